@@ -64,6 +64,9 @@ enum HksOperationType {
     HKS_OPERATION_CMAC_FREE_CTX = 0x24,                        /* cmac free ctx */
     HKS_OPERATION_SIGN_ISO_IEC_9796_2 = 0x25,                  /* sign ISO/IEC 9796-2 */
     HKS_OPERATION_VERIFY_ISO_IEC_9796_2 = 0x26,                /* verify ISO/IEC 9796-2 */
+    HKS_OPERATION_BATCH_VERIFY = 0x27,                         /* verify several messages with one key */
+    HKS_OPERATION_HASH_MULTI_BUFFER = 0x28,                    /* hash, batched across concurrent callers */
+    HKS_OPERATION_HMAC_MULTI_BUFFER = 0x29,                    /* hmac, batched across concurrent callers */
 };
 
 struct HksAbility {
@@ -85,6 +88,7 @@ struct HksAbility {
 #define HKS_CRYPTO_ABILITY_AGREE_KEY(alg)       HKS_CRYPTO_ABILITY(HKS_OPERATION_AGREE_KEY, alg)
 #define HKS_CRYPTO_ABILITY_SIGN(alg)            HKS_CRYPTO_ABILITY(HKS_OPERATION_SIGN, alg)
 #define HKS_CRYPTO_ABILITY_VERIFY(alg)          HKS_CRYPTO_ABILITY(HKS_OPERATION_VERIFY, alg)
+#define HKS_CRYPTO_ABILITY_BATCH_VERIFY(alg)    HKS_CRYPTO_ABILITY(HKS_OPERATION_BATCH_VERIFY, alg)
 
 #define HKS_CRYPTO_ABILITY_SIGN_ISO_IEC_9796_2  HKS_CRYPTO_ABILITY(HKS_OPERATION_SIGN_ISO_IEC_9796_2, 0)
 #define HKS_CRYPTO_ABILITY_VERIFY_ISO_IEC_9796_2  HKS_CRYPTO_ABILITY(HKS_OPERATION_VERIFY_ISO_IEC_9796_2, 0)
@@ -94,6 +98,7 @@ struct HksAbility {
 #define HKS_CRYPTO_ABILITY_HMAC_UPDATE          HKS_CRYPTO_ABILITY(HKS_OPERATION_HMAC_UPDATE, 0)
 #define HKS_CRYPTO_ABILITY_HMAC_FINAL           HKS_CRYPTO_ABILITY(HKS_OPERATION_HMAC_FINAL, 0)
 #define HKS_CRYPTO_ABILITY_HMAC_FREE_CTX        HKS_CRYPTO_ABILITY(HKS_OPERATION_HMAC_FREE_CTX, 0)
+#define HKS_CRYPTO_ABILITY_HMAC_MULTI_BUFFER    HKS_CRYPTO_ABILITY(HKS_OPERATION_HMAC_MULTI_BUFFER, 0)
 
 #define HKS_CRYPTO_ABILITY_CMAC_INIT            HKS_CRYPTO_ABILITY(HKS_OPERATION_CMAC_INIT, 0)
 #define HKS_CRYPTO_ABILITY_CMAC_UPDATE          HKS_CRYPTO_ABILITY(HKS_OPERATION_CMAC_UPDATE, 0)
@@ -105,6 +110,7 @@ struct HksAbility {
 #define HKS_CRYPTO_ABILITY_HASH_UPDATE          HKS_CRYPTO_ABILITY(HKS_OPERATION_HASH_UPDATE, 0)
 #define HKS_CRYPTO_ABILITY_HASH_FINAL           HKS_CRYPTO_ABILITY(HKS_OPERATION_HASH_FINAL, 0)
 #define HKS_CRYPTO_ABILITY_HASH_FREE_CTX        HKS_CRYPTO_ABILITY(HKS_OPERATION_HASH_FREE_CTX, 0)
+#define HKS_CRYPTO_ABILITY_HASH_MULTI_BUFFER    HKS_CRYPTO_ABILITY(HKS_OPERATION_HASH_MULTI_BUFFER, 0)
 
 #define HKS_CRYPTO_ABILITY_ENCRYPT(alg)         HKS_CRYPTO_ABILITY(HKS_OPERATION_ENCRYPT, alg)
 #define HKS_CRYPTO_ABILITY_ENCRYPT_INIT(alg)    HKS_CRYPTO_ABILITY(HKS_OPERATION_ENCRYPT_INIT, alg)
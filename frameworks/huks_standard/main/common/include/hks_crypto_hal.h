@@ -135,6 +135,9 @@ typedef int32_t (*Sign)(const struct HksBlob *, const struct HksUsageSpec *, con
 typedef int32_t (*Verify)(const struct HksBlob *, const struct HksUsageSpec *, const struct HksBlob *,
     const struct HksBlob *);
 
+typedef int32_t (*BatchVerify)(const struct HksBlob *, const struct HksUsageSpec *, const struct HksBlob *,
+    const struct HksBlob *, uint32_t, struct HksBlob *);
+
 typedef int32_t (*Hmac)(const struct HksBlob *, uint32_t, const struct HksBlob *, struct HksBlob *);
 
 typedef int32_t (*HmacInit)(void **, const struct HksBlob *, uint32_t);
@@ -206,6 +209,13 @@ int32_t HksCryptoHalSign(const struct HksBlob *key, const struct HksUsageSpec *u
 int32_t HksCryptoHalVerify(const struct HksBlob *key, const struct HksUsageSpec *usageSpec,
     const struct HksBlob *message, const struct HksBlob *signature);
 
+/*
+ * Verify count (message, signature) pairs with one key. Bit i of result is set when pair i verifies; a pair that
+ * fails to verify is not an error, only malformed input or an engine failure is.
+ */
+int32_t HksCryptoHalBatchVerify(const struct HksBlob *key, const struct HksUsageSpec *usageSpec,
+    const struct HksBlob *messages, const struct HksBlob *signatures, uint32_t count, struct HksBlob *result);
+
 int32_t HksCryptoHalSignIsoIec97962(const struct HksBlob *key, const struct HksUsageSpec *usageSpec,
     const struct HksBlob *message, struct HksBlob *signature);
 
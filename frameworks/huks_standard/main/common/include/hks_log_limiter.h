@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef HKS_LOG_LIMITER_H
+#define HKS_LOG_LIMITER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <time.h>
+
+#include "hks_log.h"
+
+/* every call site of HKS_LOG_I_LIMITED logs a burst of this many lines, then one more line per interval */
+#ifndef HKS_LOG_LIMIT_BURST
+#define HKS_LOG_LIMIT_BURST 10
+#endif
+
+#ifndef HKS_LOG_LIMIT_INTERVAL_MS
+#define HKS_LOG_LIMIT_INTERVAL_MS 200
+#endif
+
+#define HKS_LOG_LIMIT_S_TO_MS 1000
+#define HKS_LOG_LIMIT_MS_TO_NS 1000000
+
+/*
+ * A token bucket, zero initialized as full. Its state is one word, so that 32-bit targets update it without a lock:
+ * the time in ms, modulo 2^32, at which the bucket is full again. That time is at most burst intervals ahead of now
+ * while the bucket is in use, any other distance means an idle bucket. Only an idle of about a multiple of 2^32 ms
+ * can look like a bucket in use, and suppresses lines for at most burst intervals.
+ */
+struct HksLogLimiter {
+    uint32_t fullAtMs;
+    uint32_t suppressedCount;
+};
+
+static inline uint32_t HksLogLimiterNowMs(void)
+{
+    struct timespec curTime = { 0, 0 };
+    (void)clock_gettime(CLOCK_MONOTONIC, &curTime);
+    uint64_t nowMs = (uint64_t)curTime.tv_sec * HKS_LOG_LIMIT_S_TO_MS +
+        (uint64_t)curTime.tv_nsec / HKS_LOG_LIMIT_MS_TO_NS;
+    return (uint32_t)nowMs;
+}
+
+/* HksLogLimiterAcquire at the time nowMs */
+static inline bool HksLogLimiterAcquireAt(struct HksLogLimiter *limiter, uint32_t burst, uint32_t intervalMs,
+    uint32_t nowMs, uint32_t *suppressedCount)
+{
+    uint64_t fullSpanMs = (uint64_t)burst * intervalMs;
+    fullSpanMs = (fullSpanMs > (uint64_t)INT32_MAX) ? (uint64_t)INT32_MAX : fullSpanMs;
+    uint32_t fullAtMs = __atomic_load_n(&limiter->fullAtMs, __ATOMIC_RELAXED);
+    uint32_t newFullAtMs = 0;
+    do {
+        uint32_t aheadMs = fullAtMs - nowMs;
+        /* behind now, or too far ahead to be a bucket in use: full */
+        if ((int32_t)aheadMs < 0 || aheadMs > (uint32_t)fullSpanMs) {
+            aheadMs = 0;
+        }
+        if (burst == 0 || (uint64_t)aheadMs + intervalMs > fullSpanMs) {
+            (void)__atomic_add_fetch(&limiter->suppressedCount, 1, __ATOMIC_RELAXED);
+            return false;
+        }
+        newFullAtMs = nowMs + aheadMs + intervalMs;
+    } while (!__atomic_compare_exchange_n(&limiter->fullAtMs, &fullAtMs, newFullAtMs, true, __ATOMIC_RELAXED,
+        __ATOMIC_RELAXED));
+    *suppressedCount = __atomic_exchange_n(&limiter->suppressedCount, 0, __ATOMIC_RELAXED);
+    return true;
+}
+
+/*
+ * Takes a token of limiter, which holds up to burst tokens and gets one more every intervalMs. Returns false and
+ * counts the line suppressed when it has none, else returns in suppressedCount the lines suppressed since the last
+ * line logged.
+ */
+static inline bool HksLogLimiterAcquire(struct HksLogLimiter *limiter, uint32_t burst, uint32_t intervalMs,
+    uint32_t *suppressedCount)
+{
+    return HksLogLimiterAcquireAt(limiter, burst, intervalMs, HksLogLimiterNowMs(), suppressedCount);
+}
+
+#ifdef _HUKS_LOG_ENABLE_
+#define HKS_LOG_I_LIMITED(fmt, arg...) do { \
+    static struct HksLogLimiter hksLogLimiter = { 0, 0 }; \
+    uint32_t hksLogSuppressedCount = 0; \
+    if (HksLogLimiterAcquire(&hksLogLimiter, HKS_LOG_LIMIT_BURST, HKS_LOG_LIMIT_INTERVAL_MS, \
+        &hksLogSuppressedCount)) { \
+        HKS_LOG_I(fmt ", %" LOG_PUBLIC "u suppressed", ##arg, hksLogSuppressedCount); \
+    } \
+} while (0)
+#else
+#define HKS_LOG_I_LIMITED(...)
+#endif
+
+#endif /* HKS_LOG_LIMITER_H */
@@ -45,6 +45,7 @@ enum HksIpcInterfaceCode {
     HKS_MSG_CHIPSET_PLATFORM_DECRYPT,
     HKS_MSG_ATTEST_KEY_ASYNC_REPLY,
     HKS_MSG_LIST_ALIASES,
+    HKS_MSG_BATCH_VERIFY,
 
     /* new cmd type must be added before HKS_MSG_MAX */
     HKS_MSG_MAX,
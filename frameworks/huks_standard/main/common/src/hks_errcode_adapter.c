@@ -506,6 +506,13 @@ static struct HksError g_errCodeTable[] = {
             .errorMsg = "The number of key operation sessions has reached the limit.",
             .data = NULL
         }
+    }, {
+        .innerErrCode = HKS_ERROR_SERVICE_BUSY,
+        .hksResult = {
+            .errorCode = HUKS_ERR_CODE_SESSION_LIMIT,
+            .errorMsg = "The service is busy, too many requests are waiting to be handled.",
+            .data = NULL
+        }
     }, {
         .innerErrCode = HKS_ERROR_NOT_EXIST,
         .hksResult = {
@@ -0,0 +1,60 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef HKS_HASH_MULTI_BUFFER_H
+#define HKS_HASH_MULTI_BUFFER_H
+
+#include <stdint.h>
+
+#include "hks_type.h"
+
+#define HKS_HASH_MB_LANES 8
+
+/* longer inputs go to the single stream engine, which beats the portable lanes once its setup cost is amortized */
+#ifndef HKS_HASH_MB_MAX_INPUT_SIZE
+#define HKS_HASH_MB_MAX_INPUT_SIZE 256
+#endif
+
+/* how long at most a batch leader waits for the requests that are not in a batch yet, it waits for no others */
+#ifndef HKS_HASH_MB_WINDOW_US
+#define HKS_HASH_MB_WINDOW_US 50
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * SHA-256 of count (at most HKS_HASH_MB_LANES) messages, all lanes compressed in lockstep.
+ * digests[i] must hold HKS_DIGEST_SHA256_LEN bytes.
+ */
+int32_t HksSha256MultiBuffer(const struct HksBlob *msgs, struct HksBlob *digests, uint32_t count);
+
+/*
+ * Hash and Hmac abilities that merge concurrent SHA-256 requests into one multi-buffer run. They return
+ * HKS_ERROR_NOT_SUPPORTED for requests they do not batch, the caller then uses the single stream ability.
+ */
+int32_t HksHashMultiBuffer(uint32_t alg, const struct HksBlob *msg, struct HksBlob *hash);
+
+int32_t HksHmacMultiBuffer(const struct HksBlob *key, uint32_t digestAlg, const struct HksBlob *msg,
+    struct HksBlob *mac);
+
+void RegisterAbilityHashMultiBuffer(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HKS_HASH_MULTI_BUFFER_H */
@@ -21,10 +21,16 @@
 
 #include "hks_core_ability.h"
 #include "hks_core_get_main_key.h"
+#ifdef HKS_SUPPORT_HASH_MULTI_BUFFER
+#include "hks_hash_multi_buffer.h"
+#endif
 
 int32_t HksCryptoAbilityInit(void)
 {
     HksCryptoAbilityInitBase();
     RegisterAbilityGetMainKey();
+#ifdef HKS_SUPPORT_HASH_MULTI_BUFFER
+    RegisterAbilityHashMultiBuffer();
+#endif
     return HKS_SUCCESS;
 }
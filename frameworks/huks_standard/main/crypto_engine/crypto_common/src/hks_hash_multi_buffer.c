@@ -0,0 +1,465 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifdef HKS_CONFIG_FILE
+#include HKS_CONFIG_FILE
+#else
+#include "hks_config.h"
+#endif
+
+#ifdef HKS_SUPPORT_HASH_MULTI_BUFFER
+
+#include "hks_hash_multi_buffer.h"
+
+#include <pthread.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <time.h>
+
+#include "hks_ability.h"
+#include "hks_common_check.h"
+#include "hks_crypto_hal.h"
+#include "hks_log.h"
+#include "hks_template.h"
+#include "securec.h"
+
+#define SHA256_BLOCK_SIZE 64
+#define SHA256_STATE_WORDS 8
+#define SHA256_ROUNDS 64
+#define SHA256_LEN_FIELD_SIZE 8
+#define HMAC_IPAD 0x36
+#define HMAC_OPAD 0x5c
+#define NS_PER_US 1000
+#define NS_PER_S 1000000000L
+
+#define ROTR32(x, n) (((x) >> (n)) | ((x) << (32 - (n))))
+#define SHA256_CH(x, y, z) (((x) & (y)) ^ (~(x) & (z)))
+#define SHA256_MAJ(x, y, z) (((x) & (y)) ^ ((x) & (z)) ^ ((y) & (z)))
+#define SHA256_BSIG0(x) (ROTR32(x, 2) ^ ROTR32(x, 13) ^ ROTR32(x, 22))
+#define SHA256_BSIG1(x) (ROTR32(x, 6) ^ ROTR32(x, 11) ^ ROTR32(x, 25))
+#define SHA256_SSIG0(x) (ROTR32(x, 7) ^ ROTR32(x, 18) ^ ((x) >> 3))
+#define SHA256_SSIG1(x) (ROTR32(x, 17) ^ ROTR32(x, 19) ^ ((x) >> 10))
+
+static const uint32_t SHA256_K[SHA256_ROUNDS] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+};
+
+static const uint32_t SHA256_H0[SHA256_STATE_WORDS] = {
+    0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19,
+};
+
+/* a message seen as an optional one block prefix, its full blocks in place and one or two padded tail blocks */
+struct HksSha256MbLane {
+    const uint8_t *prefix;
+    const uint8_t *msg;
+    uint32_t msgBlocks;
+    uint32_t blockCount;
+    uint8_t tail[2 * SHA256_BLOCK_SIZE];
+};
+
+struct HksHashMbJob {
+    const uint8_t *innerPad;
+    const uint8_t *outerPad;
+    const struct HksBlob *msg;
+    uint8_t digest[HKS_DIGEST_SHA256_LEN];
+    bool isDone;
+};
+
+struct HksHashMbBatch {
+    struct HksHashMbJob *jobs[HKS_HASH_MB_LANES];
+    uint32_t count;
+};
+
+struct HksHashMbScheduler {
+    pthread_mutex_t lock;
+    pthread_cond_t joinCond; /* a job joined the open batch, or the open batch closed */
+    pthread_cond_t doneCond; /* a batch finished */
+    struct HksHashMbBatch *open;
+    /* both updated atomically, so that submitters count themselves before they wait for the lock */
+    uint32_t inFlight; /* a request that finds it zero runs alone and skips the lock */
+    uint32_t unclaimed; /* submitters that have no place in a batch yet */
+    bool isReady;
+};
+
+static struct HksHashMbScheduler g_hashMb = { .lock = PTHREAD_MUTEX_INITIALIZER };
+static pthread_once_t g_hashMbOnce = PTHREAD_ONCE_INIT;
+
+static uint32_t LoadBe32(const uint8_t *p)
+{
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | (uint32_t)p[3];
+}
+
+static void StoreBe32(uint8_t *p, uint32_t v)
+{
+    p[0] = (uint8_t)(v >> 24);
+    p[1] = (uint8_t)(v >> 16);
+    p[2] = (uint8_t)(v >> 8);
+    p[3] = (uint8_t)v;
+}
+
+static void InitLane(struct HksSha256MbLane *lane, const uint8_t *prefix, const uint8_t *msg, uint32_t msgLen)
+{
+    lane->prefix = prefix;
+    lane->msg = msg;
+    lane->msgBlocks = msgLen / SHA256_BLOCK_SIZE;
+
+    uint32_t rest = msgLen % SHA256_BLOCK_SIZE;
+    (void)memset_s(lane->tail, sizeof(lane->tail), 0, sizeof(lane->tail));
+    if (rest != 0) {
+        (void)memcpy_s(lane->tail, sizeof(lane->tail), msg + lane->msgBlocks * SHA256_BLOCK_SIZE, rest);
+    }
+    lane->tail[rest] = 0x80;
+    uint32_t tailBlocks = (rest + 1 + SHA256_LEN_FIELD_SIZE > SHA256_BLOCK_SIZE) ? 2 : 1;
+
+    uint64_t bitLen = ((uint64_t)msgLen + ((prefix != NULL) ? SHA256_BLOCK_SIZE : 0)) * HKS_BITS_PER_BYTE;
+    uint8_t *lenField = lane->tail + tailBlocks * SHA256_BLOCK_SIZE - SHA256_LEN_FIELD_SIZE;
+    StoreBe32(lenField, (uint32_t)(bitLen >> 32));
+    StoreBe32(lenField + sizeof(uint32_t), (uint32_t)bitLen);
+
+    lane->blockCount = ((prefix != NULL) ? 1 : 0) + lane->msgBlocks + tailBlocks;
+}
+
+static const uint8_t *LaneBlock(const struct HksSha256MbLane *lane, uint32_t index)
+{
+    if (lane->prefix != NULL) {
+        if (index == 0) {
+            return lane->prefix;
+        }
+        --index;
+    }
+    if (index < lane->msgBlocks) {
+        return lane->msg + index * SHA256_BLOCK_SIZE;
+    }
+    return lane->tail + (index - lane->msgBlocks) * SHA256_BLOCK_SIZE;
+}
+
+/*
+ * One compression for every lane. Words are stored lane-minor so each inner loop runs the same operation over
+ * HKS_HASH_MB_LANES independent values, which the compiler maps onto AVX2 or NEON registers.
+ */
+static void Sha256MbCompress(uint32_t state[SHA256_STATE_WORDS][HKS_HASH_MB_LANES],
+    const uint8_t *const blocks[HKS_HASH_MB_LANES])
+{
+    uint32_t w[SHA256_ROUNDS][HKS_HASH_MB_LANES];
+    uint32_t v[SHA256_STATE_WORDS][HKS_HASH_MB_LANES];
+
+    for (uint32_t t = 0; t < SHA256_BLOCK_SIZE / sizeof(uint32_t); ++t) {
+        for (uint32_t l = 0; l < HKS_HASH_MB_LANES; ++l) {
+            w[t][l] = LoadBe32(blocks[l] + t * sizeof(uint32_t));
+        }
+    }
+    for (uint32_t t = SHA256_BLOCK_SIZE / sizeof(uint32_t); t < SHA256_ROUNDS; ++t) {
+        for (uint32_t l = 0; l < HKS_HASH_MB_LANES; ++l) {
+            w[t][l] = SHA256_SSIG1(w[t - 2][l]) + w[t - 7][l] + SHA256_SSIG0(w[t - 15][l]) + w[t - 16][l];
+        }
+    }
+    (void)memcpy_s(v, sizeof(v), state, sizeof(v));
+
+    for (uint32_t t = 0; t < SHA256_ROUNDS; ++t) {
+        for (uint32_t l = 0; l < HKS_HASH_MB_LANES; ++l) {
+            uint32_t t1 = v[7][l] + SHA256_BSIG1(v[4][l]) + SHA256_CH(v[4][l], v[5][l], v[6][l]) +
+                SHA256_K[t] + w[t][l];
+            uint32_t t2 = SHA256_BSIG0(v[0][l]) + SHA256_MAJ(v[0][l], v[1][l], v[2][l]);
+            v[7][l] = v[6][l];
+            v[6][l] = v[5][l];
+            v[5][l] = v[4][l];
+            v[4][l] = v[3][l] + t1;
+            v[3][l] = v[2][l];
+            v[2][l] = v[1][l];
+            v[1][l] = v[0][l];
+            v[0][l] = t1 + t2;
+        }
+    }
+
+    for (uint32_t i = 0; i < SHA256_STATE_WORDS; ++i) {
+        for (uint32_t l = 0; l < HKS_HASH_MB_LANES; ++l) {
+            state[i][l] += v[i][l];
+        }
+    }
+    (void)memset_s(w, sizeof(w), 0, sizeof(w));
+    (void)memset_s(v, sizeof(v), 0, sizeof(v));
+}
+
+static void Sha256MbRun(const struct HksSha256MbLane *lanes, uint32_t count,
+    uint8_t digests[HKS_HASH_MB_LANES][HKS_DIGEST_SHA256_LEN])
+{
+    static const uint8_t idleBlock[SHA256_BLOCK_SIZE] = { 0 };
+    uint32_t state[SHA256_STATE_WORDS][HKS_HASH_MB_LANES];
+    uint32_t maxBlocks = 0;
+    for (uint32_t i = 0; i < SHA256_STATE_WORDS; ++i) {
+        for (uint32_t l = 0; l < HKS_HASH_MB_LANES; ++l) {
+            state[i][l] = SHA256_H0[i];
+        }
+    }
+    for (uint32_t l = 0; l < count; ++l) {
+        maxBlocks = (lanes[l].blockCount > maxBlocks) ? lanes[l].blockCount : maxBlocks;
+    }
+
+    const uint8_t *blocks[HKS_HASH_MB_LANES];
+    for (uint32_t b = 0; b < maxBlocks; ++b) {
+        for (uint32_t l = 0; l < HKS_HASH_MB_LANES; ++l) {
+            blocks[l] = (l < count && b < lanes[l].blockCount) ? LaneBlock(&lanes[l], b) : idleBlock;
+        }
+        Sha256MbCompress(state, blocks);
+        for (uint32_t l = 0; l < count; ++l) {
+            if (b + 1 != lanes[l].blockCount) {
+                continue;
+            }
+            for (uint32_t i = 0; i < SHA256_STATE_WORDS; ++i) {
+                StoreBe32(digests[l] + i * sizeof(uint32_t), state[i][l]);
+            }
+        }
+    }
+    (void)memset_s(state, sizeof(state), 0, sizeof(state));
+}
+
+int32_t HksSha256MultiBuffer(const struct HksBlob *msgs, struct HksBlob *digests, uint32_t count)
+{
+    if (msgs == NULL || digests == NULL || count == 0 || count > HKS_HASH_MB_LANES) {
+        return HKS_ERROR_INVALID_ARGUMENT;
+    }
+    struct HksSha256MbLane lanes[HKS_HASH_MB_LANES];
+    for (uint32_t i = 0; i < count; ++i) {
+        if ((msgs[i].data == NULL && msgs[i].size != 0) || digests[i].data == NULL ||
+            digests[i].size < HKS_DIGEST_SHA256_LEN) {
+            return HKS_ERROR_INVALID_ARGUMENT;
+        }
+        InitLane(&lanes[i], NULL, msgs[i].data, msgs[i].size);
+    }
+
+    uint8_t out[HKS_HASH_MB_LANES][HKS_DIGEST_SHA256_LEN];
+    Sha256MbRun(lanes, count, out);
+    for (uint32_t i = 0; i < count; ++i) {
+        (void)memcpy_s(digests[i].data, digests[i].size, out[i], HKS_DIGEST_SHA256_LEN);
+        digests[i].size = HKS_DIGEST_SHA256_LEN;
+    }
+    (void)memset_s(lanes, sizeof(lanes), 0, sizeof(lanes));
+    return HKS_SUCCESS;
+}
+
+/* plain hashes finish in the first pass, hmac jobs feed their inner digest into a second pass */
+static void RunHashMbBatch(const struct HksHashMbBatch *batch)
+{
+    struct HksSha256MbLane lanes[HKS_HASH_MB_LANES];
+    uint8_t inner[HKS_HASH_MB_LANES][HKS_DIGEST_SHA256_LEN];
+    uint8_t outer[HKS_HASH_MB_LANES][HKS_DIGEST_SHA256_LEN];
+    uint32_t outerJobs[HKS_HASH_MB_LANES];
+    uint32_t outerCount = 0;
+
+    for (uint32_t i = 0; i < batch->count; ++i) {
+        const struct HksHashMbJob *job = batch->jobs[i];
+        InitLane(&lanes[i], job->innerPad, job->msg->data, job->msg->size);
+    }
+    Sha256MbRun(lanes, batch->count, inner);
+
+    for (uint32_t i = 0; i < batch->count; ++i) {
+        struct HksHashMbJob *job = batch->jobs[i];
+        if (job->outerPad == NULL) {
+            (void)memcpy_s(job->digest, sizeof(job->digest), inner[i], HKS_DIGEST_SHA256_LEN);
+            continue;
+        }
+        InitLane(&lanes[outerCount], job->outerPad, inner[i], HKS_DIGEST_SHA256_LEN);
+        outerJobs[outerCount++] = i;
+    }
+    if (outerCount != 0) {
+        Sha256MbRun(lanes, outerCount, outer);
+        for (uint32_t i = 0; i < outerCount; ++i) {
+            struct HksHashMbJob *job = batch->jobs[outerJobs[i]];
+            (void)memcpy_s(job->digest, sizeof(job->digest), outer[i], HKS_DIGEST_SHA256_LEN);
+        }
+    }
+    (void)memset_s(lanes, sizeof(lanes), 0, sizeof(lanes));
+    (void)memset_s(inner, sizeof(inner), 0, sizeof(inner));
+    (void)memset_s(outer, sizeof(outer), 0, sizeof(outer));
+}
+
+/* the window deadline is measured on the monotonic clock, so that wall clock changes do not stretch it */
+static void InitHashMbScheduler(void)
+{
+    pthread_condattr_t attr;
+    if (pthread_condattr_init(&attr) != 0) {
+        return;
+    }
+    if (pthread_condattr_setclock(&attr, CLOCK_MONOTONIC) == 0 &&
+        pthread_cond_init(&g_hashMb.joinCond, &attr) == 0) {
+        if (pthread_cond_init(&g_hashMb.doneCond, NULL) == 0) {
+            g_hashMb.isReady = true;
+        } else {
+            (void)pthread_cond_destroy(&g_hashMb.joinCond);
+        }
+    }
+    (void)pthread_condattr_destroy(&attr);
+}
+
+static void GetWindowDeadline(struct timespec *deadline)
+{
+    (void)clock_gettime(CLOCK_MONOTONIC, deadline);
+    deadline->tv_nsec += (long)HKS_HASH_MB_WINDOW_US * NS_PER_US;
+    if (deadline->tv_nsec >= NS_PER_S) {
+        deadline->tv_sec += 1;
+        deadline->tv_nsec -= NS_PER_S;
+    }
+}
+
+/*
+ * Called with the lock held, waits for the submitters that have no place in a batch yet to join and returns the
+ * number of jobs in the batch. Jobs already claimed by a running batch never join, so they are not waited for, and
+ * a leader with nobody unclaimed behind it runs at once.
+ */
+static uint32_t CollectBatchLocked(struct HksHashMbBatch *batch)
+{
+    if (__atomic_load_n(&g_hashMb.unclaimed, __ATOMIC_RELAXED) != 0) {
+        struct timespec deadline;
+        GetWindowDeadline(&deadline);
+        while (batch->count < HKS_HASH_MB_LANES && __atomic_load_n(&g_hashMb.unclaimed, __ATOMIC_RELAXED) != 0) {
+            if (pthread_cond_timedwait(&g_hashMb.joinCond, &g_hashMb.lock, &deadline) != 0) {
+                break;
+            }
+        }
+    }
+    if (g_hashMb.open == batch) {
+        g_hashMb.open = NULL;
+    }
+    return batch->count;
+}
+
+static int32_t LeaveHashMb(int32_t ret)
+{
+    (void)__atomic_sub_fetch(&g_hashMb.inFlight, 1, __ATOMIC_RELAXED);
+    return ret;
+}
+
+/*
+ * Join the open batch or open a new one. The thread that opens a batch leads it: it collects the unclaimed submitters,
+ * runs the batch and wakes the others. A batch that got no company is handed back to the single stream engine, and
+ * so is a request that runs alone, without taking the lock.
+ */
+static int32_t SubmitHashMbJob(struct HksHashMbJob *job)
+{
+    if (__atomic_fetch_add(&g_hashMb.inFlight, 1, __ATOMIC_RELAXED) == 0) {
+        return LeaveHashMb(HKS_ERROR_NOT_SUPPORTED);
+    }
+    (void)pthread_once(&g_hashMbOnce, InitHashMbScheduler);
+    if (!g_hashMb.isReady) {
+        return LeaveHashMb(HKS_ERROR_NOT_SUPPORTED);
+    }
+
+    (void)__atomic_add_fetch(&g_hashMb.unclaimed, 1, __ATOMIC_RELAXED);
+    (void)pthread_mutex_lock(&g_hashMb.lock);
+    while (g_hashMb.open != NULL && g_hashMb.open->count == HKS_HASH_MB_LANES) {
+        (void)pthread_cond_wait(&g_hashMb.joinCond, &g_hashMb.lock);
+    }
+    (void)__atomic_sub_fetch(&g_hashMb.unclaimed, 1, __ATOMIC_RELAXED);
+
+    if (g_hashMb.open != NULL) {
+        g_hashMb.open->jobs[g_hashMb.open->count++] = job;
+        (void)pthread_cond_broadcast(&g_hashMb.joinCond);
+        while (!job->isDone) {
+            (void)pthread_cond_wait(&g_hashMb.doneCond, &g_hashMb.lock);
+        }
+        (void)pthread_mutex_unlock(&g_hashMb.lock);
+        return LeaveHashMb(HKS_SUCCESS);
+    }
+
+    struct HksHashMbBatch batch = { { job }, 1 };
+    g_hashMb.open = &batch;
+    uint32_t count = CollectBatchLocked(&batch);
+    /* the batch is closed, the submitters waiting for a place may open the next one */
+    (void)pthread_cond_broadcast(&g_hashMb.joinCond);
+    (void)pthread_mutex_unlock(&g_hashMb.lock);
+    if (count == 1) {
+        return LeaveHashMb(HKS_ERROR_NOT_SUPPORTED);
+    }
+
+    RunHashMbBatch(&batch);
+
+    (void)pthread_mutex_lock(&g_hashMb.lock);
+    for (uint32_t i = 0; i < count; ++i) {
+        batch.jobs[i]->isDone = true;
+    }
+    (void)pthread_cond_broadcast(&g_hashMb.doneCond);
+    (void)pthread_mutex_unlock(&g_hashMb.lock);
+    return LeaveHashMb(HKS_SUCCESS);
+}
+
+static bool IsMultiBufferInput(uint32_t alg, const struct HksBlob *msg, const struct HksBlob *out)
+{
+    return (alg == HKS_DIGEST_SHA256) && (CheckBlob(msg) == HKS_SUCCESS) &&
+        (msg->size <= HKS_HASH_MB_MAX_INPUT_SIZE) && (CheckBlob(out) == HKS_SUCCESS) &&
+        (out->size >= HKS_DIGEST_SHA256_LEN);
+}
+
+int32_t HksHashMultiBuffer(uint32_t alg, const struct HksBlob *msg, struct HksBlob *hash)
+{
+    if (!IsMultiBufferInput(alg, msg, hash)) {
+        return HKS_ERROR_NOT_SUPPORTED;
+    }
+
+    struct HksHashMbJob job = { NULL, NULL, msg, { 0 }, false };
+    int32_t ret = SubmitHashMbJob(&job);
+    HKS_IF_NOT_SUCC_RETURN(ret, ret)
+
+    (void)memcpy_s(hash->data, hash->size, job.digest, HKS_DIGEST_SHA256_LEN);
+    hash->size = HKS_DIGEST_SHA256_LEN;
+    return HKS_SUCCESS;
+}
+
+int32_t HksHmacMultiBuffer(const struct HksBlob *key, uint32_t digestAlg, const struct HksBlob *msg,
+    struct HksBlob *mac)
+{
+    if (!IsMultiBufferInput(digestAlg, msg, mac) || CheckBlob(key) != HKS_SUCCESS) {
+        return HKS_ERROR_NOT_SUPPORTED;
+    }
+
+    uint8_t keyBlock[SHA256_BLOCK_SIZE] = { 0 };
+    if (key->size > SHA256_BLOCK_SIZE) {
+        struct HksBlob keyDigest = { HKS_DIGEST_SHA256_LEN, keyBlock };
+        HKS_IF_NOT_SUCC_RETURN(HksSha256MultiBuffer(key, &keyDigest, 1), HKS_ERROR_NOT_SUPPORTED)
+    } else {
+        (void)memcpy_s(keyBlock, sizeof(keyBlock), key->data, key->size);
+    }
+    uint8_t innerPad[SHA256_BLOCK_SIZE];
+    uint8_t outerPad[SHA256_BLOCK_SIZE];
+    for (uint32_t i = 0; i < SHA256_BLOCK_SIZE; ++i) {
+        innerPad[i] = keyBlock[i] ^ HMAC_IPAD;
+        outerPad[i] = keyBlock[i] ^ HMAC_OPAD;
+    }
+
+    struct HksHashMbJob job = { innerPad, outerPad, msg, { 0 }, false };
+    int32_t ret = SubmitHashMbJob(&job);
+    if (ret == HKS_SUCCESS) {
+        (void)memcpy_s(mac->data, mac->size, job.digest, HKS_DIGEST_SHA256_LEN);
+        mac->size = HKS_DIGEST_SHA256_LEN;
+    }
+    (void)memset_s(keyBlock, sizeof(keyBlock), 0, sizeof(keyBlock));
+    (void)memset_s(innerPad, sizeof(innerPad), 0, sizeof(innerPad));
+    (void)memset_s(outerPad, sizeof(outerPad), 0, sizeof(outerPad));
+    (void)memset_s(job.digest, sizeof(job.digest), 0, sizeof(job.digest));
+    return ret;
+}
+
+void RegisterAbilityHashMultiBuffer(void)
+{
+    (void)RegisterAbility(HKS_CRYPTO_ABILITY_HASH_MULTI_BUFFER, HksHashMultiBuffer);
+    (void)RegisterAbility(HKS_CRYPTO_ABILITY_HMAC_MULTI_BUFFER, HksHmacMultiBuffer);
+}
+#endif /* HKS_SUPPORT_HASH_MULTI_BUFFER */
@@ -42,6 +42,9 @@ int32_t HksOpensslEd25519Sign(const struct HksBlob *key, const struct HksUsageSp
 int32_t HksOpensslEd25519Verify(const struct HksBlob *key, const struct HksUsageSpec *usageSpec,
     const struct HksBlob *message, const struct HksBlob *signature);
 
+int32_t HksOpensslEd25519BatchVerify(const struct HksBlob *key, const struct HksUsageSpec *usageSpec,
+    const struct HksBlob *messages, const struct HksBlob *signatures, uint32_t count, struct HksBlob *result);
+
 int32_t HksOpensslGetEd25519PubKey(const struct HksBlob *input, struct HksBlob *output);
 
 #ifdef __cplusplus
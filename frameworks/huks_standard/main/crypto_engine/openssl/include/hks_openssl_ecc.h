@@ -45,6 +45,9 @@ int32_t HksOpensslEcdsaSign(const struct HksBlob *key, const struct HksUsageSpec
 
 int32_t HksOpensslEcdsaVerify(const struct HksBlob *key, const struct HksUsageSpec *usageSpec,
     const struct HksBlob *message, const struct HksBlob *signature);
+
+int32_t HksOpensslEcdsaBatchVerify(const struct HksBlob *key, const struct HksUsageSpec *usageSpec,
+    const struct HksBlob *messages, const struct HksBlob *signatures, uint32_t count, struct HksBlob *result);
 #endif /* HKS_SUPPORT_ECDSA_SIGN_VERIFY */
 
 #ifdef __cplusplus
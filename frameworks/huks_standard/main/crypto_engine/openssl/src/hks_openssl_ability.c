@@ -127,9 +127,11 @@ static void RegisterAbilityVerify(void)
 #endif
 #if defined(HKS_SUPPORT_ECC_C) && defined(HKS_SUPPORT_ECDSA_C) && defined(HKS_SUPPORT_ECDSA_SIGN_VERIFY)
     (void)RegisterAbility(HKS_CRYPTO_ABILITY_VERIFY(HKS_ALG_ECC), HksOpensslEcdsaVerify);
+    (void)RegisterAbility(HKS_CRYPTO_ABILITY_BATCH_VERIFY(HKS_ALG_ECC), HksOpensslEcdsaBatchVerify);
 #endif
 #if defined(HKS_SUPPORT_ED25519_C) && defined(HKS_SUPPORT_ED25519_SIGN_VERIFY)
     (void)RegisterAbility(HKS_CRYPTO_ABILITY_VERIFY(HKS_ALG_ED25519), HksOpensslEd25519Verify);
+    (void)RegisterAbility(HKS_CRYPTO_ABILITY_BATCH_VERIFY(HKS_ALG_ED25519), HksOpensslEd25519BatchVerify);
 #endif
 #if defined(HKS_SUPPORT_DSA_C) && defined(HKS_SUPPORT_DSA_SIGN_VERIFY)
     (void)RegisterAbility(HKS_CRYPTO_ABILITY_VERIFY(HKS_ALG_DSA), HksOpensslDsaVerify);
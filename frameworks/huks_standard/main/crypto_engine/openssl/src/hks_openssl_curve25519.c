@@ -15,6 +15,7 @@
 
 #include "hks_openssl_curve25519.h"
 
+#include <openssl/err.h>
 #include <openssl/evp.h>
 #include <openssl/ossl_typ.h>
 #include <stdbool.h>
@@ -304,6 +305,45 @@ int32_t HksOpensslEd25519Verify(const struct HksBlob *key, const struct HksUsage
     return ret;
 }
 
+int32_t HksOpensslEd25519BatchVerify(const struct HksBlob *key, const struct HksUsageSpec *usageSpec,
+    const struct HksBlob *messages, const struct HksBlob *signatures, uint32_t count, struct HksBlob *result)
+{
+    (void)usageSpec;
+    /* openssl has no batched ed25519 primitive, so share the decoded public key and digest context instead */
+    struct KeyMaterial25519 *km = (struct KeyMaterial25519 *)key->data;
+    EVP_PKEY *edKeyPub = EVP_PKEY_new_raw_public_key(EVP_PKEY_ED25519, NULL,
+        key->data + sizeof(struct KeyMaterial25519), km->pubKeySize);
+    if (edKeyPub == NULL) {
+        HksLogOpensslError();
+        return HKS_ERROR_CRYPTO_ENGINE_ERROR;
+    }
+    EVP_MD_CTX *mdctx = EVP_MD_CTX_new();
+    if (mdctx == NULL) {
+        HksLogOpensslError();
+        EVP_PKEY_free(edKeyPub);
+        return HKS_ERROR_CRYPTO_ENGINE_ERROR;
+    }
+
+    int32_t ret = HKS_SUCCESS;
+    for (uint32_t i = 0; i < count; ++i) {
+        if (EVP_MD_CTX_reset(mdctx) != HKS_OPENSSL_SUCCESS ||
+            EVP_DigestVerifyInit(mdctx, NULL, NULL, NULL, edKeyPub) != HKS_OPENSSL_SUCCESS) {
+            HksLogOpensslError();
+            ret = HKS_ERROR_CRYPTO_ENGINE_ERROR;
+            break;
+        }
+        if (EVP_DigestVerify(mdctx, signatures[i].data, signatures[i].size, messages[i].data, messages[i].size) ==
+            HKS_OPENSSL_SUCCESS) {
+            result->data[i / HKS_BITS_PER_BYTE] |= (uint8_t)(1u << (i % HKS_BITS_PER_BYTE));
+        }
+    }
+    ERR_clear_error();
+
+    EVP_PKEY_free(edKeyPub);
+    EVP_MD_CTX_free(mdctx);
+    return ret;
+}
+
 int32_t HksOpensslGetEd25519PubKey(const struct HksBlob *input, struct HksBlob *output)
 {
     struct KeyMaterial25519 *key = (struct KeyMaterial25519 *)input->data;
@@ -24,6 +24,7 @@
 
 #include <openssl/bn.h>
 #include <openssl/ec.h>
+#include <openssl/err.h>
 #include <openssl/evp.h>
 #include <openssl/obj_mac.h>
 #include <openssl/ossl_typ.h>
@@ -514,6 +515,30 @@ int32_t HksOpensslEcdsaVerify(const struct HksBlob *key, const struct HksUsageSp
     return HKS_SUCCESS;
 }
 
+int32_t HksOpensslEcdsaBatchVerify(const struct HksBlob *key, const struct HksUsageSpec *usageSpec,
+    const struct HksBlob *messages, const struct HksBlob *signatures, uint32_t count, struct HksBlob *result)
+{
+    /* the public point is decoded and the verify context set up once for every digest of the same length */
+    EVP_PKEY_CTX *ctx = InitEcdsaCtx(key, usageSpec->digest, false, messages[0].size);
+    HKS_IF_NULL_LOGE_RETURN(ctx, HKS_ERROR_INVALID_KEY_INFO, "initialize ecc context failed")
+
+    for (uint32_t i = 0; i < count; ++i) {
+        bool isVerified;
+        if (messages[i].size == messages[0].size) {
+            isVerified = (EVP_PKEY_verify(ctx, signatures[i].data, signatures[i].size,
+                messages[i].data, messages[i].size) == HKS_OPENSSL_SUCCESS);
+        } else {
+            isVerified = (HksOpensslEcdsaVerify(key, usageSpec, &messages[i], &signatures[i]) == HKS_SUCCESS);
+        }
+        if (isVerified) {
+            result->data[i / HKS_BITS_PER_BYTE] |= (uint8_t)(1u << (i % HKS_BITS_PER_BYTE));
+        }
+    }
+    ERR_clear_error();
+    EVP_PKEY_CTX_free(ctx);
+    return HKS_SUCCESS;
+}
+
 int32_t HksOpensslEcdsaSign(const struct HksBlob *key, const struct HksUsageSpec *usageSpec,
     const struct HksBlob *message, struct HksBlob *signature)
 {
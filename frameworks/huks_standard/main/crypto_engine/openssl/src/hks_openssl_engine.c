@@ -31,6 +31,7 @@
 #include "hks_log.h"
 #include "hks_mem.h"
 #include "hks_template.h"
+#include "securec.h"
 
 void HksLogOpensslError(void)
 {
@@ -215,6 +216,15 @@ int32_t HksCryptoHalHmac(const struct HksBlob *key, uint32_t digestAlg, const st
         return HKS_ERROR_INVALID_ARGUMENT;
     }
 
+    /* registered only when the multi-buffer engine is built in, it hands back the requests it does not batch */
+    Hmac batched = (Hmac)GetAbility(HKS_CRYPTO_ABILITY_HMAC_MULTI_BUFFER);
+    if (batched != NULL) {
+        int32_t ret = batched(key, digestAlg, msg, mac);
+        if (ret != HKS_ERROR_NOT_SUPPORTED) {
+            return ret;
+        }
+    }
+
     Hmac func = (Hmac)GetAbility(HKS_CRYPTO_ABILITY_HMAC);
     HKS_IF_NULL_RETURN(func, HKS_ERROR_INVALID_ARGUMENT)
     return func(key, digestAlg, msg, mac);
@@ -272,6 +282,14 @@ void HksCryptoHalHmacFreeCtx(void **ctx)
 
 int32_t HksCryptoHalHash(uint32_t alg, const struct HksBlob *msg, struct HksBlob *hash)
 {
+    Hash batched = (Hash)GetAbility(HKS_CRYPTO_ABILITY_HASH_MULTI_BUFFER);
+    if (batched != NULL) {
+        int32_t ret = batched(alg, msg, hash);
+        if (ret != HKS_ERROR_NOT_SUPPORTED) {
+            return ret;
+        }
+    }
+
     Hash func = (Hash)GetAbility(HKS_CRYPTO_ABILITY_HASH);
     HKS_IF_NULL_LOGE_RETURN(func, HKS_ERROR_INVALID_ARGUMENT, "Hash func is null!")
     return func(alg, msg, hash);
@@ -365,6 +383,47 @@ int32_t HksCryptoHalVerify(const struct HksBlob *key, const struct HksUsageSpec
     return func(key, usageSpec, message, signature);
 }
 
+static int32_t BatchVerifyCheckParam(const struct HksBlob *key, const struct HksUsageSpec *usageSpec,
+    const struct HksBlob *messages, const struct HksBlob *signatures, uint32_t count, const struct HksBlob *result)
+{
+    if (HksOpensslCheckBlob(key) != HKS_SUCCESS || usageSpec == NULL || messages == NULL || signatures == NULL ||
+        count == 0 || count > HKS_MAX_BATCH_VERIFY_COUNT || HksOpensslCheckBlob(result) != HKS_SUCCESS ||
+        result->size < HKS_BATCH_VERIFY_RESULT_SIZE(count)) {
+        HKS_LOG_E("Crypt Hal batch verify param error");
+        return HKS_ERROR_INVALID_ARGUMENT;
+    }
+    for (uint32_t i = 0; i < count; ++i) {
+        if (HksOpensslCheckBlob(&messages[i]) != HKS_SUCCESS || HksOpensslCheckBlob(&signatures[i]) != HKS_SUCCESS) {
+            HKS_LOG_E("Crypt Hal batch verify invalid pair %" LOG_PUBLIC "u", i);
+            return HKS_ERROR_INVALID_ARGUMENT;
+        }
+    }
+    return HKS_SUCCESS;
+}
+
+int32_t HksCryptoHalBatchVerify(const struct HksBlob *key, const struct HksUsageSpec *usageSpec,
+    const struct HksBlob *messages, const struct HksBlob *signatures, uint32_t count, struct HksBlob *result)
+{
+    int32_t ret = BatchVerifyCheckParam(key, usageSpec, messages, signatures, count, result);
+    HKS_IF_NOT_SUCC_RETURN(ret, ret)
+    (void)memset_s(result->data, result->size, 0, result->size);
+
+    BatchVerify batchFunc = (BatchVerify)GetAbility(HKS_CRYPTO_ABILITY_BATCH_VERIFY(usageSpec->algType));
+    if (batchFunc != NULL) {
+        return batchFunc(key, usageSpec, messages, signatures, count, result);
+    }
+
+    /* no batched primitive for this algorithm, verify the pairs one after another */
+    Verify func = (Verify)GetAbility(HKS_CRYPTO_ABILITY_VERIFY(usageSpec->algType));
+    HKS_IF_NULL_LOGE_RETURN(func, HKS_ERROR_INVALID_ARGUMENT, "Verify func is null!")
+    for (uint32_t i = 0; i < count; ++i) {
+        if (func(key, usageSpec, &messages[i], &signatures[i]) == HKS_SUCCESS) {
+            result->data[i / HKS_BITS_PER_BYTE] |= (uint8_t)(1u << (i % HKS_BITS_PER_BYTE));
+        }
+    }
+    return HKS_SUCCESS;
+}
+
 int32_t HksCryptoHalDeriveKey(
     const struct HksBlob *mainKey, const struct HksKeySpec *derivationSpec, struct HksBlob *derivedKey)
 {
@@ -53,6 +53,9 @@ int32_t HksClientSign(const struct HksBlob *key, const struct HksParamSet *param
 int32_t HksClientVerify(const struct HksBlob *key, const struct HksParamSet *paramSet,
     const struct HksBlob *srcData, const struct HksBlob *signature);
 
+int32_t HksClientBatchVerify(const struct HksBlob *keyAlias, const struct HksParamSet *paramSet,
+    const struct HksBlob *srcData, const struct HksBlob *signature, uint32_t count, struct HksBlob *result);
+
 int32_t HksClientEncrypt(const struct HksBlob *key, const struct HksParamSet *paramSet,
     const struct HksBlob *plainText, struct HksBlob *cipherText);
 
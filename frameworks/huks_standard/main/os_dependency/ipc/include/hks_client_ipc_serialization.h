@@ -78,6 +78,10 @@ int32_t HksParamsToParamSet(struct HksParam *params, uint32_t cnt, struct HksPar
 
 int32_t EncodeCertChain(const struct HksBlob *inBlob, struct HksBlob *outBlob);
 
+int32_t HksBatchVerifyPack(struct HksBlob *destData, const struct HksBlob *keyAlias,
+    const struct HksParamSet *paramSet, const struct HksBlob *srcData, const struct HksBlob *signature,
+    uint32_t count, const struct HksBlob *result);
+
 int32_t HksListAliasesPack(const struct HksParamSet *srcParamSet, struct HksBlob *destData);
 
 int32_t HksListAliasesUnpackFromService(const struct HksBlob *srcData, struct HksKeyAliasSet **destData);
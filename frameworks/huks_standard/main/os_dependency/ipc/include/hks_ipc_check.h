@@ -57,6 +57,10 @@ int32_t HksCheckIpcCertificateChain(const struct HksBlob *keyAlias, const struct
 
 int32_t HksCheckIpcListAliases(const struct HksParamSet *paramSet);
 
+int32_t HksCheckIpcBatchVerify(const struct HksBlob *keyAlias, const struct HksParamSet *paramSet,
+    const struct HksBlob *srcData, const struct HksBlob *signature, uint32_t count, const struct HksBlob *result,
+    uint32_t *packSize);
+
 #ifdef __cplusplus
 }
 #endif
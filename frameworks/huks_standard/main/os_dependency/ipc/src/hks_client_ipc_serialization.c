@@ -517,6 +517,28 @@ int32_t HksParamsToParamSet(struct HksParam *params, uint32_t cnt, struct HksPar
     return ret;
 }
 
+int32_t HksBatchVerifyPack(struct HksBlob *destData, const struct HksBlob *keyAlias,
+    const struct HksParamSet *paramSet, const struct HksBlob *srcData, const struct HksBlob *signature,
+    uint32_t count, const struct HksBlob *result)
+{
+    uint32_t offset = 0;
+    int32_t ret = HksOnceParamPack(destData, keyAlias, paramSet, &offset);
+    HKS_IF_NOT_SUCC_LOGE_RETURN(ret, ret, "copy keyAlias or paramSet failed")
+
+    ret = CopyUint32ToBuffer(count, destData, &offset);
+    HKS_IF_NOT_SUCC_LOGE_RETURN(ret, ret, "copy count failed")
+
+    for (uint32_t i = 0; i < count; ++i) {
+        ret = CopyBlobToBuffer(&srcData[i], destData, &offset);
+        HKS_IF_NOT_SUCC_LOGE_RETURN(ret, ret, "copy srcData %" LOG_PUBLIC "u failed", i)
+
+        ret = CopyBlobToBuffer(&signature[i], destData, &offset);
+        HKS_IF_NOT_SUCC_LOGE_RETURN(ret, ret, "copy signature %" LOG_PUBLIC "u failed", i)
+    }
+
+    return CopyUint32ToBuffer(result->size, destData, &offset);
+}
+
 int32_t HksListAliasesPack(const struct HksParamSet *srcParamSet, struct HksBlob *destData)
 {
     uint32_t offset = 0;
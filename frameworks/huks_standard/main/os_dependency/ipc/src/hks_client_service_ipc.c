@@ -348,6 +348,30 @@ int32_t HksClientVerify(const struct HksBlob *key, const struct HksParamSet *par
     return ret;
 }
 
+int32_t HksClientBatchVerify(const struct HksBlob *keyAlias, const struct HksParamSet *paramSet,
+    const struct HksBlob *srcData, const struct HksBlob *signature, uint32_t count, struct HksBlob *result)
+{
+    uint32_t inSize = 0;
+    int32_t ret = HksCheckIpcBatchVerify(keyAlias, paramSet, srcData, signature, count, result, &inSize);
+    HKS_IF_NOT_SUCC_LOGE_RETURN(ret, ret, "HksCheckIpcBatchVerify fail")
+
+    struct HksBlob inBlob = { inSize, NULL };
+    inBlob.data = (uint8_t *)HksMalloc(inBlob.size);
+    HKS_IF_NULL_RETURN(inBlob.data, HKS_ERROR_MALLOC_FAIL)
+
+    do {
+        ret = HksBatchVerifyPack(&inBlob, keyAlias, paramSet, srcData, signature, count, result);
+        HKS_IF_NOT_SUCC_LOGE_BREAK(ret, "HksBatchVerifyPack fail")
+
+        /* one request carries the whole batch, the service answers with the result bitmap */
+        ret = HksSendRequest(HKS_MSG_BATCH_VERIFY, &inBlob, result, paramSet);
+        HKS_IF_NOT_SUCC_LOGE_BREAK(ret, "HksSendRequest fail, ret = %" LOG_PUBLIC "d", ret)
+    } while (0);
+
+    HKS_FREE_BLOB(inBlob);
+    return ret;
+}
+
 static int32_t AddAeTag(struct HksParamSet *paramSet, const struct HksBlob *inText, bool isEncrypt)
 {
     int32_t ret;
@@ -217,6 +217,24 @@ int32_t HksClientVerify(const struct HksBlob *key, const struct HksParamSet *par
     return HksServiceVerify(&processInfo, key, paramSet, srcData, signature);
 }
 
+int32_t HksClientBatchVerify(const struct HksBlob *keyAlias, const struct HksParamSet *paramSet,
+    const struct HksBlob *srcData, const struct HksBlob *signature, uint32_t count, struct HksBlob *result)
+{
+    char *processName = NULL;
+    char *userId = NULL;
+    HKS_IF_NOT_SUCC_LOGE_RETURN(GetProcessInfo(paramSet, &processName, &userId), HKS_ERROR_INTERNAL_ERROR,
+        "get process info failed")
+
+    struct HksProcessInfo processInfo = {
+        { strlen(userId), (uint8_t *)userId },
+        { strlen(processName), (uint8_t *)processName },
+        0,
+        0,
+        0
+    };
+    return HksServiceBatchVerify(&processInfo, keyAlias, paramSet, srcData, signature, count, result);
+}
+
 int32_t HksClientEncrypt(const struct HksBlob *key, const struct HksParamSet *paramSet,
     const struct HksBlob *plainText, struct HksBlob *cipherText)
 {
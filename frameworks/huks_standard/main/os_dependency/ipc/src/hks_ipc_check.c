@@ -259,6 +259,44 @@ int32_t HksCheckIpcCertificateChain(const struct HksBlob *keyAlias, const struct
     return HKS_SUCCESS;
 }
 
+static int32_t AddBlobPackSize(const struct HksBlob *blob, uint32_t *packSize)
+{
+    if (CheckBlob(blob) != HKS_SUCCESS || blob->size > MAX_PROCESS_SIZE) {
+        return HKS_ERROR_INVALID_ARGUMENT;
+    }
+    uint32_t blobPackSize = sizeof(blob->size) + ALIGN_SIZE(blob->size);
+    if (IsAdditionOverflow(*packSize, blobPackSize) || (*packSize + blobPackSize) > MAX_PROCESS_SIZE) {
+        return HKS_ERROR_INVALID_ARGUMENT;
+    }
+    *packSize += blobPackSize;
+    return HKS_SUCCESS;
+}
+
+int32_t HksCheckIpcBatchVerify(const struct HksBlob *keyAlias, const struct HksParamSet *paramSet,
+    const struct HksBlob *srcData, const struct HksBlob *signature, uint32_t count, const struct HksBlob *result,
+    uint32_t *packSize)
+{
+    HKS_IF_NOT_SUCC_RETURN(HksCheckParamSet(paramSet, paramSet->paramSetSize), HKS_ERROR_INVALID_ARGUMENT)
+    if (srcData == NULL || signature == NULL || count == 0 || count > HKS_MAX_BATCH_VERIFY_COUNT ||
+        CheckBlob(result) != HKS_SUCCESS || result->size < HKS_BATCH_VERIFY_RESULT_SIZE(count)) {
+        HKS_LOG_E("invalid batch verify count %" LOG_PUBLIC "u", count);
+        return HKS_ERROR_INVALID_ARGUMENT;
+    }
+
+    /* keyAlias and paramSet, count, every pair and finally the result size */
+    uint32_t size = ALIGN_SIZE(paramSet->paramSetSize) + sizeof(count) + sizeof(result->size);
+    HKS_IF_NOT_SUCC_RETURN(AddBlobPackSize(keyAlias, &size), HKS_ERROR_INVALID_ARGUMENT)
+    for (uint32_t i = 0; i < count; ++i) {
+        if ((AddBlobPackSize(&srcData[i], &size) != HKS_SUCCESS) ||
+            (AddBlobPackSize(&signature[i], &size) != HKS_SUCCESS)) {
+            HKS_LOG_E("ipc batch verify check size of pair %" LOG_PUBLIC "u failed", i);
+            return HKS_ERROR_INVALID_ARGUMENT;
+        }
+    }
+    *packSize = size;
+    return HKS_SUCCESS;
+}
+
 int32_t HksCheckIpcListAliases(const struct HksParamSet *paramSet)
 {
     HKS_IF_NOT_SUCC_RETURN(HksCheckParamSet(paramSet, paramSet->paramSetSize), HKS_ERROR_INVALID_ARGUMENT)
@@ -147,6 +147,19 @@ HKS_API_EXPORT int32_t HksSign(const struct HksBlob *key, const struct HksParamS
 HKS_API_EXPORT int32_t HksVerify(const struct HksBlob *key, const struct HksParamSet *paramSet,
     const struct HksBlob *srcData, const struct HksBlob *signature);
 
+/**
+ * @brief Verify several signatures made with one key
+ * @param key required key to verify data
+ * @param paramSet required parameter set
+ * @param srcData array of count data to verify
+ * @param signature array of count signatures, signature[i] belongs to srcData[i]
+ * @param count number of pairs, at most HKS_MAX_BATCH_VERIFY_COUNT
+ * @param result bitmap of at least HKS_BATCH_VERIFY_RESULT_SIZE(count) bytes, bit i is set when pair i verifies
+ * @return error code, see hks_type.h
+ */
+HKS_API_EXPORT int32_t HksBatchVerify(const struct HksBlob *key, const struct HksParamSet *paramSet,
+    const struct HksBlob *srcData, const struct HksBlob *signature, uint32_t count, struct HksBlob *result);
+
 /**
  * @brief Encrypt operation
  * @param key required key to encrypt data
@@ -83,6 +83,15 @@ struct HksPluginProxy {
     void (*hksPluginOnReceiveEvent)(const void *eventData);
 };
 
+/**
+ * @brief name of an optional function of the plugin, of type HksGetPluginLocalRequestMaskFunc. It returns the local
+ * request codes the plugin handles, bit (1 << code) for each code below 64, and is called once after hksPluginInit.
+ * Local requests of a code whose bit is clear are not passed to the plugin. Without it every request is passed.
+ */
+#define HKS_PLUGIN_LOCAL_REQUEST_MASK_FUNC "HksGetPluginLocalRequestMask"
+
+typedef uint64_t (*HksGetPluginLocalRequestMaskFunc)(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -88,6 +88,9 @@ extern "C" {
 
 #define HKS_MAX_KEY_ALIAS_COUNT 2048
 
+#define HKS_MAX_BATCH_VERIFY_COUNT 256
+#define HKS_BATCH_VERIFY_RESULT_SIZE(count) (((count) + HKS_BITS_PER_BYTE - 1) / HKS_BITS_PER_BYTE)
+
 /**
  * @brief hks blob
  */
@@ -372,6 +372,7 @@ enum HksErrorCode {
     HKS_ERROR_KEY_NODE_NOT_FOUND = -145,
     HKS_ERROR_KEY_NODE_IN_USE = -146,
     HKS_ERROR_RETRYABLE_ERROR = -147,
+    HKS_ERROR_SERVICE_BUSY = -148,
 
     HKS_ERROR_LOAD_PLUGIN_FAIL = -998,
     HKS_ERROR_INTERNAL_ERROR = -999,
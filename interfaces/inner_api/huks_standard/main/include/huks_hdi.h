@@ -575,6 +575,19 @@ struct HuksHdi {
      */
     int32_t (*HuksHdiExportChipsetPlatformPublicKey)(const struct HksBlob *salt,
         enum HksChipsetPlatformDecryptScene scene, struct HksBlob *publicKey);
+
+    /**
+     * @brief Verify several signatures with one key
+     * @param key required key to verify data
+     * @param paramSet required parameter set
+     * @param srcData array of count data to verify
+     * @param signature array of count signatures, signature[i] belongs to srcData[i]
+     * @param count number of pairs
+     * @param result bitmap, bit i is set when pair i verifies
+     * @return error code, see hks_type.h
+     */
+    int32_t (*HuksHdiBatchVerify)(const struct HksBlob *key, const struct HksParamSet *paramSet,
+        const struct HksBlob *srcData, const struct HksBlob *signature, uint32_t count, struct HksBlob *result);
 };
 
 #endif /* HUKS_HDI_H */
@@ -311,6 +311,54 @@ HKS_API_EXPORT int32_t HksVerify(const struct HksBlob *key, const struct HksPara
 #endif
 }
 
+#ifdef HKS_SUPPORT_API_SIGN_VERIFY
+static int32_t LocalBatchVerify(const struct HksBlob *key, const struct HksParamSet *paramSet,
+    const struct HksBlob *srcData, const struct HksBlob *signature, uint32_t count, struct HksBlob *result)
+{
+    if (count == 0 || count > HKS_MAX_BATCH_VERIFY_COUNT || result->data == NULL ||
+        result->size < HKS_BATCH_VERIFY_RESULT_SIZE(count)) {
+        return HKS_ERROR_INVALID_ARGUMENT;
+    }
+    (void)memset_s(result->data, result->size, 0, result->size);
+    for (uint32_t i = 0; i < count; ++i) {
+        if (HksLocalVerify(key, paramSet, &srcData[i], &signature[i]) == HKS_SUCCESS) {
+            result->data[i / HKS_BITS_PER_BYTE] |= (uint8_t)(1u << (i % HKS_BITS_PER_BYTE));
+        }
+    }
+    return HKS_SUCCESS;
+}
+#endif
+
+HKS_API_EXPORT int32_t HksBatchVerify(const struct HksBlob *key, const struct HksParamSet *paramSet,
+    const struct HksBlob *srcData, const struct HksBlob *signature, uint32_t count, struct HksBlob *result)
+{
+#ifdef HKS_SUPPORT_API_SIGN_VERIFY
+    HKS_LOG_D("enter %" LOG_PUBLIC "s", __func__);
+    if ((key == NULL) || (paramSet == NULL) || (srcData == NULL) || (signature == NULL) || (result == NULL)) {
+        return HKS_ERROR_NULL_POINTER;
+    }
+
+    struct HksParam *isKeyAlias = NULL;
+    int32_t ret = HksGetParam(paramSet, HKS_TAG_IS_KEY_ALIAS, &isKeyAlias);
+    if ((ret == HKS_SUCCESS) && (!isKeyAlias->boolParam)) {
+        ret = LocalBatchVerify(key, paramSet, srcData, signature, count, result);
+        HKS_LOG_D("leave batch verify with plain key, result = %" LOG_PUBLIC "d", ret);
+        return ret;
+    }
+    ret = HksClientBatchVerify(key, paramSet, srcData, signature, count, result);
+    HKS_LOG_D("leave %" LOG_PUBLIC "s, result = %" LOG_PUBLIC "d", __func__, ret);
+    return ret;
+#else
+    (void)key;
+    (void)paramSet;
+    (void)srcData;
+    (void)signature;
+    (void)count;
+    (void)result;
+    return HKS_ERROR_API_NOT_SUPPORTED;
+#endif
+}
+
 HKS_API_EXPORT int32_t HksEncrypt(const struct HksBlob *key, const struct HksParamSet *paramSet,
     const struct HksBlob *plainText, struct HksBlob *cipherText)
 {
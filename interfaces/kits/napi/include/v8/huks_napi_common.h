@@ -59,6 +59,8 @@ napi_ref GetCallback(napi_env env, napi_value object);
 
 napi_value GenerateHksResult(napi_env env, int32_t error, uint8_t *data, uint32_t size);
 napi_value GenerateHksResult(napi_env env, int32_t error, uint8_t *data, uint32_t size, const HksParamSet &paramSet);
+// outData is handed to the result without a copy, outData.data is nullptr afterwards
+napi_value GenerateHksResult(napi_env env, int32_t error, HksBlob &outData);
 
 napi_value GenerateStringArray(napi_env env, const struct HksBlob *blob, const uint32_t blobCount);
 
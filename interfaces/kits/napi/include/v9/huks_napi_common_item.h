@@ -35,6 +35,8 @@ struct HksSuccessReturnResult {
     struct HksBlob *outData;
     HksParamSet *paramSet;
     struct HksCertChain *certChain;
+    // outData->data is handed to the returned ArrayBuffer instead of copied, and set to nullptr
+    bool isOutDataTransferred;
 };
 
 struct HksSuccessListAliasesResult {
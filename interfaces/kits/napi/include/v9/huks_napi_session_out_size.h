@@ -0,0 +1,32 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef HUKS_NAPI_SESSION_OUT_SIZE_H
+#define HUKS_NAPI_SESSION_OUT_SIZE_H
+
+#include "hks_type.h"
+
+namespace HuksNapiItem {
+// Remembers from the init paramSet how much output the updates and the finish of a session can return.
+void HksNapiSessionOutSizeInit(const struct HksBlob *handle, const struct HksParamSet *paramSet);
+
+// The out buffer size for an update or finish with inSize bytes, inSize + DATA_SIZE_64KB for a session not known.
+uint32_t HksNapiSessionOutSizeReserve(const struct HksBlob *handle, uint32_t inSize);
+
+// Accounts for the outSize bytes an update returned, the session is forgotten after its finish or abort.
+void HksNapiSessionOutSizeComplete(const struct HksBlob *handle, uint32_t outSize, bool isEnd);
+}  // namespace HuksNapiItem
+
+#endif  // HUKS_NAPI_SESSION_OUT_SIZE_H
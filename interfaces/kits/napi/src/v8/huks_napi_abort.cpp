@@ -23,6 +23,7 @@
 #include "hks_param.h"
 #include "hks_type.h"
 #include "huks_napi_common.h"
+#include "huks_napi_session_out_size.h"
 
 namespace HuksNapi {
 namespace {
@@ -112,6 +113,7 @@ static napi_value AbortAsyncWork(napi_env env, AbortAsyncContext &context)
         },
         [](napi_env env, napi_status status, void *data) {
             AbortAsyncContext napiContext = static_cast<AbortAsyncContext>(data);
+            HuksNapiItem::HksNapiSessionOutSizeComplete(napiContext->handle, 0, true);
             napi_value result = AbortWriteResult(env, napiContext);
             if (napiContext->callback == nullptr) {
                 napi_resolve_deferred(env, napiContext->deferred, result);
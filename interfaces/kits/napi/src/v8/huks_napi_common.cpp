@@ -86,6 +86,10 @@ napi_value GetUint8Array(napi_env env, napi_value object, HksBlob &arrayBlob)
         env, napi_get_typedarray_info(env, object, &arrayType, &length, &rawData, &arrayBuffer, &offset));
     NAPI_ASSERT(env, arrayType == napi_uint8_array, "it's not uint8 array");
 
+    bool isDetached = false;
+    NAPI_CALL(env, napi_is_detached_arraybuffer(env, arrayBuffer, &isDetached));
+    NAPI_ASSERT(env, !isDetached, "the buffer of uint8 array is detached");
+
     if (length > HKS_MAX_DATA_LEN) {
         HKS_LOG_E("data len is too large, len = %" LOG_PUBLIC "zx", length);
         return nullptr;
@@ -329,16 +333,8 @@ static napi_value GenerateHksParamArray(napi_env env, const HksParamSet &paramSe
     return paramArray;
 }
 
-static napi_value GenerateResult(napi_env env, int32_t error, uint8_t *data, uint32_t size,
-    const HksParamSet *paramSet)
+static napi_value GenerateOutData(napi_env env, uint8_t *data, uint32_t size)
 {
-    napi_value result = nullptr;
-    NAPI_CALL(env, napi_create_object(env, &result));
-
-    napi_value errorCode = nullptr;
-    NAPI_CALL(env, napi_create_int32(env, error, &errorCode));
-    NAPI_CALL(env, napi_set_named_property(env, result, HKS_RESULT_PROPERTY_ERRORCODE.c_str(), errorCode));
-
     napi_value outData = nullptr;
     if (data != nullptr && size != 0) {
         napi_value outBuffer = GenerateArrayBuffer(env, data, size);
@@ -348,6 +344,41 @@ static napi_value GenerateResult(napi_env env, int32_t error, uint8_t *data, uin
     } else {
         outData = GetNull(env);
     }
+    return outData;
+}
+
+// the ArrayBuffer takes data over without a copy, data is nullptr once it does
+static napi_value TransferOutData(napi_env env, HksBlob &data)
+{
+    if (data.data == nullptr || data.size == 0) {
+        return GetNull(env);
+    }
+    uint32_t size = data.size;
+    napi_value outBuffer = nullptr;
+    napi_status status = napi_create_external_arraybuffer(
+        env, data.data, size, [](napi_env env, void *data, void *hint) { HKS_FREE(data); }, nullptr, &outBuffer);
+    if (status != napi_ok) {
+        GET_AND_THROW_LAST_ERROR((env));
+        return nullptr;
+    }
+    // free by finalize callback
+    data.data = nullptr;
+    data.size = 0;
+
+    napi_value outData = nullptr;
+    NAPI_CALL(env, napi_create_typedarray(env, napi_uint8_array, size, outBuffer, 0, &outData));
+    return outData;
+}
+
+static napi_value GenerateResult(napi_env env, int32_t error, napi_value outData, const HksParamSet *paramSet)
+{
+    napi_value result = nullptr;
+    NAPI_CALL(env, napi_create_object(env, &result));
+
+    napi_value errorCode = nullptr;
+    NAPI_CALL(env, napi_create_int32(env, error, &errorCode));
+    NAPI_CALL(env, napi_set_named_property(env, result, HKS_RESULT_PROPERTY_ERRORCODE.c_str(), errorCode));
+
     NAPI_CALL(env, napi_set_named_property(env, result, HKS_RESULT_PROPERTY_OUTDATA.c_str(), outData));
 
     napi_value properties = nullptr;
@@ -363,12 +394,17 @@ static napi_value GenerateResult(napi_env env, int32_t error, uint8_t *data, uin
 
 napi_value GenerateHksResult(napi_env env, int32_t error, uint8_t *data, uint32_t size)
 {
-    return GenerateResult(env, error, data, size, nullptr);
+    return GenerateResult(env, error, GenerateOutData(env, data, size), nullptr);
 }
 
 napi_value GenerateHksResult(napi_env env, int32_t error, uint8_t *data, uint32_t size, const HksParamSet &paramSet)
 {
-    return GenerateResult(env, error, data, size, &paramSet);
+    return GenerateResult(env, error, GenerateOutData(env, data, size), &paramSet);
+}
+
+napi_value GenerateHksResult(napi_env env, int32_t error, HksBlob &outData)
+{
+    return GenerateResult(env, error, TransferOutData(env, outData), nullptr);
 }
 
 static napi_value GenerateBusinessError(napi_env env, int32_t errorCode)
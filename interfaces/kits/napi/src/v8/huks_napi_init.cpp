@@ -23,6 +23,7 @@
 #include "hks_param.h"
 #include "hks_type.h"
 #include "huks_napi_common.h"
+#include "huks_napi_session_out_size.h"
 
 namespace HuksNapi {
 namespace {
@@ -163,6 +164,9 @@ static napi_value InitAsyncWork(napi_env env, InitAsyncCtxPtr &context)
         },
         [](napi_env env, napi_status status, void *data) {
             InitAsyncCtxPtr napiContext = static_cast<InitAsyncCtxPtr>(data);
+            if (napiContext->result == HKS_SUCCESS) {
+                HuksNapiItem::HksNapiSessionOutSizeInit(napiContext->handle, napiContext->paramSet);
+            }
             napi_value result = InitWriteResult(env, napiContext);
             if (napiContext->callback == nullptr) {
                 napi_resolve_deferred(env, napiContext->deferred, result);
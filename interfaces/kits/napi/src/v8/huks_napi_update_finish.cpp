@@ -25,6 +25,7 @@
 #include "hks_param.h"
 #include "hks_type.h"
 #include "huks_napi_common.h"
+#include "huks_napi_session_out_size.h"
 
 namespace HuksNapi {
 namespace {
@@ -103,7 +104,7 @@ static int32_t FillContextInDataAndOutData(napi_env env, napi_value *argv, Updat
         context->inData->data = nullptr;
     }
 
-    context->outData->size = context->inData->size + DATA_SIZE_64KB;
+    context->outData->size = HuksNapiItem::HksNapiSessionOutSizeReserve(context->handle, context->inData->size);
     context->outData->data = static_cast<uint8_t *>(HksMalloc(context->outData->size));
     if (context->outData->data == nullptr) {
         HKS_LOG_E("malloc memory failed");
@@ -341,10 +342,13 @@ static napi_value ParseUpdateParams(napi_env env, napi_callback_info info, Updat
 
 static napi_value UpdateWriteResult(napi_env env, UpdateAsyncContext context)
 {
-    return GenerateHksResult(env,
-        context->result,
-        ((context->result == HKS_SUCCESS && context->outData != nullptr) ? context->outData->data : nullptr),
-        (context->result == HKS_SUCCESS && context->outData != nullptr) ? context->outData->size : 0);
+    bool isSucc = context->result == HKS_SUCCESS && context->outData != nullptr;
+    HuksNapiItem::HksNapiSessionOutSizeComplete(context->handle, isSucc ? context->outData->size : 0,
+        !context->isUpdate || !isSucc);
+    if (!isSucc) {
+        return GenerateHksResult(env, context->result, nullptr, 0);
+    }
+    return GenerateHksResult(env, context->result, *context->outData);
 }
 
 static napi_value UpdateFinishAsyncWork(napi_env env, UpdateAsyncContext &context)
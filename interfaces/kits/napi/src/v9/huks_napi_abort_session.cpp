@@ -23,6 +23,7 @@
 #include "hks_param.h"
 #include "hks_type.h"
 #include "huks_napi_common_item.h"
+#include "huks_napi_session_out_size.h"
 
 namespace HuksNapiItem {
 constexpr int HUKS_NAPI_ABORT_MIN_ARGS = 2;
@@ -106,6 +107,7 @@ napi_value AbortAsyncWork(napi_env env, AbortAsyncContext &context)
         },
         [](napi_env env, napi_status status, void *data) {
             AbortAsyncContext napiContext = static_cast<AbortAsyncContext>(data);
+            HksNapiSessionOutSizeComplete(napiContext->handle, 0, true);
             HksSuccessReturnResult resultData;
             SuccessReturnResultInit(resultData);
             HksReturnNapiResult(env, napiContext->callback, napiContext->deferred, napiContext->result, resultData);
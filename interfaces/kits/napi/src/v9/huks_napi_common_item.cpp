@@ -102,6 +102,15 @@ napi_value GetUint8Array(napi_env env, napi_value object, HksBlob &arrayBlob)
         return nullptr;
     }
 
+    bool isDetached = false;
+    NAPI_CALL(env, napi_is_detached_arraybuffer(env, arrayBuffer, &isDetached));
+    if (isDetached) {
+        HksNapiThrow(env, HUKS_ERR_CODE_ILLEGAL_ARGUMENT,
+            "the buffer of data is detached");
+        HKS_LOG_E("the buffer of data is detached");
+        return nullptr;
+    }
+
     if (length > HKS_MAX_DATA_LEN) {
         HksNapiThrow(env, HUKS_ERR_CODE_ILLEGAL_ARGUMENT,
             "the length of data is too long");
@@ -367,6 +376,19 @@ static napi_value GenerateArrayBuffer(napi_env env, uint8_t *data, uint32_t size
     return outBuffer;
 }
 
+// hands data to the ArrayBuffer without a copy, data is nullptr once the ArrayBuffer owns it
+static napi_value TransferArrayBuffer(napi_env env, uint8_t *&data, uint32_t size)
+{
+    napi_value outBuffer = nullptr;
+    napi_status status = napi_create_external_arraybuffer(
+        env, data, size, [](napi_env env, void *data, void *hint) { HKS_FREE(data); }, nullptr, &outBuffer);
+    if (status != napi_ok) {
+        return nullptr;
+    }
+    data = nullptr;
+    return outBuffer;
+}
+
 static napi_value GenerateHksParam(napi_env env, const HksParam &param)
 {
     napi_value hksParam = nullptr;
@@ -730,19 +752,24 @@ static napi_value AddHandleOrChallenge(napi_env env, napi_value &object,
 }
 
 static napi_value AddOutDataParamSetOrCertChain(napi_env env, napi_value &object,
-    const struct HksBlob *outData, const HksParamSet *paramSet, const struct HksCertChain *certChain)
+    const struct HksSuccessReturnResult &resultData)
 {
     napi_value addResult = nullptr;
+    struct HksBlob *outData = resultData.outData;
+    const HksParamSet *paramSet = resultData.paramSet;
+    const struct HksCertChain *certChain = resultData.certChain;
 
     // add outData
     if ((outData != nullptr) && (outData->data != nullptr) && (outData->size != 0)) {
         napi_value outDataJs = nullptr;
-        napi_value outBuffer = GenerateArrayBuffer(env, outData->data, outData->size);
+        uint32_t outSize = outData->size;
+        napi_value outBuffer = resultData.isOutDataTransferred ? TransferArrayBuffer(env, outData->data, outSize) :
+            GenerateArrayBuffer(env, outData->data, outSize);
         if (outBuffer == nullptr) {
             HKS_LOG_E("add outData failed");
             return nullptr;
         }
-        NAPI_CALL(env, napi_create_typedarray(env, napi_uint8_array, outData->size, outBuffer, 0, &outDataJs));
+        NAPI_CALL(env, napi_create_typedarray(env, napi_uint8_array, outSize, outBuffer, 0, &outDataJs));
         NAPI_CALL(env, napi_set_named_property(env, object, HKS_RESULT_PROPERTY_OUTDATA.c_str(), outDataJs));
         addResult = GetInt32(env, 0);
     }
@@ -789,8 +816,7 @@ static napi_value GenerateResult(napi_env env, const struct HksSuccessReturnResu
     }
 
     napi_value status1 = AddHandleOrChallenge(env, result, resultData.handle, resultData.challenge);
-    napi_value status2 = AddOutDataParamSetOrCertChain(env, result,
-        resultData.outData, resultData.paramSet, resultData.certChain);
+    napi_value status2 = AddOutDataParamSetOrCertChain(env, result, resultData);
     if (status1 == nullptr && status2 == nullptr) {
         return GetNull(env);
     }
@@ -907,6 +933,7 @@ void SuccessReturnResultInit(struct HksSuccessReturnResult &resultData)
     resultData.outData = nullptr;
     resultData.paramSet = nullptr;
     resultData.certChain = nullptr;
+    resultData.isOutDataTransferred = false;
 }
 
 void SuccessListAliasesReturnResultInit(struct HksSuccessListAliasesResult &resultData)
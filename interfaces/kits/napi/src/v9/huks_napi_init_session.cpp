@@ -23,6 +23,7 @@
 #include "hks_param.h"
 #include "hks_type.h"
 #include "huks_napi_common_item.h"
+#include "huks_napi_session_out_size.h"
 
 namespace HuksNapiItem {
 constexpr int HUKS_NAPI_INIT_MIN_ARGS = 2;
@@ -142,6 +143,9 @@ napi_value InitAsyncWork(napi_env env, InitAsyncCtxPtr &context)
         },
         [](napi_env env, napi_status status, void *data) {
             InitAsyncCtxPtr napiContext = static_cast<InitAsyncCtxPtr>(data);
+            if (napiContext->result == HKS_SUCCESS) {
+                HksNapiSessionOutSizeInit(napiContext->handle, napiContext->paramSet);
+            }
             HksSuccessReturnResult resultData;
             SuccessReturnResultInit(resultData);
             resultData.handle = napiContext->handle;
@@ -0,0 +1,132 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "huks_napi_session_out_size.h"
+
+#include <algorithm>
+#include <mutex>
+#include <unordered_map>
+
+#include "securec.h"
+
+#include "hks_param.h"
+
+namespace HuksNapiItem {
+namespace {
+// covers block padding, AEAD tags and nonces, and the signatures and ciphertexts of the largest keys
+constexpr uint32_t SESSION_OUT_RESERVED_SIZE = HKS_MAX_KEY_LEN;
+constexpr uint32_t UNKNOWN_SESSION_OUT_RESERVED_SIZE = 1024 * 64;
+// sessions left without finish or abort are not tracked past this, later ones get the size of an unknown session
+constexpr size_t MAX_SESSION_COUNT = 1024;
+
+struct SessionOutSize {
+    // the input of the updates is cached and only returned by the finish, as for ccm and asymmetric ciphers
+    bool isCached;
+    // the input passed in and not returned yet
+    uint64_t pendingSize;
+};
+
+std::mutex g_sessionLock;
+std::unordered_map<uint64_t, SessionOutSize> g_sessions;
+
+// the whole handle is the key: it fits in the 32 bits js keeps, so two live sessions never share one
+bool GetSessionKey(const struct HksBlob *handle, uint64_t &key)
+{
+    if (handle == nullptr || handle->data == nullptr || handle->size != sizeof(uint64_t)) {
+        return false;
+    }
+    (void)memcpy_s(&key, sizeof(key), handle->data, handle->size);
+    return true;
+}
+
+uint32_t GetUint32Param(const struct HksParamSet *paramSet, uint32_t tag, uint32_t defaultValue)
+{
+    struct HksParam *param = nullptr;
+    return HksGetParam(paramSet, tag, &param) == HKS_SUCCESS ? param->uint32Param : defaultValue;
+}
+
+// false for the sessions whose output is not bound by their input, such as derive and agree
+bool GetIsCached(const struct HksParamSet *paramSet, bool &isCached)
+{
+    uint32_t purpose = GetUint32Param(paramSet, HKS_TAG_PURPOSE, 0);
+    uint32_t alg = GetUint32Param(paramSet, HKS_TAG_ALGORITHM, 0);
+    switch (purpose) {
+        case HKS_KEY_PURPOSE_SIGN:
+        case HKS_KEY_PURPOSE_VERIFY:
+        case HKS_KEY_PURPOSE_MAC:
+            isCached = false;
+            return true;
+        case HKS_KEY_PURPOSE_ENCRYPT:
+        case HKS_KEY_PURPOSE_DECRYPT: {
+            bool isSymmetric = alg == HKS_ALG_AES || alg == HKS_ALG_SM4 || alg == HKS_ALG_DES || alg == HKS_ALG_3DES;
+            isCached = !isSymmetric || GetUint32Param(paramSet, HKS_TAG_BLOCK_MODE, 0) == HKS_MODE_CCM;
+            return true;
+        }
+        default:
+            return false;
+    }
+}
+}  // namespace
+
+void HksNapiSessionOutSizeInit(const struct HksBlob *handle, const struct HksParamSet *paramSet)
+{
+    uint64_t key = 0;
+    bool isCached = false;
+    // a handle wider than 32 bits never comes back from js, so it is not tracked
+    if (paramSet == nullptr || !GetSessionKey(handle, key) || key > UINT32_MAX || !GetIsCached(paramSet, isCached)) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(g_sessionLock);
+    if (g_sessions.size() >= MAX_SESSION_COUNT && g_sessions.find(key) == g_sessions.end()) {
+        return;
+    }
+    g_sessions[key] = { isCached, 0 };
+}
+
+uint32_t HksNapiSessionOutSizeReserve(const struct HksBlob *handle, uint32_t inSize)
+{
+    uint64_t outSize = static_cast<uint64_t>(inSize) + UNKNOWN_SESSION_OUT_RESERVED_SIZE;
+    uint64_t key = 0;
+    if (GetSessionKey(handle, key)) {
+        std::lock_guard<std::mutex> lock(g_sessionLock);
+        auto it = g_sessions.find(key);
+        if (it != g_sessions.end()) {
+            // an update queued before this one has not returned yet, its input is counted as pending already
+            uint64_t pendingSize = it->second.isCached ? it->second.pendingSize : 0;
+            outSize = pendingSize + inSize + SESSION_OUT_RESERVED_SIZE;
+            it->second.pendingSize += inSize;
+        }
+    }
+    return static_cast<uint32_t>(std::min<uint64_t>(outSize, UINT32_MAX));
+}
+
+void HksNapiSessionOutSizeComplete(const struct HksBlob *handle, uint32_t outSize, bool isEnd)
+{
+    uint64_t key = 0;
+    if (!GetSessionKey(handle, key)) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(g_sessionLock);
+    auto it = g_sessions.find(key);
+    if (it == g_sessions.end()) {
+        return;
+    }
+    if (isEnd) {
+        g_sessions.erase(it);
+        return;
+    }
+    it->second.pendingSize -= std::min<uint64_t>(it->second.pendingSize, outSize);
+}
+}  // namespace HuksNapiItem
@@ -25,6 +25,7 @@
 #include "hks_param.h"
 #include "hks_type.h"
 #include "huks_napi_common_item.h"
+#include "huks_napi_session_out_size.h"
 
 namespace HuksNapiItem {
 constexpr int HUKS_NAPI_UPDATE_MIN_ARGS = 2;
@@ -86,7 +87,7 @@ static int32_t FillContextInDataAndOutData(napi_env env, napi_value *argv, Updat
         context->inData->data = nullptr;
     }
 
-    context->outData->size = context->inData->size + DATA_SIZE_64KB;
+    context->outData->size = HksNapiSessionOutSizeReserve(context->handle, context->inData->size);
     context->outData->data = static_cast<uint8_t *>(HksMalloc(context->outData->size));
     if (context->outData->data == nullptr) {
         HKS_LOG_E("malloc memory failed");
@@ -285,9 +286,13 @@ napi_value UpdateFinishAsyncWork(napi_env env, UpdateAsyncContext &context)
         },
         [](napi_env env, napi_status status, void *data) {
             UpdateAsyncContext napiContext = static_cast<UpdateAsyncContext>(data);
+            bool isSucc = napiContext->result == HKS_SUCCESS;
+            HksNapiSessionOutSizeComplete(napiContext->handle, isSucc ? napiContext->outData->size : 0,
+                !napiContext->isUpdate || !isSucc);
             HksSuccessReturnResult resultData;
             SuccessReturnResultInit(resultData);
             resultData.outData = napiContext->outData;
+            resultData.isOutDataTransferred = true;
             HksReturnNapiResult(env, napiContext->callback, napiContext->deferred, napiContext->result, resultData);
             DeleteUpdateAsyncContext(env, napiContext);
         },
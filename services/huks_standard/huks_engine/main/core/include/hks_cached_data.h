@@ -0,0 +1,51 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef HKS_CACHED_DATA_H
+#define HKS_CACHED_DATA_H
+
+#include <stdint.h>
+
+#include "hks_type.h"
+
+/*
+ * Input the algorithms that cannot process it piecewise cache until finish. The buffer grows to twice its capacity
+ * when it is full, and what it held is zeroized before it is freed. blob comes first, so a ctx holding this can
+ * still be freed as a cached blob: zeroize blob.size bytes, free blob.data and the ctx.
+ */
+struct HksCachedData {
+    struct HksBlob blob;
+    uint32_t capacity;
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+struct HksCachedData *HksCreateCachedData(void);
+
+/* HKS_ERROR_INVALID_ARGUMENT when the cached data would exceed maxSize, the cached data is left as it was then */
+int32_t HksAppendCachedData(struct HksCachedData *cachedData, const struct HksBlob *inData, uint32_t maxSize);
+
+/* hands the buffer over to outData, which owns it from then on, and leaves cachedData empty */
+void HksTakeCachedData(struct HksCachedData *cachedData, struct HksBlob *outData);
+
+void HksFreeCachedData(struct HksCachedData **cachedData);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HKS_CACHED_DATA_H */
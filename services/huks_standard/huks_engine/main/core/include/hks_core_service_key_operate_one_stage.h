@@ -32,6 +32,9 @@ int32_t HksCoreSign(const struct HksBlob *key, const struct HksParamSet *paramSe
 int32_t HksCoreVerify(const struct HksBlob *key, const struct HksParamSet *paramSet, const struct HksBlob *srcData,
     const struct HksBlob *signature);
 
+int32_t HksCoreBatchVerify(const struct HksBlob *key, const struct HksParamSet *paramSet,
+    const struct HksBlob *srcData, const struct HksBlob *signature, uint32_t count, struct HksBlob *result);
+
 int32_t HksCoreEncrypt(const struct HksBlob *key, const struct HksParamSet *paramSet, const struct HksBlob *plainText,
     struct HksBlob *cipherText);
 
@@ -38,25 +38,25 @@ int32_t HksCoreAbort(const struct HksBlob *handle, const struct HksParamSet *par
 
 struct HksCoreInitHandler {
     enum HksKeyPurpose pur;
-    int32_t (*handler)(const struct HuksKeyNode *keyNode, const struct HksParamSet *paramSet,
+    int32_t (*handler)(struct HuksKeyNode *keyNode, const struct HksParamSet *paramSet,
         uint32_t alg);
 };
 
 struct HksCoreUpdateHandler {
     enum HksKeyPurpose pur;
-    int32_t (*handler)(const struct HuksKeyNode *keyNode, const struct HksParamSet *paramSet,
+    int32_t (*handler)(struct HuksKeyNode *keyNode, const struct HksParamSet *paramSet,
         const struct HksBlob *srcData, struct HksBlob *signature, uint32_t alg);
 };
 
 struct HksCoreFinishHandler {
     enum HksKeyPurpose pur;
-    int32_t (*handler)(const struct HuksKeyNode *keyNode, const struct HksParamSet *paramSet,
+    int32_t (*handler)(struct HuksKeyNode *keyNode, const struct HksParamSet *paramSet,
         const struct HksBlob *inData, struct HksBlob *outData, uint32_t alg);
 };
 
 struct HksCoreAbortHandler {
     enum HksKeyPurpose pur;
-    int32_t (*handler)(const struct HuksKeyNode *keyNode, const struct HksParamSet *paramSet, uint32_t alg);
+    int32_t (*handler)(struct HuksKeyNode *keyNode, const struct HksParamSet *paramSet, uint32_t alg);
 };
 
 #ifdef __cplusplus
@@ -30,67 +30,67 @@
 extern "C" {
 #endif
 
-int32_t HksCoreSignVerifyThreeStageInit(const struct HuksKeyNode *keyNode, const struct HksParamSet *paramSet,
+int32_t HksCoreSignVerifyThreeStageInit(struct HuksKeyNode *keyNode, const struct HksParamSet *paramSet,
     uint32_t alg);
 
-int32_t HksCoreSignVerifyThreeStageUpdate(const struct HuksKeyNode *keyNode, const struct HksParamSet *paramSet,
+int32_t HksCoreSignVerifyThreeStageUpdate(struct HuksKeyNode *keyNode, const struct HksParamSet *paramSet,
     const struct HksBlob *srcData, struct HksBlob *signature, uint32_t alg);
 
-int32_t HksCoreSignVerifyThreeStageFinish(const struct HuksKeyNode *keyNode, const struct HksParamSet *paramSet,
+int32_t HksCoreSignVerifyThreeStageFinish(struct HuksKeyNode *keyNode, const struct HksParamSet *paramSet,
     const struct HksBlob *inData, struct HksBlob *outData, uint32_t alg);
 
-int32_t HksCoreSignVerifyThreeStageAbort(const struct HuksKeyNode *keyNode, const struct HksParamSet *paramSet,
+int32_t HksCoreSignVerifyThreeStageAbort(struct HuksKeyNode *keyNode, const struct HksParamSet *paramSet,
     uint32_t alg);
 
-int32_t HksCoreCryptoThreeStageInit(const struct HuksKeyNode *keyNode, const struct HksParamSet *paramSet,
+int32_t HksCoreCryptoThreeStageInit(struct HuksKeyNode *keyNode, const struct HksParamSet *paramSet,
     uint32_t alg);
 
-int32_t HksCoreCryptoThreeStageUpdate(const struct HuksKeyNode *keyNode, const struct HksParamSet *paramSet,
+int32_t HksCoreCryptoThreeStageUpdate(struct HuksKeyNode *keyNode, const struct HksParamSet *paramSet,
     const struct HksBlob *inData, struct HksBlob *outData, uint32_t alg);
 
-int32_t HksCoreEncryptThreeStageFinish(const struct HuksKeyNode *keyNode, const struct HksParamSet *paramSet,
+int32_t HksCoreEncryptThreeStageFinish(struct HuksKeyNode *keyNode, const struct HksParamSet *paramSet,
     const struct HksBlob *inData, struct HksBlob *outData, uint32_t alg);
 
-int32_t HksCoreCryptoThreeStageAbort(const struct HuksKeyNode *keyNode, const struct HksParamSet *paramSet,
+int32_t HksCoreCryptoThreeStageAbort(struct HuksKeyNode *keyNode, const struct HksParamSet *paramSet,
     uint32_t alg);
 
-int32_t HksCoreDecryptThreeStageFinish(const struct HuksKeyNode *keyNode, const struct HksParamSet *paramSet,
+int32_t HksCoreDecryptThreeStageFinish(struct HuksKeyNode *keyNode, const struct HksParamSet *paramSet,
     const struct HksBlob *inData, struct HksBlob *outData, uint32_t alg);
 
-int32_t HksCoreDeriveThreeStageInit(const struct HuksKeyNode *keyNode, const struct HksParamSet *paramSet,
+int32_t HksCoreDeriveThreeStageInit(struct HuksKeyNode *keyNode, const struct HksParamSet *paramSet,
     uint32_t alg);
 
-int32_t HksCoreDeriveThreeStageUpdate(const struct HuksKeyNode *keyNode, const struct HksParamSet *paramSet,
+int32_t HksCoreDeriveThreeStageUpdate(struct HuksKeyNode *keyNode, const struct HksParamSet *paramSet,
     const struct HksBlob *srcData, struct HksBlob *derive, uint32_t alg);
 
-int32_t HksCoreDeriveThreeStageFinish(const struct HuksKeyNode *keyNode, const struct HksParamSet *paramSet,
+int32_t HksCoreDeriveThreeStageFinish(struct HuksKeyNode *keyNode, const struct HksParamSet *paramSet,
     const struct HksBlob *inData, struct HksBlob *outData, uint32_t alg);
 
-int32_t HksCoreDeriveThreeStageAbort(const struct HuksKeyNode *keyNode, const struct HksParamSet *paramSet,
+int32_t HksCoreDeriveThreeStageAbort(struct HuksKeyNode *keyNode, const struct HksParamSet *paramSet,
     uint32_t alg);
 
-int32_t HksCoreAgreeThreeStageInit(const struct HuksKeyNode *keyNode, const struct HksParamSet *paramSet,
+int32_t HksCoreAgreeThreeStageInit(struct HuksKeyNode *keyNode, const struct HksParamSet *paramSet,
     uint32_t alg);
 
-int32_t HksCoreAgreeThreeStageUpdate(const struct HuksKeyNode *keyNode, const struct HksParamSet *paramSet,
+int32_t HksCoreAgreeThreeStageUpdate(struct HuksKeyNode *keyNode, const struct HksParamSet *paramSet,
     const struct HksBlob *srcData, struct HksBlob *signature, uint32_t alg);
 
-int32_t HksCoreAgreeThreeStageFinish(const struct HuksKeyNode *keyNode, const struct HksParamSet *paramSet,
+int32_t HksCoreAgreeThreeStageFinish(struct HuksKeyNode *keyNode, const struct HksParamSet *paramSet,
     const struct HksBlob *inData, struct HksBlob *outData, uint32_t alg);
 
-int32_t HksCoreAgreeThreeStageAbort(const struct HuksKeyNode *keyNode, const struct HksParamSet *paramSet,
+int32_t HksCoreAgreeThreeStageAbort(struct HuksKeyNode *keyNode, const struct HksParamSet *paramSet,
     uint32_t alg);
 
-int32_t HksCoreMacThreeStageInit(const struct HuksKeyNode *keyNode, const struct HksParamSet *paramSet,
+int32_t HksCoreMacThreeStageInit(struct HuksKeyNode *keyNode, const struct HksParamSet *paramSet,
     uint32_t alg);
 
-int32_t HksCoreMacThreeStageUpdate(const struct HuksKeyNode *keyNode, const struct HksParamSet *paramSet,
+int32_t HksCoreMacThreeStageUpdate(struct HuksKeyNode *keyNode, const struct HksParamSet *paramSet,
     const struct HksBlob *srcData, struct HksBlob *mac, uint32_t alg);
 
-int32_t HksCoreMacThreeStageFinish(const struct HuksKeyNode *keyNode, const struct HksParamSet *paramSet,
+int32_t HksCoreMacThreeStageFinish(struct HuksKeyNode *keyNode, const struct HksParamSet *paramSet,
     const struct HksBlob *inData, struct HksBlob *outData, uint32_t alg);
 
-int32_t HksCoreMacThreeStageAbort(const struct HuksKeyNode *keyNode, const struct HksParamSet *paramSet,
+int32_t HksCoreMacThreeStageAbort(struct HuksKeyNode *keyNode, const struct HksParamSet *paramSet,
     uint32_t alg);
 
 #ifdef __cplusplus
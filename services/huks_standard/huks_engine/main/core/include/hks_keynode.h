@@ -16,8 +16,10 @@
 #ifndef HKS_KEYNODE_H
 #define HKS_KEYNODE_H
 
+#include <stdbool.h>
 #include <stdint.h>
 
+#include "hks_crypto_hal.h"
 #include "hks_double_list.h"
 #include "hks_type.h"
 #include "hks_mutex.h"
@@ -27,15 +29,45 @@
 #define HKS_KEYNODE_HANDLE_INVALID_VALUE 0
 #define HKS_KEYNODE_HANDLE_INITIAL_VALUE 1
 
+/**
+ * @brief usage spec of a cipher or sign/verify operation, built once at init and used until finish. algParam of
+ * usageSpec points to cipherParam or aeadParam, whose iv, nonce, aad and decrypt tag point into specData, a copy
+ * owned by the key node, so the spec stays valid when the runtime paramset is rebuilt
+ */
+struct HksKeyNodeUsageSpec {
+    struct HksUsageSpec usageSpec;
+    struct HksCipherParam cipherParam;
+    struct HksAeadParam aeadParam;
+    uint8_t *specData;
+    uint32_t keyLen;
+    bool isAeMode;         // aes gcm or ccm
+    bool needAppendNonce;  // the nonce was generated at init and is appended to the cipher text
+    bool isBuilt;
+};
+
+/**
+ * @brief state of the operation on the key, parsed from the caller's paramset when the key node is created, so that
+ * update and finish need no paramset lookups
+ */
+struct HksKeyNodeSession {
+    void *ctx;              // crypto engine context, or the data cached or derived until finish
+    uint32_t purpose;
+    uint32_t alg;
+    uint32_t mode;
+    uint32_t padding;
+    uint32_t digest;
+    uint32_t keySize;       // of the key blob
+    bool hasMode;
+    bool hasPadding;
+    bool hasDigest;
+    bool hasKeySize;
+    bool isUserAuthAccess;  // set by HksCoreSecureAccessInitParams, auth state is in authRuntimeParamSet if true
+    struct HksKeyNodeUsageSpec spec;
+};
+
 struct HuksKeyNode {
     struct DoubleList listHead;
     struct HksParamSet *keyBlobParamSet;
-
-    /**
-     * @brief used to cache params of caller and state or temp prop in memory during using key
-     * CURRENT state:
-     * uint64_t crypto_ctx;     // crypto engine context
-     */
     struct HksParamSet *runtimeParamSet; // only used to store caller's paramset
 
     /**
@@ -52,6 +84,7 @@ struct HuksKeyNode {
     uint64_t handle;
     uint64_t batchOperationTimestamp;
     bool isBatchOperation;
+    struct HksKeyNodeSession session;
 };
 
 #ifdef __cplusplus
@@ -42,6 +42,8 @@ int32_t HksCheckKeybBlobIsSupportUserAuth(const struct HksParamSet *blobParamSet
 
 int32_t CheckIfNeedIsDevicePasswordSet(const struct HksParamSet *paramSet);
 
+void HksCoreSecureAccessClearAuthTokenCache(void);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,105 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _CUT_AUTHENTICATE_
+
+#include "hks_cached_data.h"
+
+#include <stddef.h>
+
+#include "hks_log.h"
+#include "hks_mem.h"
+#include "hks_template.h"
+#include "securec.h"
+
+#define HKS_CACHED_DATA_GROWTH 2
+
+struct HksCachedData *HksCreateCachedData(void)
+{
+    struct HksCachedData *cachedData = (struct HksCachedData *)HksMalloc(sizeof(struct HksCachedData));
+    HKS_IF_NULL_LOGE_RETURN(cachedData, NULL, "malloc cached data failed")
+
+    cachedData->blob.size = 0;
+    cachedData->blob.data = NULL;
+    cachedData->capacity = 0;
+    return cachedData;
+}
+
+static int32_t ReserveCachedData(struct HksCachedData *cachedData, uint32_t newSize, uint32_t maxSize)
+{
+    if ((newSize <= cachedData->capacity) && (cachedData->blob.data != NULL)) {
+        return HKS_SUCCESS;
+    }
+    uint32_t newCapacity = (cachedData->capacity > maxSize / HKS_CACHED_DATA_GROWTH) ? maxSize :
+        (cachedData->capacity * HKS_CACHED_DATA_GROWTH);
+    if (newCapacity < newSize) {
+        newCapacity = newSize;
+    }
+    /* nothing cached and no input asks for an empty buffer, which HksMalloc refuses */
+    uint8_t *newData = (uint8_t *)HksMalloc(newCapacity);
+    HKS_IF_NULL_LOGE_RETURN(newData, HKS_ERROR_MALLOC_FAIL, "update cache data malloc fail.")
+
+    if (cachedData->blob.size != 0) {
+        (void)memcpy_s(newData, newCapacity, cachedData->blob.data, cachedData->blob.size);
+        (void)memset_s(cachedData->blob.data, cachedData->blob.size, 0, cachedData->blob.size);
+    }
+    HKS_FREE(cachedData->blob.data);
+    cachedData->blob.data = newData;
+    cachedData->capacity = newCapacity;
+    return HKS_SUCCESS;
+}
+
+int32_t HksAppendCachedData(struct HksCachedData *cachedData, const struct HksBlob *inData, uint32_t maxSize)
+{
+    if ((cachedData->blob.size > maxSize) || (inData->size > (maxSize - cachedData->blob.size))) {
+        HKS_LOG_E("input data size too large, size = %" LOG_PUBLIC "u", inData->size);
+        return HKS_ERROR_INVALID_ARGUMENT;
+    }
+
+    uint32_t newSize = cachedData->blob.size + inData->size;
+    int32_t ret = ReserveCachedData(cachedData, newSize, maxSize);
+    HKS_IF_NOT_SUCC_RETURN(ret, ret)
+
+    if (inData->size != 0) {
+        if (memcpy_s(cachedData->blob.data + cachedData->blob.size, cachedData->capacity - cachedData->blob.size,
+            inData->data, inData->size) != EOK) {
+            HKS_LOG_E("memcpy in data failed");
+            return HKS_ERROR_INSUFFICIENT_MEMORY;
+        }
+    }
+    cachedData->blob.size = newSize;
+    return HKS_SUCCESS;
+}
+
+void HksTakeCachedData(struct HksCachedData *cachedData, struct HksBlob *outData)
+{
+    *outData = cachedData->blob;
+    cachedData->blob.data = NULL;
+    cachedData->blob.size = 0;
+    cachedData->capacity = 0;
+}
+
+void HksFreeCachedData(struct HksCachedData **cachedData)
+{
+    if ((cachedData == NULL) || (*cachedData == NULL)) {
+        return;
+    }
+    if ((*cachedData)->blob.data != NULL) {
+        (void)memset_s((*cachedData)->blob.data, (*cachedData)->blob.size, 0, (*cachedData)->blob.size);
+        HKS_FREE((*cachedData)->blob.data);
+    }
+    HKS_FREE(*cachedData);
+}
+#endif /* _CUT_AUTHENTICATE_ */
@@ -128,6 +128,12 @@ int32_t HuksHdiVerify(const struct HksBlob *key, const struct HksParamSet *param
     return HksCoreVerify(key, paramSet, srcData, signature);
 }
 
+int32_t HuksHdiBatchVerify(const struct HksBlob *key, const struct HksParamSet *paramSet,
+    const struct HksBlob *srcData, const struct HksBlob *signature, uint32_t count, struct HksBlob *result)
+{
+    return HksCoreBatchVerify(key, paramSet, srcData, signature, count, result);
+}
+
 int32_t HuksHdiEncrypt(const struct HksBlob *key, const struct HksParamSet *paramSet,
     const struct HksBlob *plainText, struct HksBlob *cipherText)
 {
@@ -197,6 +203,7 @@ struct HuksHdi *HuksCreateHdiDevicePtr(void)
     hdiDevicePtr->HuksHdiGetHardwareInfo  = HuksHdiGetHardwareInfo;
     hdiDevicePtr->HuksHdiSign             = HuksHdiSign;
     hdiDevicePtr->HuksHdiVerify           = HuksHdiVerify;
+    hdiDevicePtr->HuksHdiBatchVerify      = HuksHdiBatchVerify;
     hdiDevicePtr->HuksHdiEncrypt          = HuksHdiEncrypt;
     hdiDevicePtr->HuksHdiDecrypt          = HuksHdiDecrypt;
     hdiDevicePtr->HuksHdiAgreeKey         = HuksHdiAgreeKey;
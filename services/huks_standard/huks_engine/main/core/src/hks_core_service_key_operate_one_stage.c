@@ -272,6 +272,80 @@ int32_t HksCoreVerify(const struct HksBlob *key, const struct HksParamSet *param
     return SignVerify(HKS_CMD_ID_VERIFY, key, paramSet, srcData, (struct HksBlob *)signature);
 }
 
+static void FreeBatchVerifyMessages(struct HksBlob *messages, const bool *needFree, uint32_t count)
+{
+    for (uint32_t i = 0; i < count; ++i) {
+        if (needFree[i]) {
+            HKS_FREE(messages[i].data);
+        }
+    }
+}
+
+static int32_t BatchVerifyWithKeyNode(const struct HksKeyNode *keyNode, const struct HksParamSet *paramSet,
+    const struct HksBlob *srcData, const struct HksBlob *signature, uint32_t count, struct HksBlob *result)
+{
+    struct HksBlob *messages = (struct HksBlob *)HksMalloc(count * sizeof(struct HksBlob));
+    HKS_IF_NULL_LOGE_RETURN(messages, HKS_ERROR_MALLOC_FAIL, "malloc batch verify messages failed")
+    bool *needFree = (bool *)HksMalloc(count * sizeof(bool));
+    if (needFree == NULL) {
+        HKS_FREE(messages);
+        return HKS_ERROR_MALLOC_FAIL;
+    }
+    (void)memset_s(needFree, count * sizeof(bool), 0, count * sizeof(bool));
+
+    uint32_t hashed = 0;
+    int32_t ret;
+    do {
+        ret = SignVerifyPreCheck(keyNode, paramSet);
+        HKS_IF_NOT_SUCC_BREAK(ret)
+
+        for (; hashed < count; ++hashed) {
+            ret = GetSignVerifyMessage(keyNode->paramSet, &srcData[hashed], &messages[hashed], &needFree[hashed],
+                paramSet);
+            HKS_IF_NOT_SUCC_LOGE_BREAK(ret, "batch verify calc hash of %" LOG_PUBLIC "u failed!", hashed)
+        }
+        HKS_IF_NOT_SUCC_BREAK(ret)
+
+        struct HksBlob rawKey = { 0, NULL };
+        ret = HksGetRawKey(keyNode->paramSet, &rawKey);
+        HKS_IF_NOT_SUCC_LOGE_BREAK(ret, "batch verify get raw key failed!")
+
+        struct HksUsageSpec usageSpec = {0};
+        HksFillUsageSpec(paramSet, &usageSpec);
+        SetRsaPssSaltLenType(paramSet, &usageSpec);
+        ret = HksCryptoHalBatchVerify(&rawKey, &usageSpec, messages, signature, count, result);
+        (void)memset_s(rawKey.data, rawKey.size, 0, rawKey.size);
+        HKS_FREE(rawKey.data);
+    } while (0);
+
+    FreeBatchVerifyMessages(messages, needFree, hashed);
+    HKS_FREE(needFree);
+    HKS_FREE(messages);
+    return ret;
+}
+
+int32_t HksCoreBatchVerify(const struct HksBlob *key, const struct HksParamSet *paramSet,
+    const struct HksBlob *srcData, const struct HksBlob *signature, uint32_t count, struct HksBlob *result)
+{
+    if (srcData == NULL || signature == NULL || count == 0 || count > HKS_MAX_BATCH_VERIFY_COUNT ||
+        CheckBlob(result) != HKS_SUCCESS || result->size < HKS_BATCH_VERIFY_RESULT_SIZE(count)) {
+        HKS_LOG_E("invalid batch verify params, count %" LOG_PUBLIC "u", count);
+        return HKS_ERROR_INVALID_ARGUMENT;
+    }
+    for (uint32_t i = 0; i < count; ++i) {
+        int32_t ret = HksCoreCheckSignVerifyParams(HKS_CMD_ID_VERIFY, key, paramSet, &srcData[i], &signature[i]);
+        HKS_IF_NOT_SUCC_LOGE_RETURN(ret, ret, "check batch verify params of %" LOG_PUBLIC "u failed", i)
+    }
+
+    /* the key blob is decrypted and authorized once for the whole batch */
+    struct HksKeyNode *keyNode = HksGenerateKeyNode(key);
+    HKS_IF_NULL_LOGE_RETURN(keyNode, HKS_ERROR_CORRUPT_FILE, "batch verify generate keynode failed")
+
+    int32_t ret = BatchVerifyWithKeyNode(keyNode, paramSet, srcData, signature, count, result);
+    HksFreeKeyNode(&keyNode);
+    return ret;
+}
+
 int32_t HksCoreEncrypt(const struct HksBlob *key, const struct HksParamSet *paramSet,
     const struct HksBlob *plainText, struct HksBlob *cipherText)
 {
@@ -139,6 +139,26 @@ static int32_t GetPurposeAndAlgorithm(const struct HksParamSet *paramSet, uint32
     return HKS_SUCCESS;
 }
 
+/* the same purpose and handler alg as GetPurposeAndAlgorithm on the init paramSet, from the session of the key node */
+static int32_t GetSessionPurposeAndAlgorithm(const struct HksKeyNodeSession *session, uint32_t *pur, uint32_t *alg)
+{
+    if (session->purpose == 0 || session->alg == 0) {
+        HKS_LOG_E("don't found purpose or algrithm");
+        return HKS_ERROR_INVALID_ARGUMENT;
+    }
+    *pur = session->purpose;
+    *alg = session->alg;
+
+    if (*alg == HKS_ALG_HMAC || *alg == HKS_ALG_SM3 || *pur == HKS_KEY_PURPOSE_SIGN || *pur == HKS_KEY_PURPOSE_VERIFY) {
+        if (!session->hasDigest) {
+            HKS_LOG_E("don't found digest");
+            return HKS_ERROR_INVALID_ARGUMENT;
+        }
+        *alg = session->digest;
+    }
+    return HKS_SUCCESS;
+}
+
 static int32_t CoreInitPreCheck(const struct  HksBlob *key, const struct HksParamSet *paramSet,
     const struct HksBlob *handle, const struct HksBlob *token)
 {
@@ -168,13 +188,14 @@ static int32_t HksBatchCheck(struct HuksKeyNode *keyNode)
     }
     int32_t ret = HKS_ERROR_PARAM_NOT_EXIST;
     if (keyNode->isBatchOperation) {
-        struct HksParam *purposeParam = NULL;
+        if (keyNode->session.purpose == 0) {
+            HKS_LOG_E("get purpose param failed!");
+            return HKS_ERROR_INVALID_ARGUMENT;
+        }
         struct HksParam *batchPurposeParam = NULL;
-        ret = HksGetParam(keyNode->runtimeParamSet, HKS_TAG_PURPOSE, &purposeParam);
-        HKS_IF_NOT_SUCC_LOGE_RETURN(ret, HKS_ERROR_INVALID_ARGUMENT, "get purpose param failed!")
         ret = HksGetParam(keyNode->keyBlobParamSet, HKS_TAG_BATCH_PURPOSE, &batchPurposeParam);
         HKS_IF_NOT_SUCC_LOGE_RETURN(ret, HKS_ERROR_INVALID_ARGUMENT, "get batch purpose param failed!")
-        if ((purposeParam->uint32Param | batchPurposeParam->uint32Param) != batchPurposeParam->uint32Param) {
+        if ((keyNode->session.purpose | batchPurposeParam->uint32Param) != batchPurposeParam->uint32Param) {
             HKS_LOG_E("purposeParam should falll within the scope of batchPurposeParam");
             return HKS_ERROR_INVALID_PURPOSE;
         }
@@ -182,7 +203,7 @@ static int32_t HksBatchCheck(struct HuksKeyNode *keyNode)
     return ret;
 }
 
-static int32_t HksCoreInitProcess(const struct HuksKeyNode *keyNode, const struct HksParamSet *paramSet,
+static int32_t HksCoreInitProcess(struct HuksKeyNode *keyNode, const struct HksParamSet *paramSet,
     uint32_t pur, uint32_t alg)
 {
     if (keyNode == NULL || paramSet == NULL) {
@@ -215,7 +236,7 @@ static int32_t HksCoreUpdateProcess(struct HuksKeyNode *keyNode, const struct Hk
     uint32_t i;
     uint32_t pur = 0;
     uint32_t alg = 0;
-    int32_t ret = GetPurposeAndAlgorithm(keyNode->runtimeParamSet, &pur, &alg);
+    int32_t ret = GetSessionPurposeAndAlgorithm(&keyNode->session, &pur, &alg);
     HKS_IF_NOT_SUCC_LOGE_RETURN(ret, ret, "GetPurposeAndAlgorithm failed")
     uint32_t size = HKS_ARRAY_SIZE(g_hksCoreUpdateHandler);
     for (i = 0; i < size; i++) {
@@ -250,7 +271,7 @@ static int32_t HksCoreFinishProcess(struct HuksKeyNode *keyNode, const struct Hk
     uint32_t size = HKS_ARRAY_SIZE(g_hksCoreFinishHandler);
     uint32_t pur = 0;
     uint32_t alg = 0;
-    int32_t ret = GetPurposeAndAlgorithm(keyNode->runtimeParamSet, &pur, &alg);
+    int32_t ret = GetSessionPurposeAndAlgorithm(&keyNode->session, &pur, &alg);
     HKS_IF_NOT_SUCC_LOGE_RETURN(ret, ret, "GetPurposeAndAlgorithm failed")
     for (i = 0; i < size; i++) {
         if (g_hksCoreFinishHandler[i].pur == pur) {
@@ -554,7 +575,7 @@ int32_t HksCoreAbort(const struct HksBlob *handle, const struct HksParamSet *par
     struct HuksKeyNode *keyNode = HksQueryKeyNode(sessionId);
     HKS_IF_NULL_LOGE_RETURN(keyNode, HKS_SUCCESS, "abort get key node failed")
 
-    ret = GetPurposeAndAlgorithm(keyNode->runtimeParamSet, &pur, &alg);
+    ret = GetSessionPurposeAndAlgorithm(&keyNode->session, &pur, &alg);
     if (ret != HKS_SUCCESS) {
         HksDeleteKeyNode(sessionId);
         return ret;
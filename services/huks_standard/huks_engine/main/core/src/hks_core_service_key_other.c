@@ -64,6 +64,10 @@ int32_t HksCoreModuleInit(void)
 
     ret = HksCoreInitAuthTokenKey();
     HKS_IF_NOT_SUCC_LOGE_RETURN(ret, ret, "Hks init auth token key failed, ret = %" LOG_PUBLIC "d", ret)
+#ifdef HKS_SUPPORT_API_ATTEST_KEY
+    /* not fatal, attestation falls back to preparing the chain per request */
+    HKS_IF_NOT_SUCC_LOGE(DcmAttestPrepare(), "Hks prepare attest state failed")
+#endif
 #ifndef _HARDWARE_ROOT_KEY_
     ret = HksRkcInit();
     HKS_IF_NOT_SUCC_LOGE(ret, "Hks rkc init failed! ret = 0x%" LOG_PUBLIC "X", ret)
@@ -74,8 +78,12 @@ int32_t HksCoreModuleInit(void)
 
 int32_t HksCoreModuleDestroy(void)
 {
+    HksCoreSecureAccessClearAuthTokenCache();
     HksDestroyHuksMutex();
     HksCoreDestroyAuthTokenKey();
+#ifdef HKS_SUPPORT_API_ATTEST_KEY
+    DcmAttestDestroy();
+#endif
 #ifndef _HARDWARE_ROOT_KEY_
     HksCfgDestroy();
     HksMkDestroy();
@@ -145,6 +153,7 @@ int32_t HksCoreCalcMacHeader(const struct HksParamSet *paramSet, const struct Hk
 
 int32_t HksCoreRefresh(void)
 {
+    HksCoreSecureAccessClearAuthTokenCache();
     return HksCoreRefreshKeyInfo();
 }
 
@@ -27,6 +27,7 @@
 
 #include "hks_auth.h"
 #include "hks_base_check.h"
+#include "hks_cached_data.h"
 #include "hks_check_paramset.h"
 #include "hks_client_service_adapter_common.h"
 #include "hks_cmd_id.h"
@@ -50,12 +51,18 @@
 #define HKS_RSA_OAEP_DIGEST_NUM          2
 #define HKS_SM2_C1_LEN_NUM               2
 #define HKS_BLOCK_CIPHER_CBC_BLOCK_SIZE  16
-#define HKS_TEMP_SIZE                    32
 #define MAX_BUF_SIZE                     (5 * 1024 * 1024)
 #define HKS_AES_GCM_NONCE_LEN            12
 #define HKS_AES_CCM_NONCE_LEN            7
+#define HKS_SPEC_BLOB_MAX_CNT            3
 
-static int32_t CheckRsaCipherData(bool isEncrypt, uint32_t keyLen, struct HksUsageSpec *usageSpec,
+struct HksSpecBlob {
+    uint32_t tag;
+    bool isRequired;
+    struct HksBlob *out;
+};
+
+static int32_t CheckRsaCipherData(bool isEncrypt, uint32_t keyLen, const struct HksUsageSpec *usageSpec,
     const struct HksBlob *outData)
 {
     uint32_t keySize = keyLen / HKS_BITS_PER_BYTE;
@@ -193,31 +200,148 @@ static int32_t CheckBlockCipherData(bool isEncrypt, const struct HksUsageSpec *u
     return ret;
 }
 
-static int32_t HksCheckFinishOutSize(bool isEncrypt, struct HksParamSet *paramSet,
+/* copies the blob params of the spec into one buffer, an absent param that is not required leaves its out empty */
+static int32_t CopySpecBlobs(const struct HksParamSet *paramSet, const struct HksSpecBlob *blobs, uint32_t blobCnt,
+    uint8_t **specData)
+{
+    struct HksParam *params[HKS_SPEC_BLOB_MAX_CNT] = { NULL };
+    uint32_t totalSize = 0;
+    for (uint32_t i = 0; i < blobCnt; ++i) {
+        int32_t ret = HksGetParam(paramSet, blobs[i].tag, &params[i]);
+        if ((ret == HKS_ERROR_PARAM_NOT_EXIST) && !blobs[i].isRequired) {
+            params[i] = NULL;
+            continue;
+        }
+        HKS_IF_NOT_SUCC_LOGE_RETURN(ret, ret, "get spec param 0x%" LOG_PUBLIC "x failed", blobs[i].tag)
+        totalSize += params[i]->blob.size;
+    }
+    if (totalSize == 0) {
+        return HKS_SUCCESS;
+    }
+
+    uint8_t *data = (uint8_t *)HksMalloc(totalSize);
+    HKS_IF_NULL_LOGE_RETURN(data, HKS_ERROR_MALLOC_FAIL, "malloc spec data failed")
+
+    uint32_t offset = 0;
+    for (uint32_t i = 0; i < blobCnt; ++i) {
+        if ((params[i] == NULL) || (params[i]->blob.size == 0)) {
+            continue;
+        }
+        (void)memcpy_s(data + offset, totalSize - offset, params[i]->blob.data, params[i]->blob.size);
+        blobs[i].out->data = data + offset;
+        blobs[i].out->size = params[i]->blob.size;
+        offset += params[i]->blob.size;
+    }
+    *specData = data;
+    return HKS_SUCCESS;
+}
+
+static int32_t FillSessionAlgParam(const struct HksParamSet *paramSet, struct HksKeyNodeUsageSpec *spec)
+{
+    uint32_t alg = spec->usageSpec.algType;
+    if (spec->isAeMode) {
+        bool isEncrypt = (spec->usageSpec.purpose == HKS_KEY_PURPOSE_ENCRYPT);
+        struct HksSpecBlob blobs[] = {
+            { HKS_TAG_NONCE, true, &spec->aeadParam.nonce },
+            { HKS_TAG_ASSOCIATED_DATA, false, &spec->aeadParam.aad },
+            { HKS_TAG_AE_TAG, false, &spec->aeadParam.tagDec },
+        };
+        /* the tag to decrypt with is checked at finish, encrypt has no tag to copy */
+        uint32_t blobCnt = isEncrypt ? (HKS_ARRAY_SIZE(blobs) - 1) : HKS_ARRAY_SIZE(blobs);
+        int32_t ret = CopySpecBlobs(paramSet, blobs, blobCnt, &spec->specData);
+        HKS_IF_NOT_SUCC_LOGE_RETURN(ret, ret, "fill aead param failed")
+        if (isEncrypt) {
+            spec->aeadParam.tagLenEnc = HKS_AE_TAG_LEN;
+        }
+        spec->usageSpec.algParam = &spec->aeadParam;
+        return HKS_SUCCESS;
+    }
+
+    if ((alg == HKS_ALG_AES) || (alg == HKS_ALG_DES) || (alg == HKS_ALG_3DES) || (alg == HKS_ALG_SM4)) {
+        struct HksSpecBlob blob = { HKS_TAG_IV, true, &spec->cipherParam.iv };
+        int32_t ret = CopySpecBlobs(paramSet, &blob, 1, &spec->specData);
+        HKS_IF_NOT_SUCC_LOGE_RETURN(ret, ret, "fill iv param failed")
+        spec->usageSpec.algParam = &spec->cipherParam;
+    }
+    return HKS_SUCCESS;
+}
+
+/* builds the usage spec of a cipher or sign/verify operation from the runtime paramset, once the nonce is final */
+static int32_t BuildSessionUsageSpec(struct HuksKeyNode *keyNode)
+{
+    struct HksKeyNodeUsageSpec *spec = &keyNode->session.spec;
+    HksFillUsageSpec(keyNode->runtimeParamSet, &spec->usageSpec);
+    struct HksKeySpec keySpec = { 0 };
+    HksFillKeySpec(keyNode->runtimeParamSet, &keySpec);
+    spec->keyLen = keySpec.keyLen;
+    spec->isAeMode = (keyNode->session.alg == HKS_ALG_AES) && keyNode->session.hasMode &&
+        ((keyNode->session.mode == HKS_MODE_CCM) || (keyNode->session.mode == HKS_MODE_GCM));
+
+    struct HksParam *needAppendNonce = NULL;
+    spec->needAppendNonce = (HksGetParam(keyNode->runtimeParamSet, HKS_TAG_AES_GCM_NEED_REGENERATE_NONCE,
+        &needAppendNonce) == HKS_SUCCESS) && needAppendNonce->boolParam;
+
+    uint32_t purpose = keyNode->session.purpose;
+    if ((purpose == HKS_KEY_PURPOSE_SIGN) || (purpose == HKS_KEY_PURPOSE_VERIFY)) {
+        SetRsaPssSaltLenType(keyNode->runtimeParamSet, &spec->usageSpec);
+    } else {
+        int32_t ret = FillSessionAlgParam(keyNode->runtimeParamSet, spec);
+        HKS_IF_NOT_SUCC_RETURN(ret, ret)
+    }
+    spec->isBuilt = true;
+    return HKS_SUCCESS;
+}
+
+static const struct HksUsageSpec *GetSessionUsageSpec(const struct HuksKeyNode *keyNode)
+{
+    if (!keyNode->session.spec.isBuilt) {
+        HKS_LOG_E("usage spec of the operation is not built");
+        return NULL;
+    }
+    return &keyNode->session.spec.usageSpec;
+}
+
+static int32_t HksCheckFinishOutSize(bool isEncrypt, const struct HuksKeyNode *keyNode,
     const struct HksBlob *inData, const struct HksBlob *outData)
 {
-    struct HksUsageSpec usageSpec = {0};
-    HksFillUsageSpec(paramSet, &usageSpec);
-    struct HksKeySpec cipherSpec = {0};
-    HksFillKeySpec(paramSet, &cipherSpec);
-    uint32_t alg = usageSpec.algType;
+    const struct HksUsageSpec *usageSpec = GetSessionUsageSpec(keyNode);
+    HKS_IF_NULL_RETURN(usageSpec, HKS_ERROR_BAD_STATE)
 
-    switch (alg) {
+    switch (usageSpec->algType) {
         case HKS_ALG_RSA:
-            return CheckRsaCipherData(isEncrypt, cipherSpec.keyLen, &usageSpec, outData);
+            return CheckRsaCipherData(isEncrypt, keyNode->session.spec.keyLen, usageSpec, outData);
         case HKS_ALG_SM2:
-            return CheckSm2CipherData(isEncrypt, &usageSpec, inData, outData);
+            return CheckSm2CipherData(isEncrypt, usageSpec, inData, outData);
         case HKS_ALG_AES:
         case HKS_ALG_DES:
         case HKS_ALG_3DES:
-            return CheckBlockCipherData(isEncrypt, &usageSpec, inData, outData);
+            return CheckBlockCipherData(isEncrypt, usageSpec, inData, outData);
         case HKS_ALG_SM4:
-            return CheckBlockCipherData(isEncrypt, &usageSpec, inData, outData);
+            return CheckBlockCipherData(isEncrypt, usageSpec, inData, outData);
         default:
             return HKS_ERROR_INVALID_ALGORITHM;
     }
 }
 
+static int32_t GetEncryptAeTag(const struct HuksKeyNode *keyNode, const struct HksBlob *inData,
+    const struct HksBlob *outData, struct HksBlob *tagAead)
+{
+    tagAead->data = NULL;
+    tagAead->size = 0;
+    if (!keyNode->session.spec.isAeMode) {
+        return HKS_SUCCESS;
+    }
+
+    if (outData->size < (inData->size + HKS_AE_TAG_LEN)) {
+        HKS_LOG_E("too small out buf!");
+        return HKS_ERROR_INVALID_ARGUMENT;
+    }
+
+    tagAead->data = outData->data + inData->size;
+    tagAead->size = HKS_AE_TAG_LEN;
+    return HKS_SUCCESS;
+}
+
 static int32_t SignVerifyAuth(const struct HuksKeyNode *keyNode, const struct HksParamSet *paramSet)
 {
     struct HksParam *algParam = NULL;
@@ -289,106 +413,23 @@ static int32_t CipherAuth(const struct HuksKeyNode *keyNode, const struct HksPar
     return HKS_ERROR_INVALID_ALGORITHM;
 }
 
-static void *GetCryptoCtx(const struct HuksKeyNode *keyNode)
-{
-    struct HksParam *ctxParam = NULL;
-    int32_t ret = HksGetParam(keyNode->runtimeParamSet, HKS_TAG_CRYPTO_CTX, &ctxParam);
-
-    return (ret != HKS_SUCCESS || ctxParam == NULL) ? NULL : (void *)(uintptr_t)ctxParam->uint64Param;
-}
-
-static void ClearCryptoCtx(const struct HuksKeyNode *keyNode)
-{
-    struct HksParam *ctxParam = NULL;
-    int32_t ret = HksGetParam(keyNode->runtimeParamSet, HKS_TAG_CRYPTO_CTX, &ctxParam);
-    if (ret != HKS_SUCCESS || ctxParam == NULL) {
-        return;
-    }
-
-    ctxParam->uint64Param = (uint64_t)(uintptr_t)NULL;
-    return;
-}
-
-static int32_t SetCacheModeCtx(const struct HuksKeyNode *keyNode)
+static int32_t SetCacheModeCtx(struct HuksKeyNode *keyNode)
 {
-    struct HksParam *ctxParam = NULL;
-    int32_t ret = HksGetParam(keyNode->runtimeParamSet, HKS_TAG_CRYPTO_CTX, &ctxParam);
-    HKS_IF_NOT_SUCC_LOGE_RETURN(ret, HKS_ERROR_BAD_STATE, "get ctx from keyNode failed!")
-
-    struct HksBlob *tempData = (struct HksBlob *)HksMalloc(sizeof(struct HksBlob));
+    struct HksCachedData *tempData = HksCreateCachedData();
     HKS_IF_NULL_LOGE_RETURN(tempData, HKS_ERROR_MALLOC_FAIL, "get cache mode ctx malloc fail.")
 
-    tempData->size = 0;
-    tempData->data = NULL;
-    ctxParam->uint64Param = (uint64_t)(uintptr_t)tempData;
+    keyNode->session.ctx = tempData;
     return HKS_SUCCESS;
 }
 
-static int32_t CopyNewCachedData(const struct HksBlob *cachedBlob, const struct HksBlob *inData,
-    uint8_t *newData, uint32_t newSize)
+static int32_t UpdateCachedData(struct HuksKeyNode *keyNode, const struct HksBlob *srcData)
 {
-    if (cachedBlob->size != 0) {
-        if (memcpy_s(newData, newSize, cachedBlob->data, cachedBlob->size) != EOK) {
-            HKS_LOG_E("memcpy cached data failed");
-            return HKS_ERROR_INSUFFICIENT_MEMORY;
-        }
-    }
-    if (inData->size != 0) {
-        if (memcpy_s(newData + cachedBlob->size, newSize - cachedBlob->size, inData->data, inData->size) != EOK) {
-            HKS_LOG_E("memcpy in data failed");
-            return HKS_ERROR_INSUFFICIENT_MEMORY;
-        }
-    }
-    return HKS_SUCCESS;
-}
-
-static int32_t GetNewCachedData(const struct HksBlob *cachedBlob, const struct HksBlob *inData,
-    struct HksBlob *newBlob)
-{
-    if ((cachedBlob->size > MAX_BUF_SIZE) || (inData->size > (MAX_BUF_SIZE - cachedBlob->size))) {
-        HKS_LOG_E("input data size too large, size = %" LOG_PUBLIC "u", inData->size);
-        return HKS_ERROR_INVALID_ARGUMENT;
-    }
-
-    uint32_t newSize = cachedBlob->size + inData->size;
-    uint8_t *newData = (uint8_t *)HksMalloc(newSize);
-    HKS_IF_NULL_LOGE_RETURN(newData, HKS_ERROR_MALLOC_FAIL, "update cache data malloc fail.")
-
-    int32_t ret = CopyNewCachedData(cachedBlob, inData, newData, newSize);
-    if (ret != HKS_SUCCESS) {
-        HKS_FREE(newData);
-        return ret;
-    }
-
-    newBlob->data = newData;
-    newBlob->size = newSize;
-    return HKS_SUCCESS;
-}
-
-static int32_t UpdateCachedData(const struct HuksKeyNode *keyNode, const struct HksBlob *srcData)
-{
-    struct HksParam *ctxParam = NULL;
-    int32_t ret = HksGetParam(keyNode->runtimeParamSet, HKS_TAG_CRYPTO_CTX, &ctxParam);
-    HKS_IF_NOT_SUCC_LOGE_RETURN(ret, HKS_ERROR_BAD_STATE, "get ctx from keyNode failed!")
-
-    void *ctx = (void *)(uintptr_t)ctxParam->uint64Param;
+    void *ctx = keyNode->session.ctx;
     HKS_IF_NULL_LOGE_RETURN(ctx, HKS_ERROR_BAD_STATE, "ctx is invalid: null!")
 
-    struct HksBlob *cachedData = (struct HksBlob *)ctx;
-    struct HksBlob *newCachedBlob = (struct HksBlob *)HksMalloc(sizeof(struct HksBlob));
-    HKS_IF_NULL_LOGE_RETURN(newCachedBlob, HKS_ERROR_MALLOC_FAIL, "malloc new blob failed")
-
-    ret = GetNewCachedData(cachedData, srcData, newCachedBlob);
-    if (ret != HKS_SUCCESS) {
-        HKS_LOG_E("get new cached data failed, ret = %" LOG_PUBLIC "d", ret);
-        HKS_FREE(newCachedBlob);
-        return ret;
-    }
-
-    HKS_FREE(cachedData->data);
-    HKS_FREE(cachedData);
-    ctxParam->uint64Param = (uint64_t)(uintptr_t)newCachedBlob;
-    return HKS_SUCCESS;
+    int32_t ret = HksAppendCachedData((struct HksCachedData *)ctx, srcData, MAX_BUF_SIZE);
+    HKS_IF_NOT_SUCC_LOGE(ret, "get new cached data failed, ret = %" LOG_PUBLIC "d", ret)
+    return ret;
 }
 
 static void FreeCachedData(struct HksBlob **cachedData)
@@ -403,33 +444,30 @@ static void FreeCachedData(struct HksBlob **cachedData)
     HKS_FREE(*cachedData);
 }
 
-static int32_t FinishCachedData(const struct HuksKeyNode *keyNode, const struct HksBlob *srcData,
+/* appends srcData and hands the buffer over to outData without copying it, the ctx is freed either way */
+static int32_t FinishCachedData(struct HuksKeyNode *keyNode, const struct HksBlob *srcData,
     struct HksBlob *outData)
 {
-    struct HksParam *ctxParam = NULL;
-    int32_t ret = HksGetParam(keyNode->runtimeParamSet, HKS_TAG_CRYPTO_CTX, &ctxParam);
-    HKS_IF_NOT_SUCC_LOGE_RETURN(ret, HKS_ERROR_BAD_STATE, "get ctx from keyNode failed!")
-
-    void *ctx = (void *)(uintptr_t)ctxParam->uint64Param;
+    void *ctx = keyNode->session.ctx;
     HKS_IF_NULL_LOGE_RETURN(ctx, HKS_ERROR_BAD_STATE, "ctx is invalid: null!")
 
-    struct HksBlob *cachedData = (struct HksBlob *)ctx;
-    ret = GetNewCachedData(cachedData, srcData, outData);
-    HKS_IF_NOT_SUCC_LOGE(ret, "get new cached data failed, ret = %" LOG_PUBLIC "d", ret)
+    struct HksCachedData *cachedData = (struct HksCachedData *)ctx;
+    int32_t ret = HksAppendCachedData(cachedData, srcData, MAX_BUF_SIZE);
+    if (ret == HKS_SUCCESS) {
+        HksTakeCachedData(cachedData, outData);
+    } else {
+        HKS_LOG_E("get new cached data failed, ret = %" LOG_PUBLIC "d", ret);
+    }
 
-    FreeCachedData(&cachedData);
-    ctxParam->uint64Param = 0; /* clear ctx to NULL */
+    HksFreeCachedData(&cachedData);
+    keyNode->session.ctx = NULL;
     return ret;
 }
 
 static int32_t CheckCachedDataMaxSize(const struct HuksKeyNode *keyNode, const struct HksBlob *inData,
     const uint32_t maxDataLen)
 {
-    struct HksParam *ctxParam = NULL;
-    int32_t ret = HksGetParam(keyNode->runtimeParamSet, HKS_TAG_CRYPTO_CTX, &ctxParam);
-    HKS_IF_NOT_SUCC_LOGE_RETURN(ret, HKS_ERROR_BAD_STATE, "get ctx from keyNode failed!")
-
-    void *ctx = (void *)(uintptr_t)ctxParam->uint64Param;
+    void *ctx = keyNode->session.ctx;
     HKS_IF_NULL_LOGE_RETURN(ctx, HKS_ERROR_BAD_STATE, "ctx is invalid: null!")
 
     struct HksBlob *cachedData = (struct HksBlob *)ctx;
@@ -446,26 +484,22 @@ static int32_t CheckCachedDataMaxSize(const struct HuksKeyNode *keyNode, const s
     return HKS_SUCCESS;
 }
 
-static int32_t CoreHashInit(const struct HuksKeyNode *keyNode, uint32_t alg)
+static int32_t CoreHashInit(struct HuksKeyNode *keyNode, uint32_t alg)
 {
-    struct HksParam *ctxParam = NULL;
-    int32_t ret = HksGetParam(keyNode->runtimeParamSet, HKS_TAG_CRYPTO_CTX, &ctxParam);
-    HKS_IF_NOT_SUCC_LOGE_RETURN(ret, HKS_ERROR_BAD_STATE, "get ctx from keyNode failed!")
-
     void *ctx = NULL;
 
-    ret = HksCryptoHalHashInit(alg, &ctx);
+    int32_t ret = HksCryptoHalHashInit(alg, &ctx);
     if (ret != HKS_SUCCESS)  {
         HKS_LOG_E("hal hash init failed ret : %" LOG_PUBLIC "d", ret);
         return ret;
     }
-    ctxParam->uint64Param = (uint64_t)(uintptr_t)ctx;
+    keyNode->session.ctx = ctx;
     return HKS_SUCCESS;
 }
 
-static int32_t CoreHashUpdate(const struct HuksKeyNode *keyNode, const struct HksBlob *srcData)
+static int32_t CoreHashUpdate(struct HuksKeyNode *keyNode, const struct HksBlob *srcData)
 {
-    void *ctx = GetCryptoCtx(keyNode);
+    void *ctx = keyNode->session.ctx;
     HKS_IF_NULL_LOGE_RETURN(ctx, HKS_ERROR_BAD_STATE, "ctx is invalid: null!")
 
     int32_t ret = HksCryptoHalHashUpdate(srcData, ctx);
@@ -474,52 +508,37 @@ static int32_t CoreHashUpdate(const struct HuksKeyNode *keyNode, const struct Hk
     return ret;
 }
 
-static int32_t CoreHashFinish(const struct HuksKeyNode *keyNode, const struct HksBlob *srcData,
+static int32_t CoreHashFinish(struct HuksKeyNode *keyNode, const struct HksBlob *srcData,
     struct HksBlob *outData)
 {
-    struct HksParam *ctxParam = NULL;
-    int32_t ret = HksGetParam(keyNode->runtimeParamSet, HKS_TAG_CRYPTO_CTX, &ctxParam);
-    HKS_IF_NOT_SUCC_LOGE_RETURN(ret, HKS_ERROR_BAD_STATE, "get ctx from keyNode failed!")
-
-    void *ctx = (void *)(uintptr_t)ctxParam->uint64Param;
+    void *ctx = keyNode->session.ctx;
     HKS_IF_NULL_LOGE_RETURN(ctx, HKS_ERROR_BAD_STATE, "ctx is invalid: null!")
 
     outData->size = MAX_HASH_SIZE;
     outData->data = (uint8_t *)HksMalloc(MAX_HASH_SIZE);
     HKS_IF_NULL_LOGE_RETURN(outData->data, HKS_ERROR_MALLOC_FAIL, "malloc fail.")
 
-    ret = HksCryptoHalHashFinal(srcData, &ctx, outData);
+    int32_t ret = HksCryptoHalHashFinal(srcData, &ctx, outData);
     if (ret != HKS_SUCCESS) {
         HKS_LOG_E("hal hash final failed ret : %" LOG_PUBLIC "d", ret);
         HKS_FREE_BLOB(*outData);
     }
 
-    ctxParam->uint64Param = 0; /* clear ctx to NULL */
+    keyNode->session.ctx = NULL;
     return ret;
 }
 
 static int32_t CheckSignVerifyParams(const struct HuksKeyNode *keyNode, const struct HksBlob *outData)
 {
     HKS_IF_NOT_SUCC_LOGE_RETURN(CheckBlob(outData), HKS_ERROR_INVALID_ARGUMENT, "invalid outData")
+    if (!keyNode->session.hasKeySize) {
+        HKS_LOG_E("get key size from keyNode failed!");
+        return HKS_ERROR_PARAM_NOT_EXIST;
+    }
 
-    struct HksParam *tmpParam = NULL;
-    int32_t ret = HksGetParam(keyNode->keyBlobParamSet, HKS_TAG_ALGORITHM, &tmpParam);
-    HKS_IF_NOT_SUCC_LOGE_RETURN(ret, ret, "get alg from keyNode failed!")
-
-    uint32_t alg = tmpParam->uint32Param;
-
-    ret = HksGetParam(keyNode->runtimeParamSet, HKS_TAG_PURPOSE, &tmpParam);
-    HKS_IF_NOT_SUCC_LOGE_RETURN(ret, ret, "get purpoes from keyNode failed!")
-
-    uint32_t purpose = tmpParam->uint32Param;
-
-    ret = HksGetParam(keyNode->keyBlobParamSet, HKS_TAG_KEY_SIZE, &tmpParam);
-    HKS_IF_NOT_SUCC_LOGE_RETURN(ret, ret, "get key size from keyNode failed!")
-
-    uint32_t keySize = tmpParam->uint32Param;
-
-    ret = HksCheckSignature((purpose == HKS_KEY_PURPOSE_SIGN) ? HKS_CMD_ID_SIGN : HKS_CMD_ID_VERIFY,
-        alg, keySize, outData);
+    uint32_t purpose = keyNode->session.purpose;
+    int32_t ret = HksCheckSignature((purpose == HKS_KEY_PURPOSE_SIGN) ? HKS_CMD_ID_SIGN : HKS_CMD_ID_VERIFY,
+        keyNode->session.alg, keyNode->session.keySize, outData);
     HKS_IF_NOT_SUCC_LOGE(ret, "check signature failed!")
 
     return ret;
@@ -530,36 +549,33 @@ static int32_t CoreSignVerify(const struct HuksKeyNode *keyNode, const struct Hk
 {
     int32_t ret = CheckSignVerifyParams(keyNode, outData);
     HKS_IF_NOT_SUCC_RETURN(ret, ret)
+    const struct HksUsageSpec *usageSpec = GetSessionUsageSpec(keyNode);
+    HKS_IF_NULL_RETURN(usageSpec, HKS_ERROR_BAD_STATE)
 
     struct HksBlob rawKey = { 0, NULL };
     ret = HksGetRawKey(keyNode->keyBlobParamSet, &rawKey);
     HKS_IF_NOT_SUCC_LOGE_RETURN(ret, ret, "SignVerify get raw key failed!")
 
-    struct HksUsageSpec usageSpec;
-    (void)memset_s(&usageSpec, sizeof(struct HksUsageSpec), 0, sizeof(struct HksUsageSpec));
-    HksFillUsageSpec(keyNode->runtimeParamSet, &usageSpec);
-    SetRsaPssSaltLenType(keyNode->runtimeParamSet, &usageSpec);
-
-    if ((usageSpec.algType == HKS_ALG_RSA) && (usageSpec.padding == HKS_PADDING_ISO_IEC_9796_2)) {
+    if ((usageSpec->algType == HKS_ALG_RSA) && (usageSpec->padding == HKS_PADDING_ISO_IEC_9796_2)) {
 #ifdef HKS_SUPPORT_RSA_ISO_IEC_9796_2
-        if (usageSpec.purpose == HKS_KEY_PURPOSE_SIGN) {
-            ret = HksCryptoHalSignIsoIec97962(&rawKey, &usageSpec, inData, outData);
+        if (usageSpec->purpose == HKS_KEY_PURPOSE_SIGN) {
+            ret = HksCryptoHalSignIsoIec97962(&rawKey, usageSpec, inData, outData);
         } else {
-            ret = HksCryptoHalVerifyIsoIec97962(&rawKey, &usageSpec, inData, outData);
+            ret = HksCryptoHalVerifyIsoIec97962(&rawKey, usageSpec, inData, outData);
         }
 #else
         ret = HKS_ERROR_NOT_SUPPORTED;
 #endif
     } else {
-        if (usageSpec.purpose == HKS_KEY_PURPOSE_SIGN) {
-            ret = HksCryptoHalSign(&rawKey, &usageSpec, inData, outData);
+        if (usageSpec->purpose == HKS_KEY_PURPOSE_SIGN) {
+            ret = HksCryptoHalSign(&rawKey, usageSpec, inData, outData);
         } else {
-            ret = HksCryptoHalVerify(&rawKey, &usageSpec, inData, outData);
+            ret = HksCryptoHalVerify(&rawKey, usageSpec, inData, outData);
         }
     }
 
     HKS_IF_NOT_SUCC_LOGE(ret, "SignVerify Finish failed, purpose = 0x%" LOG_PUBLIC "x, ret = %" LOG_PUBLIC "d",
-        usageSpec.purpose, ret)
+        usageSpec->purpose, ret)
 
     (void)memset_s(rawKey.data, rawKey.size, 0, rawKey.size);
     HKS_FREE(rawKey.data);
@@ -570,12 +586,10 @@ static int32_t CoreSignVerify(const struct HuksKeyNode *keyNode, const struct Hk
 static int32_t HksGetParamPadding(const struct HuksKeyNode *keyNode, uint32_t *padding)
 {
     *padding = HKS_PADDING_NONE;
-    struct HksParam *paddingParam = NULL;
-    int32_t ret = HksGetParam(keyNode->runtimeParamSet, HKS_TAG_PADDING, &paddingParam);
-    if (ret != HKS_SUCCESS) {
+    if (!keyNode->session.hasPadding) {
         return HKS_ERROR_CHECK_GET_PADDING_FAIL;
     }
-    *padding = paddingParam->uint32Param;
+    *padding = keyNode->session.padding;
 
     return HKS_SUCCESS;
 }
@@ -598,36 +612,23 @@ static int32_t HksCheckNeedCachePadding(uint32_t alg, const struct HuksKeyNode *
 }
 #endif
 
-static void FreeSignVerifyCtx(const struct HuksKeyNode *keyNode)
+static void FreeSignVerifyCtx(struct HuksKeyNode *keyNode)
 {
-    struct HksParam *ctxParam = NULL;
-    int32_t ret = HksGetParam(keyNode->runtimeParamSet, HKS_TAG_CRYPTO_CTX, &ctxParam);
-    if (ret != HKS_SUCCESS) {
-        HKS_LOG_E("get ctx from keyNode failed!");
-        return;
-    }
-    void *ctx = (void *)(uintptr_t)ctxParam->uint64Param;
+    void *ctx = keyNode->session.ctx;
     if (ctx == NULL) {
         return;
     }
 
-    struct HksParam *algParam = NULL;
-    ret = HksGetParam(keyNode->runtimeParamSet, HKS_TAG_ALGORITHM, &algParam);
-    if (ret != HKS_SUCCESS) {
-        HKS_LOG_E("append cipher get alg param failed!");
-        return;
-    }
-    struct HksParam *digestParam = NULL;
-    ret = HksGetParam(keyNode->runtimeParamSet, HKS_TAG_DIGEST, &digestParam);
-    if (ret != HKS_SUCCESS) {
+    if (!keyNode->session.hasDigest) {
         HKS_LOG_E("append cipher get digest param failed!");
         return;
     }
+    uint32_t alg = keyNode->session.alg;
 #ifdef HKS_SUPPORT_RSA_ISO_IEC_9796_2
-    if ((HksCheckNeedCache(algParam->uint32Param, digestParam->uint32Param) == HKS_SUCCESS) ||
-        (HksCheckNeedCachePadding(algParam->uint32Param, keyNode) == HKS_SUCCESS)) {
+    if ((HksCheckNeedCache(alg, keyNode->session.digest) == HKS_SUCCESS) ||
+        (HksCheckNeedCachePadding(alg, keyNode) == HKS_SUCCESS)) {
 #else
-    if (HksCheckNeedCache(algParam->uint32Param, digestParam->uint32Param) == HKS_SUCCESS) {
+    if (HksCheckNeedCache(alg, keyNode->session.digest) == HKS_SUCCESS) {
 #endif
         struct HksBlob *cachedData = (struct HksBlob *)ctx;
         FreeCachedData(&cachedData);
@@ -635,7 +636,7 @@ static void FreeSignVerifyCtx(const struct HuksKeyNode *keyNode)
         HksCryptoHalHashFreeCtx(&ctx);
     }
 
-    ctxParam->uint64Param = 0; /* clear ctx to NULL */
+    keyNode->session.ctx = NULL;
 }
 
 static int32_t CheckWhetherUpdateAesNonce(struct HksParamSet **runtimeParamSet,
@@ -760,51 +761,36 @@ static int32_t UpdateNonceForAesAeMode(struct HksParamSet **runtimeParamSet, con
     return HKS_SUCCESS;
 }
 
-static int32_t CoreCipherInit(const struct HuksKeyNode *keyNode)
+static int32_t CoreCipherInit(struct HuksKeyNode *keyNode)
 {
-    int32_t ret = UpdateNonceForAesAeMode((struct HksParamSet **)(unsigned long)&keyNode->runtimeParamSet,
-        keyNode->keyBlobParamSet, false);
+    int32_t ret = UpdateNonceForAesAeMode(&keyNode->runtimeParamSet, keyNode->keyBlobParamSet, false);
     HKS_IF_NOT_SUCC_LOGE_RETURN(ret, ret, "update aes gcm nonce failed")
 
-    struct HksParam *ctxParam = NULL;
-    ret = HksGetParam(keyNode->runtimeParamSet, HKS_TAG_CRYPTO_CTX, &ctxParam);
-    HKS_IF_NOT_SUCC_LOGE_RETURN(ret, HKS_ERROR_BAD_STATE, "get ctx from keyNode failed!")
-
-    struct HksParam *purposeParam = NULL;
-    ret = HksGetParam(keyNode->runtimeParamSet, HKS_TAG_PURPOSE, &purposeParam);
-    HKS_IF_NOT_SUCC_RETURN(ret, HKS_ERROR_CHECK_GET_PURPOSE_FAIL)
+    ret = BuildSessionUsageSpec(keyNode);
+    HKS_IF_NOT_SUCC_LOGE_RETURN(ret, ret, "build cipher usage failed")
 
     struct HksBlob rawKey = { 0, NULL };
-    struct HksUsageSpec *usageSpec = NULL;
-    do {
-        uint8_t tmpData[HKS_TEMP_SIZE] = {0};
-        struct HksBlob tmpInData = { HKS_TEMP_SIZE, tmpData };
-        bool isEncrypt = (purposeParam->uint32Param == HKS_KEY_PURPOSE_ENCRYPT) ? true : false;
-        ret = HksBuildCipherUsageSpec(keyNode->runtimeParamSet, isEncrypt, &tmpInData, &usageSpec);
-        HKS_IF_NOT_SUCC_LOGE_BREAK(ret, "build cipher usage failed")
-
-        ret = HksGetRawKey(keyNode->keyBlobParamSet, &rawKey);
-        HKS_IF_NOT_SUCC_LOGE_BREAK(ret, "cipher get raw key failed")
-
-        void *ctx = NULL;
-        if (purposeParam->uint32Param == HKS_KEY_PURPOSE_ENCRYPT) {
-            ret = HksCryptoHalEncryptInit(&rawKey, usageSpec, &ctx);
-        } else {
-            ret = HksCryptoHalDecryptInit(&rawKey, usageSpec, &ctx);
-        }
-        HKS_IF_NOT_SUCC_LOGE_BREAK(ret, "cipher ctx init failed, ret = %" LOG_PUBLIC "d", ret)
-        ctxParam->uint64Param = (uint64_t)(uintptr_t)ctx;
-    } while (0);
+    ret = HksGetRawKey(keyNode->keyBlobParamSet, &rawKey);
+    HKS_IF_NOT_SUCC_LOGE_RETURN(ret, ret, "cipher get raw key failed")
 
-    if (rawKey.data != NULL) {
-        (void)memset_s(rawKey.data, rawKey.size, 0, rawKey.size);
+    void *ctx = NULL;
+    if (keyNode->session.purpose == HKS_KEY_PURPOSE_ENCRYPT) {
+        ret = HksCryptoHalEncryptInit(&rawKey, &keyNode->session.spec.usageSpec, &ctx);
+    } else {
+        ret = HksCryptoHalDecryptInit(&rawKey, &keyNode->session.spec.usageSpec, &ctx);
     }
+    if (ret == HKS_SUCCESS) {
+        keyNode->session.ctx = ctx;
+    } else {
+        HKS_LOG_E("cipher ctx init failed, ret = %" LOG_PUBLIC "d", ret);
+    }
+
+    (void)memset_s(rawKey.data, rawKey.size, 0, rawKey.size);
     HKS_FREE(rawKey.data);
-    HksFreeUsageSpec(&usageSpec);
     return ret;
 }
 
-static int32_t CoreCipherUpdate(const struct HuksKeyNode *keyNode, const struct HksBlob *inData,
+static int32_t CoreCipherUpdate(struct HuksKeyNode *keyNode, const struct HksBlob *inData,
     struct HksBlob *outData, uint32_t alg)
 {
     HKS_IF_NOT_SUCC_LOGE_RETURN(CheckBlob(outData), HKS_ERROR_INVALID_ARGUMENT, "invalid outData")
@@ -815,14 +801,11 @@ static int32_t CoreCipherUpdate(const struct HuksKeyNode *keyNode, const struct
         return HKS_ERROR_BUFFER_TOO_SMALL;
     }
 
-    void *ctx = GetCryptoCtx(keyNode);
+    void *ctx = keyNode->session.ctx;
     HKS_IF_NULL_LOGE_RETURN(ctx, HKS_ERROR_NULL_POINTER, "ctx is invalid: null!")
 
-    struct HksParam *purposeParam = NULL;
-    int32_t ret = HksGetParam(keyNode->runtimeParamSet, HKS_TAG_PURPOSE, &purposeParam);
-    HKS_IF_NOT_SUCC_LOGE_RETURN(ret, ret, "append cipher get purpose param failed!")
-
-    if (purposeParam->uint32Param == HKS_KEY_PURPOSE_ENCRYPT) {
+    int32_t ret;
+    if (keyNode->session.purpose == HKS_KEY_PURPOSE_ENCRYPT) {
         ret = HksCryptoHalEncryptUpdate(inData, ctx, outData, alg);
     } else {
         ret = HksCryptoHalDecryptUpdate(inData, ctx, outData, alg);
@@ -834,51 +817,36 @@ static int32_t CoreCipherUpdate(const struct HuksKeyNode *keyNode, const struct
 static int32_t AppendNonceWhenNeeded(const struct HuksKeyNode *keyNode,
     const struct HksBlob *inData, const uint32_t nonceLen, struct HksBlob *outData, struct HksBlob tag)
 {
-    struct HksParam *needAppendNonce = NULL;
-    int32_t ret = HksGetParam(keyNode->runtimeParamSet, HKS_TAG_AES_GCM_NEED_REGENERATE_NONCE, &needAppendNonce);
-    if (ret != HKS_SUCCESS) {
+    if (!keyNode->session.spec.needAppendNonce) {
         return HKS_SUCCESS;
     }
-    if (needAppendNonce->boolParam != true) {
-        HKS_LOG_E("need regenerate nonce value invalid!");
-        return HKS_ERROR_INVALID_ARGUMENT;
-    }
-    struct HksParam *nonceParam = NULL;
-    ret = HksGetParam(keyNode->runtimeParamSet, HKS_TAG_NONCE, &nonceParam);
-    HKS_IF_NOT_SUCC_LOGE_RETURN(ret, HKS_ERROR_CHECK_GET_NONCE_FAIL, "append cipher get nonce param failed!")
-    if (nonceParam->blob.size != nonceLen) {
+    const struct HksBlob *nonce = &keyNode->session.spec.aeadParam.nonce;
+    if (nonce->size != nonceLen) {
         HKS_LOG_E("nonce size invalid!");
         return HKS_ERROR_INVALID_ARGUMENT;
     }
-    if (memcpy_s(outData->data + inData->size + tag.size, nonceLen,
-        nonceParam->blob.data, nonceParam->blob.size) != EOK) {
+    if (memcpy_s(outData->data + inData->size + tag.size, nonceLen, nonce->data, nonce->size) != EOK) {
         HKS_LOG_E("memcpy cached data failed");
         return HKS_ERROR_INSUFFICIENT_MEMORY;
     }
-    outData->size += nonceParam->blob.size;
+    outData->size += nonce->size;
     return HKS_SUCCESS;
 }
 
-static int32_t CoreAesEncryptFinish(const struct HuksKeyNode *keyNode,
+static int32_t CoreAesEncryptFinish(struct HuksKeyNode *keyNode,
     const struct HksBlob *inData, struct HksBlob *outData, uint32_t alg)
 {
     struct HksBlob tag = { 0, NULL };
-    int32_t ret = HksGetEncryptAeTag(keyNode->runtimeParamSet, inData, outData, &tag);
+    int32_t ret = GetEncryptAeTag(keyNode, inData, outData, &tag);
     HKS_IF_NOT_SUCC_LOGE_RETURN(ret, ret, "cipher encrypt get ae tag failed!")
 
-    ret = HksCheckFinishOutSize(true, keyNode->runtimeParamSet, inData, outData);
+    ret = HksCheckFinishOutSize(true, keyNode, inData, outData);
     HKS_IF_NOT_SUCC_LOGE_RETURN(ret, ret, "aes encrypt finish check data size failed")
 
-    struct HksParam *ctxParam = NULL;
-    ret = HksGetParam(keyNode->runtimeParamSet, HKS_TAG_CRYPTO_CTX, &ctxParam);
-    HKS_IF_NOT_SUCC_LOGE_RETURN(ret, ret, "get ctx from keyNode failed!")
-
-    void *ctx = (void *)(uintptr_t)ctxParam->uint64Param;
+    void *ctx = keyNode->session.ctx;
     HKS_IF_NULL_LOGE_RETURN(ctx, HKS_ERROR_NULL_POINTER, "ctx is invalid: null!")
 
-    struct HksParam *needAppendNonce = NULL;
-    ret = HksGetParam(keyNode->runtimeParamSet, HKS_TAG_AES_GCM_NEED_REGENERATE_NONCE, &needAppendNonce);
-    if (ret == HKS_SUCCESS && needAppendNonce->boolParam == true) {
+    if (keyNode->session.spec.needAppendNonce) {
         if (outData->size < (inData->size + HKS_AE_TAG_LEN + HKS_AES_GCM_NONCE_LEN)) {
             HKS_LOG_E("too small out buf!");
             return HKS_ERROR_INVALID_ARGUMENT;
@@ -886,7 +854,7 @@ static int32_t CoreAesEncryptFinish(const struct HuksKeyNode *keyNode,
     }
 
     ret = HksCryptoHalEncryptFinal(inData, &ctx, outData, &tag, alg);
-    ctxParam->uint64Param = 0; /* clear ctx to NULL */
+    keyNode->session.ctx = NULL;
     if (ret != HKS_SUCCESS) {
         HKS_LOG_E("aes encrypt Finish failed! ret : %" LOG_PUBLIC "d", ret);
         return ret;
@@ -902,115 +870,91 @@ static int32_t CoreAesEncryptFinish(const struct HuksKeyNode *keyNode,
     return HKS_SUCCESS;
 }
 
-static int32_t CoreAesDecryptFinish(const struct HuksKeyNode *keyNode,
+static int32_t CoreAesDecryptFinish(struct HuksKeyNode *keyNode,
     const struct HksBlob *inData, struct HksBlob *outData, uint32_t alg)
 {
-    bool isAes = false;
-    bool isAeMode = false;
-    int32_t ret = HksCheckAesAeMode(keyNode->runtimeParamSet, &isAes, &isAeMode);
-    HKS_IF_NOT_SUCC_LOGE_RETURN(ret, ret, "get aeMode failed!")
-
     struct HksBlob tag = { 0, NULL };
-    if (isAes && isAeMode) {
-        struct HksParam *tagParam = NULL;
-        ret = HksGetParam(keyNode->runtimeParamSet, HKS_TAG_AE_TAG, &tagParam);
-        if (ret != HKS_SUCCESS || tagParam == NULL) {
-            HKS_LOG_E("get tag failed!");
-            return ret;
-        }
-        tag = tagParam->blob;
+    if (keyNode->session.spec.isAeMode) {
+        tag = keyNode->session.spec.aeadParam.tagDec;
+        HKS_IF_NULL_LOGE_RETURN(tag.data, HKS_ERROR_PARAM_NOT_EXIST, "get tag failed!")
     }
 
-    ret = HksCheckFinishOutSize(false, keyNode->runtimeParamSet, inData, outData);
+    int32_t ret = HksCheckFinishOutSize(false, keyNode, inData, outData);
     HKS_IF_NOT_SUCC_LOGE_RETURN(ret, ret, "aes decrypt finish check data size failed")
 
-    struct HksParam *ctxParam = NULL;
-    ret = HksGetParam(keyNode->runtimeParamSet, HKS_TAG_CRYPTO_CTX, &ctxParam);
-    HKS_IF_NOT_SUCC_LOGE_RETURN(ret, ret, "get ctx from keyNode failed!")
-
-    void *ctx = (void *)(uintptr_t)ctxParam->uint64Param;
+    void *ctx = keyNode->session.ctx;
     HKS_IF_NULL_LOGE_RETURN(ctx, HKS_ERROR_NULL_POINTER, "ctx is invalid: null!")
 
     ret = HksCryptoHalDecryptFinal(inData, &ctx, outData, &tag, alg);
     HKS_IF_NOT_SUCC_LOGE(ret, "cipher DecryptFinish failed! ret : %" LOG_PUBLIC "d", ret)
 
-    ctxParam->uint64Param = 0; /* clear ctx to NULL */
+    keyNode->session.ctx = NULL;
     return ret;
 }
 
-static int32_t CoreAesCcmCipherFinish(const struct HuksKeyNode *keyNode, const bool isEncrypt,
+static int32_t CoreAesCcmCipherFinish(struct HuksKeyNode *keyNode, const bool isEncrypt,
     const struct HksBlob *inData, struct HksBlob *outData)
 {
-    int32_t ret = HksCheckFinishOutSize(isEncrypt, keyNode->runtimeParamSet, inData, outData);
+    int32_t ret = HksCheckFinishOutSize(isEncrypt, keyNode, inData, outData);
     HKS_IF_NOT_SUCC_LOGE_RETURN(ret, ret, "ccm check data size failed")
 
-    struct HksBlob rawKey = { 0, NULL };
-    struct HksUsageSpec *usageSpec = NULL;
-    do {
-        uint8_t tmpData[HKS_TEMP_SIZE] = {0};
-        struct HksBlob tmpInData = { HKS_TEMP_SIZE, tmpData };
-        ret = HksBuildCipherUsageSpec(keyNode->runtimeParamSet, isEncrypt, &tmpInData, &usageSpec);
-        HKS_IF_NOT_SUCC_LOGE_BREAK(ret, "ccm build cipher usage failed")
-
-        ret = HksGetRawKey(keyNode->keyBlobParamSet, &rawKey);
-        HKS_IF_NOT_SUCC_LOGE_BREAK(ret, "ccm get raw key failed")
+    struct HksKeyNodeUsageSpec *spec = &keyNode->session.spec;
+    if (spec->needAppendNonce && (outData->size < (inData->size + HKS_AE_TAG_LEN + HKS_AES_CCM_NONCE_LEN))) {
+        HKS_LOG_E("ccm too small out buf");
+        return HKS_ERROR_INVALID_ARGUMENT;
+    }
+    if ((spec->usageSpec.purpose != HKS_KEY_PURPOSE_ENCRYPT) && (spec->aeadParam.tagDec.data == NULL)) {
+        HKS_LOG_E("ccm decrypt get ae tag failed");
+        return HKS_ERROR_PARAM_NOT_EXIST;
+    }
 
-        struct HksParam *needAppendNonce = NULL;
-        ret = HksGetParam(keyNode->runtimeParamSet, HKS_TAG_AES_GCM_NEED_REGENERATE_NONCE, &needAppendNonce);
-        if (ret == HKS_SUCCESS && needAppendNonce->boolParam == true) {
-            if (outData->size < (inData->size + HKS_AE_TAG_LEN + HKS_AES_CCM_NONCE_LEN)) {
-                HKS_IF_NOT_SUCC_LOGE_BREAK(HKS_ERROR_INVALID_ARGUMENT, "ccm too small out buf")
-            }
-        }
+    struct HksBlob rawKey = { 0, NULL };
+    ret = HksGetRawKey(keyNode->keyBlobParamSet, &rawKey);
+    HKS_IF_NOT_SUCC_LOGE_RETURN(ret, ret, "ccm get raw key failed")
 
-        struct HksAeadParam *aeadParam = usageSpec->algParam;
-        aeadParam->payloadLen = inData->size;
-        if (usageSpec->purpose == HKS_KEY_PURPOSE_ENCRYPT) {
+    spec->aeadParam.payloadLen = inData->size;
+    do {
+        if (spec->usageSpec.purpose == HKS_KEY_PURPOSE_ENCRYPT) {
             struct HksBlob tag = { 0, NULL };
-            ret = HksGetEncryptAeTag(keyNode->runtimeParamSet, inData, outData, &tag);
+            ret = GetEncryptAeTag(keyNode, inData, outData, &tag);
             HKS_IF_NOT_SUCC_LOGE_BREAK(ret, "ccm encrypt get ae tag failed")
-            ret = HksCryptoHalEncrypt(&rawKey, usageSpec, inData, outData, &tag);
+            ret = HksCryptoHalEncrypt(&rawKey, &spec->usageSpec, inData, outData, &tag);
             HKS_IF_NOT_SUCC_LOGE_BREAK(ret, "ccm encrypt error")
             ret = AppendNonceWhenNeeded(keyNode, inData, HKS_AES_CCM_NONCE_LEN, outData, tag);
             HKS_IF_NOT_SUCC_LOGE_BREAK(ret, "ccm append nonce failed")
             outData->size += tag.size;
         } else {
-            ret = HksGetDecryptAeTag(keyNode->runtimeParamSet, usageSpec);
-            HKS_IF_NOT_SUCC_LOGE_BREAK(ret, "ccm decrypt get ae tag failed")
-            ret = HksCryptoHalDecrypt(&rawKey, usageSpec, inData, outData);
+            ret = HksCryptoHalDecrypt(&rawKey, &spec->usageSpec, inData, outData);
         }
     } while (0);
 
     HKS_MEMSET_FREE_BLOB(rawKey);
-    HksFreeUsageSpec(&usageSpec);
     return ret;
 }
 
-static int32_t CoreAesCipherInit(const struct HuksKeyNode *keyNode)
+static int32_t CoreAesCipherInit(struct HuksKeyNode *keyNode)
 {
-    struct HksParam *modeParam = NULL;
-    int32_t ret = HksGetParam(keyNode->runtimeParamSet, HKS_TAG_BLOCK_MODE, &modeParam);
-    HKS_IF_NOT_SUCC_LOGE_RETURN(ret, ret, "cipher init get block mode failed")
+    if (!keyNode->session.hasMode) {
+        HKS_LOG_E("cipher init get block mode failed");
+        return HKS_ERROR_PARAM_NOT_EXIST;
+    }
 
-    if (modeParam->uint32Param == HKS_MODE_CCM) {
-        ret = UpdateNonceForAesAeMode((struct HksParamSet **)(unsigned long)&keyNode->runtimeParamSet,
-            keyNode->keyBlobParamSet, true);
+    if (keyNode->session.mode == HKS_MODE_CCM) {
+        int32_t ret = UpdateNonceForAesAeMode(&keyNode->runtimeParamSet, keyNode->keyBlobParamSet, true);
         HKS_IF_NOT_SUCC_LOGE_RETURN(ret, ret, "update aes gcm nonce failed")
+        ret = BuildSessionUsageSpec(keyNode);
+        HKS_IF_NOT_SUCC_LOGE_RETURN(ret, ret, "build ccm usage failed")
         return SetCacheModeCtx(keyNode);
     }
 
     return CoreCipherInit(keyNode);
 }
 
-static int32_t CoreAesCipherUpdate(const struct HuksKeyNode *keyNode, const struct HksBlob *inData,
+static int32_t CoreAesCipherUpdate(struct HuksKeyNode *keyNode, const struct HksBlob *inData,
     struct HksBlob *outData, uint32_t alg)
 {
-    struct HksParam *modeParam = NULL;
-    int32_t ret = HksGetParam(keyNode->runtimeParamSet, HKS_TAG_BLOCK_MODE, &modeParam);
-    HKS_IF_NOT_SUCC_LOGE_RETURN(ret, ret, "cipher update get block mode failed")
-
-    if (modeParam->uint32Param == HKS_MODE_CCM) {
-        ret = CheckCachedDataMaxSize(keyNode, inData, HKS_CIPHER_CCM_MODE_MAX_DATA_LEN);
+    if (keyNode->session.mode == HKS_MODE_CCM) {
+        int32_t ret = CheckCachedDataMaxSize(keyNode, inData, HKS_CIPHER_CCM_MODE_MAX_DATA_LEN);
         HKS_IF_NOT_SUCC_LOGE_RETURN(ret, ret, "cipher update in data is too long")
         if (outData != NULL) {
             outData->size = 0;
@@ -1021,14 +965,11 @@ static int32_t CoreAesCipherUpdate(const struct HuksKeyNode *keyNode, const stru
     return CoreCipherUpdate(keyNode, inData, outData, alg);
 }
 
-static int32_t CoreAesCipherFinish(const struct HuksKeyNode *keyNode, const bool isEncrypt,
+static int32_t CoreAesCipherFinish(struct HuksKeyNode *keyNode, const bool isEncrypt,
     const struct HksBlob *inData, struct HksBlob *outData, uint32_t alg)
 {
-    struct HksParam *modeParam = NULL;
-    int32_t ret = HksGetParam(keyNode->runtimeParamSet, HKS_TAG_BLOCK_MODE, &modeParam);
-    HKS_IF_NOT_SUCC_LOGE_RETURN(ret, ret, "cipher finish get block mode failed")
-    if (modeParam->uint32Param == HKS_MODE_CCM) {
-        ret = CheckCachedDataMaxSize(keyNode, inData, HKS_CIPHER_CCM_MODE_MAX_DATA_LEN);
+    if (keyNode->session.mode == HKS_MODE_CCM) {
+        int32_t ret = CheckCachedDataMaxSize(keyNode, inData, HKS_CIPHER_CCM_MODE_MAX_DATA_LEN);
         HKS_IF_NOT_SUCC_LOGE_RETURN(ret, ret, "cipher finish in data size too long")
 
         struct HksBlob tempInData = { 0, NULL };
@@ -1047,42 +988,35 @@ static int32_t CoreAesCipherFinish(const struct HuksKeyNode *keyNode, const bool
     return CoreAesDecryptFinish(keyNode, inData, outData, alg);
 }
 
-static int32_t CoreDesCipherInit(const struct HuksKeyNode *keyNode)
+static int32_t CoreDesCipherInit(struct HuksKeyNode *keyNode)
 {
-    struct HksParam *modeParam = NULL;
-    int32_t ret = HksGetParam(keyNode->runtimeParamSet, HKS_TAG_BLOCK_MODE, &modeParam);
-    HKS_IF_NOT_SUCC_LOGE_RETURN(ret, ret, "cipher init get block mode failed")
+    if (!keyNode->session.hasMode) {
+        HKS_LOG_E("cipher init get block mode failed");
+        return HKS_ERROR_PARAM_NOT_EXIST;
+    }
 
     return CoreCipherInit(keyNode);
 }
 
-static int32_t CoreDesCipherUpdate(const struct HuksKeyNode *keyNode, const struct HksBlob *inData,
+static int32_t CoreDesCipherUpdate(struct HuksKeyNode *keyNode, const struct HksBlob *inData,
     struct HksBlob *outData, uint32_t alg)
 {
-    struct HksParam *modeParam = NULL;
-    int32_t ret = HksGetParam(keyNode->runtimeParamSet, HKS_TAG_BLOCK_MODE, &modeParam);
-    HKS_IF_NOT_SUCC_LOGE_RETURN(ret, ret, "cipher update get block mode failed")
-
     return CoreCipherUpdate(keyNode, inData, outData, alg);
 }
 
 static int32_t CoreDesEncryptFinish(
-    const struct HuksKeyNode *keyNode, const struct HksBlob *inData, struct HksBlob *outData, uint32_t alg)
+    struct HuksKeyNode *keyNode, const struct HksBlob *inData, struct HksBlob *outData, uint32_t alg)
 {
     struct HksBlob tag = {0, NULL};
 
-    int32_t ret = HksCheckFinishOutSize(true, keyNode->runtimeParamSet, inData, outData);
+    int32_t ret = HksCheckFinishOutSize(true, keyNode, inData, outData);
     HKS_IF_NOT_SUCC_LOGE_RETURN(ret, ret, "des encrypt finish check data size failed")
 
-    struct HksParam *ctxParam = NULL;
-    ret = HksGetParam(keyNode->runtimeParamSet, HKS_TAG_CRYPTO_CTX, &ctxParam);
-    HKS_IF_NOT_SUCC_LOGE_RETURN(ret, ret, "get ctx from keyNode failed!")
-
-    void *ctx = (void *)(uintptr_t)ctxParam->uint64Param;
+    void *ctx = keyNode->session.ctx;
     HKS_IF_NULL_LOGE_RETURN(ctx, HKS_ERROR_NULL_POINTER, "ctx is invalid: null!")
 
     ret = HksCryptoHalEncryptFinal(inData, &ctx, outData, &tag, alg);
-    ctxParam->uint64Param = 0; /* clear ctx to NULL */
+    keyNode->session.ctx = NULL;
     if (ret != HKS_SUCCESS) {
         HKS_LOG_E("des encrypt Finish failed! ret : %" LOG_PUBLIC "d", ret);
         return ret;
@@ -1093,34 +1027,26 @@ static int32_t CoreDesEncryptFinish(
 }
 
 static int32_t CoreDesDecryptFinish(
-    const struct HuksKeyNode *keyNode, const struct HksBlob *inData, struct HksBlob *outData, uint32_t alg)
+    struct HuksKeyNode *keyNode, const struct HksBlob *inData, struct HksBlob *outData, uint32_t alg)
 {
     struct HksBlob tag = {0, NULL};
 
-    int32_t ret = HksCheckFinishOutSize(false, keyNode->runtimeParamSet, inData, outData);
+    int32_t ret = HksCheckFinishOutSize(false, keyNode, inData, outData);
     HKS_IF_NOT_SUCC_LOGE_RETURN(ret, ret, "des decrypt finish check data size failed")
 
-    struct HksParam *ctxParam = NULL;
-    ret = HksGetParam(keyNode->runtimeParamSet, HKS_TAG_CRYPTO_CTX, &ctxParam);
-    HKS_IF_NOT_SUCC_LOGE_RETURN(ret, ret, "get ctx from keyNode failed!")
-
-    void *ctx = (void *)(uintptr_t)ctxParam->uint64Param;
+    void *ctx = keyNode->session.ctx;
     HKS_IF_NULL_LOGE_RETURN(ctx, HKS_ERROR_NULL_POINTER, "ctx is invalid: null!")
 
     ret = HksCryptoHalDecryptFinal(inData, &ctx, outData, &tag, alg);
     HKS_IF_NOT_SUCC_LOGE(ret, "cipher DecryptFinish failed! ret : %" LOG_PUBLIC "d", ret)
 
-    ctxParam->uint64Param = 0; /* clear ctx to NULL */
+    keyNode->session.ctx = NULL;
     return ret;
 }
 
-static int32_t CoreDesCipherFinish(const struct HuksKeyNode *keyNode, const bool isEncrypt,
+static int32_t CoreDesCipherFinish(struct HuksKeyNode *keyNode, const bool isEncrypt,
     const struct HksBlob *inData, struct HksBlob *outData, uint32_t alg)
 {
-    struct HksParam *modeParam = NULL;
-    int32_t ret = HksGetParam(keyNode->runtimeParamSet, HKS_TAG_BLOCK_MODE, &modeParam);
-    HKS_IF_NOT_SUCC_LOGE_RETURN(ret, ret, "cipher finish get block mode failed")
-
     if (isEncrypt) {
         return CoreDesEncryptFinish(keyNode, inData, outData, alg);
     }
@@ -1128,42 +1054,35 @@ static int32_t CoreDesCipherFinish(const struct HuksKeyNode *keyNode, const bool
     return CoreDesDecryptFinish(keyNode, inData, outData, alg);
 }
 
-static int32_t Core3DesCipherInit(const struct HuksKeyNode *keyNode)
+static int32_t Core3DesCipherInit(struct HuksKeyNode *keyNode)
 {
-    struct HksParam *modeParam = NULL;
-    int32_t ret = HksGetParam(keyNode->runtimeParamSet, HKS_TAG_BLOCK_MODE, &modeParam);
-    HKS_IF_NOT_SUCC_LOGE_RETURN(ret, ret, "cipher init get block mode failed")
+    if (!keyNode->session.hasMode) {
+        HKS_LOG_E("cipher init get block mode failed");
+        return HKS_ERROR_PARAM_NOT_EXIST;
+    }
 
     return CoreCipherInit(keyNode);
 }
 
-static int32_t Core3DesCipherUpdate(const struct HuksKeyNode *keyNode, const struct HksBlob *inData,
+static int32_t Core3DesCipherUpdate(struct HuksKeyNode *keyNode, const struct HksBlob *inData,
     struct HksBlob *outData, uint32_t alg)
 {
-    struct HksParam *modeParam = NULL;
-    int32_t ret = HksGetParam(keyNode->runtimeParamSet, HKS_TAG_BLOCK_MODE, &modeParam);
-    HKS_IF_NOT_SUCC_LOGE_RETURN(ret, ret, "cipher update get block mode failed")
-
     return CoreCipherUpdate(keyNode, inData, outData, alg);
 }
 
 static int32_t Core3DesEncryptFinish(
-    const struct HuksKeyNode *keyNode, const struct HksBlob *inData, struct HksBlob *outData, uint32_t alg)
+    struct HuksKeyNode *keyNode, const struct HksBlob *inData, struct HksBlob *outData, uint32_t alg)
 {
     struct HksBlob tag = {0, NULL};
 
-    int32_t ret = HksCheckFinishOutSize(true, keyNode->runtimeParamSet, inData, outData);
+    int32_t ret = HksCheckFinishOutSize(true, keyNode, inData, outData);
     HKS_IF_NOT_SUCC_LOGE_RETURN(ret, ret, "3des encrypt finish check data size failed")
 
-    struct HksParam *ctxParam = NULL;
-    ret = HksGetParam(keyNode->runtimeParamSet, HKS_TAG_CRYPTO_CTX, &ctxParam);
-    HKS_IF_NOT_SUCC_LOGE_RETURN(ret, ret, "get ctx from keyNode failed!")
-
-    void *ctx = (void *)(uintptr_t)ctxParam->uint64Param;
+    void *ctx = keyNode->session.ctx;
     HKS_IF_NULL_LOGE_RETURN(ctx, HKS_ERROR_NULL_POINTER, "ctx is invalid: null!")
 
     ret = HksCryptoHalEncryptFinal(inData, &ctx, outData, &tag, alg);
-    ctxParam->uint64Param = 0; /* clear ctx to NULL */
+    keyNode->session.ctx = NULL;
     if (ret != HKS_SUCCESS) {
         HKS_LOG_E("3des encrypt Finish failed! ret : %" LOG_PUBLIC "d", ret);
         return ret;
@@ -1174,34 +1093,26 @@ static int32_t Core3DesEncryptFinish(
 }
 
 static int32_t Core3DesDecryptFinish(
-    const struct HuksKeyNode *keyNode, const struct HksBlob *inData, struct HksBlob *outData, uint32_t alg)
+    struct HuksKeyNode *keyNode, const struct HksBlob *inData, struct HksBlob *outData, uint32_t alg)
 {
     struct HksBlob tag = {0, NULL};
 
-    int32_t ret = HksCheckFinishOutSize(false, keyNode->runtimeParamSet, inData, outData);
+    int32_t ret = HksCheckFinishOutSize(false, keyNode, inData, outData);
     HKS_IF_NOT_SUCC_LOGE_RETURN(ret, ret, "3des decrypt finish check data size failed")
 
-    struct HksParam *ctxParam = NULL;
-    ret = HksGetParam(keyNode->runtimeParamSet, HKS_TAG_CRYPTO_CTX, &ctxParam);
-    HKS_IF_NOT_SUCC_LOGE_RETURN(ret, ret, "get ctx from keyNode failed!")
-
-    void *ctx = (void *)(uintptr_t)ctxParam->uint64Param;
+    void *ctx = keyNode->session.ctx;
     HKS_IF_NULL_LOGE_RETURN(ctx, HKS_ERROR_NULL_POINTER, "ctx is invalid: null!")
 
     ret = HksCryptoHalDecryptFinal(inData, &ctx, outData, &tag, alg);
     HKS_IF_NOT_SUCC_LOGE(ret, "cipher DecryptFinish failed! ret : %" LOG_PUBLIC "d", ret)
 
-    ctxParam->uint64Param = 0; /* clear ctx to NULL */
+    keyNode->session.ctx = NULL;
     return ret;
 }
 
-static int32_t Core3DesCipherFinish(const struct HuksKeyNode *keyNode, const bool isEncrypt,
+static int32_t Core3DesCipherFinish(struct HuksKeyNode *keyNode, const bool isEncrypt,
     const struct HksBlob *inData, struct HksBlob *outData, uint32_t alg)
 {
-    struct HksParam *modeParam = NULL;
-    int32_t ret = HksGetParam(keyNode->runtimeParamSet, HKS_TAG_BLOCK_MODE, &modeParam);
-    HKS_IF_NOT_SUCC_LOGE_RETURN(ret, ret, "cipher finish get block mode failed")
-
     if (isEncrypt) {
         return Core3DesEncryptFinish(keyNode, inData, outData, alg);
     }
@@ -1209,47 +1120,39 @@ static int32_t Core3DesCipherFinish(const struct HuksKeyNode *keyNode, const boo
     return Core3DesDecryptFinish(keyNode, inData, outData, alg);
 }
 
-static int32_t CoreSm4EncryptFinish(const struct HuksKeyNode *keyNode,
+static int32_t CoreSm4EncryptFinish(struct HuksKeyNode *keyNode,
     const struct HksBlob *inData, struct HksBlob *outData, uint32_t alg)
 {
-    int32_t ret = HksCheckFinishOutSize(true, keyNode->runtimeParamSet, inData, outData);
+    int32_t ret = HksCheckFinishOutSize(true, keyNode, inData, outData);
     HKS_IF_NOT_SUCC_LOGE_RETURN(ret, ret, "sm4 encrypt finish check data size failed")
 
-    struct HksParam *ctxParam = NULL;
-    ret = HksGetParam(keyNode->runtimeParamSet, HKS_TAG_CRYPTO_CTX, &ctxParam);
-    HKS_IF_NOT_SUCC_LOGE_RETURN(ret, ret, "get ctx from keyNode failed!")
-
-    void *ctx = (void *)(uintptr_t)ctxParam->uint64Param;
+    void *ctx = keyNode->session.ctx;
     HKS_IF_NULL_LOGE_RETURN(ctx, HKS_ERROR_NULL_POINTER, "ctx is invalid: null!")
 
     ret = HksCryptoHalEncryptFinal(inData, &ctx, outData, NULL, alg);
     if (ret != HKS_SUCCESS) {
         HKS_LOG_E("sm4 encrypt Finish failed! ret : %" LOG_PUBLIC "d", ret);
-        ctxParam->uint64Param = 0; /* clear ctx to NULL */
+        keyNode->session.ctx = NULL;
         return ret;
     }
 
-    ctxParam->uint64Param = 0; /* clear ctx to NULL */
+    keyNode->session.ctx = NULL;
     return HKS_SUCCESS;
 }
 
-static int32_t CoreSm4DecryptFinish(const struct HuksKeyNode *keyNode,
+static int32_t CoreSm4DecryptFinish(struct HuksKeyNode *keyNode,
     const struct HksBlob *inData, struct HksBlob *outData, uint32_t alg)
 {
-    int32_t ret = HksCheckFinishOutSize(false, keyNode->runtimeParamSet, inData, outData);
+    int32_t ret = HksCheckFinishOutSize(false, keyNode, inData, outData);
     HKS_IF_NOT_SUCC_LOGE_RETURN(ret, ret, "sm4 decrypt finish check data size failed")
 
-    struct HksParam *ctxParam = NULL;
-    ret = HksGetParam(keyNode->runtimeParamSet, HKS_TAG_CRYPTO_CTX, &ctxParam);
-    HKS_IF_NOT_SUCC_LOGE_RETURN(ret, ret, "get ctx from keyNode failed!")
-
-    void *ctx = (void *)(uintptr_t)ctxParam->uint64Param;
+    void *ctx = keyNode->session.ctx;
     HKS_IF_NULL_LOGE_RETURN(ctx, HKS_ERROR_NULL_POINTER, "ctx is invalid: null!")
 
     ret = HksCryptoHalDecryptFinal(inData, &ctx, outData, NULL, alg);
     HKS_IF_NOT_SUCC_LOGE(ret, "cipher DecryptFinish failed! ret : %" LOG_PUBLIC "d", ret)
 
-    ctxParam->uint64Param = 0; /* clear ctx to NULL */
+    keyNode->session.ctx = NULL;
     return ret;
 }
 
@@ -1261,12 +1164,9 @@ static int32_t RsaCipherFinish(const struct HuksKeyNode *keyNode, const struct H
     int32_t ret = HksGetRawKey(keyNode->keyBlobParamSet, &rawKey);
     HKS_IF_NOT_SUCC_LOGE_RETURN(ret, ret, "SignVerify get raw key failed!")
 
-    struct HksUsageSpec usageSpec;
-    (void)memset_s(&usageSpec, sizeof(struct HksUsageSpec), 0, sizeof(struct HksUsageSpec));
-    HksFillUsageSpec(keyNode->runtimeParamSet, &usageSpec);
-
-    bool isEncrypt = (usageSpec.purpose == HKS_KEY_PURPOSE_ENCRYPT);
-    ret = HksCheckFinishOutSize(isEncrypt, keyNode->runtimeParamSet, inData, outData);
+    const struct HksUsageSpec *usageSpec = &keyNode->session.spec.usageSpec;
+    bool isEncrypt = (usageSpec->purpose == HKS_KEY_PURPOSE_ENCRYPT);
+    ret = HksCheckFinishOutSize(isEncrypt, keyNode, inData, outData);
     if (ret != HKS_SUCCESS) {
         HKS_LOG_E("rsa cipher finish check data size failed");
         (void)memset_s(rawKey.data, rawKey.size, 0, rawKey.size);
@@ -1274,14 +1174,14 @@ static int32_t RsaCipherFinish(const struct HuksKeyNode *keyNode, const struct H
         return ret;
     }
 
-    if (usageSpec.purpose == HKS_KEY_PURPOSE_ENCRYPT) {
+    if (isEncrypt) {
         struct HksBlob tag = { 0, NULL };
-        ret = HksCryptoHalEncrypt(&rawKey, &usageSpec, inData, outData, &tag);
+        ret = HksCryptoHalEncrypt(&rawKey, usageSpec, inData, outData, &tag);
     } else {
-        ret = HksCryptoHalDecrypt(&rawKey, &usageSpec, inData, outData);
+        ret = HksCryptoHalDecrypt(&rawKey, usageSpec, inData, outData);
     }
     HKS_IF_NOT_SUCC_LOGE(ret, "rsa cipher Finish failed, purpose = 0x%" LOG_PUBLIC "x, ret = %" LOG_PUBLIC "d",
-        usageSpec.purpose, ret)
+        usageSpec->purpose, ret)
 
     (void)memset_s(rawKey.data, rawKey.size, 0, rawKey.size);
     HKS_FREE(rawKey.data);
@@ -1296,11 +1196,9 @@ static int32_t Sm2CipherFinish(const struct HuksKeyNode *keyNode, const struct H
     int32_t ret = HksGetRawKey(keyNode->keyBlobParamSet, &rawKey);
     HKS_IF_NOT_SUCC_LOGE_RETURN(ret, ret, "SignVerify get raw key failed!")
 
-    struct HksUsageSpec usageSpec = {0};
-    HksFillUsageSpec(keyNode->runtimeParamSet, &usageSpec);
-
-    bool isEncrypt = (usageSpec.purpose == HKS_KEY_PURPOSE_ENCRYPT);
-    ret = HksCheckFinishOutSize(isEncrypt, keyNode->runtimeParamSet, inData, outData);
+    const struct HksUsageSpec *usageSpec = &keyNode->session.spec.usageSpec;
+    bool isEncrypt = (usageSpec->purpose == HKS_KEY_PURPOSE_ENCRYPT);
+    ret = HksCheckFinishOutSize(isEncrypt, keyNode, inData, outData);
     if (ret != HKS_SUCCESS) {
         HKS_LOG_E("sm2 cipher finish check data size failed");
         (void)memset_s(rawKey.data, rawKey.size, 0, rawKey.size);
@@ -1308,21 +1206,21 @@ static int32_t Sm2CipherFinish(const struct HuksKeyNode *keyNode, const struct H
         return ret;
     }
 
-    if (usageSpec.purpose == HKS_KEY_PURPOSE_ENCRYPT) {
+    if (isEncrypt) {
         struct HksBlob tag = { 0, NULL };
-        ret = HksCryptoHalEncrypt(&rawKey, &usageSpec, inData, outData, &tag);
+        ret = HksCryptoHalEncrypt(&rawKey, usageSpec, inData, outData, &tag);
     } else {
-        ret = HksCryptoHalDecrypt(&rawKey, &usageSpec, inData, outData);
+        ret = HksCryptoHalDecrypt(&rawKey, usageSpec, inData, outData);
     }
     HKS_IF_NOT_SUCC_LOGE(ret, "sm2 cipher Finish failed, purpose = 0x%" LOG_PUBLIC "x, ret = %" LOG_PUBLIC "d",
-        usageSpec.purpose, ret)
+        usageSpec->purpose, ret)
 
     (void)memset_s(rawKey.data, rawKey.size, 0, rawKey.size);
     HKS_FREE(rawKey.data);
     return ret;
 }
 
-static int32_t CoreRsaCipherFinish(const struct HuksKeyNode *keyNode, const struct HksBlob *inData,
+static int32_t CoreRsaCipherFinish(struct HuksKeyNode *keyNode, const struct HksBlob *inData,
     struct HksBlob *outData)
 {
     struct HksBlob tempInData = { 0, NULL };
@@ -1334,7 +1232,7 @@ static int32_t CoreRsaCipherFinish(const struct HuksKeyNode *keyNode, const stru
     return ret;
 }
 
-static int32_t CoreSm2CipherFinish(const struct HuksKeyNode *keyNode, const struct HksBlob *inData,
+static int32_t CoreSm2CipherFinish(struct HuksKeyNode *keyNode, const struct HksBlob *inData,
     struct HksBlob *outData)
 {
     struct HksBlob tempInData = { 0, NULL };
@@ -1346,27 +1244,19 @@ static int32_t CoreSm2CipherFinish(const struct HuksKeyNode *keyNode, const stru
     return ret;
 }
 
-static void FreeCryptoCtx(const struct HuksKeyNode *keyNode, uint32_t alg)
+static void FreeCryptoCtx(struct HuksKeyNode *keyNode, uint32_t alg)
 {
-    struct HksParam *ctxParam = NULL;
-    int32_t ret = HksGetParam(keyNode->runtimeParamSet, HKS_TAG_CRYPTO_CTX, &ctxParam);
-    if (ret != HKS_SUCCESS) {
-        HKS_LOG_E("get ctx from keyNode failed!");
-        return;
-    }
-    void *ctx = (void *)(uintptr_t)ctxParam->uint64Param;
+    void *ctx = keyNode->session.ctx;
     if (ctx == NULL) {
         return;
     }
 
     if ((alg == HKS_ALG_AES) || (alg == HKS_ALG_DES) || (alg == HKS_ALG_3DES)) {
-        struct HksParam *modeParam = NULL;
-        ret = HksGetParam(keyNode->runtimeParamSet, HKS_TAG_BLOCK_MODE, &modeParam);
-        if (ret != HKS_SUCCESS) {
-            HKS_LOG_E("get ctx from keyNode failed!");
+        if (!keyNode->session.hasMode) {
+            HKS_LOG_E("get mode from keyNode failed!");
             return;
         }
-        if (modeParam->uint32Param == HKS_MODE_CCM) {
+        if (keyNode->session.mode == HKS_MODE_CCM) {
             struct HksBlob *cachedData = (struct HksBlob *)ctx;
             HKS_LOG_D("FreeCryptoCtx free ccm cache data!");
             FreeCachedData(&cachedData);
@@ -1380,12 +1270,12 @@ static void FreeCryptoCtx(const struct HuksKeyNode *keyNode, uint32_t alg)
         FreeCachedData(&cachedData);
     }
 
-    ctxParam->uint64Param = 0; /* clear ctx to NULL */
+    keyNode->session.ctx = NULL;
 }
 
 static int32_t GetRawkey(const struct HuksKeyNode *keyNode, struct HksBlob *rawKey)
 {
-    if (GetCryptoCtx(keyNode) != NULL) {
+    if (keyNode->session.ctx != NULL) {
         HKS_LOG_E("avoid running into this function multiple times!");
         return HKS_FAILURE;
     }
@@ -1450,26 +1340,24 @@ static int32_t ConstructAgreeBlob(struct HksBlob **agreeOut)
     return HKS_SUCCESS;
 }
 
-int32_t HksCoreSignVerifyThreeStageInit(const struct HuksKeyNode *keyNode, const struct HksParamSet *paramSet,
+int32_t HksCoreSignVerifyThreeStageInit(struct HuksKeyNode *keyNode, const struct HksParamSet *paramSet,
     uint32_t alg)
 {
     (void)paramSet;
     int32_t ret = SignVerifyAuth(keyNode, keyNode->runtimeParamSet);
     HKS_IF_NOT_SUCC_LOGE_RETURN(ret, ret, "HksCoreSignVerifyThreeStageInit SignAuth fail ret : %" LOG_PUBLIC "d", ret)
 
-    struct HksParam *algParam = NULL;
-    ret = HksGetParam(keyNode->runtimeParamSet, HKS_TAG_ALGORITHM, &algParam);
-    HKS_IF_NOT_SUCC_LOGE_RETURN(ret, HKS_ERROR_CHECK_GET_ALG_FAIL,
-        "get param get 0x%" LOG_PUBLIC "x failed", HKS_TAG_ALGORITHM)
+    ret = BuildSessionUsageSpec(keyNode);
+    HKS_IF_NOT_SUCC_LOGE_RETURN(ret, ret, "build sign/verify usage failed")
 
     uint32_t digest = alg;  // In signature or verify scenario, alg represents digest. See code {GetPurposeAndAlgorithm}
 
     HKS_LOG_I("Init cache or hash init.");
 #ifdef HKS_SUPPORT_RSA_ISO_IEC_9796_2
-    if ((HksCheckNeedCache(algParam->uint32Param, digest) == HKS_SUCCESS) ||
-        (HksCheckNeedCachePadding(algParam->uint32Param, keyNode) == HKS_SUCCESS)) {
+    if ((HksCheckNeedCache(keyNode->session.alg, digest) == HKS_SUCCESS) ||
+        (HksCheckNeedCachePadding(keyNode->session.alg, keyNode) == HKS_SUCCESS)) {
 #else
-    if (HksCheckNeedCache(algParam->uint32Param, digest) == HKS_SUCCESS) {
+    if (HksCheckNeedCache(keyNode->session.alg, digest) == HKS_SUCCESS) {
 #endif
         return SetCacheModeCtx(keyNode);
     } else {
@@ -1477,25 +1365,20 @@ int32_t HksCoreSignVerifyThreeStageInit(const struct HuksKeyNode *keyNode, const
     }
 }
 
-int32_t HksCoreSignVerifyThreeStageUpdate(const struct HuksKeyNode *keyNode, const struct HksParamSet *paramSet,
+int32_t HksCoreSignVerifyThreeStageUpdate(struct HuksKeyNode *keyNode, const struct HksParamSet *paramSet,
     const struct HksBlob *srcData, struct HksBlob *signature, uint32_t alg)
 {
     (void)signature;
     (void)alg;
     (void)paramSet;
 
-    struct HksParam *algParam = NULL;
-    int32_t ret = HksGetParam(keyNode->runtimeParamSet, HKS_TAG_ALGORITHM, &algParam);
-    HKS_IF_NOT_SUCC_LOGE_RETURN(ret, HKS_ERROR_CHECK_GET_ALG_FAIL,
-        "get param get 0x%" LOG_PUBLIC "x failed", HKS_TAG_ALGORITHM)
-
     uint32_t digest = alg;  // In signature or verify scenario, alg represents digest. See code {GetPurposeAndAlgorithm}
     HKS_LOG_I("Update cache or hash update.");
 #ifdef HKS_SUPPORT_RSA_ISO_IEC_9796_2
-    if ((HksCheckNeedCache(algParam->uint32Param, digest) == HKS_SUCCESS) ||
-        (HksCheckNeedCachePadding(algParam->uint32Param, keyNode) == HKS_SUCCESS)) {
+    if ((HksCheckNeedCache(keyNode->session.alg, digest) == HKS_SUCCESS) ||
+        (HksCheckNeedCachePadding(keyNode->session.alg, keyNode) == HKS_SUCCESS)) {
 #else
-    if (HksCheckNeedCache(algParam->uint32Param, digest) == HKS_SUCCESS) {
+    if (HksCheckNeedCache(keyNode->session.alg, digest) == HKS_SUCCESS) {
 #endif
         return UpdateCachedData(keyNode, srcData);
     } else {
@@ -1503,36 +1386,28 @@ int32_t HksCoreSignVerifyThreeStageUpdate(const struct HuksKeyNode *keyNode, con
     }
 }
 
-int32_t HksCoreSignVerifyThreeStageFinish(const struct HuksKeyNode *keyNode, const struct HksParamSet *paramSet,
+int32_t HksCoreSignVerifyThreeStageFinish(struct HuksKeyNode *keyNode, const struct HksParamSet *paramSet,
     const struct HksBlob *inData, struct HksBlob *outData, uint32_t alg)
 {
     (void)paramSet;
     (void)alg;
 
     struct HksBlob message = { 0, NULL };
-    struct HksParam *purposeParam = NULL;
-    int32_t ret = HksGetParam(keyNode->runtimeParamSet, HKS_TAG_PURPOSE, &purposeParam);
-    HKS_IF_NOT_SUCC_LOGE_RETURN(ret, HKS_ERROR_CHECK_GET_PURPOSE_FAIL,
-        "get param get 0x%" LOG_PUBLIC "x failed", HKS_TAG_PURPOSE)
-
-    if (purposeParam->uint32Param == HKS_KEY_PURPOSE_SIGN) { /* inData indicates signature when processing verify */
+    bool isSign = (keyNode->session.purpose == HKS_KEY_PURPOSE_SIGN);
+    if (isSign) { /* inData indicates signature when processing verify */
         message.data = inData->data;
         message.size = inData->size;
     }
 
-    struct HksParam *algParam = NULL;
-    ret = HksGetParam(keyNode->runtimeParamSet, HKS_TAG_ALGORITHM, &algParam);
-    HKS_IF_NOT_SUCC_LOGE_RETURN(ret, HKS_ERROR_CHECK_GET_ALG_FAIL,
-        "get param get 0x%" LOG_PUBLIC "x failed", HKS_TAG_ALGORITHM)
-
     uint32_t digest = alg;  // In signature or verify scenario, alg represents digest. See code {GetPurposeAndAlgorithm}
 
     struct HksBlob signVerifyData = {0, NULL};
+    int32_t ret;
 #ifdef HKS_SUPPORT_RSA_ISO_IEC_9796_2
-    if ((HksCheckNeedCache(algParam->uint32Param, digest) == HKS_SUCCESS) ||
-        (HksCheckNeedCachePadding(algParam->uint32Param, keyNode) == HKS_SUCCESS)) {
+    if ((HksCheckNeedCache(keyNode->session.alg, digest) == HKS_SUCCESS) ||
+        (HksCheckNeedCachePadding(keyNode->session.alg, keyNode) == HKS_SUCCESS)) {
 #else
-    if (HksCheckNeedCache(algParam->uint32Param, digest) == HKS_SUCCESS) {
+    if (HksCheckNeedCache(keyNode->session.alg, digest) == HKS_SUCCESS) {
 #endif
         ret = FinishCachedData(keyNode, &message, &signVerifyData);
     } else {
@@ -1543,12 +1418,12 @@ int32_t HksCoreSignVerifyThreeStageFinish(const struct HuksKeyNode *keyNode, con
 
     /* inData indicates signature when processing verify */
     ret = CoreSignVerify(keyNode, &signVerifyData,
-        (purposeParam->uint32Param == HKS_KEY_PURPOSE_SIGN) ? outData : (struct HksBlob *)inData);
+        isSign ? outData : (struct HksBlob *)inData);
     HKS_FREE_BLOB(signVerifyData);
     return ret;
 }
 
-int32_t HksCoreSignVerifyThreeStageAbort(const struct HuksKeyNode *keyNode, const struct HksParamSet *paramSet,
+int32_t HksCoreSignVerifyThreeStageAbort(struct HuksKeyNode *keyNode, const struct HksParamSet *paramSet,
     uint32_t alg)
 {
     (void)paramSet;
@@ -1558,7 +1433,7 @@ int32_t HksCoreSignVerifyThreeStageAbort(const struct HuksKeyNode *keyNode, cons
     return HKS_SUCCESS;
 }
 
-int32_t HksCoreCryptoThreeStageInit(const struct HuksKeyNode *keyNode, const struct HksParamSet *paramSet,
+int32_t HksCoreCryptoThreeStageInit(struct HuksKeyNode *keyNode, const struct HksParamSet *paramSet,
     uint32_t alg)
 {
     (void)alg;
@@ -1566,109 +1441,91 @@ int32_t HksCoreCryptoThreeStageInit(const struct HuksKeyNode *keyNode, const str
     int32_t ret = CipherAuth(keyNode, paramSet);
     HKS_IF_NOT_SUCC_LOGE_RETURN(ret, ret, "cipher init failed, ret = %" LOG_PUBLIC "d", ret)
 
-    struct HksParam *algParam = NULL;
-    ret = HksGetParam(keyNode->runtimeParamSet, HKS_TAG_ALGORITHM, &algParam);
-    HKS_IF_NOT_SUCC_LOGE_RETURN(ret, HKS_ERROR_CHECK_GET_ALG_FAIL,
-        "get param get 0x%" LOG_PUBLIC "x failed", HKS_TAG_ALGORITHM)
-
     HKS_LOG_I("Init cache or cipher init.");
 
-    if ((algParam->uint32Param == HKS_ALG_RSA) || (algParam->uint32Param == HKS_ALG_SM2)) {
+    if ((keyNode->session.alg == HKS_ALG_RSA) || (keyNode->session.alg == HKS_ALG_SM2)) {
+        ret = BuildSessionUsageSpec(keyNode);
+        HKS_IF_NOT_SUCC_LOGE_RETURN(ret, ret, "build cipher usage failed")
         return SetCacheModeCtx(keyNode);
-    } else if (algParam->uint32Param == HKS_ALG_AES) {
+    } else if (keyNode->session.alg == HKS_ALG_AES) {
         return CoreAesCipherInit(keyNode);
-    } else if (algParam->uint32Param == HKS_ALG_DES) {
+    } else if (keyNode->session.alg == HKS_ALG_DES) {
         return CoreDesCipherInit(keyNode);
-    } else if (algParam->uint32Param == HKS_ALG_3DES) {
+    } else if (keyNode->session.alg == HKS_ALG_3DES) {
         return Core3DesCipherInit(keyNode);
-    } else if (algParam->uint32Param == HKS_ALG_SM4) {
+    } else if (keyNode->session.alg == HKS_ALG_SM4) {
         return CoreCipherInit(keyNode);
     } else {
         return HKS_ERROR_INVALID_ALGORITHM;
     }
 }
 
-int32_t HksCoreCryptoThreeStageUpdate(const struct HuksKeyNode *keyNode, const struct HksParamSet *paramSet,
+int32_t HksCoreCryptoThreeStageUpdate(struct HuksKeyNode *keyNode, const struct HksParamSet *paramSet,
     const struct HksBlob *inData, struct HksBlob *outData, uint32_t alg)
 {
     (void)paramSet;
-    struct HksParam *algParam = NULL;
-    int32_t ret = HksGetParam(keyNode->runtimeParamSet, HKS_TAG_ALGORITHM, &algParam);
-    HKS_IF_NOT_SUCC_LOGE_RETURN(ret, HKS_ERROR_CHECK_GET_ALG_FAIL,
-        "get param get 0x%" LOG_PUBLIC "x failed", HKS_TAG_ALGORITHM)
-
-    if ((algParam->uint32Param == HKS_ALG_RSA) || (algParam->uint32Param == HKS_ALG_SM2)) {
+    if ((keyNode->session.alg == HKS_ALG_RSA) || (keyNode->session.alg == HKS_ALG_SM2)) {
         return UpdateCachedData(keyNode, inData);
-    } else if (algParam->uint32Param == HKS_ALG_AES) {
+    } else if (keyNode->session.alg == HKS_ALG_AES) {
         return CoreAesCipherUpdate(keyNode, inData, outData, alg);
-    } else if (algParam->uint32Param == HKS_ALG_DES) {
+    } else if (keyNode->session.alg == HKS_ALG_DES) {
         return CoreDesCipherUpdate(keyNode, inData, outData, alg);
-    } else if (algParam->uint32Param == HKS_ALG_3DES) {
+    } else if (keyNode->session.alg == HKS_ALG_3DES) {
         return Core3DesCipherUpdate(keyNode, inData, outData, alg);
-    } else if (algParam->uint32Param == HKS_ALG_SM4) {
+    } else if (keyNode->session.alg == HKS_ALG_SM4) {
         return CoreCipherUpdate(keyNode, inData, outData, alg);
     } else {
         return HKS_ERROR_INVALID_ALGORITHM;
     }
 }
 
-int32_t HksCoreEncryptThreeStageFinish(const struct HuksKeyNode *keyNode, const struct HksParamSet *paramSet,
+int32_t HksCoreEncryptThreeStageFinish(struct HuksKeyNode *keyNode, const struct HksParamSet *paramSet,
     const struct HksBlob *inData, struct HksBlob *outData, uint32_t alg)
 {
     (void)paramSet;
     HKS_IF_NOT_SUCC_LOGE_RETURN(CheckBlob(outData), HKS_ERROR_INVALID_ARGUMENT, "invalid outData")
 
-    struct HksParam *algParam = NULL;
-    int32_t ret = HksGetParam(keyNode->runtimeParamSet, HKS_TAG_ALGORITHM, &algParam);
-    HKS_IF_NOT_SUCC_LOGE_RETURN(ret, HKS_ERROR_CHECK_GET_ALG_FAIL,
-        "get param get 0x%" LOG_PUBLIC "x failed", HKS_TAG_ALGORITHM)
-
-    if (algParam->uint32Param == HKS_ALG_RSA) {
+    if (keyNode->session.alg == HKS_ALG_RSA) {
         return CoreRsaCipherFinish(keyNode, inData, outData);
-    } else if (algParam->uint32Param == HKS_ALG_SM2) {
+    } else if (keyNode->session.alg == HKS_ALG_SM2) {
         return CoreSm2CipherFinish(keyNode, inData, outData);
-    } else if (algParam->uint32Param == HKS_ALG_AES) {
+    } else if (keyNode->session.alg == HKS_ALG_AES) {
         return CoreAesCipherFinish(keyNode, true, inData, outData, alg);
-    } else if (algParam->uint32Param == HKS_ALG_DES) {
+    } else if (keyNode->session.alg == HKS_ALG_DES) {
         return CoreDesCipherFinish(keyNode, true, inData, outData, alg);
-    } else if (algParam->uint32Param == HKS_ALG_3DES) {
+    } else if (keyNode->session.alg == HKS_ALG_3DES) {
         return Core3DesCipherFinish(keyNode, true, inData, outData, alg);
-    } else if (algParam->uint32Param == HKS_ALG_SM4) {
+    } else if (keyNode->session.alg == HKS_ALG_SM4) {
         return CoreSm4EncryptFinish(keyNode, inData, outData, alg);
     } else {
         return HKS_ERROR_INVALID_ALGORITHM;
     }
 }
 
-int32_t HksCoreDecryptThreeStageFinish(const struct HuksKeyNode *keyNode, const struct HksParamSet *paramSet,
+int32_t HksCoreDecryptThreeStageFinish(struct HuksKeyNode *keyNode, const struct HksParamSet *paramSet,
     const struct HksBlob *inData, struct HksBlob *outData, uint32_t alg)
 {
     (void)paramSet;
     HKS_IF_NOT_SUCC_LOGE_RETURN(CheckBlob(outData), HKS_ERROR_INVALID_ARGUMENT, "invalid outData")
 
-    struct HksParam *algParam = NULL;
-    int32_t ret = HksGetParam(keyNode->runtimeParamSet, HKS_TAG_ALGORITHM, &algParam);
-    HKS_IF_NOT_SUCC_LOGE_RETURN(ret, HKS_ERROR_CHECK_GET_ALG_FAIL,
-        "get param get 0x%" LOG_PUBLIC "x failed", HKS_TAG_ALGORITHM)
-
-    if (algParam->uint32Param == HKS_ALG_RSA) {
+    if (keyNode->session.alg == HKS_ALG_RSA) {
         return CoreRsaCipherFinish(keyNode, inData, outData);
-    } else if (algParam->uint32Param == HKS_ALG_SM2) {
+    } else if (keyNode->session.alg == HKS_ALG_SM2) {
         return CoreSm2CipherFinish(keyNode, inData, outData);
-    } else if (algParam->uint32Param == HKS_ALG_AES) {
+    } else if (keyNode->session.alg == HKS_ALG_AES) {
         return CoreAesCipherFinish(keyNode, false, inData, outData, alg);
-    } else if (algParam->uint32Param == HKS_ALG_DES) {
+    } else if (keyNode->session.alg == HKS_ALG_DES) {
         return CoreDesCipherFinish(keyNode, false, inData, outData, alg);
-    } else if (algParam->uint32Param == HKS_ALG_3DES) {
+    } else if (keyNode->session.alg == HKS_ALG_3DES) {
         return Core3DesCipherFinish(keyNode, false, inData, outData, alg);
-    } else if (algParam->uint32Param == HKS_ALG_SM4) {
+    } else if (keyNode->session.alg == HKS_ALG_SM4) {
         return CoreSm4DecryptFinish(keyNode, inData, outData, alg);
     } else {
         return HKS_ERROR_INVALID_ALGORITHM;
     }
 }
 
-int32_t HksCoreCryptoThreeStageAbort(const struct HuksKeyNode *keyNode, const struct HksParamSet *paramSet,
+int32_t HksCoreCryptoThreeStageAbort(struct HuksKeyNode *keyNode, const struct HksParamSet *paramSet,
     uint32_t alg)
 {
     (void)paramSet;
@@ -1676,7 +1533,7 @@ int32_t HksCoreCryptoThreeStageAbort(const struct HuksKeyNode *keyNode, const st
     return HKS_SUCCESS;
 }
 
-int32_t HksCoreDeriveThreeStageInit(const struct HuksKeyNode *keyNode, const struct HksParamSet *paramSet,
+int32_t HksCoreDeriveThreeStageInit(struct HuksKeyNode *keyNode, const struct HksParamSet *paramSet,
     uint32_t alg)
 {
     (void)keyNode;
@@ -1687,18 +1544,15 @@ int32_t HksCoreDeriveThreeStageInit(const struct HuksKeyNode *keyNode, const str
     return HKS_SUCCESS;
 }
 
-int32_t HksCoreDeriveThreeStageUpdate(const struct HuksKeyNode *keyNode, const struct HksParamSet *paramSet,
+int32_t HksCoreDeriveThreeStageUpdate(struct HuksKeyNode *keyNode, const struct HksParamSet *paramSet,
     const struct HksBlob *srcData, struct HksBlob *derive, uint32_t alg)
 {
     (void)srcData;
     (void)alg;
     (void)derive;
     (void)paramSet;
-    struct HksParam *ctxParam = NULL;
-    int32_t ret = HksGetParam(keyNode->runtimeParamSet, HKS_TAG_CRYPTO_CTX, &ctxParam);
-    HKS_IF_NOT_SUCC_LOGE_RETURN(ret, HKS_ERROR_BAD_STATE, "get ctx from keyNode failed!")
-
     struct HksBlob rawKey = { 0, NULL };
+    int32_t ret;
     do {
         ret = GetRawkey(keyNode, &rawKey);
         HKS_IF_NOT_SUCC_BREAK(ret)
@@ -1719,7 +1573,7 @@ int32_t HksCoreDeriveThreeStageUpdate(const struct HuksKeyNode *keyNode, const s
             break;
         }
 
-        ctxParam->uint64Param = (uint64_t)(uintptr_t)deriveBlob;
+        keyNode->session.ctx = deriveBlob;
     } while (0);
 
     if (rawKey.data != NULL) {
@@ -1787,7 +1641,7 @@ static int32_t BuildAgreeDeriveKeyBlobOrGetOutData(const struct HksParamSet *par
     return ret;
 }
 
-int32_t HksCoreDeriveThreeStageFinish(const struct HuksKeyNode *keyNode, const struct HksParamSet *paramSet,
+int32_t HksCoreDeriveThreeStageFinish(struct HuksKeyNode *keyNode, const struct HksParamSet *paramSet,
     const struct HksBlob *inData, struct HksBlob *outData, uint32_t alg)
 {
     HKS_LOG_D("HksCoreDeriveThreeStageFinish start");
@@ -1796,7 +1650,7 @@ int32_t HksCoreDeriveThreeStageFinish(const struct HuksKeyNode *keyNode, const s
     int32_t ret = CheckBlob(outData);
     HKS_IF_NOT_SUCC_LOGE_RETURN(ret, HKS_ERROR_INVALID_ARGUMENT, "invalid outData")
 
-    void *ctx = GetCryptoCtx(keyNode);
+    void *ctx = keyNode->session.ctx;
     HKS_IF_NULL_LOGE_RETURN(ctx, HKS_ERROR_NULL_POINTER, "ctx is NULL!")
 
     struct HksBlob *restoreData = (struct HksBlob *)ctx;
@@ -1804,27 +1658,27 @@ int32_t HksCoreDeriveThreeStageFinish(const struct HuksKeyNode *keyNode, const s
     ret = BuildAgreeDeriveKeyBlobOrGetOutData(paramSet, restoreData, outData, HKS_KEY_FLAG_DERIVE_KEY, keyNode);
 
     FreeCachedData(&restoreData);
-    ClearCryptoCtx(keyNode);
+    keyNode->session.ctx = NULL;
     return ret;
 }
 
-int32_t HksCoreDeriveThreeStageAbort(const struct HuksKeyNode *keyNode, const struct HksParamSet *paramSet,
+int32_t HksCoreDeriveThreeStageAbort(struct HuksKeyNode *keyNode, const struct HksParamSet *paramSet,
     uint32_t alg)
 {
     (void)paramSet;
     (void)alg;
 
-    void *ctx = GetCryptoCtx(keyNode);
+    void *ctx = keyNode->session.ctx;
     HKS_IF_NULL_LOGE_RETURN(ctx, HKS_ERROR_NULL_POINTER, "ctx is NULL!")
 
     struct HksBlob *restoreData = (struct HksBlob *)ctx;
 
     FreeCachedData(&restoreData);
-    ClearCryptoCtx(keyNode);
+    keyNode->session.ctx = NULL;
     return HKS_SUCCESS;
 }
 
-int32_t HksCoreAgreeThreeStageInit(const struct HuksKeyNode *keyNode, const struct HksParamSet *paramSet,
+int32_t HksCoreAgreeThreeStageInit(struct HuksKeyNode *keyNode, const struct HksParamSet *paramSet,
     uint32_t alg)
 {
     (void)keyNode;
@@ -1837,25 +1691,21 @@ int32_t HksCoreAgreeThreeStageInit(const struct HuksKeyNode *keyNode, const stru
     return HKS_SUCCESS;
 }
 
-int32_t HksCoreAgreeThreeStageUpdate(const struct HuksKeyNode *keyNode, const struct HksParamSet *paramSet,
+int32_t HksCoreAgreeThreeStageUpdate(struct HuksKeyNode *keyNode, const struct HksParamSet *paramSet,
     const struct HksBlob *srcData, struct HksBlob *signature, uint32_t alg)
 {
     (void)signature;
     (void)paramSet;
     (void)alg;
 
-    struct HksParam *ctxParam = NULL;
-    int32_t ret = HksGetParam(keyNode->runtimeParamSet, HKS_TAG_CRYPTO_CTX, &ctxParam);
-    HKS_IF_NOT_SUCC_LOGE_RETURN(ret, HKS_ERROR_BAD_STATE, "get ctx from keyNode failed!")
-
-    if (ctxParam->uint64Param != 0) {
+    if (keyNode->session.ctx != NULL) {
         HKS_LOG_E("avoid running into this function multiple times!");
         return HKS_FAILURE;
     }
 
     struct HksBlob rawKey = { 0, NULL };
     struct HksBlob publicKey = { 0, NULL };
-
+    int32_t ret;
     do {
         ret = GetHksPubKeyInnerFormat(keyNode->runtimeParamSet, srcData, &publicKey);
         HKS_IF_NOT_SUCC_LOGE_BREAK(ret, "get public key from x509 format failed, ret = %" LOG_PUBLIC "d.", ret)
@@ -1881,7 +1731,7 @@ int32_t HksCoreAgreeThreeStageUpdate(const struct HuksKeyNode *keyNode, const st
             break;
         }
 
-        ctxParam->uint64Param = (uint64_t)(uintptr_t)agreeTemp;
+        keyNode->session.ctx = agreeTemp;
     } while (0);
 
     if (rawKey.data != NULL) {
@@ -1892,7 +1742,7 @@ int32_t HksCoreAgreeThreeStageUpdate(const struct HuksKeyNode *keyNode, const st
     return ret;
 }
 
-int32_t HksCoreAgreeThreeStageFinish(const struct HuksKeyNode *keyNode, const struct HksParamSet *paramSet,
+int32_t HksCoreAgreeThreeStageFinish(struct HuksKeyNode *keyNode, const struct HksParamSet *paramSet,
     const struct HksBlob *inData, struct HksBlob *outData, uint32_t alg)
 {
     (void)inData;
@@ -1900,7 +1750,7 @@ int32_t HksCoreAgreeThreeStageFinish(const struct HuksKeyNode *keyNode, const st
     int32_t ret = CheckBlob(outData);
     HKS_IF_NOT_SUCC_LOGE_RETURN(ret, HKS_ERROR_INVALID_ARGUMENT, "invalid outData")
 
-    void *ctx = GetCryptoCtx(keyNode);
+    void *ctx = keyNode->session.ctx;
     HKS_IF_NULL_LOGE_RETURN(ctx, HKS_ERROR_NULL_POINTER, "ctx is NULL!")
 
     struct HksBlob *restoreData = (struct HksBlob *)ctx;
@@ -1908,36 +1758,32 @@ int32_t HksCoreAgreeThreeStageFinish(const struct HuksKeyNode *keyNode, const st
     ret = BuildAgreeDeriveKeyBlobOrGetOutData(paramSet, restoreData, outData, HKS_KEY_FLAG_AGREE_KEY, keyNode);
 
     FreeCachedData(&restoreData);
-    ClearCryptoCtx(keyNode);
+    keyNode->session.ctx = NULL;
     return ret;
 }
 
-int32_t HksCoreAgreeThreeStageAbort(const struct HuksKeyNode *keyNode, const struct HksParamSet *paramSet, uint32_t alg)
+int32_t HksCoreAgreeThreeStageAbort(struct HuksKeyNode *keyNode, const struct HksParamSet *paramSet, uint32_t alg)
 {
     (void)paramSet;
     (void)alg;
 
-    void *ctx = GetCryptoCtx(keyNode);
+    void *ctx = keyNode->session.ctx;
     HKS_IF_NULL_LOGE_RETURN(ctx, HKS_ERROR_NULL_POINTER, "ctx is NULL!")
 
     struct HksBlob *restoreData = (struct HksBlob *)ctx;
 
     FreeCachedData(&restoreData);
-    ClearCryptoCtx(keyNode);
+    keyNode->session.ctx = NULL;
     return HKS_SUCCESS;
 }
 
-int32_t HksCoreMacThreeStageInit(const struct HuksKeyNode *keyNode, const struct HksParamSet *paramSet,
+int32_t HksCoreMacThreeStageInit(struct HuksKeyNode *keyNode, const struct HksParamSet *paramSet,
     uint32_t alg)
 {
     (void)paramSet;
     int32_t ret = HmacAuth(keyNode, keyNode->runtimeParamSet);
     HKS_IF_NOT_SUCC_LOGE_RETURN(ret, ret, "HksCoreMacThreeStageInit MacAuth fail ret : %" LOG_PUBLIC "d", ret)
 
-    struct HksParam *ctxParam = NULL;
-    ret = HksGetParam(keyNode->runtimeParamSet, HKS_TAG_CRYPTO_CTX, &ctxParam);
-    HKS_IF_NOT_SUCC_LOGE_RETURN(ret, HKS_ERROR_BAD_STATE, "get ctx from keyNode failed!")
-
     struct HksBlob rawKey = { 0, NULL };
     do {
         ret = HksGetRawKey(keyNode->keyBlobParamSet, &rawKey);
@@ -1956,7 +1802,7 @@ int32_t HksCoreMacThreeStageInit(const struct HuksKeyNode *keyNode, const struct
         }
         HKS_IF_NOT_SUCC_LOGE_BREAK(ret, "hmac init failed! ret : %" LOG_PUBLIC "d", ret)
 
-        ctxParam->uint64Param = (uint64_t)(uintptr_t)ctx;
+        keyNode->session.ctx = ctx;
     } while (0);
 
     if (rawKey.data != NULL) {
@@ -1967,21 +1813,18 @@ int32_t HksCoreMacThreeStageInit(const struct HuksKeyNode *keyNode, const struct
     return ret;
 }
 
-int32_t HksCoreMacThreeStageUpdate(const struct HuksKeyNode *keyNode, const struct HksParamSet *paramSet,
+int32_t HksCoreMacThreeStageUpdate(struct HuksKeyNode *keyNode, const struct HksParamSet *paramSet,
     const struct HksBlob *srcData, struct HksBlob *mac, uint32_t alg)
 {
     (void)paramSet;
     (void)mac;
     (void)alg;
-    int32_t ret;
+    int32_t ret = HKS_SUCCESS;
 
-    void *ctx = GetCryptoCtx(keyNode);
+    void *ctx = keyNode->session.ctx;
     HKS_IF_NULL_LOGE_RETURN(ctx, HKS_ERROR_NULL_POINTER, "ctx is NULL!")
 
-    struct HksParam *algParam = NULL;
-    ret = HksGetParam(paramSet, HKS_TAG_ALGORITHM, &algParam);
-    HKS_IF_NOT_SUCC_LOGE_RETURN(ret, ret, "append hmac get alg param failed!");
-    if (algParam->uint32Param == HKS_ALG_CMAC) {
+    if (keyNode->session.alg == HKS_ALG_CMAC) {
 #ifdef HKS_SUPPORT_CMAC_C
         ret = HksCryptoHalCmacUpdate(srcData, ctx);
 #endif
@@ -1994,23 +1837,22 @@ int32_t HksCoreMacThreeStageUpdate(const struct HuksKeyNode *keyNode, const stru
     return HKS_SUCCESS;
 }
 
-int32_t HksCoreMacThreeStageFinish(const struct HuksKeyNode *keyNode, const struct HksParamSet *paramSet,
+int32_t HksCoreMacThreeStageFinish(struct HuksKeyNode *keyNode, const struct HksParamSet *paramSet,
     const struct HksBlob *inData, struct HksBlob *outData, uint32_t alg)
 {
     (void)paramSet;
     (void)alg;
 
-    struct HksParam *algParam = NULL;
-    int32_t ret = HksGetParam(paramSet, HKS_TAG_ALGORITHM, &algParam);
-    HKS_IF_NOT_SUCC_LOGE_RETURN(ret, ret, "append hmac get alg param failed!")
-
-    if (algParam->uint32Param != HKS_ALG_CMAC) {
-        struct HksParam *digestParam = NULL;
-        ret = HksGetParam(keyNode->runtimeParamSet, HKS_TAG_DIGEST, &digestParam);
-        HKS_IF_NOT_SUCC_LOGE_RETURN(ret, HKS_ERROR_CHECK_GET_DIGEST_FAIL, "get ctx from keyNode failed!")
+    int32_t ret = HKS_SUCCESS;
+    bool isCmac = (keyNode->session.alg == HKS_ALG_CMAC);
+    if (!isCmac) {
+        if (!keyNode->session.hasDigest) {
+            HKS_LOG_E("get digest from keyNode failed!");
+            return HKS_ERROR_CHECK_GET_DIGEST_FAIL;
+        }
 
         uint32_t macLen;
-        ret = HksGetDigestLen(digestParam->uint32Param, &macLen);
+        ret = HksGetDigestLen(keyNode->session.digest, &macLen);
         HKS_IF_NOT_SUCC_LOGE_RETURN(ret, ret, "get digest len failed")
 
         if ((CheckBlob(outData) != HKS_SUCCESS) || (outData->size < macLen)) {
@@ -2019,14 +1861,10 @@ int32_t HksCoreMacThreeStageFinish(const struct HuksKeyNode *keyNode, const stru
         }
     }
 
-    struct HksParam *ctxParam = NULL;
-    ret = HksGetParam(keyNode->runtimeParamSet, HKS_TAG_CRYPTO_CTX, &ctxParam);
-    HKS_IF_NOT_SUCC_LOGE_RETURN(ret, HKS_ERROR_BAD_STATE, "get ctx from keyNode failed!")
-
-    void *ctx = (void *)(uintptr_t)ctxParam->uint64Param;
+    void *ctx = keyNode->session.ctx;
     HKS_IF_NULL_LOGE_RETURN(ctx, HKS_ERROR_NULL_POINTER, "ctx invalid")
 
-    if (algParam->uint32Param == HKS_ALG_CMAC) {
+    if (isCmac) {
 #ifdef HKS_SUPPORT_CMAC_C
         ret = HksCryptoHalCmacFinal(inData, &ctx, outData);
 #endif
@@ -2036,29 +1874,26 @@ int32_t HksCoreMacThreeStageFinish(const struct HuksKeyNode *keyNode, const stru
 
     HKS_IF_NOT_SUCC_LOGE(ret, "hmac final failed! ret : %" LOG_PUBLIC "d", ret)
 
-    ctxParam->uint64Param = 0; /* clear ctx to NULL */
+    keyNode->session.ctx = NULL;
     return ret;
 }
 
-int32_t HksCoreMacThreeStageAbort(const struct HuksKeyNode *keyNode, const struct HksParamSet *paramSet, uint32_t alg)
+int32_t HksCoreMacThreeStageAbort(struct HuksKeyNode *keyNode, const struct HksParamSet *paramSet, uint32_t alg)
 {
     (void)alg;
     (void)paramSet;
 
-    void *ctx = GetCryptoCtx(keyNode);
+    void *ctx = keyNode->session.ctx;
     HKS_IF_NULL_LOGE_RETURN(ctx, HKS_ERROR_NULL_POINTER, "ctx invalid")
-    
-    struct HksParam *algParam = NULL;
-    int32_t ret = HksGetParam(paramSet, HKS_TAG_ALGORITHM, &algParam);
-    HKS_IF_NOT_SUCC_LOGE_RETURN(ret, ret, "append hmac get alg param failed!")
-    if (algParam->uint32Param == HKS_ALG_CMAC) {
+
+    if (keyNode->session.alg == HKS_ALG_CMAC) {
 #ifdef HKS_SUPPORT_CMAC_C
         HksCryptoHalCmacFreeCtx(&ctx);
 #endif
     } else {
         HksCryptoHalHmacFreeCtx(&ctx);
     }
-    ClearCryptoCtx(keyNode);
+    keyNode->session.ctx = NULL;
 
     return HKS_SUCCESS;
 }
@@ -30,7 +30,6 @@
 #include "hks_type_inner.h"
 
 #define S_TO_MS 1000
-#define MAX_RETRY_CHECK_UNIQUE_HANDLE_TIME 10
 #define INVALID_TOKEN_ID 0U
 #define MAX_KEY_NODES_COUNT 32
 
@@ -40,6 +39,29 @@
 #define MAX_KEY_NODES_EACH_TOKEN_ID MAX_KEY_NODES_COUNT
 #endif
 
+/*
+ * A handle fits 32 bits, as the js api keeps it in a uint32: from the low bits, the index of its slot, the generation
+ * of the slot and a random tag. Each key node of a slot takes the next generation, so a handle of the last 1023 key
+ * nodes of a slot never finds the current one. Only the tag keeps a handle from being guessed, with 14 random bits
+ * where the handles before the slots had 32.
+ */
+#define KEY_NODE_SLOT_BITS 8
+#define KEY_NODE_SLOT_MASK ((1U << KEY_NODE_SLOT_BITS) - 1)
+#define KEY_NODE_GENERATION_BITS 10
+#define KEY_NODE_GENERATION_MASK ((1U << KEY_NODE_GENERATION_BITS) - 1)
+#define KEY_NODE_TAG_SHIFT (KEY_NODE_SLOT_BITS + KEY_NODE_GENERATION_BITS)
+#define KEY_NODE_TAG_MASK ((1U << (32 - KEY_NODE_TAG_SHIFT)) - 1)
+
+struct HuksKeyNodeSlot {
+    struct HuksKeyNode keyNode;
+    uint32_t generation;
+    bool isUsed;
+};
+
+/* the key nodes live in a fixed table of slots, the list keeps them from the oldest to the newest for eviction */
+static struct HuksKeyNodeSlot g_keyNodeSlots[MAX_KEY_NODES_COUNT];
+static uint8_t g_freeSlotIndexes[MAX_KEY_NODES_COUNT];
+static bool g_isKeyNodeSlotsInited = false;
 static struct DoubleList g_keyNodeList = { &g_keyNodeList, &g_keyNodeList };
 static uint32_t g_keyNodeCount = 0;
 static HksMutex *g_huksMutex = NULL;  /* global mutex using in keynode */
@@ -92,29 +114,6 @@ static void FreeKeyBlobParamSet(struct HksParamSet **paramSet)
     HksFreeParamSet(paramSet);
 }
 
-static int32_t SetAesCcmModeTag(struct HksParamSet *paramSet, const uint32_t alg, const uint32_t pur, bool *tag)
-{
-    if (alg != HKS_ALG_AES) {
-        *tag = false;
-        return HKS_SUCCESS;
-    }
-
-    if (pur != HKS_KEY_PURPOSE_ENCRYPT && pur != HKS_KEY_PURPOSE_DECRYPT) {
-        *tag = false;
-        return HKS_SUCCESS;
-    }
-
-    struct HksParam *modParam = NULL;
-    int32_t ret = HksGetParam(paramSet, HKS_TAG_BLOCK_MODE, &modParam);
-    if (ret != HKS_SUCCESS) {
-        HKS_LOG_E("aes get block mode tag fail");
-        return HKS_ERROR_UNKNOWN_ERROR;
-    }
-
-    *tag = (modParam->uint32Param == HKS_MODE_CCM);
-    return HKS_SUCCESS;
-}
-
 static void FreeCachedData(void **ctx)
 {
     struct HksBlob *cachedData = (struct HksBlob *)*ctx;
@@ -159,72 +158,56 @@ static void KeyNodeFreeCtx(uint32_t purpose, uint32_t alg, bool hasCalcHash, voi
     }
 }
 
-static void FreeRuntimeParamSet(struct HksParamSet **paramSet)
+static void FreeSessionCtx(struct HksKeyNodeSession *session)
 {
-    if ((paramSet == NULL) || (*paramSet == NULL)) {
-        HKS_LOG_E("invalid keyblob paramset");
-        return;
-    }
-
-    struct HksParam *ctxParam = NULL;
-    int32_t ret = HksGetParam(*paramSet, HKS_TAG_CRYPTO_CTX, &ctxParam);
-    if (ret != HKS_SUCCESS) {
-        HksFreeParamSet(paramSet);
-        HKS_LOG_E("get ctx from keyNode failed!");
+    if (session->ctx == NULL) {
         return;
     }
 
-    if (ctxParam->uint64Param != 0) {
-        void *ctx = (void *)(uintptr_t)ctxParam->uint64Param;
-        struct HksParam *param1 = NULL;
-        struct HksParam *param2 = NULL;
-        if (HksGetParam(*paramSet, HKS_TAG_PURPOSE, &param1) != HKS_SUCCESS ||
-            HksGetParam(*paramSet, HKS_TAG_ALGORITHM, &param2) != HKS_SUCCESS) {
-            HksFreeParamSet(paramSet);
-            return;
-        }
-        struct HksParam *param3 = NULL;
-        ret = HksGetParam(*paramSet, HKS_TAG_DIGEST, &param3);
-        if (ret == HKS_ERROR_INVALID_ARGUMENT) {
-            HksFreeParamSet(paramSet);
-            return;
-        }
-        bool hasCalcHash = true;
-        /* If the algorithm is ed25519, the plaintext is directly cached, and if the digest is HKS_DIGEST_NONE, the
-           hash value has been passed in by the user. So the hash value does not need to be free.
-        */
-        if (ret == HKS_SUCCESS) {
-            hasCalcHash = param3->uint32Param != HKS_DIGEST_NONE;
-        }
-        hasCalcHash &= (param2->uint32Param != HKS_ALG_ED25519);
-
-        bool isAesCcm = false;
-        ret = SetAesCcmModeTag(*paramSet, param2->uint32Param, param1->uint32Param, &isAesCcm);
-        if (ret != HKS_SUCCESS) {
-            HksFreeParamSet(paramSet);
-            return;
-        }
+    /* If the algorithm is ed25519, the plaintext is directly cached, and if the digest is HKS_DIGEST_NONE, the
+       hash value has been passed in by the user. So the hash value does not need to be free.
+    */
+    bool hasCalcHash = !(session->hasDigest && session->digest == HKS_DIGEST_NONE) &&
+        (session->alg != HKS_ALG_ED25519);
+    bool isAesCcm = (session->alg == HKS_ALG_AES) && session->hasMode && (session->mode == HKS_MODE_CCM) &&
+        ((session->purpose == HKS_KEY_PURPOSE_ENCRYPT) || (session->purpose == HKS_KEY_PURPOSE_DECRYPT));
+    if (isAesCcm) {
+        HKS_LOG_D("FreeSessionCtx free ccm cache data!");
+        FreeCachedData(&session->ctx);
+    } else {
+        KeyNodeFreeCtx(session->purpose, session->alg, hasCalcHash, &session->ctx);
+    }
+    session->ctx = NULL;
+}
 
-        if (isAesCcm) {
-            HKS_LOG_D("FreeRuntimeParamSet fee ccm cache data!");
-            FreeCachedData(&ctx);
-        } else {
-            KeyNodeFreeCtx(param1->uint32Param, param2->uint32Param, hasCalcHash, &ctx);
-        }
+static void FreeSessionUsageSpec(struct HksKeyNodeUsageSpec *spec)
+{
+    HKS_FREE(spec->specData);
+    spec->isBuilt = false;
+}
 
-        ctxParam->uint64Param = 0; /* clear ctx to NULL */
+static void FreeRuntimeParamSet(struct HksParamSet **paramSet)
+{
+    if ((paramSet == NULL) || (*paramSet == NULL)) {
+        HKS_LOG_E("invalid runtime paramset");
+        return;
     }
     HksFreeParamSet(paramSet);
 }
 
 static void DeleteKeyNodeFree(struct HuksKeyNode *keyNode)
 {
+    uint32_t index = (uint32_t)(keyNode->handle & KEY_NODE_SLOT_MASK);
     RemoveDoubleListNode(&keyNode->listHead);
+    FreeSessionCtx(&keyNode->session);
+    FreeSessionUsageSpec(&keyNode->session.spec);
     FreeKeyBlobParamSet(&keyNode->keyBlobParamSet);
     FreeRuntimeParamSet(&keyNode->runtimeParamSet);
     FreeRuntimeParamSet(&keyNode->authRuntimeParamSet);
-    HKS_FREE(keyNode);
+    (void)memset_s(keyNode, sizeof(struct HuksKeyNode), 0, sizeof(struct HuksKeyNode));
+    g_keyNodeSlots[index].isUsed = false;
     --g_keyNodeCount;
+    g_freeSlotIndexes[g_keyNodeCount] = (uint8_t)index;
     HKS_LOG_I("delete keynode count:%" LOG_PUBLIC "u", g_keyNodeCount);
 }
 
@@ -234,21 +217,7 @@ static int32_t BuildRuntimeParamSet(const struct HksParamSet *inParamSet, struct
     int32_t ret = HksInitParamSet(&paramSet);
     HKS_IF_NOT_SUCC_LOGE_RETURN(ret, ret, "init keyNode param set fail")
 
-    struct HksParam params[] = {
-        {
-            .tag = HKS_TAG_CRYPTO_CTX,
-            .uint64Param = 0
-        },
-    };
-
     if (inParamSet != NULL) {
-        ret = HksCheckIsTagAlreadyExist(params, HKS_ARRAY_SIZE(params), inParamSet);
-        if (ret != HKS_SUCCESS) {
-            HksFreeParamSet(&paramSet);
-            HKS_LOG_E("check params fail");
-            return ret;
-        }
-
         ret = HksAddParams(paramSet, inParamSet->params, inParamSet->paramsCnt);
         if (ret != HKS_SUCCESS) {
             HksFreeParamSet(&paramSet);
@@ -257,13 +226,6 @@ static int32_t BuildRuntimeParamSet(const struct HksParamSet *inParamSet, struct
         }
     }
 
-    ret = HksAddParams(paramSet, params, sizeof(params) / sizeof(params[0]));
-    if (ret != HKS_SUCCESS) {
-        HksFreeParamSet(&paramSet);
-        HKS_LOG_E("add runtime params fail");
-        return ret;
-    }
-
     ret = HksBuildParamSet(&paramSet);
     if (ret != HKS_SUCCESS) {
         HksFreeParamSet(&paramSet);
@@ -275,40 +237,92 @@ static int32_t BuildRuntimeParamSet(const struct HksParamSet *inParamSet, struct
     return HKS_SUCCESS;
 }
 
-static int32_t HksCheckUniqueHandle(uint64_t handle)
+static void InitKeyNodeSession(const struct HksParamSet *paramSet, const struct HksParamSet *keyBlobParamSet,
+    struct HksKeyNodeSession *session)
 {
-    struct HuksKeyNode *keyNode = NULL;
-    HKS_DLIST_ITER(keyNode, &g_keyNodeList) {
-        if ((keyNode != NULL) && (keyNode->handle == handle)) {
-            HKS_LOG_E("The handle already exists!");
-            return HKS_FAILURE;
+    struct HksParam *keySize = NULL;
+    if (HksGetParam(keyBlobParamSet, HKS_TAG_KEY_SIZE, &keySize) == HKS_SUCCESS) {
+        session->keySize = keySize->uint32Param;
+        session->hasKeySize = true;
+    }
+    for (uint32_t i = 0; i < paramSet->paramsCnt; ++i) {
+        const struct HksParam *param = &paramSet->params[i];
+        switch (param->tag) {
+            case HKS_TAG_PURPOSE:
+                session->purpose = param->uint32Param;
+                break;
+            case HKS_TAG_ALGORITHM:
+                session->alg = param->uint32Param;
+                break;
+            case HKS_TAG_BLOCK_MODE:
+                session->mode = param->uint32Param;
+                session->hasMode = true;
+                break;
+            case HKS_TAG_PADDING:
+                session->padding = param->uint32Param;
+                session->hasPadding = true;
+                break;
+            case HKS_TAG_DIGEST:
+                session->digest = param->uint32Param;
+                session->hasDigest = true;
+                break;
+            default:
+                break;
         }
     }
-    return HKS_SUCCESS;
 }
 
-static int32_t GenerateKeyNodeHandle(uint64_t *handle)
+static int32_t GenerateKeyNodeTag(uint32_t *tag)
 {
-    uint32_t handleData = 0;
-    struct HksBlob opHandle = {
+    struct HksBlob tagBlob = {
         .size = sizeof(uint32_t),
-        .data = (uint8_t *)&handleData
+        .data = (uint8_t *)tag
     };
+    int32_t ret = HksCryptoHalFillRandom(&tagBlob);
+    HKS_IF_NOT_SUCC_LOGE_RETURN(ret, ret, "fill keyNode tag failed")
+    return HKS_SUCCESS;
+}
 
-    int32_t ret = HKS_FAILURE;
-    for (uint32_t i = 0; i < MAX_RETRY_CHECK_UNIQUE_HANDLE_TIME; i++) {
-        ret = HksCryptoHalFillRandom(&opHandle);
-        if (ret != HKS_SUCCESS) {
-            HKS_LOG_E("fill keyNode handle failed");
-            return ret;
-        }
-        ret = HksCheckUniqueHandle(handleData);
-        if (ret == HKS_SUCCESS) {
-            *handle = handleData; /* Temporarily only use 32 bit handle */
-            return ret;
-        }
+/* the indexes of the free slots are g_freeSlotIndexes[g_keyNodeCount, MAX_KEY_NODES_COUNT) */
+static void InitKeyNodeSlots(void)
+{
+    if (g_isKeyNodeSlotsInited) {
+        return;
+    }
+    for (uint32_t i = 0; i < MAX_KEY_NODES_COUNT; ++i) {
+        g_freeSlotIndexes[i] = (uint8_t)i;
+    }
+    g_isKeyNodeSlotsInited = true;
+}
+
+/* a handle of a former key node of the slot fails on its generation, a forged one on its tag */
+static struct HuksKeyNode *FindKeyNode(uint64_t handle)
+{
+    uint32_t index = (uint32_t)(handle & KEY_NODE_SLOT_MASK);
+    if (index >= MAX_KEY_NODES_COUNT) {
+        return NULL;
     }
-    return ret;
+    struct HuksKeyNodeSlot *slot = &g_keyNodeSlots[index];
+    if (!slot->isUsed || slot->keyNode.handle != handle) {
+        return NULL;
+    }
+    return &slot->keyNode;
+}
+
+static struct HuksKeyNode *TakeKeyNodeSlot(const struct HuksKeyNode *keyNode, uint32_t tag)
+{
+    uint32_t index = g_freeSlotIndexes[g_keyNodeCount];
+    struct HuksKeyNodeSlot *slot = &g_keyNodeSlots[index];
+    /* generation 0 is skipped, so that no handle is the invalid one */
+    slot->generation = (slot->generation + 1) & KEY_NODE_GENERATION_MASK;
+    if (slot->generation == 0) {
+        slot->generation = 1;
+    }
+    slot->keyNode = *keyNode;
+    slot->keyNode.handle = ((tag & KEY_NODE_TAG_MASK) << KEY_NODE_TAG_SHIFT) |
+        (slot->generation << KEY_NODE_SLOT_BITS) | index;
+    slot->isUsed = true;
+    return &slot->keyNode;
 }
 
 static void DeleteFirstTimeOutBatchKeyNode(void)
@@ -397,11 +411,15 @@ static bool DeleteFirstKeyNode(void)
     return false;
 }
 
-static int32_t AddKeyNode(struct HuksKeyNode *keyNode, uint32_t tokenId)
+/* keyNode is copied into a free slot, the key node of the slot is returned */
+static struct HuksKeyNode *AddKeyNode(const struct HuksKeyNode *keyNode, uint32_t tag)
 {
     int32_t ret = HKS_SUCCESS;
+    uint32_t tokenId = GetTokenIdFromParamSet(keyNode->runtimeParamSet);
+    struct HuksKeyNode *newKeyNode = NULL;
     HksMutexLock(HksGetHuksMutex());
     do {
+        InitKeyNodeSlots();
         DeleteFirstTimeOutBatchKeyNode();
 
         ret = DeleteKeyNodeForTokenIdIfExceedLimit(tokenId);
@@ -416,13 +434,14 @@ static int32_t AddKeyNode(struct HuksKeyNode *keyNode, uint32_t tokenId)
             }
         }
 
-        AddNodeAtDoubleListTail(&g_keyNodeList, &keyNode->listHead);
+        newKeyNode = TakeKeyNodeSlot(keyNode, tag);
+        AddNodeAtDoubleListTail(&g_keyNodeList, &newKeyNode->listHead);
         ++g_keyNodeCount;
         HKS_LOG_I("add keynode count:%" LOG_PUBLIC "u", g_keyNodeCount);
     } while (0);
 
     HksMutexUnlock(HksGetHuksMutex());
-    return ret;
+    return newKeyNode;
 }
 
 
@@ -445,36 +464,27 @@ struct HuksKeyNode *HksCreateBatchKeyNode(const struct HuksKeyNode *keyNode, con
     updateKeyNode->keyBlobParamSet = keyNode->keyBlobParamSet;
     updateKeyNode->runtimeParamSet = runtimeParamSet;
     updateKeyNode->authRuntimeParamSet = keyNode->authRuntimeParamSet;
+    InitKeyNodeSession(runtimeParamSet, updateKeyNode->keyBlobParamSet, &updateKeyNode->session);
+    updateKeyNode->session.isUserAuthAccess = keyNode->session.isUserAuthAccess;
     return updateKeyNode;
 }
 
 #ifdef _STORAGE_LITE_
 struct HuksKeyNode *HksCreateKeyNode(const struct HksBlob *key, const struct HksParamSet *paramSet)
 {
-    struct HuksKeyNode *keyNode = (struct HuksKeyNode *)HksMalloc(sizeof(struct HuksKeyNode));
-    HKS_IF_NULL_LOGE_RETURN(keyNode, NULL, "malloc hks keyNode failed")
-
-    int32_t ret = GenerateKeyNodeHandle(&keyNode->handle);
-    if (ret != HKS_SUCCESS) {
-        HKS_FREE(keyNode);
-        HKS_LOG_E("get keynode handle failed");
-        return NULL;
-    }
+    uint32_t tag = 0;
+    int32_t ret = GenerateKeyNodeTag(&tag);
+    HKS_IF_NOT_SUCC_LOGE_RETURN(ret, NULL, "get keynode handle failed")
 
     struct HksParamSet *runtimeParamSet = NULL;
     ret = BuildRuntimeParamSet(paramSet, &runtimeParamSet);
-    if (ret != HKS_SUCCESS) {
-        HKS_FREE(keyNode);
-        HKS_LOG_E("get runtime paramSet failed");
-        return NULL;
-    }
+    HKS_IF_NOT_SUCC_LOGE_RETURN(ret, NULL, "get runtime paramSet failed")
 
     struct HksBlob rawKey = { 0, NULL };
     ret = HksGetRawKeyMaterial(key, &rawKey);
     if (ret != HKS_SUCCESS) {
         HKS_LOG_E("get raw key material failed, ret = %" LOG_PUBLIC "d", ret);
         HksFreeParamSet(&runtimeParamSet);
-        HKS_FREE(keyNode);
         return NULL;
     }
 
@@ -485,25 +495,26 @@ struct HuksKeyNode *HksCreateKeyNode(const struct HksBlob *key, const struct Hks
     if (ret != HKS_SUCCESS) {
         HKS_LOG_E("translate key info to paramset failed, ret = %" LOG_PUBLIC "d", ret);
         HksFreeParamSet(&runtimeParamSet);
-        HKS_FREE(keyNode);
         return NULL;
     }
 
-    ret = AddKeyNode(keyNode, GetTokenIdFromParamSet(runtimeParamSet));
-    if (ret != HKS_SUCCESS) {
+    struct HuksKeyNode keyNode;
+    (void)memset_s(&keyNode, sizeof(keyNode), 0, sizeof(keyNode));
+    keyNode.keyBlobParamSet = keyBlobParamSet;
+    keyNode.runtimeParamSet = runtimeParamSet;
+    InitKeyNodeSession(runtimeParamSet, keyBlobParamSet, &keyNode.session);
+    struct HuksKeyNode *newKeyNode = AddKeyNode(&keyNode, tag);
+    if (newKeyNode == NULL) {
         HKS_LOG_E("add keyNode failed");
+        FreeKeyBlobParamSet(&keyBlobParamSet);
         HksFreeParamSet(&runtimeParamSet);
-        HKS_FREE(keyNode);
         return NULL;
     }
-
-    keyNode->keyBlobParamSet = keyBlobParamSet;
-    keyNode->runtimeParamSet = runtimeParamSet;
-    return keyNode;
+    return newKeyNode;
 }
 #else // _STORAGE_LITE_
 static void FreeParamsForBuildKeyNode(struct HksBlob *aad, struct HksParamSet **runtimeParamSet,
-    struct HksParamSet **keyblobParamSet, struct HuksKeyNode *keyNode)
+    struct HksParamSet **keyblobParamSet)
 {
     if (aad != NULL && aad->data != NULL) {
         HKS_FREE_BLOB(*aad);
@@ -516,23 +527,18 @@ static void FreeParamsForBuildKeyNode(struct HksBlob *aad, struct HksParamSet **
     if (keyblobParamSet != NULL && *keyblobParamSet != NULL) {
         FreeKeyBlobParamSet(keyblobParamSet);
     }
-
-    if (keyNode != NULL) {
-        HKS_FREE(keyNode);
-    }
 }
 
 struct HuksKeyNode *HksCreateKeyNode(const struct HksBlob *key, const struct HksParamSet *paramSet)
 {
-    struct HuksKeyNode *keyNode = (struct HuksKeyNode *)HksMalloc(sizeof(struct HuksKeyNode));
-    HKS_IF_NULL_LOGE_RETURN(keyNode, NULL, "malloc hks keyNode failed")
-
     int32_t ret;
+    uint32_t tag = 0;
     struct HksBlob aad = { 0, NULL };
     struct HksParamSet *runtimeParamSet = NULL;
     struct HksParamSet *keyBlobParamSet = NULL;
+    struct HuksKeyNode *newKeyNode = NULL;
     do {
-        ret = GenerateKeyNodeHandle(&keyNode->handle);
+        ret = GenerateKeyNodeTag(&tag);
         HKS_IF_NOT_SUCC_LOGE_BREAK(ret, "get keynode handle failed")
 
         ret = BuildRuntimeParamSet(paramSet, &runtimeParamSet);
@@ -544,48 +550,42 @@ struct HuksKeyNode *HksCreateKeyNode(const struct HksBlob *key, const struct Hks
         ret = HksDecryptKeyBlob(&aad, keyBlobParamSet);
         HKS_IF_NOT_SUCC_LOGE_BREAK(ret, "decrypt keyBlob failed")
 
-        ret = AddKeyNode(keyNode, GetTokenIdFromParamSet(runtimeParamSet));
-        HKS_IF_NOT_SUCC_LOGE_BREAK(ret, "add keyNode failed")
+        struct HuksKeyNode keyNode;
+        (void)memset_s(&keyNode, sizeof(keyNode), 0, sizeof(keyNode));
+        keyNode.keyBlobParamSet = keyBlobParamSet;
+        keyNode.runtimeParamSet = runtimeParamSet;
+        InitKeyNodeSession(runtimeParamSet, keyBlobParamSet, &keyNode.session);
+        newKeyNode = AddKeyNode(&keyNode, tag);
+        if (newKeyNode == NULL) {
+            HKS_LOG_E("add keyNode failed");
+            ret = HKS_ERROR_SESSION_REACHED_LIMIT;
+        }
     } while (0);
 
     if (ret != HKS_SUCCESS) {
-        FreeParamsForBuildKeyNode(&aad, &runtimeParamSet, &keyBlobParamSet, keyNode);
+        FreeParamsForBuildKeyNode(&aad, &runtimeParamSet, &keyBlobParamSet);
         return NULL;
     }
 
-    keyNode->keyBlobParamSet = keyBlobParamSet;
-    keyNode->runtimeParamSet = runtimeParamSet;
-    keyNode->authRuntimeParamSet = NULL;
-
     HKS_FREE_BLOB(aad);
-    return keyNode;
+    return newKeyNode;
 }
 #endif // _STORAGE_LITE_
 
 struct HuksKeyNode *HksQueryKeyNode(uint64_t handle)
 {
-    struct HuksKeyNode *keyNode = NULL;
     HksMutexLock(HksGetHuksMutex());
-    HKS_DLIST_ITER(keyNode, &g_keyNodeList) {
-        if (keyNode != NULL && keyNode->handle == handle) {
-            HksMutexUnlock(HksGetHuksMutex());
-            return keyNode;
-        }
-    }
+    struct HuksKeyNode *keyNode = FindKeyNode(handle);
     HksMutexUnlock(HksGetHuksMutex());
-    return NULL;
+    return keyNode;
 }
 
 void HksDeleteKeyNode(uint64_t handle)
 {
-    struct HuksKeyNode *keyNode = NULL;
     HksMutexLock(HksGetHuksMutex());
-    HKS_DLIST_ITER(keyNode, &g_keyNodeList) {
-        if (keyNode != NULL && keyNode->handle == handle) {
-            DeleteKeyNodeFree(keyNode);
-            HksMutexUnlock(HksGetHuksMutex());
-            return;
-        }
+    struct HuksKeyNode *keyNode = FindKeyNode(handle);
+    if (keyNode != NULL) {
+        DeleteKeyNodeFree(keyNode);
     }
     HksMutexUnlock(HksGetHuksMutex());
 }
@@ -596,6 +596,8 @@ void HksFreeUpdateKeyNode(struct HuksKeyNode *keyNode)
     if (keyNode == NULL) {
         return;
     }
+    FreeSessionCtx(&keyNode->session);
+    FreeSessionUsageSpec(&keyNode->session.spec);
     FreeRuntimeParamSet(&keyNode->runtimeParamSet);
     HKS_FREE(keyNode);
 }
@@ -22,6 +22,7 @@
 #include "hks_secure_access.h"
 
 #include "hks_base_check.h"
+#include "hks_common_check.h"
 #include "hks_keyblob.h"
 #include "hks_keynode.h"
 #include "hks_log.h"
@@ -47,6 +48,13 @@
 #define DEFAULT_TIME_OUT 3
 #define AUTH_INFO_LEN (sizeof(uint32_t) + sizeof(uint64_t) + sizeof(uint64_t))
 
+#ifndef HKS_AUTH_TOKEN_CACHE_SIZE
+#define HKS_AUTH_TOKEN_CACHE_SIZE 8
+#endif
+
+/* no auth token can pass the timestamp check once it is older than the longest allowed auth timeout */
+#define HKS_AUTH_TOKEN_CACHE_TTL_MS ((uint64_t)MAX_AUTH_TIMEOUT_SECOND * S_TO_MS)
+
 struct HksSecureAccessInnerParams {
     const struct HksParamSet *initParamSet;
     uint32_t challengePos;
@@ -61,6 +69,23 @@ struct HksAppendDataInnerParams {
     const struct HksBlob *inData;
 };
 
+/* auth token whose sign has been verified and whose ciphertext has been decrypted */
+struct HksAuthTokenCacheEntry {
+    bool isValid;
+    uint8_t digest[HKS_DIGEST_SHA256_LEN];
+    uint64_t verifiedTime;
+    struct HksUserAuthToken authToken;
+};
+
+struct HksAuthTokenCache {
+    bool hasOwner;
+    int32_t userId;
+    uint32_t authType;
+    struct HksAuthTokenCacheEntry entries[HKS_AUTH_TOKEN_CACHE_SIZE];
+};
+
+static struct HksAuthTokenCache g_authTokenCache = { 0 };
+
 static int32_t CheckChallengeTypeValidity(const struct HksParam *blobChallengeType,
     struct HksSecureAccessInnerParams *innerParams)
 {
@@ -355,15 +380,205 @@ static int32_t ParseAuthToken(const struct HksBlob *inAuthTokenParam, struct Hks
     return ret;
 }
 
-static int32_t GetAuthToken(const struct HksParamSet *paramSet, struct HksUserAuthToken **authToken)
+static int32_t GetAuthMode(const struct HksParamSet *paramSet, uint32_t *type)
+{
+    struct HksParam *typeParam = NULL;
+    if (HksGetParam(paramSet, HKS_TAG_USER_AUTH_MODE, &typeParam) == HKS_SUCCESS &&
+        typeParam->uint32Param == HKS_USER_AUTH_MODE_COAUTH) {
+        *type = HKS_USER_AUTH_MODE_COAUTH;
+        return HKS_SUCCESS;
+    }
+
+    *type = HKS_USER_AUTH_MODE_LOCAL;
+    return HKS_SUCCESS;
+}
+
+static int32_t HksCheckAuthType(const struct HuksKeyNode *keyNode, const struct HksUserAuthToken *authToken)
+{
+    uint32_t blobAuthMode;
+    int32_t ret = GetAuthMode(keyNode->keyBlobParamSet, &blobAuthMode);
+    HKS_IF_NOT_SUCC_LOGE_RETURN(ret, ret, "get auth mode failed")
+    
+    enum {
+        // see `enum TokenType` in `drivers/peripheral/user_auth/hdi_service/common/inc/defines.h`
+        TOKEN_TYPE_LOCAL_AUTH = 0,
+        TOKEN_TYPE_LOCAL_RESIGN = 1,
+        TOKEN_TYPE_COAUTH = 2,
+    };
+    switch (authToken->plaintextData.tokenType) {
+        case TOKEN_TYPE_LOCAL_AUTH:
+        case TOKEN_TYPE_LOCAL_RESIGN:
+            break;
+        case TOKEN_TYPE_COAUTH:
+            if (blobAuthMode != HKS_USER_AUTH_MODE_COAUTH) {
+                HKS_LOG_E("not COAUTH_MODE_AUTH %" LOG_PUBLIC "u", blobAuthMode);
+                return HKS_ERROR_NOT_SUPPORTED;
+            }
+            break;
+        default:
+            HKS_LOG_E("invalid authMode %" LOG_PUBLIC "u", blobAuthMode);
+            return HKS_ERROR_NOT_SUPPORTED;
+    }
+    return HKS_SUCCESS;
+}
+
+static void ClearAuthTokenCacheLocked(void)
+{
+    (void)memset_s(&g_authTokenCache, sizeof(g_authTokenCache), 0, sizeof(g_authTokenCache));
+}
+
+static bool IsAuthTokenCacheEntryExpired(const struct HksAuthTokenCacheEntry *entry, uint64_t curTime)
+{
+    return (curTime < entry->verifiedTime) || (curTime - entry->verifiedTime > HKS_AUTH_TOKEN_CACHE_TTL_MS);
+}
+
+static bool LookupAuthTokenCache(const uint8_t *digest, uint64_t curTime, struct HksUserAuthToken *outAuthToken)
+{
+    bool isFound = false;
+    HksMutexLock(HksGetHuksMutex());
+    for (uint32_t i = 0; i < HKS_AUTH_TOKEN_CACHE_SIZE; ++i) {
+        struct HksAuthTokenCacheEntry *entry = &g_authTokenCache.entries[i];
+        if (!entry->isValid) {
+            continue;
+        }
+        if (IsAuthTokenCacheEntryExpired(entry, curTime)) {
+            (void)memset_s(entry, sizeof(struct HksAuthTokenCacheEntry), 0, sizeof(struct HksAuthTokenCacheEntry));
+            continue;
+        }
+        if (HksMemCmp(entry->digest, digest, HKS_DIGEST_SHA256_LEN) == 0) {
+            (void)memcpy_s(outAuthToken, sizeof(struct HksUserAuthToken),
+                &entry->authToken, sizeof(struct HksUserAuthToken));
+            isFound = true;
+            break;
+        }
+    }
+    HksMutexUnlock(HksGetHuksMutex());
+    return isFound;
+}
+
+static struct HksAuthTokenCacheEntry *SelectAuthTokenCacheSlotLocked(const uint8_t *digest)
+{
+    struct HksAuthTokenCacheEntry *oldest = &g_authTokenCache.entries[0];
+    for (uint32_t i = 0; i < HKS_AUTH_TOKEN_CACHE_SIZE; ++i) {
+        struct HksAuthTokenCacheEntry *entry = &g_authTokenCache.entries[i];
+        if (!entry->isValid || HksMemCmp(entry->digest, digest, HKS_DIGEST_SHA256_LEN) == 0) {
+            return entry;
+        }
+        if (entry->verifiedTime < oldest->verifiedTime) {
+            oldest = entry;
+        }
+    }
+    return oldest;
+}
+
+static void InsertAuthTokenCache(const uint8_t *digest, uint64_t curTime, const struct HksUserAuthToken *authToken)
+{
+    HksMutexLock(HksGetHuksMutex());
+    /* tokens of another user or another auth type mean a user switch or credential change, drop everything */
+    if (g_authTokenCache.hasOwner && (g_authTokenCache.userId != authToken->ciphertextData.userId ||
+        g_authTokenCache.authType != authToken->plaintextData.authType)) {
+        HKS_LOG_I("auth token owner changed, clear auth token cache");
+        ClearAuthTokenCacheLocked();
+    }
+    g_authTokenCache.hasOwner = true;
+    g_authTokenCache.userId = authToken->ciphertextData.userId;
+    g_authTokenCache.authType = authToken->plaintextData.authType;
+
+    struct HksAuthTokenCacheEntry *entry = SelectAuthTokenCacheSlotLocked(digest);
+    (void)memcpy_s(entry->digest, HKS_DIGEST_SHA256_LEN, digest, HKS_DIGEST_SHA256_LEN);
+    (void)memcpy_s(&entry->authToken, sizeof(struct HksUserAuthToken), authToken, sizeof(struct HksUserAuthToken));
+    entry->verifiedTime = curTime;
+    entry->isValid = true;
+    HksMutexUnlock(HksGetHuksMutex());
+}
+
+void HksCoreSecureAccessClearAuthTokenCache(void)
+{
+    HksMutexLock(HksGetHuksMutex());
+    ClearAuthTokenCacheLocked();
+    HksMutexUnlock(HksGetHuksMutex());
+}
+
+static bool GetAuthTokenCacheKey(const struct HksBlob *authTokenParam, uint8_t *digest, uint64_t *curTime)
+{
+    if (CheckAuthToken(authTokenParam) != HKS_SUCCESS) {
+        return false;
+    }
+    struct HksBlob digestBlob = { HKS_DIGEST_SHA256_LEN, digest };
+    if (HksCryptoHalHash(HKS_DIGEST_SHA256, authTokenParam, &digestBlob) != HKS_SUCCESS) {
+        HKS_LOG_E("calc auth token digest failed, skip auth token cache");
+        return false;
+    }
+    return HksElapsedRealTime(curTime) == HKS_SUCCESS;
+}
+
+static int32_t GetCachedAuthToken(const uint8_t *digest, uint64_t curTime, struct HksUserAuthToken **outAuthToken)
+{
+    struct HksUserAuthToken *authToken = (struct HksUserAuthToken *)HksMalloc(sizeof(struct HksUserAuthToken));
+    HKS_IF_NULL_LOGE_RETURN(authToken, HKS_ERROR_MALLOC_FAIL, "malloc for authToken failed!")
+
+    if (!LookupAuthTokenCache(digest, curTime, authToken)) {
+        HKS_FREE(authToken);
+        return HKS_ERROR_NOT_EXIST;
+    }
+    *outAuthToken = authToken;
+    return HKS_SUCCESS;
+}
+
+static int32_t VerifyAndDecryptAuthToken(const struct HuksKeyNode *keyNode, const struct HksBlob *authTokenParam,
+    struct HksUserAuthToken **outAuthToken)
+{
+    struct HksUserAuthToken *authToken = NULL;
+    int32_t ret = ParseAuthToken(authTokenParam, &authToken);
+    HKS_IF_NOT_SUCC_LOGE_RETURN(ret, HKS_ERROR_INVALID_AUTH_TOKEN, "parse auth token failed!")
+
+    do {
+        ret = HksVerifyAuthTokenSign(authToken);
+        HKS_IF_NOT_SUCC_LOGE_BREAK(ret, "verify the auth token sign failed! %" LOG_PUBLIC "d", ret)
+
+        ret = HksCheckAuthType(keyNode, authToken);
+        HKS_IF_NOT_SUCC_LOGE_BREAK(ret, "HksCheckAuthType failed! %" LOG_PUBLIC "d", ret)
+
+        ret = HksDecryptAuthToken(authToken);
+        HKS_IF_NOT_SUCC_LOGE_BREAK(ret, "decrypt auth token failed! %" LOG_PUBLIC "d", ret)
+
+        *outAuthToken = authToken;
+        return HKS_SUCCESS;
+    } while (0);
+
+    HKS_FREE(authToken);
+    return ret;
+}
+
+/*
+ * The sign verification and decryption of an auth token only depend on its bytes, so the result is cached
+ * by token digest. The checks bound to the key node (auth type, challenge, timestamp, uid) always run.
+ */
+static int32_t GetVerifiedAuthToken(const struct HuksKeyNode *keyNode, const struct HksParamSet *paramSet,
+    struct HksUserAuthToken **outAuthToken)
 {
     struct HksParam *authTokenParam = NULL;
     int32_t ret = HksGetParam(paramSet, HKS_TAG_AUTH_TOKEN, &authTokenParam);
     HKS_IF_NOT_SUCC_LOGE_RETURN(ret, HKS_ERROR_CHECK_GET_AUTH_TOKEN_FAILED, "get auth token param failed!")
 
-    ret = ParseAuthToken(&authTokenParam->blob, authToken);
-    HKS_IF_NOT_SUCC_LOGE_RETURN(ret, HKS_ERROR_INVALID_AUTH_TOKEN, "parse auth token failed!")
+    uint8_t digest[HKS_DIGEST_SHA256_LEN] = {0};
+    uint64_t curTime = 0;
+    bool isCacheUsable = GetAuthTokenCacheKey(&authTokenParam->blob, digest, &curTime);
+    if (isCacheUsable && GetCachedAuthToken(digest, curTime, outAuthToken) == HKS_SUCCESS) {
+        ret = HksCheckAuthType(keyNode, *outAuthToken);
+        if (ret != HKS_SUCCESS) {
+            HKS_LOG_E("HksCheckAuthType failed! %" LOG_PUBLIC "d", ret);
+            HKS_FREE(*outAuthToken);
+        }
+        return ret;
+    }
 
+    ret = VerifyAndDecryptAuthToken(keyNode, &authTokenParam->blob, outAuthToken);
+    HKS_IF_NOT_SUCC_RETURN(ret, ret)
+
+    if (isCacheUsable) {
+        InsertAuthTokenCache(digest, curTime, *outAuthToken);
+    }
     return HKS_SUCCESS;
 }
 
@@ -868,48 +1083,7 @@ int32_t HksCoreSecureAccessInitParams(struct HuksKeyNode *keyNode, const struct
     HKS_IF_NOT_SUCC_LOGE_RETURN(ret, ret, "build auth run time params failed")
 
     keyNode->authRuntimeParamSet = authRuntimeParamSet;
-    return HKS_SUCCESS;
-}
-
-static int32_t GetAuthMode(const struct HksParamSet *paramSet, uint32_t *type)
-{
-    struct HksParam *typeParam = NULL;
-    if (HksGetParam(paramSet, HKS_TAG_USER_AUTH_MODE, &typeParam) == HKS_SUCCESS &&
-        typeParam->uint32Param == HKS_USER_AUTH_MODE_COAUTH) {
-        *type = HKS_USER_AUTH_MODE_COAUTH;
-        return HKS_SUCCESS;
-    }
-
-    *type = HKS_USER_AUTH_MODE_LOCAL;
-    return HKS_SUCCESS;
-}
-
-static int32_t HksCheckAuthType(struct HuksKeyNode *keyNode, const struct HksUserAuthToken *authToken)
-{
-    uint32_t blobAuthMode;
-    int32_t ret = GetAuthMode(keyNode->keyBlobParamSet, &blobAuthMode);
-    HKS_IF_NOT_SUCC_LOGE_RETURN(ret, ret, "get auth mode failed")
-    
-    enum {
-        // see `enum TokenType` in `drivers/peripheral/user_auth/hdi_service/common/inc/defines.h`
-        TOKEN_TYPE_LOCAL_AUTH = 0,
-        TOKEN_TYPE_LOCAL_RESIGN = 1,
-        TOKEN_TYPE_COAUTH = 2,
-    };
-    switch (authToken->plaintextData.tokenType) {
-        case TOKEN_TYPE_LOCAL_AUTH:
-        case TOKEN_TYPE_LOCAL_RESIGN:
-            break;
-        case TOKEN_TYPE_COAUTH:
-            if (blobAuthMode != HKS_USER_AUTH_MODE_COAUTH) {
-                HKS_LOG_E("not COAUTH_MODE_AUTH %" LOG_PUBLIC "u", blobAuthMode);
-                return HKS_ERROR_NOT_SUPPORTED;
-            }
-            break;
-        default:
-            HKS_LOG_E("invalid authMode %" LOG_PUBLIC "u", blobAuthMode);
-            return HKS_ERROR_NOT_SUPPORTED;
-    }
+    keyNode->session.isUserAuthAccess = innerParams.isUserAuthAccess;
     return HKS_SUCCESS;
 }
 
@@ -919,6 +1093,9 @@ int32_t HksCoreSecureAccessVerifyParams(struct HuksKeyNode *keyNode, const struc
         HKS_LOG_E("the pointer param is invalid");
         return HKS_ERROR_NULL_POINTER;
     }
+    if (!keyNode->session.isUserAuthAccess) {
+        return HKS_SUCCESS;
+    }
 
     struct HksParam *authResult = NULL;
     bool isNeedSecureAccess = true;
@@ -937,17 +1114,8 @@ int32_t HksCoreSecureAccessVerifyParams(struct HuksKeyNode *keyNode, const struc
 
     struct HksUserAuthToken *authToken = NULL;
     do {
-        ret = GetAuthToken(paramSet, &authToken);
-        HKS_IF_NOT_SUCC_LOGE_BREAK(ret, "get auth token failed! %" LOG_PUBLIC "d", ret)
-
-        ret = HksVerifyAuthTokenSign(authToken);
-        HKS_IF_NOT_SUCC_LOGE_BREAK(ret, "verify the auth token sign failed! %" LOG_PUBLIC "d", ret)
-
-        ret = HksCheckAuthType(keyNode, authToken);
-        HKS_IF_NOT_SUCC_LOGE_BREAK(ret, "HksCheckAuthType failed! %" LOG_PUBLIC "d", ret)
-
-        ret = HksDecryptAuthToken(authToken);
-        HKS_IF_NOT_SUCC_LOGE_BREAK(ret, "decrypt auth token failed! %" LOG_PUBLIC "d", ret)
+        ret = GetVerifiedAuthToken(keyNode, paramSet, &authToken);
+        HKS_IF_NOT_SUCC_LOGE_BREAK(ret, "get verified auth token failed! %" LOG_PUBLIC "d", ret)
 
         ret = VerifyChallengeOrTimeStamp(keyNode, authToken);
         HKS_IF_NOT_SUCC_LOGE_BREAK(ret, "verify challenge failed! %" LOG_PUBLIC "d", ret)
@@ -962,8 +1130,8 @@ int32_t HksCoreSecureAccessVerifyParams(struct HuksKeyNode *keyNode, const struc
 int32_t HksCoreAppendAuthInfoBeforeUpdate(struct HuksKeyNode *keyNode, uint32_t pur,
     const struct HksParamSet *inParamSet, const struct HksBlob *inData, struct HksBlob *appendedData)
 {
-    // current only support append secure sign
-    if (pur != HKS_KEY_PURPOSE_SIGN) {
+    // current only support append secure sign, which needs user auth
+    if (pur != HKS_KEY_PURPOSE_SIGN || !keyNode->session.isUserAuthAccess) {
         return HKS_SUCCESS;
     }
 
@@ -1010,7 +1178,7 @@ int32_t HksCoreAppendAuthInfoBeforeFinish(struct HuksKeyNode *keyNode, uint32_t
 int32_t HksCoreAppendAuthInfoAfterFinish(struct HuksKeyNode *keyNode, uint32_t pur,
     const struct HksParamSet *inParamSet, uint32_t inOutDataOriginSize, struct HksBlob *inOutData)
 {
-    if (pur != HKS_KEY_PURPOSE_SIGN) {
+    if (pur != HKS_KEY_PURPOSE_SIGN || !keyNode->session.isUserAuthAccess) {
         return HKS_SUCCESS;
     }
 
@@ -1101,6 +1269,10 @@ int32_t HksCheckKeybBlobIsSupportUserAuth(const struct HksParamSet *blobParamSet
     *isSupport = false;
     return HKS_SUCCESS;
 }
+
+void HksCoreSecureAccessClearAuthTokenCache(void)
+{
+}
 #endif
 
 #ifndef _STORAGE_LITE_
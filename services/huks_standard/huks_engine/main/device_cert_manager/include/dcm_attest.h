@@ -109,8 +109,6 @@ struct HksAttestExt {
 struct HksAttestSpec {
     struct HksBlob claimsOid;
     struct HksBlob claims;
-    struct HksBlob devCert;
-    struct HksBlob devKey;
     struct HksBlob attestKey;
     struct HksUsageSpec usageSpec;
     struct ValidPeriod validity;
@@ -120,6 +118,10 @@ struct HksAttestSpec {
 extern "C" {
 #endif
 
+int32_t DcmAttestPrepare(void);
+
+void DcmAttestDestroy(void);
+
 int32_t CreateAttestCertChain(const struct HksParamSet *keyNodeParamSet, const struct HksParamSet *paramSet,
     struct HksBlob *certChain, struct HksBlob *rawKey);
 
@@ -329,6 +329,23 @@ static enum HksTag g_idAttestList[] = {
     HKS_TAG_ATTESTATION_ID_VERSION_INFO,
 };
 
+/*
+ * Everything in an attestation chain that does not depend on the attested key: the parsed TBS templates, the
+ * issuer taken from the device cert, the parsed device signing key and the formatted dev/ca/root tail of the
+ * chain. It is built once at module init and only read afterwards.
+ */
+struct HksAttestPreparedState {
+    bool isPrepared;
+    bool isEcTbsValid;
+    struct HksAttestTbsSpec rsaTbs;
+    struct HksAttestTbsSpec ecTbs;
+    struct HksAsn1Obj issuer;
+    struct HksBlob devKeyMaterial;
+    struct HksBlob chainTail;
+};
+
+static struct HksAttestPreparedState g_attestState = { 0 };
+
 static inline uint32_t GetYearIndex(uint32_t year)
 {
     if ((year % 4 == 0) && ((year % 100 != 0) || (year % 400 == 0))) { /* 4/100/400 check whether it is a leap year */
@@ -535,7 +552,7 @@ static int32_t IsValidAttestCert(struct HksAttestCert *cert)
     return HKS_SUCCESS;
 }
 
-static void ParseAttestTbs(const struct HksBlob *template, struct HksAttestTbsSpec *tbsSpec)
+static int32_t ParseAttestTbs(const struct HksBlob *template, struct HksAttestTbsSpec *tbsSpec)
 {
     struct HksAsn1Obj obj = {{0}};
     struct HksBlob skip = { 0, NULL };
@@ -551,24 +568,26 @@ static void ParseAttestTbs(const struct HksBlob *template, struct HksAttestTbsSp
     ret += DcmAsn1ExtractTag(&val, &tbsSpec->spki, &val, ASN_1_TAG_TYPE_SEQ);
     ret += DcmAsn1ExtractTag(&val, &tbsSpec->extensions, &val, ASN_1_TAG_TYPE_CTX_SPEC3);
     ret += IsValidAttestTbs(tbsSpec);
-    HKS_IF_NOT_SUCC_LOGE(ret, "invalid tbs.\n")
+    HKS_IF_NOT_SUCC_LOGE_RETURN(ret, HKS_ERROR_INVALID_ARGUMENT, "invalid tbs.\n")
+    return HKS_SUCCESS;
 }
 
-static void ParseAttestCert(const struct HksBlob *devCert, struct HksAttestCert *cert)
+static int32_t ParseAttestCert(const struct HksBlob *devCert, struct HksAttestCert *cert)
 {
     struct HksAsn1Obj obj = {{0}};
     struct HksBlob next = { 0, NULL };
 
     int32_t ret = DcmAsn1ExtractTag(&next, &obj, devCert, ASN_1_TAG_TYPE_SEQ);
     struct HksBlob val = { obj.value.size, obj.value.data };
-    ParseAttestTbs(&val, &cert->tbs);
+    ret += ParseAttestTbs(&val, &cert->tbs);
     struct HksAsn1Obj skip = {{0}};
     ret += DcmAsn1ExtractTag(&val, &skip, &val, ASN_1_TAG_TYPE_SEQ);
     ret += DcmAsn1ExtractTag(&val, &cert->signAlg, &val, ASN_1_TAG_TYPE_SEQ);
     ret += DcmAsn1ExtractTag(&val, &cert->signature, &val, ASN_1_TAG_TYPE_BIT_STR);
 
     ret += IsValidAttestCert(cert);
-    HKS_IF_NOT_SUCC_LOGE(ret, "invalid dev cert.\n")
+    HKS_IF_NOT_SUCC_LOGE_RETURN(ret, HKS_ERROR_INVALID_ARGUMENT, "invalid dev cert.\n")
+    return HKS_SUCCESS;
 }
 
 static void ParseAttestExtension(const struct HksBlob *data, struct HksAttestExt *ext)
@@ -733,12 +752,15 @@ static void GetSignatureByAlg(uint32_t signAlg, struct HksAsn1Blob *sigature)
         sigature->data = g_ecdsaSha256Oid.data;
     }
 }
-static int32_t CreateTbs(const struct HksBlob *template, const struct HksAttestSpec *attestSpec,
+static int32_t CreateTbs(const struct HksAttestPreparedState *state, const struct HksAttestSpec *attestSpec,
     struct HksBlob *tbs, uint32_t signAlg)
 {
-    struct HksAttestTbsSpec draftTbs;
-    (void)memset_s(&draftTbs, sizeof(struct HksAttestTbsSpec), 0, sizeof(struct HksAttestTbsSpec));
-    ParseAttestTbs(template, &draftTbs);
+    if ((signAlg != HKS_ALG_RSA) && !state->isEcTbsValid) {
+        HKS_LOG_E("tbs template of alg %" LOG_PUBLIC "u is invalid", signAlg);
+        return HKS_ERROR_BAD_STATE;
+    }
+    /* the prepared template only points into the const template, so a shallow copy is enough to patch it */
+    struct HksAttestTbsSpec draftTbs = (signAlg == HKS_ALG_RSA) ? state->rsaTbs : state->ecTbs;
     struct HksAsn1Blob sigature = { ASN_1_TAG_TYPE_SEQ, 0, NULL };
     GetSignatureByAlg(signAlg, &sigature);
     draftTbs.signature.value = sigature;
@@ -749,10 +771,7 @@ static int32_t CreateTbs(const struct HksBlob *template, const struct HksAttestS
     struct HksAsn1Blob validBlob = { ASN_1_TAG_TYPE_RAW, validity.size, validity.data };
     draftTbs.validity.value = validBlob;
 
-    struct HksAttestCert devCert;
-    (void)memset_s(&devCert, sizeof(struct HksAttestCert), 0, sizeof(struct HksAttestCert));
-    ParseAttestCert(&attestSpec->devCert, &devCert);
-    draftTbs.issuer = devCert.tbs.subject;
+    draftTbs.issuer = state->issuer;
 
     uint8_t pubKey[PUBKEY_DER_LEN] = {0};
     struct HksBlob pubKeyBlob = { PUBKEY_DER_LEN, pubKey };
@@ -871,9 +890,9 @@ int32_t HksGetDevicePrivateKey(const struct HksBlob *key, struct HksBlob *out)
     return HKS_SUCCESS;
 }
 
-static int32_t SignTbs(struct HksBlob *sig, const struct HksBlob *tbs, const struct HksBlob *key, uint32_t signAlg)
+static int32_t SignTbs(struct HksBlob *sig, const struct HksBlob *tbs, const struct HksBlob *priKey,
+    uint32_t signAlg)
 {
-    (void)key;
     uint8_t buffer[HKS_DIGEST_SHA256_LEN] = {0};
     struct HksBlob message = { HKS_DIGEST_SHA256_LEN, buffer };
     int32_t ret = HksCryptoHalHash(HKS_DIGEST_SHA256, tbs, &message);
@@ -892,30 +911,24 @@ static int32_t SignTbs(struct HksBlob *sig, const struct HksBlob *tbs, const str
         usageSpec.algType = HKS_ALG_ECC;
     }
 
-    struct HksBlob priKey = { 0, NULL };
-    ret = HksGetDevicePrivateKey(key, &priKey);
-    HKS_IF_NOT_SUCC_LOGE_RETURN(ret, ret, "get private key failed!")
-
-    ret = HksCryptoHalSign(&priKey, &usageSpec, &message, sig);
-    (void)memset_s(priKey.data, priKey.size, 0, priKey.size);
-    HKS_FREE(priKey.data);
+    ret = HksCryptoHalSign(priKey, &usageSpec, &message, sig);
     HKS_IF_NOT_SUCC_LOGE_RETURN(ret, ret, "sign tbs failed!")
 
     return HKS_SUCCESS;
 }
 
-static int32_t CreateAttestCert(struct HksBlob *attestCert, struct HksBlob *template,
+static int32_t CreateAttestCert(struct HksBlob *attestCert, const struct HksAttestPreparedState *state,
     const struct HksAttestSpec *attestSpec, uint32_t signAlg)
 {
     struct HksBlob tbs = *attestCert;
     tbs.data += ATT_CERT_HEADER_SIZE;
     tbs.size -= ATT_CERT_HEADER_SIZE;
-    int32_t ret = CreateTbs(template, attestSpec, &tbs, signAlg);
+    int32_t ret = CreateTbs(state, attestSpec, &tbs, signAlg);
     HKS_IF_NOT_SUCC_LOGE_RETURN(ret, HKS_ERROR_BAD_STATE, "CreateTbs failed!")
 
     uint8_t sigBuf[SIG_MAX_SIZE] = {0};
     struct HksBlob signature = { sizeof(sigBuf), sigBuf };
-    ret = SignTbs(&signature, &tbs, &attestSpec->devKey, signAlg);
+    ret = SignTbs(&signature, &tbs, &state->devKeyMaterial, signAlg);
     HKS_IF_NOT_SUCC_LOGE_RETURN(ret, HKS_ERROR_BAD_STATE, "SignTbs failed!")
 
     uint32_t certSize = tbs.size;
@@ -1245,14 +1258,11 @@ static int32_t BuildAttestClaims(const struct HksParamSet *paramSet, const struc
     return HKS_SUCCESS;
 }
 
+/* the built-in certs and key are const and live as long as the process, so hand out views instead of copies */
 static int32_t ReadCertOrKey(const uint8_t *inData, uint32_t size, struct HksBlob *out)
 {
-    uint8_t *data = HksMalloc(size);
-    HKS_IF_NULL_LOGE_RETURN(data, HKS_ERROR_MALLOC_FAIL, "malloc data fail\n")
-
-    (void)memcpy_s(data, size, inData, size);
     out->size = size;
-    out->data = data;
+    out->data = (uint8_t *)inData;
     return HKS_SUCCESS;
 }
 
@@ -1273,17 +1283,6 @@ static int32_t GetCertOrKey(enum HksCertType type, struct HksBlob *out)
     return HKS_ERROR_NOT_SUPPORTED;
 }
 
-static int32_t GetCertAndKey(struct HksAttestSpec *attestSpec)
-{
-    int32_t ret = GetCertOrKey(HKS_DEVICE_CERT, &attestSpec->devCert);
-    HKS_IF_NOT_SUCC_LOGE_RETURN(ret, ret, "get devCert fail")
-
-    ret = GetCertOrKey(HKS_DEVICE_KEY, &attestSpec->devKey);
-    HKS_IF_NOT_SUCC_LOGE_RETURN(ret, ret, "get devKey fail")
-
-    return ret;
-}
-
 static void FreeAttestSpec(struct HksAttestSpec **attestSpec)
 {
     struct HksAttestSpec *spec = *attestSpec;
@@ -1294,13 +1293,6 @@ static void FreeAttestSpec(struct HksAttestSpec **attestSpec)
     if (spec->claims.data != NULL) {
         HKS_FREE(spec->claims.data);
     }
-    if (spec->devCert.data != NULL) {
-        HKS_FREE(spec->devCert.data);
-    }
-    if (spec->devKey.data != NULL) {
-        (void)memset_s(spec->devKey.data, spec->devKey.size, 0, spec->devKey.size);
-        HKS_FREE(spec->devKey.data);
-    }
     if (spec->attestKey.data != NULL) {
         (void)memset_s(spec->attestKey.data, spec->attestKey.size, 0, spec->attestKey.size);
         HKS_FREE(spec->attestKey.data);
@@ -1350,37 +1342,26 @@ static int32_t BuildAttestSpec(const struct HksParamSet *keyNodeParamSet, const
     attestSpec->claimsOid = hksAttestationExtensionOid;
     attestSpec->attestKey.size = rawKey->size;
     attestSpec->attestKey.data = HksMalloc(rawKey->size);
-    HKS_IF_NULL_LOGE_RETURN(attestSpec->attestKey.data, HKS_ERROR_MALLOC_FAIL, "fail to malloc raw key")
-    (void)memcpy_s(attestSpec->attestKey.data, rawKey->size, rawKey->data, rawKey->size);
-
-    ret = GetCertAndKey(attestSpec);
-    if (ret != HKS_SUCCESS) {
-        HKS_LOG_E("get cert and key fail\n");
+    if (attestSpec->attestKey.data == NULL) {
+        HKS_LOG_E("fail to malloc raw key");
         FreeAttestSpec(&attestSpec);
-        return ret;
+        return HKS_ERROR_MALLOC_FAIL;
     }
+    (void)memcpy_s(attestSpec->attestKey.data, rawKey->size, rawKey->data, rawKey->size);
+
     *outAttestSpec = attestSpec;
     return HKS_SUCCESS;
 }
 
-static int32_t CreateHwAttestCert(const struct HksAttestSpec *attestSpec, struct HksBlob *outAttestCert,
-    uint32_t signAlg)
+static int32_t CreateHwAttestCert(const struct HksAttestPreparedState *state, const struct HksAttestSpec *attestSpec,
+    struct HksBlob *outAttestCert, uint32_t signAlg)
 {
-    struct HksBlob template = { 0, NULL };
-    if (signAlg == HKS_ALG_RSA) {
-        template.data = (uint8_t *)g_attestTbsRsa;
-        template.size = sizeof(g_attestTbsRsa);
-    } else {
-        template.data = (uint8_t *)g_attestTbs;
-        template.size = sizeof(g_attestTbs);
-    }
-
     uint8_t *attest = HksMalloc(HKS_ATTEST_CERT_SIZE + attestSpec->claims.size);
     HKS_LOG_E("mattestSpec->claims.size is %" LOG_PUBLIC "d!", attestSpec->claims.size);
     HKS_IF_NULL_LOGE_RETURN(attest, HKS_ERROR_MALLOC_FAIL, "malloc attest cert failed!")
 
     struct HksBlob attestCert = { HKS_ATTEST_CERT_SIZE + attestSpec->claims.size, attest };
-    int32_t ret = CreateAttestCert(&attestCert, &template, attestSpec, signAlg);
+    int32_t ret = CreateAttestCert(&attestCert, state, attestSpec, signAlg);
     if (ret != HKS_SUCCESS) {
         HKS_FREE(attest);
         HKS_LOG_E("CreateAttestCert failed!");
@@ -1411,13 +1392,105 @@ static int32_t FormatCertToBuf(enum HksCertType type, struct HksBlob *buf)
     HKS_IF_NOT_SUCC_LOGE_RETURN(ret, HKS_ERROR_BAD_STATE, "get cert failed!")
 
     ret = CopyBlobToBuffer(&cert, buf);
-    HKS_FREE(cert.data);
     HKS_IF_NOT_SUCC_LOGE_RETURN(ret, ret, "copy cert fail")
 
     return ret;
 }
 
-static int32_t FormatAttestChain(const struct HksBlob *attestCert, const struct HksAttestSpec *attestSpec,
+static uint32_t FormattedCertSize(enum HksCertType type)
+{
+    struct HksBlob cert = { 0, NULL };
+    if (GetCertOrKey(type, &cert) != HKS_SUCCESS) {
+        return 0;
+    }
+    return sizeof(cert.size) + ALIGN_SIZE(cert.size);
+}
+
+static int32_t PrepareChainTail(struct HksBlob *chainTail)
+{
+    uint32_t size = FormattedCertSize(HKS_DEVICE_CERT) + FormattedCertSize(HKS_CA_CERT) +
+        FormattedCertSize(HKS_ROOT_CERT);
+    uint8_t *data = (uint8_t *)HksMalloc(size);
+    HKS_IF_NULL_LOGE_RETURN(data, HKS_ERROR_MALLOC_FAIL, "malloc chain tail failed!")
+    (void)memset_s(data, size, 0, size);
+
+    struct HksBlob tmp = { size, data };
+    int32_t ret = FormatCertToBuf(HKS_DEVICE_CERT, &tmp);
+    if (ret == HKS_SUCCESS) {
+        ret = FormatCertToBuf(HKS_CA_CERT, &tmp);
+    }
+    if (ret == HKS_SUCCESS) {
+        ret = FormatCertToBuf(HKS_ROOT_CERT, &tmp);
+    }
+    if (ret != HKS_SUCCESS) {
+        HKS_LOG_E("format chain tail failed!");
+        HKS_FREE(data);
+        return ret;
+    }
+    chainTail->data = data;
+    chainTail->size = size;
+    return HKS_SUCCESS;
+}
+
+static void FreeAttestPreparedState(struct HksAttestPreparedState *state)
+{
+    if (state->devKeyMaterial.data != NULL) {
+        (void)memset_s(state->devKeyMaterial.data, state->devKeyMaterial.size, 0, state->devKeyMaterial.size);
+        HKS_FREE(state->devKeyMaterial.data);
+    }
+    HKS_FREE_BLOB(state->chainTail);
+    (void)memset_s(state, sizeof(struct HksAttestPreparedState), 0, sizeof(struct HksAttestPreparedState));
+}
+
+static int32_t PrepareAttestState(struct HksAttestPreparedState *state)
+{
+    (void)memset_s(state, sizeof(struct HksAttestPreparedState), 0, sizeof(struct HksAttestPreparedState));
+
+    struct HksBlob template = { sizeof(g_attestTbsRsa), (uint8_t *)g_attestTbsRsa };
+    int32_t ret = ParseAttestTbs(&template, &state->rsaTbs);
+    HKS_IF_NOT_SUCC_LOGE_RETURN(ret, ret, "parse rsa tbs template failed!")
+
+    /* the chain is always signed with the rsa device key, the ec template is only checked when used */
+    template.size = sizeof(g_attestTbs);
+    template.data = (uint8_t *)g_attestTbs;
+    state->isEcTbsValid = (ParseAttestTbs(&template, &state->ecTbs) == HKS_SUCCESS);
+
+    struct HksBlob devCertBlob = { 0, NULL };
+    (void)GetCertOrKey(HKS_DEVICE_CERT, &devCertBlob);
+    struct HksAttestCert devCert;
+    (void)memset_s(&devCert, sizeof(struct HksAttestCert), 0, sizeof(struct HksAttestCert));
+    ret = ParseAttestCert(&devCertBlob, &devCert);
+    HKS_IF_NOT_SUCC_LOGE_RETURN(ret, ret, "parse dev cert failed!")
+    state->issuer = devCert.tbs.subject;
+
+    struct HksBlob devKey = { 0, NULL };
+    (void)GetCertOrKey(HKS_DEVICE_KEY, &devKey);
+    ret = HksGetDevicePrivateKey(&devKey, &state->devKeyMaterial);
+    HKS_IF_NOT_SUCC_LOGE_RETURN(ret, ret, "get private key failed!")
+
+    ret = PrepareChainTail(&state->chainTail);
+    if (ret != HKS_SUCCESS) {
+        FreeAttestPreparedState(state);
+        return ret;
+    }
+    state->isPrepared = true;
+    return HKS_SUCCESS;
+}
+
+int32_t DcmAttestPrepare(void)
+{
+    if (g_attestState.isPrepared) {
+        return HKS_SUCCESS;
+    }
+    return PrepareAttestState(&g_attestState);
+}
+
+void DcmAttestDestroy(void)
+{
+    FreeAttestPreparedState(&g_attestState);
+}
+
+static int32_t FormatAttestChain(const struct HksBlob *attestCert, const struct HksAttestPreparedState *state,
     struct HksBlob *certChain)
 {
     struct HksBlob tmp = *certChain;
@@ -1428,37 +1501,52 @@ static int32_t FormatAttestChain(const struct HksBlob *attestCert, const struct
     int32_t ret = CopyBlobToBuffer(attestCert, &tmp);
     HKS_IF_NOT_SUCC_LOGE_RETURN(ret, ret, "copy attest cert fail")
 
-    ret = CopyBlobToBuffer(&attestSpec->devCert, &tmp);
-    HKS_IF_NOT_SUCC_LOGE_RETURN(ret, ret, "copy dev cert fail")
-
-    ret = FormatCertToBuf(HKS_CA_CERT, &tmp);
-    HKS_IF_NOT_SUCC_LOGE_RETURN(ret, HKS_ERROR_BAD_STATE, "format ca cert failed!")
-
-    ret = FormatCertToBuf(HKS_ROOT_CERT, &tmp);
-    HKS_IF_NOT_SUCC_LOGE_RETURN(ret, HKS_ERROR_BAD_STATE, "format root cert failed!")
+    if (memcpy_s(tmp.data, tmp.size, state->chainTail.data, state->chainTail.size) != EOK) {
+        HKS_LOG_E("copy chain tail fail");
+        return HKS_ERROR_BUFFER_TOO_SMALL;
+    }
+    tmp.data += state->chainTail.size;
 
     certChain->size = tmp.data - certChain->data;
     HKS_LOG_I("certChain size after format is %" LOG_PUBLIC "u", certChain->size);
     return HKS_SUCCESS;
 }
 
-int32_t CreateAttestCertChain(const struct HksParamSet *keyNodeParamSet, const struct HksParamSet *paramSet,
-    struct HksBlob *certChain, struct HksBlob *rawKey)
+static int32_t CreateAttestCertChainWithState(const struct HksAttestPreparedState *state,
+    const struct HksParamSet *keyNodeParamSet, const struct HksParamSet *paramSet, struct HksBlob *certChain,
+    struct HksBlob *rawKey)
 {
     struct HksAttestSpec *attestSpec = NULL;
     int32_t ret = BuildAttestSpec(keyNodeParamSet, paramSet, rawKey, &attestSpec);
     HKS_IF_NOT_SUCC_LOGE_RETURN(ret, ret, "build attest spec failed")
 
     struct HksBlob attestCert;
-    ret = CreateHwAttestCert(attestSpec, &attestCert, HKS_ALG_RSA);
+    ret = CreateHwAttestCert(state, attestSpec, &attestCert, HKS_ALG_RSA);
     if (ret != HKS_SUCCESS) {
         FreeAttestSpec(&attestSpec);
         HKS_LOG_E("build attest spec failed");
         return ret;
     }
 
-    ret = FormatAttestChain(&attestCert, attestSpec, certChain);
+    ret = FormatAttestChain(&attestCert, state, certChain);
     HKS_FREE_BLOB(attestCert);
     FreeAttestSpec(&attestSpec);
     return ret;
 }
+
+int32_t CreateAttestCertChain(const struct HksParamSet *keyNodeParamSet, const struct HksParamSet *paramSet,
+    struct HksBlob *certChain, struct HksBlob *rawKey)
+{
+    if (g_attestState.isPrepared) {
+        return CreateAttestCertChainWithState(&g_attestState, keyNodeParamSet, paramSet, certChain, rawKey);
+    }
+
+    /* normally prepared at module init; if that failed, build a private copy for this request */
+    struct HksAttestPreparedState localState;
+    int32_t ret = PrepareAttestState(&localState);
+    HKS_IF_NOT_SUCC_LOGE_RETURN(ret, ret, "prepare attest state failed")
+
+    ret = CreateAttestCertChainWithState(&localState, keyNodeParamSet, paramSet, certChain, rawKey);
+    FreeAttestPreparedState(&localState);
+    return ret;
+}
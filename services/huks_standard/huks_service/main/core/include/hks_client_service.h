@@ -42,6 +42,10 @@ int32_t HksServiceSign(const struct HksProcessInfo *processInfo, const struct Hk
 int32_t HksServiceVerify(const struct HksProcessInfo *processInfo, const struct HksBlob *keyAlias,
     const struct HksParamSet *paramSet, const struct HksBlob *srcData, const struct HksBlob *signature);
 
+int32_t HksServiceBatchVerify(const struct HksProcessInfo *processInfo, const struct HksBlob *keyAlias,
+    const struct HksParamSet *paramSet, const struct HksBlob *srcData, const struct HksBlob *signature,
+    uint32_t count, struct HksBlob *result);
+
 int32_t HksServiceEncrypt(const struct HksProcessInfo *processInfo, const struct HksBlob *keyAlias,
     const struct HksParamSet *paramSet, const struct HksBlob *plainText, struct HksBlob *cipherText);
 
@@ -22,13 +22,19 @@
 #include "hks_double_list.h"
 #include "hks_type_inner.h"
 
+enum HksOperationState {
+    HKS_OPERATION_IDLE = 0,
+    HKS_OPERATION_IN_USE,
+    HKS_OPERATION_ABORTING, /* in use while its process was removed, deleted once marked unused */
+};
+
 struct HksOperation {
     struct DoubleList listHead;
     struct HksProcessInfo processInfo;
     uint64_t handle;
     bool abortable;
     uint64_t accessTokenId;
-    bool isInUse;
+    uint32_t state; /* enum HksOperationState, only changed atomically */
     uint64_t batchOperationTimestamp;
     bool isBatchOperation;
     bool isUserIdPassedDuringInit;
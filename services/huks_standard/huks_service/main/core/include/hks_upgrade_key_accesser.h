@@ -34,6 +34,14 @@ extern "C" {
 int32_t HksDoUpgradeKeyAccess(const struct HksBlob *oldKey, const struct HksParamSet *srcParamSet,
     struct HksBlob *newKey);
 
+/*
+ * Upgrades the key file path/fileName in place when its key version is older than HKS_KEY_VERSION, and its copy
+ * under bakPath if bakPath is not NULL and the copy is the same. A key already at HKS_KEY_VERSION succeeds with
+ * isUpgraded false. ioSize returns the bytes read and written.
+ */
+int32_t HksUpgradeKeyFileIfNeed(const char *path, const char *bakPath, const char *fileName, bool *isUpgraded,
+    uint32_t *ioSize);
+
 #ifdef __cplusplus
 }
 #endif
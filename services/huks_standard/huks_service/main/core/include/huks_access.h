@@ -77,6 +77,9 @@ int32_t HuksAccessSign(const struct HksBlob *key, const struct HksParamSet *para
 int32_t HuksAccessVerify(const struct HksBlob *key, const struct HksParamSet *paramSet,
     const struct HksBlob *srcData, const struct HksBlob *signature);
 
+int32_t HuksAccessBatchVerify(const struct HksBlob *key, const struct HksParamSet *paramSet,
+    const struct HksBlob *srcData, const struct HksBlob *signature, uint32_t count, struct HksBlob *result);
+
 int32_t HuksAccessEncrypt(const struct HksBlob *key, const struct HksParamSet *paramSet,
     const struct HksBlob *plainText, struct HksBlob *cipherText);
 
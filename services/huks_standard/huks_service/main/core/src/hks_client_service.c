@@ -1083,6 +1083,64 @@ int32_t HksServiceVerify(const struct HksProcessInfo *processInfo, const struct
     return ret;
 }
 
+static int32_t CheckBatchVerifyParams(const struct HksProcessInfo *processInfo, const struct HksBlob *keyAlias,
+    const struct HksParamSet *paramSet, const struct HksBlob *srcData, const struct HksBlob *signature,
+    uint32_t count, const struct HksBlob *result)
+{
+    if (srcData == NULL || signature == NULL || count == 0 || count > HKS_MAX_BATCH_VERIFY_COUNT ||
+        CheckBlob(result) != HKS_SUCCESS || result->size < HKS_BATCH_VERIFY_RESULT_SIZE(count)) {
+        HKS_LOG_E("invalid batch verify count %" LOG_PUBLIC "u", count);
+        return HKS_ERROR_INVALID_ARGUMENT;
+    }
+    for (uint32_t i = 0; i < count; ++i) {
+        int32_t ret = HksCheckAllParams(&processInfo->processName, keyAlias, paramSet, &srcData[i], &signature[i]);
+        HKS_IF_NOT_SUCC_LOGE_RETURN(ret, ret, "check batch verify pair %" LOG_PUBLIC "u failed", i)
+    }
+    return HKS_SUCCESS;
+}
+
+int32_t HksServiceBatchVerify(const struct HksProcessInfo *processInfo, const struct HksBlob *keyAlias,
+    const struct HksParamSet *paramSet, const struct HksBlob *srcData, const struct HksBlob *signature,
+    uint32_t count, struct HksBlob *result)
+{
+    int32_t ret;
+    struct HksParamSet *newParamSet = NULL;
+    struct HksBlob keyFromFile = { 0, NULL };
+    struct HksHitraceId traceId = {0};
+
+#ifdef L2_STANDARD
+    traceId = HksHitraceBegin(__func__, HKS_HITRACE_FLAG_DEFAULT);
+#endif
+
+    do {
+        ret = CheckBatchVerifyParams(processInfo, keyAlias, paramSet, srcData, signature, count, result);
+        HKS_IF_NOT_SUCC_LOGE_BREAK(ret, "check batch verify params failed, ret = %" LOG_PUBLIC "d", ret)
+
+        /* the key file is read once for the whole batch */
+        ret = GetKeyAndNewParamSet(processInfo, keyAlias, paramSet, &keyFromFile, &newParamSet);
+        HKS_IF_NOT_SUCC_LOGE(ret, "batch verify: get main key and new paramSet failed, ret = %" LOG_PUBLIC "d", ret)
+
+        if (ret == HKS_SUCCESS) {
+            ret = HuksAccessBatchVerify(&keyFromFile, newParamSet, srcData, signature, count, result);
+        }
+#ifdef SUPPORT_STORAGE_BACKUP
+        if (ret == HKS_ERROR_CORRUPT_FILE || ret == HKS_ERROR_FILE_SIZE_FAIL || ret == HKS_ERROR_NOT_EXIST) {
+            HKS_FREE_BLOB(keyFromFile);
+            ret = GetKeyData(processInfo, keyAlias, newParamSet, &keyFromFile, HKS_STORAGE_TYPE_BAK_KEY);
+            HKS_IF_NOT_SUCC_LOGE_BREAK(ret,
+                "batch verify: get bak key and new paramSet failed, ret = %" LOG_PUBLIC "d", ret)
+
+            ret = HuksAccessBatchVerify(&keyFromFile, newParamSet, srcData, signature, count, result);
+        }
+#endif
+    } while (0);
+
+    HKS_FREE_BLOB(keyFromFile);
+    HksFreeParamSet(&newParamSet);
+    HksReportEvent(__func__, &traceId, processInfo, paramSet, ret);
+    return ret;
+}
+
 int32_t HksServiceEncrypt(const struct HksProcessInfo *processInfo, const struct HksBlob *keyAlias,
     const struct HksParamSet *paramSet, const struct HksBlob *plainText, struct HksBlob *cipherText)
 {
@@ -1241,12 +1299,27 @@ int32_t HksServiceGetKeyParamSet(const struct HksProcessInfo *processInfo, const
     int32_t ret;
     struct HksParamSet *newParamSet = NULL;
     struct HksBlob keyFromFile = { 0, NULL };
+#ifdef HKS_SUPPORT_KEY_CACHE
+    uint64_t cacheGeneration = 0;
+    bool isCacheMissed = false;
+#endif
 
     do {
         ret = HksCheckGetKeyParamSetParams(&processInfo->processName, keyAlias, paramSetOut);
         HKS_IF_NOT_SUCC_LOGE_BREAK(ret, "check get key paramSet params failed, ret = %" LOG_PUBLIC "d", ret)
 
+#ifdef HKS_SUPPORT_KEY_CACHE
+        ret = AppendProcessInfoAndDefaultStrategy(paramSetIn, processInfo, NULL, &newParamSet);
+        HKS_IF_NOT_SUCC_LOGE_BREAK(ret, "append process info and default strategy failed, ret = %" LOG_PUBLIC "d", ret)
+
+        // a hit only skips reading the key file, the engine still checks the cached key below
+        isCacheMissed = (HksManageStoreGetCachedKey(processInfo, newParamSet, keyAlias, &keyFromFile,
+            &cacheGeneration) != HKS_SUCCESS);
+        ret = isCacheMissed ? GetKeyData(processInfo, keyAlias, newParamSet, &keyFromFile, HKS_STORAGE_TYPE_KEY) :
+            HKS_SUCCESS;
+#else
         ret = GetKeyAndNewParamSet(processInfo, keyAlias, paramSetIn, &keyFromFile, &newParamSet);
+#endif
         HKS_IF_NOT_SUCC_LOGE(ret,
             "get key paramSet: get key and new paramSet failed, ret = %" LOG_PUBLIC "d", ret)
 
@@ -1256,6 +1329,10 @@ int32_t HksServiceGetKeyParamSet(const struct HksProcessInfo *processInfo, const
 #ifdef SUPPORT_STORAGE_BACKUP
         if (ret == HKS_ERROR_CORRUPT_FILE || ret == HKS_ERROR_FILE_SIZE_FAIL || ret == HKS_ERROR_NOT_EXIST) {
             HKS_FREE_BLOB(keyFromFile);
+#ifdef HKS_SUPPORT_KEY_CACHE
+            // the content of the backup file is not cached under the name of the main file
+            isCacheMissed = false;
+#endif
             ret = GetKeyData(processInfo, keyAlias, newParamSet, &keyFromFile, HKS_STORAGE_TYPE_BAK_KEY);
             HKS_IF_NOT_SUCC_LOGE_BREAK(ret,
                 "get key paramSet: get bak key and new paramSet failed, ret = %" LOG_PUBLIC "d", ret)
@@ -1266,7 +1343,12 @@ int32_t HksServiceGetKeyParamSet(const struct HksProcessInfo *processInfo, const
             "get key paramset or access level check key validity failed, ret = %" LOG_PUBLIC "d", ret)
 
         ret = GetKeyParamSet(&keyFromFile, paramSetOut);
-        HKS_IF_NOT_SUCC_LOGE(ret, "get Key paramSet failed, ret = %" LOG_PUBLIC "d", ret)
+        HKS_IF_NOT_SUCC_LOGE_BREAK(ret, "get Key paramSet failed, ret = %" LOG_PUBLIC "d", ret)
+#ifdef HKS_SUPPORT_KEY_CACHE
+        if (isCacheMissed) {
+            HksManageStoreCacheKey(processInfo, newParamSet, keyAlias, &keyFromFile, cacheGeneration);
+        }
+#endif
     } while (0);
 
     HKS_FREE_BLOB(keyFromFile);
@@ -1550,6 +1632,10 @@ int32_t HksServiceInitialize(void)
         ret = HksInitPluginProxy();
         HKS_IF_NOT_SUCC_LOGE_BREAK(ret, "Init plugin failed, ret=%" LOG_PUBLIC "d", ret);
 
+#ifdef HKS_ENABLE_EVENT_DELETE
+        HksServiceSweepDirTrash();
+#endif
+
 #ifdef _STORAGE_LITE_
         ret = HksLoadFileToBuffer();
         HKS_IF_NOT_SUCC_LOGE_BREAK(ret, "load file to buffer failed, ret = %" LOG_PUBLIC "d", ret)
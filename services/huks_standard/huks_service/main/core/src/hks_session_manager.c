@@ -23,6 +23,7 @@
 #include <stdio.h>
 
 #include "hks_log.h"
+#include "hks_log_limiter.h"
 #include "hks_mem.h"
 #include "hks_param.h"
 #include "hks_template.h"
@@ -42,7 +43,20 @@
 
 static struct DoubleList g_operationList = { &g_operationList, &g_operationList };
 static uint32_t g_operationCount = 0;
-static pthread_mutex_t g_lock = PTHREAD_MUTEX_INITIALIZER;
+/* taken for reading to look an operation up, and for writing to add or remove one */
+static pthread_rwlock_t g_lock = PTHREAD_RWLOCK_INITIALIZER;
+
+static uint32_t GetOperationState(const struct HksOperation *operation)
+{
+    return __atomic_load_n(&operation->state, __ATOMIC_ACQUIRE);
+}
+
+/* on failure *expected is set to the current state */
+static bool CasOperationState(struct HksOperation *operation, uint32_t *expected, uint32_t desired)
+{
+    return __atomic_compare_exchange_n(&operation->state, expected, desired, false, __ATOMIC_ACQ_REL,
+        __ATOMIC_ACQUIRE);
+}
 
 static void DeleteKeyNode(uint64_t operationHandle)
 {
@@ -84,7 +98,7 @@ static void DeleteKeyNodeAndDecreaseGlobalCount(struct HksOperation *operation)
     DeleteKeyNode(operation->handle);
     FreeOperation(&operation);
     --g_operationCount;
-    HKS_LOG_I("delete operation count:%" LOG_PUBLIC "u", g_operationCount);
+    HKS_LOG_I_LIMITED("delete operation count:%" LOG_PUBLIC "u", g_operationCount);
 }
 
 /* Need to lock before calling DeleteFirstAbortableOperation */
@@ -96,7 +110,7 @@ static bool DeleteFirstAbortableOperation(void)
         if (operation == NULL) {
             continue;
         }
-        if (operation->isInUse) {
+        if (GetOperationState(operation) != HKS_OPERATION_IDLE) {
             HKS_LOG_W("DeleteFirstAbortableOperation can not delete using session! userIdInt %" LOG_PUBLIC "d",
                 operation->processInfo.userIdInt);
             continue;
@@ -131,7 +145,7 @@ static void DeleteFirstTimeOutBatchOperation(void)
         if (operation->batchOperationTimestamp >= curTime) {
             continue;
         }
-        if (operation->isInUse) {
+        if (GetOperationState(operation) != HKS_OPERATION_IDLE) {
             HKS_LOG_W("Batch operation timeout but is in use, not delete, userIdInt %" LOG_PUBLIC "d",
                 operation->processInfo.userIdInt);
             continue;
@@ -153,7 +167,7 @@ static bool DeleteFirstAbortableOperationForTokenId(uint32_t tokenId)
         if (operation == NULL || operation->accessTokenId != tokenId) {
             continue;
         }
-        if (operation->isInUse) {
+        if (GetOperationState(operation) != HKS_OPERATION_IDLE) {
             HKS_LOG_W("DeleteFirstAbortableOperationForTokenId can not delete using session! userIdInt %"
                 LOG_PUBLIC "d", operation->processInfo.userIdInt);
             continue;
@@ -191,7 +205,7 @@ static int32_t DeleteForTokenIdIfExceedLimit(uint32_t tokenId)
 
 static int32_t AddOperation(struct HksOperation *operation)
 {
-    pthread_mutex_lock(&g_lock);
+    pthread_rwlock_wrlock(&g_lock);
 
     int32_t ret = HKS_ERROR_SESSION_REACHED_LIMIT;
     do {
@@ -211,9 +225,9 @@ static int32_t AddOperation(struct HksOperation *operation)
 
         AddNodeAtDoubleListTail(&g_operationList, &operation->listHead);
         ++g_operationCount;
-        HKS_LOG_I("add operation count:%" LOG_PUBLIC "u", g_operationCount);
+        HKS_LOG_I_LIMITED("add operation count:%" LOG_PUBLIC "u", g_operationCount);
     } while (false);
-    pthread_mutex_unlock(&g_lock);
+    pthread_rwlock_unlock(&g_lock);
     return ret;
 }
 
@@ -318,7 +332,7 @@ int32_t CreateOperation(const struct HksProcessInfo *processInfo, const struct H
     }
 
     operation->abortable = abortable;
-    operation->isInUse = false;
+    operation->state = HKS_OPERATION_IDLE;
 
     if (paramSet != NULL) {
         ret = HksAddBatchTimeToOperation(paramSet, operation);
@@ -369,21 +383,21 @@ struct HksOperation *QueryOperationAndMarkInUse(const struct HksProcessInfo *pro
     HKS_IF_NOT_SUCC_LOGE_RETURN(ret, NULL, "construct handle failed when query operation")
 
     struct HksOperation *operation = NULL;
-    pthread_mutex_lock(&g_lock);
+    pthread_rwlock_rdlock(&g_lock);
     HKS_DLIST_ITER(operation, &g_operationList) {
         if ((operation != NULL) && (operation->handle == handle) && IsSameProcessName(processInfo, operation) &&
             IsSameUserId(processInfo, operation)) {
-            if (operation->isInUse) {
-                HKS_LOG_E("operation is in use!");
-                pthread_mutex_unlock(&g_lock);
+            uint32_t state = HKS_OPERATION_IDLE;
+            if (!CasOperationState(operation, &state, HKS_OPERATION_IN_USE)) {
+                HKS_LOG_E("operation is in use, state %" LOG_PUBLIC "u", state);
+                pthread_rwlock_unlock(&g_lock);
                 return NULL;
             }
-            operation->isInUse = true;
-            pthread_mutex_unlock(&g_lock);
+            pthread_rwlock_unlock(&g_lock);
             return operation;
         }
     }
-    pthread_mutex_unlock(&g_lock);
+    pthread_rwlock_unlock(&g_lock);
 
     return NULL;
 }
@@ -393,7 +407,14 @@ void MarkOperationUnUse(struct HksOperation *operation)
     if (operation == NULL) {
         return;
     }
-    operation->isInUse = false;
+    uint32_t state = HKS_OPERATION_IN_USE;
+    if (CasOperationState(operation, &state, HKS_OPERATION_IDLE) || state != HKS_OPERATION_ABORTING) {
+        return;
+    }
+    HKS_LOG_I("delete operation of a removed process once unused");
+    pthread_rwlock_wrlock(&g_lock);
+    DeleteKeyNodeAndDecreaseGlobalCount(operation);
+    pthread_rwlock_unlock(&g_lock);
 }
 
 void DeleteOperation(const struct HksBlob *operationHandle)
@@ -406,37 +427,42 @@ void DeleteOperation(const struct HksBlob *operationHandle)
     }
 
     struct HksOperation *operation = NULL;
-    pthread_mutex_lock(&g_lock);
+    pthread_rwlock_wrlock(&g_lock);
     HKS_DLIST_ITER(operation, &g_operationList) {
         if (operation != NULL && operation->handle == handle) {
-            if (operation->isInUse) {
+            if (GetOperationState(operation) != HKS_OPERATION_IDLE) {
                 HKS_LOG_I("operation is in use, do not delete");
                 break;
             }
             FreeOperation(&operation);
             --g_operationCount;
             HKS_LOG_D("delete operation count:%" LOG_PUBLIC "u", g_operationCount);
-            pthread_mutex_unlock(&g_lock);
+            pthread_rwlock_unlock(&g_lock);
             return;
         }
     }
-    pthread_mutex_unlock(&g_lock);
+    pthread_rwlock_unlock(&g_lock);
 }
 
+/* Need to lock for writing before calling DeleteSession, no operation can be marked in use meanwhile */
 static void DeleteSession(const struct HksProcessInfo *processInfo, struct HksOperation *operation)
 {
-    if (operation->isInUse) {
-        HKS_LOG_E("operation is in use, do not delete");
-        return;
-    }
     bool isNeedDelete = false;
     if (processInfo->processName.size == 0) { /* delete by user id */
         isNeedDelete = IsSameUserId(processInfo, operation);
     } else { /* delete by process name */
         isNeedDelete = IsSameUserId(processInfo, operation) && IsSameProcessName(processInfo, operation);
     }
+    if (!isNeedDelete) {
+        return;
+    }
 
-    if (isNeedDelete) {
+    uint32_t state = HKS_OPERATION_IN_USE;
+    if (CasOperationState(operation, &state, HKS_OPERATION_ABORTING)) {
+        HKS_LOG_I("operation is in use, delete it once unused");
+        return;
+    }
+    if (state == HKS_OPERATION_IDLE) {
         DeleteKeyNodeAndDecreaseGlobalCount(operation);
     }
 }
@@ -445,11 +471,11 @@ void DeleteSessionByProcessInfo(const struct HksProcessInfo *processInfo)
 {
     struct HksOperation *operation = NULL;
 
-    pthread_mutex_lock(&g_lock);
+    pthread_rwlock_wrlock(&g_lock);
     HKS_DLIST_SAFT_ITER(operation, &g_operationList) {
         if (operation != NULL) {
             DeleteSession(processInfo, operation);
         }
     }
-    pthread_mutex_unlock(&g_lock);
+    pthread_rwlock_unlock(&g_lock);
 }
@@ -25,8 +25,10 @@
 
 #include "huks_access.h"
 #include "hks_client_service_util.h"
+#include "hks_file_operator.h"
 #include "hks_log.h"
 #include "hks_mem.h"
+#include "hks_storage.h"
 #include "hks_template.h"
 #include "hks_type_inner.h"
 
@@ -60,4 +62,118 @@ int32_t HksDoUpgradeKeyAccess(const struct HksBlob *oldKey, const struct HksPara
     HksFreeParamSet(&paramSet);
     return ret;
 }
+
+static const uint32_t KEY_OWNER_TAGS[] = { HKS_TAG_PROCESS_NAME, HKS_TAG_USER_ID, HKS_TAG_ACCESS_TOKEN_ID };
+
+// an upgrade without a request runs as the key owner, whose identity is taken from the key file
+static int32_t ConstructKeyOwnerParamSet(const struct HksBlob *key, struct HksParamSet **outParamSet)
+{
+    struct HksParamSet *keyParamSet = NULL;
+    struct HksParamSet *paramSet = NULL;
+    int32_t ret;
+    do {
+        ret = HksGetParamSet((const struct HksParamSet *)key->data, key->size, &keyParamSet);
+        HKS_IF_NOT_SUCC_LOGE_BREAK(ret, "get key file paramSet failed!")
+
+        ret = HksInitParamSet(&paramSet);
+        HKS_IF_NOT_SUCC_LOGE_BREAK(ret, "init paramSet failed!")
+
+        for (uint32_t i = 0; i < HKS_ARRAY_SIZE(KEY_OWNER_TAGS); ++i) {
+            struct HksParam *param = NULL;
+            if (HksGetParam(keyParamSet, KEY_OWNER_TAGS[i], &param) != HKS_SUCCESS) {
+                continue;
+            }
+            ret = HksAddParams(paramSet, param, 1);
+            HKS_IF_NOT_SUCC_LOGE_BREAK(ret, "add owner param %" LOG_PUBLIC "u failed!", KEY_OWNER_TAGS[i])
+        }
+        HKS_IF_NOT_SUCC_BREAK(ret)
+
+        ret = HksBuildParamSet(&paramSet);
+        HKS_IF_NOT_SUCC_LOGE_BREAK(ret, "build paramSet failed!")
+    } while (0);
+    HksFreeParamSet(&keyParamSet);
+    if (ret != HKS_SUCCESS) {
+        HksFreeParamSet(&paramSet);
+        return ret;
+    }
+    *outParamSet = paramSet;
+    return HKS_SUCCESS;
+}
+
+static int32_t ReadKeyFile(const char *path, const char *fileName, struct HksBlob *key)
+{
+    uint32_t size = HksFileSize(path, fileName);
+    if (size == 0) {
+        return HKS_ERROR_NOT_EXIST;
+    }
+    if (size > MAX_KEY_SIZE) {
+        HKS_LOG_E("invalid key file size %" LOG_PUBLIC "u", size);
+        return HKS_ERROR_INVALID_KEY_FILE;
+    }
+    key->data = (uint8_t *)HksMalloc(size);
+    HKS_IF_NULL_LOGE_RETURN(key->data, HKS_ERROR_MALLOC_FAIL, "malloc key file buffer failed!")
+    key->size = size;
+
+    int32_t ret = HksStorageReadFile(path, fileName, 0, key, &size);
+    if (ret == HKS_SUCCESS) {
+        key->size = size;
+        ret = HksCheckParamSet((const struct HksParamSet *)key->data, key->size);
+    }
+    if (ret != HKS_SUCCESS) {
+        HKS_FREE_BLOB(*key);
+    }
+    return ret;
+}
+
+int32_t HksUpgradeKeyFileIfNeed(const char *path, const char *bakPath, const char *fileName, bool *isUpgraded,
+    uint32_t *ioSize)
+{
+    *isUpgraded = false;
+    *ioSize = 0;
+    struct HksBlob oldKey = { .size = 0, .data = NULL };
+    int32_t ret = ReadKeyFile(path, fileName, &oldKey);
+    HKS_IF_NOT_SUCC_RETURN(ret, ret)
+    *ioSize = oldKey.size;
+
+    struct HksBlob newKey = { .size = 0, .data = NULL };
+    struct HksParamSet *ownerParamSet = NULL;
+    do {
+        struct HksParam *keyVersion = NULL;
+        ret = HksGetParam((const struct HksParamSet *)oldKey.data, HKS_TAG_KEY_VERSION, &keyVersion);
+        HKS_IF_NOT_SUCC_LOGE_BREAK(ret, "get param key version failed!")
+        if (keyVersion->uint32Param == HKS_KEY_VERSION) {
+            break;
+        }
+        if (keyVersion->uint32Param == 0 || keyVersion->uint32Param > HKS_KEY_VERSION) {
+            ret = HKS_ERROR_BAD_STATE;
+            break;
+        }
+
+        ret = ConstructKeyOwnerParamSet(&oldKey, &ownerParamSet);
+        HKS_IF_NOT_SUCC_BREAK(ret)
+
+        newKey.data = (uint8_t *)HksMalloc(MAX_KEY_SIZE);
+        if (newKey.data == NULL) {
+            ret = HKS_ERROR_MALLOC_FAIL;
+            break;
+        }
+        newKey.size = MAX_KEY_SIZE;
+        ret = HksDoUpgradeKeyAccess(&oldKey, ownerParamSet, &newKey);
+        HKS_IF_NOT_SUCC_LOGE_BREAK(ret, "do upgrade access failed!")
+
+        // a key deleted or upgraded by a request since it was read is left as it is
+        ret = HksStorageReplaceFile(path, fileName, &oldKey, &newKey);
+        HKS_IF_NOT_SUCC_LOGE_BREAK(ret, "replace key file failed, ret = %" LOG_PUBLIC "d", ret)
+        *isUpgraded = true;
+        *ioSize += oldKey.size + newKey.size;
+
+        if (bakPath != NULL && HksStorageReplaceFile(bakPath, fileName, &oldKey, &newKey) == HKS_SUCCESS) {
+            *ioSize += oldKey.size + newKey.size;
+        }
+    } while (0);
+    HksFreeParamSet(&ownerParamSet);
+    HKS_FREE_BLOB(oldKey);
+    HKS_FREE_BLOB(newKey);
+    return ret;
+}
 #endif /* HKS_ENABLE_UPGRADE_KEY */
@@ -57,6 +57,13 @@ int32_t HksGetKeyCountByProcessName(const struct HksStoreFileInfo *fileInfo, uin
 int32_t HksStorageWriteFile(
     const char *path, const char *fileName, uint32_t offset, const uint8_t *buf, uint32_t len);
 
+int32_t HksStorageReadFile(
+    const char *path, const char *fileName, uint32_t offset, struct HksBlob *blob, uint32_t *size);
+
+// writes content only if the file still holds expected, HKS_ERROR_BAD_STATE if it changed since it was read
+int32_t HksStorageReplaceFile(const char *path, const char *fileName, const struct HksBlob *expected,
+    const struct HksBlob *content);
+
 #endif // _STORAGE_LITE_
 #endif // _CUT_AUTHENTICATE_
 
@@ -69,6 +76,14 @@ void HksServiceDeleteUserIDKeyAliasFile(const struct HksBlob *userId);
 
 void HksServiceDeleteUIDKeyAliasFile(const struct HksProcessInfo *processInfo);
 
+/* removes in the background the trash of app and user removals left in the de store by a crash */
+void HksServiceSweepDirTrash(void);
+
+#ifdef L2_STANDARD
+/* the same for the ce and ece stores of userId, which are readable once the user is unlocked */
+void HksServiceSweepUserDirTrash(uint32_t userId);
+#endif
+
 int32_t HksListAliasesByProcessName(const struct HksStoreFileInfo *fileInfo, struct HksKeyAliasSet **outData);
 
 #ifdef HKS_ENABLE_SMALL_TO_SERVICE
@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef HKS_STORAGE_ALIAS_INDEX_H
+#define HKS_STORAGE_ALIAS_INDEX_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "hks_type.h"
+
+#ifdef L2_STANDARD
+#define HKS_SUPPORT_ALIAS_INDEX
+#endif
+
+/*
+ * The alias index of a key directory lives next to it as "<dir>.idx". It holds the sorted file names of the
+ * directory together with the inode and mtime the directory had when the index was written, so an index that
+ * missed a change (crash between key write and index write) is detected and rebuilt from a directory scan.
+ * The mtime only ticks as often as the file system clock, so paths that add or remove files of the directory
+ * without Begin and End invalidate the index explicitly.
+ */
+#define HKS_ALIAS_INDEX_SUFFIX ".idx"
+
+struct HksAliasIndexList {
+    uint32_t count;
+    uint32_t size;
+    char *names; /* count NUL terminated file names in strcmp order */
+};
+
+struct HksAliasIndexUpdate {
+    const char *dirPath;
+    void *lock;
+    bool isFresh;
+    struct HksAliasIndexList list;
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+int32_t HksAliasIndexGetList(const char *dirPath, struct HksAliasIndexList *list);
+
+int32_t HksAliasIndexGetCount(const char *dirPath, uint32_t *count);
+
+void HksAliasIndexFreeList(struct HksAliasIndexList *list);
+
+/*
+ * Key writers call Begin before touching dirPath and End after it. The index lock is held in between, so the
+ * index can be patched in place instead of rebuilt: isDone tells whether fileName was really added or removed.
+ */
+void HksAliasIndexBeginUpdate(const char *dirPath, struct HksAliasIndexUpdate *update);
+
+void HksAliasIndexEndUpdate(struct HksAliasIndexUpdate *update, const char *fileName, bool isAdd, bool isDone);
+
+/* drops the index of dirPath after files were added or removed without Begin and End, the next list rebuilds it */
+void HksAliasIndexInvalidate(const char *dirPath);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HKS_STORAGE_ALIAS_INDEX_H */
@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef HKS_STORAGE_KEY_CACHE_H
+#define HKS_STORAGE_KEY_CACHE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "hks_type_inner.h"
+
+#ifdef L2_STANDARD
+#define HKS_SUPPORT_KEY_CACHE
+#endif
+
+/*
+ * In-memory cache of whether a key file exists, and of the content getKeyItemProperties read from it. The engine
+ * checks the validity of a cached key on every use, the cache only saves reading the file.
+ * Entries are keyed by the directory and the name of the key file. Writes and removes of key files through
+ * hks_storage update the entry of the file, directory removals and unlock events clear the whole cache. Files of
+ * the ECE store are never cached, they become unreadable whenever the screen locks.
+ *
+ * A lookup that misses returns a generation. The caller checks the file and fills the entry with that generation,
+ * the fill is dropped if any key file changed meanwhile, so a slow lookup never overwrites a newer state.
+ */
+enum HksKeyCacheState {
+    HKS_KEY_CACHE_UNKNOWN = 0,
+    HKS_KEY_CACHE_EXIST,
+    HKS_KEY_CACHE_NOT_EXIST,
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+enum HksKeyCacheState HksKeyCacheGetState(const char *path, const char *fileName, uint64_t *generation);
+
+void HksKeyCacheFillState(const char *path, const char *fileName, bool isExist, uint64_t generation);
+
+/* Called by the writers of key files with the file lock still held, drops the cached content of the file. */
+void HksKeyCacheSetState(const char *path, const char *fileName, bool isExist);
+
+/*
+ * The content is only returned to the caller that filled it: the access token and the user id are part of the
+ * identity check that reading the key file does. keyOut is allocated, the caller frees it.
+ */
+int32_t HksKeyCacheGetKey(const char *path, const char *fileName, const struct HksProcessInfo *processInfo,
+    struct HksBlob *keyOut, uint64_t *generation);
+
+void HksKeyCacheFillKey(const char *path, const char *fileName, const struct HksProcessInfo *processInfo,
+    const struct HksBlob *key, uint64_t generation);
+
+void HksKeyCacheClear(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HKS_STORAGE_KEY_CACHE_H */
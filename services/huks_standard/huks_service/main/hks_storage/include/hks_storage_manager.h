@@ -17,6 +17,7 @@
 #define HUKS_STORAGE_MANAGER_H
 
 #include "hks_storage_utils.h"
+#include "hks_storage_key_cache.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -46,6 +47,19 @@ int32_t HksManageGetKeyCountByProcessName(const struct HksProcessInfo *processIn
 int32_t HksManageListAliasesByProcessName(const struct HksProcessInfo *processInfo, const struct HksParamSet *paramSet,
     struct HksKeyAliasSet **outData);
 
+#ifdef HKS_SUPPORT_KEY_CACHE
+/*
+ * Copies the cached content of the key file to keyOut, which the caller frees. HKS_ERROR_NOT_EXIST means it is not
+ * cached, the caller then reads the key file and, once the engine accepted the key, passes it to
+ * HksManageStoreCacheKey with generation.
+ */
+int32_t HksManageStoreGetCachedKey(const struct HksProcessInfo *processInfo, const struct HksParamSet *paramSet,
+    const struct HksBlob *keyAlias, struct HksBlob *keyOut, uint64_t *generation);
+
+void HksManageStoreCacheKey(const struct HksProcessInfo *processInfo, const struct HksParamSet *paramSet,
+    const struct HksBlob *keyAlias, const struct HksBlob *key, uint64_t generation);
+#endif
+
 #ifdef __cplusplus
 }
 #endif
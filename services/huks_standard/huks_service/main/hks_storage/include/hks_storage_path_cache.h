@@ -0,0 +1,51 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef HKS_STORAGE_PATH_CACHE_H
+#define HKS_STORAGE_PATH_CACHE_H
+
+#include <stdint.h>
+
+#include "hks_storage_utils.h"
+
+#if defined(L2_STANDARD) && !defined(_STORAGE_LITE_)
+#define HKS_SUPPORT_PATH_CACHE
+#endif
+
+/*
+ * Cache of the key file directories HksGetFileInfo built and created, keyed by what they are derived from. A hit
+ * skips building the user and uid names, the check of the user directory and the stat of every path component,
+ * only the key alias is left to append. Entries are only added once the directories are known to exist, user
+ * removal, uninstall and HksStoreDestroy clear the cache.
+ *
+ * A lookup that misses returns a generation for the later put, the put is dropped if the cache was cleared
+ * meanwhile, so directories removed during a slow lookup are never cached.
+ */
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Copies the cached directories to the path buffers of fileInfo, HKS_ERROR_NOT_EXIST when they are not cached. */
+int32_t HksPathCacheGet(const struct HksStorePathKey *key, struct HksStoreFileInfo *fileInfo, uint64_t *generation);
+
+void HksPathCachePut(const struct HksStorePathKey *key, const struct HksStoreFileInfo *fileInfo, uint64_t generation);
+
+void HksPathCacheClear(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* HKS_STORAGE_PATH_CACHE_H */
@@ -16,6 +16,7 @@
 #ifndef HKS_STORAGE_UTILS_H
 #define HKS_STORAGE_UTILS_H
 
+#include <stdbool.h>
 #include <stdint.h>
 
 #include "hks_type_inner.h"
@@ -78,6 +79,15 @@ struct HksStoreMaterial {
     char *keyAliasPath;
 };
 
+/* everything the directory of a key file is derived from */
+struct HksStorePathKey {
+    enum HksPathType pathType;
+    int32_t userId;
+    uint32_t storageType;
+    bool isPlain;
+    const struct HksBlob *processName;
+};
+
 struct HksFileEntry {
     char *fileName;
     uint32_t fileNameLen;
@@ -87,8 +97,19 @@ enum KeyOperation {
     KEY_OPERATION_SAVE = 0,
     KEY_OPERATION_GET = 1,
     KEY_OPERATION_DELETE = 2,
+    KEY_OPERATION_MAX,
+};
+
+enum HksKeyOperationLogLevel {
+    HKS_KEY_OPERATION_LOG_ALL = 0,     /* every key operation is logged */
+    HKS_KEY_OPERATION_LOG_LIMITED = 1, /* the logs of each operation are rate limited */
+    HKS_KEY_OPERATION_LOG_COUNT = 2,   /* the operations are only counted, the counts logged now and then */
 };
 
+#ifndef HKS_KEY_OPERATION_LOG_LEVEL
+#define HKS_KEY_OPERATION_LOG_LEVEL HKS_KEY_OPERATION_LOG_LIMITED
+#endif
+
 int32_t ConstructPlainName(const struct HksBlob *blob, char *targetName, uint32_t nameLen);
 
 int32_t ConstructName(const struct HksBlob *blob, char *targetName, uint32_t nameLen);
@@ -101,8 +122,16 @@ int32_t HksFileInfoInit(struct HksStoreFileInfo *fileInfo);
 
 void FileInfoFree(struct HksStoreFileInfo *fileInfo);
 
+/* Sets the file name of fileInfoPath to keyAliasPath, a NULL keyAliasPath leaves it empty. */
+int32_t HksFileInfoSetName(struct HksStoreInfo *fileInfoPath, const char *keyAliasPath);
+
 int32_t RecordKeyOperation(uint32_t operation, const char *path, const char *keyAlias);
 
+void HksSetKeyOperationLogLevel(enum HksKeyOperationLogLevel level);
+
+/* the number of the key operations recorded since the start of the service, at any level */
+uint32_t HksGetKeyOperationCount(uint32_t operation);
+
 void FileNameListFree(struct HksFileEntry **fileNameList, uint32_t keyCount);
 
 int32_t FileNameListInit(struct HksFileEntry **fileNameList, uint32_t keyCount);
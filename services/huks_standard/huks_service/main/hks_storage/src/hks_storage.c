@@ -31,7 +31,10 @@
 #include "hks_file_operator.h"
 #include "hks_log.h"
 #include "hks_mem.h"
+#include "hks_storage_alias_index.h"
 #include "hks_storage_file_lock.h"
+#include "hks_storage_key_cache.h"
+#include "hks_storage_path_cache.h"
 #include "hks_template.h"
 #include "huks_access.h"
 #include "securec.h"
@@ -56,6 +59,36 @@ static HksStorageFileLock *CreateStorageFileLock(const char *path, const char *f
 }
 #endif
 
+// called with the file lock held, so the cache sees the changes of a file in the order they were made
+static void UpdateKeyCache(const char *path, const char *fileName, int32_t ret, bool isExistOnSuccess)
+{
+#ifdef HKS_SUPPORT_KEY_CACHE
+    bool isExist = (ret == HKS_SUCCESS) ? isExistOnSuccess : (HksIsFileExist(path, fileName) == HKS_SUCCESS);
+    HksKeyCacheSetState(path, fileName, isExist);
+#else
+    (void)path;
+    (void)fileName;
+    (void)ret;
+    (void)isExistOnSuccess;
+#endif
+}
+
+static int32_t IsKeyFileExist(const char *path, const char *fileName)
+{
+#ifdef HKS_SUPPORT_KEY_CACHE
+    uint64_t generation = 0;
+    enum HksKeyCacheState state = HksKeyCacheGetState(path, fileName, &generation);
+    if (state != HKS_KEY_CACHE_UNKNOWN) {
+        return (state == HKS_KEY_CACHE_EXIST) ? HKS_SUCCESS : HKS_ERROR_NOT_EXIST;
+    }
+    int32_t ret = HksIsFileExist(path, fileName);
+    HksKeyCacheFillState(path, fileName, ret == HKS_SUCCESS, generation);
+    return ret;
+#else
+    return HksIsFileExist(path, fileName);
+#endif
+}
+
 int32_t HksStorageWriteFile(
     const char *path, const char *fileName, uint32_t offset, const uint8_t *buf, uint32_t len)
 {
@@ -63,15 +96,18 @@ int32_t HksStorageWriteFile(
     HksStorageFileLock *lock = CreateStorageFileLock(path, fileName);
     HksStorageFileLockWrite(lock);
     int32_t ret = HksFileWrite(path, fileName, offset, buf, len);
+    UpdateKeyCache(path, fileName, ret, true);
     HksStorageFileUnlockWrite(lock);
     HksStorageFileLockRelease(lock);
     return ret;
 #else
-    return HksFileWrite(path, fileName, offset, buf, len);
+    int32_t ret = HksFileWrite(path, fileName, offset, buf, len);
+    UpdateKeyCache(path, fileName, ret, true);
+    return ret;
 #endif
 }
 
-static int32_t HksStorageReadFile(
+int32_t HksStorageReadFile(
     const char *path, const char *fileName, uint32_t offset, struct HksBlob *blob, uint32_t *size)
 {
 #ifdef HKS_SUPPORT_THREAD
@@ -86,6 +122,46 @@ static int32_t HksStorageReadFile(
     return ret;
 }
 
+static int32_t ReplaceFileIfUnchanged(const char *path, const char *fileName, const struct HksBlob *expected,
+    const struct HksBlob *content)
+{
+    uint32_t size = HksFileSize(path, fileName);
+    if (size == 0) {
+        return HKS_ERROR_NOT_EXIST;
+    }
+    if (size != expected->size) {
+        return HKS_ERROR_BAD_STATE;
+    }
+    struct HksBlob current = { .size = size, .data = (uint8_t *)HksMalloc(size) };
+    HKS_IF_NULL_LOGE_RETURN(current.data, HKS_ERROR_MALLOC_FAIL, "malloc current file buffer failed.")
+
+    int32_t ret = HksFileRead(path, fileName, 0, &current, &size);
+    if (ret == HKS_SUCCESS && (size != expected->size || HksMemCmp(current.data, expected->data, size) != EOK)) {
+        ret = HKS_ERROR_BAD_STATE;
+    }
+    HKS_FREE_BLOB(current);
+    HKS_IF_NOT_SUCC_RETURN(ret, ret)
+
+    return HksFileWrite(path, fileName, 0, content->data, content->size);
+}
+
+int32_t HksStorageReplaceFile(const char *path, const char *fileName, const struct HksBlob *expected,
+    const struct HksBlob *content)
+{
+#ifdef HKS_SUPPORT_THREAD
+    HksStorageFileLock *lock = CreateStorageFileLock(path, fileName);
+    HksStorageFileLockWrite(lock);
+    int32_t ret = ReplaceFileIfUnchanged(path, fileName, expected, content);
+    UpdateKeyCache(path, fileName, ret, true);
+    HksStorageFileUnlockWrite(lock);
+    HksStorageFileLockRelease(lock);
+#else
+    int32_t ret = ReplaceFileIfUnchanged(path, fileName, expected, content);
+    UpdateKeyCache(path, fileName, ret, true);
+#endif
+    return ret;
+}
+
 #ifdef HKS_ENABLE_CLEAN_FILE
 static int32_t CleanFile(const char *path, const char *fileName)
 {
@@ -140,10 +216,12 @@ static int32_t HksStorageRemoveFile(const char *path, const char *fileName)
     HksStorageFileLock *lock = CreateStorageFileLock(path, fileName);
     HksStorageFileLockWrite(lock);
     ret = HksFileRemove(path, fileName);
+    UpdateKeyCache(path, fileName, ret, false);
     HksStorageFileUnlockWrite(lock);
     HksStorageFileLockRelease(lock);
 #else
     ret = HksFileRemove(path, fileName);
+    UpdateKeyCache(path, fileName, ret, false);
 #endif
     return ret;
 }
@@ -213,10 +291,10 @@ static int32_t GetKeyBlobFromFile(const char *path, const char *fileName, struct
 
 static int32_t DeleteKeyBlob(const struct HksStoreFileInfo *fileInfo)
 {
-    int32_t isMainFileExist = HksIsFileExist(fileInfo->mainPath.path, fileInfo->mainPath.fileName);
+    int32_t isMainFileExist = IsKeyFileExist(fileInfo->mainPath.path, fileInfo->mainPath.fileName);
     int32_t ret = HKS_SUCCESS;
 #ifdef SUPPORT_STORAGE_BACKUP
-    int32_t isBakFileExist = HksIsFileExist(fileInfo->bakPath.path, fileInfo->bakPath.fileName);
+    int32_t isBakFileExist = IsKeyFileExist(fileInfo->bakPath.path, fileInfo->bakPath.fileName);
     if ((isMainFileExist != HKS_SUCCESS) && (isBakFileExist != HKS_SUCCESS)) {
         return HKS_ERROR_NOT_EXIST;
     }
@@ -238,7 +316,7 @@ static int32_t DeleteKeyBlob(const struct HksStoreFileInfo *fileInfo)
 
 static int32_t GetKeyBlob(const struct HksStoreInfo *fileInfoPath, struct HksBlob *keyBlob)
 {
-    int32_t isFileExist = HksIsFileExist(fileInfoPath->path, fileInfoPath->fileName);
+    int32_t isFileExist = IsKeyFileExist(fileInfoPath->path, fileInfoPath->fileName);
     HKS_IF_NOT_SUCC_RETURN(isFileExist, HKS_ERROR_NOT_EXIST)
 
     int32_t ret = GetKeyBlobFromFile(fileInfoPath->path, fileInfoPath->fileName, keyBlob);
@@ -247,7 +325,7 @@ static int32_t GetKeyBlob(const struct HksStoreInfo *fileInfoPath, struct HksBlo
 
 static int32_t GetKeyBlobSize(const struct HksStoreInfo *fileInfoPath, uint32_t *keyBlobSize)
 {
-    int32_t isFileExist = HksIsFileExist(fileInfoPath->path, fileInfoPath->fileName);
+    int32_t isFileExist = IsKeyFileExist(fileInfoPath->path, fileInfoPath->fileName);
     HKS_IF_NOT_SUCC_RETURN(isFileExist, HKS_ERROR_NOT_EXIST)
 
     uint32_t size = HksFileSize(fileInfoPath->path, fileInfoPath->fileName);
@@ -260,18 +338,24 @@ static int32_t GetKeyBlobSize(const struct HksStoreInfo *fileInfoPath, uint32_t
 
 static int32_t IsKeyBlobExist(const struct HksStoreFileInfo *fileInfo)
 {
-    int32_t isMainFileExist = HksIsFileExist(fileInfo->mainPath.path, fileInfo->mainPath.fileName);
+    int32_t isMainFileExist = IsKeyFileExist(fileInfo->mainPath.path, fileInfo->mainPath.fileName);
 #ifndef SUPPORT_STORAGE_BACKUP
     HKS_IF_NOT_SUCC_RETURN(isMainFileExist, HKS_ERROR_NOT_EXIST)
 #else
     if (isMainFileExist != HKS_SUCCESS) {
-        int32_t isBakFileExist = HksIsFileExist(fileInfo->bakPath.path, fileInfo->bakPath.fileName);
+        int32_t isBakFileExist = IsKeyFileExist(fileInfo->bakPath.path, fileInfo->bakPath.fileName);
         HKS_IF_NOT_SUCC_LOGE_RETURN(isBakFileExist, HKS_ERROR_NOT_EXIST, "hks mainkey and backupkey not exist")
 
-        if (CopyKeyBlobFromSrc(fileInfo->bakPath.path, fileInfo->bakPath.fileName,
-            fileInfo->mainPath.path, fileInfo->mainPath.fileName) != HKS_SUCCESS) {
-                HKS_LOG_E("hks copy bak key to main key failed");
-            }
+#ifdef HKS_SUPPORT_ALIAS_INDEX
+        struct HksAliasIndexUpdate update;
+        HksAliasIndexBeginUpdate(fileInfo->mainPath.path, &update);
+#endif
+        int32_t ret = CopyKeyBlobFromSrc(fileInfo->bakPath.path, fileInfo->bakPath.fileName,
+            fileInfo->mainPath.path, fileInfo->mainPath.fileName);
+        HKS_IF_NOT_SUCC_LOGE(ret, "hks copy bak key to main key failed")
+#ifdef HKS_SUPPORT_ALIAS_INDEX
+        HksAliasIndexEndUpdate(&update, fileInfo->mainPath.fileName, true, ret == HKS_SUCCESS);
+#endif
     }
 #endif
     return HKS_SUCCESS;
@@ -284,8 +368,21 @@ int32_t HksStoreKeyBlob(const struct HksStoreFileInfo *fileInfo, const struct Hk
         ret = RecordKeyOperation(KEY_OPERATION_SAVE, fileInfo->mainPath.path, fileInfo->mainPath.fileName);
         HKS_IF_NOT_SUCC_BREAK(ret)
 
+#ifdef HKS_SUPPORT_ALIAS_INDEX
+        struct HksAliasIndexUpdate update;
+        HksAliasIndexBeginUpdate(fileInfo->mainPath.path, &update);
+#endif
         ret = HksStorageWriteFile(fileInfo->mainPath.path, fileInfo->mainPath.fileName, 0,
             keyBlob->data, keyBlob->size);
+#ifdef HKS_SUPPORT_ALIAS_INDEX
+        HksAliasIndexEndUpdate(&update, fileInfo->mainPath.fileName, true, ret == HKS_SUCCESS);
+#endif
+#ifdef HKS_SUPPORT_PATH_CACHE
+        if (ret != HKS_SUCCESS) {
+            // the directory may be gone behind the cache, the next request makes it again
+            HksPathCacheClear();
+        }
+#endif
         HKS_IF_NOT_SUCC_LOGE_BREAK(ret, "hks save main key blob failed, ret = %" LOG_PUBLIC "d.", ret)
 
 #ifdef SUPPORT_STORAGE_BACKUP
@@ -306,7 +403,14 @@ int32_t HksStoreDeleteKeyBlob(const struct HksStoreFileInfo *fileInfo)
         ret = RecordKeyOperation(KEY_OPERATION_DELETE, fileInfo->mainPath.path, fileInfo->mainPath.fileName);
         HKS_IF_NOT_SUCC_BREAK(ret)
 
+#ifdef HKS_SUPPORT_ALIAS_INDEX
+        struct HksAliasIndexUpdate update;
+        HksAliasIndexBeginUpdate(fileInfo->mainPath.path, &update);
+        ret = DeleteKeyBlob(fileInfo);
+        HksAliasIndexEndUpdate(&update, fileInfo->mainPath.fileName, false, ret == HKS_SUCCESS);
+#else
         ret = DeleteKeyBlob(fileInfo);
+#endif
     } while (0);
 
     return ret;
@@ -348,6 +452,7 @@ int32_t HksStoreGetKeyBlobSize(const struct HksStoreInfo *fileInfoPath, uint32_t
     return ret;
 }
 
+#if !defined(HKS_SUPPORT_ALIAS_INDEX) || defined(HKS_ENABLE_SMALL_TO_SERVICE)
 static int32_t GetFileCount(const char *path, uint32_t *fileCount)
 {
     if ((path == NULL) || (fileCount == NULL)) {
@@ -373,7 +478,42 @@ static int32_t GetFileCount(const char *path, uint32_t *fileCount)
 
     return HKS_SUCCESS;
 }
+#endif
 
+#ifdef HKS_SUPPORT_ALIAS_INDEX
+static int32_t GetKeyAliasByProcessName(const struct HksStoreFileInfo *fileInfo, struct HksKeyInfo *keyInfoList,
+    uint32_t *listCount)
+{
+    struct HksAliasIndexList list;
+    int32_t ret = HksAliasIndexGetList(fileInfo->mainPath.path, &list);
+    HKS_IF_NOT_SUCC_LOGE_RETURN(ret, ret, "get alias index failed, ret = %" LOG_PUBLIC "d.", ret)
+
+    do {
+        if (*listCount < list.count) {
+            HKS_LOG_E("listCount space not enough");
+            ret = HKS_ERROR_BUFFER_TOO_SMALL;
+            break;
+        }
+
+        const char *name = list.names;
+        for (uint32_t i = 0; i < list.count; ++i) {
+            ret = ConstructBlob(name, &(keyInfoList[i].alias));
+            HKS_IF_NOT_SUCC_LOGE_BREAK(ret, "construct blob failed, ret = %" LOG_PUBLIC "d", ret)
+            name += strlen(name) + 1;
+        }
+        HKS_IF_NOT_SUCC_BREAK(ret)
+        *listCount = list.count;
+    } while (0);
+
+    HksAliasIndexFreeList(&list);
+    return ret;
+}
+
+static int32_t GetKeyCount(const char *path, uint32_t *fileCount)
+{
+    return HksAliasIndexGetCount(path, fileCount);
+}
+#else
 static int32_t GetFileNameList(const char *path, struct HksFileEntry *fileNameList, uint32_t *fileCount)
 {
     if ((path == NULL) || (fileCount == NULL) || (fileNameList == NULL)) {
@@ -459,6 +599,12 @@ static int32_t GetKeyAliasByProcessName(const struct HksStoreFileInfo *fileInfo,
     return ret;
 }
 
+static int32_t GetKeyCount(const char *path, uint32_t *fileCount)
+{
+    return GetFileCount(path, fileCount);
+}
+#endif
+
 int32_t HksGetKeyAliasByProcessName(const struct HksStoreFileInfo *fileInfo, struct HksKeyInfo *keyInfoList,
     uint32_t *listCount)
 {
@@ -475,7 +621,7 @@ int32_t HksGetKeyCountByProcessName(const struct HksStoreFileInfo *fileInfo, uin
 {
     int32_t ret;
     do {
-        ret = GetFileCount(fileInfo->mainPath.path, fileCount);
+        ret = GetKeyCount(fileInfo->mainPath.path, fileCount);
         HKS_IF_NOT_SUCC_LOGE_BREAK(ret, "get storage file count failed, ret = %" LOG_PUBLIC "d.", ret)
     } while (0);
 
@@ -561,6 +707,12 @@ int32_t HksStoreDestroy(const struct HksBlob *processName)
 #endif
     } while (0);
 
+#ifdef HKS_SUPPORT_KEY_CACHE
+    HksKeyCacheClear();
+#endif
+#ifdef HKS_SUPPORT_PATH_CACHE
+    HksPathCacheClear();
+#endif
     HKS_FREE(name);
     return ret;
 }
@@ -581,7 +733,7 @@ static void DeleteUserIdMainPathAndBakPath(const char *userData, const char *deD
         deDataPath, userData);
     if (offset > 0) {
         HKS_LOG_I("delete path: %" LOG_PUBLIC "s", dePath);
-        (void)HksDeleteDir(dePath);
+        (void)HksDeleteDirAsync(dePath);
     } else {
         HKS_LOG_E("get de path failed");
     }
@@ -591,7 +743,7 @@ static void DeleteUserIdMainPathAndBakPath(const char *userData, const char *deD
         HKS_CE_ROOT_PATH, userData, ceOrEceDataPath);
     if (offset > 0) {
         HKS_LOG_I("delete path: %" LOG_PUBLIC "s", cePath);
-        (void)HksDeleteDir(cePath);
+        (void)HksDeleteDirAsync(cePath);
     } else {
         HKS_LOG_E("get ce path failed");
     }
@@ -601,7 +753,7 @@ static void DeleteUserIdMainPathAndBakPath(const char *userData, const char *deD
         HKS_ECE_ROOT_PATH, userData, ceOrEceDataPath);
     if (offset > 0) {
         HKS_LOG_I("delete path: %" LOG_PUBLIC "s", ecePath);
-        (void)HksDeleteDir(ecePath);
+        (void)HksDeleteDirAsync(ecePath);
     } else {
         HKS_LOG_E("get ece path failed");
     }
@@ -635,7 +787,7 @@ static void DeleteUidMainPathAndBakPath(const char *userData, const char *uidDat
         deDataPath, userData, uidData);
     if (offset > 0) {
         HKS_LOG_I("delete path: %" LOG_PUBLIC "s", dePath);
-        (void)HksDeleteDir(dePath);
+        (void)HksDeleteDirAsync(dePath);
     } else {
         HKS_LOG_E("get de path failed");
     }
@@ -645,7 +797,7 @@ static void DeleteUidMainPathAndBakPath(const char *userData, const char *uidDat
         HKS_CE_ROOT_PATH, userData, ceOrEceDataPath, uidData);
     if (offset > 0) {
         HKS_LOG_I("delete path: %" LOG_PUBLIC "s", cePath);
-        (void)HksDeleteDir(cePath);
+        (void)HksDeleteDirAsync(cePath);
     } else {
         HKS_LOG_E("get ce path failed");
     }
@@ -655,7 +807,7 @@ static void DeleteUidMainPathAndBakPath(const char *userData, const char *uidDat
         HKS_ECE_ROOT_PATH, userData, ceOrEceDataPath, uidData);
     if (offset > 0) {
         HKS_LOG_I("delete path: %" LOG_PUBLIC "s", ecePath);
-        (void)HksDeleteDir(ecePath);
+        (void)HksDeleteDirAsync(ecePath);
     } else {
         HKS_LOG_E("get ece path failed");
     }
@@ -711,12 +863,19 @@ void HksServiceDeleteUserIDKeyAliasFile(const struct HksBlob *userId)
         }
 
         // ignore these results for ensure to clear data as most as possible
-        ret = HksDeleteDir(userProcess);
+        ret = HksDeleteDirAsync(userProcess);
         HKS_IF_NOT_SUCC_LOGE(ret, "delete de path: %" LOG_PUBLIC "s failed, ret = %" LOG_PUBLIC "d", userProcess, ret)
 #ifdef L2_STANDARD
         (void)DeleteUserIdPath(userId);
 #endif
     } while (0);
+#ifdef HKS_SUPPORT_KEY_CACHE
+    // the directories are renamed away already, so no key of them is found again once the cache is cleared
+    HksKeyCacheClear();
+#endif
+#ifdef HKS_SUPPORT_PATH_CACHE
+    HksPathCacheClear();
+#endif
     HKS_FREE(userData);
 }
 
@@ -757,16 +916,112 @@ void HksServiceDeleteUIDKeyAliasFile(const struct HksProcessInfo *processInfo)
         HKS_LOG_I("delete path : %" LOG_PUBLIC "s", userProcess);
 
         // ignore these results for ensure to clear data as most as possible
-        ret = HksDeleteDir(userProcess);
+        ret = HksDeleteDirAsync(userProcess);
         HKS_IF_NOT_SUCC_LOGE(ret, "delete de path: %" LOG_PUBLIC "s failed, ret = %" LOG_PUBLIC "d", userProcess, ret)
 #ifdef L2_STANDARD
         (void)DeleteUidPath(processInfo);
 #endif
     } while (0);
+#ifdef HKS_SUPPORT_KEY_CACHE
+    HksKeyCacheClear();
+#endif
+#ifdef HKS_SUPPORT_PATH_CACHE
+    HksPathCacheClear();
+#endif
     HKS_FREE(userData);
     HKS_FREE(uidData);
 }
 
+/* the removals above return once their dirs are trash, the trash a crash left is found here */
+void HksServiceSweepDirTrash(void)
+{
+    // the trash of a user is in the root, the trash of an app in the dir of its user
+    (void)HksSweepDirTrashAsync(HKS_KEY_STORE_PATH, true);
+#ifdef SUPPORT_STORAGE_BACKUP
+    (void)HksSweepDirTrashAsync(HKS_KEY_STORE_BAK_PATH, true);
+#endif
+}
+
+#ifdef L2_STANDARD
+static void SweepUserDirTrash(const char *rootPath, uint32_t userId, const char *storePath)
+{
+    char path[HKS_MAX_DIRENT_FILE_LEN] = "";
+    if (sprintf_s(path, HKS_MAX_DIRENT_FILE_LEN, "%s/%u/%s", rootPath, userId, storePath) < 0) {
+        HKS_LOG_E("get sweep path failed");
+        return;
+    }
+    (void)HksSweepDirTrashAsync(path, false);
+}
+
+void HksServiceSweepUserDirTrash(uint32_t userId)
+{
+    SweepUserDirTrash(HKS_CE_ROOT_PATH, userId, HKS_STORE_SERVICE_PATH);
+    SweepUserDirTrash(HKS_ECE_ROOT_PATH, userId, HKS_STORE_SERVICE_PATH);
+#ifdef SUPPORT_STORAGE_BACKUP
+    SweepUserDirTrash(HKS_CE_ROOT_PATH, userId, HKS_STORE_SERVICE_BAK_PATH);
+    SweepUserDirTrash(HKS_ECE_ROOT_PATH, userId, HKS_STORE_SERVICE_BAK_PATH);
+#endif
+}
+#endif
+
+#ifdef HKS_SUPPORT_ALIAS_INDEX
+int32_t HksListAliasesByProcessName(const struct HksStoreFileInfo *fileInfo, struct HksKeyAliasSet **outData)
+{
+    struct HksAliasIndexList list;
+    int32_t ret = HksAliasIndexGetList(fileInfo->mainPath.path, &list);
+    HKS_IF_NOT_SUCC_LOGE_RETURN(ret, ret, "get alias index failed, ret = %" LOG_PUBLIC "d.", ret)
+    if (list.count == 0) {
+        HksAliasIndexFreeList(&list);
+        return HKS_SUCCESS;
+    }
+
+    struct HksKeyAliasSet *tempAliasSet = NULL;
+    do {
+        if (list.count > HKS_MAX_KEY_ALIAS_COUNT) {
+            HKS_LOG_E("file count too long, count = %" LOG_PUBLIC "u.", list.count);
+            ret = HKS_ERROR_BUFFER_TOO_SMALL;
+            break;
+        }
+        tempAliasSet = (struct HksKeyAliasSet *)HksMalloc(sizeof(struct HksKeyAliasSet));
+        if (tempAliasSet == NULL) {
+            HKS_LOG_E("malloc key alias set failed");
+            ret = HKS_ERROR_MALLOC_FAIL;
+            break;
+        }
+        tempAliasSet->aliasesCnt = list.count;
+        tempAliasSet->aliases = (struct HksBlob *)HksMalloc(list.count * sizeof(struct HksBlob));
+        if (tempAliasSet->aliases == NULL) {
+            HKS_LOG_E("malloc aliases fail");
+            ret = HKS_ERROR_MALLOC_FAIL;
+            break;
+        }
+
+        const char *name = list.names;
+        for (uint32_t i = 0; i < list.count; i++) {
+            uint32_t size = strlen(name);
+            tempAliasSet->aliases[i].size = size;
+            tempAliasSet->aliases[i].data = (uint8_t *)HksMalloc(size);
+            if (tempAliasSet->aliases[i].data == NULL) {
+                HKS_LOG_E("malloc alias %" LOG_PUBLIC "d fail", i);
+                ret = HKS_ERROR_MALLOC_FAIL;
+                break;
+            }
+
+            ret = ConstructBlob(name, &(tempAliasSet->aliases[i]));
+            HKS_IF_NOT_SUCC_LOGE_BREAK(ret, "construct blob failed, ret = %" LOG_PUBLIC "d", ret)
+            name += size + 1;
+        }
+    } while (0);
+
+    HksAliasIndexFreeList(&list);
+    if (ret != HKS_SUCCESS) {
+        HksFreeKeyAliasSet(tempAliasSet);
+        return ret;
+    }
+    *outData = tempAliasSet;
+    return ret;
+}
+#else
 static int32_t GetHksKeyAliasSet(const struct HksFileEntry *fileNameList, const uint32_t fileCount,
     struct HksKeyAliasSet **outData)
 {
@@ -867,6 +1122,7 @@ int32_t HksListAliasesByProcessName(const struct HksStoreFileInfo *fileInfo, str
     }
     return ret;
 }
+#endif /* HKS_SUPPORT_ALIAS_INDEX */
 
 #endif
 #endif /* _CUT_AUTHENTICATE_ */
@@ -0,0 +1,509 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _CUT_AUTHENTICATE_
+
+#ifdef HKS_CONFIG_FILE
+#include HKS_CONFIG_FILE
+#else
+#include "hks_config.h"
+#endif
+
+#include "hks_storage_alias_index.h"
+
+#ifdef HKS_SUPPORT_ALIAS_INDEX
+
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+
+#include "hks_file_operator.h"
+#include "hks_log.h"
+#include "hks_mem.h"
+#include "hks_storage_file_lock.h"
+#include "hks_template.h"
+#include "securec.h"
+
+#define HKS_ALIAS_INDEX_MAGIC 0x49534b48 /* "HKSI" */
+#define HKS_ALIAS_INDEX_VERSION 1
+#define HKS_ALIAS_INDEX_TMP_SUFFIX HKS_ALIAS_INDEX_SUFFIX ".tmp"
+#define HKS_ALIAS_INDEX_SCAN_INIT_SIZE 1024
+#define HKS_ALIAS_INDEX_MAX_SIZE (HKS_MAX_KEY_ALIAS_COUNT * HKS_MAX_FILE_NAME_LEN)
+#define FNV_OFFSET_BASIS 0x811c9dc5
+#define FNV_PRIME 0x01000193
+
+struct HksAliasIndexStamp {
+    uint64_t ino;
+    int64_t mtimeSec;
+    int64_t mtimeNsec;
+};
+
+struct HksAliasIndexHeader {
+    uint32_t magic;
+    uint32_t version;
+    struct HksAliasIndexStamp stamp;
+    uint32_t count;
+    uint32_t namesSize;
+    uint32_t namesChecksum;
+    uint32_t headerChecksum; /* covers every field above */
+};
+
+static uint32_t Checksum(const uint8_t *data, uint32_t size)
+{
+    uint32_t hash = FNV_OFFSET_BASIS;
+    for (uint32_t i = 0; i < size; ++i) {
+        hash = (hash ^ data[i]) * FNV_PRIME;
+    }
+    return hash;
+}
+
+static int32_t GetIndexPath(const char *dirPath, const char *suffix, char *indexPath, uint32_t pathLen)
+{
+    uint32_t dirLen = strlen(dirPath);
+    while (dirLen > 1 && dirPath[dirLen - 1] == '/') {
+        --dirLen;
+    }
+    if (sprintf_s(indexPath, pathLen, "%.*s%s", (int)dirLen, dirPath, suffix) <= 0) {
+        HKS_LOG_E("get alias index path failed");
+        return HKS_ERROR_INSUFFICIENT_MEMORY;
+    }
+    return HKS_SUCCESS;
+}
+
+static int32_t GetDirStamp(const char *dirPath, struct HksAliasIndexStamp *stamp)
+{
+    struct stat dirStat;
+    (void)memset_s(&dirStat, sizeof(dirStat), 0, sizeof(dirStat));
+    if (stat(dirPath, &dirStat) != 0 || !S_ISDIR(dirStat.st_mode)) {
+        return HKS_ERROR_NOT_EXIST;
+    }
+    stamp->ino = (uint64_t)dirStat.st_ino;
+    stamp->mtimeSec = (int64_t)dirStat.st_mtim.tv_sec;
+    stamp->mtimeNsec = (int64_t)dirStat.st_mtim.tv_nsec;
+    return HKS_SUCCESS;
+}
+
+static bool IsSameStamp(const struct HksAliasIndexStamp *a, const struct HksAliasIndexStamp *b)
+{
+    return (a->ino == b->ino) && (a->mtimeSec == b->mtimeSec) && (a->mtimeNsec == b->mtimeNsec);
+}
+
+static void LockIndex(void **lock, const char *indexPath, bool isWrite)
+{
+#ifdef HKS_SUPPORT_THREAD
+    *lock = HksStorageFileLockCreate(indexPath);
+    if (isWrite) {
+        (void)HksStorageFileLockWrite((HksStorageFileLock *)*lock);
+    } else {
+        (void)HksStorageFileLockRead((HksStorageFileLock *)*lock);
+    }
+#else
+    (void)indexPath;
+    (void)isWrite;
+    *lock = NULL;
+#endif
+}
+
+static void UnlockIndex(void **lock, bool isWrite)
+{
+#ifdef HKS_SUPPORT_THREAD
+    if (*lock == NULL) {
+        return;
+    }
+    if (isWrite) {
+        (void)HksStorageFileUnlockWrite((HksStorageFileLock *)*lock);
+    } else {
+        (void)HksStorageFileUnlockRead((HksStorageFileLock *)*lock);
+    }
+    HksStorageFileLockRelease((HksStorageFileLock *)*lock);
+#else
+    (void)isWrite;
+#endif
+    *lock = NULL;
+}
+
+static int32_t CheckNames(const char *names, uint32_t size, uint32_t count)
+{
+    if (size == 0) {
+        return (count == 0) ? HKS_SUCCESS : HKS_ERROR_INVALID_KEY_FILE;
+    }
+    if (names[size - 1] != '\0') {
+        return HKS_ERROR_INVALID_KEY_FILE;
+    }
+    uint32_t nameCount = 0;
+    for (uint32_t i = 0; i < size; ++i) {
+        nameCount += (names[i] == '\0') ? 1 : 0;
+    }
+    return (nameCount == count) ? HKS_SUCCESS : HKS_ERROR_INVALID_KEY_FILE;
+}
+
+static int32_t CheckHeader(const struct HksAliasIndexHeader *header, const struct HksAliasIndexStamp *stamp,
+    uint32_t fileSize)
+{
+    if (header->magic != HKS_ALIAS_INDEX_MAGIC || header->version != HKS_ALIAS_INDEX_VERSION ||
+        header->headerChecksum != Checksum((const uint8_t *)header, offsetof(struct HksAliasIndexHeader,
+        headerChecksum)) || header->namesSize != fileSize - sizeof(*header)) {
+        return HKS_ERROR_INVALID_KEY_FILE;
+    }
+    return IsSameStamp(&header->stamp, stamp) ? HKS_SUCCESS : HKS_ERROR_NOT_EXIST;
+}
+
+/* loads the header only when list is NULL, the names are moved to the front of the read buffer */
+static int32_t ReadIndex(const char *indexPath, const struct HksAliasIndexStamp *stamp,
+    struct HksAliasIndexList *list, uint32_t *count)
+{
+    struct HksAliasIndexHeader header;
+    uint32_t fileSize = HksFileSize(NULL, indexPath);
+    if (fileSize < sizeof(header) || fileSize > HKS_ALIAS_INDEX_MAX_SIZE) {
+        return HKS_ERROR_NOT_EXIST;
+    }
+    uint32_t readSize = (list == NULL) ? sizeof(header) : fileSize;
+    uint8_t *buf = (uint8_t *)HksMalloc(readSize);
+    HKS_IF_NULL_RETURN(buf, HKS_ERROR_MALLOC_FAIL)
+
+    int32_t ret;
+    do {
+        struct HksBlob blob = { readSize, buf };
+        uint32_t size = readSize;
+        ret = HksFileRead(NULL, indexPath, 0, &blob, &size);
+        if (ret != HKS_SUCCESS || size != readSize) {
+            ret = HKS_ERROR_READ_FILE_FAIL;
+            break;
+        }
+        (void)memcpy_s(&header, sizeof(header), buf, sizeof(header));
+        ret = CheckHeader(&header, stamp, fileSize);
+        HKS_IF_NOT_SUCC_BREAK(ret)
+        *count = header.count;
+        if (list == NULL) {
+            break;
+        }
+
+        char *names = (char *)(buf + sizeof(header));
+        if (Checksum((const uint8_t *)names, header.namesSize) != header.namesChecksum) {
+            ret = HKS_ERROR_INVALID_KEY_FILE;
+            break;
+        }
+        ret = CheckNames(names, header.namesSize, header.count);
+        HKS_IF_NOT_SUCC_BREAK(ret)
+
+        if (header.namesSize != 0) {
+            (void)memmove_s(buf, readSize, names, header.namesSize);
+        }
+        list->count = header.count;
+        list->size = header.namesSize;
+        list->names = (char *)buf;
+        return HKS_SUCCESS;
+    } while (0);
+
+    HKS_FREE(buf);
+    return ret;
+}
+
+/* write to a temporary file and rename it over the index, a crash leaves either the old or the new index */
+static int32_t WriteIndex(const char *dirPath, const struct HksAliasIndexStamp *stamp,
+    const struct HksAliasIndexList *list)
+{
+    char indexPath[HKS_MAX_FILE_NAME_LEN] = { 0 };
+    char tmpPath[HKS_MAX_FILE_NAME_LEN] = { 0 };
+    int32_t ret = GetIndexPath(dirPath, HKS_ALIAS_INDEX_SUFFIX, indexPath, sizeof(indexPath));
+    HKS_IF_NOT_SUCC_RETURN(ret, ret)
+    ret = GetIndexPath(dirPath, HKS_ALIAS_INDEX_TMP_SUFFIX, tmpPath, sizeof(tmpPath));
+    HKS_IF_NOT_SUCC_RETURN(ret, ret)
+
+    struct HksAliasIndexHeader header;
+    (void)memset_s(&header, sizeof(header), 0, sizeof(header));
+    header.magic = HKS_ALIAS_INDEX_MAGIC;
+    header.version = HKS_ALIAS_INDEX_VERSION;
+    header.stamp = *stamp;
+    header.count = list->count;
+    header.namesSize = list->size;
+    header.namesChecksum = Checksum((const uint8_t *)list->names, list->size);
+    header.headerChecksum = Checksum((const uint8_t *)&header, offsetof(struct HksAliasIndexHeader, headerChecksum));
+
+    uint32_t totalSize = sizeof(header) + list->size;
+    uint8_t *buf = (uint8_t *)HksMalloc(totalSize);
+    HKS_IF_NULL_RETURN(buf, HKS_ERROR_MALLOC_FAIL)
+    (void)memcpy_s(buf, totalSize, &header, sizeof(header));
+    if (list->size != 0) {
+        (void)memcpy_s(buf + sizeof(header), totalSize - sizeof(header), list->names, list->size);
+    }
+
+    do {
+        ret = HksFileWrite(NULL, tmpPath, 0, buf, totalSize);
+        HKS_IF_NOT_SUCC_LOGE_BREAK(ret, "write alias index failed, ret = %" LOG_PUBLIC "d", ret)
+        if (rename(tmpPath, indexPath) != 0) {
+            HKS_LOG_E("rename alias index failed");
+            (void)HksFileRemove(NULL, tmpPath);
+            ret = HKS_ERROR_WRITE_FILE_FAIL;
+        }
+    } while (0);
+    HKS_FREE(buf);
+    return ret;
+}
+
+static int32_t AppendName(struct HksAliasIndexList *list, uint32_t *capacity, const char *name)
+{
+    uint32_t nameSize = strlen(name) + 1;
+    if (list->size + nameSize > *capacity) {
+        uint32_t newCapacity = (*capacity == 0) ? HKS_ALIAS_INDEX_SCAN_INIT_SIZE : *capacity;
+        while (newCapacity < list->size + nameSize) {
+            newCapacity *= 2; /* grow by doubling */
+        }
+        char *names = (char *)HksMalloc(newCapacity);
+        HKS_IF_NULL_RETURN(names, HKS_ERROR_MALLOC_FAIL)
+        if (list->size != 0) {
+            (void)memcpy_s(names, newCapacity, list->names, list->size);
+        }
+        HKS_FREE(list->names);
+        list->names = names;
+        *capacity = newCapacity;
+    }
+    (void)memcpy_s(list->names + list->size, *capacity - list->size, name, nameSize);
+    list->size += nameSize;
+    list->count++;
+    return HKS_SUCCESS;
+}
+
+static int CompareName(const void *a, const void *b)
+{
+    return strcmp(*(const char * const *)a, *(const char * const *)b);
+}
+
+static int32_t SortNames(struct HksAliasIndexList *list)
+{
+    if (list->count <= 1) {
+        return HKS_SUCCESS;
+    }
+    const char **entries = (const char **)HksMalloc(list->count * sizeof(const char *));
+    HKS_IF_NULL_RETURN(entries, HKS_ERROR_MALLOC_FAIL)
+    char *sorted = (char *)HksMalloc(list->size);
+    if (sorted == NULL) {
+        HKS_FREE(entries);
+        return HKS_ERROR_MALLOC_FAIL;
+    }
+
+    const char *name = list->names;
+    for (uint32_t i = 0; i < list->count; ++i) {
+        entries[i] = name;
+        name += strlen(name) + 1;
+    }
+    qsort(entries, list->count, sizeof(const char *), CompareName);
+
+    uint32_t offset = 0;
+    for (uint32_t i = 0; i < list->count; ++i) {
+        uint32_t nameSize = strlen(entries[i]) + 1;
+        (void)memcpy_s(sorted + offset, list->size - offset, entries[i], nameSize);
+        offset += nameSize;
+    }
+    HKS_FREE(entries);
+    HKS_FREE(list->names);
+    list->names = sorted;
+    return HKS_SUCCESS;
+}
+
+static int32_t ScanDir(const char *dirPath, struct HksAliasIndexList *list)
+{
+    void *dir = HksOpenDir(dirPath);
+    if (dir == NULL) {
+        HKS_LOG_W("can't open directory");
+        return HKS_SUCCESS;
+    }
+
+    uint32_t capacity = 0;
+    int32_t ret = HKS_SUCCESS;
+    struct HksFileDirentInfo dire = {{0}};
+    while (HksGetDirFile(dir, &dire) == HKS_SUCCESS) {
+        ret = AppendName(list, &capacity, dire.fileName);
+        HKS_IF_NOT_SUCC_BREAK(ret)
+    }
+    (void)HksCloseDir(dir);
+    HKS_IF_NOT_SUCC_RETURN(ret, ret)
+    return SortNames(list);
+}
+
+/* called with the index write lock held, the result is only stored when nothing changed during the scan */
+static int32_t RebuildIndex(const char *dirPath, struct HksAliasIndexList *list)
+{
+    struct HksAliasIndexStamp before;
+    struct HksAliasIndexStamp after;
+    HKS_IF_NOT_SUCC_RETURN(GetDirStamp(dirPath, &before), HKS_SUCCESS)
+
+    int32_t ret = ScanDir(dirPath, list);
+    if (ret != HKS_SUCCESS) {
+        HksAliasIndexFreeList(list);
+        return ret;
+    }
+    if (GetDirStamp(dirPath, &after) == HKS_SUCCESS && IsSameStamp(&before, &after)) {
+        HKS_IF_NOT_SUCC_LOGE(WriteIndex(dirPath, &after, list), "store rebuilt alias index failed")
+    }
+    return HKS_SUCCESS;
+}
+
+static int32_t LoadIndex(const char *dirPath, struct HksAliasIndexList *list, uint32_t *count)
+{
+    struct HksAliasIndexStamp stamp;
+    /* a directory that does not exist yet holds no keys */
+    HKS_IF_NOT_SUCC_RETURN(GetDirStamp(dirPath, &stamp), HKS_SUCCESS)
+
+    char indexPath[HKS_MAX_FILE_NAME_LEN] = { 0 };
+    int32_t ret = GetIndexPath(dirPath, HKS_ALIAS_INDEX_SUFFIX, indexPath, sizeof(indexPath));
+    HKS_IF_NOT_SUCC_RETURN(ret, ret)
+
+    void *lock = NULL;
+    LockIndex(&lock, indexPath, false);
+    ret = ReadIndex(indexPath, &stamp, list, count);
+    UnlockIndex(&lock, false);
+    if (ret == HKS_SUCCESS) {
+        return ret;
+    }
+    HKS_LOG_I("alias index missing or stale, rebuild it, ret = %" LOG_PUBLIC "d", ret);
+
+    struct HksAliasIndexList scanned = { 0, 0, NULL };
+    LockIndex(&lock, indexPath, true);
+    ret = RebuildIndex(dirPath, &scanned);
+    UnlockIndex(&lock, true);
+    HKS_IF_NOT_SUCC_RETURN(ret, ret)
+
+    *count = scanned.count;
+    if (list != NULL) {
+        *list = scanned;
+    } else {
+        HksAliasIndexFreeList(&scanned);
+    }
+    return HKS_SUCCESS;
+}
+
+int32_t HksAliasIndexGetList(const char *dirPath, struct HksAliasIndexList *list)
+{
+    if (dirPath == NULL || list == NULL) {
+        return HKS_ERROR_NULL_POINTER;
+    }
+    (void)memset_s(list, sizeof(*list), 0, sizeof(*list));
+    uint32_t count = 0;
+    return LoadIndex(dirPath, list, &count);
+}
+
+int32_t HksAliasIndexGetCount(const char *dirPath, uint32_t *count)
+{
+    if (dirPath == NULL || count == NULL) {
+        return HKS_ERROR_NULL_POINTER;
+    }
+    *count = 0;
+    return LoadIndex(dirPath, NULL, count);
+}
+
+void HksAliasIndexFreeList(struct HksAliasIndexList *list)
+{
+    if (list == NULL) {
+        return;
+    }
+    HKS_FREE(list->names);
+    list->count = 0;
+    list->size = 0;
+}
+
+/* insert or remove fileName keeping the strcmp order, adding a present name or removing a missing one is a no-op */
+static int32_t PatchList(struct HksAliasIndexList *list, const char *fileName, bool isAdd)
+{
+    uint32_t nameSize = strlen(fileName) + 1;
+    uint32_t capacity = list->size + (isAdd ? nameSize : 0);
+    if (capacity == 0) {
+        return HKS_SUCCESS;
+    }
+    char *names = (char *)HksMalloc(capacity);
+    HKS_IF_NULL_RETURN(names, HKS_ERROR_MALLOC_FAIL)
+
+    uint32_t in = 0;
+    uint32_t out = 0;
+    uint32_t count = 0;
+    bool isPlaced = !isAdd;
+    while (in < list->size) {
+        const char *cur = list->names + in;
+        uint32_t curSize = strlen(cur) + 1;
+        int cmp = strcmp(cur, fileName);
+        in += curSize;
+        if (cmp == 0 && !isAdd) {
+            continue;
+        }
+        if (!isPlaced && cmp > 0) {
+            (void)memcpy_s(names + out, capacity - out, fileName, nameSize);
+            out += nameSize;
+            ++count;
+        }
+        isPlaced = isPlaced || (cmp >= 0);
+        (void)memcpy_s(names + out, capacity - out, cur, curSize);
+        out += curSize;
+        ++count;
+    }
+    if (!isPlaced) {
+        (void)memcpy_s(names + out, capacity - out, fileName, nameSize);
+        out += nameSize;
+        ++count;
+    }
+
+    HKS_FREE(list->names);
+    list->names = names;
+    list->size = out;
+    list->count = count;
+    return HKS_SUCCESS;
+}
+
+void HksAliasIndexBeginUpdate(const char *dirPath, struct HksAliasIndexUpdate *update)
+{
+    (void)memset_s(update, sizeof(*update), 0, sizeof(*update));
+    update->dirPath = dirPath;
+
+    char indexPath[HKS_MAX_FILE_NAME_LEN] = { 0 };
+    if (GetIndexPath(dirPath, HKS_ALIAS_INDEX_SUFFIX, indexPath, sizeof(indexPath)) != HKS_SUCCESS) {
+        return;
+    }
+    LockIndex(&update->lock, indexPath, true);
+
+    struct HksAliasIndexStamp stamp;
+    uint32_t count = 0;
+    update->isFresh = (GetDirStamp(dirPath, &stamp) == HKS_SUCCESS) &&
+        (ReadIndex(indexPath, &stamp, &update->list, &count) == HKS_SUCCESS);
+}
+
+void HksAliasIndexEndUpdate(struct HksAliasIndexUpdate *update, const char *fileName, bool isAdd, bool isDone)
+{
+    /* a stale index is left alone, the next list or count rebuilds it */
+    if (update->isFresh && isDone && PatchList(&update->list, fileName, isAdd) == HKS_SUCCESS) {
+        struct HksAliasIndexStamp stamp;
+        if (GetDirStamp(update->dirPath, &stamp) == HKS_SUCCESS) {
+            HKS_IF_NOT_SUCC_LOGE(WriteIndex(update->dirPath, &stamp, &update->list), "update alias index failed")
+        }
+    }
+    UnlockIndex(&update->lock, true);
+    HksAliasIndexFreeList(&update->list);
+    update->isFresh = false;
+}
+
+void HksAliasIndexInvalidate(const char *dirPath)
+{
+    char indexPath[HKS_MAX_FILE_NAME_LEN] = { 0 };
+    if (dirPath == NULL || GetIndexPath(dirPath, HKS_ALIAS_INDEX_SUFFIX, indexPath, sizeof(indexPath)) != HKS_SUCCESS) {
+        return;
+    }
+    /* under the write lock, so a rebuild that scanned the directory before the change cannot store its result after */
+    void *lock = NULL;
+    LockIndex(&lock, indexPath, true);
+    HKS_IF_NOT_SUCC_LOGE(HksFileRemove(NULL, indexPath), "remove alias index failed")
+    UnlockIndex(&lock, true);
+}
+#endif /* HKS_SUPPORT_ALIAS_INDEX */
+#endif /* _CUT_AUTHENTICATE_ */
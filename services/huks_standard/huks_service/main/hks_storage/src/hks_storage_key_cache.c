@@ -0,0 +1,281 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _CUT_AUTHENTICATE_
+
+#ifdef HKS_CONFIG_FILE
+#include HKS_CONFIG_FILE
+#else
+#include "hks_config.h"
+#endif
+
+#include "hks_storage_key_cache.h"
+
+#ifdef HKS_SUPPORT_KEY_CACHE
+
+#include <stddef.h>
+#include <string.h>
+
+#include "hks_file_operator.h"
+#include "hks_log.h"
+#include "hks_mem.h"
+#include "hks_mutex.h"
+#include "hks_template.h"
+#include "securec.h"
+
+#define HKS_KEY_CACHE_BUCKET_COUNT 256
+/* reaching this many entries clears the cache, the keys still in use are cached again by their next request */
+#define HKS_KEY_CACHE_MAX_COUNT 1024
+#define HKS_KEY_CACHE_MAX_KEY_SIZE 4096
+#define FNV_OFFSET_BASIS 0x811c9dc5
+#define FNV_PRIME 0x01000193
+
+struct HksKeyCacheEntry {
+    struct HksKeyCacheEntry *next;
+    uint32_t hash;
+    bool isExist;
+    uint64_t accessTokenId;
+    int32_t userId;
+    struct HksBlob key; /* content of the key file, empty while not cached */
+    char name[]; /* "<path>/<fileName>" */
+};
+
+static HksMutex *g_keyCacheLock = NULL;
+static struct HksKeyCacheEntry *g_buckets[HKS_KEY_CACHE_BUCKET_COUNT];
+static uint32_t g_entryCount = 0;
+/* changes on every write, remove and clear, fills carrying an older generation are dropped */
+static uint64_t g_generation = 0;
+
+static bool IsCachedPath(const char *path)
+{
+    return (path != NULL) && (strncmp(path, HKS_ECE_ROOT_PATH, strlen(HKS_ECE_ROOT_PATH)) != 0);
+}
+
+static uint32_t HashName(const char *path, const char *fileName)
+{
+    uint32_t hash = FNV_OFFSET_BASIS;
+    for (const char *c = path; *c != '\0'; ++c) {
+        hash = (hash ^ (uint8_t)*c) * FNV_PRIME;
+    }
+    hash = (hash ^ (uint8_t)'/') * FNV_PRIME;
+    for (const char *c = fileName; *c != '\0'; ++c) {
+        hash = (hash ^ (uint8_t)*c) * FNV_PRIME;
+    }
+    return hash;
+}
+
+static bool IsSameName(const struct HksKeyCacheEntry *entry, const char *path, const char *fileName)
+{
+    size_t pathLen = strlen(path);
+    return (strncmp(entry->name, path, pathLen) == 0) && (entry->name[pathLen] == '/') &&
+        (strcmp(entry->name + pathLen + 1, fileName) == 0);
+}
+
+static struct HksKeyCacheEntry *FindEntry(const char *path, const char *fileName, uint32_t hash)
+{
+    for (struct HksKeyCacheEntry *entry = g_buckets[hash % HKS_KEY_CACHE_BUCKET_COUNT]; entry != NULL;
+        entry = entry->next) {
+        if (entry->hash == hash && IsSameName(entry, path, fileName)) {
+            return entry;
+        }
+    }
+    return NULL;
+}
+
+static void FreeEntryKey(struct HksKeyCacheEntry *entry)
+{
+    if (entry->key.data != NULL) {
+        (void)memset_s(entry->key.data, entry->key.size, 0, entry->key.size);
+    }
+    HKS_FREE_BLOB(entry->key);
+}
+
+static void FreeEntry(struct HksKeyCacheEntry *entry)
+{
+    FreeEntryKey(entry);
+    HKS_FREE(entry);
+}
+
+static void ClearEntries(void)
+{
+    for (uint32_t i = 0; i < HKS_KEY_CACHE_BUCKET_COUNT; ++i) {
+        while (g_buckets[i] != NULL) {
+            struct HksKeyCacheEntry *entry = g_buckets[i];
+            g_buckets[i] = entry->next;
+            FreeEntry(entry);
+        }
+    }
+    g_entryCount = 0;
+}
+
+static struct HksKeyCacheEntry *GetOrAddEntry(const char *path, const char *fileName, uint32_t hash)
+{
+    struct HksKeyCacheEntry *entry = FindEntry(path, fileName, hash);
+    if (entry != NULL) {
+        return entry;
+    }
+    if (g_entryCount >= HKS_KEY_CACHE_MAX_COUNT) {
+        ClearEntries();
+    }
+
+    size_t nameSize = strlen(path) + 1 + strlen(fileName) + 1;
+    entry = (struct HksKeyCacheEntry *)HksMalloc(sizeof(struct HksKeyCacheEntry) + nameSize);
+    HKS_IF_NULL_RETURN(entry, NULL)
+    if (sprintf_s(entry->name, nameSize, "%s/%s", path, fileName) <= 0) {
+        HKS_FREE(entry);
+        return NULL;
+    }
+    entry->hash = hash;
+    entry->isExist = false;
+    entry->accessTokenId = 0;
+    entry->userId = 0;
+    entry->key.size = 0;
+    entry->key.data = NULL;
+    entry->next = g_buckets[hash % HKS_KEY_CACHE_BUCKET_COUNT];
+    g_buckets[hash % HKS_KEY_CACHE_BUCKET_COUNT] = entry;
+    ++g_entryCount;
+    return entry;
+}
+
+enum HksKeyCacheState HksKeyCacheGetState(const char *path, const char *fileName, uint64_t *generation)
+{
+    if (!IsCachedPath(path) || fileName == NULL || g_keyCacheLock == NULL || HksMutexLock(g_keyCacheLock) != 0) {
+        *generation = UINT64_MAX;
+        return HKS_KEY_CACHE_UNKNOWN;
+    }
+    enum HksKeyCacheState state = HKS_KEY_CACHE_UNKNOWN;
+    struct HksKeyCacheEntry *entry = FindEntry(path, fileName, HashName(path, fileName));
+    if (entry != NULL) {
+        state = entry->isExist ? HKS_KEY_CACHE_EXIST : HKS_KEY_CACHE_NOT_EXIST;
+    }
+    *generation = g_generation;
+    (void)HksMutexUnlock(g_keyCacheLock);
+    return state;
+}
+
+void HksKeyCacheFillState(const char *path, const char *fileName, bool isExist, uint64_t generation)
+{
+    if (!IsCachedPath(path) || fileName == NULL || g_keyCacheLock == NULL || HksMutexLock(g_keyCacheLock) != 0) {
+        return;
+    }
+    if (generation == g_generation) {
+        struct HksKeyCacheEntry *entry = GetOrAddEntry(path, fileName, HashName(path, fileName));
+        if (entry != NULL) {
+            entry->isExist = isExist;
+        }
+    }
+    (void)HksMutexUnlock(g_keyCacheLock);
+}
+
+void HksKeyCacheSetState(const char *path, const char *fileName, bool isExist)
+{
+    if (!IsCachedPath(path) || fileName == NULL || g_keyCacheLock == NULL || HksMutexLock(g_keyCacheLock) != 0) {
+        return;
+    }
+    ++g_generation;
+    struct HksKeyCacheEntry *entry = GetOrAddEntry(path, fileName, HashName(path, fileName));
+    if (entry != NULL) {
+        entry->isExist = isExist;
+        FreeEntryKey(entry);
+    }
+    (void)HksMutexUnlock(g_keyCacheLock);
+}
+
+int32_t HksKeyCacheGetKey(const char *path, const char *fileName, const struct HksProcessInfo *processInfo,
+    struct HksBlob *keyOut, uint64_t *generation)
+{
+    *generation = UINT64_MAX;
+    if (!IsCachedPath(path) || fileName == NULL || g_keyCacheLock == NULL || HksMutexLock(g_keyCacheLock) != 0) {
+        return HKS_ERROR_NOT_EXIST;
+    }
+    int32_t ret = HKS_ERROR_NOT_EXIST;
+    struct HksKeyCacheEntry *entry = FindEntry(path, fileName, HashName(path, fileName));
+    if (entry != NULL && entry->key.data != NULL && entry->accessTokenId == processInfo->accessTokenId &&
+        entry->userId == processInfo->userIdInt) {
+        keyOut->data = (uint8_t *)HksMalloc(entry->key.size);
+        if (keyOut->data != NULL) {
+            (void)memcpy_s(keyOut->data, entry->key.size, entry->key.data, entry->key.size);
+            keyOut->size = entry->key.size;
+            ret = HKS_SUCCESS;
+        }
+    }
+    *generation = g_generation;
+    (void)HksMutexUnlock(g_keyCacheLock);
+    return ret;
+}
+
+void HksKeyCacheFillKey(const char *path, const char *fileName, const struct HksProcessInfo *processInfo,
+    const struct HksBlob *key, uint64_t generation)
+{
+    if (!IsCachedPath(path) || fileName == NULL || key->data == NULL || key->size == 0 ||
+        key->size > HKS_KEY_CACHE_MAX_KEY_SIZE) {
+        return;
+    }
+    uint8_t *copy = (uint8_t *)HksMalloc(key->size);
+    if (copy == NULL) {
+        return;
+    }
+    (void)memcpy_s(copy, key->size, key->data, key->size);
+
+    if (g_keyCacheLock == NULL || HksMutexLock(g_keyCacheLock) != 0) {
+        (void)memset_s(copy, key->size, 0, key->size);
+        HKS_FREE(copy);
+        return;
+    }
+    struct HksKeyCacheEntry *entry = NULL;
+    if (generation == g_generation) {
+        entry = GetOrAddEntry(path, fileName, HashName(path, fileName));
+    }
+    if (entry != NULL) {
+        FreeEntryKey(entry);
+        entry->isExist = true;
+        entry->accessTokenId = processInfo->accessTokenId;
+        entry->userId = processInfo->userIdInt;
+        entry->key.data = copy;
+        entry->key.size = key->size;
+        copy = NULL;
+    }
+    (void)HksMutexUnlock(g_keyCacheLock);
+    if (copy != NULL) {
+        (void)memset_s(copy, key->size, 0, key->size);
+        HKS_FREE(copy);
+    }
+}
+
+void HksKeyCacheClear(void)
+{
+    if (g_keyCacheLock == NULL || HksMutexLock(g_keyCacheLock) != 0) {
+        return;
+    }
+    ++g_generation;
+    ClearEntries();
+    (void)HksMutexUnlock(g_keyCacheLock);
+}
+
+__attribute__((constructor)) static void OnLoad(void)
+{
+    g_keyCacheLock = HksMutexCreate();
+}
+
+__attribute__((destructor)) static void OnUnload(void)
+{
+    ClearEntries();
+    if (g_keyCacheLock != NULL) {
+        HksMutexClose(g_keyCacheLock);
+        g_keyCacheLock = NULL;
+    }
+}
+#endif /* HKS_SUPPORT_KEY_CACHE */
+#endif /* _CUT_AUTHENTICATE_ */
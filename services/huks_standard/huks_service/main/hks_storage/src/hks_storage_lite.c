@@ -35,8 +35,51 @@
 #define HKS_STORAGE_VERSION 1
 #define HKS_STORAGE_RESERVED_SEALING_ALG 0xFEDCBA98
 
+#ifdef HKS_SUPPORT_STORAGE_LITE_V2
+#define HKS_STORAGE_VERSION_LOG 2
+#define HKS_STORAGE_IMAGE_VERSION HKS_STORAGE_VERSION_LOG
+#define HKS_STORE_KEY_INFO_TOMBSTONE 0x01 /* keyInfo->rsv of a record that deletes its alias */
+#define HKS_STORAGE_COMPACT_PERCENT 50 /* compact once dead records fill half of the log */
+#define HKS_STORAGE_COMPACT_MIN_LEN 1024 /* ... and are worth a full file rewrite */
+#define HKS_STORAGE_INDEX_MIN_CAPACITY 16
+#define HKS_STORAGE_FNV_OFFSET_BASIS 2166136261U
+#define HKS_STORAGE_FNV_PRIME 16777619U
+#define HKS_PERCENT 100
+
+struct HksStorageIndexSlot {
+    uint32_t hash;
+    uint32_t offset; /* 0 marks an empty slot, the header sits at offset 0 */
+};
+
+struct HksStorageIndex {
+    uint32_t capacity; /* power of 2, at least twice count */
+    uint32_t count;
+    uint32_t deadLen; /* bytes of replaced records and tombstones in the log */
+    struct HksStorageIndexSlot *slots;
+};
+#else
+#define HKS_STORAGE_IMAGE_VERSION HKS_STORAGE_VERSION
+#endif
+
 struct HksBlob g_storageImageBuffer = { 0, NULL };
 
+static struct HksParamSet *g_calcMacParamSet = NULL;
+
+#ifdef HKS_SUPPORT_STORAGE_LITE_V2
+static struct HksStorageIndex g_storageIndex = { 0, 0, 0, NULL };
+
+/* the key store file holds the header of g_storageImageBuffer, so records can be appended to it */
+static bool g_storageFileSynced = false;
+
+static void FreeStorageIndex(struct HksStorageIndex *index)
+{
+    HKS_FREE(index->slots);
+    index->capacity = 0;
+    index->count = 0;
+    index->deadLen = 0;
+}
+#endif
+
 static uint32_t HksGetStoreFileOffset(void)
 {
     return HKS_FILE_OFFSET_BASE;
@@ -81,22 +124,23 @@ static int32_t CalcHeaderMac(const struct HksBlob *salt, const uint8_t *buf,
     HKS_IF_NULL_RETURN(srcData.data, HKS_ERROR_MALLOC_FAIL)
 
     int32_t ret;
-    struct HksParamSet *paramSet = NULL;
     do {
         if (memcpy_s(srcData.data, srcData.size, buf, srcSize) != EOK) {
             ret = HKS_ERROR_INSUFFICIENT_MEMORY;
             break;
         }
 
-        ret = ConstructCalcMacParamSet(&paramSet);
-        HKS_IF_NOT_SUCC_BREAK(ret)
+        /* the digest param never changes, build it once instead of on every header update */
+        if (g_calcMacParamSet == NULL) {
+            ret = ConstructCalcMacParamSet(&g_calcMacParamSet);
+            HKS_IF_NOT_SUCC_BREAK(ret)
+        }
 
-        ret = HuksAccessCalcHeaderMac(paramSet, salt, &srcData, mac);
+        ret = HuksAccessCalcHeaderMac(g_calcMacParamSet, salt, &srcData, mac);
         HKS_IF_NOT_SUCC_LOGE(ret, "access calc header mac failed, ret = %" LOG_PUBLIC "d.", ret)
     } while (0);
 
     HKS_FREE_BLOB(srcData);
-    HksFreeParamSet(&paramSet);
     return ret;
 }
 
@@ -104,7 +148,11 @@ static int32_t InitImageBuffer(void)
 {
     /* caller func ensure g_storageImageBuffer.size is larger than sizeof(*keyInfoHead) */
     struct HksStoreHeaderInfo *keyInfoHead = (struct HksStoreHeaderInfo *)g_storageImageBuffer.data;
-    keyInfoHead->version = HKS_STORAGE_VERSION;
+#ifdef HKS_SUPPORT_STORAGE_LITE_V2
+    FreeStorageIndex(&g_storageIndex);
+    g_storageFileSynced = false;
+#endif
+    keyInfoHead->version = HKS_STORAGE_IMAGE_VERSION;
     keyInfoHead->keyCount = 0;
     keyInfoHead->totalLen = sizeof(*keyInfoHead);
     keyInfoHead->sealingAlg = HKS_STORAGE_RESERVED_SEALING_ALG;
@@ -234,6 +282,223 @@ static struct HksBlob HksGetImageBuffer(void)
     return g_storageImageBuffer;
 }
 
+#ifdef HKS_SUPPORT_STORAGE_LITE_V2
+static uint32_t HashKeyAlias(const uint8_t *data, uint32_t size)
+{
+    uint32_t hash = HKS_STORAGE_FNV_OFFSET_BASIS;
+    for (uint32_t i = 0; i < size; ++i) {
+        hash = (hash ^ data[i]) * HKS_STORAGE_FNV_PRIME;
+    }
+    return hash;
+}
+
+static bool IsTombstone(const struct HksStoreKeyInfo *keyInfo)
+{
+    /* a key record never has keySize 0, see HksIsKeyInfoLenInvalid */
+    return (keyInfo->keySize == 0) && (keyInfo->rsv == HKS_STORE_KEY_INFO_TOMBSTONE);
+}
+
+static bool IsAliasOfRecord(const uint8_t *image, uint32_t offset, const struct HksBlob *keyAlias)
+{
+    const struct HksStoreKeyInfo *keyInfo = (const struct HksStoreKeyInfo *)(image + offset);
+    return (keyInfo->aliasSize == keyAlias->size) &&
+        (HksMemCmp(keyAlias->data, image + offset + sizeof(*keyInfo), keyAlias->size) == 0);
+}
+
+/* returns the slot holding keyAlias, or the empty slot it would be inserted at */
+static uint32_t FindIndexSlot(const struct HksStorageIndex *index, const uint8_t *image,
+    const struct HksBlob *keyAlias, uint32_t hash)
+{
+    uint32_t mask = index->capacity - 1;
+    uint32_t slot = hash & mask;
+    while (index->slots[slot].offset != 0) {
+        if ((index->slots[slot].hash == hash) && IsAliasOfRecord(image, index->slots[slot].offset, keyAlias)) {
+            break;
+        }
+        slot = (slot + 1) & mask;
+    }
+    return slot;
+}
+
+static uint32_t GetIndexedOffset(const struct HksStorageIndex *index, const uint8_t *image,
+    const struct HksBlob *keyAlias)
+{
+    if (index->count == 0) {
+        return 0;
+    }
+    uint32_t slot = FindIndexSlot(index, image, keyAlias, HashKeyAlias(keyAlias->data, keyAlias->size));
+    return index->slots[slot].offset;
+}
+
+static int32_t ReserveIndex(struct HksStorageIndex *index, uint32_t count)
+{
+    /* a load factor of at most 1/2 keeps probe runs short and always leaves an empty slot */
+    if ((index->capacity != 0) && (count <= index->capacity / 2)) {
+        return HKS_SUCCESS;
+    }
+
+    uint32_t capacity = (index->capacity == 0) ? HKS_STORAGE_INDEX_MIN_CAPACITY : index->capacity;
+    while (count > capacity / 2) {
+        capacity *= 2;
+    }
+
+    struct HksStorageIndexSlot *slots = (struct HksStorageIndexSlot *)HksMalloc(capacity * sizeof(*slots));
+    HKS_IF_NULL_RETURN(slots, HKS_ERROR_MALLOC_FAIL)
+
+    uint32_t mask = capacity - 1;
+    for (uint32_t i = 0; i < index->capacity; ++i) {
+        if (index->slots[i].offset == 0) {
+            continue;
+        }
+        uint32_t slot = index->slots[i].hash & mask;
+        while (slots[slot].offset != 0) {
+            slot = (slot + 1) & mask;
+        }
+        slots[slot] = index->slots[i];
+    }
+
+    HKS_FREE(index->slots);
+    index->slots = slots;
+    index->capacity = capacity;
+    return HKS_SUCCESS;
+}
+
+static void RemoveIndexSlot(struct HksStorageIndex *index, uint32_t slot)
+{
+    /* backward shift: move later members of the probe run into the hole, so no deleted markers pile up */
+    uint32_t mask = index->capacity - 1;
+    uint32_t hole = slot;
+    uint32_t next = (slot + 1) & mask;
+    while (index->slots[next].offset != 0) {
+        uint32_t home = index->slots[next].hash & mask;
+        bool isHomeInRun = (hole <= next) ? ((hole < home) && (home <= next)) : ((hole < home) || (home <= next));
+        if (!isHomeInRun) {
+            index->slots[hole] = index->slots[next];
+            hole = next;
+        }
+        next = (next + 1) & mask;
+    }
+    index->slots[hole].hash = 0;
+    index->slots[hole].offset = 0;
+    index->count--;
+}
+
+/* applies the record at offset to the index, the caller reserved room for one more alias */
+static void UpdateIndex(struct HksStorageIndex *index, const uint8_t *image, uint32_t offset)
+{
+    const struct HksStoreKeyInfo *keyInfo = (const struct HksStoreKeyInfo *)(image + offset);
+    struct HksBlob keyAlias = { keyInfo->aliasSize, (uint8_t *)image + offset + sizeof(*keyInfo) };
+    uint32_t hash = HashKeyAlias(keyAlias.data, keyAlias.size);
+    uint32_t slot = FindIndexSlot(index, image, &keyAlias, hash);
+
+    uint32_t oldOffset = index->slots[slot].offset;
+    if (oldOffset != 0) {
+        index->deadLen += ((const struct HksStoreKeyInfo *)(image + oldOffset))->keyInfoLen;
+    }
+
+    if (IsTombstone(keyInfo)) {
+        index->deadLen += keyInfo->keyInfoLen;
+        if (oldOffset != 0) {
+            RemoveIndexSlot(index, slot);
+        }
+        return;
+    }
+
+    if (oldOffset == 0) {
+        index->count++;
+    }
+    index->slots[slot].hash = hash;
+    index->slots[slot].offset = offset;
+}
+
+static int32_t CheckLogRecord(const uint8_t *image, uint32_t offset, uint32_t totalLen, bool isLog)
+{
+    if ((totalLen < offset) || ((totalLen - offset) < sizeof(struct HksStoreKeyInfo))) {
+        HKS_LOG_E("invalid keyinfo size.");
+        return HKS_ERROR_INVALID_KEY_FILE;
+    }
+
+    struct HksStoreKeyInfo *keyInfo = (struct HksStoreKeyInfo *)(image + offset);
+    bool isValid;
+    if (IsTombstone(keyInfo)) {
+        isValid = isLog && (keyInfo->aliasSize != 0) && (keyInfo->aliasSize <= HKS_MAX_KEY_ALIAS_LEN) &&
+            (keyInfo->authIdSize == 0) && (keyInfo->keyInfoLen == (sizeof(*keyInfo) + keyInfo->aliasSize));
+    } else {
+        isValid = !HksIsKeyInfoLenInvalid(keyInfo);
+    }
+
+    if (!isValid || (keyInfo->keyInfoLen > (totalLen - offset))) {
+        HKS_LOG_E("invalid keyinfo len");
+        return HKS_ERROR_INVALID_KEY_FILE;
+    }
+    return HKS_SUCCESS;
+}
+
+/* replays the log in image into an empty index: later records replace earlier ones, tombstones remove them */
+static int32_t BuildStorageIndex(const uint8_t *image, struct HksStorageIndex *index)
+{
+    const struct HksStoreHeaderInfo *keyInfoHead = (const struct HksStoreHeaderInfo *)image;
+    bool isLog = (keyInfoHead->version == HKS_STORAGE_VERSION_LOG);
+    uint32_t totalLen = keyInfoHead->totalLen;
+    uint32_t offset = sizeof(*keyInfoHead);
+
+    int32_t ret = ReserveIndex(index, keyInfoHead->keyCount);
+    while ((ret == HKS_SUCCESS) && (offset < totalLen)) {
+        ret = CheckLogRecord(image, offset, totalLen, isLog);
+        HKS_IF_NOT_SUCC_BREAK(ret)
+
+        ret = ReserveIndex(index, index->count + 1);
+        HKS_IF_NOT_SUCC_BREAK(ret)
+
+        UpdateIndex(index, image, offset);
+        offset += ((const struct HksStoreKeyInfo *)(image + offset))->keyInfoLen;
+    }
+
+    if ((ret == HKS_SUCCESS) && (index->count != keyInfoHead->keyCount)) {
+        HKS_LOG_E("key count %" LOG_PUBLIC "u not match log %" LOG_PUBLIC "u", keyInfoHead->keyCount, index->count);
+        ret = HKS_ERROR_INVALID_KEY_FILE;
+    }
+
+    if (ret != HKS_SUCCESS) {
+        FreeStorageIndex(index);
+    }
+    return ret;
+}
+
+static int32_t OpenStorageLog(void)
+{
+    /* caller func ensure g_storageImageBuffer holds the whole image */
+    struct HksStoreHeaderInfo *keyInfoHead = (struct HksStoreHeaderInfo *)g_storageImageBuffer.data;
+    if ((keyInfoHead->version != HKS_STORAGE_VERSION) && (keyInfoHead->version != HKS_STORAGE_VERSION_LOG)) {
+        HKS_LOG_E("unknown storage version %" LOG_PUBLIC "u", keyInfoHead->version);
+        return HKS_ERROR_INVALID_KEY_FILE;
+    }
+
+    FreeStorageIndex(&g_storageIndex);
+    int32_t ret = BuildStorageIndex(g_storageImageBuffer.data, &g_storageIndex);
+    HKS_IF_NOT_SUCC_RETURN(ret, ret)
+
+    g_storageFileSynced = true;
+    if (keyInfoHead->version == HKS_STORAGE_VERSION_LOG) {
+        return HKS_SUCCESS;
+    }
+
+    /* a version 1 image is a log without dead records, migrating it only rewrites the header */
+    keyInfoHead->version = HKS_STORAGE_VERSION_LOG;
+    ret = RefreshKeyInfoHeaderHmac(keyInfoHead);
+    if (ret == HKS_SUCCESS) {
+        ret = HksFileWriteAt(HKS_KEY_STORE_PATH, HKS_KEY_STORE_FILE_NAME, HksGetStoreFileOffset(),
+            g_storageImageBuffer.data, sizeof(*keyInfoHead));
+    }
+    if (ret != HKS_SUCCESS) {
+        /* the next store or delete rewrites the whole file */
+        HKS_LOG_E("migrate key store file failed, ret = %" LOG_PUBLIC "d", ret);
+        g_storageFileSynced = false;
+    }
+    return HKS_SUCCESS;
+}
+#endif /* HKS_SUPPORT_STORAGE_LITE_V2 */
+
 static int32_t LoadFileToBuffer(const char *fileName)
 {
     /* 1. read key info header */
@@ -258,6 +523,12 @@ static int32_t LoadFileToBuffer(const char *fileName)
 
         /* 4. check success, load full buffer */
         ret = FreshImageBuffer(fileName);
+#ifdef HKS_SUPPORT_STORAGE_LITE_V2
+        HKS_IF_NOT_SUCC_BREAK(ret)
+
+        /* 5. index the log, migrating a version 1 image */
+        ret = OpenStorageLog();
+#endif
     } while (0);
 
     if (ret != HKS_SUCCESS) {
@@ -299,6 +570,9 @@ static int32_t CleanStorageKeyInfo(const char *fileName)
         HKS_LOG_E("write file failed when hks refresh file buffer");
         FreeImageBuffer();
     }
+#ifdef HKS_SUPPORT_STORAGE_LITE_V2
+    g_storageFileSynced = (ret == HKS_SUCCESS);
+#endif
     return ret;
 }
 
@@ -332,7 +606,216 @@ int32_t HksFileBufferRefresh(void)
  *          | AuthIdSize |  keyAlias   |  keyAuthId  |         key          |
  *          |   1bytes   | max 64bytes | max 64bytes | max keyMaterial size |
  *          +---------------------------------------------------------------+
+ *
+ * Version 2 keeps this layout as an append-only log. A store appends the new keyInfo and leaves the replaced
+ * one behind as dead bytes, a delete appends a tombstone: a keyInfo with keySize 0, rsv set to
+ * HKS_STORE_KEY_INFO_TOMBSTONE and only the keyAlias behind it. keyCount counts the live keys, totalLen the
+ * whole log. The record is written to the file before the header, so a record whose header never made it
+ * lies beyond totalLen and is ignored. Dead bytes are dropped by a compaction that rewrites the file.
  */
+#ifdef HKS_SUPPORT_STORAGE_LITE_V2
+static int32_t GetKeyOffsetByKeyAlias(const struct HksBlob *keyAlias, uint32_t *keyOffset)
+{
+    if (g_storageImageBuffer.size < sizeof(struct HksStoreHeaderInfo)) {
+        HKS_LOG_E("invalid keyinfo buffer size %" LOG_PUBLIC "u.", g_storageImageBuffer.size);
+        return HKS_ERROR_INVALID_KEY_FILE;
+    }
+
+    uint32_t offset = GetIndexedOffset(&g_storageIndex, g_storageImageBuffer.data, keyAlias);
+    if (offset == 0) {
+        return HKS_ERROR_NOT_EXIST;
+    }
+
+    *keyOffset = offset;
+    return HKS_SUCCESS;
+}
+
+static int32_t ReserveImageBuffer(uint32_t len)
+{
+    if (g_storageImageBuffer.size >= len) {
+        return HKS_SUCCESS;
+    }
+
+    /* grow geometrically, so a run of stores copies the image a logarithmic number of times */
+    uint32_t newBufLen = g_storageImageBuffer.size * 2;
+    if (newBufLen < len) {
+        newBufLen = len;
+    }
+    if (newBufLen > MAX_STORAGE_SIZE) {
+        newBufLen = MAX_STORAGE_SIZE;
+    }
+
+    uint8_t *buf = (uint8_t *)HksMalloc(newBufLen);
+    HKS_IF_NULL_RETURN(buf, HKS_ERROR_MALLOC_FAIL)
+
+    struct HksStoreHeaderInfo *keyInfoHead = (struct HksStoreHeaderInfo *)g_storageImageBuffer.data;
+    if (memcpy_s(buf, newBufLen, g_storageImageBuffer.data, keyInfoHead->totalLen) != EOK) {
+        HKS_FREE(buf);
+        return HKS_ERROR_INSUFFICIENT_MEMORY;
+    }
+
+    FreeImageBuffer();
+    g_storageImageBuffer.data = buf;
+    g_storageImageBuffer.size = newBufLen;
+    return HKS_SUCCESS;
+}
+
+/* copies the live records except the one of dropAlias into a new buffer of bufLen bytes */
+static int32_t CompactImageBuffer(const struct HksBlob *dropAlias, uint32_t bufLen)
+{
+    uint8_t *buf = (uint8_t *)HksMalloc(bufLen);
+    HKS_IF_NULL_RETURN(buf, HKS_ERROR_MALLOC_FAIL)
+
+    const uint8_t *image = g_storageImageBuffer.data;
+    const struct HksStoreHeaderInfo *keyInfoHead = (const struct HksStoreHeaderInfo *)image;
+    struct HksStoreHeaderInfo *newHead = (struct HksStoreHeaderInfo *)buf;
+    int32_t ret = HKS_SUCCESS;
+    (void)memcpy_s(buf, bufLen, keyInfoHead, sizeof(*keyInfoHead));
+    newHead->keyCount = 0;
+    newHead->totalLen = sizeof(*newHead);
+
+    uint32_t offset = sizeof(*keyInfoHead);
+    while (offset < keyInfoHead->totalLen) {
+        const struct HksStoreKeyInfo *keyInfo = (const struct HksStoreKeyInfo *)(image + offset);
+        struct HksBlob keyAlias = { keyInfo->aliasSize, (uint8_t *)image + offset + sizeof(*keyInfo) };
+        bool isLive = !IsTombstone(keyInfo) && !IsAliasOfRecord(image, offset, dropAlias) &&
+            (GetIndexedOffset(&g_storageIndex, image, &keyAlias) == offset);
+        if (isLive) {
+            if (memcpy_s(buf + newHead->totalLen, bufLen - newHead->totalLen, keyInfo, keyInfo->keyInfoLen) != EOK) {
+                ret = HKS_ERROR_INSUFFICIENT_MEMORY;
+                break;
+            }
+            newHead->totalLen += keyInfo->keyInfoLen;
+            newHead->keyCount++;
+        }
+        offset += keyInfo->keyInfoLen;
+    }
+
+    struct HksStorageIndex index = { 0, 0, 0, NULL };
+    if (ret == HKS_SUCCESS) {
+        ret = BuildStorageIndex(buf, &index);
+    }
+    if (ret != HKS_SUCCESS) {
+        (void)memset_s(buf, bufLen, 0, bufLen);
+        HKS_FREE(buf);
+        return ret;
+    }
+
+    FreeImageBuffer();
+    FreeStorageIndex(&g_storageIndex);
+    g_storageImageBuffer.data = buf;
+    g_storageImageBuffer.size = bufLen;
+    g_storageIndex = index;
+    g_storageFileSynced = false;
+    return HKS_SUCCESS;
+}
+
+static int32_t WriteStorageLog(uint32_t recordOffset, uint32_t recordLen)
+{
+    uint32_t fileOffset = HksGetStoreFileOffset();
+    struct HksStoreHeaderInfo *keyInfoHead = (struct HksStoreHeaderInfo *)g_storageImageBuffer.data;
+    int32_t ret;
+    if (g_storageFileSynced && (recordLen != 0)) {
+        ret = HksFileWriteAt(HKS_KEY_STORE_PATH, HKS_KEY_STORE_FILE_NAME, fileOffset + recordOffset,
+            g_storageImageBuffer.data + recordOffset, recordLen);
+        if (ret == HKS_SUCCESS) {
+            ret = HksFileWriteAt(HKS_KEY_STORE_PATH, HKS_KEY_STORE_FILE_NAME, fileOffset,
+                g_storageImageBuffer.data, sizeof(*keyInfoHead));
+        }
+        if (ret == HKS_SUCCESS) {
+            return HKS_SUCCESS;
+        }
+        HKS_LOG_E("append to key store file failed, ret = %" LOG_PUBLIC "d, rewrite it", ret);
+    }
+
+    ret = HksFileWrite(HKS_KEY_STORE_PATH, HKS_KEY_STORE_FILE_NAME, fileOffset,
+        g_storageImageBuffer.data, keyInfoHead->totalLen);
+    g_storageFileSynced = (ret == HKS_SUCCESS);
+    return ret;
+}
+
+/* record is the new keyInfo of keyAlias, or a tombstone for it */
+static int32_t AppendRecord(const struct HksBlob *keyAlias, const struct HksBlob *record)
+{
+    uint32_t oldOffset = 0;
+    int32_t ret = GetKeyOffsetByKeyAlias(keyAlias, &oldOffset);
+    if ((ret != HKS_SUCCESS) && (ret != HKS_ERROR_NOT_EXIST)) {
+        return ret;
+    }
+
+    /* 1. size the new log, compact when dead records dominate or the append does not fit */
+    struct HksStoreHeaderInfo *keyInfoHead = (struct HksStoreHeaderInfo *)g_storageImageBuffer.data;
+    bool isTombstone = IsTombstone((const struct HksStoreKeyInfo *)record->data);
+    uint32_t oldLen = (oldOffset == 0) ? 0 :
+        ((const struct HksStoreKeyInfo *)(g_storageImageBuffer.data + oldOffset))->keyInfoLen;
+    uint32_t liveLen = keyInfoHead->totalLen - g_storageIndex.deadLen - oldLen;
+    uint32_t addLen = isTombstone ? 0 : record->size;
+    if (liveLen + addLen > MAX_STORAGE_SIZE) {
+        HKS_LOG_E("after add, buffer too big to store");
+        return HKS_ERROR_STORAGE_FAILURE;
+    }
+    uint32_t appendedLen = keyInfoHead->totalLen + record->size;
+    uint32_t deadLen = g_storageIndex.deadLen + oldLen + (isTombstone ? record->size : 0);
+    bool needCompact = (appendedLen > MAX_STORAGE_SIZE) || ((deadLen >= HKS_STORAGE_COMPACT_MIN_LEN) &&
+        (deadLen * HKS_PERCENT >= appendedLen * HKS_STORAGE_COMPACT_PERCENT));
+
+    struct HksStoreHeaderInfo newkeyInfoHead;
+    (void)memcpy_s(&newkeyInfoHead, sizeof(newkeyInfoHead), keyInfoHead, sizeof(*keyInfoHead));
+    newkeyInfoHead.version = HKS_STORAGE_VERSION_LOG;
+    newkeyInfoHead.keyCount = keyInfoHead->keyCount - ((oldOffset != 0) ? 1 : 0) + (isTombstone ? 0 : 1);
+    newkeyInfoHead.totalLen = needCompact ? (liveLen + addLen) : appendedLen;
+
+    /* 2. calc the new header hmac and reserve the index before anything changes */
+    ret = RefreshKeyInfoHeaderHmac(&newkeyInfoHead);
+    HKS_IF_NOT_SUCC_RETURN(ret, ret)
+
+    ret = ReserveIndex(&g_storageIndex, g_storageIndex.count + 1);
+    HKS_IF_NOT_SUCC_RETURN(ret, ret)
+
+    /* 3. make room, a compaction drops the record being replaced or deleted right away */
+    if (needCompact) {
+        uint32_t bufLen = (newkeyInfoHead.totalLen > g_storageImageBuffer.size) ?
+            newkeyInfoHead.totalLen : g_storageImageBuffer.size;
+        ret = CompactImageBuffer(keyAlias, bufLen);
+    } else {
+        ret = ReserveImageBuffer(newkeyInfoHead.totalLen);
+    }
+    HKS_IF_NOT_SUCC_RETURN(ret, ret)
+
+    /* 4. append, a delete that compacted has nothing left to append */
+    keyInfoHead = (struct HksStoreHeaderInfo *)g_storageImageBuffer.data;
+    uint32_t recordOffset = keyInfoHead->totalLen;
+    uint32_t recordLen = newkeyInfoHead.totalLen - recordOffset;
+    if (recordLen != 0) {
+        if (memcpy_s(g_storageImageBuffer.data + recordOffset, g_storageImageBuffer.size - recordOffset,
+            record->data, recordLen) != EOK) {
+            return HKS_ERROR_INSUFFICIENT_MEMORY;
+        }
+        UpdateIndex(&g_storageIndex, g_storageImageBuffer.data, recordOffset);
+    }
+
+    /* 5. replace header */
+    (void)memcpy_s(g_storageImageBuffer.data, sizeof(newkeyInfoHead), &newkeyInfoHead, sizeof(newkeyInfoHead));
+    return WriteStorageLog(recordOffset, recordLen);
+}
+
+static int32_t CheckKeyRecord(const struct HksBlob *keyAlias, const struct HksBlob *keyBlob)
+{
+    if (keyBlob->size < sizeof(struct HksStoreKeyInfo)) {
+        HKS_LOG_E("invalid key blob size %" LOG_PUBLIC "u", keyBlob->size);
+        return HKS_ERROR_INVALID_ARGUMENT;
+    }
+
+    /* the index finds a record by the alias inside it, so it must be keyAlias */
+    struct HksStoreKeyInfo *keyInfo = (struct HksStoreKeyInfo *)keyBlob->data;
+    if (HksIsKeyInfoLenInvalid(keyInfo) || (keyInfo->keyInfoLen != keyBlob->size) ||
+        !IsAliasOfRecord(keyBlob->data, 0, keyAlias)) {
+        HKS_LOG_E("invalid key blob");
+        return HKS_ERROR_INVALID_ARGUMENT;
+    }
+    return HKS_SUCCESS;
+}
+#else
 static int32_t GetKeyOffsetByKeyAlias(const struct HksBlob *keyAlias, uint32_t *keyOffset)
 {
     struct HksBlob storageBuf = HksGetImageBuffer();
@@ -542,6 +1025,7 @@ static int32_t StoreKeyBlob(bool needDeleteKey, uint32_t offset, const struct Hk
     }
     return HKS_SUCCESS;
 }
+#endif /* HKS_SUPPORT_STORAGE_LITE_V2 */
 
 static int32_t GetFileName(const struct HksBlob *name, char **fileName)
 {
@@ -601,6 +1085,12 @@ int32_t HksStoreKeyBlob(const struct HksStoreFileInfo *fileInfo, const struct Hk
         return StoreRootMaterial(keyAlias, keyBlob);
     }
 
+#ifdef HKS_SUPPORT_STORAGE_LITE_V2
+    int32_t ret = CheckKeyRecord(keyAlias, keyBlob);
+    HKS_IF_NOT_SUCC_RETURN(ret, ret)
+
+    return AppendRecord(keyAlias, keyBlob);
+#else
     /* 1. check key exist or not */
     uint32_t offset = 0;
     int32_t ret = GetKeyOffsetByKeyAlias(keyAlias, &offset);
@@ -620,6 +1110,7 @@ int32_t HksStoreKeyBlob(const struct HksStoreFileInfo *fileInfo, const struct Hk
 
     uint32_t fileOffset = HksGetStoreFileOffset();
     return HksFileWrite(HKS_KEY_STORE_PATH, HKS_KEY_STORE_FILE_NAME, fileOffset, g_storageImageBuffer.data, totalLen);
+#endif
 }
 
 int32_t HksStoreDeleteKeyBlob(const struct HksStoreFileInfo *fileInfo,
@@ -633,6 +1124,24 @@ int32_t HksStoreDeleteKeyBlob(const struct HksStoreFileInfo *fileInfo,
     int32_t ret = GetKeyOffsetByKeyAlias(keyAlias, &offset);
     HKS_IF_NOT_SUCC_RETURN(ret, ret)
 
+#ifdef HKS_SUPPORT_STORAGE_LITE_V2
+    /* 2. append a tombstone, keyAlias is no longer than the alias of the key record found */
+    struct {
+        struct HksStoreKeyInfo keyInfo;
+        uint8_t keyAlias[HKS_MAX_KEY_ALIAS_LEN];
+    } tombstone;
+    (void)memset_s(&tombstone, sizeof(tombstone), 0, sizeof(tombstone));
+    tombstone.keyInfo.keyInfoLen = sizeof(tombstone.keyInfo) + keyAlias->size;
+    tombstone.keyInfo.rsv = HKS_STORE_KEY_INFO_TOMBSTONE;
+    tombstone.keyInfo.aliasSize = keyAlias->size;
+    if (memcpy_s((uint8_t *)&tombstone + sizeof(tombstone.keyInfo), sizeof(tombstone) - sizeof(tombstone.keyInfo),
+        keyAlias->data, keyAlias->size) != EOK) {
+        return HKS_ERROR_INSUFFICIENT_MEMORY;
+    }
+
+    struct HksBlob record = { tombstone.keyInfo.keyInfoLen, (uint8_t *)&tombstone };
+    return AppendRecord(keyAlias, &record);
+#else
     /* 2. calc tmp header hmac */
     struct HksStoreHeaderInfo *keyInfoHead = (struct HksStoreHeaderInfo *)g_storageImageBuffer.data;
     struct HksStoreKeyInfo *keyInfo = (struct HksStoreKeyInfo *)(g_storageImageBuffer.data + offset);
@@ -658,6 +1167,7 @@ int32_t HksStoreDeleteKeyBlob(const struct HksStoreFileInfo *fileInfo,
     uint32_t fileOffset = HksGetStoreFileOffset();
     return HksFileWrite(HKS_KEY_STORE_PATH, HKS_KEY_STORE_FILE_NAME, fileOffset,
         g_storageImageBuffer.data, keyInfoHead->totalLen);
+#endif
 }
 
 int32_t HksStoreIsKeyBlobExist(const struct HksStoreFileInfo *fileInfo,
@@ -739,7 +1249,12 @@ int32_t HksStoreGetToatalSize(uint32_t *size)
     }
 
     struct HksStoreHeaderInfo *keyInfoHead = (struct HksStoreHeaderInfo *)g_storageImageBuffer.data;
+#ifdef HKS_SUPPORT_STORAGE_LITE_V2
+    /* dead records are dropped by the next compaction, they do not count against the storage limit */
+    *size = keyInfoHead->totalLen - g_storageIndex.deadLen;
+#else
     *size = keyInfoHead->totalLen;
+#endif
     return HKS_SUCCESS;
 }
 
@@ -804,6 +1319,34 @@ static int32_t GetAndCheckKeyCount(uint32_t *inputCount, uint32_t *keyCount)
     return HKS_SUCCESS;
 }
 
+#ifdef HKS_SUPPORT_STORAGE_LITE_V2
+int32_t HksStoreGetKeyInfoList(struct HksKeyInfo *keyInfoList, uint32_t *listCount)
+{
+    uint32_t keyCount;
+    int32_t ret = GetAndCheckKeyCount(listCount, &keyCount);
+    HKS_IF_NOT_SUCC_RETURN(ret, ret)
+
+    /* records were checked when logged, walk the log in store order and keep those the index points at */
+    const uint8_t *image = g_storageImageBuffer.data;
+    uint32_t totalLen = ((const struct HksStoreHeaderInfo *)image)->totalLen;
+    uint32_t num = 0;
+    uint32_t offset = sizeof(struct HksStoreHeaderInfo);
+    while ((offset < totalLen) && (num < keyCount)) {
+        const struct HksStoreKeyInfo *keyInfo = (const struct HksStoreKeyInfo *)(image + offset);
+        struct HksBlob keyAlias = { keyInfo->aliasSize, (uint8_t *)image + offset + sizeof(*keyInfo) };
+        if (!IsTombstone(keyInfo) && (GetIndexedOffset(&g_storageIndex, image, &keyAlias) == offset)) {
+            struct HksBlob keyInfoBlob = { keyInfo->keyInfoLen, (uint8_t *)image + offset };
+            ret = GetKeyInfoList(&keyInfoList[num], &keyInfoBlob);
+            HKS_IF_NOT_SUCC_RETURN(ret, ret)
+            num++;
+        }
+        offset += keyInfo->keyInfoLen;
+    }
+
+    *listCount = num;
+    return HKS_SUCCESS;
+}
+#else
 int32_t HksStoreGetKeyInfoList(struct HksKeyInfo *keyInfoList, uint32_t *listCount)
 {
     uint32_t keyCount;
@@ -841,6 +1384,7 @@ int32_t HksStoreGetKeyInfoList(struct HksKeyInfo *keyInfoList, uint32_t *listCou
     *listCount = num;
     return HKS_SUCCESS;
 }
+#endif /* HKS_SUPPORT_STORAGE_LITE_V2 */
 
 #ifdef HKS_ENABLE_CLEAN_FILE
 static int32_t CleanFile(const char *path, const char *fileName)
@@ -32,6 +32,7 @@
 
 #include "hks_storage.h"
 #include "hks_storage_manager.h"
+#include "hks_storage_path_cache.h"
 #include "hks_template.h"
 #include "hks_type_inner.h"
 
@@ -183,36 +184,36 @@ static bool GetIsPlainPath(uint32_t storageLevel)
 }
 
 static int32_t GetPathType(const struct HksProcessInfo *processInfo, uint32_t storageType,
-    int32_t storageLevel, struct HksStoreMaterial *outMaterial)
+    int32_t storageLevel, enum HksPathType *pathType)
 {
     (void)processInfo;
     (void)storageType;
 #ifdef HKS_ENABLE_LITE_HAP
     if (CheckIsLiteHap(&processInfo->processName)) {
-        outMaterial->pathType = LITE_HAP_PATH;
+        *pathType = LITE_HAP_PATH;
         return HKS_SUCCESS;
     }
 #endif
 #ifdef HKS_USE_RKC_IN_STANDARD
     if (storageType == HKS_STORAGE_TYPE_ROOT_KEY) {
-        outMaterial->pathType = RKC_IN_STANDARD_PATH;
+        *pathType = RKC_IN_STANDARD_PATH;
         return HKS_SUCCESS;
     }
 #endif
     switch (storageLevel) {
         case HKS_AUTH_STORAGE_LEVEL_DE:
-            outMaterial->pathType = DE_PATH;
+            *pathType = DE_PATH;
             break;
 #ifdef L2_STANDARD
         case HKS_AUTH_STORAGE_LEVEL_CE:
-            outMaterial->pathType = CE_PATH;
+            *pathType = CE_PATH;
             break;
         case HKS_AUTH_STORAGE_LEVEL_ECE:
-            outMaterial->pathType = ECE_PATH;
+            *pathType = ECE_PATH;
             break;
     #ifdef HUKS_ENABLE_SKIP_UPGRADE_KEY_STORAGE_SECURE_LEVEL
         case HKS_AUTH_STORAGE_LEVEL_OLD_DE_TMP:
-            outMaterial->pathType = TMP_PATH;
+            *pathType = TMP_PATH;
             break;
     #endif
 #endif
@@ -230,9 +231,8 @@ static void FreeStorageMaterial(struct HksStoreMaterial *material)
     HKS_FREE(material->keyAliasPath);
 }
 
-static int32_t InitStorageMaterial(const struct HksProcessInfo *processInfo,
-    const struct HksParamSet *paramSet, const struct HksBlob *keyAlias, uint32_t storageType,
-    struct HksStoreMaterial *outMaterial)
+static int32_t GetStorePathKey(const struct HksProcessInfo *processInfo, const struct HksParamSet *paramSet,
+    uint32_t storageType, struct HksStorePathKey *outKey)
 {
     (void)paramSet;
     uint32_t storageLevel = HKS_AUTH_STORAGE_LEVEL_DE;
@@ -245,17 +245,29 @@ static int32_t InitStorageMaterial(const struct HksProcessInfo *processInfo,
         return ret;
     }
 #endif
-    bool isPlainPath = GetIsPlainPath(storageLevel);
+    struct HksStorePathKey key = { DE_PATH, storeUserId, storageType, GetIsPlainPath(storageLevel),
+        &processInfo->processName };
+    ret = GetPathType(processInfo, storageType, storageLevel, &key.pathType);
+    HKS_IF_NOT_SUCC_LOGE_RETURN(ret, ret, "get path type failed.")
 
-    struct HksStoreMaterial material = { DE_PATH, 0, 0, 0, 0 };
-    do {
-        ret = GetPathType(processInfo, storageType, storageLevel, &material);
-        HKS_IF_NOT_SUCC_LOGE_BREAK(ret, "get path type failed.")
+    *outKey = key;
+    return HKS_SUCCESS;
+}
 
-        ret = GetUserIdPath(storeUserId, isPlainPath, &material);
+static int32_t InitStorageMaterial(const struct HksProcessInfo *processInfo,
+    const struct HksParamSet *paramSet, const struct HksBlob *keyAlias, uint32_t storageType,
+    struct HksStoreMaterial *outMaterial)
+{
+    struct HksStorePathKey key;
+    int32_t ret = GetStorePathKey(processInfo, paramSet, storageType, &key);
+    HKS_IF_NOT_SUCC_RETURN(ret, ret)
+
+    struct HksStoreMaterial material = { key.pathType, 0, 0, 0, 0 };
+    do {
+        ret = GetUserIdPath(key.userId, key.isPlain, &material);
         HKS_IF_NOT_SUCC_LOGE_BREAK(ret, "get user id path failed.")
 
-        ret = GetUidPath(isPlainPath, &processInfo->processName, &material);
+        ret = GetUidPath(key.isPlain, key.processName, &material);
         HKS_IF_NOT_SUCC_LOGE_BREAK(ret, "get uid path failed.")
 
         ret = GetStorageTypePath(storageType, &material);
@@ -285,6 +297,71 @@ static int32_t HksConstructStoreFileInfo(const struct HksProcessInfo *processInf
     return ret;
 }
 
+#ifdef HKS_SUPPORT_PATH_CACHE
+static int32_t GetCachedStoreFileInfo(const struct HksStorePathKey *key, const struct HksBlob *keyAlias,
+    struct HksStoreMaterial *material, struct HksStoreFileInfo *fileInfo, uint64_t *generation)
+{
+    int32_t ret = HksFileInfoInit(fileInfo);
+    HKS_IF_NOT_SUCC_RETURN(ret, ret)
+
+    do {
+        ret = HksPathCacheGet(key, fileInfo, generation);
+        HKS_IF_NOT_SUCC_BREAK(ret)
+
+        ret = GetKeyAliasPath(keyAlias, material);
+        HKS_IF_NOT_SUCC_BREAK(ret)
+
+        ret = HksFileInfoSetName(&fileInfo->mainPath, material->keyAliasPath);
+        HKS_IF_NOT_SUCC_BREAK(ret)
+#ifdef SUPPORT_STORAGE_BACKUP
+        ret = HksFileInfoSetName(&fileInfo->bakPath, material->keyAliasPath);
+        HKS_IF_NOT_SUCC_BREAK(ret)
+#endif
+        return HKS_SUCCESS;
+    } while (0);
+
+    // the caller builds the file info from scratch then
+    FileInfoFree(fileInfo);
+    FreeStorageMaterial(material);
+    return ret;
+}
+#endif
+
+/*
+ * Builds the file info of keyAlias, or of the key directory when keyAlias is NULL. The directories come from the
+ * path cache when it has them, only the name of the key is built then.
+ */
+static int32_t InitStoreFileInfo(const struct HksProcessInfo *processInfo, const struct HksParamSet *paramSet,
+    const struct HksBlob *keyAlias, uint32_t storageType, struct HksStoreMaterial *outMaterial,
+    struct HksStoreFileInfo *fileInfo)
+{
+    int32_t ret;
+#ifdef HKS_SUPPORT_PATH_CACHE
+    struct HksStorePathKey key;
+    ret = GetStorePathKey(processInfo, paramSet, storageType, &key);
+    HKS_IF_NOT_SUCC_RETURN(ret, ret)
+
+    ret = CheckSpecificUserIdAndStorageLevel(processInfo, paramSet);
+    HKS_IF_NOT_SUCC_LOGE_RETURN(ret, ret,
+        "check storagelevel or specificuserid tag failed, ret = %" LOG_PUBLIC "d.", ret)
+
+    uint64_t generation = 0;
+    if (GetCachedStoreFileInfo(&key, keyAlias, outMaterial, fileInfo, &generation) == HKS_SUCCESS) {
+        return HKS_SUCCESS;
+    }
+#endif
+    ret = InitStorageMaterial(processInfo, paramSet, keyAlias, storageType, outMaterial);
+    HKS_IF_NOT_SUCC_LOGE_RETURN(ret, ret, "init storage material failed, ret = %" LOG_PUBLIC "d.", ret)
+
+    ret = HksConstructStoreFileInfo(processInfo, paramSet, outMaterial, fileInfo);
+    HKS_IF_NOT_SUCC_LOGE_RETURN(ret, ret, "hks construct store file info failed, ret = %" LOG_PUBLIC "d.", ret)
+#ifdef HKS_SUPPORT_PATH_CACHE
+    // HksGetFileInfo made the directories, so they are known to exist
+    HksPathCachePut(&key, fileInfo, generation);
+#endif
+    return HKS_SUCCESS;
+}
+
 int32_t HksManageStoreKeyBlob(const struct HksProcessInfo *processInfo, const struct HksParamSet *paramSet,
     const struct HksBlob *keyAlias, const struct HksBlob *keyBlob, uint32_t storageType)
 {
@@ -301,11 +378,8 @@ int32_t HksManageStoreKeyBlob(const struct HksProcessInfo *processInfo, const st
 #ifdef _STORAGE_LITE_
         ret = HksStoreKeyBlob(NULL, keyAlias, storageType, keyBlob);
 #else
-        ret = InitStorageMaterial(processInfo, paramSet, keyAlias, storageType, &material);
-        HKS_IF_NOT_SUCC_LOGE_BREAK(ret, "init storage material failed, ret = %" LOG_PUBLIC "d.", ret)
-
-        ret = HksConstructStoreFileInfo(processInfo, paramSet, &material, &fileInfo);
-        HKS_IF_NOT_SUCC_LOGE_BREAK(ret, "hks construct store file info failed, ret = %" LOG_PUBLIC "d.", ret)
+        ret = InitStoreFileInfo(processInfo, paramSet, keyAlias, storageType, &material, &fileInfo);
+        HKS_IF_NOT_SUCC_LOGE_BREAK(ret, "init store file info failed, ret = %" LOG_PUBLIC "d.", ret)
 
         ret = HksStoreKeyBlob(&fileInfo, keyBlob);
 #endif
@@ -333,11 +407,8 @@ int32_t HksManageStoreDeleteKeyBlob(const struct HksProcessInfo *processInfo, co
 #ifdef _STORAGE_LITE_
         ret = HksStoreDeleteKeyBlob(NULL, keyAlias, storageType);
 #else
-        ret = InitStorageMaterial(processInfo, paramSet, keyAlias, storageType, &material);
-        HKS_IF_NOT_SUCC_LOGE_BREAK(ret, "init storage material failed, ret = %" LOG_PUBLIC "d.", ret)
-
-        ret = HksConstructStoreFileInfo(processInfo, paramSet, &material, &fileInfo);
-        HKS_IF_NOT_SUCC_LOGE_BREAK(ret, "hks construct store file info failed, ret = %" LOG_PUBLIC "d.", ret)
+        ret = InitStoreFileInfo(processInfo, paramSet, keyAlias, storageType, &material, &fileInfo);
+        HKS_IF_NOT_SUCC_LOGE_BREAK(ret, "init store file info failed, ret = %" LOG_PUBLIC "d.", ret)
 
         ret = HksStoreDeleteKeyBlob(&fileInfo);
 #endif
@@ -365,11 +436,8 @@ int32_t HksManageStoreIsKeyBlobExist(const struct HksProcessInfo *processInfo, c
 #ifdef _STORAGE_LITE_
         ret = HksStoreIsKeyBlobExist(NULL, keyAlias, storageType);
 #else
-        ret = InitStorageMaterial(processInfo, paramSet, keyAlias, storageType, &material);
-        HKS_IF_NOT_SUCC_LOGE_BREAK(ret, "init storage material failed, ret = %" LOG_PUBLIC "d.", ret)
-
-        ret = HksConstructStoreFileInfo(processInfo, paramSet, &material, &fileInfo);
-        HKS_IF_NOT_SUCC_LOGE_BREAK(ret, "hks construct store file info failed, ret = %" LOG_PUBLIC "d.", ret)
+        ret = InitStoreFileInfo(processInfo, paramSet, keyAlias, storageType, &material, &fileInfo);
+        HKS_IF_NOT_SUCC_LOGE_BREAK(ret, "init store file info failed, ret = %" LOG_PUBLIC "d.", ret)
 
         ret = HksStoreIsKeyBlobExist(&fileInfo);
 #endif
@@ -397,11 +465,8 @@ int32_t HksManageStoreGetKeyBlob(const struct HksProcessInfo *processInfo, const
 #ifdef _STORAGE_LITE_
         ret = HksStoreGetKeyBlob(NULL, keyAlias, storageType, keyBlob);
 #else
-        ret = InitStorageMaterial(processInfo, paramSet, keyAlias, storageType, &material);
-        HKS_IF_NOT_SUCC_LOGE_BREAK(ret, "init storage material failed, ret = %" LOG_PUBLIC "d.", ret)
-
-        ret = HksConstructStoreFileInfo(processInfo, paramSet, &material, &fileInfo);
-        HKS_IF_NOT_SUCC_LOGE_BREAK(ret, "hks construct store file info failed, ret = %" LOG_PUBLIC "d.", ret)
+        ret = InitStoreFileInfo(processInfo, paramSet, keyAlias, storageType, &material, &fileInfo);
+        HKS_IF_NOT_SUCC_LOGE_BREAK(ret, "init store file info failed, ret = %" LOG_PUBLIC "d.", ret)
 
         if (storageType != HKS_STORAGE_TYPE_BAK_KEY) {
             ret = HksStoreGetKeyBlob(&fileInfo.mainPath, keyBlob);
@@ -442,11 +507,8 @@ int32_t HksManageStoreGetKeyBlobSize(const struct HksProcessInfo *processInfo, c
 #ifdef _STORAGE_LITE_
         ret = HksStoreGetKeyBlobSize(NULL, keyAlias, storageType, keyBlobSize);
 #else
-        ret = InitStorageMaterial(processInfo, paramSet, keyAlias, storageType, &material);
-        HKS_IF_NOT_SUCC_LOGE_BREAK(ret, "init storage material failed, ret = %" LOG_PUBLIC "d.", ret)
-
-        ret = HksConstructStoreFileInfo(processInfo, paramSet, &material, &fileInfo);
-        HKS_IF_NOT_SUCC_LOGE_BREAK(ret, "hks construct store file info failed, ret = %" LOG_PUBLIC "d.", ret)
+        ret = InitStoreFileInfo(processInfo, paramSet, keyAlias, storageType, &material, &fileInfo);
+        HKS_IF_NOT_SUCC_LOGE_BREAK(ret, "init store file info failed, ret = %" LOG_PUBLIC "d.", ret)
 
         if (storageType != HKS_STORAGE_TYPE_BAK_KEY) {
             ret = HksStoreGetKeyBlobSize(&fileInfo.mainPath, keyBlobSize);
@@ -476,11 +538,8 @@ int32_t HksManageGetKeyAliasByProcessName(const struct HksProcessInfo *processIn
     struct HksStoreMaterial material = { DE_PATH, 0, 0, 0, 0 };
     int32_t ret;
     do {
-        ret = InitStorageMaterial(processInfo, paramSet, NULL, HKS_STORAGE_TYPE_KEY, &material);
-        HKS_IF_NOT_SUCC_LOGE_BREAK(ret, "init storage material failed, ret = %" LOG_PUBLIC "d.", ret)
-
-        ret = HksConstructStoreFileInfo(processInfo, paramSet, &material, &fileInfo);
-        HKS_IF_NOT_SUCC_LOGE_BREAK(ret, "hks construct store file info failed, ret = %" LOG_PUBLIC "d.", ret)
+        ret = InitStoreFileInfo(processInfo, paramSet, NULL, HKS_STORAGE_TYPE_KEY, &material, &fileInfo);
+        HKS_IF_NOT_SUCC_LOGE_BREAK(ret, "init store file info failed, ret = %" LOG_PUBLIC "d.", ret)
 
         ret = HksGetKeyAliasByProcessName(&fileInfo, keyInfoList, listCount);
         HKS_IF_NOT_SUCC_LOGE_BREAK(ret, "hks get key alias by processname failed, ret = %" LOG_PUBLIC "d.", ret)
@@ -507,11 +566,8 @@ int32_t HksManageGetKeyCountByProcessName(const struct HksProcessInfo *processIn
 #ifdef _STORAGE_LITE_
         ret = HksGetKeyCountByProcessName(NULL, fileCount);
 #else
-        ret = InitStorageMaterial(processInfo, paramSet, NULL, HKS_STORAGE_TYPE_KEY, &material);
-        HKS_IF_NOT_SUCC_LOGE_BREAK(ret, "init storage material failed, ret = %" LOG_PUBLIC "d.", ret)
-
-        ret = HksConstructStoreFileInfo(processInfo, paramSet, &material, &fileInfo);
-        HKS_IF_NOT_SUCC_LOGE_BREAK(ret, "hks construct store file info failed, ret = %" LOG_PUBLIC "d.", ret)
+        ret = InitStoreFileInfo(processInfo, paramSet, NULL, HKS_STORAGE_TYPE_KEY, &material, &fileInfo);
+        HKS_IF_NOT_SUCC_LOGE_BREAK(ret, "init store file info failed, ret = %" LOG_PUBLIC "d.", ret)
 
         ret = HksGetKeyCountByProcessName(&fileInfo, fileCount);
 #endif
@@ -535,11 +591,8 @@ int32_t HksManageListAliasesByProcessName(const struct HksProcessInfo *processIn
     struct HksStoreMaterial material = { DE_PATH, 0, 0, 0, 0 };
     int32_t ret;
     do {
-        ret = InitStorageMaterial(processInfo, paramSet, NULL, HKS_STORAGE_TYPE_KEY, &material);
-        HKS_IF_NOT_SUCC_LOGE_BREAK(ret, "init storage material failed, ret = %" LOG_PUBLIC "d.", ret)
-
-        ret = HksConstructStoreFileInfo(processInfo, paramSet, &material, &fileInfo);
-        HKS_IF_NOT_SUCC_LOGE_BREAK(ret, "hks construct store file info failed, ret = %" LOG_PUBLIC "d.", ret)
+        ret = InitStoreFileInfo(processInfo, paramSet, NULL, HKS_STORAGE_TYPE_KEY, &material, &fileInfo);
+        HKS_IF_NOT_SUCC_LOGE_BREAK(ret, "init store file info failed, ret = %" LOG_PUBLIC "d.", ret)
 
         ret = HksListAliasesByProcessName(&fileInfo, outData);
         HKS_IF_NOT_SUCC_LOGE_BREAK(ret, "hks list aliases by processname failed, ret = %" LOG_PUBLIC "d.", ret)
@@ -556,4 +609,51 @@ int32_t HksManageListAliasesByProcessName(const struct HksProcessInfo *processIn
 #endif
 }
 
+#ifdef HKS_SUPPORT_KEY_CACHE
+int32_t HksManageStoreGetCachedKey(const struct HksProcessInfo *processInfo, const struct HksParamSet *paramSet,
+    const struct HksBlob *keyAlias, struct HksBlob *keyOut, uint64_t *generation)
+{
+#ifdef SUPPORT_STORAGE_BACKUP
+    struct HksStoreFileInfo fileInfo = { { 0 }, { 0 } };
+#else
+    struct HksStoreFileInfo fileInfo = { { 0 } };
+#endif
+    struct HksStoreMaterial material = { DE_PATH, 0, 0, 0, 0 };
+    int32_t ret;
+    do {
+        ret = InitStoreFileInfo(processInfo, paramSet, keyAlias, HKS_STORAGE_TYPE_KEY, &material, &fileInfo);
+        HKS_IF_NOT_SUCC_LOGE_BREAK(ret, "init store file info failed, ret = %" LOG_PUBLIC "d.", ret)
+
+        ret = HksKeyCacheGetKey(fileInfo.mainPath.path, fileInfo.mainPath.fileName, processInfo, keyOut,
+            generation);
+    } while (0);
+
+    FileInfoFree(&fileInfo);
+    FreeStorageMaterial(&material);
+    // anything but a hit falls back to reading the key file
+    return (ret == HKS_SUCCESS) ? ret : HKS_ERROR_NOT_EXIST;
+}
+
+void HksManageStoreCacheKey(const struct HksProcessInfo *processInfo, const struct HksParamSet *paramSet,
+    const struct HksBlob *keyAlias, const struct HksBlob *key, uint64_t generation)
+{
+#ifdef SUPPORT_STORAGE_BACKUP
+    struct HksStoreFileInfo fileInfo = { { 0 }, { 0 } };
+#else
+    struct HksStoreFileInfo fileInfo = { { 0 } };
+#endif
+    struct HksStoreMaterial material = { DE_PATH, 0, 0, 0, 0 };
+    int32_t ret;
+    do {
+        ret = InitStoreFileInfo(processInfo, paramSet, keyAlias, HKS_STORAGE_TYPE_KEY, &material, &fileInfo);
+        HKS_IF_NOT_SUCC_LOGE_BREAK(ret, "init store file info failed, ret = %" LOG_PUBLIC "d.", ret)
+
+        HksKeyCacheFillKey(fileInfo.mainPath.path, fileInfo.mainPath.fileName, processInfo, key, generation);
+    } while (0);
+
+    FileInfoFree(&fileInfo);
+    FreeStorageMaterial(&material);
+}
+#endif
+
 #endif
\ No newline at end of file
@@ -0,0 +1,235 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef _CUT_AUTHENTICATE_
+
+#ifdef HKS_CONFIG_FILE
+#include HKS_CONFIG_FILE
+#else
+#include "hks_config.h"
+#endif
+
+#include "hks_storage_path_cache.h"
+
+#ifdef HKS_SUPPORT_PATH_CACHE
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "hks_mem.h"
+#include "hks_mutex.h"
+#include "hks_template.h"
+#include "securec.h"
+
+#define HKS_PATH_CACHE_BUCKET_COUNT 64
+/* one entry per caller, user and storage level in use, reaching this many clears the cache */
+#define HKS_PATH_CACHE_MAX_COUNT 256
+#define FNV_OFFSET_BASIS 0x811c9dc5
+#define FNV_PRIME 0x01000193
+
+struct HksPathCacheEntry {
+    struct HksPathCacheEntry *next;
+    uint32_t hash;
+    enum HksPathType pathType;
+    int32_t userId;
+    uint32_t storageType;
+    bool isPlain;
+    uint32_t processNameSize;
+    const char *mainDir;
+#ifdef SUPPORT_STORAGE_BACKUP
+    const char *bakDir;
+#endif
+    uint8_t data[]; /* process name, then the directories */
+};
+
+static HksMutex *g_pathCacheLock = NULL;
+static struct HksPathCacheEntry *g_buckets[HKS_PATH_CACHE_BUCKET_COUNT];
+static uint32_t g_entryCount = 0;
+/* changes on every clear, puts carrying an older generation are dropped */
+static uint64_t g_generation = 0;
+
+static uint32_t HashBytes(uint32_t hash, const uint8_t *data, uint32_t size)
+{
+    for (uint32_t i = 0; i < size; ++i) {
+        hash = (hash ^ data[i]) * FNV_PRIME;
+    }
+    return hash;
+}
+
+static uint32_t HashKey(const struct HksStorePathKey *key)
+{
+    uint32_t hash = FNV_OFFSET_BASIS;
+    uint32_t fields[] = { (uint32_t)key->pathType, (uint32_t)key->userId, key->storageType, (uint32_t)key->isPlain };
+    hash = HashBytes(hash, (const uint8_t *)fields, sizeof(fields));
+    return HashBytes(hash, key->processName->data, key->processName->size);
+}
+
+static bool IsSameKey(const struct HksPathCacheEntry *entry, const struct HksStorePathKey *key, uint32_t hash)
+{
+    return entry->hash == hash && entry->pathType == key->pathType && entry->userId == key->userId &&
+        entry->storageType == key->storageType && entry->isPlain == key->isPlain &&
+        entry->processNameSize == key->processName->size &&
+        memcmp(entry->data, key->processName->data, key->processName->size) == 0;
+}
+
+static struct HksPathCacheEntry *FindEntry(const struct HksStorePathKey *key, uint32_t hash)
+{
+    for (struct HksPathCacheEntry *entry = g_buckets[hash % HKS_PATH_CACHE_BUCKET_COUNT]; entry != NULL;
+        entry = entry->next) {
+        if (IsSameKey(entry, key, hash)) {
+            return entry;
+        }
+    }
+    return NULL;
+}
+
+static void ClearEntries(void)
+{
+    for (uint32_t i = 0; i < HKS_PATH_CACHE_BUCKET_COUNT; ++i) {
+        while (g_buckets[i] != NULL) {
+            struct HksPathCacheEntry *entry = g_buckets[i];
+            g_buckets[i] = entry->next;
+            HKS_FREE(entry);
+        }
+    }
+    g_entryCount = 0;
+}
+
+static int32_t CopyDir(const char *dir, struct HksStoreInfo *fileInfoPath)
+{
+    if (fileInfoPath->path == NULL || strcpy_s(fileInfoPath->path, fileInfoPath->size, dir) != EOK) {
+        return HKS_ERROR_BUFFER_TOO_SMALL;
+    }
+    return HKS_SUCCESS;
+}
+
+static bool IsValidKey(const struct HksStorePathKey *key)
+{
+    return key != NULL && key->processName != NULL && key->processName->data != NULL &&
+        g_pathCacheLock != NULL;
+}
+
+int32_t HksPathCacheGet(const struct HksStorePathKey *key, struct HksStoreFileInfo *fileInfo, uint64_t *generation)
+{
+    *generation = UINT64_MAX;
+    if (!IsValidKey(key) || HksMutexLock(g_pathCacheLock) != 0) {
+        return HKS_ERROR_NOT_EXIST;
+    }
+    int32_t ret = HKS_ERROR_NOT_EXIST;
+    struct HksPathCacheEntry *entry = FindEntry(key, HashKey(key));
+    if (entry != NULL) {
+        ret = CopyDir(entry->mainDir, &fileInfo->mainPath);
+#ifdef SUPPORT_STORAGE_BACKUP
+        if (ret == HKS_SUCCESS) {
+            ret = CopyDir(entry->bakDir, &fileInfo->bakPath);
+        }
+#endif
+    }
+    *generation = g_generation;
+    (void)HksMutexUnlock(g_pathCacheLock);
+    return ret;
+}
+
+static struct HksPathCacheEntry *NewEntry(const struct HksStorePathKey *key, uint32_t hash,
+    const struct HksStoreFileInfo *fileInfo)
+{
+    size_t mainSize = strlen(fileInfo->mainPath.path) + 1;
+    size_t dataSize = key->processName->size + mainSize;
+#ifdef SUPPORT_STORAGE_BACKUP
+    size_t bakSize = strlen(fileInfo->bakPath.path) + 1;
+    dataSize += bakSize;
+#endif
+    struct HksPathCacheEntry *entry =
+        (struct HksPathCacheEntry *)HksMalloc(sizeof(struct HksPathCacheEntry) + dataSize);
+    HKS_IF_NULL_RETURN(entry, NULL)
+
+    entry->hash = hash;
+    entry->pathType = key->pathType;
+    entry->userId = key->userId;
+    entry->storageType = key->storageType;
+    entry->isPlain = key->isPlain;
+    entry->processNameSize = key->processName->size;
+    uint8_t *cur = entry->data;
+    (void)memcpy_s(cur, dataSize, key->processName->data, key->processName->size);
+    cur += key->processName->size;
+    (void)memcpy_s(cur, mainSize, fileInfo->mainPath.path, mainSize);
+    entry->mainDir = (const char *)cur;
+#ifdef SUPPORT_STORAGE_BACKUP
+    cur += mainSize;
+    (void)memcpy_s(cur, bakSize, fileInfo->bakPath.path, bakSize);
+    entry->bakDir = (const char *)cur;
+#endif
+    return entry;
+}
+
+void HksPathCachePut(const struct HksStorePathKey *key, const struct HksStoreFileInfo *fileInfo, uint64_t generation)
+{
+    if (!IsValidKey(key) || fileInfo->mainPath.path == NULL) {
+        return;
+    }
+#ifdef SUPPORT_STORAGE_BACKUP
+    if (fileInfo->bakPath.path == NULL) {
+        return;
+    }
+#endif
+    uint32_t hash = HashKey(key);
+    // built outside of the lock, a put that turns out to be dropped only wastes the allocation
+    struct HksPathCacheEntry *entry = NewEntry(key, hash, fileInfo);
+    if (entry == NULL) {
+        return;
+    }
+    if (HksMutexLock(g_pathCacheLock) != 0) {
+        HKS_FREE(entry);
+        return;
+    }
+    if (generation == g_generation && FindEntry(key, hash) == NULL) {
+        if (g_entryCount >= HKS_PATH_CACHE_MAX_COUNT) {
+            ClearEntries();
+        }
+        entry->next = g_buckets[hash % HKS_PATH_CACHE_BUCKET_COUNT];
+        g_buckets[hash % HKS_PATH_CACHE_BUCKET_COUNT] = entry;
+        ++g_entryCount;
+        entry = NULL;
+    }
+    (void)HksMutexUnlock(g_pathCacheLock);
+    HKS_FREE(entry);
+}
+
+void HksPathCacheClear(void)
+{
+    if (g_pathCacheLock == NULL || HksMutexLock(g_pathCacheLock) != 0) {
+        return;
+    }
+    ++g_generation;
+    ClearEntries();
+    (void)HksMutexUnlock(g_pathCacheLock);
+}
+
+__attribute__((constructor)) static void OnLoad(void)
+{
+    g_pathCacheLock = HksMutexCreate();
+}
+
+__attribute__((destructor)) static void OnUnload(void)
+{
+    ClearEntries();
+    if (g_pathCacheLock != NULL) {
+        HksMutexClose(g_pathCacheLock);
+        g_pathCacheLock = NULL;
+    }
+}
+#endif /* HKS_SUPPORT_PATH_CACHE */
+#endif /* _CUT_AUTHENTICATE_ */
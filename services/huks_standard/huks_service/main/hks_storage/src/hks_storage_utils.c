@@ -32,6 +32,7 @@
 
 #include "hks_file_operator.h"
 #include "hks_log.h"
+#include "hks_log_limiter.h"
 #include "hks_mem.h"
 #include "hks_template.h"
 #include "hks_param.h"
@@ -258,6 +259,16 @@ static int32_t FileInfoInit(struct HksStoreFileInfo *fileInfo)
     return ret;
 }
 
+int32_t HksFileInfoInit(struct HksStoreFileInfo *fileInfo)
+{
+    int32_t ret = FileInfoInit(fileInfo);
+    if (ret != HKS_SUCCESS) {
+        FileInfoFree(fileInfo);
+        return HKS_ERROR_MALLOC_FAIL;
+    }
+    return HKS_SUCCESS;
+}
+
 void FileInfoFree(struct HksStoreFileInfo *fileInfo)
 {
     HKS_FREE(fileInfo->mainPath.path);
@@ -271,21 +282,53 @@ void FileInfoFree(struct HksStoreFileInfo *fileInfo)
 #endif
 }
 
+/* the counts of the key operations are logged at most once per interval at HKS_KEY_OPERATION_LOG_COUNT */
+#define KEY_OPERATION_COUNT_INTERVAL_MS 60000
+
+static uint32_t g_keyOperationLogLevel = HKS_KEY_OPERATION_LOG_LEVEL;
+static uint32_t g_keyOperationCounts[KEY_OPERATION_MAX] = { 0 };
+static struct HksLogLimiter g_keyOperationLimiters[KEY_OPERATION_MAX];
+static struct HksLogLimiter g_keyOperationCountLimiter;
+
+void HksSetKeyOperationLogLevel(enum HksKeyOperationLogLevel level)
+{
+    __atomic_store_n(&g_keyOperationLogLevel, (uint32_t)level, __ATOMIC_RELAXED);
+}
+
+uint32_t HksGetKeyOperationCount(uint32_t operation)
+{
+    if (operation >= KEY_OPERATION_MAX) {
+        return 0;
+    }
+    return __atomic_load_n(&g_keyOperationCounts[operation], __ATOMIC_RELAXED);
+}
+
+static bool NeedLogKeyOperation(uint32_t operation, uint32_t *suppressedCount)
+{
+    switch (__atomic_load_n(&g_keyOperationLogLevel, __ATOMIC_RELAXED)) {
+        case HKS_KEY_OPERATION_LOG_ALL:
+            return true;
+        case HKS_KEY_OPERATION_LOG_LIMITED:
+            return HksLogLimiterAcquire(&g_keyOperationLimiters[operation], HKS_LOG_LIMIT_BURST,
+                HKS_LOG_LIMIT_INTERVAL_MS, suppressedCount);
+        default:
+            break;
+    }
+    if (HksLogLimiterAcquire(&g_keyOperationCountLimiter, 1, KEY_OPERATION_COUNT_INTERVAL_MS, suppressedCount)) {
+        HKS_LOG_I("key operations, generate %" LOG_PUBLIC "u, use %" LOG_PUBLIC "u, delete %" LOG_PUBLIC "u",
+            HksGetKeyOperationCount(KEY_OPERATION_SAVE), HksGetKeyOperationCount(KEY_OPERATION_GET),
+            HksGetKeyOperationCount(KEY_OPERATION_DELETE));
+    }
+    return false;
+}
+
 /*
  * keyAlias: xxxxxxxxxxxxxxxxxxx********************xxxxxxxxxxxxxxxxxx
  *                              |<- anonymous len ->||<- suffix len ->|
  *           |<----------------- keyAlias len ----------------------->|
  */
-int32_t RecordKeyOperation(uint32_t operation, const char *path, const char *keyAlias)
+static void AnonymizeKeyAlias(const char *keyAlias, uint32_t keyAliasLen, char *outKeyAlias)
 {
-    (void)path;
-    uint32_t bufSize = strlen(keyAlias) + 1;
-    char *outKeyAlias = (char *)HksMalloc(bufSize);
-    HKS_IF_NULL_RETURN(outKeyAlias, HKS_ERROR_MALLOC_FAIL)
-
-    (void)memset_s(outKeyAlias, bufSize, 0, bufSize);
-
-    uint32_t keyAliasLen = strlen(keyAlias);
     uint32_t anoyLen = (keyAliasLen + 1) / 2;
     uint32_t suffixLen = anoyLen / 2;
     outKeyAlias[0] = keyAlias[0]; // keyAliasLen > 0;
@@ -298,26 +341,40 @@ int32_t RecordKeyOperation(uint32_t operation, const char *path, const char *key
         }
     }
     outKeyAlias[keyAliasLen] = '\0';
+}
+
+/* The alias is only anonymized for a line logged, the others are counted. */
+int32_t RecordKeyOperation(uint32_t operation, const char *path, const char *keyAlias)
+{
+    (void)path;
+    uint32_t keyAliasLen = strlen(keyAlias);
+    if ((operation >= KEY_OPERATION_MAX) || (keyAliasLen >= HKS_MAX_FILE_NAME_LEN)) {
+        return HKS_ERROR_INVALID_ARGUMENT;
+    }
+
+    (void)__atomic_add_fetch(&g_keyOperationCounts[operation], 1, __ATOMIC_RELAXED);
+    uint32_t suppressedCount = 0;
+    if (!NeedLogKeyOperation(operation, &suppressedCount)) {
+        return HKS_SUCCESS;
+    }
+    char outKeyAlias[HKS_MAX_FILE_NAME_LEN] = { 0 };
+    AnonymizeKeyAlias(keyAlias, keyAliasLen, outKeyAlias);
 
-    int32_t ret = HKS_SUCCESS;
     switch (operation) {
         case KEY_OPERATION_SAVE:
-            HKS_LOG_I("generate key, storage path: %" LOG_PUBLIC "s, key alias: %" LOG_PUBLIC "s",
-                path, outKeyAlias);
+            HKS_LOG_I("generate key, storage path: %" LOG_PUBLIC "s, key alias: %" LOG_PUBLIC "s, %" LOG_PUBLIC
+                "u suppressed", path, outKeyAlias, suppressedCount);
             break;
         case KEY_OPERATION_GET:
-            HKS_LOG_I("use key, storage path: %" LOG_PUBLIC "s, key alias: %" LOG_PUBLIC "s", path, outKeyAlias);
-            break;
-        case KEY_OPERATION_DELETE:
-            HKS_LOG_I("delete key, storage path: %" LOG_PUBLIC "s, key alias: %" LOG_PUBLIC "s",
-                path, outKeyAlias);
+            HKS_LOG_I("use key, storage path: %" LOG_PUBLIC "s, key alias: %" LOG_PUBLIC "s, %" LOG_PUBLIC
+                "u suppressed", path, outKeyAlias, suppressedCount);
             break;
         default:
-            ret = HKS_ERROR_INVALID_ARGUMENT;
+            HKS_LOG_I("delete key, storage path: %" LOG_PUBLIC "s, key alias: %" LOG_PUBLIC "s, %" LOG_PUBLIC
+                "u suppressed", path, outKeyAlias, suppressedCount);
+            break;
     }
-
-    HKS_FREE(outKeyAlias);
-    return ret;
+    return HKS_SUCCESS;
 }
 
 void FileNameListFree(struct HksFileEntry **fileNameList, uint32_t keyCount)
@@ -537,6 +594,21 @@ static int32_t ConstructPath(const struct HksStoreMaterial *material, const char
     return ret;
 }
 
+int32_t HksFileInfoSetName(struct HksStoreInfo *fileInfoPath, const char *keyAliasPath)
+{
+    if (keyAliasPath == NULL) {
+        return HKS_SUCCESS;
+    }
+    if (strstr(keyAliasPath, "../") != NULL) {
+        HKS_LOG_E("invalid filePath, ../ is included in file path");
+        return HKS_ERROR_INVALID_ARGUMENT;
+    }
+    if (memcpy_s(fileInfoPath->fileName, HKS_MAX_FILE_NAME_LEN, keyAliasPath, strlen(keyAliasPath)) != EOK) {
+        return HKS_ERROR_INSUFFICIENT_MEMORY;
+    }
+    return HKS_SUCCESS;
+}
+
 static int32_t GetPathInfo(const struct HksStoreMaterial *material, const char *deDataPath,
     const char *ceOrEceDataPath, struct HksStoreInfo *fileInfoPath)
 {
@@ -557,17 +629,7 @@ static int32_t GetPathInfo(const struct HksStoreMaterial *material, const char *
     } else {
         HKS_IF_NOT_SUCC_LOGE_RETURN(ret, ret, "make full dir failed.")
     }
-    if (material->keyAliasPath != NULL) {
-        if (strstr(material->keyAliasPath, "../") != NULL) {
-            HKS_LOG_E("invalid filePath, ../ is included in file path");
-            return HKS_ERROR_INVALID_ARGUMENT;
-        }
-        if (memcpy_s(fileInfoPath->fileName, HKS_MAX_FILE_NAME_LEN,
-            material->keyAliasPath, strlen(material->keyAliasPath)) != EOK) {
-            ret = HKS_ERROR_INSUFFICIENT_MEMORY;
-        }
-    }
-    return ret;
+    return HksFileInfoSetName(fileInfoPath, material->keyAliasPath);
 }
 
 int32_t HksGetFileInfo(const struct HksStoreMaterial *material, struct HksStoreFileInfo *fileInfo)
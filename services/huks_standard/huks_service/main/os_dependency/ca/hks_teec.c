@@ -21,6 +21,7 @@
 
 #include "hks_teec.h"
 
+#include <pthread.h>
 #include <unistd.h>
 
 #include "hks_log.h"
@@ -30,11 +31,13 @@
 #include "tee_client_id.h"
 #include "tee_client_type.h"
 
+#ifndef HISI_HKS_TA_PATH
 #ifdef HKS_ROUTER
 #define HISI_HKS_TA_PATH "/lib/sec/86310d18-5659-47c9-b212-841a3ca4f814.sec"
 #else
 #define HISI_HKS_TA_PATH "/vendor/bin/86310d18-5659-47c9-b212-841a3ca4f814.sec"
 #endif
+#endif
 
 #define MAX_TEE_PARAMS_NUMS 4
 #define PROVISION_PARAM_COUNT 4
@@ -68,8 +71,36 @@ typedef struct {
     TeecOpParamSet paramSet;
 } TeecOperation;
 
+/* size of the registered shared memory of each session, larger requests fall back to temp memref */
+#ifndef HKS_TEEC_SHARED_MEM_SIZE
+#define HKS_TEEC_SHARED_MEM_SIZE (16 * 1024)
+#endif
+
+#define HKS_TEEC_SHARED_MEM_ALIGN 8
+
+#ifndef TEEC_ERROR_TARGET_DEAD
+#define TEEC_ERROR_TARGET_DEAD 0xFFFF3024
+#endif
+
+struct HksTeecSessionSlot {
+    TEEC_Session *session;
+    TEEC_SharedMemory sharedMem;
+    bool isSharedMemRegistered;
+    bool isInUse;
+    bool isDead; /* its session died, the next checkout opens a new one in its place */
+};
+
+/* original user buffers of the params staged in the registered shared memory */
+struct HksTeecStagedParams {
+    uint32_t paramTypes;
+    bool isStaged;
+    TEEC_TempMemoryReference userRef[MAX_TEE_PARAMS_NUMS];
+};
+
 static TEEC_Context *g_context = NULL;
-static TEEC_Session *g_sessionSelfStart = NULL;
+static struct HksTeecSessionSlot g_sessionPool[HKS_TEEC_SESSION_POOL_SIZE];
+static pthread_mutex_t g_sessionPoolLock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t g_sessionPoolCond = PTHREAD_COND_INITIALIZER;
 
 static inline void InitializeBlob(struct HksBlob *blob, uint32_t size, uint8_t *data)
 {
@@ -133,30 +164,181 @@ static TEEC_Result OpenSession(TEEC_Context *context, TEEC_Session **session)
     return ret;
 }
 
-static TEEC_Result TeecOpen(void)
+static void RegisterSlotSharedMemory(TEEC_Context *context, struct HksTeecSessionSlot *slot)
 {
-    if (g_context != NULL) {
-        return TEEC_SUCCESS;
+    uint8_t *buffer = (uint8_t *)HksMalloc(HKS_TEEC_SHARED_MEM_SIZE);
+    if (buffer == NULL) {
+        HKS_LOG_E("malloc shared memory failed, use temp memref instead");
+        return;
     }
 
-    g_context = HksMalloc(sizeof(TEEC_Context));
-    HKS_IF_NULL_LOGE_RETURN(g_context, TEEC_ERROR_OUT_OF_MEMORY, "memory allocate failed!")
+    (void)memset_s(&slot->sharedMem, sizeof(slot->sharedMem), 0, sizeof(slot->sharedMem));
+    slot->sharedMem.buffer = buffer;
+    slot->sharedMem.size = HKS_TEEC_SHARED_MEM_SIZE;
+    slot->sharedMem.flags = TEEC_MEM_INPUT | TEEC_MEM_OUTPUT;
+    TEEC_Result ret = TEEC_RegisterSharedMemory(context, &slot->sharedMem);
+    if (ret != TEEC_SUCCESS) {
+        HKS_LOG_E("register shared memory failed, ret=0x%" LOG_PUBLIC "x, use temp memref instead", ret);
+        HKS_FREE(buffer);
+        slot->sharedMem.buffer = NULL;
+        return;
+    }
+    slot->isSharedMemRegistered = true;
+}
 
-    TEEC_Result result = TEEC_InitializeContext(NULL, g_context);
-    if (result != TEEC_SUCCESS) {
-        HKS_LOG_E("Initialize TEE context failed, ret=0x%" LOG_PUBLIC "x", result);
-        HKS_FREE(g_context);
-        return result;
+static void CloseSlot(struct HksTeecSessionSlot *slot)
+{
+    if (slot->isSharedMemRegistered) {
+        TEEC_ReleaseSharedMemory(&slot->sharedMem);
+        (void)memset_s(slot->sharedMem.buffer, HKS_TEEC_SHARED_MEM_SIZE, 0, HKS_TEEC_SHARED_MEM_SIZE);
+        HKS_FREE(slot->sharedMem.buffer);
+        slot->sharedMem.buffer = NULL;
+        slot->isSharedMemRegistered = false;
+    }
+    if (slot->session != NULL) {
+        TEEC_CloseSession(slot->session);
+        HKS_FREE(slot->session);
+        slot->session = NULL;
+    }
+}
+
+static TEEC_Result OpenSlot(TEEC_Context *context, struct HksTeecSessionSlot *slot)
+{
+    TEEC_Result ret = OpenSession(context, &slot->session);
+    if (ret != TEEC_SUCCESS) {
+        return ret;
+    }
+    RegisterSlotSharedMemory(context, slot);
+    return TEEC_SUCCESS;
+}
+
+/* caller must hold g_sessionPoolLock */
+static TEEC_Result TeecOpenLocked(void)
+{
+    if (g_context == NULL) {
+        g_context = HksMalloc(sizeof(TEEC_Context));
+        HKS_IF_NULL_LOGE_RETURN(g_context, TEEC_ERROR_OUT_OF_MEMORY, "memory allocate failed!")
+
+        TEEC_Result result = TEEC_InitializeContext(NULL, g_context);
+        if (result != TEEC_SUCCESS) {
+            HKS_LOG_E("Initialize TEE context failed, ret=0x%" LOG_PUBLIC "x", result);
+            HKS_FREE(g_context);
+            return result;
+        }
     }
 
-    result = OpenSession(g_context, &g_sessionSelfStart);
-    if (result != TEEC_SUCCESS) {
+    TEEC_Result result = TEEC_SUCCESS;
+    uint32_t openedNum = 0;
+    for (uint32_t i = 0; i < HKS_TEEC_SESSION_POOL_SIZE; ++i) {
+        /*
+         * a checked out slot belongs to its request, which checks it in with its own state, and keeps the context
+         * in use: it counts as opened
+         */
+        if (g_sessionPool[i].isInUse) {
+            ++openedNum;
+            continue;
+        }
+        g_sessionPool[i].isDead = false;
+        if (g_sessionPool[i].session == NULL) {
+            TEEC_Result ret = OpenSlot(g_context, &g_sessionPool[i]);
+            if (ret != TEEC_SUCCESS) {
+                result = ret;
+                continue;
+            }
+        }
+        if (g_sessionPool[i].session != NULL) {
+            ++openedNum;
+        }
+    }
+
+    /*
+     * a partially filled pool still works with fewer sessions: the TA may limit the sessions of a client, so the
+     * slots that failed to open are not retried until the pool is opened again
+     */
+    if (openedNum == 0) {
         TEEC_FinalizeContext(g_context);
         HKS_FREE(g_context);
         HKS_LOG_E("Open Session failed!");
+        return result;
     }
+    HKS_LOG_I("teec session pool opened %" LOG_PUBLIC "u of %" LOG_PUBLIC "u", openedNum,
+        (uint32_t)HKS_TEEC_SESSION_POOL_SIZE);
+    return TEEC_SUCCESS;
+}
+
+static TEEC_Result TeecOpen(void)
+{
+    (void)pthread_mutex_lock(&g_sessionPoolLock);
+    TEEC_Result ret = TeecOpenLocked();
+    (void)pthread_mutex_unlock(&g_sessionPoolLock);
+    return ret;
+}
 
-    return result;
+/* returns an idle open session, else an idle slot whose session died, else NULL to wait for one checked in */
+static struct HksTeecSessionSlot *FindIdleSlotLocked(void)
+{
+    struct HksTeecSessionSlot *deadSlot = NULL;
+    for (uint32_t i = 0; i < HKS_TEEC_SESSION_POOL_SIZE; ++i) {
+        if (g_sessionPool[i].isInUse) {
+            continue;
+        }
+        if (g_sessionPool[i].session != NULL) {
+            return &g_sessionPool[i];
+        }
+        if (deadSlot == NULL && g_sessionPool[i].isDead) {
+            deadSlot = &g_sessionPool[i];
+        }
+    }
+    return deadSlot;
+}
+
+/* the state of a slot is only changed under g_sessionPoolLock, isDead tells whether its session died meanwhile */
+static void CheckInSessionSlot(struct HksTeecSessionSlot *slot, bool isDead)
+{
+    (void)pthread_mutex_lock(&g_sessionPoolLock);
+    slot->isDead = isDead;
+    slot->isInUse = false;
+    (void)pthread_cond_broadcast(&g_sessionPoolCond);
+    (void)pthread_mutex_unlock(&g_sessionPoolLock);
+}
+
+static TEEC_Result CheckOutSessionSlot(struct HksTeecSessionSlot **outSlot)
+{
+    (void)pthread_mutex_lock(&g_sessionPoolLock);
+    if (g_context == NULL) {
+        TEEC_Result ret = TeecOpenLocked();
+        if (ret != TEEC_SUCCESS) {
+            (void)pthread_mutex_unlock(&g_sessionPoolLock);
+            HKS_LOG_E("teec open failed!");
+            return ret;
+        }
+    }
+
+    struct HksTeecSessionSlot *slot = FindIdleSlotLocked();
+    while (slot == NULL) {
+        (void)pthread_cond_wait(&g_sessionPoolCond, &g_sessionPoolLock);
+        slot = FindIdleSlotLocked();
+    }
+    slot->isInUse = true;
+    TEEC_Context *context = g_context;
+    (void)pthread_mutex_unlock(&g_sessionPoolLock);
+
+    /*
+     * the slot is owned exclusively now, so a dead session can be replaced without the pool lock, and HksTeeClose
+     * waits for the slot before it finalizes the context
+     */
+    if (slot->session == NULL) {
+        TEEC_Result ret = OpenSlot(context, slot);
+        if (ret != TEEC_SUCCESS) {
+            /* the slot stays dead, the next checkout tries again */
+            HKS_LOG_E("reopen ta session failed, ret=0x%" LOG_PUBLIC "x", ret);
+            CheckInSessionSlot(slot, true);
+            return ret;
+        }
+    }
+
+    *outSlot = slot;
+    return TEEC_SUCCESS;
 }
 
 static void FillUpCommand(const TeecOpParam *src, TEEC_Parameter *des)
@@ -181,20 +363,124 @@ static void FillUpCommand(const TeecOpParam *src, TEEC_Parameter *des)
     }
 }
 
-static TEEC_Result TeecRequestCmdInner(enum HksCmdId pkiCmdId, TEEC_Operation *operation,
-    TeecOperation *teecOperation)
+static inline bool IsTempMemref(uint32_t paramType)
 {
-    TEEC_Result ret;
-    if (g_sessionSelfStart == NULL) {
-        ret = TeecOpen();
-        if (ret != TEEC_SUCCESS) {
-            HKS_LOG_E("teec open failed!");
-            return ret;
+    return (paramType == TEEC_MEMREF_TEMP_INPUT) || (paramType == TEEC_MEMREF_TEMP_OUTPUT) ||
+        (paramType == TEEC_MEMREF_TEMP_INOUT);
+}
+
+static uint32_t TempMemrefToPartial(uint32_t paramType)
+{
+    switch (paramType) {
+        case TEEC_MEMREF_TEMP_INPUT:
+            return TEEC_MEMREF_PARTIAL_INPUT;
+        case TEEC_MEMREF_TEMP_OUTPUT:
+            return TEEC_MEMREF_PARTIAL_OUTPUT;
+        default:
+            return TEEC_MEMREF_PARTIAL_INOUT;
+    }
+}
+
+static inline size_t AlignSharedMemSize(size_t size)
+{
+    return (size + HKS_TEEC_SHARED_MEM_ALIGN - 1) & ~((size_t)HKS_TEEC_SHARED_MEM_ALIGN - 1);
+}
+
+/*
+ * Move the temp memrefs of the operation into the registered shared memory of the session, so that the driver
+ * does not need to allocate and map a bounce buffer for every parameter of every command.
+ */
+static void StageParamsInSharedMemory(struct HksTeecSessionSlot *slot, TEEC_Operation *operation,
+    struct HksTeecStagedParams *staged)
+{
+    staged->isStaged = false;
+    staged->paramTypes = operation->paramTypes;
+    if (!slot->isSharedMemRegistered) {
+        return;
+    }
+
+    size_t totalSize = 0;
+    for (uint32_t i = 0; i < MAX_TEE_PARAMS_NUMS; ++i) {
+        if (IsTempMemref(TEEC_PARAM_TYPE_GET(operation->paramTypes, i))) {
+            totalSize += AlignSharedMemSize(operation->params[i].tmpref.size);
+        }
+    }
+    if (totalSize == 0 || totalSize > slot->sharedMem.size) {
+        return;
+    }
+
+    uint32_t newTypes[MAX_TEE_PARAMS_NUMS] = { 0 };
+    size_t offset = 0;
+    uint8_t *base = (uint8_t *)slot->sharedMem.buffer;
+    for (uint32_t i = 0; i < MAX_TEE_PARAMS_NUMS; ++i) {
+        uint32_t type = TEEC_PARAM_TYPE_GET(operation->paramTypes, i);
+        newTypes[i] = type;
+        if (!IsTempMemref(type)) {
+            continue;
         }
+
+        TEEC_TempMemoryReference userRef = operation->params[i].tmpref;
+        staged->userRef[i] = userRef;
+        if (type != TEEC_MEMREF_TEMP_OUTPUT && userRef.size != 0) {
+            (void)memcpy_s(base + offset, slot->sharedMem.size - offset, userRef.buffer, userRef.size);
+        }
+        operation->params[i].memref.parent = &slot->sharedMem;
+        operation->params[i].memref.offset = offset;
+        operation->params[i].memref.size = userRef.size;
+        newTypes[i] = TempMemrefToPartial(type);
+        offset += AlignSharedMemSize(userRef.size);
+    }
+    operation->paramTypes = TEEC_PARAM_TYPES(newTypes[0], newTypes[1], newTypes[2], newTypes[3]); /* 2, 3 index */
+    staged->isStaged = true;
+}
+
+/* copy the outputs back to the user buffers and present the operation as temp memrefs again to the callers */
+static void UnstageParamsFromSharedMemory(struct HksTeecSessionSlot *slot, TEEC_Operation *operation,
+    const struct HksTeecStagedParams *staged)
+{
+    if (!staged->isStaged) {
+        return;
+    }
+
+    for (uint32_t i = 0; i < MAX_TEE_PARAMS_NUMS; ++i) {
+        uint32_t type = TEEC_PARAM_TYPE_GET(staged->paramTypes, i);
+        if (!IsTempMemref(type)) {
+            continue;
+        }
+
+        size_t outSize = operation->params[i].memref.size;
+        const uint8_t *src = (const uint8_t *)slot->sharedMem.buffer + operation->params[i].memref.offset;
+        if (type != TEEC_MEMREF_TEMP_INPUT && outSize != 0 && outSize <= staged->userRef[i].size) {
+            (void)memcpy_s(staged->userRef[i].buffer, staged->userRef[i].size, src, outSize);
+        }
+        (void)memset_s((uint8_t *)src, AlignSharedMemSize(staged->userRef[i].size), 0,
+            AlignSharedMemSize(staged->userRef[i].size));
+        operation->params[i].tmpref.buffer = staged->userRef[i].buffer;
+        operation->params[i].tmpref.size = outSize;
     }
+    operation->paramTypes = staged->paramTypes;
+}
+
+static TEEC_Result InvokeOnSlot(struct HksTeecSessionSlot *slot, enum HksCmdId pkiCmdId,
+    TEEC_Operation *operation, uint32_t *retOrigin)
+{
+    struct HksTeecStagedParams staged;
+    StageParamsInSharedMemory(slot, operation, &staged);
+    TEEC_Result ret = TEEC_InvokeCommand(slot->session, pkiCmdId, operation, retOrigin);
+    UnstageParamsFromSharedMemory(slot, operation, &staged);
+    return ret;
+}
+
+static TEEC_Result TeecRequestCmdInner(enum HksCmdId pkiCmdId, TEEC_Operation *operation,
+    TeecOperation *teecOperation)
+{
+    struct HksTeecSessionSlot *slot = NULL;
+    TEEC_Result ret = CheckOutSessionSlot(&slot);
+    HKS_IF_NOT_SUCC_LOGE_RETURN(ret, ret, "check out teec session failed!")
 
     if (memset_s(operation, sizeof(TEEC_Operation), 0, sizeof(TEEC_Operation)) != EOK) {
         HKS_LOG_E("memset for operation failed!");
+        CheckInSessionSlot(slot, false);
         return TEEC_ERROR_GENERIC;
     }
 
@@ -208,11 +494,20 @@ static TEEC_Result TeecRequestCmdInner(enum HksCmdId pkiCmdId, TEEC_Operation *o
     }
 
     uint32_t retOrigin = 0;
-    ret = TEEC_InvokeCommand(g_sessionSelfStart, pkiCmdId, operation, &retOrigin);
+    ret = InvokeOnSlot(slot, pkiCmdId, operation, &retOrigin);
     if (ret != TEEC_SUCCESS) {
         HKS_LOG_E("invoke km command failed, cmd = %" LOG_PUBLIC "u, ret = 0x%" LOG_PUBLIC "x, "
             "retOrigin = %" LOG_PUBLIC "u", pkiCmdId, ret, retOrigin);
     }
+    bool isDead = (ret == TEEC_ERROR_TARGET_DEAD);
+    if (isDead) {
+        /*
+         * the TA instance behind this session is gone, and with it any state the command may have changed before,
+         * so the command is not replayed: it fails, and the next request gets a new session
+         */
+        CloseSlot(slot);
+    }
+    CheckInSessionSlot(slot, isDead);
 
     return ret;
 }
@@ -266,6 +561,22 @@ int32_t HksTeeOpen(void)
     return TeecOpen();
 }
 
+void HksTeeClose(void)
+{
+    (void)pthread_mutex_lock(&g_sessionPoolLock);
+    for (uint32_t i = 0; i < HKS_TEEC_SESSION_POOL_SIZE; ++i) {
+        while (g_sessionPool[i].isInUse) {
+            (void)pthread_cond_wait(&g_sessionPoolCond, &g_sessionPoolLock);
+        }
+        CloseSlot(&g_sessionPool[i]);
+    }
+    if (g_context != NULL) {
+        TEEC_FinalizeContext(g_context);
+        HKS_FREE(g_context);
+    }
+    (void)pthread_mutex_unlock(&g_sessionPoolLock);
+}
+
 #ifdef HKS_SUPPORT_API_INJECT_KEY
 int32_t HksTeeProvision(const struct HksBlob *keybox, struct HksBlob *challenge,
     const struct HksBlob *challengeIn, struct HksBlob *signature, struct HksBlob *certData)
@@ -19,12 +19,19 @@
 #include <tee_client_type.h>
 #include "hks_type_inner.h"
 
+/* number of TA sessions kept open, commands from different IPC threads run on different sessions concurrently */
+#ifndef HKS_TEEC_SESSION_POOL_SIZE
+#define HKS_TEEC_SESSION_POOL_SIZE 4
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
 int32_t HksTeeOpen(void);
 
+void HksTeeClose(void);
+
 int32_t HksTeeGenerateKey(const struct HksBlob *keyBlob, const struct HksParamSet *paramSetIn,
     struct HksBlob *keyOut);
 
@@ -404,6 +404,44 @@ void HksIpcServiceVerify(const struct HksBlob *srcData, const uint8_t *context)
     HKS_FREE_BLOB(processInfo.userId);
 }
 
+void HksIpcServiceBatchVerify(const struct HksBlob *srcData, const uint8_t *context)
+{
+    struct HksBlob keyAlias = { 0, NULL };
+    struct HksParamSet *inParamSet = NULL;
+    struct HksBlob *unsignedData = NULL;
+    struct HksBlob *signature = NULL;
+    uint32_t count = 0;
+    struct HksBlob result = { 0, NULL };
+    struct HksProcessInfo processInfo = { { 0, NULL }, { 0, NULL }, 0, 0 };
+    int32_t ret;
+
+    do {
+        ret = HksBatchVerifyUnpack(srcData, &keyAlias, &inParamSet, &unsignedData, &signature, &count, &result);
+        HKS_IF_NOT_SUCC_LOGE_BREAK(ret, "HksBatchVerifyUnpack Ipc fail")
+
+        ret = HksGetProcessInfoForIPC(context, &processInfo);
+        HKS_IF_NOT_SUCC_LOGE_BREAK(ret, "HksGetProcessInfoForIPC fail, ret = %" LOG_PUBLIC "d", ret)
+
+        ret = HksCheckAcrossAccountsPermission(inParamSet, processInfo.userIdInt);
+        HKS_IF_NOT_SUCC_LOGE_BREAK(ret, "HksCheckAcrossAccountsPermission fail, ret = %" LOG_PUBLIC "d", ret)
+
+        ret = HksServiceBatchVerify(&processInfo, &keyAlias, inParamSet, unsignedData, signature, count, &result);
+        HKS_IF_NOT_SUCC_LOGE_BREAK(ret, "HksServiceBatchVerify fail")
+
+        HksSendResponse(context, ret, &result);
+    } while (0);
+
+    if (ret != HKS_SUCCESS) {
+        HksSendResponse(context, ret, NULL);
+    }
+
+    HKS_FREE(unsignedData);
+    HKS_FREE(signature);
+    HKS_FREE_BLOB(result);
+    HKS_FREE_BLOB(processInfo.processName);
+    HKS_FREE_BLOB(processInfo.userId);
+}
+
 void HksIpcServiceEncrypt(const struct HksBlob *srcData, const uint8_t *context)
 {
     struct HksBlob keyAlias = { 0, NULL };
@@ -42,6 +42,8 @@ void HksIpcServiceSign(const struct HksBlob *srcData, const uint8_t *context);
 
 void HksIpcServiceVerify(const struct HksBlob *srcData, const uint8_t *context);
 
+void HksIpcServiceBatchVerify(const struct HksBlob *srcData, const uint8_t *context);
+
 void HksIpcServiceEncrypt(const struct HksBlob *srcData, const uint8_t *context);
 
 void HksIpcServiceDecrypt(const struct HksBlob *srcData, const uint8_t *context);
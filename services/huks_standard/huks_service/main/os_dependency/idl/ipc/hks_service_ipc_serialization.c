@@ -330,6 +330,58 @@ int32_t HksVerifyUnpack(const struct HksBlob *srcData, struct HksBlob *key, stru
     return GetBlobFromBuffer(signature, srcData, &offset);
 }
 
+static int32_t BatchVerifyPairsUnpack(const struct HksBlob *srcData, struct HksBlob *unsignedData,
+    struct HksBlob *signature, uint32_t count, uint32_t *offset)
+{
+    for (uint32_t i = 0; i < count; ++i) {
+        int32_t ret = GetBlobFromBuffer(&unsignedData[i], srcData, offset);
+        HKS_IF_NOT_SUCC_LOGE_RETURN(ret, ret, "get unsignedData %" LOG_PUBLIC "u failed", i)
+
+        ret = GetBlobFromBuffer(&signature[i], srcData, offset);
+        HKS_IF_NOT_SUCC_LOGE_RETURN(ret, ret, "get signature %" LOG_PUBLIC "u failed", i)
+    }
+    return HKS_SUCCESS;
+}
+
+int32_t HksBatchVerifyUnpack(const struct HksBlob *srcData, struct HksBlob *key, struct HksParamSet **paramSet,
+    struct HksBlob **unsignedData, struct HksBlob **signature, uint32_t *count, struct HksBlob *result)
+{
+    uint32_t offset = 0;
+    int32_t ret = GetKeyAndParamSetFromBuffer(srcData, key, paramSet, &offset);
+    HKS_IF_NOT_SUCC_LOGE_RETURN(ret, ret, "getKeyAndParamSetFromBuffer failed")
+
+    ret = GetUint32FromBuffer(count, srcData, &offset);
+    HKS_IF_NOT_SUCC_LOGE_RETURN(ret, ret, "get count failed")
+    if (*count == 0 || *count > HKS_MAX_BATCH_VERIFY_COUNT) {
+        HKS_LOG_E("invalid batch verify count %" LOG_PUBLIC "u", *count);
+        return HKS_ERROR_INVALID_ARGUMENT;
+    }
+
+    /* the pairs only reference srcData, nothing but the two arrays is copied */
+    uint32_t arraySize = (*count) * sizeof(struct HksBlob);
+    *unsignedData = (struct HksBlob *)HksMalloc(arraySize);
+    HKS_IF_NULL_LOGE_RETURN(*unsignedData, HKS_ERROR_MALLOC_FAIL, "malloc unsignedData failed")
+    *signature = (struct HksBlob *)HksMalloc(arraySize);
+    if (*signature == NULL) {
+        HKS_FREE(*unsignedData);
+        return HKS_ERROR_MALLOC_FAIL;
+    }
+
+    do {
+        ret = BatchVerifyPairsUnpack(srcData, *unsignedData, *signature, *count, &offset);
+        HKS_IF_NOT_SUCC_BREAK(ret)
+
+        ret = MallocBlobFromBuffer(srcData, result, &offset);
+        HKS_IF_NOT_SUCC_LOGE(ret, "malloc result data failed")
+    } while (0);
+
+    if (ret != HKS_SUCCESS) {
+        HKS_FREE(*unsignedData);
+        HKS_FREE(*signature);
+    }
+    return ret;
+}
+
 int32_t HksEncryptDecryptUnpack(const struct HksBlob *srcData, struct HksBlob *key,
     struct HksParamSet **paramSet, struct HksBlob *inputText, struct HksBlob *outputText)
 {
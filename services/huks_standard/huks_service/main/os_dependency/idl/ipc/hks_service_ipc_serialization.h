@@ -50,6 +50,9 @@ int32_t HksSignUnpack(const struct HksBlob *srcData, struct HksBlob *key, struct
 int32_t HksVerifyUnpack(const struct HksBlob *srcData, struct HksBlob *key, struct HksParamSet **paramSet,
     struct HksBlob *unsignedData, struct HksBlob *signature);
 
+int32_t HksBatchVerifyUnpack(const struct HksBlob *srcData, struct HksBlob *key, struct HksParamSet **paramSet,
+    struct HksBlob **unsignedData, struct HksBlob **signature, uint32_t *count, struct HksBlob *result);
+
 int32_t HksEncryptDecryptUnpack(const struct HksBlob *srcData, struct HksBlob *key,
     struct HksParamSet **paramSet, struct HksBlob *inputText, struct HksBlob *outputText);
 
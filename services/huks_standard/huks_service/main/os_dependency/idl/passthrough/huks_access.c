@@ -200,6 +200,17 @@ ENABLE_CFI(int32_t HuksAccessVerify(const struct HksBlob *key, const struct HksP
     return g_hksHalDevicePtr->HuksHdiVerify(key, paramSet, srcData, signature);
 }
 
+ENABLE_CFI(int32_t HuksAccessBatchVerify(const struct HksBlob *key, const struct HksParamSet *paramSet,
+    const struct HksBlob *srcData, const struct HksBlob *signature, uint32_t count, struct HksBlob *result))
+{
+    HKS_IF_NOT_SUCC_RETURN(HksCreateHuksHdiDevice(&g_hksHalDevicePtr), HKS_ERROR_NULL_POINTER)
+
+    HKS_IF_NULL_LOGE_RETURN(g_hksHalDevicePtr->HuksHdiBatchVerify, HKS_ERROR_NULL_POINTER,
+        "BatchVerify function is null pointer")
+
+    return g_hksHalDevicePtr->HuksHdiBatchVerify(key, paramSet, srcData, signature, count, result);
+}
+
 ENABLE_CFI(int32_t HuksAccessEncrypt(const struct HksBlob *key, const struct HksParamSet *paramSet,
     const struct HksBlob *plainText, struct HksBlob *cipherText))
 {
@@ -21,6 +21,9 @@
 
 #include "huks_access.h"
 
+#include <pthread.h>
+
+#include "hdf_remote_service.h"
 #include "hks_cfi.h"
 #include "huks_hdi.h"
 #include "v1_0/ihuks.h"
@@ -29,39 +32,148 @@
 #include "hks_log.h"
 #include "hks_mem.h"
 #include "hks_template.h"
+#include "securec.h"
+
+/* an hks blob is { size, data } and a huks blob { data, dataLen }, so blobs are converted member by member, while
+ * a paramset is handed over as is, wrapped in a huks paramset pointing at it */
+_Static_assert(sizeof(((struct HuksBlob *)0)->dataLen) == sizeof(((struct HksBlob *)0)->size),
+    "blob size does not fit the hdi blob");
+_Static_assert(sizeof(((struct HuksParamSet *)0)->dataLen) == sizeof(((struct HksParamSet *)0)->paramSetSize),
+    "paramset size does not fit the hdi paramset");
 
+/*
+ * The hdi proxy, set once every entry the service calls is known to be set, so a call only checks that it is there.
+ * It is dropped when the hdi service dies and got again by the next call, which also initializes the module of the
+ * new service if the module was initialized. A dead proxy is not released, calls still running on it fail alone.
+ */
 static struct IHuks *g_hksHdiProxyInstance = NULL;
+static bool g_isHdiModuleInited = false;
+static pthread_mutex_t g_hdiProxyLock = PTHREAD_MUTEX_INITIALIZER;
 
+static bool IsHdiProxyComplete(const struct IHuks *proxy)
+{
+    if ((proxy->ModuleInit == NULL) || (proxy->ModuleDestroy == NULL) || (proxy->GenerateRandom == NULL)) {
+        return false;
+    }
 #ifndef _CUT_AUTHENTICATE_
-static int32_t InitHdiProxyInstance()
+    if ((proxy->GenerateKey == NULL) || (proxy->ImportKey == NULL) || (proxy->ImportWrappedKey == NULL) ||
+        (proxy->ExportPublicKey == NULL) || (proxy->Init == NULL) || (proxy->Update == NULL) ||
+        (proxy->Finish == NULL) || (proxy->Abort == NULL) || (proxy->CheckKeyValidity == NULL) ||
+        (proxy->Sign == NULL) || (proxy->Verify == NULL) || (proxy->Encrypt == NULL) || (proxy->Decrypt == NULL) ||
+        (proxy->AgreeKey == NULL) || (proxy->DeriveKey == NULL) || (proxy->Mac == NULL)) {
+        return false;
+    }
+#ifdef HKS_ENABLE_UPGRADE_KEY
+    if (proxy->UpgradeKey == NULL) {
+        return false;
+    }
+#endif
+#ifdef HKS_SUPPORT_API_ATTEST_KEY
+    if (proxy->AttestKey == NULL) {
+        return false;
+    }
+#endif
+#endif /* _CUT_AUTHENTICATE_ */
+#ifdef HKS_SUPPORT_CHIPSET_PLATFORM_DECRYPT
+    if (proxy->ExportChipsetPlatformPublicKey == NULL) {
+        return false;
+    }
+#endif
+    return true;
+}
+
+static void OnHdiServiceDied(struct HdfDeathRecipient *recipient, struct HdfRemoteService *service)
+{
+    (void)recipient;
+    (void)service;
+    HKS_LOG_E("hdi huks service died, the proxy is got again by the next call");
+    (void)pthread_mutex_lock(&g_hdiProxyLock);
+    __atomic_store_n(&g_hksHdiProxyInstance, NULL, __ATOMIC_RELEASE);
+    (void)pthread_mutex_unlock(&g_hdiProxyLock);
+}
+
+static struct HdfDeathRecipient g_hdiDeathRecipient = { .OnRemoteDied = OnHdiServiceDied };
+
+static void AddHdiDeathRecipient(struct IHuks *proxy)
 {
-    if (g_hksHdiProxyInstance != NULL) {
-        return HKS_SUCCESS;
+    if (proxy->AsObject == NULL) {
+        return;
     }
+    struct HdfRemoteService *remote = proxy->AsObject(proxy);
+    if (remote == NULL) {
+        /* passthrough instance, it lives in the process of the service */
+        return;
+    }
+    HdfRemoteServiceAddDeathRecipient(remote, &g_hdiDeathRecipient);
+}
 
-    g_hksHdiProxyInstance = IHuksGetInstance("hdi_service", true);
-    HKS_IF_NULL_LOGE_RETURN(g_hksHdiProxyInstance, HKS_ERROR_NULL_POINTER, "IHuksGet hdi huks service failed")
-    return HKS_SUCCESS;
+/* caller must hold g_hdiProxyLock */
+static struct IHuks *BuildHdiProxyLocked(void)
+{
+    struct IHuks *proxy = IHuksGetInstance("hdi_service", true);
+    HKS_IF_NULL_LOGE_RETURN(proxy, NULL, "IHuksGet hdi huks service failed")
+
+    if (!IsHdiProxyComplete(proxy)) {
+        HKS_LOG_E("hdi huks service lacks a function");
+        IHuksReleaseInstance("hdi_service", proxy, true);
+        return NULL;
+    }
+    if (g_isHdiModuleInited) {
+        int32_t ret = proxy->ModuleInit(proxy);
+        if (ret != HKS_SUCCESS) {
+            HKS_LOG_E("init module of the new hdi huks service failed, ret = %" LOG_PUBLIC "d", ret);
+            IHuksReleaseInstance("hdi_service", proxy, true);
+            return NULL;
+        }
+    }
+    AddHdiDeathRecipient(proxy);
+    __atomic_store_n(&g_hksHdiProxyInstance, proxy, __ATOMIC_RELEASE);
+    return proxy;
 }
 
-ENABLE_CFI(int32_t HuksAccessModuleInit(void))
+static struct IHuks *GetHdiProxy(void)
+{
+    struct IHuks *proxy = __atomic_load_n(&g_hksHdiProxyInstance, __ATOMIC_ACQUIRE);
+    if (proxy != NULL) {
+        return proxy;
+    }
+
+    (void)pthread_mutex_lock(&g_hdiProxyLock);
+    proxy = g_hksHdiProxyInstance;
+    if (proxy == NULL) {
+        proxy = BuildHdiProxyLocked();
+    }
+    (void)pthread_mutex_unlock(&g_hdiProxyLock);
+    return proxy;
+}
+
+#ifndef _CUT_AUTHENTICATE_
+static void SetHdiModuleInited(bool isInited)
 {
-    HKS_IF_NOT_SUCC_RETURN(InitHdiProxyInstance(), HKS_ERROR_NULL_POINTER)
+    (void)pthread_mutex_lock(&g_hdiProxyLock);
+    g_isHdiModuleInited = isInited;
+    (void)pthread_mutex_unlock(&g_hdiProxyLock);
+}
 
-    HKS_IF_NULL_LOGE_RETURN(g_hksHdiProxyInstance->ModuleInit, HKS_ERROR_NULL_POINTER,
-        "Module Init function is null pointer")
+ENABLE_CFI(int32_t HuksAccessModuleInit(void))
+{
+    struct IHuks *proxy = GetHdiProxy();
+    HKS_IF_NULL_RETURN(proxy, HKS_ERROR_NULL_POINTER)
 
-    return g_hksHdiProxyInstance->ModuleInit(g_hksHdiProxyInstance);
+    int32_t ret = proxy->ModuleInit(proxy);
+    if (ret == HKS_SUCCESS) {
+        SetHdiModuleInited(true);
+    }
+    return ret;
 }
 
 ENABLE_CFI(int32_t HuksAccessModuleDestroy(void))
 {
-    HKS_IF_NOT_SUCC_RETURN(InitHdiProxyInstance(), HKS_ERROR_NULL_POINTER)
+    struct IHuks *proxy = GetHdiProxy();
+    HKS_IF_NULL_RETURN(proxy, HKS_ERROR_NULL_POINTER)
 
-    HKS_IF_NULL_LOGE_RETURN(g_hksHdiProxyInstance->ModuleDestroy, HKS_ERROR_NULL_POINTER,
-        "Module Init function is null pointer")
-
-    return g_hksHdiProxyInstance->ModuleDestroy(g_hksHdiProxyInstance);
+    SetHdiModuleInited(false);
+    return proxy->ModuleDestroy(proxy);
 }
 
 ENABLE_CFI(int32_t HuksAccessRefresh(void))
@@ -72,12 +184,9 @@ ENABLE_CFI(int32_t HuksAccessRefresh(void))
 static int32_t HdiProxyGenerateKey(const struct HuksBlob* keyAlias, const struct HuksParamSet* paramSet,
     const struct HuksBlob* keyIn, struct HuksBlob* keyOut)
 {
-    HKS_IF_NOT_SUCC_RETURN(InitHdiProxyInstance(), HKS_ERROR_NULL_POINTER)
-
-    HKS_IF_NULL_LOGE_RETURN(g_hksHdiProxyInstance->GenerateKey, HKS_ERROR_NULL_POINTER,
-        "GenerateKey function is null pointer")
-
-    return g_hksHdiProxyInstance->GenerateKey(g_hksHdiProxyInstance, keyAlias, paramSet, keyIn, keyOut);
+    struct IHuks *proxy = GetHdiProxy();
+    HKS_IF_NULL_RETURN(proxy, HKS_ERROR_NULL_POINTER)
+    return proxy->GenerateKey(proxy, keyAlias, paramSet, keyIn, keyOut);
 }
 
 ENABLE_CFI(int32_t HuksAccessGenerateKey(const struct HksBlob *keyAlias, const struct HksParamSet *paramSetIn,
@@ -91,11 +200,9 @@ ENABLE_CFI(int32_t HuksAccessGenerateKey(const struct HksBlob *keyAlias, const s
 static int32_t HdiProxyImportKey(const struct HuksBlob *keyAlias, const struct HuksBlob *key,
     const struct HuksParamSet *paramSet, struct HuksBlob *keyOut)
 {
-    HKS_IF_NOT_SUCC_RETURN(InitHdiProxyInstance(), HKS_ERROR_NULL_POINTER)
-
-    HKS_IF_NULL_LOGE_RETURN(g_hksHdiProxyInstance->ImportKey, HKS_ERROR_NULL_POINTER,
-        "ImportKey function is null pointer")
-    return g_hksHdiProxyInstance->ImportKey(g_hksHdiProxyInstance, keyAlias, key, paramSet, keyOut);
+    struct IHuks *proxy = GetHdiProxy();
+    HKS_IF_NULL_RETURN(proxy, HKS_ERROR_NULL_POINTER)
+    return proxy->ImportKey(proxy, keyAlias, key, paramSet, keyOut);
 }
 
 ENABLE_CFI(int32_t HuksAccessImportKey(const struct HksBlob *keyAlias, const struct HksBlob *key,
@@ -109,11 +216,9 @@ ENABLE_CFI(int32_t HuksAccessImportKey(const struct HksBlob *keyAlias, const str
 static int32_t HdiProxyImportWrappedKey(const struct HuksBlob *wrappingKeyAlias, const struct HuksBlob *key,
     const struct HuksBlob *wrappedKeyData, const struct HuksParamSet *paramSet, struct HuksBlob *keyOut)
 {
-    HKS_IF_NOT_SUCC_RETURN(InitHdiProxyInstance(), HKS_ERROR_NULL_POINTER)
-
-    HKS_IF_NULL_LOGE_RETURN(g_hksHdiProxyInstance->ImportWrappedKey, HKS_ERROR_NULL_POINTER,
-        "ImportWrappedKey function is null pointer")
-    return g_hksHdiProxyInstance->ImportWrappedKey(g_hksHdiProxyInstance, wrappingKeyAlias, key, wrappedKeyData,
+    struct IHuks *proxy = GetHdiProxy();
+    HKS_IF_NULL_RETURN(proxy, HKS_ERROR_NULL_POINTER)
+    return proxy->ImportWrappedKey(proxy, wrappingKeyAlias, key, wrappedKeyData,
         paramSet, keyOut);
 }
 
@@ -129,11 +234,9 @@ ENABLE_CFI(int32_t HuksAccessImportWrappedKey(const struct HksBlob *wrappingKeyA
 static int32_t HdiProxyExportPublicKey(const struct HuksBlob *key, const struct HuksParamSet *paramSet,
     struct HuksBlob *keyOut)
 {
-    HKS_IF_NOT_SUCC_RETURN(InitHdiProxyInstance(), HKS_ERROR_NULL_POINTER)
-
-    HKS_IF_NULL_LOGE_RETURN(g_hksHdiProxyInstance->ExportPublicKey, HKS_ERROR_NULL_POINTER,
-        "ExportPublicKey function is null pointer")
-    return g_hksHdiProxyInstance->ExportPublicKey(g_hksHdiProxyInstance, key, paramSet, keyOut);
+    struct IHuks *proxy = GetHdiProxy();
+    HKS_IF_NULL_RETURN(proxy, HKS_ERROR_NULL_POINTER)
+    return proxy->ExportPublicKey(proxy, key, paramSet, keyOut);
 }
 
 ENABLE_CFI(int32_t HuksAccessExportPublicKey(const struct HksBlob *key, const struct HksParamSet *paramSet,
@@ -147,11 +250,9 @@ ENABLE_CFI(int32_t HuksAccessExportPublicKey(const struct HksBlob *key, const st
 static int32_t HdiProxyInit(const struct  HuksBlob *key, const struct HuksParamSet *paramSet,
     struct HuksBlob *handle, struct HuksBlob *token)
 {
-    HKS_IF_NOT_SUCC_RETURN(InitHdiProxyInstance(), HKS_ERROR_NULL_POINTER)
-
-    HKS_IF_NULL_LOGE_RETURN(g_hksHdiProxyInstance->Init, HKS_ERROR_NULL_POINTER,
-        "Init function is null pointer")
-    return g_hksHdiProxyInstance->Init(g_hksHdiProxyInstance, key, paramSet, handle, token);
+    struct IHuks *proxy = GetHdiProxy();
+    HKS_IF_NULL_RETURN(proxy, HKS_ERROR_NULL_POINTER)
+    return proxy->Init(proxy, key, paramSet, handle, token);
 }
 
 ENABLE_CFI(int32_t HuksAccessInit(const struct  HksBlob *key, const struct HksParamSet *paramSet,
@@ -165,11 +266,9 @@ ENABLE_CFI(int32_t HuksAccessInit(const struct  HksBlob *key, const struct HksPa
 static int32_t HdiProxyUpdate(const struct HuksBlob *handle, const struct HuksParamSet *paramSet,
     const struct HuksBlob *inData, struct HuksBlob *outData)
 {
-    HKS_IF_NOT_SUCC_RETURN(InitHdiProxyInstance(), HKS_ERROR_NULL_POINTER)
-
-    HKS_IF_NULL_LOGE_RETURN(g_hksHdiProxyInstance->Update, HKS_ERROR_NULL_POINTER,
-        "Update function is null pointer")
-    return g_hksHdiProxyInstance->Update(g_hksHdiProxyInstance, handle, paramSet, inData, outData);
+    struct IHuks *proxy = GetHdiProxy();
+    HKS_IF_NULL_RETURN(proxy, HKS_ERROR_NULL_POINTER)
+    return proxy->Update(proxy, handle, paramSet, inData, outData);
 }
 
 ENABLE_CFI(int32_t HuksAccessUpdate(const struct HksBlob *handle, const struct HksParamSet *paramSet,
@@ -183,11 +282,9 @@ ENABLE_CFI(int32_t HuksAccessUpdate(const struct HksBlob *handle, const struct H
 static int32_t HdiProxyFinish(const struct HuksBlob *handle, const struct HuksParamSet *paramSet,
     const struct HuksBlob *inData, struct HuksBlob *outData)
 {
-    HKS_IF_NOT_SUCC_RETURN(InitHdiProxyInstance(), HKS_ERROR_NULL_POINTER)
-
-    HKS_IF_NULL_LOGE_RETURN(g_hksHdiProxyInstance->Finish, HKS_ERROR_NULL_POINTER,
-        "Finish function is null pointer")
-    return g_hksHdiProxyInstance->Finish(g_hksHdiProxyInstance, handle, paramSet, inData, outData);
+    struct IHuks *proxy = GetHdiProxy();
+    HKS_IF_NULL_RETURN(proxy, HKS_ERROR_NULL_POINTER)
+    return proxy->Finish(proxy, handle, paramSet, inData, outData);
 }
 
 ENABLE_CFI(int32_t HuksAccessFinish(const struct HksBlob *handle, const struct HksParamSet *paramSet,
@@ -200,11 +297,9 @@ ENABLE_CFI(int32_t HuksAccessFinish(const struct HksBlob *handle, const struct H
 
 static int32_t HdiProxyAbort(const struct HuksBlob *handle, const struct HuksParamSet *paramSet)
 {
-    HKS_IF_NOT_SUCC_RETURN(InitHdiProxyInstance(), HKS_ERROR_NULL_POINTER)
-
-    HKS_IF_NULL_LOGE_RETURN(g_hksHdiProxyInstance->Abort, HKS_ERROR_NULL_POINTER,
-        "Abort function is null pointer")
-    return g_hksHdiProxyInstance->Abort(g_hksHdiProxyInstance, handle, paramSet);
+    struct IHuks *proxy = GetHdiProxy();
+    HKS_IF_NULL_RETURN(proxy, HKS_ERROR_NULL_POINTER)
+    return proxy->Abort(proxy, handle, paramSet);
 }
 
 ENABLE_CFI(int32_t HuksAccessAbort(const struct HksBlob *handle, const struct HksParamSet *paramSet))
@@ -216,12 +311,9 @@ ENABLE_CFI(int32_t HuksAccessAbort(const struct HksBlob *handle, const struct Hk
 
 static int32_t HdiProxyCheckKeyValidity(const struct HuksParamSet* paramSet, const struct HuksBlob* key)
 {
-    HKS_IF_NOT_SUCC_RETURN(InitHdiProxyInstance(), HKS_ERROR_NULL_POINTER)
-
-    HKS_IF_NULL_LOGE_RETURN(g_hksHdiProxyInstance->CheckKeyValidity, HKS_ERROR_NULL_POINTER,
-        "GetKeyProperties function is null pointer")
-
-    return g_hksHdiProxyInstance->CheckKeyValidity(g_hksHdiProxyInstance, paramSet, key);
+    struct IHuks *proxy = GetHdiProxy();
+    HKS_IF_NULL_RETURN(proxy, HKS_ERROR_NULL_POINTER)
+    return proxy->CheckKeyValidity(proxy, paramSet, key);
 }
 
 ENABLE_CFI(int32_t HuksAccessGetKeyProperties(const struct HksParamSet *paramSet, const struct HksBlob *key))
@@ -245,11 +337,9 @@ ENABLE_CFI(int32_t HuksAccessGetHardwareInfo(void))
 static int32_t HdiProxySign(const struct HuksBlob *key, const struct HuksParamSet *paramSet,
     const struct HuksBlob *srcData, struct HuksBlob *signature)
 {
-    HKS_IF_NOT_SUCC_RETURN(InitHdiProxyInstance(), HKS_ERROR_NULL_POINTER)
-
-    HKS_IF_NULL_LOGE_RETURN(g_hksHdiProxyInstance->Sign, HKS_ERROR_NULL_POINTER,
-        "Sign function is null pointer")
-    return g_hksHdiProxyInstance->Sign(g_hksHdiProxyInstance, key, paramSet, srcData, signature);
+    struct IHuks *proxy = GetHdiProxy();
+    HKS_IF_NULL_RETURN(proxy, HKS_ERROR_NULL_POINTER)
+    return proxy->Sign(proxy, key, paramSet, srcData, signature);
 }
 
 ENABLE_CFI(int32_t HuksAccessSign(const struct HksBlob *key, const struct HksParamSet *paramSet,
@@ -263,11 +353,9 @@ ENABLE_CFI(int32_t HuksAccessSign(const struct HksBlob *key, const struct HksPar
 static int32_t HdiProxyVerify(const struct HuksBlob *key, const struct HuksParamSet *paramSet,
     const struct HuksBlob *srcData, const struct HuksBlob *signature)
 {
-    HKS_IF_NOT_SUCC_RETURN(InitHdiProxyInstance(), HKS_ERROR_NULL_POINTER)
-
-    HKS_IF_NULL_LOGE_RETURN(g_hksHdiProxyInstance->Verify, HKS_ERROR_NULL_POINTER,
-        "Verify function is null pointer")
-    return g_hksHdiProxyInstance->Verify(g_hksHdiProxyInstance, key, paramSet, srcData, signature);
+    struct IHuks *proxy = GetHdiProxy();
+    HKS_IF_NULL_RETURN(proxy, HKS_ERROR_NULL_POINTER)
+    return proxy->Verify(proxy, key, paramSet, srcData, signature);
 }
 
 ENABLE_CFI(int32_t HuksAccessVerify(const struct HksBlob *key, const struct HksParamSet *paramSet,
@@ -278,14 +366,28 @@ ENABLE_CFI(int32_t HuksAccessVerify(const struct HksBlob *key, const struct HksP
     return ret;
 }
 
+/* the idl interface has no batch entry, so each pair still crosses into the huks core on its own */
+ENABLE_CFI(int32_t HuksAccessBatchVerify(const struct HksBlob *key, const struct HksParamSet *paramSet,
+    const struct HksBlob *srcData, const struct HksBlob *signature, uint32_t count, struct HksBlob *result))
+{
+    if (result == NULL || result->data == NULL || result->size < HKS_BATCH_VERIFY_RESULT_SIZE(count)) {
+        return HKS_ERROR_INVALID_ARGUMENT;
+    }
+    (void)memset_s(result->data, result->size, 0, result->size);
+    for (uint32_t i = 0; i < count; ++i) {
+        if (HuksAccessVerify(key, paramSet, &srcData[i], &signature[i]) == HKS_SUCCESS) {
+            result->data[i / HKS_BITS_PER_BYTE] |= (uint8_t)(1u << (i % HKS_BITS_PER_BYTE));
+        }
+    }
+    return HKS_SUCCESS;
+}
+
 static int32_t HdiProxyEncrypt(const struct HuksBlob *key, const struct HuksParamSet *paramSet,
     const struct HuksBlob *plainText, struct HuksBlob *cipherText)
 {
-    HKS_IF_NOT_SUCC_RETURN(InitHdiProxyInstance(), HKS_ERROR_NULL_POINTER)
-
-    HKS_IF_NULL_LOGE_RETURN(g_hksHdiProxyInstance->Encrypt, HKS_ERROR_NULL_POINTER,
-        "Encrypt function is null pointer")
-    return g_hksHdiProxyInstance->Encrypt(g_hksHdiProxyInstance, key, paramSet, plainText, cipherText);
+    struct IHuks *proxy = GetHdiProxy();
+    HKS_IF_NULL_RETURN(proxy, HKS_ERROR_NULL_POINTER)
+    return proxy->Encrypt(proxy, key, paramSet, plainText, cipherText);
 }
 
 ENABLE_CFI(int32_t HuksAccessEncrypt(const struct HksBlob *key, const struct HksParamSet *paramSet,
@@ -299,11 +401,9 @@ ENABLE_CFI(int32_t HuksAccessEncrypt(const struct HksBlob *key, const struct Hks
 static int32_t HdiProxyDecrypt(const struct HuksBlob *key, const struct HuksParamSet *paramSet,
     const struct HuksBlob *cipherText, struct HuksBlob *plainText)
 {
-    HKS_IF_NOT_SUCC_RETURN(InitHdiProxyInstance(), HKS_ERROR_NULL_POINTER)
-
-    HKS_IF_NULL_LOGE_RETURN(g_hksHdiProxyInstance->Decrypt, HKS_ERROR_NULL_POINTER,
-        "Decrypt function is null pointer")
-    return g_hksHdiProxyInstance->Decrypt(g_hksHdiProxyInstance, key, paramSet, cipherText, plainText);
+    struct IHuks *proxy = GetHdiProxy();
+    HKS_IF_NULL_RETURN(proxy, HKS_ERROR_NULL_POINTER)
+    return proxy->Decrypt(proxy, key, paramSet, cipherText, plainText);
 }
 
 ENABLE_CFI(int32_t HuksAccessDecrypt(const struct HksBlob *key, const struct HksParamSet *paramSet,
@@ -317,11 +417,9 @@ ENABLE_CFI(int32_t HuksAccessDecrypt(const struct HksBlob *key, const struct Hks
 static int32_t HdiProxyAgreeKey(const struct HuksParamSet *paramSet, const struct HuksBlob *privateKey,
     const struct HuksBlob *peerPublicKey, struct HuksBlob *agreedKey)
 {
-    HKS_IF_NOT_SUCC_RETURN(InitHdiProxyInstance(), HKS_ERROR_NULL_POINTER)
-
-    HKS_IF_NULL_LOGE_RETURN(g_hksHdiProxyInstance->AgreeKey, HKS_ERROR_NULL_POINTER,
-        "AgreeKey function is null pointer")
-    return g_hksHdiProxyInstance->AgreeKey(g_hksHdiProxyInstance, paramSet, privateKey, peerPublicKey, agreedKey);
+    struct IHuks *proxy = GetHdiProxy();
+    HKS_IF_NULL_RETURN(proxy, HKS_ERROR_NULL_POINTER)
+    return proxy->AgreeKey(proxy, paramSet, privateKey, peerPublicKey, agreedKey);
 }
 
 ENABLE_CFI(int32_t HuksAccessAgreeKey(const struct HksParamSet *paramSet, const struct HksBlob *privateKey,
@@ -335,11 +433,9 @@ ENABLE_CFI(int32_t HuksAccessAgreeKey(const struct HksParamSet *paramSet, const
 static int32_t HdiProxyDeriveKey(const struct HuksParamSet *paramSet, const struct HuksBlob *kdfKey,
     struct HuksBlob *derivedKey)
 {
-    HKS_IF_NOT_SUCC_RETURN(InitHdiProxyInstance(), HKS_ERROR_NULL_POINTER)
-
-    HKS_IF_NULL_LOGE_RETURN(g_hksHdiProxyInstance->DeriveKey, HKS_ERROR_NULL_POINTER,
-        "DeriveKey function is null pointer")
-    return g_hksHdiProxyInstance->DeriveKey(g_hksHdiProxyInstance, paramSet, kdfKey, derivedKey);
+    struct IHuks *proxy = GetHdiProxy();
+    HKS_IF_NULL_RETURN(proxy, HKS_ERROR_NULL_POINTER)
+    return proxy->DeriveKey(proxy, paramSet, kdfKey, derivedKey);
 }
 
 ENABLE_CFI(int32_t HuksAccessDeriveKey(const struct HksParamSet *paramSet, const struct HksBlob *kdfKey,
@@ -353,11 +449,9 @@ ENABLE_CFI(int32_t HuksAccessDeriveKey(const struct HksParamSet *paramSet, const
 static int32_t HdiProxyMac(const struct HuksBlob *key, const struct HuksParamSet *paramSet,
     const struct HuksBlob *srcData, struct HuksBlob *mac)
 {
-    HKS_IF_NOT_SUCC_RETURN(InitHdiProxyInstance(), HKS_ERROR_NULL_POINTER)
-
-    HKS_IF_NULL_LOGE_RETURN(g_hksHdiProxyInstance->Mac, HKS_ERROR_NULL_POINTER,
-        "Mac function is null pointer")
-    return g_hksHdiProxyInstance->Mac(g_hksHdiProxyInstance, key, paramSet, srcData, mac);
+    struct IHuks *proxy = GetHdiProxy();
+    HKS_IF_NULL_RETURN(proxy, HKS_ERROR_NULL_POINTER)
+    return proxy->Mac(proxy, key, paramSet, srcData, mac);
 }
 
 ENABLE_CFI(int32_t HuksAccessMac(const struct HksBlob *key, const struct HksParamSet *paramSet,
@@ -372,11 +466,9 @@ ENABLE_CFI(int32_t HuksAccessMac(const struct HksBlob *key, const struct HksPara
 static int32_t HdiProxyUpgradeKey(const struct HuksBlob *oldKey, const struct HuksParamSet *paramSet,
     struct HuksBlob *newKey)
 {
-    HKS_IF_NOT_SUCC_RETURN(InitHdiProxyInstance(), HKS_ERROR_NULL_POINTER)
-
-    HKS_IF_NULL_LOGE_RETURN(g_hksHdiProxyInstance->UpgradeKey, HKS_ERROR_NULL_POINTER,
-        "Change key owner function is null pointer")
-    return g_hksHdiProxyInstance->UpgradeKey(g_hksHdiProxyInstance, oldKey, paramSet, newKey);
+    struct IHuks *proxy = GetHdiProxy();
+    HKS_IF_NULL_RETURN(proxy, HKS_ERROR_NULL_POINTER)
+    return proxy->UpgradeKey(proxy, oldKey, paramSet, newKey);
 }
 
 ENABLE_CFI(int32_t HuksAccessUpgradeKey(const struct HksBlob *oldKey, const struct HksParamSet *paramSet,
@@ -392,11 +484,9 @@ ENABLE_CFI(int32_t HuksAccessUpgradeKey(const struct HksBlob *oldKey, const stru
 static int32_t HdiProxyAttestKey(const struct HuksBlob *key, const struct HuksParamSet *paramSet,
     struct HuksBlob *certChain)
 {
-    HKS_IF_NOT_SUCC_RETURN(InitHdiProxyInstance(), HKS_ERROR_NULL_POINTER)
-
-    HKS_IF_NULL_LOGE_RETURN(g_hksHdiProxyInstance->AttestKey, HKS_ERROR_NULL_POINTER,
-        "AttestKey function is null pointer")
-    return g_hksHdiProxyInstance->AttestKey(g_hksHdiProxyInstance, key, paramSet, certChain);
+    struct IHuks *proxy = GetHdiProxy();
+    HKS_IF_NULL_RETURN(proxy, HKS_ERROR_NULL_POINTER)
+    return proxy->AttestKey(proxy, key, paramSet, certChain);
 }
 
 ENABLE_CFI(int32_t HuksAccessAttestKey(const struct HksBlob *key, const struct HksParamSet *paramSet,
@@ -412,11 +502,9 @@ ENABLE_CFI(int32_t HuksAccessAttestKey(const struct HksBlob *key, const struct H
 
 static int32_t HdiProxyGenerateRandom(const struct HuksParamSet *paramSet, struct HuksBlob *random)
 {
-    HKS_IF_NOT_SUCC_RETURN(InitHdiProxyInstance(), HKS_ERROR_NULL_POINTER)
-
-    HKS_IF_NULL_LOGE_RETURN(g_hksHdiProxyInstance->GenerateRandom, HKS_ERROR_NULL_POINTER,
-        "GenerateRandom function is null pointer")
-    return g_hksHdiProxyInstance->GenerateRandom(g_hksHdiProxyInstance, paramSet, random);
+    struct IHuks *proxy = GetHdiProxy();
+    HKS_IF_NULL_RETURN(proxy, HKS_ERROR_NULL_POINTER)
+    return proxy->GenerateRandom(proxy, paramSet, random);
 }
 
 ENABLE_CFI(int32_t HuksAccessGenerateRandom(const struct HksParamSet *paramSet, struct HksBlob *random))
@@ -430,11 +518,9 @@ ENABLE_CFI(int32_t HuksAccessGenerateRandom(const struct HksParamSet *paramSet,
 static int32_t HdiProxyExportChipsetPlatformPublicKey(const struct HuksBlob *salt,
     enum HuksChipsetPlatformDecryptScene scene, struct HuksBlob *publicKey)
 {
-    HKS_IF_NOT_SUCC_RETURN(InitHdiProxyInstance(), HKS_ERROR_NULL_POINTER)
-
-    HKS_IF_NULL_LOGE_RETURN(g_hksHdiProxyInstance->ExportChipsetPlatformPublicKey, HKS_ERROR_NULL_POINTER,
-        "ExportChipsetPlatformPublicKey function is null pointer")
-    return g_hksHdiProxyInstance->ExportChipsetPlatformPublicKey(g_hksHdiProxyInstance, salt, scene, publicKey);
+    struct IHuks *proxy = GetHdiProxy();
+    HKS_IF_NULL_RETURN(proxy, HKS_ERROR_NULL_POINTER)
+    return proxy->ExportChipsetPlatformPublicKey(proxy, salt, scene, publicKey);
 }
 
 ENABLE_CFI(int32_t HuksAccessExportChipsetPlatformPublicKey(const struct HksBlob *salt,
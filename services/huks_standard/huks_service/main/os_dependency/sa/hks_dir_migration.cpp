@@ -0,0 +1,140 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hks_dir_migration.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <dirent.h>
+#include <fcntl.h>
+#include <filesystem>
+#include <string>
+#include <sys/stat.h>
+#include <system_error>
+#include <unistd.h>
+#include <vector>
+
+#include "hks_log.h"
+#include "hks_template.h"
+#include "hks_type_enum.h"
+
+namespace OHOS {
+namespace Security {
+namespace Hks {
+namespace {
+int32_t MoveEntry(const std::string &src, const std::string &dst);
+
+// the copy and remove of the former migration, only used when src and dst are on different file systems
+int32_t CopyEntry(const std::string &src, const std::string &dst)
+{
+    std::error_code errCode{};
+    std::filesystem::copy(src, dst,
+        std::filesystem::copy_options::recursive | std::filesystem::copy_options::overwrite_existing, errCode);
+    if (errCode.value() != 0) {
+        HKS_LOG_E("copy %" LOG_PUBLIC "s to %" LOG_PUBLIC "s failed %" LOG_PUBLIC "s",
+            src.c_str(), dst.c_str(), errCode.message().c_str());
+        return HKS_ERROR_WRITE_FILE_FAIL;
+    }
+    std::filesystem::remove_all(src, errCode);
+    if (errCode.value() != 0) {
+        HKS_LOG_E("remove_all %" LOG_PUBLIC "s failed %" LOG_PUBLIC "s", src.c_str(), errCode.message().c_str());
+        return HKS_ERROR_REMOVE_FILE_FAIL;
+    }
+    return HKS_SUCCESS;
+}
+
+int32_t MergeDir(const std::string &oldDir, const std::string &newDir)
+{
+    DIR *dir = opendir(oldDir.c_str());
+    if (dir == nullptr) {
+        HKS_LOG_E("open dir %" LOG_PUBLIC "s failed, errno %" LOG_PUBLIC "d", oldDir.c_str(), errno);
+        return HKS_ERROR_OPEN_FILE_FAIL;
+    }
+    // the names are read first, whether readdir returns entries renamed meanwhile is unspecified
+    std::vector<std::string> names;
+    for (struct dirent *dire = readdir(dir); dire != nullptr; dire = readdir(dir)) {
+        if (strcmp(dire->d_name, ".") != 0 && strcmp(dire->d_name, "..") != 0) {
+            names.emplace_back(dire->d_name);
+        }
+    }
+    (void)closedir(dir);
+
+    int32_t ret = HKS_SUCCESS;
+    for (const std::string &name : names) {
+        int32_t entryRet = MoveEntry(oldDir + "/" + name, newDir + "/" + name);
+        if (entryRet != HKS_SUCCESS) {
+            ret = entryRet;
+        }
+    }
+    HKS_IF_NOT_SUCC_RETURN(ret, ret)
+
+    if (rmdir(oldDir.c_str()) != 0) {
+        HKS_LOG_E("rmdir %" LOG_PUBLIC "s failed, errno %" LOG_PUBLIC "d", oldDir.c_str(), errno);
+        return HKS_ERROR_REMOVE_FILE_FAIL;
+    }
+    return HKS_SUCCESS;
+}
+
+int32_t MoveEntry(const std::string &src, const std::string &dst)
+{
+    if (rename(src.c_str(), dst.c_str()) == 0) {
+        return HKS_SUCCESS;
+    }
+    int err = errno;
+    if (err == EXDEV) {
+        return CopyEntry(src, dst);
+    }
+    // a directory only replaces an empty one, the content of both is merged instead
+    if (err == ENOTEMPTY || err == EEXIST) {
+        return MergeDir(src, dst);
+    }
+    HKS_LOG_E("rename %" LOG_PUBLIC "s to %" LOG_PUBLIC "s failed, errno %" LOG_PUBLIC "d",
+        src.c_str(), dst.c_str(), err);
+    return HKS_ERROR_WRITE_FILE_FAIL;
+}
+}
+
+int32_t HksMigrateDirectory(const char *oldDir, const char *newDir, const char *markerPath)
+{
+    if (access(markerPath, F_OK) == 0) {
+        return HKS_SUCCESS;
+    }
+
+    struct stat oldStat;
+    if (lstat(oldDir, &oldStat) == 0) {
+        int32_t ret = MoveEntry(oldDir, newDir);
+        HKS_IF_NOT_SUCC_LOGE_RETURN(ret, ret, "migrate %" LOG_PUBLIC "s failed, retry on next start", oldDir)
+        HKS_LOG_I("migrate %" LOG_PUBLIC "s to %" LOG_PUBLIC "s ok!", oldDir, newDir);
+    } else if (errno != ENOENT) {
+        HKS_LOG_E("stat %" LOG_PUBLIC "s failed, errno %" LOG_PUBLIC "d", oldDir, errno);
+        return HKS_ERROR_OPEN_FILE_FAIL;
+    } else if (mkdir(newDir, S_IRWXU) != 0 && errno != EEXIST) {
+        HKS_LOG_E("mkdir %" LOG_PUBLIC "s failed, errno %" LOG_PUBLIC "d", newDir, errno);
+        return HKS_ERROR_MAKE_DIR_FAIL;
+    }
+
+    int fd = open(markerPath, O_WRONLY | O_CREAT | O_CLOEXEC, S_IRUSR | S_IWUSR);
+    if (fd < 0) {
+        // the migration is done anyway, only the next start checks oldDir again
+        HKS_LOG_E("create marker %" LOG_PUBLIC "s failed, errno %" LOG_PUBLIC "d", markerPath, errno);
+        return HKS_SUCCESS;
+    }
+    (void)close(fd);
+    return HKS_SUCCESS;
+}
+}
+}
+}
@@ -0,0 +1,32 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef HKS_DIR_MIGRATION_H
+#define HKS_DIR_MIGRATION_H
+
+#include <stdint.h>
+
+namespace OHOS {
+namespace Security {
+namespace Hks {
+// Moves the content of oldDir into newDir and removes oldDir, an entry already in newDir is replaced by the one
+// from oldDir. Entries are renamed, and only copied when oldDir and newDir are on different file systems. Once
+// oldDir is gone the empty file markerPath is created, and later calls return at once while it exists.
+int32_t HksMigrateDirectory(const char *oldDir, const char *newDir, const char *markerPath);
+}
+}
+}
+
+#endif // HKS_DIR_MIGRATION_H
@@ -0,0 +1,387 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hks_event_aggregator.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <fcntl.h>
+#include <fstream>
+#include <mutex>
+#include <pthread.h>
+#include <set>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utility>
+
+#include "hks_client_service.h"
+#include "hks_log.h"
+#include "hks_mem.h"
+#include "hks_template.h"
+#include "hks_type_inner.h"
+#include "hks_upgrade_lock.h"
+#include "rwlock.h"
+
+#include "securec.h"
+
+#define USER_ID_ROOT                  "0"
+
+static void GetProcessInfo(int userId, int uid, struct HksProcessInfo *processInfo)
+{
+    uint32_t userSize = sizeof(userId);
+    if (userId == 0) {
+        userSize = strlen(USER_ID_ROOT);
+    }
+    uint8_t *userData = static_cast<uint8_t *>(HksMalloc(userSize));
+    if (userData == nullptr) {
+        HKS_LOG_E("user id malloc failed.");
+        return;
+    }
+    if (userId == 0) {
+        (void)memcpy_s(userData, userSize, USER_ID_ROOT, userSize);
+    } else {
+        (void)memcpy_s(userData, userSize, &userId, userSize);
+    }
+    processInfo->userId.size = userSize;
+    processInfo->userId.data = userData;
+    processInfo->userIdInt = userId;
+
+    uint32_t uidSize = sizeof(uid);
+    uint8_t *uidData = static_cast<uint8_t *>(HksMalloc(uidSize));
+    if (uidData == nullptr) {
+        HKS_LOG_E("uid malloc failed.");
+        HKS_FREE(userData);
+        processInfo->userId.data = nullptr;
+        return;
+    }
+    (void)memcpy_s(uidData, uidSize, &uid, uidSize);
+    processInfo->processName.size = uidSize;
+    processInfo->processName.data = uidData;
+}
+
+static void GetUserId(int userId, struct HksBlob *userIdBlob)
+{
+    uint32_t userIdSize = sizeof(userId);
+    uint8_t *userIdData = static_cast<uint8_t *>(HksMalloc(userIdSize));
+    if (userIdData == nullptr) {
+        HKS_LOG_E("uid malloc failed.");
+        return;
+    }
+    (void)memcpy_s(userIdData, userIdSize, &userId, userIdSize);
+    userIdBlob->size = userIdSize;
+    userIdBlob->data = userIdData;
+}
+
+namespace OHOS {
+namespace Security {
+namespace Hks {
+namespace {
+constexpr int USER_REMOVAL_UID = -1;
+constexpr int REMOVAL_THREAD_NICE = 19;
+
+// userId and uid of a package, USER_REMOVAL_UID for every package of the user
+using RemovalKey = std::pair<int, int>;
+
+std::mutex g_aggregatorLock;
+std::condition_variable g_aggregatorCond;
+std::set<RemovalKey> g_pending;   // waiting for the next batch
+std::set<RemovalKey> g_batch;     // taken by the running batch and not yet run
+std::set<int> g_queuedUids;       // uids of g_pending and g_batch
+std::multiset<int> g_runningUids; // uids of the removals of packages running
+uint32_t g_runningCount = 0;
+// g_pending, g_batch and the removals running, read without the lock by every request
+std::atomic<uint32_t> g_queuedCount { 0 };
+bool g_isRunning = false;
+int64_t g_firstEventMs = 0;
+int64_t g_lastEventMs = 0;
+HksEventAggregatorConfig g_config = { HKS_REMOVAL_WINDOW_MS, HKS_REMOVAL_MAX_DELAY_MS, HKS_PENDING_REMOVAL_PATH };
+HksEventAggregatorStats g_stats = { 0, 0, 0, 0, 0 };
+
+int64_t NowMs()
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void RunRemoval(const RemovalKey &key)
+{
+    struct HksProcessInfo processInfo = { { 0, nullptr }, { 0, nullptr } };
+    if (key.second == USER_REMOVAL_UID) {
+        GetUserId(key.first, &(processInfo.userId));
+    } else {
+        GetProcessInfo(key.first, key.second, &processInfo);
+    }
+    if (processInfo.userId.data != nullptr) {
+        HksServiceDeleteProcessInfo(&processInfo);
+    }
+    HKS_FREE_BLOB(processInfo.userId);
+    HKS_FREE_BLOB(processInfo.processName);
+}
+
+void UpdateQueuedCountLocked()
+{
+    g_queuedCount.store(static_cast<uint32_t>(g_pending.size() + g_batch.size()) + g_runningCount,
+        std::memory_order_release);
+}
+
+void AppendPendingLocked(const RemovalKey &key)
+{
+    int32_t record[] = { key.first, key.second };
+    int fd = open(g_config.pendingPath.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, S_IRUSR | S_IWUSR);
+    if (fd < 0) {
+        HKS_LOG_E("open pending removal file failed, errno %" LOG_PUBLIC "d", errno);
+        return;
+    }
+    if (write(fd, record, sizeof(record)) != static_cast<ssize_t>(sizeof(record))) {
+        HKS_LOG_E("write pending removal file failed, errno %" LOG_PUBLIC "d", errno);
+    }
+    (void)close(fd);
+}
+
+void RemovePendingFileIfDoneLocked()
+{
+    if (g_queuedCount.load(std::memory_order_relaxed) != 0) {
+        return;
+    }
+    if (unlink(g_config.pendingPath.c_str()) != 0 && errno != ENOENT) {
+        HKS_LOG_E("remove pending removal file failed, errno %" LOG_PUBLIC "d", errno);
+    }
+}
+
+bool IsQueuedLocked(const RemovalKey &key)
+{
+    RemovalKey userKey = { key.first, USER_REMOVAL_UID };
+    return g_pending.count(key) != 0 || g_batch.count(key) != 0 || g_pending.count(userKey) != 0 ||
+        g_batch.count(userKey) != 0;
+}
+
+// drops the queued removals of the packages of userId, the removal of the user covers them
+void MergeIntoUserLocked(std::set<RemovalKey> &queue, int userId)
+{
+    auto begin = queue.upper_bound({ userId, USER_REMOVAL_UID });
+    auto end = begin;
+    for (; end != queue.end() && end->first == userId; ++end) {
+        (void)g_queuedUids.erase(end->second);
+        ++g_stats.mergedCount;
+    }
+    (void)queue.erase(begin, end);
+}
+
+void *AggregatorThread(void *arg);
+
+void StartThreadLocked()
+{
+    if (g_isRunning) {
+        return;
+    }
+    pthread_t thread;
+    if (pthread_create(&thread, nullptr, AggregatorThread, nullptr) != 0) {
+        HKS_LOG_E("create removal thread failed, removals run on the next start.");
+        return;
+    }
+    pthread_setname_np(thread, "HUKS_REMOVAL");
+    (void)pthread_detach(thread);
+    g_isRunning = true;
+}
+
+void QueueLocked(const RemovalKey &key, bool isPersisted)
+{
+    ++g_stats.receivedCount;
+    if (IsQueuedLocked(key)) {
+        ++g_stats.mergedCount;
+        return;
+    }
+    if (key.second == USER_REMOVAL_UID) {
+        MergeIntoUserLocked(g_pending, key.first);
+        MergeIntoUserLocked(g_batch, key.first);
+    } else {
+        (void)g_queuedUids.insert(key.second);
+    }
+    if (!isPersisted) {
+        AppendPendingLocked(key);
+    }
+    int64_t now = NowMs();
+    if (g_pending.empty()) {
+        g_firstEventMs = now;
+    }
+    g_lastEventMs = now;
+    (void)g_pending.insert(key);
+    UpdateQueuedCountLocked();
+    StartThreadLocked();
+}
+
+void TakeLocked(std::set<RemovalKey> &queue, const RemovalKey &key)
+{
+    (void)queue.erase(key);
+    if (key.second != USER_REMOVAL_UID) {
+        (void)g_queuedUids.erase(key.second);
+        (void)g_runningUids.insert(key.second);
+    }
+    ++g_runningCount;
+}
+
+void FinishLocked(const RemovalKey &key)
+{
+    if (key.second != USER_REMOVAL_UID) {
+        (void)g_runningUids.erase(g_runningUids.find(key.second));
+    }
+    --g_runningCount;
+    ++g_stats.removedCount;
+    UpdateQueuedCountLocked();
+    RemovePendingFileIfDoneLocked();
+    g_aggregatorCond.notify_all();
+}
+
+// waits until the removals calm down, false once nothing is left to run
+bool WaitBatchLocked(std::unique_lock<std::mutex> &lock)
+{
+    for (;;) {
+        if (g_pending.empty()) {
+            return false;
+        }
+        int64_t now = NowMs();
+        int64_t waitMs = std::min(g_lastEventMs + g_config.windowMs - now, g_firstEventMs + g_config.maxDelayMs - now);
+        if (waitMs <= 0) {
+            return true;
+        }
+        (void)g_aggregatorCond.wait_for(lock, std::chrono::milliseconds(waitMs));
+    }
+}
+
+void RunBatchLocked(std::unique_lock<std::mutex> &lock)
+{
+    ++g_stats.batchCount;
+    g_batch.swap(g_pending);
+    HKS_LOG_I("run a batch of %" LOG_PUBLIC "u removals.", static_cast<uint32_t>(g_batch.size()));
+    for (;;) {
+        lock.unlock();
+        // taken before the removal is marked running, a request waiting for it may hold its read guard meanwhile
+        OHOS::Utils::UniqueReadGuard<OHOS::Utils::RWLock> readGuard(g_upgradeOrRequestLock);
+        lock.lock();
+        if (g_batch.empty()) {
+            return;
+        }
+        RemovalKey key = *g_batch.begin();
+        TakeLocked(g_batch, key);
+        lock.unlock();
+        RunRemoval(key);
+        lock.lock();
+        FinishLocked(key);
+    }
+}
+
+void *AggregatorThread(void *arg)
+{
+    (void)arg;
+    if (setpriority(PRIO_PROCESS, static_cast<id_t>(gettid()), REMOVAL_THREAD_NICE) != 0) {
+        HKS_LOG_E("lower removal thread priority failed.");
+    }
+    if (HksWaitIfPowerOnUpgrading() != HKS_SUCCESS) {
+        HKS_LOG_E("wait on upgrading failed.");
+    }
+    std::unique_lock<std::mutex> lock(g_aggregatorLock);
+    while (WaitBatchLocked(lock)) {
+        RunBatchLocked(lock);
+    }
+    g_isRunning = false;
+    g_aggregatorCond.notify_all();
+    HKS_LOG_I("removals done, %" LOG_PUBLIC "u received, %" LOG_PUBLIC "u merged, %" LOG_PUBLIC "u run.",
+        g_stats.receivedCount, g_stats.mergedCount, g_stats.removedCount);
+    return nullptr;
+}
+}
+
+void HksEventAggregatorAddPackageRemoved(int userId, int uid)
+{
+    if (uid < 0) {
+        HKS_LOG_E("package removal without uid is dropped.");
+        return;
+    }
+    std::lock_guard<std::mutex> lock(g_aggregatorLock);
+    QueueLocked({ userId, uid }, false);
+    g_aggregatorCond.notify_all();
+}
+
+void HksEventAggregatorAddUserRemoved(int userId)
+{
+    std::lock_guard<std::mutex> lock(g_aggregatorLock);
+    QueueLocked({ userId, USER_REMOVAL_UID }, false);
+    g_aggregatorCond.notify_all();
+}
+
+void HksEventAggregatorFlushUid(int uid)
+{
+    if (g_queuedCount.load(std::memory_order_acquire) == 0) {
+        return;
+    }
+    std::unique_lock<std::mutex> lock(g_aggregatorLock);
+    g_aggregatorCond.wait(lock, [uid] { return g_runningUids.count(uid) == 0; });
+    if (g_queuedUids.count(uid) == 0) {
+        return;
+    }
+    auto isOfUid = [uid](const RemovalKey &key) { return key.second == uid; };
+    std::set<RemovalKey> &queue = std::any_of(g_pending.begin(), g_pending.end(), isOfUid) ? g_pending : g_batch;
+    RemovalKey key = *std::find_if(queue.begin(), queue.end(), isOfUid);
+    TakeLocked(queue, key);
+    lock.unlock();
+    HKS_LOG_I("run the queued removal of uid %" LOG_PUBLIC "d before its request.", uid);
+    // the caller holds the read guard of requests
+    RunRemoval(key);
+    lock.lock();
+    FinishLocked(key);
+}
+
+void HksEventAggregatorResume(void)
+{
+    std::lock_guard<std::mutex> lock(g_aggregatorLock);
+    std::ifstream file(g_config.pendingPath, std::ios::binary);
+    int32_t record[] = { 0, 0 };
+    uint32_t count = 0;
+    while (file.read(reinterpret_cast<char *>(record), sizeof(record))) {
+        QueueLocked({ record[0], record[1] }, true);
+        ++count;
+    }
+    if (count > 0) {
+        HKS_LOG_I("resume %" LOG_PUBLIC "u pending removals.", count);
+        g_aggregatorCond.notify_all();
+    }
+}
+
+void HksEventAggregatorGetStats(HksEventAggregatorStats &stats)
+{
+    std::lock_guard<std::mutex> lock(g_aggregatorLock);
+    stats = g_stats;
+    stats.queuedCount = g_queuedCount.load(std::memory_order_relaxed);
+}
+
+void HksEventAggregatorSetConfig(const HksEventAggregatorConfig &config)
+{
+    std::lock_guard<std::mutex> lock(g_aggregatorLock);
+    g_config = config;
+}
+
+bool HksEventAggregatorWaitDone(uint32_t timeoutMs)
+{
+    std::unique_lock<std::mutex> lock(g_aggregatorLock);
+    return g_aggregatorCond.wait_for(lock, std::chrono::milliseconds(timeoutMs),
+        [] { return g_queuedCount.load(std::memory_order_relaxed) == 0 && !g_isRunning; });
+}
+}
+}
+}
@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef HKS_EVENT_AGGREGATOR_H
+#define HKS_EVENT_AGGREGATOR_H
+
+#include <cstdint>
+#include <string>
+
+/* removals queued and not yet run, read back on the next start of the service */
+#ifndef HKS_PENDING_REMOVAL_PATH
+#define HKS_PENDING_REMOVAL_PATH "/data/service/el1/public/huks_service/.pending_removals"
+#endif
+
+/* a batch starts once no removal has arrived for this long */
+#ifndef HKS_REMOVAL_WINDOW_MS
+#define HKS_REMOVAL_WINDOW_MS 200
+#endif
+
+/* or once its first removal has waited this long, under a steady stream of removals */
+#ifndef HKS_REMOVAL_MAX_DELAY_MS
+#define HKS_REMOVAL_MAX_DELAY_MS 2000
+#endif
+
+namespace OHOS {
+namespace Security {
+namespace Hks {
+struct HksEventAggregatorConfig {
+    uint32_t windowMs;
+    uint32_t maxDelayMs;
+    std::string pendingPath;
+};
+
+struct HksEventAggregatorStats {
+    uint32_t queuedCount;   // removals waiting for a batch or running
+    uint32_t receivedCount;
+    uint32_t mergedCount;   // removals already queued, or covered by the removal of their user
+    uint32_t removedCount;  // key removals run
+    uint32_t batchCount;
+};
+
+// The removals of packages and users are queued per (userId, uid), a duplicate is dropped and the removal of a user
+// covers the removals of its packages. A low priority thread runs the queue as one batch once the removals calm
+// down. Every queued removal is appended to the pending file first, which is removed once the queue is empty.
+void HksEventAggregatorAddPackageRemoved(int userId, int uid);
+
+void HksEventAggregatorAddUserRemoved(int userId);
+
+// Called before every request of uid, runs the queued removal of uid first so that the keys of an app installed
+// again under the same uid are not removed by the batch of its former removal.
+void HksEventAggregatorFlushUid(int uid);
+
+// Queues the removals of the pending file, left by a service that stopped before running them.
+void HksEventAggregatorResume(void);
+
+void HksEventAggregatorGetStats(HksEventAggregatorStats &stats);
+
+void HksEventAggregatorSetConfig(const HksEventAggregatorConfig &config);
+
+// Waits until the queue is empty and its thread stopped, false if timeoutMs elapses first.
+bool HksEventAggregatorWaitDone(uint32_t timeoutMs);
+}
+}
+}
+
+#endif // HKS_EVENT_AGGREGATOR_H
@@ -20,18 +20,16 @@
 #ifdef HAS_OS_ACCOUNT_PART
 #include "os_account_manager.h"
 #endif
-#include "hks_client_service.h"
+#include "hks_event_aggregator.h"
 #include "hks_log.h"
-#include "hks_mem.h"
 #include "hks_plugin_adapter.h"
-#include "hks_type_inner.h"
+#include "hks_storage.h"
+#include "hks_storage_key_cache.h"
 #include "hks_template.h"
+#include "hks_type_inner.h"
 #include "hks_upgrade.h"
 #include "hks_upgrade_lock.h"
 
-#include "securec.h"
-
-#define USER_ID_ROOT                  "0"
 #ifndef HAS_OS_ACCOUNT_PART
 constexpr static int UID_TRANSFORM_DIVISOR = 200000;
 static void GetOsAccountIdFromUid(int uid, int &osAccountId)
@@ -40,52 +38,6 @@ static void GetOsAccountIdFromUid(int uid, int &osAccountId)
 }
 #endif // HAS_OS_ACCOUNT_PART
 
-static void GetProcessInfo(int userId, int uid, struct HksProcessInfo *processInfo)
-{
-    uint32_t userSize = sizeof(userId);
-    if (userId == 0) {
-        userSize = strlen(USER_ID_ROOT);
-    }
-    uint8_t *userData = static_cast<uint8_t *>(HksMalloc(userSize));
-    if (userData == nullptr) {
-        HKS_LOG_E("user id malloc failed.");
-        return;
-    }
-    if (userId == 0) {
-        (void)memcpy_s(userData, userSize, USER_ID_ROOT, userSize);
-    } else {
-        (void)memcpy_s(userData, userSize, &userId, userSize);
-    }
-    processInfo->userId.size = userSize;
-    processInfo->userId.data = userData;
-    processInfo->userIdInt = userId;
-
-    uint32_t uidSize = sizeof(uid);
-    uint8_t *uidData = static_cast<uint8_t *>(HksMalloc(uidSize));
-    if (uidData == nullptr) {
-        HKS_LOG_E("uid malloc failed.");
-        HKS_FREE(userData);
-        processInfo->userId.data = nullptr;
-        return;
-    }
-    (void)memcpy_s(uidData, uidSize, &uid, uidSize);
-    processInfo->processName.size = uidSize;
-    processInfo->processName.data = uidData;
-}
-
-static void GetUserId(int userId, struct HksBlob *userIdBlob)
-{
-    uint32_t userIdSize = sizeof(userId);
-    uint8_t *userIdData = static_cast<uint8_t *>(HksMalloc(userIdSize));
-    if (userIdData == nullptr) {
-        HKS_LOG_E("uid malloc failed.");
-        return;
-    }
-    (void)memcpy_s(userIdData, userIdSize, &userId, userIdSize);
-    userIdBlob->size = userIdSize;
-    userIdBlob->data = userIdData;
-}
-
 namespace OHOS {
 namespace Security {
 namespace Hks {
@@ -96,19 +48,11 @@ const int32_t BACKUP_UID = 1089;
 
 void SystemEventSubscriber::OnReceiveEvent(const OHOS::EventFwk::CommonEventData &data)
 {
-    struct HksProcessInfo processInfo = { { 0, nullptr }, { 0, nullptr } };
-
     auto want = data.GetWant();
     constexpr const char* UID = "uid";
     std::string action = want.GetAction();
 
-    // judge whether is upgrading, wait for upgrade finished
-    if (HksWaitIfPowerOnUpgrading() != HKS_SUCCESS) {
-        HKS_LOG_E("wait on upgrading failed.");
-        return;
-    }
-    OHOS::Utils::UniqueReadGuard<OHOS::Utils::RWLock> readGuard(g_upgradeOrRequestLock);
-
+    // removals are queued and run in batches by hks_event_aggregator, a storm of them costs one batch
     if (action == OHOS::EventFwk::CommonEventSupport::COMMON_EVENT_PACKAGE_REMOVED ||
         action == OHOS::EventFwk::CommonEventSupport::COMMON_EVENT_SANDBOX_PACKAGE_REMOVED) {
         int uid = want.GetIntParam(UID, -1);
@@ -120,23 +64,33 @@ void SystemEventSubscriber::OnReceiveEvent(const OHOS::EventFwk::CommonEventData
 #endif // HAS_OS_ACCOUNT_PART
         HKS_LOG_I("HksService package removed: uid is %" LOG_PUBLIC "d userId is %" LOG_PUBLIC "d", uid, userId);
 
-        GetProcessInfo(userId, uid, &processInfo);
-        HksServiceDeleteProcessInfo(&processInfo);
+        HksEventAggregatorAddPackageRemoved(userId, uid);
     } else if (action == OHOS::EventFwk::CommonEventSupport::COMMON_EVENT_USER_REMOVED) {
         int userId = data.GetCode();
         HKS_LOG_I("HksService user removed: userId is %" LOG_PUBLIC "d", userId);
 
-        GetUserId(userId, &(processInfo.userId));
-        HksServiceDeleteProcessInfo(&processInfo);
+        HksEventAggregatorAddUserRemoved(userId);
     } else if (action == OHOS::EventFwk::CommonEventSupport::COMMON_EVENT_USER_UNLOCKED) {
         HKS_LOG_I("the credential-encrypted storage has become unlocked");
         int userId = data.GetCode();
         HKS_LOG_I("user %" LOG_PUBLIC "d unlocked.", userId);
+
+        // judge whether is upgrading, wait for upgrade finished
+        if (HksWaitIfPowerOnUpgrading() != HKS_SUCCESS) {
+            HKS_LOG_E("wait on upgrading failed.");
+            return;
+        }
+        OHOS::Utils::UniqueReadGuard<OHOS::Utils::RWLock> readGuard(g_upgradeOrRequestLock);
+#ifdef HKS_SUPPORT_KEY_CACHE
+        // keys of the ce store that were looked up while it was locked are cached as missing
+        HksKeyCacheClear();
+#endif
         HksUpgradeOnUserUnlock(userId);
+#ifdef HKS_ENABLE_EVENT_DELETE
+        HksServiceSweepUserDirTrash(static_cast<uint32_t>(userId));
+#endif
     }
 
-    HKS_FREE_BLOB(processInfo.userId);
-    HKS_FREE_BLOB(processInfo.processName);
     HksPluginOnReceiveEvent(&data);
 }
 
@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hks_request_dispatcher.h"
+
+#include "hks_log.h"
+#include "hks_type_enum.h"
+#include "huks_service_ipc_interface_code.h"
+
+namespace OHOS {
+namespace Security {
+namespace Hks {
+namespace {
+HksLaneLimiter &GetLaneLimiter(HksRequestLane lane)
+{
+    static HksLaneLimiter fastLane({ HKS_FAST_LANE_THREAD_NUM, HKS_FAST_LANE_QUEUE_DEPTH });
+    static HksLaneLimiter slowLane({ HKS_SLOW_LANE_THREAD_NUM, HKS_SLOW_LANE_QUEUE_DEPTH });
+    return (lane == HksRequestLane::SLOW) ? slowLane : fastLane;
+}
+}
+
+HksLaneLimiter::HksLaneLimiter(const HksLaneConfig &config) : config_(config)
+{
+}
+
+int32_t HksLaneLimiter::Enter()
+{
+    std::unique_lock<std::mutex> lock(lock_);
+    if (running_ < config_.threadNum) {
+        ++running_;
+        return HKS_SUCCESS;
+    }
+    if (waiting_ >= config_.queueDepth) {
+        HKS_LOG_E("lane is full, running %" LOG_PUBLIC "u, waiting %" LOG_PUBLIC "u", running_, waiting_);
+        return HKS_ERROR_SERVICE_BUSY;
+    }
+    ++waiting_;
+    cond_.wait(lock, [this] { return running_ < config_.threadNum; });
+    --waiting_;
+    ++running_;
+    return HKS_SUCCESS;
+}
+
+void HksLaneLimiter::Leave()
+{
+    {
+        std::lock_guard<std::mutex> lock(lock_);
+        --running_;
+    }
+    cond_.notify_one();
+}
+
+HksRequestLane HksGetRequestLane(uint32_t code, uint32_t srcDataSize)
+{
+    if (srcDataSize > HKS_SLOW_LANE_DATA_SIZE) {
+        return HksRequestLane::SLOW;
+    }
+    switch (code) {
+        case HKS_MSG_GEN_KEY:
+        case HKS_MSG_IMPORT_WRAPPED_KEY:
+        case HKS_MSG_ATTEST_KEY:
+        case HKS_MSG_ATTEST_KEY_ASYNC_REPLY:
+            return HksRequestLane::SLOW;
+        default:
+            return HksRequestLane::FAST;
+    }
+}
+
+HksLaneGuard::HksLaneGuard(uint32_t code, uint32_t srcDataSize)
+    : HksLaneGuard(GetLaneLimiter(HksGetRequestLane(code, srcDataSize)))
+{
+}
+
+HksLaneGuard::HksLaneGuard(HksLaneLimiter &limiter) : limiter_(limiter), ret_(limiter.Enter())
+{
+}
+
+HksLaneGuard::~HksLaneGuard()
+{
+    if (ret_ == HKS_SUCCESS) {
+        limiter_.Leave();
+    }
+}
+}
+}
+}
@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef HKS_REQUEST_DISPATCHER_H
+#define HKS_REQUEST_DISPATCHER_H
+
+#include <condition_variable>
+#include <mutex>
+#include <stdint.h>
+
+/* ipc threads of the service, a request runs on the thread that received it */
+#ifndef HUKS_IPC_THREAD_NUM
+#define HUKS_IPC_THREAD_NUM 16
+#endif
+
+/* key generation, attestation, wrapped key import and requests carrying more than HKS_SLOW_LANE_DATA_SIZE bytes */
+#ifndef HKS_SLOW_LANE_THREAD_NUM
+#define HKS_SLOW_LANE_THREAD_NUM 3
+#endif
+
+/* every other message of hks_message_handler.h */
+#ifndef HKS_FAST_LANE_THREAD_NUM
+#define HKS_FAST_LANE_THREAD_NUM 6
+#endif
+
+/*
+ * Requests of a busy lane wait on their ipc thread up to the depth of its queue, more are refused. A storm of slow
+ * requests thus parks at most HKS_SLOW_LANE_THREAD_NUM + HKS_SLOW_LANE_QUEUE_DEPTH ipc threads and leaves the others
+ * to the fast lane.
+ */
+#ifndef HKS_SLOW_LANE_QUEUE_DEPTH
+#define HKS_SLOW_LANE_QUEUE_DEPTH (2 * HKS_SLOW_LANE_THREAD_NUM)
+#endif
+#ifndef HKS_FAST_LANE_QUEUE_DEPTH
+#define HKS_FAST_LANE_QUEUE_DEPTH HKS_FAST_LANE_THREAD_NUM
+#endif
+
+#ifndef HKS_SLOW_LANE_DATA_SIZE
+#define HKS_SLOW_LANE_DATA_SIZE (64 * 1024)
+#endif
+
+static_assert(HKS_SLOW_LANE_THREAD_NUM + HKS_FAST_LANE_THREAD_NUM < HUKS_IPC_THREAD_NUM,
+    "the running requests of the lanes may not hold every ipc thread");
+static_assert(HKS_SLOW_LANE_THREAD_NUM + HKS_SLOW_LANE_QUEUE_DEPTH + HKS_FAST_LANE_THREAD_NUM <= HUKS_IPC_THREAD_NUM,
+    "the slow lane may not park the ipc threads the fast lane runs on");
+
+namespace OHOS {
+namespace Security {
+namespace Hks {
+enum class HksRequestLane {
+    FAST = 0,
+    SLOW,
+};
+
+struct HksLaneConfig {
+    uint32_t threadNum;  /* requests of the lane running at once */
+    uint32_t queueDepth; /* requests of the lane waiting for one of them to finish, more are refused */
+};
+
+// Bounds the requests of a lane that run at once, so that slow requests cannot take every core from the fast ones.
+// Requests are run by the ipc thread that received them, a request waits on that thread until the lane has room,
+// and is refused with HKS_ERROR_SERVICE_BUSY only when the queue of the lane is full.
+class HksLaneLimiter {
+public:
+    explicit HksLaneLimiter(const HksLaneConfig &config);
+    int32_t Enter();
+    void Leave();
+
+private:
+    std::mutex lock_;
+    std::condition_variable cond_;
+    HksLaneConfig config_;
+    uint32_t running_ = 0;
+    uint32_t waiting_ = 0;
+};
+
+HksRequestLane HksGetRequestLane(uint32_t code, uint32_t srcDataSize);
+
+// Holds a place in the lane of a request for its lifetime, GetResult is HKS_ERROR_SERVICE_BUSY when it got none.
+class HksLaneGuard {
+public:
+    HksLaneGuard(uint32_t code, uint32_t srcDataSize);
+    explicit HksLaneGuard(HksLaneLimiter &limiter);
+    ~HksLaneGuard();
+    HksLaneGuard(const HksLaneGuard &) = delete;
+    HksLaneGuard &operator=(const HksLaneGuard &) = delete;
+
+    int32_t GetResult() const
+    {
+        return ret_;
+    }
+
+private:
+    HksLaneLimiter &limiter_;
+    int32_t ret_;
+};
+}
+}
+}
+
+#endif // HKS_REQUEST_DISPATCHER_H
@@ -23,15 +23,20 @@
 
 #include "hks_client_service.h"
 #include "hks_dcm_callback_handler.h"
+#include "hks_dir_migration.h"
 #include "hks_ipc_service.h"
 #include "hks_log.h"
 #include "hks_mem.h"
 #include "hks_message_handler.h"
 #include "hks_plugin_adapter.h"
+#include "hks_request_dispatcher.h"
 #include "hks_response.h"
 #include "hks_template.h"
 #include "hks_type_inner.h"
 #include "hks_upgrade.h"
+#ifdef HKS_ENABLE_UPGRADE_KEY
+#include "hks_upgrade_key_scheduler.h"
+#endif
 #include "hks_upgrade_lock.h"
 #include "hks_util.h"
 #include "huks_service_ipc_interface_code.h"
@@ -45,6 +50,7 @@
 #include <pthread.h>
 #include <unistd.h>
 
+#include "hks_event_aggregator.h"
 #include "hks_event_observer.h"
 #endif
 
@@ -68,7 +74,6 @@ REGISTER_SYSTEM_ABILITY_BY_ID(HksService, SA_ID_KEYSTORE_SERVICE, true);
 std::mutex HksService::instanceLock;
 sptr<HksService> HksService::instance;
 const uint32_t MAX_MALLOC_LEN = 1 * 1024 * 1024; /* max malloc size 1 MB */
-#define HUKS_IPC_THREAD_NUM 2
 #ifdef SUPPORT_COMMON_EVENT
 const uint32_t MAX_DELAY_TIMES = 100;
 #endif
@@ -240,6 +245,11 @@ static void ProcessRemoteRequest(uint32_t code, MessageParcel &data, MessageParc
             break;
         }
 
+        // waits here while the lane of the request is busy, before the buffer of the request is allocated
+        HksLaneGuard laneGuard(code, srcData.size);
+        ret = laneGuard.GetResult();
+        HKS_IF_NOT_SUCC_BREAK(ret)
+
         srcData.data = static_cast<uint8_t *>(HksMalloc(srcData.size));
         if (srcData.data == nullptr) {
             HKS_LOG_E("Malloc srcData failed.");
@@ -279,6 +289,12 @@ int HksService::OnRemoteRequest(uint32_t code, MessageParcel &data, MessageParce
         return HW_SYSTEM_ERROR;
     }
     OHOS::Utils::UniqueReadGuard<OHOS::Utils::RWLock> readGuard(g_upgradeOrRequestLock);
+#ifdef HKS_ENABLE_UPGRADE_KEY
+    HksUpgradeKeySchedulerNotifyRequest();
+#endif
+#ifdef SUPPORT_COMMON_EVENT
+    HksEventAggregatorFlushUid(IPCSkeleton::GetCallingUid());
+#endif
 
     if (code < HksIpcInterfaceCode::HKS_MSG_BASE || code >= HksIpcInterfaceCode::HKS_MSG_MAX) {
         int32_t ret = RetryLoadPlugin();
@@ -306,11 +322,13 @@ int HksService::OnRemoteRequest(uint32_t code, MessageParcel &data, MessageParce
 
 #define OLD_PATH "/data/service/el2/public/huks_service/maindata"
 #define NEW_PATH "/data/service/el1/public/huks_service/maindata"
+#define NEW_PATH_MIGRATED_MARKER "/data/service/el1/public/huks_service/.maindata_migrated"
 
 #ifdef HKS_USE_RKC_IN_STANDARD
 #define OLD_MINE_PATH "/data/data/huks_service/maindata"
 #define INTERMEDIATE_MINE_RKC_PATH "/data/service/el1/public/huks_service/maindata/hks_client"
 #define NEW_MINE_RKC_PATH "/data/data/huks_service/maindata/hks_client"
+#define NEW_MINE_RKC_PATH_MIGRATED_MARKER "/data/data/huks_service/.hks_client_migrated"
 
 #define DEFAULT_PATH_LEN 1024
 #endif
@@ -367,31 +385,6 @@ void MoveMineOldFile(const char *oldDir, const char *newDir)
 }
 #endif
 
-void MoveDirectoryTree(const char *oldDir, const char *newDir)
-{
-    std::error_code errCode{};
-    std::filesystem::create_directory(newDir, errCode);
-    if (errCode.value() != 0) {
-        HKS_LOG_E("create_directory %" LOG_PUBLIC "s failed %" LOG_PUBLIC "s", newDir, errCode.message().c_str());
-    } else {
-        HKS_LOG_I("create_directory %" LOG_PUBLIC "s ok!", newDir);
-    }
-    std::filesystem::copy(oldDir, newDir,
-        std::filesystem::copy_options::recursive | std::filesystem::copy_options::overwrite_existing, errCode);
-    if (errCode.value() != 0) {
-        HKS_LOG_E("copy %" LOG_PUBLIC "s to %" LOG_PUBLIC "s failed %" LOG_PUBLIC "s",
-            oldDir, newDir, errCode.message().c_str());
-        return;
-    }
-    HKS_LOG_I("copy %" LOG_PUBLIC "s to %" LOG_PUBLIC "s ok!", oldDir, newDir);
-    std::filesystem::remove_all(oldDir, errCode);
-    if (errCode.value() != 0) {
-        HKS_LOG_E("remove_all %" LOG_PUBLIC "s failed %" LOG_PUBLIC "s", oldDir, errCode.message().c_str());
-        return;
-    }
-    HKS_LOG_I("remove_all %" LOG_PUBLIC "s ok!", oldDir);
-}
-
 void HksService::OnStart()
 {
     HKS_LOG_I("HksService OnStart");
@@ -400,10 +393,10 @@ void HksService::OnStart()
         HKS_LOG_I("HksService has already started");
         return;
     }
-    MoveDirectoryTree(OLD_PATH, NEW_PATH);
+    (void)HksMigrateDirectory(OLD_PATH, NEW_PATH, NEW_PATH_MIGRATED_MARKER);
 #ifdef HKS_USE_RKC_IN_STANDARD
     // the intermediate mine's rkc is located in INTERMEDIATE_MINE_RKC_PATH, normal keys is located in NEW_PATH
-    MoveDirectoryTree(INTERMEDIATE_MINE_RKC_PATH, NEW_MINE_RKC_PATH);
+    (void)HksMigrateDirectory(INTERMEDIATE_MINE_RKC_PATH, NEW_MINE_RKC_PATH, NEW_MINE_RKC_PATH_MIGRATED_MARKER);
     // the original mine's rkc and normal keys are both located in OLD_MINE_PATH, should move all expect for rkc files
     MoveMineOldFile(OLD_MINE_PATH, NEW_PATH);
 #endif
@@ -434,6 +427,9 @@ void HksService::OnStart()
     }
     HksUpgradeOnPowerOnDoneNotifyAll();
 #endif
+#ifdef SUPPORT_COMMON_EVENT
+    HksEventAggregatorResume();
+#endif
 
     std::atomic_store(&runningState_, STATE_RUNNING);
     IPCSkeleton::SetMaxWorkThreadNum(HUKS_IPC_THREAD_NUM);
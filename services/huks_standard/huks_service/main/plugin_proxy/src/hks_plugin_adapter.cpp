@@ -15,6 +15,9 @@
 
 #include "hks_plugin_adapter.h"
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <dlfcn.h>
 
 #include "hks_cfi.h"
@@ -26,11 +29,30 @@
 #include "hks_template.h"
 #include "hks_type.h"
 
+/* a failed load is retried by the first caller after the interval, which doubles after each failure */
+#ifndef HKS_PLUGIN_RETRY_MIN_INTERVAL_MS
+#define HKS_PLUGIN_RETRY_MIN_INTERVAL_MS 1000
+#endif
+#ifndef HKS_PLUGIN_RETRY_MAX_INTERVAL_MS
+#define HKS_PLUGIN_RETRY_MAX_INTERVAL_MS (60 * 1000)
+#endif
+
+#define HKS_PLUGIN_LOCAL_REQUEST_MASK_BITS 64
+
 using HksGetPluginProxyFunc = struct HksPluginProxy *(*)();
 
+/* the plugin once it is initialized, published to g_loadedPlugin and never changed afterwards */
+struct HksLoadedPlugin {
+    struct HksPluginProxy *proxy;
+    uint64_t localRequestMask;
+};
+
 static void *g_pluginHandler = nullptr;
 static HksMutex *g_pluginMutex = nullptr;
-static struct HksPluginProxy *g_pluginProxy = nullptr;
+static struct HksLoadedPlugin g_loadedPluginInst = { nullptr, 0 };
+static std::atomic<const struct HksLoadedPlugin *> g_loadedPlugin { nullptr };
+static std::atomic<int64_t> g_nextRetryTimeMs { 0 };
+static int64_t g_retryIntervalMs = HKS_PLUGIN_RETRY_MIN_INTERVAL_MS; /* guarded by g_pluginMutex */
 
 static struct HksBasicInterface g_interfaceInst = {
     .hksManageStoreKeyBlob = HksManageStoreKeyBlob,
@@ -47,11 +69,16 @@ static struct HksBasicInterface g_interfaceInst = {
     .appendStorageParamsForQuery = AppendStorageLevelIfNotExist,
 };
 
-static void HksDestoryPluginProxy(void)
+static int64_t GetSteadyTimeMs(void)
 {
-    if (g_pluginProxy != nullptr) {
-        g_pluginProxy->hksPluginDestory();
-        g_pluginProxy = nullptr;
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+static void HksDestoryPluginProxy(struct HksPluginProxy *proxy)
+{
+    if (proxy != nullptr) {
+        proxy->hksPluginDestory();
     }
 
     if (g_pluginHandler != nullptr) {
@@ -60,36 +87,75 @@ static void HksDestoryPluginProxy(void)
     }
 }
 
-/* It is invoked when service initialize */
-ENABLE_CFI(static int32_t HksCreatePluginProxy(void))
+/* caller must hold g_pluginMutex */
+ENABLE_CFI(static int32_t LoadPluginLocked(void))
 {
-    if (HksMutexLock(g_pluginMutex) != HKS_SUCCESS) {
-        HKS_LOG_E("lock mutex for plugin proxy failed");
-        return HKS_ERROR_BAD_STATE;
-    }
-
+    struct HksPluginProxy *proxy = nullptr;
     int32_t ret = HKS_ERROR_NULL_POINTER;
     do {
-        if (g_pluginProxy != nullptr) {
-            ret = HKS_SUCCESS;
-            break;
-        }
-
         g_pluginHandler = dlopen("libhuks_ext.z.so", RTLD_NOW);
         HKS_IF_NULL_LOGE_BREAK(g_pluginHandler, "dlopen for plugin proxy failed")
 
         HksGetPluginProxyFunc func = (HksGetPluginProxyFunc)dlsym(g_pluginHandler, "HksGetPluginProxy");
         HKS_IF_NULL_LOGE_BREAK(func, "dlsym for plugin proxy failed")
 
-        g_pluginProxy = func();
-        HKS_IF_NULL_LOGE_BREAK(g_pluginProxy, "HksGetPluginProxy result is null")
+        proxy = func();
+        HKS_IF_NULL_LOGE_BREAK(proxy, "HksGetPluginProxy result is null")
 
-        ret = g_pluginProxy->hksPluginInit(&g_interfaceInst);
+        ret = proxy->hksPluginInit(&g_interfaceInst);
         HKS_IF_NOT_SUCC_LOGE_BREAK(ret, "init plugin failed, ret = %" LOG_PUBLIC "d", ret)
     } while (0);
 
     if (ret != HKS_SUCCESS) {
-        HksDestoryPluginProxy();
+        HksDestoryPluginProxy(proxy);
+        return ret;
+    }
+
+    HksGetPluginLocalRequestMaskFunc maskFunc =
+        (HksGetPluginLocalRequestMaskFunc)dlsym(g_pluginHandler, HKS_PLUGIN_LOCAL_REQUEST_MASK_FUNC);
+    g_loadedPluginInst.proxy = proxy;
+    g_loadedPluginInst.localRequestMask = (maskFunc != nullptr) ? maskFunc() : UINT64_MAX;
+    g_loadedPlugin.store(&g_loadedPluginInst, std::memory_order_release);
+    return HKS_SUCCESS;
+}
+
+/* caller must hold g_pluginMutex */
+static int32_t LoadPluginAfterRetryTimeLocked(void)
+{
+    if (GetSteadyTimeMs() < g_nextRetryTimeMs.load(std::memory_order_relaxed)) {
+        // another caller failed while this one waited for the mutex
+        return HKS_ERROR_LOAD_PLUGIN_FAIL;
+    }
+
+    int32_t ret = LoadPluginLocked();
+    if (ret != HKS_SUCCESS) {
+        HKS_LOG_W("load plugin failed, retry in %" LOG_PUBLIC "lld ms", (long long)g_retryIntervalMs);
+        g_nextRetryTimeMs.store(GetSteadyTimeMs() + g_retryIntervalMs, std::memory_order_relaxed);
+        g_retryIntervalMs = std::min<int64_t>(g_retryIntervalMs * 2, HKS_PLUGIN_RETRY_MAX_INTERVAL_MS);
+    }
+    return ret;
+}
+
+/*
+ * Loads the plugin once. Callers find a loaded plugin without taking the mutex, and a failed load is not tried again
+ * before its retry time, so bursts of requests and events neither wait on the mutex nor dlopen again and again.
+ */
+static int32_t HksCreatePluginProxy(void)
+{
+    if (g_loadedPlugin.load(std::memory_order_acquire) != nullptr) {
+        return HKS_SUCCESS;
+    }
+    if (GetSteadyTimeMs() < g_nextRetryTimeMs.load(std::memory_order_relaxed)) {
+        return HKS_ERROR_LOAD_PLUGIN_FAIL;
+    }
+
+    if (HksMutexLock(g_pluginMutex) != HKS_SUCCESS) {
+        HKS_LOG_E("lock mutex for plugin proxy failed");
+        return HKS_ERROR_BAD_STATE;
+    }
+    int32_t ret = HKS_SUCCESS;
+    if (g_loadedPlugin.load(std::memory_order_relaxed) == nullptr) {
+        ret = LoadPluginAfterRetryTimeLocked();
     }
     (void)HksMutexUnlock(g_pluginMutex);
     return ret;
@@ -124,20 +190,26 @@ int32_t HksInitPluginProxy(void)
 
 int32_t HksPluginOnRemoteRequest(uint32_t code, void *data, void *reply, void *option)
 {
-    return g_pluginProxy->hksPluginOnRemoteRequest(code, data, reply, option);
+    const struct HksLoadedPlugin *plugin = g_loadedPlugin.load(std::memory_order_acquire);
+    HKS_IF_NULL_LOGE_RETURN(plugin, HKS_ERROR_LOAD_PLUGIN_FAIL, "plugin is not loaded")
+    return plugin->proxy->hksPluginOnRemoteRequest(code, data, reply, option);
 }
 
 int32_t HksPluginOnLocalRequest(uint32_t code, const void *data, void *reply)
 {
-    if (g_pluginProxy == nullptr) {
+    const struct HksLoadedPlugin *plugin = g_loadedPlugin.load(std::memory_order_acquire);
+    if (plugin == nullptr) {
+        return HKS_SUCCESS;
+    }
+    if ((code < HKS_PLUGIN_LOCAL_REQUEST_MASK_BITS) && ((plugin->localRequestMask & (1ULL << code)) == 0)) {
         return HKS_SUCCESS;
     }
-    return g_pluginProxy->hksPluginOnLocalRequest(code, data, reply);
+    return plugin->proxy->hksPluginOnLocalRequest(code, data, reply);
 }
 
 void HksPluginOnReceiveEvent(const void *data)
 {
     if (RetryLoadPlugin() == HKS_SUCCESS) {
-        g_pluginProxy->hksPluginOnReceiveEvent(data);
+        g_loadedPlugin.load(std::memory_order_acquire)->proxy->hksPluginOnReceiveEvent(data);
     }
 }
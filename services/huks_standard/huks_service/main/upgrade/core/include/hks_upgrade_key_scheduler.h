@@ -0,0 +1,60 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef HKS_UPGRADE_KEY_SCHEDULER_H
+#define HKS_UPGRADE_KEY_SCHEDULER_H
+
+#include <cstdint>
+#include <string>
+
+namespace OHOS {
+namespace Security {
+namespace Hks {
+
+struct HksUpgradeKeySchedulerConfig {
+    // time from starting the scheduler thread to reading its first key file
+    uint32_t startDelayMs;
+    // a key file is only read once no request has arrived for this long
+    uint32_t idleMs;
+    // the scheduler sleeps after each key file so that its reads and writes stay under this rate, 0 for no limit
+    uint32_t ioBytesPerSecond;
+};
+
+struct HksUpgradeKeySchedulerStats {
+    uint32_t pendingStoreCount;
+    uint32_t scannedCount;
+    uint32_t upgradedCount;
+    uint32_t upToDateCount;
+    uint32_t failedCount;
+};
+
+// Queues a key store for a background pass that upgrades every key file below HKS_KEY_VERSION. bakRoot is the
+// backup store mirroring mainRoot, or empty. A store is passed at most once per service run.
+void HksUpgradeKeySchedulerAddStore(const std::string &mainRoot, const std::string &bakRoot);
+
+// Called for every request, the scheduler stays idle while requests keep arriving.
+void HksUpgradeKeySchedulerNotifyRequest(void);
+
+void HksUpgradeKeySchedulerGetStats(HksUpgradeKeySchedulerStats &stats);
+
+void HksUpgradeKeySchedulerSetConfig(const HksUpgradeKeySchedulerConfig &config);
+
+// Waits until every queued store has been passed, false if timeoutMs elapses first.
+bool HksUpgradeKeySchedulerWaitDone(uint32_t timeoutMs);
+}
+}
+}
+
+#endif // HKS_UPGRADE_KEY_SCHEDULER_H
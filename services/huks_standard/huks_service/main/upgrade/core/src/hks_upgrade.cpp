@@ -24,6 +24,13 @@
 #include "hks_file_transfer.h"
 #endif
 
+#ifdef HKS_ENABLE_UPGRADE_KEY
+#include <string>
+
+#include "hks_file_operator.h"
+#include "hks_upgrade_key_scheduler.h"
+#endif
+
 namespace OHOS {
 namespace Security {
 namespace Hks {
@@ -32,6 +39,9 @@ void HksUpgradeOnPowerOn(void)
 #ifdef HUKS_ENABLE_UPGRADE_KEY_STORAGE_SECURE_LEVEL
     HKS_IF_NOT_SUCC_LOGE(HksUpgradeFileTransferOnPowerOn(), "HksUpgradeFileTransfer on power on failed!")
 #endif
+#ifdef HKS_ENABLE_UPGRADE_KEY
+    HksUpgradeKeySchedulerAddStore(HKS_KEY_STORE_PATH, HKS_KEY_STORE_BAK_PATH);
+#endif
 }
 
 void HksUpgradeOnUserUnlock(uint32_t userId)
@@ -54,6 +64,14 @@ void HksUpgradeOnUserUnlock(uint32_t userId)
     }
 
     g_upgradeOrRequestLock.LockRead();
+#endif
+#ifdef HKS_ENABLE_UPGRADE_KEY
+    // the ce and ece stores of a user can only be read once it is unlocked
+    std::string userPath = "/" + std::to_string(userId) + "/";
+    HksUpgradeKeySchedulerAddStore(HKS_CE_ROOT_PATH + userPath + HKS_STORE_SERVICE_PATH,
+        HKS_CE_ROOT_PATH + userPath + HKS_STORE_SERVICE_BAK_PATH);
+    HksUpgradeKeySchedulerAddStore(HKS_ECE_ROOT_PATH + userPath + HKS_STORE_SERVICE_PATH,
+        HKS_ECE_ROOT_PATH + userPath + HKS_STORE_SERVICE_BAK_PATH);
 #endif
     HKS_LOG_I("leave HksUpgradeOnUserUnlock.");
 }
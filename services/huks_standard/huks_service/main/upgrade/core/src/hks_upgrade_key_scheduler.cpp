@@ -0,0 +1,256 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hks_upgrade_key_scheduler.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <dirent.h>
+#include <fcntl.h>
+#include <mutex>
+#include <pthread.h>
+#include <set>
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <thread>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+
+#include "hks_file_operator.h"
+#include "hks_log.h"
+#include "hks_template.h"
+#include "hks_type_enum.h"
+#include "hks_upgrade_key_accesser.h"
+#include "hks_upgrade_lock.h"
+#include "rwlock.h"
+
+namespace OHOS {
+namespace Security {
+namespace Hks {
+namespace {
+constexpr uint32_t DEFAULT_START_DELAY_MS = 30000;
+constexpr uint32_t DEFAULT_IDLE_MS = 500;
+constexpr uint32_t DEFAULT_IO_BYTES_PER_SECOND = 256 * 1024;
+constexpr uint32_t MS_PER_SECOND = 1000;
+constexpr uint32_t MAX_DIR_DEPTH = 8;
+constexpr int UPGRADE_THREAD_NICE = 19;
+
+struct KeyStore {
+    std::string mainRoot;
+    std::string bakRoot;
+};
+
+struct ScanDir {
+    std::string relPath;
+    uint32_t depth;
+};
+
+std::mutex g_schedulerLock;
+std::condition_variable g_schedulerCond;
+std::deque<KeyStore> g_pendingStores;
+std::set<std::string> g_knownStores;
+bool g_isRunning = false;
+HksUpgradeKeySchedulerConfig g_config = { DEFAULT_START_DELAY_MS, DEFAULT_IDLE_MS, DEFAULT_IO_BYTES_PER_SECOND };
+HksUpgradeKeySchedulerStats g_stats = { 0, 0, 0, 0, 0 };
+std::atomic<int64_t> g_lastRequestMs { 0 };
+
+int64_t NowMs()
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+HksUpgradeKeySchedulerConfig GetConfig()
+{
+    std::lock_guard<std::mutex> lock(g_schedulerLock);
+    return g_config;
+}
+
+void WaitIdle()
+{
+    uint32_t idleMs = GetConfig().idleMs;
+    for (;;) {
+        int64_t quietMs = NowMs() - g_lastRequestMs.load(std::memory_order_relaxed);
+        if (quietMs >= static_cast<int64_t>(idleMs)) {
+            return;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(idleMs - quietMs));
+    }
+}
+
+void Throttle(uint32_t ioSize)
+{
+    uint32_t ioBytesPerSecond = GetConfig().ioBytesPerSecond;
+    if (ioBytesPerSecond == 0) {
+        return;
+    }
+    uint64_t costMs = static_cast<uint64_t>(ioSize) * MS_PER_SECOND / ioBytesPerSecond;
+    if (costMs > 0) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(costMs));
+    }
+}
+
+void UpgradeKeyFile(const KeyStore &store, const std::string &relPath, const std::string &fileName)
+{
+    WaitIdle();
+    std::string path = store.mainRoot + relPath;
+    std::string bakPath = store.bakRoot.empty() ? "" : store.bakRoot + relPath;
+    bool isUpgraded = false;
+    uint32_t ioSize = 0;
+    int32_t ret;
+    {
+        // shared with requests, only the storage level upgrades which take it for writing wait for this key
+        OHOS::Utils::UniqueReadGuard<OHOS::Utils::RWLock> readGuard(g_upgradeOrRequestLock);
+        ret = HksUpgradeKeyFileIfNeed(path.c_str(), bakPath.empty() ? nullptr : bakPath.c_str(), fileName.c_str(),
+            &isUpgraded, &ioSize);
+    }
+    {
+        std::lock_guard<std::mutex> lock(g_schedulerLock);
+        ++g_stats.scannedCount;
+        if (ret == HKS_SUCCESS) {
+            ++(isUpgraded ? g_stats.upgradedCount : g_stats.upToDateCount);
+        } else if (ret != HKS_ERROR_NOT_EXIST) {
+            ++g_stats.failedCount;
+        }
+    }
+    Throttle(ioSize);
+}
+
+bool IsKeyDir(const std::string &relPath)
+{
+    size_t pos = relPath.find_last_of('/');
+    return relPath.compare(pos == std::string::npos ? 0 : pos + 1, std::string::npos, HKS_KEY_STORE_KEY_PATH) == 0;
+}
+
+// reads one directory of the store, its key files are collected first so the directory is not held open meanwhile
+void ReadScanDir(const KeyStore &store, const ScanDir &scanDir, std::vector<ScanDir> &dirs,
+    std::vector<std::string> &files)
+{
+    DIR *dir = opendir((store.mainRoot + scanDir.relPath).c_str());
+    if (dir == nullptr) {
+        return;
+    }
+    bool isKeyDir = IsKeyDir(scanDir.relPath);
+    for (struct dirent *dire = readdir(dir); dire != nullptr; dire = readdir(dir)) {
+        // skips "." and "..", and the trash of asynchronous deletes
+        if (dire->d_name[0] == '.') {
+            continue;
+        }
+        unsigned char type = dire->d_type;
+        struct stat fileStat;
+        if (type == DT_UNKNOWN && fstatat(dirfd(dir), dire->d_name, &fileStat, AT_SYMLINK_NOFOLLOW) == 0) {
+            type = S_ISDIR(fileStat.st_mode) ? DT_DIR : (S_ISREG(fileStat.st_mode) ? DT_REG : DT_UNKNOWN);
+        }
+        if (type == DT_DIR && scanDir.depth < MAX_DIR_DEPTH) {
+            dirs.push_back({ scanDir.relPath + "/" + dire->d_name, scanDir.depth + 1 });
+        } else if (type == DT_REG && isKeyDir) {
+            files.emplace_back(dire->d_name);
+        }
+    }
+    (void)closedir(dir);
+}
+
+void PassStore(const KeyStore &store)
+{
+    HKS_LOG_I("upgrade key scheduler passes a store.");
+    std::vector<ScanDir> dirs = { { "", 0 } };
+    while (!dirs.empty()) {
+        ScanDir scanDir = std::move(dirs.back());
+        dirs.pop_back();
+        std::vector<std::string> files;
+        ReadScanDir(store, scanDir, dirs, files);
+        for (const std::string &fileName : files) {
+            UpgradeKeyFile(store, scanDir.relPath, fileName);
+        }
+    }
+}
+
+void *SchedulerThread(void *arg)
+{
+    (void)arg;
+    if (setpriority(PRIO_PROCESS, static_cast<id_t>(gettid()), UPGRADE_THREAD_NICE) != 0) {
+        HKS_LOG_E("lower upgrade key scheduler priority failed.");
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(GetConfig().startDelayMs));
+    for (;;) {
+        KeyStore store;
+        {
+            std::lock_guard<std::mutex> lock(g_schedulerLock);
+            if (g_pendingStores.empty()) {
+                g_isRunning = false;
+                g_schedulerCond.notify_all();
+                HKS_LOG_I("upgrade key scheduler done, %" LOG_PUBLIC "u upgraded, %" LOG_PUBLIC "u failed.",
+                    g_stats.upgradedCount, g_stats.failedCount);
+                return nullptr;
+            }
+            store = g_pendingStores.front();
+        }
+        PassStore(store);
+        std::lock_guard<std::mutex> lock(g_schedulerLock);
+        g_pendingStores.pop_front();
+    }
+}
+}
+
+void HksUpgradeKeySchedulerAddStore(const std::string &mainRoot, const std::string &bakRoot)
+{
+    std::lock_guard<std::mutex> lock(g_schedulerLock);
+    if (!g_knownStores.insert(mainRoot).second) {
+        return;
+    }
+    g_pendingStores.push_back({ mainRoot, bakRoot });
+    if (g_isRunning) {
+        return;
+    }
+    pthread_t thread;
+    if (pthread_create(&thread, nullptr, SchedulerThread, nullptr) != 0) {
+        HKS_LOG_E("create upgrade key scheduler thread failed, keys are upgraded on their next use.");
+        g_pendingStores.clear();
+        return;
+    }
+    pthread_setname_np(thread, "HUKS_KEY_UPGRADE");
+    (void)pthread_detach(thread);
+    g_isRunning = true;
+}
+
+void HksUpgradeKeySchedulerNotifyRequest(void)
+{
+    g_lastRequestMs.store(NowMs(), std::memory_order_relaxed);
+}
+
+void HksUpgradeKeySchedulerGetStats(HksUpgradeKeySchedulerStats &stats)
+{
+    std::lock_guard<std::mutex> lock(g_schedulerLock);
+    stats = g_stats;
+    stats.pendingStoreCount = static_cast<uint32_t>(g_pendingStores.size());
+}
+
+void HksUpgradeKeySchedulerSetConfig(const HksUpgradeKeySchedulerConfig &config)
+{
+    std::lock_guard<std::mutex> lock(g_schedulerLock);
+    g_config = config;
+}
+
+bool HksUpgradeKeySchedulerWaitDone(uint32_t timeoutMs)
+{
+    std::unique_lock<std::mutex> lock(g_schedulerLock);
+    return g_schedulerCond.wait_for(lock, std::chrono::milliseconds(timeoutMs), [] { return !g_isRunning; });
+}
+}
+}
+}
@@ -66,6 +66,11 @@ int32_t HksMatchConfig(const char *alias, uint32_t uid, uint32_t userId, uint64_
 
 bool HksIsRdbDeKey(const char *alias);
 
+// between Init and Destroy the token type and hap name of an accessTokenId are looked up once and then reused
+void HksConfigTokenCacheInit(void);
+
+void HksConfigTokenCacheDestroy(void);
+
 #ifdef __cplusplus
 }
 #endif
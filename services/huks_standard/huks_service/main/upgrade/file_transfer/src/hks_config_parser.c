@@ -16,7 +16,9 @@
 #include "hks_config_parser.h"
 
 #include <inttypes.h>
+#include <pthread.h>
 #include <stdint.h>
+#include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
 
@@ -35,6 +37,44 @@ static const char * const HAP_SKIP_UPGRADE_CFG_LIST[] = HUKS_HAP_SKIP_UPGRADE_CO
 static const char * const RDB_DE_PREFIX = "DistributedDataRdb";
 static const char * const RDB_ROOT_DE = "distributeddb_client_root_key";
 
+// the complete policy of one configured sa uid or hap name
+struct HksConfigPolicy {
+    uint32_t uid;
+    const char *hapName;
+    bool skipTransfer;
+    bool needDe;
+    bool needFrontUser;
+};
+
+struct HksConfigPolicyTable {
+    struct HksConfigPolicy *policies;
+    uint32_t count;
+};
+
+typedef int (*HksConfigPolicyCompare)(const void *, const void *);
+
+// the four config lists merged into one table for sa and one for hap, built once and sorted for binary search
+static struct HksConfigPolicy g_saPolicies[HKS_ARRAY_SIZE(SA_SKIP_UPGRADE_CFG_LIST) +
+    HKS_ARRAY_SIZE(SA_UPGRADE_CFG_LIST)];
+static struct HksConfigPolicy g_hapPolicies[HKS_ARRAY_SIZE(HAP_SKIP_UPGRADE_CFG_LIST) +
+    HKS_ARRAY_SIZE(HAP_UPGRADE_CFG_LIST)];
+static struct HksConfigPolicyTable g_saPolicyTable = { g_saPolicies, 0 };
+static struct HksConfigPolicyTable g_hapPolicyTable = { g_hapPolicies, 0 };
+static pthread_once_t g_policyTableOnce = PTHREAD_ONCE_INIT;
+
+#define HKS_CONFIG_TOKEN_CACHE_SIZE 256
+
+struct HksConfigTokenCacheEntry {
+    bool isUsed;
+    enum HksAtType type;
+    uint64_t accessTokenId;
+    char hapName[HAP_NAME_LEN_MAX];
+};
+
+// maps accessTokenId to its token type and hap name, only while a transfer run holds it
+static pthread_mutex_t g_tokenCacheLock = PTHREAD_MUTEX_INITIALIZER;
+static struct HksConfigTokenCacheEntry *g_tokenCache = NULL;
+
 bool HksIsRdbDeKey(const char *alias)
 {
     uint32_t rdbDePrefixLen = strlen(RDB_DE_PREFIX);
@@ -49,22 +89,34 @@ bool HksIsRdbDeKey(const char *alias)
     return false;
 }
 
+// the file content is read in place: blob data is located by offset the way HksFreshParamSet does, not copied
 static int32_t ParseOwnerIdFromParamSet(const struct HksParamSet *paramSet, uint32_t *uid, uint64_t *accessTokenId,
     uint32_t *userId)
 {
     bool getUid = false;
     bool getAccessToken = false;
     bool getUserId = false;
-    int32_t ret;
+    uint32_t offset = sizeof(struct HksParamSet) + sizeof(struct HksParam) * paramSet->paramsCnt;
     for (uint32_t i = 0; i < paramSet->paramsCnt; ++i) {
+        if (offset > paramSet->paramSetSize) {
+            HKS_LOG_E("invalid param set offset!");
+            return HKS_ERROR_INVALID_KEY_FILE;
+        }
+        uint32_t blobOffset = offset;
+        if (GetTagType((enum HksTag)(paramSet->params[i].tag)) == HKS_TAG_TYPE_BYTES) {
+            if (paramSet->params[i].blob.size > paramSet->paramSetSize - offset) {
+                HKS_LOG_E("invalid param set blob size!");
+                return HKS_ERROR_INVALID_KEY_FILE;
+            }
+            offset += paramSet->params[i].blob.size;
+        }
         if (paramSet->params[i].tag == HKS_TAG_PROCESS_NAME) {
             // the uid data should be uint32_t
             if (paramSet->params[i].blob.size != sizeof(uint32_t)) {
                 HKS_LOG_E("process name blob data is over the size of uint32_t.");
-                ret = HKS_ERROR_INVALID_KEY_FILE;
-                break;
+                return HKS_ERROR_INVALID_KEY_FILE;
             }
-            *uid = *(uint32_t *)paramSet->params[i].blob.data;
+            (void)memcpy_s(uid, sizeof(uint32_t), (const uint8_t *)paramSet + blobOffset, sizeof(uint32_t));
             getUid = true;
             continue;
         }
@@ -83,24 +135,22 @@ static int32_t ParseOwnerIdFromParamSet(const struct HksParamSet *paramSet, uint
             getUserId = true;
             continue;
         }
-        if (getUid && getAccessToken && getUserId) {
-            break;
-        }
     }
-    ret = getUid && getAccessToken && getUserId ? HKS_SUCCESS : HKS_ERROR_INVALID_KEY_FILE;
-    return ret;
+    if (offset != paramSet->paramSetSize) {
+        HKS_LOG_E("invalid param set size!");
+        return HKS_ERROR_INVALID_KEY_FILE;
+    }
+    return getUid && getAccessToken && getUserId ? HKS_SUCCESS : HKS_ERROR_INVALID_KEY_FILE;
 }
 
 static int32_t ParseOwnerIdFromFileContent(const struct HksBlob *fileContent, uint32_t *uid, uint64_t *accessTokenId,
     uint32_t *userId)
 {
-    struct HksParamSet *tmpParamSet = NULL;
-    int32_t ret = HksGetParamSet((const struct HksParamSet *)fileContent->data, fileContent->size, &tmpParamSet);
-    HKS_IF_NOT_SUCC_LOGE_RETURN(ret, ret, "fresh paramset failed.")
+    const struct HksParamSet *paramSet = (const struct HksParamSet *)fileContent->data;
+    int32_t ret = HksCheckParamSet(paramSet, fileContent->size);
+    HKS_IF_NOT_SUCC_LOGE_RETURN(ret, ret, "check paramset failed.")
 
-    ret = ParseOwnerIdFromParamSet(tmpParamSet, uid, accessTokenId, userId);
-    HKS_FREE(tmpParamSet);
-    return ret;
+    return ParseOwnerIdFromParamSet(paramSet, uid, accessTokenId, userId);
 }
 
 static void InitDefaultStrategy(const char *alias, struct HksUpgradeFileTransferInfo *info)
@@ -115,75 +165,191 @@ static void InitDefaultStrategy(const char *alias, struct HksUpgradeFileTransfer
     }
 }
 
-static int32_t MatchSaConfig(const char *alias, uint32_t uid, uint32_t userId, struct HksUpgradeFileTransferInfo *info)
+static int ComparePolicyUid(const void *left, const void *right)
 {
-    InitDefaultStrategy(alias, info);
-    for (uint32_t i = 0; i < HKS_ARRAY_SIZE(SA_SKIP_UPGRADE_CFG_LIST); ++i) {
-        if (uid == SA_SKIP_UPGRADE_CFG_LIST[i]) {
-            HKS_LOG_I("%" LOG_PUBLIC "u needs skip transfer upgrade.", uid);
-            info->skipTransfer = true;
-            return HKS_SUCCESS;
+    uint32_t leftUid = ((const struct HksConfigPolicy *)left)->uid;
+    uint32_t rightUid = ((const struct HksConfigPolicy *)right)->uid;
+    return (leftUid > rightUid) - (leftUid < rightUid);
+}
+
+static int ComparePolicyHapName(const void *left, const void *right)
+{
+    return strcmp(((const struct HksConfigPolicy *)left)->hapName, ((const struct HksConfigPolicy *)right)->hapName);
+}
+
+// the first entry of a uid or hap name wins, as it did when the lists were scanned in order
+static void AddPolicy(struct HksConfigPolicyTable *table, const struct HksConfigPolicy *policy,
+    HksConfigPolicyCompare compare)
+{
+    for (uint32_t i = 0; i < table->count; ++i) {
+        if (compare(&table->policies[i], policy) == 0) {
+            return;
         }
     }
+    table->policies[table->count++] = *policy;
+}
 
+// skip lists go in first since a skip config overrides an upgrade config of the same owner
+static void BuildPolicyTables(void)
+{
+    for (uint32_t i = 0; i < HKS_ARRAY_SIZE(SA_SKIP_UPGRADE_CFG_LIST); ++i) {
+        struct HksConfigPolicy policy = { SA_SKIP_UPGRADE_CFG_LIST[i], NULL, true, false, false };
+        AddPolicy(&g_saPolicyTable, &policy, ComparePolicyUid);
+    }
     for (uint32_t i = 0; i < HKS_ARRAY_SIZE(SA_UPGRADE_CFG_LIST); ++i) {
-        if (SA_UPGRADE_CFG_LIST[i].uid == uid) {
-            info->needDe = SA_UPGRADE_CFG_LIST[i].needDe;
-            info->needFrontUser = SA_UPGRADE_CFG_LIST[i].needFrontUser;
-            HKS_LOG_I("match sa config, need de %" LOG_PUBLIC "d, need with withUser %" LOG_PUBLIC "d.",
-                info->needDe, info->needFrontUser);
-            break;
-        }
+        struct HksConfigPolicy policy = { SA_UPGRADE_CFG_LIST[i].uid, NULL, false, SA_UPGRADE_CFG_LIST[i].needDe,
+            SA_UPGRADE_CFG_LIST[i].needFrontUser };
+        AddPolicy(&g_saPolicyTable, &policy, ComparePolicyUid);
+    }
+    for (uint32_t i = 0; i < HKS_ARRAY_SIZE(HAP_SKIP_UPGRADE_CFG_LIST); ++i) {
+        struct HksConfigPolicy policy = { 0, HAP_SKIP_UPGRADE_CFG_LIST[i], true, false, false };
+        AddPolicy(&g_hapPolicyTable, &policy, ComparePolicyHapName);
+    }
+    for (uint32_t i = 0; i < HKS_ARRAY_SIZE(HAP_UPGRADE_CFG_LIST); ++i) {
+        struct HksConfigPolicy policy = { 0, HAP_UPGRADE_CFG_LIST[i].hapName, false, HAP_UPGRADE_CFG_LIST[i].needDe,
+            HAP_UPGRADE_CFG_LIST[i].needFrontUser };
+        AddPolicy(&g_hapPolicyTable, &policy, ComparePolicyHapName);
+    }
+    qsort(g_saPolicyTable.policies, g_saPolicyTable.count, sizeof(struct HksConfigPolicy), ComparePolicyUid);
+    qsort(g_hapPolicyTable.policies, g_hapPolicyTable.count, sizeof(struct HksConfigPolicy), ComparePolicyHapName);
+}
+
+static const struct HksConfigPolicy *FindPolicy(const struct HksConfigPolicyTable *table,
+    const struct HksConfigPolicy *key, HksConfigPolicyCompare compare)
+{
+    (void)pthread_once(&g_policyTableOnce, BuildPolicyTables);
+    return (const struct HksConfigPolicy *)bsearch(key, table->policies, table->count,
+        sizeof(struct HksConfigPolicy), compare);
+}
+
+static int32_t MatchSaConfig(const char *alias, uint32_t uid, uint32_t userId, struct HksUpgradeFileTransferInfo *info)
+{
+    InitDefaultStrategy(alias, info);
+    struct HksConfigPolicy key = { uid, NULL, false, false, false };
+    const struct HksConfigPolicy *policy = FindPolicy(&g_saPolicyTable, &key, ComparePolicyUid);
+    if (policy != NULL && policy->skipTransfer) {
+        HKS_LOG_I("%" LOG_PUBLIC "u needs skip transfer upgrade.", uid);
+        info->skipTransfer = true;
+        return HKS_SUCCESS;
+    }
+    if (policy != NULL) {
+        info->needDe = policy->needDe;
+        info->needFrontUser = policy->needFrontUser;
+        HKS_LOG_I("match sa config, need de %" LOG_PUBLIC "d, need with withUser %" LOG_PUBLIC "d.",
+            info->needDe, info->needFrontUser);
     }
     info->uid = uid;
     info->userId = userId;
     return HKS_SUCCESS;
 }
 
-static int32_t MatchHapConfig(const char *alias, uint32_t uid, uint32_t userId, uint64_t accessTokenId,
+static int32_t MatchHapConfig(const char *alias, uint32_t uid, uint32_t userId, const char *hapName,
     struct HksUpgradeFileTransferInfo *info)
 {
-    char hapName[HAP_NAME_LEN_MAX] = { 0 };
-    int32_t ret = HksGetHapNameFromAccessToken(accessTokenId, hapName, HAP_NAME_LEN_MAX);
-    HKS_IF_NOT_SUCC_LOGE_RETURN(ret, ret,
-        "get hap name from accessTokenId failed, accessTokenId is %" LOG_PUBLIC PRIu64, accessTokenId)
-
     InitDefaultStrategy(alias, info);
-    for (uint32_t i = 0; i < HKS_ARRAY_SIZE(HAP_SKIP_UPGRADE_CFG_LIST); ++i) {
-        if (strlen(HAP_SKIP_UPGRADE_CFG_LIST[i]) != strlen(hapName)) {
-            continue;
-        }
-        if (HksMemCmp(HAP_SKIP_UPGRADE_CFG_LIST[i], hapName, strlen(hapName)) == EOK) {
-            info->skipTransfer = true;
-            HKS_LOG_I("%" LOG_PUBLIC "u, %" LOG_PUBLIC "s needs skip transfer upgrade.", uid, hapName);
-            return HKS_SUCCESS;
-        }
+    struct HksConfigPolicy key = { 0, hapName, false, false, false };
+    const struct HksConfigPolicy *policy = FindPolicy(&g_hapPolicyTable, &key, ComparePolicyHapName);
+    if (policy != NULL && policy->skipTransfer) {
+        info->skipTransfer = true;
+        HKS_LOG_I("%" LOG_PUBLIC "u, %" LOG_PUBLIC "s needs skip transfer upgrade.", uid, hapName);
+        return HKS_SUCCESS;
     }
-    for (uint32_t i = 0; i < HKS_ARRAY_SIZE(HAP_UPGRADE_CFG_LIST); ++i) {
-        if (strlen(HAP_UPGRADE_CFG_LIST[i].hapName) != strlen(hapName)) {
-            continue;
-        }
-        if (HksMemCmp(HAP_UPGRADE_CFG_LIST[i].hapName, hapName, strlen(hapName)) == EOK) {
-            info->needDe = HAP_UPGRADE_CFG_LIST[i].needDe;
-            info->needFrontUser = HAP_UPGRADE_CFG_LIST[i].needFrontUser;
-            HKS_LOG_I("match hap config, need de %" LOG_PUBLIC "d, need with withUser %" LOG_PUBLIC "d.",
-                info->needDe, info->needFrontUser);
-            break;
-        }
+    if (policy != NULL) {
+        info->needDe = policy->needDe;
+        info->needFrontUser = policy->needFrontUser;
+        HKS_LOG_I("match hap config, need de %" LOG_PUBLIC "d, need with withUser %" LOG_PUBLIC "d.",
+            info->needDe, info->needFrontUser);
     }
     info->uid = uid;
     info->userId = userId;
     return HKS_SUCCESS;
 }
 
+void HksConfigTokenCacheInit(void)
+{
+    (void)pthread_mutex_lock(&g_tokenCacheLock);
+    if (g_tokenCache == NULL) {
+        g_tokenCache = (struct HksConfigTokenCacheEntry *)HksMalloc(
+            sizeof(struct HksConfigTokenCacheEntry) * HKS_CONFIG_TOKEN_CACHE_SIZE);
+        if (g_tokenCache == NULL) {
+            HKS_LOG_E("malloc token cache failed, every key file queries its owner.");
+        }
+    }
+    (void)pthread_mutex_unlock(&g_tokenCacheLock);
+}
+
+void HksConfigTokenCacheDestroy(void)
+{
+    (void)pthread_mutex_lock(&g_tokenCacheLock);
+    HKS_FREE(g_tokenCache);
+    (void)pthread_mutex_unlock(&g_tokenCacheLock);
+}
+
+static struct HksConfigTokenCacheEntry *FindTokenCacheEntry(uint64_t accessTokenId)
+{
+    uint32_t start = (uint32_t)(accessTokenId ^ (accessTokenId >> 32)) % HKS_CONFIG_TOKEN_CACHE_SIZE;
+    for (uint32_t i = 0; i < HKS_CONFIG_TOKEN_CACHE_SIZE; ++i) {
+        struct HksConfigTokenCacheEntry *entry = &g_tokenCache[(start + i) % HKS_CONFIG_TOKEN_CACHE_SIZE];
+        if (!entry->isUsed || entry->accessTokenId == accessTokenId) {
+            return entry;
+        }
+    }
+    return NULL;
+}
+
+static bool GetCachedTokenInfo(uint64_t accessTokenId, enum HksAtType *type, char *hapName)
+{
+    bool isHit = false;
+    (void)pthread_mutex_lock(&g_tokenCacheLock);
+    struct HksConfigTokenCacheEntry *entry = (g_tokenCache == NULL) ? NULL : FindTokenCacheEntry(accessTokenId);
+    if (entry != NULL && entry->isUsed) {
+        *type = entry->type;
+        (void)memcpy_s(hapName, HAP_NAME_LEN_MAX, entry->hapName, HAP_NAME_LEN_MAX);
+        isHit = true;
+    }
+    (void)pthread_mutex_unlock(&g_tokenCacheLock);
+    return isHit;
+}
+
+static void CacheTokenInfo(uint64_t accessTokenId, enum HksAtType type, const char *hapName)
+{
+    (void)pthread_mutex_lock(&g_tokenCacheLock);
+    struct HksConfigTokenCacheEntry *entry = (g_tokenCache == NULL) ? NULL : FindTokenCacheEntry(accessTokenId);
+    if (entry != NULL) {
+        entry->isUsed = true;
+        entry->type = type;
+        entry->accessTokenId = accessTokenId;
+        (void)memcpy_s(entry->hapName, HAP_NAME_LEN_MAX, hapName, HAP_NAME_LEN_MAX);
+    }
+    (void)pthread_mutex_unlock(&g_tokenCacheLock);
+}
+
+// hapName is left empty for tokens that are not of a hap
+static int32_t GetTokenInfo(uint64_t accessTokenId, enum HksAtType *type, char *hapName)
+{
+    if (GetCachedTokenInfo(accessTokenId, type, hapName)) {
+        return HKS_SUCCESS;
+    }
+    int32_t ret = HksGetAtType(accessTokenId, type);
+    HKS_IF_NOT_SUCC_LOGE_RETURN(ret, ret, "get access token type failed.")
+    if (*type == HKS_TOKEN_HAP) {
+        ret = HksGetHapNameFromAccessToken(accessTokenId, hapName, HAP_NAME_LEN_MAX);
+        HKS_IF_NOT_SUCC_LOGE_RETURN(ret, ret,
+            "get hap name from accessTokenId failed, accessTokenId is %" LOG_PUBLIC PRIu64, accessTokenId)
+    }
+    CacheTokenInfo(accessTokenId, *type, hapName);
+    return HKS_SUCCESS;
+}
+
 int32_t HksMatchConfig(const char *alias, uint32_t uid, uint32_t userId, uint64_t accessTokenId,
     struct HksUpgradeFileTransferInfo *info)
 {
     enum HksAtType type;
-    int32_t ret = HksGetAtType(accessTokenId, &type);
-    HKS_IF_NOT_SUCC_LOGE_RETURN(ret, ret, "get access token type failed.")
+    char hapName[HAP_NAME_LEN_MAX] = { 0 };
+    int32_t ret = GetTokenInfo(accessTokenId, &type, hapName);
+    HKS_IF_NOT_SUCC_RETURN(ret, ret)
     if (type == HKS_TOKEN_HAP) {
-        return MatchHapConfig(alias, uid, userId, accessTokenId, info);
+        return MatchHapConfig(alias, uid, userId, hapName, info);
     }
     return MatchSaConfig(alias, uid, userId, info);
 }
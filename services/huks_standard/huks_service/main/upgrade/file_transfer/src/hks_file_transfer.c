@@ -23,17 +23,96 @@
 #include "hks_template.h"
 #include "hks_type_inner.h"
 
+#include "hks_storage_alias_index.h"
+#include "hks_storage_key_cache.h"
 #include "hks_storage_utils.h"
 
+#include <dirent.h>
 #include <errno.h>
-#include <ftw.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <pthread.h>
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define HKS_TRANSFER_WORKER_NUM 4
+#define HKS_TRANSFER_BATCH_SIZE 64
+#define HKS_TRANSFER_MAX_QUEUED_BATCH 32
+#define HKS_TRANSFER_MAX_DEPTH 8
+#define HKS_TRANSFER_DEST_CACHE_SIZE 256
+#define HKS_TRANSFER_JOURNAL_MAX_SIZE (1024 * 1024)
+#define HKS_TRANSFER_JOURNAL_LINE_LEN (HKS_MAX_FILE_NAME_LEN + 64)
+#define HKS_TRANSFER_HASH_INIT 2166136261u
+#define HKS_TRANSFER_HASH_PRIME 16777619u
 
-#define OPEN_FDS 64
+/*
+ * Directories whose files were all moved or skipped by config are appended to the journal as "sec nsec path" with
+ * the mtime they had afterwards. A later run skips a journaled directory while its mtime is unchanged, so an
+ * interrupted or repeated transfer does not read and parse the same key files again.
+ */
+#define HKS_TRANSFER_JOURNAL_PATH HKS_KEY_STORE_TMP_PATH ".journal"
 
 uint32_t g_frontUserId = 100;
 
+// a scanned source directory, freed when the scanner and every batch of it are done
+struct HksTransferDir {
+    char path[HKS_MAX_FILE_NAME_LEN]; /* ends with '/' */
+    dev_t dev;
+    uint32_t refCount;
+    bool isAllHandled;
+};
+
+struct HksTransferBatch {
+    struct HksTransferBatch *next;
+    struct HksTransferDir *dir;
+    uint32_t count;
+    char aliases[HKS_TRANSFER_BATCH_SIZE][NAME_MAX + 1];
+};
+
+// the directory the keys of one owner go to, created and looked up once per run
+struct HksTransferDestination {
+    bool isUsed;
+    bool needDe;
+    uint32_t userId;
+    uint32_t uid;
+    dev_t dev;
+    char path[HKS_MAX_FILE_NAME_LEN];
+};
+
+struct HksTransferJournalEntry {
+    uint32_t hash;
+    long long mtimeSec;
+    long mtimeNsec;
+    const char *path;
+};
+
+struct HksTransferJournal {
+    int fd;
+    char *content;
+    uint32_t capacity; /* power of two, the table is at most half full */
+    struct HksTransferJournalEntry *entries;
+};
+
+struct HksTransferEngine {
+    pthread_mutex_t lock;
+    pthread_cond_t hasWork;
+    pthread_cond_t hasRoom;
+    struct HksTransferBatch *head;
+    struct HksTransferBatch *tail;
+    uint32_t queued;
+    uint32_t workerNum;
+    bool isScanDone;
+    bool (*filter)(const char *alias); /* NULL takes every file */
+    uint32_t movedCount;
+    uint32_t skippedDirCount;
+    pthread_mutex_t destLock;
+    struct HksTransferDestination *dests;
+    struct HksTransferJournal journal; /* fd is -1 when the run keeps no journal */
+};
+
 static int32_t GetStoreMaterial(const struct HksBlob *alias, const struct HksUpgradeFileTransferInfo *info,
     struct HksStoreMaterial *outMaterial)
 {
@@ -114,17 +193,97 @@ static int32_t ConstructNewFilePath(const char *alias, const struct HksUpgradeFi
     return ret;
 }
 
-static int32_t TransferFile(const char *alias, const char *oldPath, const struct HksBlob *fileContent,
-    const struct HksUpgradeFileTransferInfo *info)
+static int32_t GetFileContent(const char *path, const char *alias, struct HksBlob *fileContent)
 {
-    int32_t ret;
+    uint32_t size = HksFileSize(path, alias);
+    if (size == 0) {
+        return HKS_ERROR_FILE_SIZE_FAIL;
+    }
+    fileContent->data = (uint8_t *)HksMalloc(size);
+    HKS_IF_NULL_RETURN(fileContent->data, HKS_ERROR_MALLOC_FAIL)
+
+    fileContent->size = size;
+    return HksFileRead(path, alias, 0, fileContent, &fileContent->size);
+}
+
+static int32_t GetTransferDestination(struct HksTransferEngine *engine, const char *alias,
+    const struct HksUpgradeFileTransferInfo *info, struct HksTransferDestination *dest)
+{
+    uint32_t userId = info->needFrontUser ? g_frontUserId : info->userId;
+    uint32_t start = (info->uid ^ (userId * HKS_TRANSFER_HASH_PRIME) ^ (uint32_t)info->needDe) %
+        HKS_TRANSFER_DEST_CACHE_SIZE;
+    struct HksTransferDestination *slot = NULL;
+    (void)pthread_mutex_lock(&engine->destLock);
+    for (uint32_t i = 0; (engine->dests != NULL) && (i < HKS_TRANSFER_DEST_CACHE_SIZE); ++i) {
+        struct HksTransferDestination *entry = &engine->dests[(start + i) % HKS_TRANSFER_DEST_CACHE_SIZE];
+        if (!entry->isUsed) {
+            slot = entry;
+            break;
+        }
+        if (entry->uid == info->uid && entry->userId == userId && entry->needDe == info->needDe) {
+            *dest = *entry;
+            (void)pthread_mutex_unlock(&engine->destLock);
+            return HKS_SUCCESS;
+        }
+    }
+    (void)pthread_mutex_unlock(&engine->destLock);
+
     char *newPath = NULL;
+    int32_t ret;
     do {
         ret = ConstructNewFilePath(alias, info, &newPath);
-        if (ret != HKS_SUCCESS) {
-            HKS_LOG_E("construct new file path failed.");
+        HKS_IF_NOT_SUCC_LOGE_BREAK(ret, "construct new file path failed.")
+
+        ret = HksMakeFullDir(newPath);
+        HKS_IF_NOT_SUCC_LOGE_BREAK(ret, "make dir %" LOG_PUBLIC "s writefailed.", newPath)
+
+        struct stat dirStat;
+        if (strcpy_s(dest->path, sizeof(dest->path), newPath) != EOK || stat(newPath, &dirStat) != 0) {
+            HKS_LOG_E("get dir %" LOG_PUBLIC "s info failed.", newPath);
+            ret = HKS_ERROR_INTERNAL_ERROR;
             break;
         }
+        dest->isUsed = true;
+        dest->needDe = info->needDe;
+        dest->userId = userId;
+        dest->uid = info->uid;
+        dest->dev = dirStat.st_dev;
+        (void)pthread_mutex_lock(&engine->destLock);
+        if (slot != NULL && !slot->isUsed) {
+            *slot = *dest;
+        }
+        (void)pthread_mutex_unlock(&engine->destLock);
+    } while (false);
+    HKS_FREE(newPath);
+    return ret;
+}
+
+// on one file system the key file is renamed instead of written again and removed
+static int32_t MoveKeyFile(const char *oldPath, const char *newPath, const char *alias)
+{
+    char oldFile[HKS_MAX_FILE_NAME_LEN] = { 0 };
+    char newFile[HKS_MAX_FILE_NAME_LEN] = { 0 };
+    int32_t ret = HksGetFileName(oldPath, alias, oldFile, sizeof(oldFile));
+    HKS_IF_NOT_SUCC_RETURN(ret, ret)
+    ret = HksGetFileName(newPath, alias, newFile, sizeof(newFile));
+    HKS_IF_NOT_SUCC_RETURN(ret, ret)
+    if (rename(oldFile, newFile) != 0) {
+        HKS_LOG_E("rename to %" LOG_PUBLIC "s failed, errno is %" LOG_PUBLIC "d.", newPath, errno);
+        return HKS_ERROR_INTERNAL_ERROR;
+    }
+    return HKS_SUCCESS;
+}
+
+static int32_t TransferFile(struct HksTransferEngine *engine, const char *alias, const struct HksTransferDir *dir,
+    const struct HksBlob *fileContent, const struct HksUpgradeFileTransferInfo *info)
+{
+    const char *oldPath = dir->path;
+    struct HksTransferDestination dest = { 0 };
+    int32_t ret;
+    do {
+        ret = GetTransferDestination(engine, alias, info, &dest);
+        HKS_IF_NOT_SUCC_LOGE_BREAK(ret, "get transfer destination failed.")
+        const char *newPath = dest.path;
 
         // Check if the alias is of rdb key file. If it is, skip the checking of duplicate to overwrite key file.
         if (HksIsRdbDeKey(alias) && info->needDe) {
@@ -144,15 +303,14 @@ static int32_t TransferFile(const char *alias, const char *oldPath, const struct
             }
         }
 
-        ret = HksMakeFullDir(newPath);
-        if (ret != HKS_SUCCESS) {
-            HKS_LOG_E("make dir %" LOG_PUBLIC "s writefailed.", newPath);
-            break;
-        }
-
         // The result of the info record dose not need to take into consideration.
         (void)RecordKeyOperation(KEY_OPERATION_SAVE, newPath, alias);
 
+        if (dest.dev == dir->dev && MoveKeyFile(oldPath, newPath, alias) == HKS_SUCCESS) {
+            ret = HKS_SUCCESS;
+            break;
+        }
+
         ret = HksFileWrite(newPath, alias, 0, fileContent->data, fileContent->size);
         if (ret != HKS_SUCCESS) {
             HKS_LOG_E("file %" LOG_PUBLIC "s write failed.", newPath);
@@ -170,87 +328,389 @@ static int32_t TransferFile(const char *alias, const char *oldPath, const struct
             }
         }
     } while (false);
-    HKS_FREE(newPath);
 
+#ifdef HKS_SUPPORT_ALIAS_INDEX
+    // the files are moved around hks_storage while requests run, an mtime in the same tick would hide the change
+    HksAliasIndexInvalidate(oldPath);
+    if (dest.isUsed) {
+        HksAliasIndexInvalidate(dest.path);
+    }
+#endif
     return ret;
 }
 
-static int32_t SplitPath(const char *filePath, const struct FTW *ftw, char **path, char **alias)
+// a file is handled when it is gone from the source or its config says it stays, neither changes on a retry
+static bool ProcessKeyFile(struct HksTransferEngine *engine, const struct HksTransferDir *dir, const char *alias,
+    bool *isMoved)
 {
-    *alias = (char *)HksMalloc(strlen(filePath) + 1 - ftw->base);
-    if (*alias == NULL) {
-        return HKS_ERROR_MALLOC_FAIL;
+    struct HksBlob fileContent = { 0 };
+    bool isHandled = false;
+    int32_t ret;
+    do {
+        ret = GetFileContent(dir->path, alias, &fileContent);
+        HKS_IF_NOT_SUCC_LOGE_BREAK(ret, "get file content failed.")
+
+        struct HksUpgradeFileTransferInfo info = { 0 };
+        ret = HksParseConfig(alias, &fileContent, &info);
+        if (ret != HKS_SUCCESS) {
+            HKS_LOG_E("HksParseConfig failed, path is %" LOG_PUBLIC "s%" LOG_PUBLIC "s", dir->path, alias);
+            break;
+        }
+        if (info.skipTransfer) {
+            HKS_LOG_I("file %" LOG_PUBLIC "s%" LOG_PUBLIC "s should skip transfer.", dir->path, alias);
+            isHandled = true;
+            break;
+        }
+        ret = TransferFile(engine, alias, dir, &fileContent, &info);
+        HKS_IF_NOT_SUCC_LOGE_BREAK(ret, "TransferFile failed!")
+        *isMoved = HksIsFileExist(dir->path, alias) != HKS_SUCCESS;
+        isHandled = *isMoved;
+    } while (false);
+    HKS_FREE_BLOB(fileContent);
+    return isHandled;
+}
+
+static uint32_t HashJournalEntry(const char *path, uint32_t pathLen, long long mtimeSec, long mtimeNsec)
+{
+    uint32_t hash = HKS_TRANSFER_HASH_INIT;
+    for (uint32_t i = 0; i < pathLen; ++i) {
+        hash = (hash ^ (uint8_t)path[i]) * HKS_TRANSFER_HASH_PRIME;
     }
-    (void)memcpy_s(*alias, strlen(filePath) - ftw->base, filePath + ftw->base, strlen(filePath) - ftw->base);
+    return hash ^ (uint32_t)mtimeSec ^ (uint32_t)mtimeNsec;
+}
 
-    *path = (char *)HksMalloc(ftw->base + 1);
-    if (*path == NULL) {
-        return HKS_ERROR_MALLOC_FAIL;
+static bool IsDirJournaled(const struct HksTransferJournal *journal, const char *path, const struct stat *dirStat)
+{
+    if (journal->entries == NULL) {
+        return false;
+    }
+    uint32_t pathLen = strlen(path);
+    uint32_t hash = HashJournalEntry(path, pathLen, (long long)dirStat->st_mtim.tv_sec, dirStat->st_mtim.tv_nsec);
+    for (uint32_t i = hash & (journal->capacity - 1); journal->entries[i].path != NULL;
+        i = (i + 1) & (journal->capacity - 1)) {
+        const struct HksTransferJournalEntry *entry = &journal->entries[i];
+        if (entry->hash == hash && entry->mtimeSec == (long long)dirStat->st_mtim.tv_sec &&
+            entry->mtimeNsec == dirStat->st_mtim.tv_nsec && strncmp(entry->path, path, pathLen) == 0 &&
+            entry->path[pathLen] == '\n') {
+            return true;
+        }
     }
-    (void)memcpy_s(*path, ftw->base, filePath, ftw->base);
+    return false;
+}
 
-    HKS_LOG_I("path is %" LOG_PUBLIC "s.", *path);
+static void AddJournalEntry(struct HksTransferJournal *journal, char *line)
+{
+    char *end = NULL;
+    long long mtimeSec = strtoll(line, &end, 10);
+    if (end == line || *end != ' ') {
+        return;
+    }
+    char *nsecStart = end + 1;
+    long mtimeNsec = strtol(nsecStart, &end, 10);
+    if (end == nsecStart || *end != ' ') {
+        return;
+    }
+    const char *path = end + 1;
+    const char *pathEnd = strchr(path, '\n');
+    if (pathEnd == NULL || pathEnd == path) {
+        return;
+    }
+    uint32_t hash = HashJournalEntry(path, (uint32_t)(pathEnd - path), mtimeSec, mtimeNsec);
+    uint32_t i = hash & (journal->capacity - 1);
+    while (journal->entries[i].path != NULL) {
+        i = (i + 1) & (journal->capacity - 1);
+    }
+    journal->entries[i] = (struct HksTransferJournalEntry) { hash, mtimeSec, mtimeNsec, path };
+}
 
-    return HKS_SUCCESS;
+static void LoadJournal(struct HksTransferJournal *journal)
+{
+    uint32_t size = HksFileSize(NULL, HKS_TRANSFER_JOURNAL_PATH);
+    if (size == 0 || size > HKS_TRANSFER_JOURNAL_MAX_SIZE) {
+        (void)HksFileRemove(NULL, HKS_TRANSFER_JOURNAL_PATH);
+        return;
+    }
+    uint32_t lineCount = 0;
+    do {
+        journal->content = (char *)HksMalloc(size + 1);
+        HKS_IF_NULL_BREAK(journal->content)
+        struct HksBlob blob = { size, (uint8_t *)journal->content };
+        HKS_IF_NOT_SUCC_BREAK(HksFileRead(NULL, HKS_TRANSFER_JOURNAL_PATH, 0, &blob, &size))
+        journal->content[size] = '\0';
+        for (uint32_t i = 0; i < size; ++i) {
+            lineCount += (journal->content[i] == '\n') ? 1 : 0;
+        }
+        journal->capacity = 1;
+        while (journal->capacity < lineCount * 2 + 1) {
+            journal->capacity <<= 1;
+        }
+        journal->entries = (struct HksTransferJournalEntry *)HksMalloc(
+            sizeof(struct HksTransferJournalEntry) * journal->capacity);
+        HKS_IF_NULL_BREAK(journal->entries)
+        for (char *line = journal->content; line != NULL && *line != '\0'; line = strchr(line, '\n')) {
+            line += (*line == '\n') ? 1 : 0;
+            AddJournalEntry(journal, line);
+        }
+        return;
+    } while (false);
+    HKS_LOG_E("load transfer journal failed, every directory is scanned.");
+    HKS_FREE(journal->entries);
+    HKS_FREE(journal->content);
 }
 
-static int32_t GetFileContent(const char *path, const char *alias, struct HksBlob *fileContent)
+static void OpenJournal(struct HksTransferJournal *journal)
 {
-    uint32_t size = HksFileSize(path, alias);
-    if (size == 0) {
-        return HKS_ERROR_FILE_SIZE_FAIL;
+    LoadJournal(journal);
+    journal->fd = open(HKS_TRANSFER_JOURNAL_PATH, O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, S_IRUSR | S_IWUSR);
+    if (journal->fd < 0) {
+        HKS_LOG_E("open transfer journal failed, errno is %" LOG_PUBLIC "d.", errno);
     }
-    fileContent->data = (uint8_t *)HksMalloc(size);
-    HKS_IF_NULL_RETURN(fileContent->data, HKS_ERROR_MALLOC_FAIL)
+}
 
-    fileContent->size = size;
-    return HksFileRead(path, alias, 0, fileContent, &fileContent->size);
+static void CloseJournal(struct HksTransferJournal *journal)
+{
+    if (journal->fd >= 0) {
+        (void)fsync(journal->fd);
+        (void)close(journal->fd);
+        journal->fd = -1;
+    }
+    HKS_FREE(journal->entries);
+    HKS_FREE(journal->content);
 }
 
-static int ProcessFileUpgrade(const char *filePath, const struct stat *st, int typeFlag, struct FTW *ftw)
+// called without the engine lock, a journal line is one O_APPEND write and does not interleave with others
+static void AppendJournal(struct HksTransferEngine *engine, const struct HksTransferDir *dir)
 {
-    (void)st;
-    if (typeFlag != FTW_F) {
-        HKS_LOG_D("%" LOG_PUBLIC "s not a file", filePath);
-        return 0;
+    struct stat dirStat;
+    char line[HKS_TRANSFER_JOURNAL_LINE_LEN] = { 0 };
+    uint32_t pathLen = strlen(dir->path) - 1; /* without the trailing '/' */
+    if (stat(dir->path, &dirStat) != 0) {
+        return;
     }
-    char *alias = NULL;
-    char *path = NULL;
-    struct HksBlob fileContent = { 0 };
-    int32_t ret;
-    do {
-        ret = SplitPath(filePath, ftw, &path, &alias);
-        HKS_IF_NOT_SUCC_LOGE_BREAK(ret, "split filePath failed.")
+    int len = snprintf_s(line, sizeof(line), sizeof(line) - 1, "%lld %ld %.*s\n",
+        (long long)dirStat.st_mtim.tv_sec, dirStat.st_mtim.tv_nsec, (int)pathLen, dir->path);
+    if (len > 0 && write(engine->journal.fd, line, len) != len) {
+        HKS_LOG_E("append transfer journal failed.");
+    }
+}
 
-        ret = GetFileContent(path, alias, &fileContent);
-        HKS_IF_NOT_SUCC_LOGE_BREAK(ret, "get file content failed.")
+static void ReleaseDir(struct HksTransferEngine *engine, struct HksTransferDir *dir, bool isAllHandled,
+    uint32_t movedCount)
+{
+    (void)pthread_mutex_lock(&engine->lock);
+    dir->isAllHandled = dir->isAllHandled && isAllHandled;
+    engine->movedCount += movedCount;
+    bool isLast = (--dir->refCount == 0);
+    (void)pthread_mutex_unlock(&engine->lock);
+    if (!isLast) {
+        return;
+    }
+    if (dir->isAllHandled && engine->journal.fd >= 0) {
+        AppendJournal(engine, dir);
+    }
+    HKS_FREE(dir);
+}
 
-        struct HksUpgradeFileTransferInfo info = { 0 };
-        ret = HksParseConfig(alias, &fileContent, &info);
-        if (ret != HKS_SUCCESS) {
-            HKS_LOG_E("HksParseConfig failed, path is %" LOG_PUBLIC "s", filePath);
-            break;
+static void ProcessBatch(struct HksTransferEngine *engine, struct HksTransferBatch *batch)
+{
+    bool isAllHandled = true;
+    uint32_t movedCount = 0;
+    for (uint32_t i = 0; i < batch->count; ++i) {
+        bool isMoved = false;
+        isAllHandled = ProcessKeyFile(engine, batch->dir, batch->aliases[i], &isMoved) && isAllHandled;
+        movedCount += isMoved ? 1 : 0;
+    }
+    ReleaseDir(engine, batch->dir, isAllHandled, movedCount);
+    HKS_FREE(batch);
+}
+
+static struct HksTransferBatch *PopBatch(struct HksTransferEngine *engine)
+{
+    (void)pthread_mutex_lock(&engine->lock);
+    while (engine->head == NULL && !engine->isScanDone) {
+        (void)pthread_cond_wait(&engine->hasWork, &engine->lock);
+    }
+    struct HksTransferBatch *batch = engine->head;
+    if (batch != NULL) {
+        engine->head = batch->next;
+        engine->tail = (engine->head == NULL) ? NULL : engine->tail;
+        --engine->queued;
+        (void)pthread_cond_signal(&engine->hasRoom);
+    }
+    (void)pthread_mutex_unlock(&engine->lock);
+    return batch;
+}
+
+static void *TransferWorker(void *arg)
+{
+    struct HksTransferEngine *engine = (struct HksTransferEngine *)arg;
+    struct HksTransferBatch *batch = PopBatch(engine);
+    while (batch != NULL) {
+        ProcessBatch(engine, batch);
+        batch = PopBatch(engine);
+    }
+    return NULL;
+}
+
+// hands a batch to the workers, or processes it on the scanning thread when no worker could be started
+static void PushBatch(struct HksTransferEngine *engine, struct HksTransferBatch *batch)
+{
+    (void)pthread_mutex_lock(&engine->lock);
+    ++batch->dir->refCount;
+    if (engine->workerNum == 0) {
+        (void)pthread_mutex_unlock(&engine->lock);
+        ProcessBatch(engine, batch);
+        return;
+    }
+    while (engine->queued >= HKS_TRANSFER_MAX_QUEUED_BATCH) {
+        (void)pthread_cond_wait(&engine->hasRoom, &engine->lock);
+    }
+    if (engine->tail == NULL) {
+        engine->head = batch;
+    } else {
+        engine->tail->next = batch;
+    }
+    engine->tail = batch;
+    ++engine->queued;
+    (void)pthread_cond_signal(&engine->hasWork);
+    (void)pthread_mutex_unlock(&engine->lock);
+}
+
+static bool IsEntryDir(int dirFd, const struct dirent *dire, bool *isFile)
+{
+    struct stat entryStat;
+    if (dire->d_type != DT_UNKNOWN) {
+        *isFile = (dire->d_type == DT_REG);
+        return dire->d_type == DT_DIR;
+    }
+    // soft links are neither followed nor transferred
+    if (fstatat(dirFd, dire->d_name, &entryStat, AT_SYMLINK_NOFOLLOW) != 0) {
+        *isFile = false;
+        return false;
+    }
+    *isFile = S_ISREG(entryStat.st_mode);
+    return S_ISDIR(entryStat.st_mode);
+}
+
+static struct HksTransferDir *CreateTransferDir(struct HksTransferEngine *engine, const char *path, bool *isJournaled)
+{
+    struct stat dirStat;
+    if (lstat(path, &dirStat) != 0 || !S_ISDIR(dirStat.st_mode)) {
+        return NULL;
+    }
+    struct HksTransferDir *dir = (struct HksTransferDir *)HksMalloc(sizeof(struct HksTransferDir));
+    HKS_IF_NULL_RETURN(dir, NULL)
+    if (snprintf_s(dir->path, sizeof(dir->path), sizeof(dir->path) - 1, "%s/", path) < 0) {
+        HKS_FREE(dir);
+        return NULL;
+    }
+    dir->dev = dirStat.st_dev;
+    dir->refCount = 1;
+    dir->isAllHandled = true;
+    *isJournaled = IsDirJournaled(&engine->journal, path, &dirStat);
+    return dir;
+}
+
+ENABLE_CFI(static void ScanDir(struct HksTransferEngine *engine, const char *path, uint32_t depth))
+{
+    bool isJournaled = false;
+    struct HksTransferDir *dir = CreateTransferDir(engine, path, &isJournaled);
+    if (dir == NULL) {
+        return;
+    }
+    engine->skippedDirCount += isJournaled ? 1 : 0;
+    DIR *dirp = opendir(path);
+    if (dirp == NULL) {
+        ReleaseDir(engine, dir, false, 0);
+        return;
+    }
+    bool isAllQueued = true;
+    struct HksTransferBatch *batch = NULL;
+    for (struct dirent *dire = readdir(dirp); dire != NULL; dire = readdir(dirp)) {
+        bool isFile = false;
+        if (strcmp(dire->d_name, ".") == 0 || strcmp(dire->d_name, "..") == 0) {
+            continue;
         }
-        if (info.skipTransfer) {
-            HKS_LOG_I("file %" LOG_PUBLIC "s should skip transfer.", filePath);
-            break;
+        if (IsEntryDir(dirfd(dirp), dire, &isFile)) {
+            char subPath[HKS_MAX_FILE_NAME_LEN] = { 0 };
+            if (depth + 1 < HKS_TRANSFER_MAX_DEPTH &&
+                snprintf_s(subPath, sizeof(subPath), sizeof(subPath) - 1, "%s%s", dir->path, dire->d_name) > 0) {
+                ScanDir(engine, subPath, depth + 1);
+            }
+            continue;
         }
-        HKS_IF_NOT_SUCC_LOGE(TransferFile(alias, path, &fileContent, &info), "TransferFile failed!")
-    } while (false);
-    HKS_FREE(path);
-    HKS_FREE(alias);
-    HKS_FREE_BLOB(fileContent);
-
-    // continue to traverse files
-    return 0;
+        if (!isFile || isJournaled || (engine->filter != NULL && !engine->filter(dire->d_name))) {
+            continue;
+        }
+        if (batch == NULL) {
+            batch = (struct HksTransferBatch *)HksMalloc(sizeof(struct HksTransferBatch));
+            if (batch == NULL) {
+                isAllQueued = false;
+                break;
+            }
+            batch->dir = dir;
+        }
+        if (strcpy_s(batch->aliases[batch->count], sizeof(batch->aliases[0]), dire->d_name) != EOK) {
+            isAllQueued = false;
+            continue;
+        }
+        if (++batch->count == HKS_TRANSFER_BATCH_SIZE) {
+            PushBatch(engine, batch);
+            batch = NULL;
+        }
+    }
+    closedir(dirp);
+    if (batch != NULL) {
+        PushBatch(engine, batch);
+    }
+    ReleaseDir(engine, dir, isAllQueued, 0);
 }
 
-ENABLE_CFI(int32_t UpgradeFileTransfer(void))
+// moves the key files under rootPath with HKS_TRANSFER_WORKER_NUM workers while this thread scans the tree
+ENABLE_CFI(static void RunTransferEngine(const char *rootPath, bool (*filter)(const char *alias), bool useJournal))
 {
-    // depth first and ignore soft link
-    int nftwRet = nftw(HKS_KEY_STORE_TMP_PATH, ProcessFileUpgrade, OPEN_FDS, FTW_DEPTH | FTW_PHYS);
-    HKS_LOG_I("call nftw result is %" LOG_PUBLIC "d.", nftwRet);
+    struct HksTransferEngine engine = { .journal = { .fd = -1 } };
+    pthread_t workers[HKS_TRANSFER_WORKER_NUM];
+    (void)pthread_mutex_init(&engine.lock, NULL);
+    (void)pthread_mutex_init(&engine.destLock, NULL);
+    (void)pthread_cond_init(&engine.hasWork, NULL);
+    (void)pthread_cond_init(&engine.hasRoom, NULL);
+    engine.filter = filter;
+    engine.dests = (struct HksTransferDestination *)HksMalloc(
+        sizeof(struct HksTransferDestination) * HKS_TRANSFER_DEST_CACHE_SIZE);
+    if (useJournal) {
+        OpenJournal(&engine.journal);
+    }
+    for (uint32_t i = 0; i < HKS_TRANSFER_WORKER_NUM; ++i) {
+        if (pthread_create(&workers[engine.workerNum], NULL, TransferWorker, &engine) == 0) {
+            ++engine.workerNum;
+        }
+    }
+
+    ScanDir(&engine, rootPath, 0);
+
+    (void)pthread_mutex_lock(&engine.lock);
+    engine.isScanDone = true;
+    (void)pthread_cond_broadcast(&engine.hasWork);
+    (void)pthread_mutex_unlock(&engine.lock);
+    for (uint32_t i = 0; i < engine.workerNum; ++i) {
+        (void)pthread_join(workers[i], NULL);
+    }
+    HKS_LOG_I("transfer %" LOG_PUBLIC "s done with %" LOG_PUBLIC "u workers, %" LOG_PUBLIC "u files moved, %"
+        LOG_PUBLIC "u dirs skipped by journal.", rootPath, engine.workerNum, engine.movedCount,
+        engine.skippedDirCount);
+
+    CloseJournal(&engine.journal);
+    HKS_FREE(engine.dests);
+    (void)pthread_cond_destroy(&engine.hasRoom);
+    (void)pthread_cond_destroy(&engine.hasWork);
+    (void)pthread_mutex_destroy(&engine.destLock);
+    (void)pthread_mutex_destroy(&engine.lock);
+}
 
+int32_t UpgradeFileTransfer(void)
+{
+    RunTransferEngine(HKS_KEY_STORE_TMP_PATH, NULL, true);
     return HKS_SUCCESS;
 }
 
@@ -273,57 +733,11 @@ static int32_t CopyDeToTmpPathIfNeed(void)
     return HKS_SUCCESS;
 }
 
-static int ProcessRdbCeToDeUpgrade(const char *filePath, const struct stat *st, int typeFlag, struct FTW *ftw)
-{
-    (void)st;
-    if (typeFlag != FTW_F) {
-        HKS_LOG_D("%" LOG_PUBLIC "s not a file", filePath);
-        return 0;
-    }
-
-    char *alias = NULL;
-    char *path = NULL;
-    struct HksBlob fileContent = { 0 };
-    int32_t ret;
-    do {
-        ret = SplitPath(filePath, ftw, &path, &alias);
-        HKS_IF_NOT_SUCC_LOGE_BREAK(ret, "split filePath failed.")
-
-        if (!HksIsRdbDeKey(alias)) {
-            // Not rdb key file, break and do nothing.
-            break;
-        }
-
-        HKS_LOG_I("Find rdb key file in %" LOG_PUBLIC "s.", path);
-
-        ret = GetFileContent(path, alias, &fileContent);
-        HKS_IF_NOT_SUCC_LOGE_BREAK(ret, "get file content failed.")
-
-        struct HksUpgradeFileTransferInfo info = { 0 };
-        ret = HksParseConfig(alias, &fileContent, &info);
-        if (ret != HKS_SUCCESS) {
-            HKS_LOG_E("HksParseConfig failed, path is %" LOG_PUBLIC "s", filePath);
-            break;
-        }
-        if (info.skipTransfer) {
-            HKS_LOG_I("file %" LOG_PUBLIC "s should skip transfer.", filePath);
-            break;
-        }
-        HKS_IF_NOT_SUCC_LOGE(TransferFile(alias, path, &fileContent, &info), "TransferFile failed!")
-    } while (false);
-    HKS_FREE(path);
-    HKS_FREE(alias);
-    HKS_FREE_BLOB(fileContent);
-
-    // Continue to traverse files.
-    return 0;
-}
-
 const char * const HUKS_CE_ROOT_PATH = "/data/service/el2";
 const char * const HUKS_SERVICE_SUB_PATH = "huks_service";
 
 // Copy the rdb key in ce into DE.
-ENABLE_CFI(static int32_t CopyRdbCeToDePathIfNeed(void))
+static int32_t CopyRdbCeToDePathIfNeed(void)
 {
     char huksCePath[HKS_MAX_DIRENT_FILE_LEN] = { 0 };
     int32_t offset = sprintf_s(huksCePath, HKS_MAX_DIRENT_FILE_LEN, "%s/%u/%s", HUKS_CE_ROOT_PATH, g_frontUserId,
@@ -334,26 +748,32 @@ ENABLE_CFI(static int32_t CopyRdbCeToDePathIfNeed(void))
         return HKS_ERROR_BAD_STATE;
     }
 
-    // depth first and ignore soft link
-    int nftwRet = nftw(huksCePath, ProcessRdbCeToDeUpgrade, OPEN_FDS, FTW_DEPTH | FTW_PHYS);
-    HKS_LOG_I("call nftw result is %" LOG_PUBLIC "d.", nftwRet);
-
+    // only rdb key files are moved, the ce directory keeps changing so no journal is kept for it
+    RunTransferEngine(huksCePath, HksIsRdbDeKey, false);
     return HKS_SUCCESS;
 }
 
 int32_t HksUpgradeFileTransferOnPowerOn(void)
 {
     CopyDeToTmpPathIfNeed();
+    HksConfigTokenCacheInit();
     int32_t ret = CopyRdbCeToDePathIfNeed();
     // If the ret is fail, continue to upgrade next step instead of return.
     if (ret != HKS_SUCCESS) {
         HKS_LOG_E("CopyRdbCeToDePathIfNeed failed, ret is %" LOG_PUBLIC "d.", ret);
     }
-    return UpgradeFileTransfer();
+    ret = UpgradeFileTransfer();
+    HksConfigTokenCacheDestroy();
+    return ret;
 }
 
 int32_t HksUpgradeFileTransferOnUserUnlock(uint32_t userId)
 {
     g_frontUserId = userId;
-    return HksUpgradeFileTransferOnPowerOn();
+    int32_t ret = HksUpgradeFileTransferOnPowerOn();
+#ifdef HKS_SUPPORT_KEY_CACHE
+    // the transfer writes key files around hks_storage, the cached state of any of them may be stale now
+    HksKeyCacheClear();
+#endif
+    return ret;
 }
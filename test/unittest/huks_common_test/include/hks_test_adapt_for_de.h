@@ -51,6 +51,9 @@ int32_t HksSignForDe(const struct HksBlob *key, const struct HksParamSet *paramS
 int32_t HksVerifyForDe(const struct HksBlob *key, const struct HksParamSet *paramSet,
     const struct HksBlob *srcData, const struct HksBlob *signature);
 
+int32_t HksBatchVerifyForDe(const struct HksBlob *key, const struct HksParamSet *paramSet,
+    const struct HksBlob *srcData, const struct HksBlob *signature, uint32_t count, struct HksBlob *result);
+
 int32_t HksEncryptForDe(const struct HksBlob *key, const struct HksParamSet *paramSet,
     const struct HksBlob *plainText, struct HksBlob *cipherText);
 
@@ -278,6 +278,28 @@ int32_t HksVerifyForDe(const struct HksBlob *key, const struct HksParamSet *para
     return ret;
 }
 
+int32_t HksBatchVerifyForDe(const struct HksBlob *key, const struct HksParamSet *paramSet,
+    const struct HksBlob *srcData, const struct HksBlob *signature, uint32_t count, struct HksBlob *result)
+{
+    int32_t ret;
+    struct HksParamSet *newParamSet = NULL;
+    if (paramSet != NULL) {
+        ret = ConstructNewParamSet(paramSet, &newParamSet);
+    } else {
+        struct HksParam tmpParams[] = {
+            { .tag = HKS_TAG_AUTH_STORAGE_LEVEL, .uint32Param = HKS_AUTH_STORAGE_LEVEL_DE },
+        };
+        ret = GenerateParamSet(&newParamSet, tmpParams, sizeof(tmpParams) / sizeof(tmpParams[0]));
+    }
+    if (ret != HKS_SUCCESS) {
+        HKS_LOG_E("construct new paramSet fail");
+        return ret;
+    }
+    ret = HksBatchVerify(key, newParamSet, srcData, signature, count, result);
+    HksFreeParamSet(&newParamSet);
+    return ret;
+}
+
 int32_t HksEncryptForDe(const struct HksBlob *key, const struct HksParamSet *paramSet,
     const struct HksBlob *plainText, struct HksBlob *cipherText)
 {
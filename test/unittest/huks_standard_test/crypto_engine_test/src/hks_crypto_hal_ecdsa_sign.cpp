@@ -42,6 +42,7 @@ struct TestCaseParams {
 
 const uint32_t SIGNATURE_SIZE = 521;
 const uint32_t MAX_PUB_KEY_SIZE = 218;
+const uint32_t BATCH_VERIFY_COUNT = 3;
 
 #ifdef HKS_UNTRUSTED_RUNNING_ENV
 const TestCaseParams HKS_CRYPTO_HAL_ECDSA_SIGN_001_PARAMS = {
@@ -558,6 +559,39 @@ protected:
         HKS_FREE(pubKey.data);
         HKS_FREE(key.data);
     }
+
+    void RunBatchVerifyTestCase(const TestCaseParams &testCaseParams) const
+    {
+        HksBlob key = { .size = 0, .data = nullptr };
+        ASSERT_EQ(HksCryptoHalGenerateKey(&testCaseParams.spec, &key), HKS_SUCCESS);
+        struct HksBlob pubKey = { .size = MAX_PUB_KEY_SIZE, .data = (uint8_t *)HksMalloc(MAX_PUB_KEY_SIZE) };
+        ASSERT_NE(pubKey.data, nullptr);
+        EXPECT_EQ(HksCryptoHalGetPubKey(&key, &pubKey), HKS_SUCCESS);
+
+        uint8_t hashData[BATCH_VERIFY_COUNT][HKS_HMAC_DIGEST_SHA512_LEN] = {{0}};
+        uint8_t signData[BATCH_VERIFY_COUNT][SIGNATURE_SIZE] = {{0}};
+        struct HksBlob hashes[BATCH_VERIFY_COUNT];
+        struct HksBlob signatures[BATCH_VERIFY_COUNT];
+        for (uint32_t i = 0; i < BATCH_VERIFY_COUNT; ++i) {
+            uint8_t msgData[] = { 0x00, 0x11, 0x22, (uint8_t)i };
+            struct HksBlob message = { sizeof(msgData), msgData };
+            hashes[i] = { HKS_HMAC_DIGEST_SHA512_LEN, hashData[i] };
+            EXPECT_EQ(HksCryptoHalHash(testCaseParams.usageSpec.digest, &message, &hashes[i]), HKS_SUCCESS);
+            signatures[i] = { SIGNATURE_SIZE, signData[i] };
+            EXPECT_EQ(HksCryptoHalSign(&key, &testCaseParams.usageSpec, &hashes[i], &signatures[i]), HKS_SUCCESS);
+        }
+        /* the second signature belongs to another message and must be the only one rejected */
+        signatures[1] = signatures[0];
+
+        uint8_t bitmap[HKS_BATCH_VERIFY_RESULT_SIZE(BATCH_VERIFY_COUNT)] = {0};
+        struct HksBlob result = { sizeof(bitmap), bitmap };
+        EXPECT_EQ(HksCryptoHalBatchVerify(&pubKey, &testCaseParams.usageSpec, hashes, signatures,
+            BATCH_VERIFY_COUNT, &result), HKS_SUCCESS);
+        EXPECT_EQ(bitmap[0], 0x05);
+
+        HKS_FREE(pubKey.data);
+        HKS_FREE(key.data);
+    }
 };
 
 void HksCryptoHalEcdsaSign::SetUpTestCase(void)
@@ -819,6 +853,16 @@ HWTEST_F(HksCryptoHalEcdsaSign, HksCryptoHalEcdsaSign_024, Function | SmallTest
 {
     RunTestCase(HKS_CRYPTO_HAL_ECDSA_SIGN_024_PARAMS);
 }
+
+/**
+ * @tc.number    : HksCryptoHalEcdsaSign_025
+ * @tc.name      : HksCryptoHalEcdsaSign_025
+ * @tc.desc      : Using HksCryptoHalBatchVerify verify ECC-256-SHA512 signatures with one key.
+ */
+HWTEST_F(HksCryptoHalEcdsaSign, HksCryptoHalEcdsaSign_025, Function | SmallTest | Level0)
+{
+    RunBatchVerifyTestCase(HKS_CRYPTO_HAL_ECDSA_SIGN_022_PARAMS);
+}
 }  // namespace UnitTest
 }  // namespace Huks
 }  // namespace Security
@@ -0,0 +1,271 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <chrono>
+#include <gtest/gtest.h>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "hks_ability.h"
+#include "hks_common_check.h"
+#include "hks_config.h"
+#include "hks_crypto_hal.h"
+#include "hks_crypto_hal_common.h"
+#include "hks_hash_multi_buffer.h"
+#include "hks_mem.h"
+
+using namespace testing::ext;
+namespace OHOS {
+namespace Security {
+namespace Huks {
+namespace UnitTest {
+namespace {
+const uint32_t SHA256_SIZE = 32;
+const uint32_t BENCH_ROUNDS = 2000;
+const uint32_t HMAC_THREADS = HKS_HASH_MB_LANES;
+const uint32_t HMAC_ROUNDS = 200;
+const uint32_t HASH_ROUNDS = 2000;
+const uint32_t SHORT_KEY_SIZE = 32;
+const uint32_t LONG_KEY_SIZE = 100;
+const uint32_t MESSAGE_SIZES[HKS_HASH_MB_LANES] = { 1, 55, 56, 63, 64, 119, 1000, 4096 };
+const uint32_t BENCH_SIZES[] = { 64, 256, 1024, 4096 };
+
+std::vector<uint8_t> MakeMessage(uint32_t size, uint8_t seed)
+{
+    std::vector<uint8_t> msg(size);
+    for (uint32_t i = 0; i < size; ++i) {
+        msg[i] = (uint8_t)(seed + i * 7);
+    }
+    return msg;
+}
+
+double MegaBytesPerSecond(uint64_t bytes, std::chrono::steady_clock::duration cost)
+{
+    double seconds = std::chrono::duration<double>(cost).count();
+    return (seconds > 0) ? (bytes / seconds / (1024 * 1024)) : 0;
+}
+}  // namespace
+
+class HksCryptoHalHashMb : public HksCryptoHalCommon, public testing::Test {
+public:
+    static void SetUpTestCase(void);
+    static void TearDownTestCase(void);
+    void SetUp();
+    void TearDown();
+};
+
+void HksCryptoHalHashMb::SetUpTestCase(void)
+{
+}
+
+void HksCryptoHalHashMb::TearDownTestCase(void)
+{
+}
+
+void HksCryptoHalHashMb::SetUp()
+{
+    EXPECT_EQ(HksCryptoAbilityInit(), 0);
+}
+
+void HksCryptoHalHashMb::TearDown()
+{
+}
+
+/**
+ * @tc.number    : HksCryptoHalHashMb_001
+ * @tc.name      : HksCryptoHalHashMb_001
+ * @tc.desc      : All lanes of HksSha256MultiBuffer match the single stream SHA-256, lengths cross padding edges.
+ */
+HWTEST_F(HksCryptoHalHashMb, HksCryptoHalHashMb_001, Function | SmallTest | Level0)
+{
+    std::vector<std::vector<uint8_t>> msgs;
+    HksBlob msgBlobs[HKS_HASH_MB_LANES];
+    uint8_t digests[HKS_HASH_MB_LANES][SHA256_SIZE] = {{ 0 }};
+    HksBlob digestBlobs[HKS_HASH_MB_LANES];
+    for (uint32_t i = 0; i < HKS_HASH_MB_LANES; ++i) {
+        msgs.push_back(MakeMessage(MESSAGE_SIZES[i], (uint8_t)i));
+    }
+    for (uint32_t i = 0; i < HKS_HASH_MB_LANES; ++i) {
+        msgBlobs[i] = { .size = MESSAGE_SIZES[i], .data = msgs[i].data() };
+        digestBlobs[i] = { .size = SHA256_SIZE, .data = digests[i] };
+    }
+    ASSERT_EQ(HksSha256MultiBuffer(msgBlobs, digestBlobs, HKS_HASH_MB_LANES), HKS_SUCCESS);
+
+    Hash single = (Hash)GetAbility(HKS_CRYPTO_ABILITY_HASH);
+    ASSERT_NE(single, nullptr);
+    for (uint32_t i = 0; i < HKS_HASH_MB_LANES; ++i) {
+        uint8_t expect[SHA256_SIZE] = { 0 };
+        HksBlob expectBlob = { .size = SHA256_SIZE, .data = expect };
+        ASSERT_EQ(single(HKS_DIGEST_SHA256, &msgBlobs[i], &expectBlob), HKS_SUCCESS);
+        EXPECT_EQ(digestBlobs[i].size, SHA256_SIZE);
+        EXPECT_EQ(HksMemCmp(expect, digests[i], SHA256_SIZE), 0) << "lane " << i;
+    }
+}
+
+/**
+ * @tc.number    : HksCryptoHalHashMb_002
+ * @tc.name      : HksCryptoHalHashMb_002
+ * @tc.desc      : Concurrent HksCryptoHalHmac callers are batched and still match the single stream HMAC-SHA256.
+ */
+HWTEST_F(HksCryptoHalHashMb, HksCryptoHalHashMb_002, Function | SmallTest | Level0)
+{
+    Hmac single = (Hmac)GetAbility(HKS_CRYPTO_ABILITY_HMAC);
+    ASSERT_NE(single, nullptr);
+    std::vector<uint32_t> failures(HMAC_THREADS, 0);
+    std::vector<std::thread> threads;
+    for (uint32_t t = 0; t < HMAC_THREADS; ++t) {
+        threads.emplace_back([t, single, &failures]() {
+            /* odd threads use a key longer than one block so the key is hashed first */
+            std::vector<uint8_t> key = MakeMessage(((t & 1) == 0) ? SHORT_KEY_SIZE : LONG_KEY_SIZE, (uint8_t)t);
+            std::vector<uint8_t> msg = MakeMessage(MESSAGE_SIZES[t], (uint8_t)(t + 1));
+            HksBlob keyBlob = { .size = (uint32_t)key.size(), .data = key.data() };
+            HksBlob msgBlob = { .size = (uint32_t)msg.size(), .data = msg.data() };
+            for (uint32_t r = 0; r < HMAC_ROUNDS; ++r) {
+                uint8_t mac[SHA256_SIZE] = { 0 };
+                uint8_t expect[SHA256_SIZE] = { 0 };
+                HksBlob macBlob = { .size = SHA256_SIZE, .data = mac };
+                HksBlob expectBlob = { .size = SHA256_SIZE, .data = expect };
+                if (HksCryptoHalHmac(&keyBlob, HKS_DIGEST_SHA256, &msgBlob, &macBlob) != HKS_SUCCESS ||
+                    single(&keyBlob, HKS_DIGEST_SHA256, &msgBlob, &expectBlob) != HKS_SUCCESS ||
+                    macBlob.size != SHA256_SIZE || HksMemCmp(mac, expect, SHA256_SIZE) != 0) {
+                    ++failures[t];
+                }
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    for (uint32_t t = 0; t < HMAC_THREADS; ++t) {
+        EXPECT_EQ(failures[t], 0u) << "thread " << t;
+    }
+}
+
+/**
+ * @tc.number    : HksCryptoHalHashMb_003
+ * @tc.name      : HksCryptoHalHashMb_003
+ * @tc.desc      : Requests the multi-buffer engine does not batch are handed back to the single stream engine.
+ */
+HWTEST_F(HksCryptoHalHashMb, HksCryptoHalHashMb_003, Function | SmallTest | Level0)
+{
+    std::vector<uint8_t> msg = MakeMessage(HKS_HASH_MB_MAX_INPUT_SIZE + 1, 0);
+    HksBlob msgBlob = { .size = (uint32_t)msg.size(), .data = msg.data() };
+    uint8_t hash[HKS_DIGEST_SHA512_LEN] = { 0 };
+    HksBlob hashBlob = { .size = sizeof(hash), .data = hash };
+
+    EXPECT_EQ(HksHashMultiBuffer(HKS_DIGEST_SHA256, &msgBlob, &hashBlob), HKS_ERROR_NOT_SUPPORTED);
+    msgBlob.size = SHA256_SIZE;
+    EXPECT_EQ(HksHashMultiBuffer(HKS_DIGEST_SHA512, &msgBlob, &hashBlob), HKS_ERROR_NOT_SUPPORTED);
+    /* a lone caller finds no company and is sent to the single stream engine without waiting */
+    EXPECT_EQ(HksHashMultiBuffer(HKS_DIGEST_SHA256, &msgBlob, &hashBlob), HKS_ERROR_NOT_SUPPORTED);
+
+    EXPECT_EQ(HksCryptoHalHash(HKS_DIGEST_SHA512, &msgBlob, &hashBlob), HKS_SUCCESS);
+    EXPECT_EQ(hashBlob.size, HKS_DIGEST_SHA512_LEN);
+}
+
+/**
+ * @tc.number    : HksCryptoHalHashMb_004
+ * @tc.name      : HksCryptoHalHashMb_004
+ * @tc.desc      : Throughput of single stream SHA-256 against eight lane multi-buffer SHA-256, 64 B to 4 KB.
+ */
+HWTEST_F(HksCryptoHalHashMb, HksCryptoHalHashMb_004, Function | SmallTest | Level1)
+{
+    Hash single = (Hash)GetAbility(HKS_CRYPTO_ABILITY_HASH);
+    ASSERT_NE(single, nullptr);
+    for (uint32_t size : BENCH_SIZES) {
+        std::vector<std::vector<uint8_t>> msgs;
+        HksBlob msgBlobs[HKS_HASH_MB_LANES];
+        uint8_t digests[HKS_HASH_MB_LANES][SHA256_SIZE] = {{ 0 }};
+        HksBlob digestBlobs[HKS_HASH_MB_LANES];
+        for (uint32_t i = 0; i < HKS_HASH_MB_LANES; ++i) {
+            msgs.push_back(MakeMessage(size, (uint8_t)i));
+        }
+        for (uint32_t i = 0; i < HKS_HASH_MB_LANES; ++i) {
+            msgBlobs[i] = { .size = size, .data = msgs[i].data() };
+            digestBlobs[i] = { .size = SHA256_SIZE, .data = digests[i] };
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        for (uint32_t r = 0; r < BENCH_ROUNDS; ++r) {
+            for (uint32_t i = 0; i < HKS_HASH_MB_LANES; ++i) {
+                digestBlobs[i].size = SHA256_SIZE;
+                ASSERT_EQ(single(HKS_DIGEST_SHA256, &msgBlobs[i], &digestBlobs[i]), HKS_SUCCESS);
+            }
+        }
+        auto singleCost = std::chrono::steady_clock::now() - start;
+
+        start = std::chrono::steady_clock::now();
+        for (uint32_t r = 0; r < BENCH_ROUNDS; ++r) {
+            ASSERT_EQ(HksSha256MultiBuffer(msgBlobs, digestBlobs, HKS_HASH_MB_LANES), HKS_SUCCESS);
+        }
+        auto multiCost = std::chrono::steady_clock::now() - start;
+
+        uint64_t bytes = (uint64_t)size * HKS_HASH_MB_LANES * BENCH_ROUNDS;
+        std::cout << "sha256 " << size << " B: single stream " << MegaBytesPerSecond(bytes, singleCost) <<
+            " MB/s, multi-buffer " << MegaBytesPerSecond(bytes, multiCost) << " MB/s" << std::endl;
+    }
+}
+
+/**
+ * @tc.number    : HksCryptoHalHashMb_005
+ * @tc.name      : HksCryptoHalHashMb_005
+ * @tc.desc      : Concurrent HksHashMultiBuffer callers get the right digest whether batched or handed back.
+ */
+HWTEST_F(HksCryptoHalHashMb, HksCryptoHalHashMb_005, Function | SmallTest | Level0)
+{
+    Hash single = (Hash)GetAbility(HKS_CRYPTO_ABILITY_HASH);
+    ASSERT_NE(single, nullptr);
+    std::vector<uint32_t> failures(HKS_HASH_MB_LANES, 0);
+    std::vector<uint32_t> batched(HKS_HASH_MB_LANES, 0);
+    std::vector<std::thread> threads;
+    for (uint32_t t = 0; t < HKS_HASH_MB_LANES; ++t) {
+        threads.emplace_back([t, single, &failures, &batched]() {
+            std::vector<uint8_t> msg = MakeMessage(HKS_HASH_MB_MAX_INPUT_SIZE - t, (uint8_t)t);
+            HksBlob msgBlob = { .size = (uint32_t)msg.size(), .data = msg.data() };
+            uint8_t expect[SHA256_SIZE] = { 0 };
+            HksBlob expectBlob = { .size = SHA256_SIZE, .data = expect };
+            if (single(HKS_DIGEST_SHA256, &msgBlob, &expectBlob) != HKS_SUCCESS) {
+                ++failures[t];
+                return;
+            }
+            for (uint32_t r = 0; r < HASH_ROUNDS; ++r) {
+                uint8_t hash[SHA256_SIZE] = { 0 };
+                HksBlob hashBlob = { .size = SHA256_SIZE, .data = hash };
+                int32_t ret = HksHashMultiBuffer(HKS_DIGEST_SHA256, &msgBlob, &hashBlob);
+                if (ret == HKS_ERROR_NOT_SUPPORTED) {
+                    continue;
+                }
+                ++batched[t];
+                if (ret != HKS_SUCCESS || hashBlob.size != SHA256_SIZE || HksMemCmp(hash, expect, SHA256_SIZE) != 0) {
+                    ++failures[t];
+                }
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    uint32_t batchedTotal = 0;
+    for (uint32_t t = 0; t < HKS_HASH_MB_LANES; ++t) {
+        EXPECT_EQ(failures[t], 0u) << "thread " << t;
+        batchedTotal += batched[t];
+    }
+    std::cout << "batched " << batchedTotal << " of " << HKS_HASH_MB_LANES * HASH_ROUNDS << " requests" << std::endl;
+}
+}  // namespace UnitTest
+}  // namespace Huks
+}  // namespace Security
+}  // namespace OHOS
@@ -0,0 +1,24 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef HKS_LOG_LIMITER_TEST_H
+#define HKS_LOG_LIMITER_TEST_H
+
+namespace Unittest::HksFrameworkCommonLogLimiterTest {
+int HksLogLimiterTest001(void);
+int HksLogLimiterTest002(void);
+int HksLogLimiterTest003(void);
+}
+#endif // HKS_LOG_LIMITER_TEST_H
@@ -0,0 +1,123 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hks_log_limiter_test.h"
+
+#include <gtest/gtest.h>
+
+#include "hks_log_limiter.h"
+
+using namespace testing::ext;
+namespace Unittest::HksFrameworkCommonLogLimiterTest {
+class HksLogLimiterTest : public testing::Test {
+public:
+    static void SetUpTestCase(void);
+
+    static void TearDownTestCase(void);
+
+    void SetUp();
+
+    void TearDown();
+};
+
+void HksLogLimiterTest::SetUpTestCase(void)
+{
+}
+
+void HksLogLimiterTest::TearDownTestCase(void)
+{
+}
+
+void HksLogLimiterTest::SetUp()
+{
+}
+
+void HksLogLimiterTest::TearDown()
+{
+}
+
+static const uint32_t TEST_BURST = 3;
+static const uint32_t TEST_INTERVAL_MS = 200;
+static const uint32_t TEST_START_MS = 5000;
+
+/* takes every token of limiter at nowMs, returns how many it had */
+static uint32_t DrainAt(struct HksLogLimiter *limiter, uint32_t nowMs)
+{
+    uint32_t count = 0;
+    uint32_t suppressedCount = 0;
+    while (count <= TEST_BURST && HksLogLimiterAcquireAt(limiter, TEST_BURST, TEST_INTERVAL_MS, nowMs,
+        &suppressedCount)) {
+        ++count;
+    }
+    return count;
+}
+
+/**
+ * @tc.name: HksLogLimiterTest.HksLogLimiterTest001
+ * @tc.desc: a full bucket logs a burst, then one line per interval with the count of the lines suppressed before it
+ * @tc.type: FUNC
+ */
+HWTEST_F(HksLogLimiterTest, HksLogLimiterTest001, TestSize.Level0)
+{
+    struct HksLogLimiter limiter = { 0, 0 };
+    EXPECT_EQ(DrainAt(&limiter, TEST_START_MS), TEST_BURST);
+
+    uint32_t suppressedCount = 0;
+    EXPECT_FALSE(HksLogLimiterAcquireAt(&limiter, TEST_BURST, TEST_INTERVAL_MS, TEST_START_MS + TEST_INTERVAL_MS - 1,
+        &suppressedCount));
+    EXPECT_TRUE(HksLogLimiterAcquireAt(&limiter, TEST_BURST, TEST_INTERVAL_MS, TEST_START_MS + TEST_INTERVAL_MS,
+        &suppressedCount));
+    EXPECT_EQ(suppressedCount, 2u);
+    EXPECT_FALSE(HksLogLimiterAcquireAt(&limiter, TEST_BURST, TEST_INTERVAL_MS, TEST_START_MS + TEST_INTERVAL_MS,
+        &suppressedCount));
+
+    EXPECT_EQ(DrainAt(&limiter, TEST_START_MS + TEST_INTERVAL_MS * 3), 2u);
+    EXPECT_EQ(DrainAt(&limiter, TEST_START_MS + TEST_INTERVAL_MS * 10), TEST_BURST);
+}
+
+/**
+ * @tc.name: HksLogLimiterTest.HksLogLimiterTest002
+ * @tc.desc: an exhausted bucket left idle for hours, past 2^23 and 2^24 ms, is full again
+ * @tc.type: FUNC
+ */
+HWTEST_F(HksLogLimiterTest, HksLogLimiterTest002, TestSize.Level0)
+{
+    const uint32_t idleTimesMs[] = { (1U << 23) + 1, 3 * 3600 * 1000, (1U << 24) + 1, (1U << 31) + 1 };
+    for (uint32_t idleMs : idleTimesMs) {
+        struct HksLogLimiter limiter = { 0, 0 };
+        EXPECT_EQ(DrainAt(&limiter, TEST_START_MS), TEST_BURST);
+        EXPECT_EQ(DrainAt(&limiter, TEST_START_MS + idleMs), TEST_BURST) << "idle " << idleMs << " ms";
+    }
+}
+
+/**
+ * @tc.name: HksLogLimiterTest.HksLogLimiterTest003
+ * @tc.desc: the bucket keeps its pace across the wrap of the ms clock, and a burst of 0 suppresses every line
+ * @tc.type: FUNC
+ */
+HWTEST_F(HksLogLimiterTest, HksLogLimiterTest003, TestSize.Level0)
+{
+    struct HksLogLimiter limiter = { 0, 0 };
+    uint32_t nowMs = UINT32_MAX - TEST_INTERVAL_MS;
+    EXPECT_EQ(DrainAt(&limiter, nowMs - TEST_START_MS), TEST_BURST);
+    EXPECT_EQ(DrainAt(&limiter, nowMs), TEST_BURST);
+    EXPECT_EQ(DrainAt(&limiter, nowMs + TEST_INTERVAL_MS / 2), 0u);
+    EXPECT_EQ(DrainAt(&limiter, nowMs + TEST_INTERVAL_MS * 2), 2u);
+
+    uint32_t suppressedCount = 0;
+    struct HksLogLimiter closedLimiter = { 0, 0 };
+    EXPECT_FALSE(HksLogLimiterAcquireAt(&closedLimiter, 0, TEST_INTERVAL_MS, TEST_START_MS, &suppressedCount));
+}
+}
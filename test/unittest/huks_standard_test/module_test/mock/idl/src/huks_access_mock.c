@@ -124,6 +124,12 @@ ENABLE_CFI(int32_t HuksAccessVerify(const struct HksBlob *key, const struct HksP
     return HksCoreVerify(key, paramSet, srcData, signature);
 }
 
+ENABLE_CFI(int32_t HuksAccessBatchVerify(const struct HksBlob *key, const struct HksParamSet *paramSet,
+    const struct HksBlob *srcData, const struct HksBlob *signature, uint32_t count, struct HksBlob *result))
+{
+    return HksCoreBatchVerify(key, paramSet, srcData, signature, count, result);
+}
+
 ENABLE_CFI(int32_t HuksAccessEncrypt(const struct HksBlob *key, const struct HksParamSet *paramSet,
     const struct HksBlob *plainText, struct HksBlob *cipherText))
 {
@@ -0,0 +1,51 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef TEE_CLIENT_API_H
+#define TEE_CLIENT_API_H
+
+#include "tee_client_type.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define TEEC_PARAM_TYPES(param0Type, param1Type, param2Type, param3Type) \
+    (((param3Type) << 12) | ((param2Type) << 8) | ((param1Type) << 4) | (param0Type))
+
+#define TEEC_PARAM_TYPE_GET(paramTypes, index) \
+    (((paramTypes) >> (4 * (index))) & 0x0F)
+
+TEEC_Result TEEC_InitializeContext(const char *name, TEEC_Context *context);
+
+void TEEC_FinalizeContext(TEEC_Context *context);
+
+TEEC_Result TEEC_OpenSession(TEEC_Context *context, TEEC_Session *session, const TEEC_UUID *destination,
+    uint32_t connectionMethod, const void *connectionData, TEEC_Operation *operation, uint32_t *returnOrigin);
+
+void TEEC_CloseSession(TEEC_Session *session);
+
+TEEC_Result TEEC_InvokeCommand(TEEC_Session *session, uint32_t commandID, TEEC_Operation *operation,
+    uint32_t *returnOrigin);
+
+TEEC_Result TEEC_RegisterSharedMemory(TEEC_Context *context, TEEC_SharedMemory *sharedMem);
+
+void TEEC_ReleaseSharedMemory(TEEC_SharedMemory *sharedMem);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
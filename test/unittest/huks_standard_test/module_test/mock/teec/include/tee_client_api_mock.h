@@ -0,0 +1,52 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef TEE_CLIENT_API_MOCK_H
+#define TEE_CLIENT_API_MOCK_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define TEEC_MOCK_OUTPUT_PATTERN 0xA5
+
+void TeecMockReset(void);
+
+/* every invoke sleeps this long, the TA handles sessions concurrently like a multi-session TA */
+void TeecMockSetInvokeDelayUs(uint32_t delayUs);
+
+/* the next invoke reports TEEC_ERROR_TARGET_DEAD and the session stays dead */
+void TeecMockKillNextSession(void);
+
+/* opening a session beyond this many open ones fails, like a TA limiting the sessions of a client */
+void TeecMockSetMaxSessionCount(uint32_t maxCount);
+
+uint32_t TeecMockGetOpenSessionCount(void);
+
+uint32_t TeecMockGetOpenSessionTotal(void);
+
+uint32_t TeecMockGetMaxConcurrentInvoke(void);
+
+uint32_t TeecMockGetRegisteredSharedMemCount(void);
+
+uint32_t TeecMockGetPartialMemrefInvokeCount(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
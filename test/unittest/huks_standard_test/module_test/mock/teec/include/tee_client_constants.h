@@ -0,0 +1,60 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef TEE_CLIENT_CONSTANTS_H
+#define TEE_CLIENT_CONSTANTS_H
+
+#define TEEC_PARAM_NUM 4
+
+enum TEEC_ReturnCode {
+    TEEC_SUCCESS = 0x0,
+    TEEC_ERROR_GENERIC = 0xFFFF0000,
+    TEEC_ERROR_BAD_PARAMETERS = 0xFFFF0006,
+    TEEC_ERROR_OUT_OF_MEMORY = 0xFFFF000C,
+    TEEC_ERROR_SHORT_BUFFER = 0xFFFF0010,
+    TEEC_ERROR_TARGET_DEAD = 0xFFFF3024,
+};
+
+enum TEEC_ParamType {
+    TEEC_NONE = 0x0,
+    TEEC_VALUE_INPUT = 0x01,
+    TEEC_VALUE_OUTPUT = 0x02,
+    TEEC_VALUE_INOUT = 0x03,
+    TEEC_MEMREF_TEMP_INPUT = 0x05,
+    TEEC_MEMREF_TEMP_OUTPUT = 0x06,
+    TEEC_MEMREF_TEMP_INOUT = 0x07,
+    TEEC_MEMREF_WHOLE = 0xc,
+    TEEC_MEMREF_PARTIAL_INPUT = 0xd,
+    TEEC_MEMREF_PARTIAL_OUTPUT = 0xe,
+    TEEC_MEMREF_PARTIAL_INOUT = 0xf,
+};
+
+enum TEEC_SharedMemCtl {
+    TEEC_MEM_INPUT = 0x1,
+    TEEC_MEM_OUTPUT = 0x2,
+    TEEC_MEM_INOUT = 0x3,
+};
+
+enum TEEC_LoginMethod {
+    TEEC_LOGIN_PUBLIC = 0x0,
+    TEEC_LOGIN_USER,
+    TEEC_LOGIN_GROUP,
+    TEEC_LOGIN_APPLICATION = 0x4,
+    TEEC_LOGIN_USER_APPLICATION = 0x5,
+    TEEC_LOGIN_GROUP_APPLICATION = 0x6,
+    TEEC_LOGIN_IDENTIFY = 0x7,
+};
+
+#endif
@@ -0,0 +1,25 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef TEE_CLIENT_ID_H
+#define TEE_CLIENT_ID_H
+
+#include "hks_cmd_id.h"
+
+/* vendor command ids that are not part of enum HksCmdId */
+#define HKS_CMD_ID_IMPORT_TRUST_CERT 0x00010020
+#define HCM_CMD_ID_IS_DEVICE_KEY_EXIST 0x00010021
+
+#endif
@@ -0,0 +1,95 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef TEE_CLIENT_TYPE_H
+#define TEE_CLIENT_TYPE_H
+
+/* minimal subset of the GP TEE client types, used to run the teec session pool off-device */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "tee_client_constants.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef uint32_t TEEC_Result;
+
+typedef struct {
+    uint32_t timeLow;
+    uint16_t timeMid;
+    uint16_t timeHiAndVersion;
+    uint8_t clockSeqAndNode[8];
+} TEEC_UUID;
+
+typedef struct {
+    int32_t fd;
+    uint8_t *ta_path;
+    uint32_t sessionCount;
+} TEEC_Context;
+
+typedef struct {
+    uint32_t sessionId;
+    uint32_t isDead;
+    TEEC_Context *context;
+} TEEC_Session;
+
+typedef struct {
+    void *buffer;
+    size_t size;
+    uint32_t flags;
+    uint32_t ops_cnt;
+    bool is_allocated;
+    TEEC_Context *context;
+} TEEC_SharedMemory;
+
+typedef struct {
+    void *buffer;
+    size_t size;
+} TEEC_TempMemoryReference;
+
+typedef struct {
+    TEEC_SharedMemory *parent;
+    size_t size;
+    size_t offset;
+} TEEC_RegisteredMemoryReference;
+
+typedef struct {
+    uint32_t a;
+    uint32_t b;
+} TEEC_Value;
+
+typedef union {
+    TEEC_TempMemoryReference tmpref;
+    TEEC_RegisteredMemoryReference memref;
+    TEEC_Value value;
+} TEEC_Parameter;
+
+typedef struct {
+    uint32_t started;
+    uint32_t paramTypes;
+    TEEC_Parameter params[TEEC_PARAM_NUM];
+    TEEC_Session *session;
+    bool cancel_flag;
+} TEEC_Operation;
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,234 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "tee_client_api.h"
+#include "tee_client_api_mock.h"
+
+#include <pthread.h>
+#include <unistd.h>
+
+#include "securec.h"
+
+static pthread_mutex_t g_mockLock = PTHREAD_MUTEX_INITIALIZER;
+static uint32_t g_invokeDelayUs = 0;
+static bool g_killNextSession = false;
+static uint32_t g_maxSessionCount = UINT32_MAX;
+static uint32_t g_openSessionCount = 0;
+static uint32_t g_openSessionTotal = 0;
+static uint32_t g_concurrentInvoke = 0;
+static uint32_t g_maxConcurrentInvoke = 0;
+static uint32_t g_registeredSharedMemCount = 0;
+static uint32_t g_partialMemrefInvokeCount = 0;
+
+void TeecMockReset(void)
+{
+    (void)pthread_mutex_lock(&g_mockLock);
+    g_invokeDelayUs = 0;
+    g_killNextSession = false;
+    g_maxSessionCount = UINT32_MAX;
+    g_openSessionTotal = 0;
+    g_maxConcurrentInvoke = 0;
+    g_partialMemrefInvokeCount = 0;
+    (void)pthread_mutex_unlock(&g_mockLock);
+}
+
+void TeecMockSetInvokeDelayUs(uint32_t delayUs)
+{
+    g_invokeDelayUs = delayUs;
+}
+
+void TeecMockKillNextSession(void)
+{
+    g_killNextSession = true;
+}
+
+void TeecMockSetMaxSessionCount(uint32_t maxCount)
+{
+    g_maxSessionCount = maxCount;
+}
+
+uint32_t TeecMockGetOpenSessionCount(void)
+{
+    return g_openSessionCount;
+}
+
+uint32_t TeecMockGetOpenSessionTotal(void)
+{
+    return g_openSessionTotal;
+}
+
+uint32_t TeecMockGetMaxConcurrentInvoke(void)
+{
+    return g_maxConcurrentInvoke;
+}
+
+uint32_t TeecMockGetRegisteredSharedMemCount(void)
+{
+    return g_registeredSharedMemCount;
+}
+
+uint32_t TeecMockGetPartialMemrefInvokeCount(void)
+{
+    return g_partialMemrefInvokeCount;
+}
+
+TEEC_Result TEEC_InitializeContext(const char *name, TEEC_Context *context)
+{
+    (void)name;
+    if (context == NULL) {
+        return TEEC_ERROR_BAD_PARAMETERS;
+    }
+    (void)memset_s(context, sizeof(TEEC_Context), 0, sizeof(TEEC_Context));
+    return TEEC_SUCCESS;
+}
+
+void TEEC_FinalizeContext(TEEC_Context *context)
+{
+    (void)context;
+}
+
+TEEC_Result TEEC_OpenSession(TEEC_Context *context, TEEC_Session *session, const TEEC_UUID *destination,
+    uint32_t connectionMethod, const void *connectionData, TEEC_Operation *operation, uint32_t *returnOrigin)
+{
+    (void)destination;
+    (void)connectionMethod;
+    (void)connectionData;
+    (void)operation;
+    (void)returnOrigin;
+    if (context == NULL || session == NULL) {
+        return TEEC_ERROR_BAD_PARAMETERS;
+    }
+
+    (void)pthread_mutex_lock(&g_mockLock);
+    if (g_openSessionCount >= g_maxSessionCount) {
+        (void)pthread_mutex_unlock(&g_mockLock);
+        return TEEC_ERROR_OUT_OF_MEMORY;
+    }
+    session->sessionId = ++g_openSessionTotal;
+    session->isDead = 0;
+    session->context = context;
+    ++g_openSessionCount;
+    (void)pthread_mutex_unlock(&g_mockLock);
+    return TEEC_SUCCESS;
+}
+
+void TEEC_CloseSession(TEEC_Session *session)
+{
+    if (session == NULL) {
+        return;
+    }
+    (void)pthread_mutex_lock(&g_mockLock);
+    --g_openSessionCount;
+    (void)pthread_mutex_unlock(&g_mockLock);
+}
+
+static bool IsOutputMemref(uint32_t type)
+{
+    return type == TEEC_MEMREF_TEMP_OUTPUT || type == TEEC_MEMREF_TEMP_INOUT ||
+        type == TEEC_MEMREF_PARTIAL_OUTPUT || type == TEEC_MEMREF_PARTIAL_INOUT;
+}
+
+static bool IsPartialMemref(uint32_t type)
+{
+    return type == TEEC_MEMREF_PARTIAL_INPUT || type == TEEC_MEMREF_PARTIAL_OUTPUT ||
+        type == TEEC_MEMREF_PARTIAL_INOUT;
+}
+
+/* the mock TA fills every output memref with a fixed pattern */
+static void FillOutputParams(TEEC_Operation *operation)
+{
+    bool isPartial = false;
+    for (uint32_t i = 0; i < TEEC_PARAM_NUM; ++i) {
+        uint32_t type = TEEC_PARAM_TYPE_GET(operation->paramTypes, i);
+        isPartial = isPartial || IsPartialMemref(type);
+        if (!IsOutputMemref(type)) {
+            continue;
+        }
+        if (IsPartialMemref(type)) {
+            TEEC_RegisteredMemoryReference *memref = &operation->params[i].memref;
+            uint8_t *buffer = (uint8_t *)memref->parent->buffer + memref->offset;
+            (void)memset_s(buffer, memref->size, TEEC_MOCK_OUTPUT_PATTERN, memref->size);
+        } else {
+            (void)memset_s(operation->params[i].tmpref.buffer, operation->params[i].tmpref.size,
+                TEEC_MOCK_OUTPUT_PATTERN, operation->params[i].tmpref.size);
+        }
+    }
+    if (isPartial) {
+        (void)pthread_mutex_lock(&g_mockLock);
+        ++g_partialMemrefInvokeCount;
+        (void)pthread_mutex_unlock(&g_mockLock);
+    }
+}
+
+TEEC_Result TEEC_InvokeCommand(TEEC_Session *session, uint32_t commandID, TEEC_Operation *operation,
+    uint32_t *returnOrigin)
+{
+    (void)commandID;
+    if (session == NULL || operation == NULL) {
+        return TEEC_ERROR_BAD_PARAMETERS;
+    }
+    if (returnOrigin != NULL) {
+        *returnOrigin = 0;
+    }
+
+    (void)pthread_mutex_lock(&g_mockLock);
+    if (g_killNextSession) {
+        g_killNextSession = false;
+        session->isDead = 1;
+    }
+    if (session->isDead != 0) {
+        (void)pthread_mutex_unlock(&g_mockLock);
+        return TEEC_ERROR_TARGET_DEAD;
+    }
+    ++g_concurrentInvoke;
+    if (g_concurrentInvoke > g_maxConcurrentInvoke) {
+        g_maxConcurrentInvoke = g_concurrentInvoke;
+    }
+    (void)pthread_mutex_unlock(&g_mockLock);
+
+    if (g_invokeDelayUs != 0) {
+        (void)usleep(g_invokeDelayUs);
+    }
+    FillOutputParams(operation);
+
+    (void)pthread_mutex_lock(&g_mockLock);
+    --g_concurrentInvoke;
+    (void)pthread_mutex_unlock(&g_mockLock);
+    return TEEC_SUCCESS;
+}
+
+TEEC_Result TEEC_RegisterSharedMemory(TEEC_Context *context, TEEC_SharedMemory *sharedMem)
+{
+    if (context == NULL || sharedMem == NULL || sharedMem->buffer == NULL) {
+        return TEEC_ERROR_BAD_PARAMETERS;
+    }
+    sharedMem->context = context;
+    sharedMem->is_allocated = false;
+    (void)pthread_mutex_lock(&g_mockLock);
+    ++g_registeredSharedMemCount;
+    (void)pthread_mutex_unlock(&g_mockLock);
+    return TEEC_SUCCESS;
+}
+
+void TEEC_ReleaseSharedMemory(TEEC_SharedMemory *sharedMem)
+{
+    if (sharedMem == NULL || sharedMem->context == NULL) {
+        return;
+    }
+    sharedMem->context = NULL;
+    (void)pthread_mutex_lock(&g_mockLock);
+    --g_registeredSharedMemCount;
+    (void)pthread_mutex_unlock(&g_mockLock);
+}
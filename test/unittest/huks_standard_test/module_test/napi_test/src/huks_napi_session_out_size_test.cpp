@@ -0,0 +1,157 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include "huks_napi_session_out_size.h"
+
+#include "hks_param.h"
+#include "hks_type.h"
+
+using namespace testing::ext;
+using namespace HuksNapiItem;
+namespace {
+constexpr uint32_t RESERVED_SIZE = HKS_MAX_KEY_LEN;
+constexpr uint32_t UNKNOWN_RESERVED_SIZE = 1024 * 64;
+constexpr uint32_t UPDATE_SIZE = 100;
+constexpr uint32_t FINISH_SIZE = 50;
+constexpr uint32_t TAG_SIZE = 16;
+
+class HuksNapiSessionOutSizeTest : public testing::Test {
+public:
+    static void SetUpTestCase(void) {};
+
+    static void TearDownTestCase(void) {};
+
+    void SetUp() {};
+
+    void TearDown() {};
+};
+
+struct TestSession {
+    uint64_t handleValue;
+    struct HksBlob handle;
+
+    explicit TestSession(uint64_t value) : handleValue(value)
+    {
+        handle = { sizeof(handleValue), reinterpret_cast<uint8_t *>(&handleValue) };
+    }
+};
+
+static void InitSession(const TestSession &session, uint32_t alg, uint32_t purpose, uint32_t mode)
+{
+    struct HksParam params[] = {
+        { .tag = HKS_TAG_ALGORITHM, .uint32Param = alg },
+        { .tag = HKS_TAG_PURPOSE, .uint32Param = purpose },
+        { .tag = HKS_TAG_BLOCK_MODE, .uint32Param = mode },
+    };
+    struct HksParamSet *paramSet = nullptr;
+    ASSERT_EQ(HksInitParamSet(&paramSet), HKS_SUCCESS);
+    ASSERT_EQ(HksAddParams(paramSet, params, sizeof(params) / sizeof(params[0])), HKS_SUCCESS);
+    ASSERT_EQ(HksBuildParamSet(&paramSet), HKS_SUCCESS);
+    HksNapiSessionOutSizeInit(&session.handle, paramSet);
+    HksFreeParamSet(&paramSet);
+}
+
+/**
+ * @tc.name: HuksNapiSessionOutSizeTest.HuksNapiSessionOutSizeTest001
+ * @tc.desc: the updates of a ccm session return nothing, so its finish reserves room for all their input
+ * @tc.type: FUNC
+ */
+HWTEST_F(HuksNapiSessionOutSizeTest, HuksNapiSessionOutSizeTest001, TestSize.Level0)
+{
+    TestSession session(0x1001);
+    InitSession(session, HKS_ALG_AES, HKS_KEY_PURPOSE_ENCRYPT, HKS_MODE_CCM);
+
+    EXPECT_EQ(HksNapiSessionOutSizeReserve(&session.handle, UPDATE_SIZE), UPDATE_SIZE + RESERVED_SIZE);
+    HksNapiSessionOutSizeComplete(&session.handle, 0, false);
+    EXPECT_EQ(HksNapiSessionOutSizeReserve(&session.handle, UPDATE_SIZE), UPDATE_SIZE * 2 + RESERVED_SIZE);
+    HksNapiSessionOutSizeComplete(&session.handle, 0, false);
+
+    EXPECT_EQ(HksNapiSessionOutSizeReserve(&session.handle, FINISH_SIZE),
+        UPDATE_SIZE * 2 + FINISH_SIZE + RESERVED_SIZE);
+    HksNapiSessionOutSizeComplete(&session.handle, UPDATE_SIZE * 2 + FINISH_SIZE + TAG_SIZE, true);
+
+    // the finished session is forgotten
+    EXPECT_EQ(HksNapiSessionOutSizeReserve(&session.handle, FINISH_SIZE), FINISH_SIZE + UNKNOWN_RESERVED_SIZE);
+}
+
+/**
+ * @tc.name: HuksNapiSessionOutSizeTest.HuksNapiSessionOutSizeTest002
+ * @tc.desc: an update of a cbc session returns its input, so every update and the finish only reserve their own
+ * @tc.type: FUNC
+ */
+HWTEST_F(HuksNapiSessionOutSizeTest, HuksNapiSessionOutSizeTest002, TestSize.Level0)
+{
+    TestSession session(0x1002);
+    InitSession(session, HKS_ALG_AES, HKS_KEY_PURPOSE_DECRYPT, HKS_MODE_CBC);
+
+    EXPECT_EQ(HksNapiSessionOutSizeReserve(&session.handle, UPDATE_SIZE), UPDATE_SIZE + RESERVED_SIZE);
+    HksNapiSessionOutSizeComplete(&session.handle, UPDATE_SIZE, false);
+    EXPECT_EQ(HksNapiSessionOutSizeReserve(&session.handle, UPDATE_SIZE), UPDATE_SIZE + RESERVED_SIZE);
+    HksNapiSessionOutSizeComplete(&session.handle, UPDATE_SIZE, false);
+
+    EXPECT_EQ(HksNapiSessionOutSizeReserve(&session.handle, FINISH_SIZE), FINISH_SIZE + RESERVED_SIZE);
+    HksNapiSessionOutSizeComplete(&session.handle, FINISH_SIZE, true);
+    EXPECT_EQ(HksNapiSessionOutSizeReserve(&session.handle, FINISH_SIZE), FINISH_SIZE + UNKNOWN_RESERVED_SIZE);
+}
+
+/**
+ * @tc.name: HuksNapiSessionOutSizeTest.HuksNapiSessionOutSizeTest003
+ * @tc.desc: sessions are told apart by their whole handle, and the abort or failed update of one keeps the other
+ * @tc.type: FUNC
+ */
+HWTEST_F(HuksNapiSessionOutSizeTest, HuksNapiSessionOutSizeTest003, TestSize.Level0)
+{
+    TestSession first(0x01001003);
+    TestSession second(0x02001003);
+    InitSession(first, HKS_ALG_RSA, HKS_KEY_PURPOSE_ENCRYPT, HKS_MODE_ECB);
+    InitSession(second, HKS_ALG_SM4, HKS_KEY_PURPOSE_ENCRYPT, HKS_MODE_CTR);
+
+    EXPECT_EQ(HksNapiSessionOutSizeReserve(&first.handle, UPDATE_SIZE), UPDATE_SIZE + RESERVED_SIZE);
+    HksNapiSessionOutSizeComplete(&first.handle, 0, false);
+    EXPECT_EQ(HksNapiSessionOutSizeReserve(&second.handle, UPDATE_SIZE), UPDATE_SIZE + RESERVED_SIZE);
+
+    // a failed update ends the second session only
+    HksNapiSessionOutSizeComplete(&second.handle, 0, true);
+    EXPECT_EQ(HksNapiSessionOutSizeReserve(&second.handle, UPDATE_SIZE), UPDATE_SIZE + UNKNOWN_RESERVED_SIZE);
+    EXPECT_EQ(HksNapiSessionOutSizeReserve(&first.handle, FINISH_SIZE), UPDATE_SIZE + FINISH_SIZE + RESERVED_SIZE);
+
+    // abort
+    HksNapiSessionOutSizeComplete(&first.handle, 0, true);
+    EXPECT_EQ(HksNapiSessionOutSizeReserve(&first.handle, FINISH_SIZE), FINISH_SIZE + UNKNOWN_RESERVED_SIZE);
+}
+
+/**
+ * @tc.name: HuksNapiSessionOutSizeTest.HuksNapiSessionOutSizeTest004
+ * @tc.desc: a session js cannot name again, or whose output is not bound by its input, keeps the 64KB reserve
+ * @tc.type: FUNC
+ */
+HWTEST_F(HuksNapiSessionOutSizeTest, HuksNapiSessionOutSizeTest004, TestSize.Level0)
+{
+    TestSession wideHandle(0x100001004);
+    InitSession(wideHandle, HKS_ALG_AES, HKS_KEY_PURPOSE_ENCRYPT, HKS_MODE_GCM);
+    EXPECT_EQ(HksNapiSessionOutSizeReserve(&wideHandle.handle, UPDATE_SIZE), UPDATE_SIZE + UNKNOWN_RESERVED_SIZE);
+
+    TestSession derive(0x1004);
+    InitSession(derive, HKS_ALG_HKDF, HKS_KEY_PURPOSE_DERIVE, HKS_MODE_ECB);
+    EXPECT_EQ(HksNapiSessionOutSizeReserve(&derive.handle, UPDATE_SIZE), UPDATE_SIZE + UNKNOWN_RESERVED_SIZE);
+
+    uint32_t shortHandleValue = 0x1004;
+    struct HksBlob shortHandle = { sizeof(shortHandleValue), reinterpret_cast<uint8_t *>(&shortHandleValue) };
+    EXPECT_EQ(HksNapiSessionOutSizeReserve(&shortHandle, UPDATE_SIZE), UPDATE_SIZE + UNKNOWN_RESERVED_SIZE);
+    EXPECT_EQ(HksNapiSessionOutSizeReserve(nullptr, UPDATE_SIZE), UPDATE_SIZE + UNKNOWN_RESERVED_SIZE);
+}
+}
@@ -23,5 +23,7 @@ int HksKeyNodeTest003(void);
 int HksKeyNodeTest004(void);
 int HksKeyNodeTest005(void);
 int HksKeyNodeTest006(void);
+int HksKeyNodeTest007(void);
+int HksKeyNodeTest008(void);
 }
 #endif
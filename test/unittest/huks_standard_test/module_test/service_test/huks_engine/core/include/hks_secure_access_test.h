@@ -31,5 +31,11 @@ int HksSecureAccessTest010(void);
 int HksSecureAccessTest011(void);
 int HksSecureAccessTest012(void);
 int HksSecureAccessTest013(void);
+int HksSecureAccessTest014(void);
+int HksSecureAccessTest015(void);
+int HksSecureAccessTest016(void);
+int HksSecureAccessTest017(void);
+int HksSecureAccessTest018(void);
+int HksSecureAccessTest019(void);
 }
 #endif
@@ -0,0 +1,166 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+#include "hks_cached_data.h"
+#include "hks_mem.h"
+#include "hks_type.h"
+#include "securec.h"
+
+using namespace testing::ext;
+namespace Unittest::HksCachedDataTest {
+namespace {
+constexpr uint32_t TEST_MAX_SIZE = 5 * 1024 * 1024;
+constexpr uint32_t BENCH_UPDATE_SIZE = 1024;
+constexpr uint32_t BENCH_UPDATE_COUNT = 64;
+constexpr uint32_t BENCH_ROUNDS = 200;
+
+/* the accumulation of cached data before: a new buffer of the old and the new size on every update */
+int32_t CopyOnUpdate(struct HksBlob *cached, const struct HksBlob *inData)
+{
+    uint32_t newSize = cached->size + inData->size;
+    uint8_t *newData = static_cast<uint8_t *>(HksMalloc(newSize));
+    if (newData == nullptr) {
+        return HKS_ERROR_MALLOC_FAIL;
+    }
+    if (cached->size != 0) {
+        (void)memcpy_s(newData, newSize, cached->data, cached->size);
+        (void)memset_s(cached->data, cached->size, 0, cached->size);
+    }
+    (void)memcpy_s(newData + cached->size, newSize - cached->size, inData->data, inData->size);
+    HKS_FREE(cached->data);
+    cached->data = newData;
+    cached->size = newSize;
+    return HKS_SUCCESS;
+}
+
+double Microseconds(std::chrono::steady_clock::duration cost)
+{
+    return std::chrono::duration<double, std::micro>(cost).count();
+}
+}  // namespace
+
+class HksCachedDataTest : public testing::Test {};
+
+/**
+ * @tc.name: HksCachedDataTest.HksCachedDataTest001
+ * @tc.desc: appended data is handed over in order, the buffer grows geometrically and not beyond the max size
+ * @tc.type: FUNC
+ */
+HWTEST_F(HksCachedDataTest, HksCachedDataTest001, TestSize.Level0)
+{
+    struct HksCachedData *cachedData = HksCreateCachedData();
+    ASSERT_NE(cachedData, nullptr);
+    std::vector<uint8_t> expected;
+    uint32_t growCount = 0;
+    for (uint32_t i = 0; i < BENCH_UPDATE_COUNT; ++i) {
+        std::vector<uint8_t> part(i + 1, static_cast<uint8_t>(i));
+        struct HksBlob inData = { static_cast<uint32_t>(part.size()), part.data() };
+        uint32_t capacity = cachedData->capacity;
+        ASSERT_EQ(HksAppendCachedData(cachedData, &inData, TEST_MAX_SIZE), HKS_SUCCESS);
+        growCount += (cachedData->capacity != capacity) ? 1 : 0;
+        expected.insert(expected.end(), part.begin(), part.end());
+    }
+    EXPECT_LT(growCount, BENCH_UPDATE_COUNT / 4);
+
+    struct HksBlob outData = { 0, nullptr };
+    HksTakeCachedData(cachedData, &outData);
+    ASSERT_EQ(outData.size, expected.size());
+    EXPECT_EQ(HksMemCmp(outData.data, expected.data(), outData.size), HKS_SUCCESS);
+    EXPECT_EQ(cachedData->blob.data, nullptr);
+    EXPECT_EQ(cachedData->blob.size, 0u);
+    HKS_FREE_BLOB(outData);
+
+    std::vector<uint8_t> large(BENCH_UPDATE_SIZE, 1);
+    struct HksBlob inData = { BENCH_UPDATE_SIZE, large.data() };
+    ASSERT_EQ(HksAppendCachedData(cachedData, &inData, BENCH_UPDATE_SIZE + 1), HKS_SUCCESS);
+    ASSERT_EQ(HksAppendCachedData(cachedData, &inData, BENCH_UPDATE_SIZE + 1), HKS_ERROR_INVALID_ARGUMENT);
+    EXPECT_EQ(cachedData->blob.size, BENCH_UPDATE_SIZE);
+    struct HksBlob one = { 1, large.data() };
+    ASSERT_EQ(HksAppendCachedData(cachedData, &one, BENCH_UPDATE_SIZE + 1), HKS_SUCCESS);
+    EXPECT_EQ(cachedData->capacity, BENCH_UPDATE_SIZE + 1);
+    HksFreeCachedData(&cachedData);
+    EXPECT_EQ(cachedData, nullptr);
+}
+
+/**
+ * @tc.name: HksCachedDataTest.HksCachedDataTest002
+ * @tc.desc: no data at all is refused as the empty buffer it would need, an empty append to cached data is not
+ * @tc.type: FUNC
+ */
+HWTEST_F(HksCachedDataTest, HksCachedDataTest002, TestSize.Level0)
+{
+    struct HksCachedData *cachedData = HksCreateCachedData();
+    ASSERT_NE(cachedData, nullptr);
+    struct HksBlob emptyData = { 0, nullptr };
+    EXPECT_EQ(HksAppendCachedData(cachedData, &emptyData, TEST_MAX_SIZE), HKS_ERROR_MALLOC_FAIL);
+
+    uint8_t data[] = { 1, 2, 3 };
+    struct HksBlob inData = { sizeof(data), data };
+    ASSERT_EQ(HksAppendCachedData(cachedData, &inData, TEST_MAX_SIZE), HKS_SUCCESS);
+    EXPECT_EQ(HksAppendCachedData(cachedData, &emptyData, TEST_MAX_SIZE), HKS_SUCCESS);
+    EXPECT_EQ(cachedData->blob.size, sizeof(data));
+    HksFreeCachedData(&cachedData);
+}
+
+/**
+ * @tc.name: HksCachedDataTest.HksCachedDataTest003
+ * @tc.desc: time 64 updates of 1 KB and the finish of cached data, against a new buffer on every update and a copy
+ *           at finish
+ * @tc.type: PERF
+ */
+HWTEST_F(HksCachedDataTest, HksCachedDataTest003, TestSize.Level1)
+{
+    std::vector<uint8_t> part(BENCH_UPDATE_SIZE, 1);
+    struct HksBlob inData = { BENCH_UPDATE_SIZE, part.data() };
+
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t round = 0; round < BENCH_ROUNDS; ++round) {
+        struct HksBlob cached = { 0, nullptr };
+        for (uint32_t i = 0; i < BENCH_UPDATE_COUNT; ++i) {
+            ASSERT_EQ(CopyOnUpdate(&cached, &inData), HKS_SUCCESS);
+        }
+        struct HksBlob outData = { 0, nullptr };
+        ASSERT_EQ(CopyOnUpdate(&outData, &cached), HKS_SUCCESS);
+        (void)memset_s(cached.data, cached.size, 0, cached.size);
+        HKS_FREE_BLOB(cached);
+        HKS_FREE_BLOB(outData);
+    }
+    double copyCost = Microseconds(std::chrono::steady_clock::now() - start) / BENCH_ROUNDS;
+
+    start = std::chrono::steady_clock::now();
+    for (uint32_t round = 0; round < BENCH_ROUNDS; ++round) {
+        struct HksCachedData *cachedData = HksCreateCachedData();
+        ASSERT_NE(cachedData, nullptr);
+        for (uint32_t i = 0; i < BENCH_UPDATE_COUNT; ++i) {
+            ASSERT_EQ(HksAppendCachedData(cachedData, &inData, TEST_MAX_SIZE), HKS_SUCCESS);
+        }
+        struct HksBlob outData = { 0, nullptr };
+        HksTakeCachedData(cachedData, &outData);
+        HksFreeCachedData(&cachedData);
+        ASSERT_EQ(outData.size, BENCH_UPDATE_SIZE * BENCH_UPDATE_COUNT);
+        HKS_FREE_BLOB(outData);
+    }
+    double growCost = Microseconds(std::chrono::steady_clock::now() - start) / BENCH_ROUNDS;
+
+    std::cout << BENCH_UPDATE_COUNT << " updates of " << BENCH_UPDATE_SIZE << " bytes and finish: new buffer per " <<
+        "update " << copyCost << " us, growing buffer " << growCost << " us" << std::endl;
+}
+}
@@ -16,7 +16,10 @@
 #include "hks_keynode_test.h"
 
 #include <gtest/gtest.h>
+#include <chrono>
+#include <iostream>
 #include <string>
+#include <vector>
 
 #include "base/security/huks/services/huks_standard/huks_engine/main/core/src/hks_keynode.c"
 #include "file_ex.h"
@@ -62,6 +65,97 @@ static const struct HksParam g_params[] = {
     },
 };
 
+static const uint32_t MIN_CHUNK_SIZE = 16;
+static const uint32_t MAX_CHUNK_SIZE = 256;
+static const uint32_t CHUNK_SIZE_STEP = 4;
+static const uint32_t UPDATE_ROUNDS = 200000;
+static const uint32_t KEY_NODE_ROUNDS = 200000;
+static const uint32_t TEST_TAG = 0x5e55104;
+static uint8_t g_nonce[] = "hks_keynode_nonce";
+static uint8_t g_aad[] = "hks_keynode_aad";
+static uint8_t g_processName[] = "hks_keynode_test";
+
+/* the params an aes update ran on, as the caller's paramset is copied into the runtime paramset */
+static int32_t BuildRuntimeParamSetForTest(struct HksParamSet **paramSet)
+{
+    const struct HksParam params[] = {
+        { .tag = HKS_TAG_KEY_SIZE, .uint32Param = HKS_AES_KEY_SIZE_256 },
+        { .tag = HKS_TAG_PROCESS_NAME, .blob = { sizeof(g_processName), g_processName } },
+        { .tag = HKS_TAG_ACCESS_TOKEN_ID, .uint64Param = 0 },
+        { .tag = HKS_TAG_USER_ID, .uint32Param = 0 },
+        { .tag = HKS_TAG_IS_BATCH_OPERATION, .boolParam = false },
+        { .tag = HKS_TAG_NONCE, .blob = { sizeof(g_nonce), g_nonce } },
+        { .tag = HKS_TAG_ASSOCIATED_DATA, .blob = { sizeof(g_aad), g_aad } },
+        { .tag = HKS_TAG_PADDING, .uint32Param = HKS_PADDING_NONE },
+        { .tag = HKS_TAG_BLOCK_MODE, .uint32Param = HKS_MODE_CBC },
+        { .tag = HKS_TAG_PURPOSE, .uint32Param = HKS_KEY_PURPOSE_ENCRYPT },
+        { .tag = HKS_TAG_ALGORITHM, .uint32Param = HKS_ALG_AES },
+        { .tag = HKS_TAG_CRYPTO_CTX, .uint64Param = 0 },
+    };
+    int32_t ret = HksInitParamSet(paramSet);
+    HKS_IF_NOT_SUCC_RETURN(ret, ret)
+    ret = HksAddParams(*paramSet, params, sizeof(params) / sizeof(params[0]));
+    if (ret == HKS_SUCCESS) {
+        ret = HksBuildParamSet(paramSet);
+    }
+    if (ret != HKS_SUCCESS) {
+        HksFreeParamSet(paramSet);
+    }
+    return ret;
+}
+
+/* the lookups of a cipher update: purpose and algorithm to dispatch, ctx, and block mode and purpose again */
+static uint64_t LookupByParamSet(const struct HksParamSet *paramSet)
+{
+    const HksTag tags[] = { HKS_TAG_PURPOSE, HKS_TAG_ALGORITHM, HKS_TAG_CRYPTO_CTX, HKS_TAG_BLOCK_MODE,
+        HKS_TAG_PURPOSE };
+    uint64_t sum = 0;
+    for (uint32_t i = 0; i < sizeof(tags) / sizeof(tags[0]); ++i) {
+        struct HksParam *param = nullptr;
+        if (HksGetParam(paramSet, tags[i], &param) == HKS_SUCCESS) {
+            sum += param->uint32Param;
+        }
+    }
+    return sum;
+}
+
+static uint64_t LookupBySession(const struct HksKeyNodeSession *volatile session)
+{
+    return session->purpose + session->alg + reinterpret_cast<uintptr_t>(session->ctx) + session->mode +
+        session->purpose;
+}
+
+/* a key node of an aes session, added as HksCreateKeyNode does once the key blob is decrypted */
+static struct HuksKeyNode *AddKeyNodeForTest(uint32_t tag)
+{
+    struct HuksKeyNode keyNode = {};
+    if (BuildRuntimeParamSetForTest(&keyNode.runtimeParamSet) != HKS_SUCCESS) {
+        return nullptr;
+    }
+    InitKeyNodeSession(keyNode.runtimeParamSet, keyNode.keyBlobParamSet, &keyNode.session);
+    struct HuksKeyNode *newKeyNode = AddKeyNode(&keyNode, tag);
+    if (newKeyNode == nullptr) {
+        HksFreeParamSet(&keyNode.runtimeParamSet);
+    }
+    return newKeyNode;
+}
+
+static bool IsInKeyNodeSlots(const struct HuksKeyNode *keyNode)
+{
+    for (uint32_t i = 0; i < MAX_KEY_NODES_COUNT; ++i) {
+        if (keyNode == &g_keyNodeSlots[i].keyNode) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static double ElapsedUsPerRound(std::chrono::steady_clock::time_point start)
+{
+    return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count() /
+        UPDATE_ROUNDS;
+}
+
 /**
  * @tc.name: HksKeyNodeTest.HksKeyNodeTest001
  * @tc.desc: tdd HksCreateKeyNode, expect keyNode == NULL
@@ -108,19 +202,15 @@ HWTEST_F(HksKeyNodeTest, HksKeyNodeTest003, TestSize.Level0)
         .data = reinterpret_cast<uint8_t *>(HksMalloc(sizeof(HksBlob))),
     };
 
-    FreeParamsForBuildKeyNode(&blob, nullptr, nullptr, nullptr);
+    FreeParamsForBuildKeyNode(&blob, nullptr, nullptr);
 
     struct HksParamSet *runtimeParamSet = reinterpret_cast<HksParamSet *>(HksMalloc(sizeof(HksParamSet)));
     ASSERT_EQ(runtimeParamSet == nullptr, false) << "runtimeParamSet malloc failed.";
-    FreeParamsForBuildKeyNode(&blob, &runtimeParamSet, nullptr, nullptr);
+    FreeParamsForBuildKeyNode(&blob, &runtimeParamSet, nullptr);
 
     struct HksParamSet *keyBlobParamSet = reinterpret_cast<HksParamSet *>(HksMalloc(sizeof(HksParamSet)));
     ASSERT_EQ(keyBlobParamSet == nullptr, false) << "keyBlobParamSet malloc failed.";
-    FreeParamsForBuildKeyNode(&blob, &runtimeParamSet, &keyBlobParamSet, nullptr);
-
-    struct HuksKeyNode *keyNode = reinterpret_cast<HuksKeyNode *>(HksMalloc(sizeof(HuksKeyNode)));
-    ASSERT_EQ(keyNode == nullptr, false) << "keyNode malloc failed.";
-    FreeParamsForBuildKeyNode(&blob, &runtimeParamSet, &keyBlobParamSet, keyNode);
+    FreeParamsForBuildKeyNode(&blob, &runtimeParamSet, &keyBlobParamSet);
 }
 
 /**
@@ -177,4 +267,246 @@ HWTEST_F(HksKeyNodeTest, HksKeyNodeTest006, TestSize.Level0)
     FreeRuntimeParamSet(&paramSetTwo);
 }
 
-}
\ No newline at end of file
+/**
+ * @tc.name: HksKeyNodeTest.HksKeyNodeTest007
+ * @tc.desc: tdd InitKeyNodeSession, the operation params and the key size are parsed once into the session
+ * @tc.type: FUNC
+ */
+HWTEST_F(HksKeyNodeTest, HksKeyNodeTest007, TestSize.Level0)
+{
+    HKS_LOG_I("enter HksKeyNodeTest007");
+    struct HksParamSet *paramSet = nullptr;
+    ASSERT_EQ(BuildRuntimeParamSetForTest(&paramSet), HKS_SUCCESS);
+
+    struct HksKeyNodeSession session = {};
+    InitKeyNodeSession(paramSet, paramSet, &session);
+    EXPECT_EQ(session.ctx == nullptr, true);
+    EXPECT_EQ(session.purpose, static_cast<uint32_t>(HKS_KEY_PURPOSE_ENCRYPT));
+    EXPECT_EQ(session.alg, static_cast<uint32_t>(HKS_ALG_AES));
+    EXPECT_EQ(session.hasMode && session.mode == HKS_MODE_CBC, true);
+    EXPECT_EQ(session.hasPadding && session.padding == HKS_PADDING_NONE, true);
+    EXPECT_EQ(session.hasDigest, false);
+    EXPECT_EQ(session.hasKeySize && session.keySize == HKS_AES_KEY_SIZE_256, true);
+    EXPECT_EQ(session.isUserAuthAccess, false);
+    HksFreeParamSet(&paramSet);
+}
+
+/**
+ * @tc.name: HksKeyNodeTest.HksKeyNodeTest008
+ * @tc.desc: per update cost of getting the ctx and the operation params, by paramset lookups and from the session,
+ *           next to a copy of a 16 to 256 bytes chunk
+ * @tc.type: PERF
+ */
+HWTEST_F(HksKeyNodeTest, HksKeyNodeTest008, TestSize.Level1)
+{
+    HKS_LOG_I("enter HksKeyNodeTest008");
+    struct HksParamSet *paramSet = nullptr;
+    ASSERT_EQ(BuildRuntimeParamSetForTest(&paramSet), HKS_SUCCESS);
+    struct HksKeyNodeSession session = {};
+    InitKeyNodeSession(paramSet, paramSet, &session);
+
+    uint8_t chunk[MAX_CHUNK_SIZE] = { 0 };
+    uint8_t out[MAX_CHUNK_SIZE] = { 0 };
+    for (uint32_t chunkSize = MIN_CHUNK_SIZE; chunkSize <= MAX_CHUNK_SIZE; chunkSize *= CHUNK_SIZE_STEP) {
+        uint64_t sink = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (uint32_t i = 0; i < UPDATE_ROUNDS; ++i) {
+            sink += LookupByParamSet(paramSet);
+            (void)memcpy_s(out, sizeof(out), chunk, chunkSize);
+            sink += out[i % chunkSize];
+        }
+        double lookupCost = ElapsedUsPerRound(start);
+
+        start = std::chrono::steady_clock::now();
+        for (uint32_t i = 0; i < UPDATE_ROUNDS; ++i) {
+            sink += LookupBySession(&session);
+            (void)memcpy_s(out, sizeof(out), chunk, chunkSize);
+            sink += out[i % chunkSize];
+        }
+        double sessionCost = ElapsedUsPerRound(start);
+
+        std::cout << chunkSize << " bytes per update: paramset lookups " << lookupCost << " us, session " <<
+            sessionCost << " us (" << sink << ")" << std::endl;
+        EXPECT_LE(sessionCost, lookupCost);
+    }
+    HksFreeParamSet(&paramSet);
+}
+
+/**
+ * @tc.name: HksKeyNodeTest.HksKeyNodeTest009
+ * @tc.desc: a deleted key node is zeroized and its slot is taken again under a new handle, the stale handle finds
+ *           nothing
+ * @tc.type: FUNC
+ */
+HWTEST_F(HksKeyNodeTest, HksKeyNodeTest009, TestSize.Level0)
+{
+    HKS_LOG_I("enter HksKeyNodeTest009");
+    struct HuksKeyNode *keyNode = AddKeyNodeForTest(TEST_TAG);
+    ASSERT_NE(keyNode, nullptr);
+    EXPECT_TRUE(IsInKeyNodeSlots(keyNode));
+    uint64_t handle = keyNode->handle;
+    EXPECT_NE(handle, static_cast<uint64_t>(HKS_KEYNODE_HANDLE_INVALID_VALUE));
+    EXPECT_EQ(HksQueryKeyNode(handle), keyNode);
+    EXPECT_EQ(keyNode->session.alg, static_cast<uint32_t>(HKS_ALG_AES));
+
+    HksDeleteKeyNode(handle);
+    EXPECT_EQ(HksQueryKeyNode(handle), nullptr);
+    EXPECT_EQ(keyNode->handle, 0u);
+    EXPECT_EQ(keyNode->runtimeParamSet, nullptr);
+
+    struct HuksKeyNode *newKeyNode = AddKeyNodeForTest(TEST_TAG);
+    ASSERT_EQ(newKeyNode, keyNode);
+    EXPECT_NE(newKeyNode->handle, handle);
+    EXPECT_EQ(HksQueryKeyNode(handle), nullptr);
+    HksDeleteKeyNode(handle);
+    EXPECT_EQ(HksQueryKeyNode(newKeyNode->handle), newKeyNode);
+    HksDeleteKeyNode(newKeyNode->handle);
+    EXPECT_EQ(g_keyNodeCount, 0u);
+}
+
+/**
+ * @tc.name: HksKeyNodeTest.HksKeyNodeTest010
+ * @tc.desc: a handle with another tag, generation or slot index, or beyond 32 bits, finds nothing
+ * @tc.type: FUNC
+ */
+HWTEST_F(HksKeyNodeTest, HksKeyNodeTest010, TestSize.Level0)
+{
+    HKS_LOG_I("enter HksKeyNodeTest010");
+    struct HuksKeyNode *keyNode = AddKeyNodeForTest(TEST_TAG);
+    ASSERT_NE(keyNode, nullptr);
+    uint64_t handle = keyNode->handle;
+    const uint64_t forgedHandles[] = { handle ^ (1ULL << KEY_NODE_SLOT_BITS), handle ^ (1ULL << 31), handle ^ 1ULL,
+        handle | KEY_NODE_SLOT_MASK, handle | (1ULL << 32), HKS_KEYNODE_HANDLE_INVALID_VALUE };
+    for (uint64_t forgedHandle : forgedHandles) {
+        EXPECT_EQ(HksQueryKeyNode(forgedHandle), nullptr);
+        HksDeleteKeyNode(forgedHandle);
+    }
+    EXPECT_EQ(HksQueryKeyNode(handle), keyNode);
+    HksDeleteKeyNode(handle);
+    EXPECT_EQ(g_keyNodeCount, 0u);
+}
+
+/**
+ * @tc.name: HksKeyNodeTest.HksKeyNodeTest011
+ * @tc.desc: a key node added over the limit evicts the oldest one into the slot it frees
+ * @tc.type: FUNC
+ */
+HWTEST_F(HksKeyNodeTest, HksKeyNodeTest011, TestSize.Level0)
+{
+    HKS_LOG_I("enter HksKeyNodeTest011");
+    uint64_t handles[MAX_KEY_NODES_EACH_TOKEN_ID] = { 0 };
+    for (uint32_t i = 0; i < MAX_KEY_NODES_EACH_TOKEN_ID; ++i) {
+        struct HuksKeyNode *keyNode = AddKeyNodeForTest(TEST_TAG + i);
+        ASSERT_NE(keyNode, nullptr);
+        handles[i] = keyNode->handle;
+    }
+    struct HuksKeyNode *oldestKeyNode = HksQueryKeyNode(handles[0]);
+    struct HuksKeyNode *keyNode = AddKeyNodeForTest(TEST_TAG);
+    ASSERT_NE(keyNode, nullptr);
+    EXPECT_EQ(keyNode, oldestKeyNode);
+    EXPECT_EQ(HksQueryKeyNode(handles[0]), nullptr);
+    for (uint32_t i = 1; i < MAX_KEY_NODES_EACH_TOKEN_ID; ++i) {
+        EXPECT_NE(HksQueryKeyNode(handles[i]), nullptr);
+        HksDeleteKeyNode(handles[i]);
+    }
+    HksDeleteKeyNode(keyNode->handle);
+    EXPECT_EQ(g_keyNodeCount, 0u);
+}
+
+/**
+ * @tc.name: HksKeyNodeTest.HksKeyNodeTest012
+ * @tc.desc: cost of a lookup among a full table of key nodes, and of an add and delete of a key node
+ * @tc.type: PERF
+ */
+HWTEST_F(HksKeyNodeTest, HksKeyNodeTest012, TestSize.Level1)
+{
+    HKS_LOG_I("enter HksKeyNodeTest012");
+    uint64_t handles[MAX_KEY_NODES_EACH_TOKEN_ID] = { 0 };
+    for (uint32_t i = 0; i < MAX_KEY_NODES_EACH_TOKEN_ID - 1; ++i) {
+        struct HuksKeyNode *keyNode = AddKeyNodeForTest(TEST_TAG + i);
+        ASSERT_NE(keyNode, nullptr);
+        handles[i] = keyNode->handle;
+    }
+    uint32_t failCount = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < KEY_NODE_ROUNDS; ++i) {
+        failCount += (HksQueryKeyNode(handles[i % (MAX_KEY_NODES_EACH_TOKEN_ID - 1)]) == nullptr) ? 1 : 0;
+    }
+    double queryCost = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+    struct HuksKeyNode keyNode = {};
+    ASSERT_EQ(BuildRuntimeParamSetForTest(&keyNode.runtimeParamSet), HKS_SUCCESS);
+    start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < KEY_NODE_ROUNDS; ++i) {
+        struct HuksKeyNode *newKeyNode = AddKeyNode(&keyNode, TEST_TAG);
+        if (newKeyNode == nullptr) {
+            ++failCount;
+            continue;
+        }
+        /* the runtime paramset is kept for the next round */
+        newKeyNode->runtimeParamSet = nullptr;
+        HksDeleteKeyNode(newKeyNode->handle);
+    }
+    double addCost = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+    HksFreeParamSet(&keyNode.runtimeParamSet);
+
+    std::cout << "key node lookup " << queryCost / KEY_NODE_ROUNDS << " ns, add and delete " <<
+        addCost / KEY_NODE_ROUNDS << " ns" << std::endl;
+    EXPECT_EQ(failCount, 0u);
+    for (uint32_t i = 0; i < MAX_KEY_NODES_EACH_TOKEN_ID - 1; ++i) {
+        HksDeleteKeyNode(handles[i]);
+    }
+    EXPECT_EQ(g_keyNodeCount, 0u);
+}
+
+/**
+ * @tc.name: HksKeyNodeTest.HksKeyNodeTest013
+ * @tc.desc: a handle kept in a uint32, as the js api does, and widened back finds its key node
+ * @tc.type: FUNC
+ */
+HWTEST_F(HksKeyNodeTest, HksKeyNodeTest013, TestSize.Level0)
+{
+    HKS_LOG_I("enter HksKeyNodeTest013");
+    struct HuksKeyNode *keyNode = AddKeyNodeForTest(TEST_TAG);
+    ASSERT_NE(keyNode, nullptr);
+    uint32_t jsHandle = static_cast<uint32_t>(keyNode->handle);
+    uint64_t handle = jsHandle;
+    EXPECT_EQ(handle, keyNode->handle);
+    EXPECT_EQ(HksQueryKeyNode(handle), keyNode);
+    HksDeleteKeyNode(handle);
+    EXPECT_EQ(HksQueryKeyNode(handle), nullptr);
+    EXPECT_EQ(g_keyNodeCount, 0u);
+}
+
+/**
+ * @tc.name: HksKeyNodeTest.HksKeyNodeTest014
+ * @tc.desc: the key nodes a slot holds one after another, even with the same tag, get handles of distinct
+ *           generations, and none of the former handles finds the current key node
+ * @tc.type: FUNC
+ */
+HWTEST_F(HksKeyNodeTest, HksKeyNodeTest014, TestSize.Level0)
+{
+    HKS_LOG_I("enter HksKeyNodeTest014");
+    std::vector<uint64_t> handles;
+    struct HuksKeyNode *keyNode = nullptr;
+    for (uint32_t i = 0; i < KEY_NODE_GENERATION_MASK; ++i) {
+        if (keyNode != nullptr) {
+            HksDeleteKeyNode(keyNode->handle);
+        }
+        struct HuksKeyNode *newKeyNode = AddKeyNodeForTest(TEST_TAG);
+        ASSERT_NE(newKeyNode, nullptr);
+        ASSERT_TRUE(keyNode == nullptr || newKeyNode == keyNode);
+        keyNode = newKeyNode;
+        handles.push_back(keyNode->handle);
+    }
+    uint64_t handle = handles.back();
+    handles.pop_back();
+    for (uint64_t formerHandle : handles) {
+        EXPECT_NE(formerHandle, handle);
+        EXPECT_EQ(HksQueryKeyNode(formerHandle), nullptr);
+    }
+    EXPECT_EQ(HksQueryKeyNode(handle), keyNode);
+    HksDeleteKeyNode(handle);
+    EXPECT_EQ(g_keyNodeCount, 0u);
+}
+}
@@ -392,4 +392,237 @@ HWTEST_F(HksSecureAccessTest, HksSecureAccessTest013, TestSize.Level0)
     EXPECT_EQ(ret, HKS_ERROR_PARAM_NOT_EXIST);
     HksFreeParamSet(&paramSet);
 }
+
+static void BuildTestAuthToken(struct HksUserAuthToken *authToken, int32_t userId, uint32_t authType, uint8_t seed)
+{
+    (void)memset_s(authToken, sizeof(struct HksUserAuthToken), seed, sizeof(struct HksUserAuthToken));
+    authToken->ciphertextData.userId = userId;
+    authToken->plaintextData.authType = authType;
+    authToken->plaintextData.tokenType = 0;
+}
+
+static void InsertTestAuthToken(const struct HksUserAuthToken *authToken, uint8_t *digest, uint64_t curTime)
+{
+    struct HksBlob tokenBlob = { sizeof(struct HksUserAuthToken), (uint8_t *)authToken };
+    uint64_t now = 0;
+    ASSERT_TRUE(GetAuthTokenCacheKey(&tokenBlob, digest, &now));
+    InsertAuthTokenCache(digest, curTime, authToken);
+}
+
+/**
+ * @tc.name: HksSecureAccessTest.HksSecureAccessTest014
+ * @tc.desc: tdd auth token cache, cached token is returned only for the same token bytes
+ * @tc.type: FUNC
+ */
+HWTEST_F(HksSecureAccessTest, HksSecureAccessTest014, TestSize.Level0)
+{
+    HKS_LOG_I("enter HksSecureAccessTest014");
+    HksCoreSecureAccessClearAuthTokenCache();
+    struct HksUserAuthToken tokenA;
+    BuildTestAuthToken(&tokenA, 100, 1, 0xA);
+    uint8_t digestA[HKS_DIGEST_SHA256_LEN] = {0};
+    InsertTestAuthToken(&tokenA, digestA, 1000);
+
+    struct HksUserAuthToken tokenB;
+    BuildTestAuthToken(&tokenB, 100, 1, 0xB);
+    uint8_t digestB[HKS_DIGEST_SHA256_LEN] = {0};
+    struct HksBlob tokenBlobB = { sizeof(struct HksUserAuthToken), (uint8_t *)&tokenB };
+    uint64_t now = 0;
+    ASSERT_TRUE(GetAuthTokenCacheKey(&tokenBlobB, digestB, &now));
+
+    struct HksUserAuthToken outToken;
+    EXPECT_TRUE(LookupAuthTokenCache(digestA, 1000, &outToken));
+    EXPECT_EQ(HksMemCmp(&outToken, &tokenA, sizeof(struct HksUserAuthToken)), 0);
+    EXPECT_FALSE(LookupAuthTokenCache(digestB, 1000, &outToken));
+
+    struct HksBlob wrongSizeBlob = { sizeof(struct HksUserAuthToken) - 1, (uint8_t *)&tokenA };
+    EXPECT_FALSE(GetAuthTokenCacheKey(&wrongSizeBlob, digestB, &now));
+    HksCoreSecureAccessClearAuthTokenCache();
+}
+
+/**
+ * @tc.name: HksSecureAccessTest.HksSecureAccessTest015
+ * @tc.desc: tdd auth token cache, expired token and cleared cache are not hit
+ * @tc.type: FUNC
+ */
+HWTEST_F(HksSecureAccessTest, HksSecureAccessTest015, TestSize.Level0)
+{
+    HKS_LOG_I("enter HksSecureAccessTest015");
+    HksCoreSecureAccessClearAuthTokenCache();
+    struct HksUserAuthToken token;
+    BuildTestAuthToken(&token, 100, 1, 0xC);
+    uint8_t digest[HKS_DIGEST_SHA256_LEN] = {0};
+    InsertTestAuthToken(&token, digest, 1000);
+
+    struct HksUserAuthToken outToken;
+    EXPECT_TRUE(LookupAuthTokenCache(digest, 1000 + HKS_AUTH_TOKEN_CACHE_TTL_MS, &outToken));
+    EXPECT_FALSE(LookupAuthTokenCache(digest, 1000 + HKS_AUTH_TOKEN_CACHE_TTL_MS + 1, &outToken));
+    EXPECT_FALSE(LookupAuthTokenCache(digest, 1000, &outToken));
+
+    InsertTestAuthToken(&token, digest, 1000);
+    HksCoreSecureAccessClearAuthTokenCache();
+    EXPECT_FALSE(LookupAuthTokenCache(digest, 1000, &outToken));
+}
+
+/**
+ * @tc.name: HksSecureAccessTest.HksSecureAccessTest016
+ * @tc.desc: tdd auth token cache, token of another user or auth type invalidates the cache
+ * @tc.type: FUNC
+ */
+HWTEST_F(HksSecureAccessTest, HksSecureAccessTest016, TestSize.Level0)
+{
+    HKS_LOG_I("enter HksSecureAccessTest016");
+    HksCoreSecureAccessClearAuthTokenCache();
+    struct HksUserAuthToken tokenA;
+    BuildTestAuthToken(&tokenA, 100, 1, 0xD);
+    uint8_t digestA[HKS_DIGEST_SHA256_LEN] = {0};
+    InsertTestAuthToken(&tokenA, digestA, 1000);
+
+    struct HksUserAuthToken tokenB;
+    BuildTestAuthToken(&tokenB, 101, 1, 0xD);
+    uint8_t digestB[HKS_DIGEST_SHA256_LEN] = {0};
+    InsertTestAuthToken(&tokenB, digestB, 1000);
+
+    struct HksUserAuthToken outToken;
+    EXPECT_FALSE(LookupAuthTokenCache(digestA, 1000, &outToken));
+    EXPECT_TRUE(LookupAuthTokenCache(digestB, 1000, &outToken));
+
+    struct HksUserAuthToken tokenC;
+    BuildTestAuthToken(&tokenC, 101, 2, 0xD);
+    uint8_t digestC[HKS_DIGEST_SHA256_LEN] = {0};
+    InsertTestAuthToken(&tokenC, digestC, 1000);
+
+    EXPECT_FALSE(LookupAuthTokenCache(digestB, 1000, &outToken));
+    EXPECT_TRUE(LookupAuthTokenCache(digestC, 1000, &outToken));
+    HksCoreSecureAccessClearAuthTokenCache();
+}
+
+/**
+ * @tc.name: HksSecureAccessTest.HksSecureAccessTest017
+ * @tc.desc: tdd auth token cache, the oldest token is evicted when the cache is full
+ * @tc.type: FUNC
+ */
+HWTEST_F(HksSecureAccessTest, HksSecureAccessTest017, TestSize.Level0)
+{
+    HKS_LOG_I("enter HksSecureAccessTest017");
+    HksCoreSecureAccessClearAuthTokenCache();
+    uint8_t digests[HKS_AUTH_TOKEN_CACHE_SIZE + 1][HKS_DIGEST_SHA256_LEN] = {{0}};
+    for (uint32_t i = 0; i <= HKS_AUTH_TOKEN_CACHE_SIZE; ++i) {
+        struct HksUserAuthToken token;
+        BuildTestAuthToken(&token, 100, 1, (uint8_t)i);
+        InsertTestAuthToken(&token, digests[i], 1000 + i);
+    }
+
+    struct HksUserAuthToken outToken;
+    EXPECT_FALSE(LookupAuthTokenCache(digests[0], 1000 + HKS_AUTH_TOKEN_CACHE_SIZE, &outToken));
+    for (uint32_t i = 1; i <= HKS_AUTH_TOKEN_CACHE_SIZE; ++i) {
+        EXPECT_TRUE(LookupAuthTokenCache(digests[i], 1000 + HKS_AUTH_TOKEN_CACHE_SIZE, &outToken));
+    }
+    HksCoreSecureAccessClearAuthTokenCache();
+}
+
+static int32_t BuildUserAuthKeyNode(struct HuksKeyNode *keyNode, uint32_t authMode)
+{
+    struct HksParam blobParams[] = {
+        { .tag = HKS_TAG_USER_AUTH_TYPE, .uint32Param = HKS_USER_AUTH_TYPE_FINGERPRINT },
+        { .tag = HKS_TAG_USER_AUTH_MODE, .uint32Param = authMode },
+    };
+    int32_t ret = BuildParamSetWithParam(&keyNode->keyBlobParamSet, blobParams, HKS_ARRAY_SIZE(blobParams), false);
+    HKS_IF_NOT_SUCC_RETURN(ret, ret)
+
+    keyNode->session.isUserAuthAccess = true;
+    struct HksParam runtimeParams[] = {
+        { .tag = HKS_TAG_IS_USER_AUTH_ACCESS, .boolParam = true },
+        { .tag = HKS_TAG_KEY_AUTH_RESULT, .int32Param = HKS_AUTH_RESULT_INIT },
+    };
+    return BuildParamSetWithParam(&keyNode->authRuntimeParamSet, runtimeParams, HKS_ARRAY_SIZE(runtimeParams), false);
+}
+
+static int32_t VerifyWithFreshKeyNode(const struct HksParamSet *paramSet, uint32_t authMode)
+{
+    struct HuksKeyNode keyNode = { { nullptr, nullptr }, nullptr, nullptr, nullptr, 0 };
+    int32_t ret = BuildUserAuthKeyNode(&keyNode, authMode);
+    if (ret == HKS_SUCCESS) {
+        ret = HksCoreSecureAccessVerifyParams(&keyNode, paramSet);
+    }
+    HksFreeParamSet(&keyNode.keyBlobParamSet);
+    HksFreeParamSet(&keyNode.authRuntimeParamSet);
+    return ret;
+}
+
+/**
+ * @tc.name: HksSecureAccessTest.HksSecureAccessTest018
+ * @tc.desc: tdd HksCoreSecureAccessVerifyParams, unverified token is rejected the same way every time
+ * @tc.type: FUNC
+ */
+HWTEST_F(HksSecureAccessTest, HksSecureAccessTest018, TestSize.Level0)
+{
+    HKS_LOG_I("enter HksSecureAccessTest018");
+    HksCoreSecureAccessClearAuthTokenCache();
+    struct HksUserAuthToken token;
+    BuildTestAuthToken(&token, 100, 1, 0xE);
+    struct HksParam tokenParam = {
+        .tag = HKS_TAG_AUTH_TOKEN,
+        .blob = { sizeof(struct HksUserAuthToken), (uint8_t *)&token }
+    };
+    struct HksParamSet *paramSet = nullptr;
+    ASSERT_EQ(BuildParamSetWithParam(&paramSet, &tokenParam, 1, false), HKS_SUCCESS);
+
+    int32_t firstRet = VerifyWithFreshKeyNode(paramSet, HKS_USER_AUTH_MODE_LOCAL);
+    EXPECT_NE(firstRet, HKS_SUCCESS);
+    EXPECT_EQ(VerifyWithFreshKeyNode(paramSet, HKS_USER_AUTH_MODE_LOCAL), firstRet);
+
+    uint8_t digest[HKS_DIGEST_SHA256_LEN] = {0};
+    uint64_t now = 0;
+    ASSERT_TRUE(GetAuthTokenCacheKey(&tokenParam.blob, digest, &now));
+    struct HksUserAuthToken outToken;
+    EXPECT_FALSE(LookupAuthTokenCache(digest, now, &outToken));
+    HksFreeParamSet(&paramSet);
+}
+
+/**
+ * @tc.name: HksSecureAccessTest.HksSecureAccessTest019
+ * @tc.desc: tdd GetVerifiedAuthToken, key node bound checks still run for a cached token
+ * @tc.type: FUNC
+ */
+HWTEST_F(HksSecureAccessTest, HksSecureAccessTest019, TestSize.Level0)
+{
+    HKS_LOG_I("enter HksSecureAccessTest019");
+    HksCoreSecureAccessClearAuthTokenCache();
+    struct HksUserAuthToken token;
+    BuildTestAuthToken(&token, 100, 1, 0xF);
+    const uint32_t coAuthTokenType = 2;
+    token.plaintextData.tokenType = coAuthTokenType;
+    struct HksParam tokenParam = {
+        .tag = HKS_TAG_AUTH_TOKEN,
+        .blob = { sizeof(struct HksUserAuthToken), (uint8_t *)&token }
+    };
+    struct HksParamSet *paramSet = nullptr;
+    ASSERT_EQ(BuildParamSetWithParam(&paramSet, &tokenParam, 1, false), HKS_SUCCESS);
+
+    uint8_t digest[HKS_DIGEST_SHA256_LEN] = {0};
+    uint64_t now = 0;
+    ASSERT_TRUE(GetAuthTokenCacheKey(&tokenParam.blob, digest, &now));
+    InsertAuthTokenCache(digest, now, &token);
+
+    struct HuksKeyNode localKeyNode = { { nullptr, nullptr }, nullptr, nullptr, nullptr, 0 };
+    ASSERT_EQ(BuildUserAuthKeyNode(&localKeyNode, HKS_USER_AUTH_MODE_LOCAL), HKS_SUCCESS);
+    struct HksUserAuthToken *outToken = nullptr;
+    EXPECT_EQ(GetVerifiedAuthToken(&localKeyNode, paramSet, &outToken), HKS_ERROR_NOT_SUPPORTED);
+    EXPECT_EQ(outToken, nullptr);
+
+    struct HuksKeyNode coAuthKeyNode = { { nullptr, nullptr }, nullptr, nullptr, nullptr, 0 };
+    ASSERT_EQ(BuildUserAuthKeyNode(&coAuthKeyNode, HKS_USER_AUTH_MODE_COAUTH), HKS_SUCCESS);
+    EXPECT_EQ(GetVerifiedAuthToken(&coAuthKeyNode, paramSet, &outToken), HKS_SUCCESS);
+    ASSERT_NE(outToken, nullptr);
+    EXPECT_EQ(HksMemCmp(outToken, &token, sizeof(struct HksUserAuthToken)), 0);
+
+    HKS_FREE(outToken);
+    HksFreeParamSet(&localKeyNode.keyBlobParamSet);
+    HksFreeParamSet(&localKeyNode.authRuntimeParamSet);
+    HksFreeParamSet(&coAuthKeyNode.keyBlobParamSet);
+    HksFreeParamSet(&coAuthKeyNode.authRuntimeParamSet);
+    HksFreeParamSet(&paramSet);
+    HksCoreSecureAccessClearAuthTokenCache();
+}
 }
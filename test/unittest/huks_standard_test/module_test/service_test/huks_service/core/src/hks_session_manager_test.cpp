@@ -0,0 +1,169 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "hks_session_manager.h"
+#include "hks_type_inner.h"
+
+using namespace testing::ext;
+namespace Unittest::HksSessionManagerTest {
+namespace {
+constexpr uint32_t MAX_THREAD_NUM = 16;
+constexpr uint32_t BENCH_ROUND_NUM = 200000;
+constexpr uint64_t TEST_HANDLE_BASE = 0x5e5510400000000;
+constexpr uint64_t TEST_TOKEN_ID_BASE = 0x5e55104;
+
+// the process of session index, each with its own access token so that no session evicts another
+class TestSession {
+public:
+    explicit TestSession(uint32_t index) : userId_(index), uid_(index), handle_(TEST_HANDLE_BASE + index)
+    {
+        processInfo_.userId = { sizeof(userId_), reinterpret_cast<uint8_t *>(&userId_) };
+        processInfo_.processName = { sizeof(uid_), reinterpret_cast<uint8_t *>(&uid_) };
+        processInfo_.accessTokenId = TEST_TOKEN_ID_BASE + index;
+        handleBlob_ = { sizeof(handle_), reinterpret_cast<uint8_t *>(&handle_) };
+    }
+
+    ~TestSession()
+    {
+        DeleteOperation(&handleBlob_);
+    }
+
+    int32_t Create()
+    {
+        return CreateOperation(&processInfo_, nullptr, &handleBlob_, true);
+    }
+
+    struct HksOperation *Query()
+    {
+        return QueryOperationAndMarkInUse(&processInfo_, &handleBlob_);
+    }
+
+    const struct HksProcessInfo *GetProcessInfo() const
+    {
+        return &processInfo_;
+    }
+
+private:
+    uint32_t userId_;
+    uint32_t uid_;
+    uint64_t handle_;
+    struct HksProcessInfo processInfo_ {};
+    struct HksBlob handleBlob_ {};
+};
+
+// every thread drives its own session as an update would, returns the lookups per second of all threads
+double RunSessions(uint32_t threadNum, std::atomic<uint32_t> &failCount)
+{
+    std::vector<std::unique_ptr<TestSession>> sessions;
+    for (uint32_t i = 0; i < threadNum; ++i) {
+        sessions.push_back(std::make_unique<TestSession>(i));
+        EXPECT_EQ(sessions.back()->Create(), HKS_SUCCESS);
+    }
+    std::vector<std::thread> threads;
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < threadNum; ++i) {
+        threads.emplace_back([&session = *sessions[i], &failCount] {
+            for (uint32_t round = 0; round < BENCH_ROUND_NUM; ++round) {
+                struct HksOperation *operation = session.Query();
+                if (operation == nullptr) {
+                    ++failCount;
+                    continue;
+                }
+                MarkOperationUnUse(operation);
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return threadNum * BENCH_ROUND_NUM / seconds;
+}
+}  // namespace
+
+class HksSessionManagerTest : public testing::Test {};
+
+/**
+ * @tc.name: HksSessionManagerTest.HksSessionManagerTest001
+ * @tc.desc: a session is lent to one request at a time, and is not deleted while lent
+ * @tc.type: FUNC
+ */
+HWTEST_F(HksSessionManagerTest, HksSessionManagerTest001, TestSize.Level0)
+{
+    TestSession session(0);
+    ASSERT_EQ(session.Create(), HKS_SUCCESS);
+    struct HksOperation *operation = session.Query();
+    ASSERT_NE(operation, nullptr);
+    EXPECT_EQ(session.Query(), nullptr);
+
+    uint64_t handle = TEST_HANDLE_BASE;
+    struct HksBlob handleBlob = { sizeof(handle), reinterpret_cast<uint8_t *>(&handle) };
+    DeleteOperation(&handleBlob);
+    MarkOperationUnUse(operation);
+    operation = session.Query();
+    ASSERT_NE(operation, nullptr);
+    MarkOperationUnUse(operation);
+
+    DeleteOperation(&handleBlob);
+    EXPECT_EQ(session.Query(), nullptr);
+}
+
+/**
+ * @tc.name: HksSessionManagerTest.HksSessionManagerTest002
+ * @tc.desc: removing a process deletes its unused sessions at once, and a lent one once it is given back
+ * @tc.type: FUNC
+ */
+HWTEST_F(HksSessionManagerTest, HksSessionManagerTest002, TestSize.Level0)
+{
+    TestSession session(0);
+    ASSERT_EQ(session.Create(), HKS_SUCCESS);
+    struct HksOperation *operation = session.Query();
+    ASSERT_NE(operation, nullptr);
+
+    DeleteSessionByProcessInfo(session.GetProcessInfo());
+    EXPECT_EQ(session.Query(), nullptr);
+    MarkOperationUnUse(operation);
+    EXPECT_EQ(session.Query(), nullptr);
+
+    ASSERT_EQ(session.Create(), HKS_SUCCESS);
+    DeleteSessionByProcessInfo(session.GetProcessInfo());
+    EXPECT_EQ(session.Query(), nullptr);
+}
+
+/**
+ * @tc.name: HksSessionManagerTest.HksSessionManagerTest003
+ * @tc.desc: lookups per second of 2 to 16 threads each driving its own session
+ * @tc.type: PERF
+ */
+HWTEST_F(HksSessionManagerTest, HksSessionManagerTest003, TestSize.Level1)
+{
+    for (uint32_t threadNum = 2; threadNum <= MAX_THREAD_NUM; threadNum *= 2) {
+        std::atomic<uint32_t> failCount { 0 };
+        double opsPerSecond = RunSessions(threadNum, failCount);
+        std::cout << threadNum << " threads: " << opsPerSecond / threadNum << " lookups per second per thread" <<
+            std::endl;
+        EXPECT_EQ(failCount.load(), 0u);
+    }
+}
+}
@@ -0,0 +1,273 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#include "hks_log.h"
+#include "hks_teec.h"
+#include "tee_client_api_mock.h"
+
+using namespace testing::ext;
+namespace Unittest::HksTeecTest {
+static const uint32_t TEST_THREAD_NUM = 16;
+static const uint32_t TEST_INVOKE_DELAY_US = 20000;
+static const uint32_t TEST_RANDOM_SIZE = 32;
+static const uint32_t TEST_LARGE_RANDOM_SIZE = 64 * 1024;
+
+class HksTeecTest : public testing::Test {
+public:
+    static void SetUpTestCase(void);
+
+    static void TearDownTestCase(void);
+
+    void SetUp();
+
+    void TearDown();
+};
+
+void HksTeecTest::SetUpTestCase(void)
+{
+}
+
+void HksTeecTest::TearDownTestCase(void)
+{
+}
+
+void HksTeecTest::SetUp()
+{
+    TeecMockReset();
+}
+
+void HksTeecTest::TearDown()
+{
+    HksTeeClose();
+}
+
+static int32_t GenerateRandom(uint32_t size, uint8_t *out)
+{
+    struct HksParamSet paramSet = { sizeof(struct HksParamSet), 0 };
+    struct HksBlob random = { size, out };
+    return HksTeeGenerateRandom(&paramSet, &random);
+}
+
+/**
+ * @tc.name: HksTeecTest.HksTeecTest001
+ * @tc.desc: HksTeeOpen opens the whole session pool and registers one shared memory per session
+ * @tc.type: FUNC
+ */
+HWTEST_F(HksTeecTest, HksTeecTest001, TestSize.Level0)
+{
+    HKS_LOG_I("enter HksTeecTest001");
+    ASSERT_EQ(HksTeeOpen(), HKS_SUCCESS);
+    EXPECT_EQ(TeecMockGetOpenSessionCount(), (uint32_t)HKS_TEEC_SESSION_POOL_SIZE);
+    EXPECT_EQ(TeecMockGetRegisteredSharedMemCount(), (uint32_t)HKS_TEEC_SESSION_POOL_SIZE);
+
+    HksTeeClose();
+    EXPECT_EQ(TeecMockGetOpenSessionCount(), 0u);
+    EXPECT_EQ(TeecMockGetRegisteredSharedMemCount(), 0u);
+}
+
+/**
+ * @tc.name: HksTeecTest.HksTeecTest002
+ * @tc.desc: commands from concurrent threads run on different sessions, bounded by the pool size
+ * @tc.type: PERF
+ */
+HWTEST_F(HksTeecTest, HksTeecTest002, TestSize.Level0)
+{
+    HKS_LOG_I("enter HksTeecTest002");
+    ASSERT_EQ(HksTeeOpen(), HKS_SUCCESS);
+    TeecMockSetInvokeDelayUs(TEST_INVOKE_DELAY_US);
+
+    std::vector<int32_t> results(TEST_THREAD_NUM, HKS_FAILURE);
+    std::vector<std::thread> threads;
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < TEST_THREAD_NUM; ++i) {
+        threads.emplace_back([&results, i]() {
+            uint8_t out[TEST_RANDOM_SIZE] = { 0 };
+            results[i] = GenerateRandom(sizeof(out), out);
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    auto cost = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+    HKS_LOG_I("%" LOG_PUBLIC "u requests on %" LOG_PUBLIC "u sessions cost %" LOG_PUBLIC "lld us",
+        TEST_THREAD_NUM, (uint32_t)HKS_TEEC_SESSION_POOL_SIZE, (long long)cost.count());
+
+    for (uint32_t i = 0; i < TEST_THREAD_NUM; ++i) {
+        EXPECT_EQ(results[i], HKS_SUCCESS);
+    }
+    EXPECT_GT(TeecMockGetMaxConcurrentInvoke(), 1u);
+    EXPECT_LE(TeecMockGetMaxConcurrentInvoke(), (uint32_t)HKS_TEEC_SESSION_POOL_SIZE);
+    EXPECT_LT(cost.count(), (long long)TEST_THREAD_NUM * TEST_INVOKE_DELAY_US);
+}
+
+/**
+ * @tc.name: HksTeecTest.HksTeecTest003
+ * @tc.desc: a command whose TA died fails without a replay, and the next command runs on a new session
+ * @tc.type: FUNC
+ */
+HWTEST_F(HksTeecTest, HksTeecTest003, TestSize.Level0)
+{
+    HKS_LOG_I("enter HksTeecTest003");
+    ASSERT_EQ(HksTeeOpen(), HKS_SUCCESS);
+    uint32_t openedTotal = TeecMockGetOpenSessionTotal();
+
+    TeecMockKillNextSession();
+    uint8_t out[TEST_RANDOM_SIZE] = { 0 };
+    EXPECT_EQ(GenerateRandom(sizeof(out), out), (int32_t)TEEC_ERROR_TARGET_DEAD);
+    EXPECT_EQ(TeecMockGetOpenSessionTotal(), openedTotal);
+    EXPECT_EQ(TeecMockGetOpenSessionCount(), (uint32_t)HKS_TEEC_SESSION_POOL_SIZE - 1);
+
+    // the idle open sessions are used first, the dead one is replaced once every other one is busy
+    TeecMockSetInvokeDelayUs(TEST_INVOKE_DELAY_US);
+    std::vector<int32_t> results(TEST_THREAD_NUM, HKS_FAILURE);
+    std::vector<std::thread> threads;
+    for (uint32_t i = 0; i < TEST_THREAD_NUM; ++i) {
+        threads.emplace_back([&results, i]() {
+            uint8_t threadOut[TEST_RANDOM_SIZE] = { 0 };
+            results[i] = GenerateRandom(sizeof(threadOut), threadOut);
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    for (uint32_t i = 0; i < TEST_THREAD_NUM; ++i) {
+        EXPECT_EQ(results[i], HKS_SUCCESS);
+    }
+    EXPECT_EQ(TeecMockGetOpenSessionTotal(), openedTotal + 1);
+    EXPECT_EQ(TeecMockGetOpenSessionCount(), (uint32_t)HKS_TEEC_SESSION_POOL_SIZE);
+}
+
+/**
+ * @tc.name: HksTeecTest.HksTeecTest004
+ * @tc.desc: small requests go through the registered shared memory and outputs reach the caller buffer
+ * @tc.type: FUNC
+ */
+HWTEST_F(HksTeecTest, HksTeecTest004, TestSize.Level0)
+{
+    HKS_LOG_I("enter HksTeecTest004");
+    ASSERT_EQ(HksTeeOpen(), HKS_SUCCESS);
+
+    uint8_t out[TEST_RANDOM_SIZE] = { 0 };
+    EXPECT_EQ(GenerateRandom(sizeof(out), out), HKS_SUCCESS);
+    EXPECT_EQ(TeecMockGetPartialMemrefInvokeCount(), 1u);
+    for (uint32_t i = 0; i < sizeof(out); ++i) {
+        EXPECT_EQ(out[i], TEEC_MOCK_OUTPUT_PATTERN);
+    }
+}
+
+/**
+ * @tc.name: HksTeecTest.HksTeecTest005
+ * @tc.desc: requests larger than the shared memory fall back to temp memref
+ * @tc.type: FUNC
+ */
+HWTEST_F(HksTeecTest, HksTeecTest005, TestSize.Level0)
+{
+    HKS_LOG_I("enter HksTeecTest005");
+    ASSERT_EQ(HksTeeOpen(), HKS_SUCCESS);
+
+    std::vector<uint8_t> out(TEST_LARGE_RANDOM_SIZE, 0);
+    EXPECT_EQ(GenerateRandom(out.size(), out.data()), HKS_SUCCESS);
+    EXPECT_EQ(TeecMockGetPartialMemrefInvokeCount(), 0u);
+    EXPECT_EQ(out[0], TEEC_MOCK_OUTPUT_PATTERN);
+    EXPECT_EQ(out[out.size() - 1], TEEC_MOCK_OUTPUT_PATTERN);
+}
+
+/**
+ * @tc.name: HksTeecTest.HksTeecTest006
+ * @tc.desc: when the TA opens fewer sessions than the pool size, busy commands wait instead of opening more
+ * @tc.type: FUNC
+ */
+HWTEST_F(HksTeecTest, HksTeecTest006, TestSize.Level0)
+{
+    HKS_LOG_I("enter HksTeecTest006");
+    const uint32_t maxSessionCount = 2;
+    TeecMockSetMaxSessionCount(maxSessionCount);
+    ASSERT_EQ(HksTeeOpen(), HKS_SUCCESS);
+    EXPECT_EQ(TeecMockGetOpenSessionCount(), maxSessionCount);
+    TeecMockSetInvokeDelayUs(TEST_INVOKE_DELAY_US);
+
+    std::vector<int32_t> results(TEST_THREAD_NUM, HKS_FAILURE);
+    std::vector<std::thread> threads;
+    for (uint32_t i = 0; i < TEST_THREAD_NUM; ++i) {
+        threads.emplace_back([&results, i]() {
+            uint8_t out[TEST_RANDOM_SIZE] = { 0 };
+            results[i] = GenerateRandom(sizeof(out), out);
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    for (uint32_t i = 0; i < TEST_THREAD_NUM; ++i) {
+        EXPECT_EQ(results[i], HKS_SUCCESS);
+    }
+    EXPECT_EQ(TeecMockGetOpenSessionTotal(), maxSessionCount);
+    EXPECT_LE(TeecMockGetMaxConcurrentInvoke(), maxSessionCount);
+}
+
+/**
+ * @tc.name: HksTeecTest.HksTeecTest007
+ * @tc.desc: reopening the pool while a command runs leaves its slot alone, the session that died in it is replaced
+ * @tc.type: FUNC
+ */
+HWTEST_F(HksTeecTest, HksTeecTest007, TestSize.Level0)
+{
+    HKS_LOG_I("enter HksTeecTest007");
+    ASSERT_EQ(HksTeeOpen(), HKS_SUCCESS);
+    uint32_t openedTotal = TeecMockGetOpenSessionTotal();
+    TeecMockSetInvokeDelayUs(TEST_INVOKE_DELAY_US);
+    TeecMockKillNextSession();
+
+    std::vector<int32_t> results(TEST_THREAD_NUM, HKS_FAILURE);
+    std::vector<std::thread> threads;
+    for (uint32_t i = 0; i < TEST_THREAD_NUM; ++i) {
+        threads.emplace_back([&results, i]() {
+            uint8_t out[TEST_RANDOM_SIZE] = { 0 };
+            results[i] = GenerateRandom(sizeof(out), out);
+        });
+        EXPECT_EQ(HksTeeOpen(), HKS_SUCCESS);
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    uint32_t deadNum = 0;
+    for (uint32_t i = 0; i < TEST_THREAD_NUM; ++i) {
+        deadNum += (results[i] == (int32_t)TEEC_ERROR_TARGET_DEAD) ? 1 : 0;
+        EXPECT_TRUE(results[i] == HKS_SUCCESS || results[i] == (int32_t)TEEC_ERROR_TARGET_DEAD);
+    }
+    EXPECT_EQ(deadNum, 1u);
+
+    // every slot is handed out again: a burst of commands fills the pool, the dead session included
+    threads.clear();
+    for (uint32_t i = 0; i < TEST_THREAD_NUM; ++i) {
+        threads.emplace_back([&results, i]() {
+            uint8_t out[TEST_RANDOM_SIZE] = { 0 };
+            results[i] = GenerateRandom(sizeof(out), out);
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    for (uint32_t i = 0; i < TEST_THREAD_NUM; ++i) {
+        EXPECT_EQ(results[i], HKS_SUCCESS);
+    }
+    EXPECT_EQ(TeecMockGetOpenSessionTotal(), openedTotal + 1);
+    EXPECT_EQ(TeecMockGetOpenSessionCount(), (uint32_t)HKS_TEEC_SESSION_POOL_SIZE);
+}
+}
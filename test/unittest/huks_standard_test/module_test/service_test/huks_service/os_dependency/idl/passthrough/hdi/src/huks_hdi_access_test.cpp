@@ -0,0 +1,269 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <iostream>
+
+#include "hdf_remote_service.h"
+#include "hks_log.h"
+#include "hks_type.h"
+#include "huks_access.h"
+#include "v1_0/ihuks.h"
+
+using namespace testing::ext;
+namespace Unittest::HuksHdiAccessTest {
+namespace {
+constexpr uint32_t TEST_CALL_NUM = 100;
+constexpr uint32_t BENCH_ROUND_NUM = 1000000;
+constexpr uint8_t TEST_OUT_PATTERN = 0x5a;
+
+struct FakeHdiService {
+    struct IHuks huks;
+    uint32_t getCount;
+    uint32_t releaseCount;
+    uint32_t moduleInitCount;
+    uint32_t updateCount;
+    struct HdfDeathRecipient *deathRecipient;
+};
+
+FakeHdiService g_service;
+uint8_t g_remote;
+
+int32_t FakeModuleInit(struct IHuks *self)
+{
+    (void)self;
+    ++g_service.moduleInitCount;
+    return HKS_SUCCESS;
+}
+
+int32_t FakeModuleDestroy(struct IHuks *self)
+{
+    (void)self;
+    return HKS_SUCCESS;
+}
+
+// hands the input back so the caller sees the conversion of both directions
+int32_t FakeUpdate(struct IHuks *self, const struct HuksBlob *handle, const struct HuksParamSet *paramSet,
+    const struct HuksBlob *inData, struct HuksBlob *outData)
+{
+    (void)self;
+    (void)handle;
+    (void)paramSet;
+    ++g_service.updateCount;
+    if (inData->dataLen > 0) {
+        outData->data[0] = TEST_OUT_PATTERN;
+    }
+    outData->dataLen = inData->dataLen;
+    return HKS_SUCCESS;
+}
+
+template<typename... Args>
+int32_t FakeEntry(struct IHuks *self, Args...)
+{
+    (void)self;
+    return HKS_SUCCESS;
+}
+
+struct HdfRemoteService *FakeAsObject(struct IHuks *self)
+{
+    (void)self;
+    return reinterpret_cast<struct HdfRemoteService *>(&g_remote);
+}
+
+void ResetService()
+{
+    g_service = {};
+    struct IHuks &huks = g_service.huks;
+    huks.ModuleInit = FakeModuleInit;
+    huks.ModuleDestroy = FakeModuleDestroy;
+    huks.GenerateKey = FakeEntry;
+    huks.ImportKey = FakeEntry;
+    huks.ImportWrappedKey = FakeEntry;
+    huks.ExportPublicKey = FakeEntry;
+    huks.Init = FakeEntry;
+    huks.Update = FakeUpdate;
+    huks.Finish = FakeEntry;
+    huks.Abort = FakeEntry;
+    huks.CheckKeyValidity = FakeEntry;
+    huks.AttestKey = FakeEntry;
+    huks.GenerateRandom = FakeEntry;
+    huks.Sign = FakeEntry;
+    huks.Verify = FakeEntry;
+    huks.Encrypt = FakeEntry;
+    huks.Decrypt = FakeEntry;
+    huks.AgreeKey = FakeEntry;
+    huks.DeriveKey = FakeEntry;
+    huks.Mac = FakeEntry;
+    huks.UpgradeKey = FakeEntry;
+    huks.ExportChipsetPlatformPublicKey = FakeEntry;
+    huks.AsObject = FakeAsObject;
+}
+
+int32_t Update(uint32_t inSize, struct HksBlob *out)
+{
+    uint8_t handleData[sizeof(uint64_t)] = { 0 };
+    uint8_t inBuffer[sizeof(uint64_t)] = { 0 };
+    struct HksBlob handle = { sizeof(handleData), handleData };
+    struct HksBlob inData = { inSize, inBuffer };
+    struct HksParamSet paramSet = { sizeof(struct HksParamSet), 0 };
+    return HuksAccessUpdate(&handle, &paramSet, &inData, out);
+}
+}  // namespace
+
+extern "C" {
+struct IHuks *IHuksGetInstance(const char *serviceName, bool isStub)
+{
+    (void)serviceName;
+    (void)isStub;
+    ++g_service.getCount;
+    return &g_service.huks;
+}
+
+void IHuksReleaseInstance(const char *serviceName, struct IHuks *instance, bool isStub)
+{
+    (void)serviceName;
+    (void)instance;
+    (void)isStub;
+    ++g_service.releaseCount;
+}
+
+void HdfRemoteServiceAddDeathRecipient(struct HdfRemoteService *service, struct HdfDeathRecipient *recipient)
+{
+    (void)service;
+    g_service.deathRecipient = recipient;
+}
+}
+
+class HuksHdiAccessTest : public testing::Test {
+public:
+    static void SetUpTestCase(void);
+
+    static void TearDownTestCase(void);
+
+    void SetUp();
+
+    void TearDown();
+};
+
+void HuksHdiAccessTest::SetUpTestCase(void)
+{
+}
+
+void HuksHdiAccessTest::TearDownTestCase(void)
+{
+}
+
+void HuksHdiAccessTest::SetUp()
+{
+    ResetService();
+}
+
+void HuksHdiAccessTest::TearDown()
+{
+    // the service dying is the only way to drop the proxy of the access layer
+    (void)HuksAccessModuleDestroy();
+    if (g_service.deathRecipient != nullptr) {
+        g_service.deathRecipient->OnRemoteDied(g_service.deathRecipient, nullptr);
+    }
+}
+
+/**
+ * @tc.name: HuksHdiAccessTest.HuksHdiAccessTest001
+ * @tc.desc: a service lacking a function is refused, a complete one is got once for every later call
+ * @tc.type: FUNC
+ */
+HWTEST_F(HuksHdiAccessTest, HuksHdiAccessTest001, TestSize.Level0)
+{
+    HKS_LOG_I("enter HuksHdiAccessTest001");
+    g_service.huks.Update = nullptr;
+    EXPECT_EQ(HuksAccessModuleInit(), HKS_ERROR_NULL_POINTER);
+    EXPECT_EQ(g_service.releaseCount, 1u);
+    EXPECT_EQ(g_service.moduleInitCount, 0u);
+
+    ResetService();
+    ASSERT_EQ(HuksAccessModuleInit(), HKS_SUCCESS);
+    uint8_t outBuffer[sizeof(uint64_t)] = { 0 };
+    for (uint32_t i = 0; i < TEST_CALL_NUM; ++i) {
+        struct HksBlob out = { sizeof(outBuffer), outBuffer };
+        ASSERT_EQ(Update(sizeof(uint32_t), &out), HKS_SUCCESS);
+        EXPECT_EQ(out.size, sizeof(uint32_t));
+        EXPECT_EQ(out.data, outBuffer);
+    }
+    EXPECT_EQ(outBuffer[0], TEST_OUT_PATTERN);
+    EXPECT_EQ(g_service.getCount, 1u);
+    EXPECT_EQ(g_service.updateCount, TEST_CALL_NUM);
+}
+
+/**
+ * @tc.name: HuksHdiAccessTest.HuksHdiAccessTest002
+ * @tc.desc: after the service died the next call gets the service again and initializes its module
+ * @tc.type: FUNC
+ */
+HWTEST_F(HuksHdiAccessTest, HuksHdiAccessTest002, TestSize.Level0)
+{
+    HKS_LOG_I("enter HuksHdiAccessTest002");
+    ASSERT_EQ(HuksAccessModuleInit(), HKS_SUCCESS);
+    ASSERT_NE(g_service.deathRecipient, nullptr);
+    g_service.deathRecipient->OnRemoteDied(g_service.deathRecipient, nullptr);
+
+    uint8_t outBuffer[sizeof(uint64_t)] = { 0 };
+    struct HksBlob out = { sizeof(outBuffer), outBuffer };
+    EXPECT_EQ(Update(sizeof(uint32_t), &out), HKS_SUCCESS);
+    EXPECT_EQ(g_service.getCount, 2u);
+    EXPECT_EQ(g_service.moduleInitCount, 2u);
+    EXPECT_EQ(g_service.updateCount, 1u);
+}
+
+/**
+ * @tc.name: HuksHdiAccessTest.HuksHdiAccessTest003
+ * @tc.desc: cost of an update through the access layer against a direct call of the service, on a service doing
+ *           nothing
+ * @tc.type: PERF
+ */
+HWTEST_F(HuksHdiAccessTest, HuksHdiAccessTest003, TestSize.Level1)
+{
+    HKS_LOG_I("enter HuksHdiAccessTest003");
+    ASSERT_EQ(HuksAccessModuleInit(), HKS_SUCCESS);
+
+    uint8_t handleData[sizeof(uint64_t)] = { 0 };
+    uint8_t inBuffer[sizeof(uint64_t)] = { 0 };
+    uint8_t outBuffer[sizeof(uint64_t)] = { 0 };
+    struct HuksBlob handle = { handleData, sizeof(handleData) };
+    struct HksParamSet paramSet = { sizeof(struct HksParamSet), 0 };
+    struct HuksParamSet huksParamSet = { reinterpret_cast<uint8_t *>(&paramSet), paramSet.paramSetSize };
+    struct HuksBlob inData = { inBuffer, sizeof(inBuffer) };
+    struct IHuks *volatile huks = &g_service.huks;
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < BENCH_ROUND_NUM; ++i) {
+        struct HuksBlob out = { outBuffer, sizeof(outBuffer) };
+        (void)huks->Update(huks, &handle, &huksParamSet, &inData, &out);
+    }
+    double directNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+    start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < BENCH_ROUND_NUM; ++i) {
+        struct HksBlob out = { sizeof(outBuffer), outBuffer };
+        (void)Update(sizeof(inBuffer), &out);
+    }
+    double accessNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "update, direct " << directNs / BENCH_ROUND_NUM << " ns, through the access layer " <<
+        accessNs / BENCH_ROUND_NUM << " ns, overhead " << (accessNs - directNs) / BENCH_ROUND_NUM << " ns per call" <<
+        std::endl;
+    EXPECT_EQ(g_service.getCount, 1u);
+    EXPECT_EQ(g_service.updateCount, 2 * BENCH_ROUND_NUM);
+}
+}
@@ -0,0 +1,195 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <system_error>
+
+#include "hks_dir_migration.h"
+#include "hks_type_enum.h"
+
+using namespace testing::ext;
+using namespace OHOS::Security::Hks;
+namespace Unittest::HksDirMigrationTest {
+namespace {
+const std::string TEST_ROOT = (std::filesystem::temp_directory_path() / "huks_dir_migration_test").string();
+const std::string OLD_DIR = TEST_ROOT + "/el2/maindata";
+const std::string NEW_DIR = TEST_ROOT + "/el1/maindata";
+const std::string MARKER = TEST_ROOT + "/el1/.maindata_migrated";
+const uint32_t BENCH_USER_COUNT = 20;
+const uint32_t BENCH_KEY_COUNT = 1000; /* 20 users * 1000 keys = 20k key files */
+
+void WriteFile(const std::string &path, const std::string &content)
+{
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file << content;
+}
+
+std::string ReadFile(const std::string &path)
+{
+    std::ifstream file(path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+
+// writes keyCount key files for each of userCount users, in the <user>/<uid>/key/<alias> layout of a key store
+void MakeStore(const std::string &root, uint32_t userCount, uint32_t keyCount)
+{
+    for (uint32_t u = 0; u < userCount; ++u) {
+        std::string keyDir = root + "/" + std::to_string(u) + "/0/key";
+        std::filesystem::create_directories(keyDir);
+        for (uint32_t k = 0; k < keyCount; ++k) {
+            WriteFile(keyDir + "/key_" + std::to_string(k), "key " + std::to_string(u) + " " + std::to_string(k));
+        }
+    }
+}
+
+uint32_t CountFiles(const std::string &root)
+{
+    uint32_t count = 0;
+    std::error_code errCode{};
+    for (auto it = std::filesystem::recursive_directory_iterator(root, errCode);
+        it != std::filesystem::recursive_directory_iterator(); ++it) {
+        count += it->is_regular_file() ? 1 : 0;
+    }
+    return count;
+}
+
+/* the migration OnStart did before: a recursive copy and then a recursive remove, on every start */
+void CopyAndRemove(const std::string &oldDir, const std::string &newDir)
+{
+    std::error_code errCode{};
+    std::filesystem::create_directory(newDir, errCode);
+    std::filesystem::copy(oldDir, newDir,
+        std::filesystem::copy_options::recursive | std::filesystem::copy_options::overwrite_existing, errCode);
+    if (errCode.value() == 0) {
+        std::filesystem::remove_all(oldDir, errCode);
+    }
+}
+
+double Milliseconds(std::chrono::steady_clock::duration cost)
+{
+    return std::chrono::duration<double, std::milli>(cost).count();
+}
+}  // namespace
+
+class HksDirMigrationTest : public testing::Test {
+public:
+    void SetUp() override
+    {
+        std::error_code errCode{};
+        std::filesystem::remove_all(TEST_ROOT, errCode);
+        std::filesystem::create_directories(TEST_ROOT + "/el1", errCode);
+        std::filesystem::create_directories(TEST_ROOT + "/el2", errCode);
+    }
+
+    void TearDown() override
+    {
+        std::error_code errCode{};
+        std::filesystem::remove_all(TEST_ROOT, errCode);
+    }
+};
+
+/**
+ * @tc.name: HksDirMigrationTest.HksDirMigrationTest001
+ * @tc.desc: the old store is moved to a missing new store, the old one is gone and the marker is written
+ * @tc.type: FUNC
+ */
+HWTEST_F(HksDirMigrationTest, HksDirMigrationTest001, TestSize.Level0)
+{
+    MakeStore(OLD_DIR, 3, 5);
+
+    EXPECT_EQ(HksMigrateDirectory(OLD_DIR.c_str(), NEW_DIR.c_str(), MARKER.c_str()), HKS_SUCCESS);
+
+    EXPECT_FALSE(std::filesystem::exists(OLD_DIR));
+    EXPECT_TRUE(std::filesystem::exists(MARKER));
+    EXPECT_EQ(CountFiles(NEW_DIR), 15u);
+    EXPECT_EQ(ReadFile(NEW_DIR + "/2/0/key/key_4"), "key 2 4");
+}
+
+/**
+ * @tc.name: HksDirMigrationTest.HksDirMigrationTest002
+ * @tc.desc: the old store is merged into a new store that has content, a key of the same name is replaced
+ * @tc.type: FUNC
+ */
+HWTEST_F(HksDirMigrationTest, HksDirMigrationTest002, TestSize.Level0)
+{
+    MakeStore(OLD_DIR, 2, 3);
+    std::filesystem::create_directories(NEW_DIR + "/0/0/key");
+    std::filesystem::create_directories(NEW_DIR + "/9/0/key");
+    WriteFile(NEW_DIR + "/0/0/key/key_0", "stale");
+    WriteFile(NEW_DIR + "/0/0/key/new_key", "new");
+    WriteFile(NEW_DIR + "/9/0/key/key_0", "other user");
+
+    EXPECT_EQ(HksMigrateDirectory(OLD_DIR.c_str(), NEW_DIR.c_str(), MARKER.c_str()), HKS_SUCCESS);
+
+    EXPECT_FALSE(std::filesystem::exists(OLD_DIR));
+    EXPECT_EQ(CountFiles(NEW_DIR), 8u);
+    EXPECT_EQ(ReadFile(NEW_DIR + "/0/0/key/key_0"), "key 0 0");
+    EXPECT_EQ(ReadFile(NEW_DIR + "/0/0/key/new_key"), "new");
+    EXPECT_EQ(ReadFile(NEW_DIR + "/9/0/key/key_0"), "other user");
+}
+
+/**
+ * @tc.name: HksDirMigrationTest.HksDirMigrationTest003
+ * @tc.desc: without an old store the new one is created and marked, once marked an old store is left alone
+ * @tc.type: FUNC
+ */
+HWTEST_F(HksDirMigrationTest, HksDirMigrationTest003, TestSize.Level0)
+{
+    EXPECT_EQ(HksMigrateDirectory(OLD_DIR.c_str(), NEW_DIR.c_str(), MARKER.c_str()), HKS_SUCCESS);
+    EXPECT_TRUE(std::filesystem::is_directory(NEW_DIR));
+    EXPECT_TRUE(std::filesystem::exists(MARKER));
+
+    MakeStore(OLD_DIR, 1, 1);
+    EXPECT_EQ(HksMigrateDirectory(OLD_DIR.c_str(), NEW_DIR.c_str(), MARKER.c_str()), HKS_SUCCESS);
+    EXPECT_EQ(CountFiles(OLD_DIR), 1u);
+    EXPECT_EQ(CountFiles(NEW_DIR), 0u);
+}
+
+/**
+ * @tc.name: HksDirMigrationTest.HksDirMigrationTest004
+ * @tc.desc: time the migration step of OnStart takes for a store of 20k key files: copy and remove, rename, and a
+ *           later start that finds the marker
+ * @tc.type: PERF
+ */
+HWTEST_F(HksDirMigrationTest, HksDirMigrationTest004, TestSize.Level1)
+{
+    MakeStore(OLD_DIR, BENCH_USER_COUNT, BENCH_KEY_COUNT);
+    auto start = std::chrono::steady_clock::now();
+    CopyAndRemove(OLD_DIR, NEW_DIR);
+    double copyCost = Milliseconds(std::chrono::steady_clock::now() - start);
+    ASSERT_EQ(CountFiles(NEW_DIR), BENCH_USER_COUNT * BENCH_KEY_COUNT);
+
+    std::error_code errCode{};
+    std::filesystem::remove_all(NEW_DIR, errCode);
+    MakeStore(OLD_DIR, BENCH_USER_COUNT, BENCH_KEY_COUNT);
+    start = std::chrono::steady_clock::now();
+    EXPECT_EQ(HksMigrateDirectory(OLD_DIR.c_str(), NEW_DIR.c_str(), MARKER.c_str()), HKS_SUCCESS);
+    double renameCost = Milliseconds(std::chrono::steady_clock::now() - start);
+    ASSERT_EQ(CountFiles(NEW_DIR), BENCH_USER_COUNT * BENCH_KEY_COUNT);
+
+    start = std::chrono::steady_clock::now();
+    EXPECT_EQ(HksMigrateDirectory(OLD_DIR.c_str(), NEW_DIR.c_str(), MARKER.c_str()), HKS_SUCCESS);
+    double markedCost = Milliseconds(std::chrono::steady_clock::now() - start);
+
+    std::cout << "migrate " << BENCH_USER_COUNT * BENCH_KEY_COUNT << " key files: copy and remove " << copyCost <<
+        " ms, rename " << renameCost << " ms, marked start " << markedCost << " ms" << std::endl;
+}
+}
@@ -0,0 +1,161 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <system_error>
+
+#include "hks_event_aggregator.h"
+
+using namespace testing::ext;
+using namespace OHOS::Security::Hks;
+namespace Unittest::HksEventAggregatorTest {
+namespace {
+const std::string PENDING_PATH =
+    (std::filesystem::temp_directory_path() / "huks_event_aggregator_test_pending").string();
+constexpr int TEST_USER_ID = 901; /* users and uids without any key */
+constexpr int OTHER_USER_ID = 902;
+constexpr int UID_PER_USER = 200000;
+constexpr int REMOVED_USER_UID = -1;
+constexpr uint32_t STORM_EVENT_NUM = 1000;
+constexpr uint32_t STORM_UID_NUM = 50;
+constexpr uint32_t OTHER_EVENT_NUM = 49;
+constexpr uint32_t OTHER_UID_NUM = 7;
+constexpr uint32_t STORM_WINDOW_MS = 500;
+constexpr uint32_t LONG_WINDOW_MS = 10000;
+constexpr uint32_t WAIT_DONE_MS = 20000;
+
+int TestUid(int userId, uint32_t index)
+{
+    return userId * UID_PER_USER + static_cast<int>(index);
+}
+
+uint32_t PendingRecordNum()
+{
+    std::error_code errCode{};
+    uintmax_t size = std::filesystem::file_size(PENDING_PATH, errCode);
+    return (errCode.value() != 0) ? 0 : static_cast<uint32_t>(size / (2 * sizeof(int32_t)));
+}
+
+HksEventAggregatorStats Delta(const HksEventAggregatorStats &before)
+{
+    HksEventAggregatorStats after = { 0, 0, 0, 0, 0 };
+    HksEventAggregatorGetStats(after);
+    return { after.queuedCount, after.receivedCount - before.receivedCount, after.mergedCount - before.mergedCount,
+        after.removedCount - before.removedCount, after.batchCount - before.batchCount };
+}
+}  // namespace
+
+class HksEventAggregatorTest : public testing::Test {
+public:
+    void SetUp() override
+    {
+        std::filesystem::remove(PENDING_PATH);
+        HksEventAggregatorGetStats(before_);
+    }
+
+    void TearDown() override
+    {
+        EXPECT_TRUE(HksEventAggregatorWaitDone(WAIT_DONE_MS));
+        std::filesystem::remove(PENDING_PATH);
+    }
+
+    HksEventAggregatorStats before_ = { 0, 0, 0, 0, 0 };
+};
+
+/**
+ * @tc.name: HksEventAggregatorTest.HksEventAggregatorTest001
+ * @tc.desc: a storm of 1000 removals of 50 packages, and of the packages of a user removed along, runs as one batch
+ *           removing each package and the user once, the pending file lasts until the batch is done
+ * @tc.type: FUNC
+ */
+HWTEST_F(HksEventAggregatorTest, HksEventAggregatorTest001, TestSize.Level0)
+{
+    HksEventAggregatorSetConfig({ STORM_WINDOW_MS, LONG_WINDOW_MS, PENDING_PATH });
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < STORM_EVENT_NUM - OTHER_EVENT_NUM - 1; ++i) {
+        HksEventAggregatorAddPackageRemoved(TEST_USER_ID, TestUid(TEST_USER_ID, i % STORM_UID_NUM));
+    }
+    for (uint32_t i = 0; i < OTHER_EVENT_NUM; ++i) {
+        HksEventAggregatorAddPackageRemoved(OTHER_USER_ID, TestUid(OTHER_USER_ID, i % OTHER_UID_NUM));
+    }
+    HksEventAggregatorAddUserRemoved(OTHER_USER_ID);
+    double queueUs = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+    HksEventAggregatorStats queued = Delta(before_);
+    EXPECT_EQ(queued.queuedCount, STORM_UID_NUM + 1);
+    EXPECT_EQ(PendingRecordNum(), STORM_UID_NUM + OTHER_UID_NUM + 1);
+
+    ASSERT_TRUE(HksEventAggregatorWaitDone(WAIT_DONE_MS));
+    HksEventAggregatorStats done = Delta(before_);
+    std::cout << STORM_EVENT_NUM << " removal events queued in " << queueUs / STORM_EVENT_NUM << " us each, " <<
+        done.removedCount << " removals in " << done.batchCount << " batch" << std::endl;
+    EXPECT_EQ(done.receivedCount, STORM_EVENT_NUM);
+    EXPECT_EQ(done.mergedCount, STORM_EVENT_NUM - STORM_UID_NUM - 1);
+    EXPECT_EQ(done.removedCount, STORM_UID_NUM + 1);
+    EXPECT_EQ(done.batchCount, 1u);
+    EXPECT_FALSE(std::filesystem::exists(PENDING_PATH));
+}
+
+/**
+ * @tc.name: HksEventAggregatorTest.HksEventAggregatorTest002
+ * @tc.desc: the removals left in the pending file by a former run are run once on resume
+ * @tc.type: FUNC
+ */
+HWTEST_F(HksEventAggregatorTest, HksEventAggregatorTest002, TestSize.Level0)
+{
+    int32_t records[] = { TEST_USER_ID, TestUid(TEST_USER_ID, 0), TEST_USER_ID, TestUid(TEST_USER_ID, 0),
+        OTHER_USER_ID, REMOVED_USER_UID };
+    {
+        std::ofstream file(PENDING_PATH, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char *>(records), sizeof(records));
+    }
+    HksEventAggregatorSetConfig({ 0, 0, PENDING_PATH });
+    HksEventAggregatorResume();
+
+    ASSERT_TRUE(HksEventAggregatorWaitDone(WAIT_DONE_MS));
+    HksEventAggregatorStats done = Delta(before_);
+    EXPECT_EQ(done.mergedCount, 1u);
+    EXPECT_EQ(done.removedCount, 2u);
+    EXPECT_FALSE(std::filesystem::exists(PENDING_PATH));
+}
+
+/**
+ * @tc.name: HksEventAggregatorTest.HksEventAggregatorTest003
+ * @tc.desc: a request of a package with a queued removal runs the removal at once, other requests leave it queued
+ * @tc.type: FUNC
+ */
+HWTEST_F(HksEventAggregatorTest, HksEventAggregatorTest003, TestSize.Level0)
+{
+    HksEventAggregatorSetConfig({ LONG_WINDOW_MS, LONG_WINDOW_MS, PENDING_PATH });
+    int uid = TestUid(TEST_USER_ID, 0);
+    HksEventAggregatorAddPackageRemoved(TEST_USER_ID, uid);
+
+    HksEventAggregatorFlushUid(TestUid(TEST_USER_ID, 1));
+    EXPECT_EQ(Delta(before_).queuedCount, 1u);
+    EXPECT_EQ(PendingRecordNum(), 1u);
+
+    HksEventAggregatorFlushUid(uid);
+    HksEventAggregatorStats done = Delta(before_);
+    EXPECT_EQ(done.queuedCount, 0u);
+    EXPECT_EQ(done.removedCount, 1u);
+    EXPECT_FALSE(std::filesystem::exists(PENDING_PATH));
+}
+}
@@ -0,0 +1,309 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "hks_request_dispatcher.h"
+#include "hks_type_enum.h"
+#include "huks_service_ipc_interface_code.h"
+
+using namespace testing::ext;
+using namespace OHOS::Security::Hks;
+namespace Unittest::HksRequestDispatcherTest {
+namespace {
+/* cores the requests compete for, one more than the slow lane runs at once */
+constexpr uint32_t MOCK_CORE_NUM = HKS_SLOW_LANE_THREAD_NUM + 1;
+constexpr uint32_t LOAD_REQUEST_NUM = 400;
+constexpr uint32_t LOAD_SLOW_PERIOD = 50; /* every 50 requests start with a burst of key generations */
+constexpr uint32_t LOAD_SLOW_BURST = MOCK_CORE_NUM;
+constexpr auto LOAD_ARRIVAL_INTERVAL = std::chrono::milliseconds(1);
+constexpr auto SLOW_REQUEST_COST = std::chrono::milliseconds(30);
+constexpr auto FAST_REQUEST_COST = std::chrono::microseconds(200);
+constexpr uint32_t PERCENT = 100;
+constexpr uint32_t P99 = 99;
+constexpr auto QUEUE_WAIT_TIME = std::chrono::milliseconds(100);
+
+using Clock = std::chrono::steady_clock;
+
+struct MockRequest {
+    uint32_t code;
+    Clock::time_point sendTime;
+};
+
+struct LoadResult {
+    std::vector<double> fastLatency;
+    uint32_t fastBusyCount = 0;
+    uint32_t slowBusyCount = 0;
+};
+
+// Stands in for the cores of the device, a request holds one while it runs.
+class MockCores {
+public:
+    void Run(Clock::duration cost)
+    {
+        {
+            std::unique_lock<std::mutex> lock(lock_);
+            cond_.wait(lock, [this] { return busy_ < MOCK_CORE_NUM; });
+            ++busy_;
+        }
+        std::this_thread::sleep_for(cost);
+        {
+            std::lock_guard<std::mutex> lock(lock_);
+            --busy_;
+        }
+        cond_.notify_one();
+    }
+
+private:
+    std::mutex lock_;
+    std::condition_variable cond_;
+    uint32_t busy_ = 0;
+};
+
+// Stands in for the ipc layer: threadNum threads take the requests in the order they were sent, as binder threads
+// do, and run the handler of the service on them. withLanes runs the handler under the lane of the request. The
+// requests still queued when it is destroyed are handled first.
+class MockIpc {
+public:
+    MockIpc(uint32_t threadNum, bool withLanes, LoadResult &result) : withLanes_(withLanes), result_(result)
+    {
+        for (uint32_t i = 0; i < threadNum; ++i) {
+            threads_.emplace_back([this] { Run(); });
+        }
+    }
+
+    ~MockIpc()
+    {
+        {
+            std::lock_guard<std::mutex> lock(lock_);
+            stop_ = true;
+        }
+        cond_.notify_all();
+        for (auto &thread : threads_) {
+            thread.join();
+        }
+    }
+
+    void Send(uint32_t code)
+    {
+        {
+            std::lock_guard<std::mutex> lock(lock_);
+            queue_.push_back({ code, Clock::now() });
+        }
+        cond_.notify_one();
+    }
+
+private:
+    void Run()
+    {
+        std::unique_lock<std::mutex> lock(lock_);
+        while (true) {
+            cond_.wait(lock, [this] { return stop_ || !queue_.empty(); });
+            if (queue_.empty()) {
+                return;
+            }
+            MockRequest request = queue_.front();
+            queue_.pop_front();
+            lock.unlock();
+            int32_t ret = Handle(request.code);
+            double latency = std::chrono::duration<double, std::milli>(Clock::now() - request.sendTime).count();
+            lock.lock();
+            bool isSlow = (request.code == HKS_MSG_GEN_KEY);
+            if (ret == HKS_ERROR_SERVICE_BUSY) {
+                ++(isSlow ? result_.slowBusyCount : result_.fastBusyCount);
+            } else if (!isSlow) {
+                result_.fastLatency.push_back(latency);
+            }
+        }
+    }
+
+    int32_t Handle(uint32_t code)
+    {
+        auto cost = (code == HKS_MSG_GEN_KEY) ? Clock::duration(SLOW_REQUEST_COST) : FAST_REQUEST_COST;
+        if (!withLanes_) {
+            cores_.Run(cost);
+            return HKS_SUCCESS;
+        }
+        HksLaneGuard laneGuard(code, 0);
+        if (laneGuard.GetResult() == HKS_SUCCESS) {
+            cores_.Run(cost);
+        }
+        return laneGuard.GetResult();
+    }
+
+    bool withLanes_;
+    MockCores cores_;
+    std::mutex lock_;
+    std::condition_variable cond_;
+    std::deque<MockRequest> queue_;
+    std::vector<std::thread> threads_;
+    LoadResult &result_;
+    bool stop_ = false;
+};
+
+// sends LOAD_REQUEST_NUM encryptions mixed with bursts of key generations, at a steady rate, and waits for all of them
+LoadResult RunLoad(uint32_t threadNum, bool withLanes)
+{
+    LoadResult result;
+    {
+        MockIpc ipc(threadNum, withLanes, result);
+        auto next = Clock::now();
+        for (uint32_t i = 0; i < LOAD_REQUEST_NUM; ++i) {
+            ipc.Send((i % LOAD_SLOW_PERIOD < LOAD_SLOW_BURST) ? HKS_MSG_GEN_KEY : HKS_MSG_ENCRYPT);
+            next += LOAD_ARRIVAL_INTERVAL;
+            std::this_thread::sleep_until(next);
+        }
+    }
+    return result;
+}
+
+double Percentile(std::vector<double> values, uint32_t percent)
+{
+    if (values.empty()) {
+        return 0;
+    }
+    std::sort(values.begin(), values.end());
+    return values[(values.size() - 1) * percent / PERCENT];
+}
+}  // namespace
+
+class HksRequestDispatcherTest : public testing::Test {};
+
+/**
+ * @tc.name: HksRequestDispatcherTest.HksRequestDispatcherTest001
+ * @tc.desc: key generation, attestation, wrapped key import and large requests take the slow lane
+ * @tc.type: FUNC
+ */
+HWTEST_F(HksRequestDispatcherTest, HksRequestDispatcherTest001, TestSize.Level0)
+{
+    EXPECT_EQ(HksGetRequestLane(HKS_MSG_GEN_KEY, 0), HksRequestLane::SLOW);
+    EXPECT_EQ(HksGetRequestLane(HKS_MSG_ATTEST_KEY, 0), HksRequestLane::SLOW);
+    EXPECT_EQ(HksGetRequestLane(HKS_MSG_ATTEST_KEY_ASYNC_REPLY, 0), HksRequestLane::SLOW);
+    EXPECT_EQ(HksGetRequestLane(HKS_MSG_IMPORT_WRAPPED_KEY, 0), HksRequestLane::SLOW);
+    EXPECT_EQ(HksGetRequestLane(HKS_MSG_ENCRYPT, HKS_SLOW_LANE_DATA_SIZE + 1), HksRequestLane::SLOW);
+
+    EXPECT_EQ(HksGetRequestLane(HKS_MSG_ENCRYPT, HKS_SLOW_LANE_DATA_SIZE), HksRequestLane::FAST);
+    EXPECT_EQ(HksGetRequestLane(HKS_MSG_MAC, 0), HksRequestLane::FAST);
+    EXPECT_EQ(HksGetRequestLane(HKS_MSG_UPDATE, 0), HksRequestLane::FAST);
+    EXPECT_EQ(HksGetRequestLane(HKS_MSG_KEY_EXIST, 0), HksRequestLane::FAST);
+}
+
+/**
+ * @tc.name: HksRequestDispatcherTest.HksRequestDispatcherTest002
+ * @tc.desc: a full lane queues requests up to its depth and refuses more, a request leaving lets a queued one run
+ * @tc.type: FUNC
+ */
+HWTEST_F(HksRequestDispatcherTest, HksRequestDispatcherTest002, TestSize.Level0)
+{
+    HksLaneLimiter limiter({ 1, 1 });
+    auto running = std::make_unique<HksLaneGuard>(limiter);
+    ASSERT_EQ(running->GetResult(), HKS_SUCCESS);
+
+    bool queuedRan = false;
+    std::thread queued([&limiter, &queuedRan] {
+        HksLaneGuard laneGuard(limiter);
+        queuedRan = (laneGuard.GetResult() == HKS_SUCCESS);
+    });
+    // gives the queued request the time to take the only place of the queue
+    std::this_thread::sleep_for(QUEUE_WAIT_TIME);
+    {
+        HksLaneGuard refused(limiter);
+        EXPECT_EQ(refused.GetResult(), HKS_ERROR_SERVICE_BUSY);
+    }
+
+    running.reset();
+    queued.join();
+    EXPECT_TRUE(queuedRan);
+    HksLaneGuard again(limiter);
+    EXPECT_EQ(again.GetResult(), HKS_SUCCESS);
+}
+
+/**
+ * @tc.name: HksRequestDispatcherTest.HksRequestDispatcherTest003
+ * @tc.desc: p99 of the fast requests under a load mixed with bursts of key generations, on the ipc threads of the
+ *           service taking requests in order, without and with the lanes, and no request is refused
+ * @tc.type: PERF
+ */
+HWTEST_F(HksRequestDispatcherTest, HksRequestDispatcherTest003, TestSize.Level1)
+{
+    LoadResult baseline = RunLoad(HUKS_IPC_THREAD_NUM, false);
+    LoadResult lanes = RunLoad(HUKS_IPC_THREAD_NUM, true);
+    double baselineP99 = Percentile(baseline.fastLatency, P99);
+    double lanesP99 = Percentile(lanes.fastLatency, P99);
+
+    std::cout << "fast request p99 on " << HUKS_IPC_THREAD_NUM << " ipc threads and " << MOCK_CORE_NUM <<
+        " cores: in order " << baselineP99 << " ms, with lanes " << lanesP99 << " ms, refused " <<
+        lanes.fastBusyCount << " fast and " << lanes.slowBusyCount << " slow requests" << std::endl;
+    EXPECT_EQ(lanes.fastBusyCount, 0u);
+    EXPECT_EQ(lanes.slowBusyCount, 0u);
+    EXPECT_EQ(lanes.fastLatency.size(), baseline.fastLatency.size());
+    EXPECT_LT(lanesP99, baselineP99);
+}
+
+/**
+ * @tc.name: HksRequestDispatcherTest.HksRequestDispatcherTest004
+ * @tc.desc: with the default depths a storm of key generations on every ipc thread is refused past the slow lane
+ *           and its queue, and a fast request still runs at once
+ * @tc.type: FUNC
+ */
+HWTEST_F(HksRequestDispatcherTest, HksRequestDispatcherTest004, TestSize.Level0)
+{
+    std::mutex lock;
+    std::condition_variable cond;
+    bool isReleased = false;
+    std::atomic<uint32_t> busyCount { 0 };
+    std::vector<std::thread> storm;
+    for (uint32_t i = 0; i < HUKS_IPC_THREAD_NUM; ++i) {
+        storm.emplace_back([&lock, &cond, &isReleased, &busyCount] {
+            HksLaneGuard laneGuard(HKS_MSG_GEN_KEY, 0);
+            if (laneGuard.GetResult() == HKS_ERROR_SERVICE_BUSY) {
+                ++busyCount;
+                return;
+            }
+            std::unique_lock<std::mutex> releaseLock(lock);
+            cond.wait(releaseLock, [&isReleased] { return isReleased; });
+        });
+    }
+    // gives the storm the time to fill the slow lane and its queue
+    std::this_thread::sleep_for(QUEUE_WAIT_TIME);
+    EXPECT_EQ(busyCount.load(), HUKS_IPC_THREAD_NUM - HKS_SLOW_LANE_THREAD_NUM - HKS_SLOW_LANE_QUEUE_DEPTH);
+    {
+        HksLaneGuard fast(HKS_MSG_ENCRYPT, 0);
+        EXPECT_EQ(fast.GetResult(), HKS_SUCCESS);
+    }
+
+    {
+        std::lock_guard<std::mutex> releaseLock(lock);
+        isReleased = true;
+    }
+    cond.notify_all();
+    for (auto &thread : storm) {
+        thread.join();
+    }
+    HksLaneGuard slow(HKS_MSG_GEN_KEY, 0);
+    EXPECT_EQ(slow.GetResult(), HKS_SUCCESS);
+}
+}
@@ -29,7 +29,9 @@
 #define HKS_CONFIG_RKC_STORE_PATH "/data"
 
 #include <gtest/gtest.h>
+#include <chrono>
 #include <cstring>
+#include <iostream>
 
 #include "file_ex.h"
 #include "hks_log.h"
@@ -42,6 +44,11 @@
 
 using namespace testing::ext;
 namespace Unittest::HksStorageUtilTest {
+static const uint32_t RECORD_NUM = 100;
+static const uint32_t RECORD_BENCH_ROUNDS = 20000;
+static const char *TEST_KEY_PATH = HKS_KEY_STORE_PATH "/100/20020001/key";
+static const char *TEST_KEY_ALIAS = "hks_storage_util_test_key_alias_0123456789";
+
 class HksStorageUtilTest : public testing::Test {
 public:
     static void SetUpTestCase(void);
@@ -273,4 +280,61 @@ HWTEST_F(HksStorageUtilTest, HksStorageUtilTest007, TestSize.Level0)
     ASSERT_EQ(strlen(fileInfo.mainPath.path), strlen(expectPath)) << fileInfo.mainPath.path;
     ASSERT_EQ(EOK, HksMemCmp(fileInfo.mainPath.path, expectPath, strlen(expectPath)));
 }
+
+/**
+ * @tc.name: HksStorageUtilTest.HksStorageUtilTest008
+ * @tc.desc: every key operation is counted, a burst of them is logged at the limited level and none at the count
+ *           level
+ * @tc.type: FUNC
+ */
+HWTEST_F(HksStorageUtilTest, HksStorageUtilTest008, TestSize.Level0)
+{
+    HKS_LOG_I("enter HksStorageUtilTest008");
+    EXPECT_EQ(RecordKeyOperation(KEY_OPERATION_MAX, TEST_KEY_PATH, TEST_KEY_ALIAS), HKS_ERROR_INVALID_ARGUMENT);
+
+    HksSetKeyOperationLogLevel(HKS_KEY_OPERATION_LOG_LIMITED);
+    g_keyOperationLimiters[KEY_OPERATION_GET] = {};
+    uint32_t count = HksGetKeyOperationCount(KEY_OPERATION_GET);
+    for (uint32_t i = 0; i < RECORD_NUM; ++i) {
+        ASSERT_EQ(RecordKeyOperation(KEY_OPERATION_GET, TEST_KEY_PATH, TEST_KEY_ALIAS), HKS_SUCCESS);
+    }
+    EXPECT_EQ(HksGetKeyOperationCount(KEY_OPERATION_GET) - count, RECORD_NUM);
+    EXPECT_GT(g_keyOperationLimiters[KEY_OPERATION_GET].suppressedCount, 0u);
+    EXPECT_LE(g_keyOperationLimiters[KEY_OPERATION_GET].suppressedCount, RECORD_NUM - HKS_LOG_LIMIT_BURST);
+
+    HksSetKeyOperationLogLevel(HKS_KEY_OPERATION_LOG_COUNT);
+    g_keyOperationCountLimiter = {};
+    count = HksGetKeyOperationCount(KEY_OPERATION_DELETE);
+    for (uint32_t i = 0; i < RECORD_NUM; ++i) {
+        ASSERT_EQ(RecordKeyOperation(KEY_OPERATION_DELETE, TEST_KEY_PATH, TEST_KEY_ALIAS), HKS_SUCCESS);
+    }
+    EXPECT_EQ(HksGetKeyOperationCount(KEY_OPERATION_DELETE) - count, RECORD_NUM);
+    EXPECT_EQ(g_keyOperationCountLimiter.suppressedCount, RECORD_NUM - 1);
+    HksSetKeyOperationLogLevel(static_cast<enum HksKeyOperationLogLevel>(HKS_KEY_OPERATION_LOG_LEVEL));
+}
+
+/**
+ * @tc.name: HksStorageUtilTest.HksStorageUtilTest009
+ * @tc.desc: cost of recording the use of a key, as every get of a key does, at each key operation log level
+ * @tc.type: PERF
+ */
+HWTEST_F(HksStorageUtilTest, HksStorageUtilTest009, TestSize.Level1)
+{
+    HKS_LOG_I("enter HksStorageUtilTest009");
+    const enum HksKeyOperationLogLevel levels[] = { HKS_KEY_OPERATION_LOG_ALL, HKS_KEY_OPERATION_LOG_LIMITED,
+        HKS_KEY_OPERATION_LOG_COUNT };
+    for (enum HksKeyOperationLogLevel level : levels) {
+        HksSetKeyOperationLogLevel(level);
+        uint32_t failCount = 0;
+        auto start = std::chrono::steady_clock::now();
+        for (uint32_t i = 0; i < RECORD_BENCH_ROUNDS; ++i) {
+            failCount += (RecordKeyOperation(KEY_OPERATION_GET, TEST_KEY_PATH, TEST_KEY_ALIAS) != HKS_SUCCESS) ? 1 : 0;
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::cout << "key operation log level " << level << ": " << RECORD_BENCH_ROUNDS / seconds <<
+            " key uses recorded per second" << std::endl;
+        EXPECT_EQ(failCount, 0u);
+    }
+    HksSetKeyOperationLogLevel(static_cast<enum HksKeyOperationLogLevel>(HKS_KEY_OPERATION_LOG_LEVEL));
+}
 }
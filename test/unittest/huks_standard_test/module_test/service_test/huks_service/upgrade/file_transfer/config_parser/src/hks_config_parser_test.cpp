@@ -15,6 +15,9 @@
 
 #include <gtest/gtest.h>
 
+#include <string>
+#include <vector>
+
 #include "hks_config_parser.h"
 #include "hks_log.h"
 #include "hks_mem.h"
@@ -26,11 +29,15 @@
 #undef HUKS_SA_SKIP_UPGRADE_CONFIG
 #undef HUKS_HAP_SKIP_UPGRADE_CONFIG
 
-#define HUKS_SA_UPGRADE_CONFIG { { 6, false, false }, { 7, false, true }, { 8, true, false }, { 9, true, true } }
+// sa 10 and com.example.skip2 are also in the skip lists, and the second sa 9 and demo4 are shadowed by the first
+#define HUKS_SA_UPGRADE_CONFIG { { 6, false, false }, { 7, false, true }, { 8, true, false }, { 9, true, true }, \
+    { 10, true, true }, { 9, false, false } }
 #define HUKS_HAP_UPGRADE_CONFIG { { "com.example.demo1", true, true }, \
     { "com.example.demo2", true, false }, \
     { "com.example.demo3", false, true }, \
-    { "com.example.demo4", false, false } }
+    { "com.example.demo4", false, false }, \
+    { "com.example.skip2", true, true }, \
+    { "com.example.demo4", true, true } }
 #define HUKS_SA_SKIP_UPGRADE_CONFIG { 0, 10, 99 }
 #define HUKS_HAP_SKIP_UPGRADE_CONFIG { "com.example.skip1", "com.example.skip2" }
 
@@ -38,21 +45,80 @@
 
 enum HksAtType g_accessTokenType = HKS_TOKEN_HAP;
 char *g_hapName = nullptr;
+uint32_t g_atTypeQueryCount = 0;
+uint32_t g_hapNameQueryCount = 0;
 
 int32_t HksGetAtType(uint64_t accessTokenId, enum HksAtType *atType)
 {
+    ++g_atTypeQueryCount;
     *atType = g_accessTokenType;
     return HKS_SUCCESS;
 }
 
 int32_t HksGetHapNameFromAccessToken(int32_t tokenId, char *hapName, int32_t hapNameSize)
 {
+    ++g_hapNameQueryCount;
     (void)memcpy_s(hapName, hapNameSize, g_hapName, strlen(g_hapName));
     return HKS_SUCCESS;
 }
 
 using namespace testing::ext;
 namespace Unittest::HksServiceUpgradeConfigParserTest {
+namespace {
+// the matching done before the policy tables: every list scanned in order, skip lists first
+void LinearMatchSaConfig(const char *alias, uint32_t uid, uint32_t userId, struct HksUpgradeFileTransferInfo *info)
+{
+    InitDefaultStrategy(alias, info);
+    for (uint32_t i = 0; i < HKS_ARRAY_SIZE(SA_SKIP_UPGRADE_CFG_LIST); ++i) {
+        if (uid == SA_SKIP_UPGRADE_CFG_LIST[i]) {
+            info->skipTransfer = true;
+            return;
+        }
+    }
+    for (uint32_t i = 0; i < HKS_ARRAY_SIZE(SA_UPGRADE_CFG_LIST); ++i) {
+        if (SA_UPGRADE_CFG_LIST[i].uid == uid) {
+            info->needDe = SA_UPGRADE_CFG_LIST[i].needDe;
+            info->needFrontUser = SA_UPGRADE_CFG_LIST[i].needFrontUser;
+            break;
+        }
+    }
+    info->uid = uid;
+    info->userId = userId;
+}
+
+void LinearMatchHapConfig(const char *alias, uint32_t uid, uint32_t userId, const char *hapName,
+    struct HksUpgradeFileTransferInfo *info)
+{
+    InitDefaultStrategy(alias, info);
+    for (uint32_t i = 0; i < HKS_ARRAY_SIZE(HAP_SKIP_UPGRADE_CFG_LIST); ++i) {
+        if (strcmp(HAP_SKIP_UPGRADE_CFG_LIST[i], hapName) == 0) {
+            info->skipTransfer = true;
+            return;
+        }
+    }
+    for (uint32_t i = 0; i < HKS_ARRAY_SIZE(HAP_UPGRADE_CFG_LIST); ++i) {
+        if (strcmp(HAP_UPGRADE_CFG_LIST[i].hapName, hapName) == 0) {
+            info->needDe = HAP_UPGRADE_CFG_LIST[i].needDe;
+            info->needFrontUser = HAP_UPGRADE_CFG_LIST[i].needFrontUser;
+            break;
+        }
+    }
+    info->uid = uid;
+    info->userId = userId;
+}
+
+void ExpectSameInfo(const struct HksUpgradeFileTransferInfo &expect, const struct HksUpgradeFileTransferInfo &info)
+{
+    EXPECT_EQ(expect.skipTransfer, info.skipTransfer);
+    EXPECT_EQ(expect.needDe, info.needDe);
+    EXPECT_EQ(expect.needFrontUser, info.needFrontUser);
+    EXPECT_EQ(expect.uid, info.uid);
+    EXPECT_EQ(expect.userId, info.userId);
+}
+
+const char * const TEST_ALIASES[] = { "", "key_alias", "DistributedDataRdb_key", "distributeddb_client_root_key" };
+}  // namespace
+
 class HksServiceUpgradeConfigParserTest : public testing::Test {
 public:
     static void SetUpTestCase(void);
@@ -629,4 +695,116 @@ HWTEST_F(HksServiceUpgradeConfigParserTest, HksServiceUpgradeConfigParserTest013
 
     HksFreeParamSet(&paramSet013);
 }
+
+/**
+ * @tc.name: HksServiceUpgradeConfigParserTest.HksServiceUpgradeConfigParserTest014
+ * @tc.desc: test HksParseConfig queries the owner of an accessTokenId once while the token cache is on
+ * @tc.type: FUNC
+ */
+HWTEST_F(HksServiceUpgradeConfigParserTest, HksServiceUpgradeConfigParserTest014, TestSize.Level0)
+{
+    HKS_LOG_I("enter HksServiceUpgradeConfigParserTest014");
+    g_hapName = const_cast<char *>("com.example.demo2");
+    g_accessTokenType = HKS_TOKEN_HAP;
+    struct HksParamSet *paramSet014 = nullptr;
+    (void)HksInitParamSet(&paramSet014);
+    uint32_t uid014 = 20020014;
+    struct HksParam params[] = {
+        {
+            .tag = HKS_TAG_PROCESS_NAME,
+            .blob = {
+                .data = reinterpret_cast<uint8_t *>(&uid014),
+                .size = sizeof(uint32_t)
+            }
+        }, {
+            .tag = HKS_TAG_USER_ID,
+            .uint32Param = 100
+        }, {
+            .tag = HKS_TAG_ACCESS_TOKEN_ID,
+            .uint64Param = 14
+        }
+    };
+    (void)HksAddParams(paramSet014, params, HKS_ARRAY_SIZE(params));
+    (void)HksBuildParamSet(&paramSet014);
+    struct HksBlob fileContent = { .data = reinterpret_cast<uint8_t *>(paramSet014),
+        .size = paramSet014->paramSetSize };
+    struct HksUpgradeFileTransferInfo info = { 0 };
+
+    g_hapNameQueryCount = 0;
+    HksConfigTokenCacheInit();
+    for (uint32_t i = 0; i < 3; ++i) {
+        EXPECT_EQ(HKS_SUCCESS, HksParseConfig("", &fileContent, &info));
+        EXPECT_EQ(true, info.needDe);
+        EXPECT_EQ(false, info.needFrontUser);
+    }
+    EXPECT_EQ(1u, g_hapNameQueryCount);
+    HksConfigTokenCacheDestroy();
+
+    EXPECT_EQ(HKS_SUCCESS, HksParseConfig("", &fileContent, &info));
+    EXPECT_EQ(2u, g_hapNameQueryCount);
+
+    HksFreeParamSet(&paramSet014);
+}
+
+/**
+ * @tc.name: HksServiceUpgradeConfigParserTest.HksServiceUpgradeConfigParserTest015
+ * @tc.desc: test the sa policy table gives the same result as scanning the sa config lists for every uid around them
+ * @tc.type: FUNC
+ */
+HWTEST_F(HksServiceUpgradeConfigParserTest, HksServiceUpgradeConfigParserTest015, TestSize.Level0)
+{
+    HKS_LOG_I("enter HksServiceUpgradeConfigParserTest015");
+    const uint32_t maxUid = 128;
+    for (const char *alias : TEST_ALIASES) {
+        for (uint32_t uid = 0; uid < maxUid; ++uid) {
+            struct HksUpgradeFileTransferInfo expect = { 0 };
+            struct HksUpgradeFileTransferInfo info = { 0 };
+            LinearMatchSaConfig(alias, uid, uid + 1, &expect);
+            EXPECT_EQ(HKS_SUCCESS, MatchSaConfig(alias, uid, uid + 1, &info));
+            ExpectSameInfo(expect, info);
+        }
+    }
+    struct HksUpgradeFileTransferInfo info = { 0 };
+    EXPECT_EQ(HKS_SUCCESS, MatchSaConfig("", 10, 0, &info));
+    EXPECT_EQ(true, info.skipTransfer);
+    EXPECT_EQ(HKS_SUCCESS, MatchSaConfig("", 9, 0, &info));
+    EXPECT_EQ(true, info.needDe);
+    EXPECT_EQ(true, info.needFrontUser);
+}
+
+/**
+ * @tc.name: HksServiceUpgradeConfigParserTest.HksServiceUpgradeConfigParserTest016
+ * @tc.desc: test the hap policy table gives the same result as scanning the hap config lists, for configured names,
+ *           their prefixes and extensions, and unknown names
+ * @tc.type: FUNC
+ */
+HWTEST_F(HksServiceUpgradeConfigParserTest, HksServiceUpgradeConfigParserTest016, TestSize.Level0)
+{
+    HKS_LOG_I("enter HksServiceUpgradeConfigParserTest016");
+    std::vector<std::string> hapNames = { "", "com", "com.example.demo", "com.example.demo5", "com.unknown" };
+    for (uint32_t i = 0; i < HKS_ARRAY_SIZE(HAP_SKIP_UPGRADE_CFG_LIST); ++i) {
+        hapNames.emplace_back(HAP_SKIP_UPGRADE_CFG_LIST[i]);
+    }
+    for (uint32_t i = 0; i < HKS_ARRAY_SIZE(HAP_UPGRADE_CFG_LIST); ++i) {
+        std::string name = HAP_UPGRADE_CFG_LIST[i].hapName;
+        hapNames.emplace_back(name);
+        hapNames.emplace_back(name.substr(0, name.size() - 1));
+        hapNames.emplace_back(name + "0");
+    }
+    for (const char *alias : TEST_ALIASES) {
+        for (const std::string &hapName : hapNames) {
+            struct HksUpgradeFileTransferInfo expect = { 0 };
+            struct HksUpgradeFileTransferInfo info = { 0 };
+            LinearMatchHapConfig(alias, 20020016, 100, hapName.c_str(), &expect);
+            EXPECT_EQ(HKS_SUCCESS, MatchHapConfig(alias, 20020016, 100, hapName.c_str(), &info));
+            ExpectSameInfo(expect, info);
+        }
+    }
+    struct HksUpgradeFileTransferInfo info = { 0 };
+    EXPECT_EQ(HKS_SUCCESS, MatchHapConfig("", 0, 0, "com.example.skip2", &info));
+    EXPECT_EQ(true, info.skipTransfer);
+    EXPECT_EQ(HKS_SUCCESS, MatchHapConfig("", 0, 0, "com.example.demo4", &info));
+    EXPECT_EQ(false, info.needDe);
+    EXPECT_EQ(false, info.needFrontUser);
+}
 }
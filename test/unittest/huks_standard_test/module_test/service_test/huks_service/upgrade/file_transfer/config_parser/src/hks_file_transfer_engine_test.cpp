@@ -0,0 +1,193 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <iostream>
+#include <string>
+
+#include "hks_at_api_wrap.h"
+#include "hks_file_operator.h"
+#include "hks_file_transfer.h"
+#include "hks_log.h"
+#include "hks_param.h"
+#include "hks_type_inner.h"
+
+/* mocks of the access token service, defined in hks_config_parser_test.cpp */
+extern enum HksAtType g_accessTokenType;
+extern uint32_t g_atTypeQueryCount;
+
+using namespace testing::ext;
+namespace Unittest::HksFileTransferEngineTest {
+namespace {
+/* in the test config sa 8 moves to de without the front user and sa 10 is skipped, see hks_config_parser_test.cpp */
+const uint32_t DE_SA_UID = 8;
+const uint32_t SKIP_SA_UID = 10;
+const uint32_t TEST_USER_BASE = 20000;
+const uint32_t BENCH_USER_COUNT = 100;
+const uint32_t BENCH_KEY_COUNT = 1000; /* 100 owners * 1000 keys = 100k key files */
+const std::string JOURNAL_PATH = std::string(HKS_KEY_STORE_TMP_PATH) + ".journal";
+
+std::string SourceDir(uint32_t userId, uint32_t uid)
+{
+    return std::string(HKS_KEY_STORE_TMP_PATH) + "/" + std::to_string(userId) + "/" + std::to_string(uid) + "/key";
+}
+
+std::string DestDir(uint32_t userId, uint32_t uid)
+{
+    return std::string(HKS_KEY_STORE_PATH) + "/" + std::to_string(userId) + "/" + std::to_string(uid) + "/key";
+}
+
+void MakeDirs(const std::string &path)
+{
+    for (size_t pos = path.find('/', 1); pos != std::string::npos; pos = path.find('/', pos + 1)) {
+        (void)HksMakeDir(path.substr(0, pos).c_str());
+    }
+    (void)HksMakeDir(path.c_str());
+}
+
+// writes keyCount key files owned by uid and userId, in the old de layout the transfer starts from
+void GenerateKeyTree(uint32_t userId, uint32_t uid, uint32_t keyCount)
+{
+    struct HksParamSet *paramSet = nullptr;
+    ASSERT_EQ(HksInitParamSet(&paramSet), HKS_SUCCESS);
+    struct HksParam params[] = {
+        { .tag = HKS_TAG_PROCESS_NAME, .blob = { sizeof(uid), reinterpret_cast<uint8_t *>(&uid) } },
+        { .tag = HKS_TAG_USER_ID, .uint32Param = userId },
+        { .tag = HKS_TAG_ACCESS_TOKEN_ID, .uint64Param = userId },
+    };
+    ASSERT_EQ(HksAddParams(paramSet, params, HKS_ARRAY_SIZE(params)), HKS_SUCCESS);
+    ASSERT_EQ(HksBuildParamSet(&paramSet), HKS_SUCCESS);
+
+    std::string dir = SourceDir(userId, uid);
+    MakeDirs(dir);
+    for (uint32_t i = 0; i < keyCount; ++i) {
+        std::string alias = "key_" + std::to_string(i);
+        ASSERT_EQ(HksFileWrite(dir.c_str(), alias.c_str(), 0, reinterpret_cast<uint8_t *>(paramSet),
+            paramSet->paramSetSize), HKS_SUCCESS);
+    }
+    HksFreeParamSet(&paramSet);
+}
+
+uint32_t CountFiles(const std::string &dir)
+{
+    uint32_t count = 0;
+    void *dirp = HksOpenDir(dir.c_str());
+    if (dirp == nullptr) {
+        return 0;
+    }
+    struct HksFileDirentInfo dire = {{ 0 }};
+    while (HksGetDirFile(dirp, &dire) == HKS_SUCCESS) {
+        ++count;
+    }
+    (void)HksCloseDir(dirp);
+    return count;
+}
+
+void RemoveUser(uint32_t userId)
+{
+    (void)HksDeleteDir((std::string(HKS_KEY_STORE_TMP_PATH) + "/" + std::to_string(userId)).c_str());
+    (void)HksDeleteDir((std::string(HKS_KEY_STORE_PATH) + "/" + std::to_string(userId)).c_str());
+}
+}  // namespace
+
+class HksFileTransferEngineTest : public testing::Test {
+public:
+    void SetUp() override
+    {
+        g_accessTokenType = HKS_TOKEN_NATIVE;
+        (void)HksFileRemove(nullptr, JOURNAL_PATH.c_str());
+    }
+
+    void TearDown() override
+    {
+        for (uint32_t i = 0; i < BENCH_USER_COUNT; ++i) {
+            RemoveUser(TEST_USER_BASE + i);
+        }
+        (void)HksFileRemove(nullptr, JOURNAL_PATH.c_str());
+    }
+};
+
+/**
+ * @tc.name: HksFileTransferEngineTest.HksFileTransferEngineTest001
+ * @tc.desc: every key file of several owners is moved to its de directory and the source directories are emptied
+ * @tc.type: FUNC
+ */
+HWTEST_F(HksFileTransferEngineTest, HksFileTransferEngineTest001, TestSize.Level0)
+{
+    const uint32_t userCount = 5;
+    const uint32_t keyCount = 150; /* more than two batches per directory */
+    for (uint32_t i = 0; i < userCount; ++i) {
+        GenerateKeyTree(TEST_USER_BASE + i, DE_SA_UID, keyCount);
+    }
+
+    EXPECT_EQ(UpgradeFileTransfer(), HKS_SUCCESS);
+
+    for (uint32_t i = 0; i < userCount; ++i) {
+        EXPECT_EQ(CountFiles(SourceDir(TEST_USER_BASE + i, DE_SA_UID)), 0u);
+        EXPECT_EQ(CountFiles(DestDir(TEST_USER_BASE + i, DE_SA_UID)), keyCount);
+    }
+}
+
+/**
+ * @tc.name: HksFileTransferEngineTest.HksFileTransferEngineTest002
+ * @tc.desc: a directory whose files are all skipped by config is journaled and not parsed again on the next run
+ * @tc.type: FUNC
+ */
+HWTEST_F(HksFileTransferEngineTest, HksFileTransferEngineTest002, TestSize.Level0)
+{
+    const uint32_t keyCount = 10;
+    GenerateKeyTree(TEST_USER_BASE, SKIP_SA_UID, keyCount);
+
+    g_atTypeQueryCount = 0;
+    EXPECT_EQ(UpgradeFileTransfer(), HKS_SUCCESS);
+    EXPECT_EQ(CountFiles(SourceDir(TEST_USER_BASE, SKIP_SA_UID)), keyCount);
+    uint32_t firstRunQueries = g_atTypeQueryCount;
+    EXPECT_GE(firstRunQueries, keyCount);
+
+    EXPECT_EQ(UpgradeFileTransfer(), HKS_SUCCESS);
+    EXPECT_LE(g_atTypeQueryCount - firstRunQueries, firstRunQueries - keyCount);
+
+    /* a changed directory no longer matches its journal line */
+    GenerateKeyTree(TEST_USER_BASE, SKIP_SA_UID, keyCount + 1);
+    uint32_t secondRunQueries = g_atTypeQueryCount;
+    EXPECT_EQ(UpgradeFileTransfer(), HKS_SUCCESS);
+    EXPECT_GE(g_atTypeQueryCount - secondRunQueries, keyCount + 1);
+}
+
+/**
+ * @tc.name: HksFileTransferEngineTest.HksFileTransferEngineTest003
+ * @tc.desc: wall time to transfer a generated tree of 100k key files
+ * @tc.type: PERF
+ */
+HWTEST_F(HksFileTransferEngineTest, HksFileTransferEngineTest003, TestSize.Level1)
+{
+    for (uint32_t i = 0; i < BENCH_USER_COUNT; ++i) {
+        GenerateKeyTree(TEST_USER_BASE + i, DE_SA_UID, BENCH_KEY_COUNT);
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    EXPECT_EQ(UpgradeFileTransfer(), HKS_SUCCESS);
+    double cost = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    uint32_t moved = 0;
+    for (uint32_t i = 0; i < BENCH_USER_COUNT; ++i) {
+        moved += CountFiles(DestDir(TEST_USER_BASE + i, DE_SA_UID));
+    }
+    EXPECT_EQ(moved, BENCH_USER_COUNT * BENCH_KEY_COUNT);
+    std::cout << "transfer " << moved << " key files: " << cost << " ms" << std::endl;
+}
+}
@@ -22,6 +22,9 @@
 #include "hks_mem.h"
 #include "hks_param.h"
 #include "hks_type.h"
+#ifdef HKS_ENABLE_UPGRADE_KEY
+#include "hks_upgrade_key_scheduler.h"
+#endif
 
 #include "hks_test_modify_old_key.h"
 
@@ -271,4 +274,43 @@ HWTEST_F(HksUpgradeKeyTest, HksUpgradeKeyTest001, TestSize.Level0)
 
     (void)HksDeleteKey(&keyAliasTest001, nullptr);
 }
+
+#ifdef HKS_ENABLE_UPGRADE_KEY
+/**
+ * @tc.name: HksUpgradeKeyTest.HksUpgradeKeyTest002
+ * @tc.desc: the background scheduler upgrades every old key file of a store before any of them is used
+ * @tc.type: FUNC
+ */
+HWTEST_F(HksUpgradeKeyTest, HksUpgradeKeyTest002, TestSize.Level0)
+{
+    const uint32_t keyCount = 3;
+    const uint32_t waitMs = 10000;
+    std::string aliases[keyCount];
+    for (uint32_t i = 0; i < keyCount; ++i) {
+        aliases[i] = std::string(KEY_ALIAS) + "_scheduler_" + std::to_string(i);
+        struct HksBlob keyAlias = {
+            .size = static_cast<uint32_t>(aliases[i].size()), .data = (uint8_t *)aliases[i].c_str() };
+        ASSERT_EQ(TestGenerateOldkey(&keyAlias, GEN_AES_PARAMS, HKS_ARRAY_SIZE(GEN_AES_PARAMS)), HKS_SUCCESS);
+    }
+    HksChangeOldKeyOwner(HKS_CONFIG_KEY_STORE_PATH "/maindata", HUKS_UID);
+
+    OHOS::Security::Hks::HksUpgradeKeySchedulerStats before = { 0 };
+    OHOS::Security::Hks::HksUpgradeKeySchedulerGetStats(before);
+    OHOS::Security::Hks::HksUpgradeKeySchedulerSetConfig({ 0, 0, 0 });
+    OHOS::Security::Hks::HksUpgradeKeySchedulerAddStore(HKS_CONFIG_KEY_STORE_PATH "/maindata",
+        HKS_CONFIG_KEY_STORE_PATH "/bakdata");
+    ASSERT_TRUE(OHOS::Security::Hks::HksUpgradeKeySchedulerWaitDone(waitMs));
+
+    OHOS::Security::Hks::HksUpgradeKeySchedulerStats after = { 0 };
+    OHOS::Security::Hks::HksUpgradeKeySchedulerGetStats(after);
+    EXPECT_EQ(after.pendingStoreCount, 0u);
+    EXPECT_GE(after.upgradedCount - before.upgradedCount, keyCount);
+    for (uint32_t i = 0; i < keyCount; ++i) {
+        struct HksBlob keyAlias = {
+            .size = static_cast<uint32_t>(aliases[i].size()), .data = (uint8_t *)aliases[i].c_str() };
+        EXPECT_EQ(TestCheckKeyVersionIsExpected(&keyAlias, REAL_HKS_KEY_VERSION), HKS_SUCCESS);
+        (void)HksDeleteKey(&keyAlias, nullptr);
+    }
+}
+#endif
 }
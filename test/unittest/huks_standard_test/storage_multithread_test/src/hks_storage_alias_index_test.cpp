@@ -0,0 +1,186 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <fcntl.h>
+#include <string>
+#include <sys/stat.h>
+#include <vector>
+
+#include "hks_config.h"
+#include "hks_file_operator.h"
+#include "hks_storage_alias_index.h"
+#include "hks_type.h"
+
+using namespace testing::ext;
+
+namespace {
+const std::string TEST_DIR = std::string(HKS_KEY_STORE_PATH) + "/alias_index_test";
+const std::string TEST_INDEX = TEST_DIR + HKS_ALIAS_INDEX_SUFFIX;
+constexpr uint8_t TEST_BLOB[] = { 0x01, 0x02, 0x03, 0x04 };
+
+std::vector<std::string> ToVector(const struct HksAliasIndexList &list)
+{
+    std::vector<std::string> names;
+    const char *name = list.names;
+    for (uint32_t i = 0; i < list.count; ++i) {
+        names.emplace_back(name);
+        name += strlen(name) + 1;
+    }
+    return names;
+}
+
+std::vector<std::string> GetNames()
+{
+    struct HksAliasIndexList list;
+    EXPECT_EQ(HksAliasIndexGetList(TEST_DIR.c_str(), &list), HKS_SUCCESS);
+    std::vector<std::string> names = ToVector(list);
+    HksAliasIndexFreeList(&list);
+    return names;
+}
+
+void StoreFile(const char *name)
+{
+    struct HksAliasIndexUpdate update;
+    HksAliasIndexBeginUpdate(TEST_DIR.c_str(), &update);
+    int32_t ret = HksFileWrite(TEST_DIR.c_str(), name, 0, TEST_BLOB, sizeof(TEST_BLOB));
+    HksAliasIndexEndUpdate(&update, name, true, ret == HKS_SUCCESS);
+    EXPECT_EQ(ret, HKS_SUCCESS);
+}
+
+void DeleteFile(const char *name)
+{
+    struct HksAliasIndexUpdate update;
+    HksAliasIndexBeginUpdate(TEST_DIR.c_str(), &update);
+    int32_t ret = HksFileRemove(TEST_DIR.c_str(), name);
+    HksAliasIndexEndUpdate(&update, name, false, ret == HKS_SUCCESS);
+    EXPECT_EQ(ret, HKS_SUCCESS);
+}
+}  // namespace
+
+class HksStorageAliasIndexTest : public testing::Test {
+public:
+    void SetUp() override
+    {
+        (void)HksDeleteDir(TEST_DIR.c_str());
+        (void)HksFileRemove(nullptr, TEST_INDEX.c_str());
+        (void)HksMakeDir(HKS_KEY_STORE_PATH);
+        EXPECT_EQ(HksMakeDir(TEST_DIR.c_str()), HKS_SUCCESS);
+    }
+
+    void TearDown() override
+    {
+        (void)HksDeleteDir(TEST_DIR.c_str());
+        (void)HksFileRemove(nullptr, TEST_INDEX.c_str());
+    }
+};
+
+/**
+ * @tc.name: HksStorageAliasIndexTest.HksStorageAliasIndexTest001
+ * @tc.desc: without an index the names come from a scan, sorted, and the index is written for the next call
+ * @tc.type: FUNC
+ */
+HWTEST_F(HksStorageAliasIndexTest, HksStorageAliasIndexTest001, TestSize.Level0)
+{
+    for (const char *name : { "gamma", "alpha", "beta" }) {
+        ASSERT_EQ(HksFileWrite(TEST_DIR.c_str(), name, 0, TEST_BLOB, sizeof(TEST_BLOB)), HKS_SUCCESS);
+    }
+    EXPECT_NE(HksIsFileExist(nullptr, TEST_INDEX.c_str()), HKS_SUCCESS);
+
+    std::vector<std::string> expect = { "alpha", "beta", "gamma" };
+    EXPECT_EQ(GetNames(), expect);
+    EXPECT_EQ(HksIsFileExist(nullptr, TEST_INDEX.c_str()), HKS_SUCCESS);
+
+    uint32_t count = 0;
+    EXPECT_EQ(HksAliasIndexGetCount(TEST_DIR.c_str(), &count), HKS_SUCCESS);
+    EXPECT_EQ(count, expect.size());
+}
+
+/**
+ * @tc.name: HksStorageAliasIndexTest.HksStorageAliasIndexTest002
+ * @tc.desc: stores and deletes patch a fresh index in place, the directory is never scanned again
+ * @tc.type: FUNC
+ */
+HWTEST_F(HksStorageAliasIndexTest, HksStorageAliasIndexTest002, TestSize.Level0)
+{
+    EXPECT_TRUE(GetNames().empty());
+    StoreFile("key_b");
+    StoreFile("key_a");
+    StoreFile("key_c");
+    StoreFile("key_a");
+    DeleteFile("key_b");
+
+    struct HksAliasIndexUpdate update;
+    HksAliasIndexBeginUpdate(TEST_DIR.c_str(), &update);
+    EXPECT_TRUE(update.isFresh);
+    std::vector<std::string> expect = { "key_a", "key_c" };
+    EXPECT_EQ(ToVector(update.list), expect);
+    HksAliasIndexEndUpdate(&update, "key_d", true, false);
+
+    EXPECT_EQ(GetNames(), expect);
+}
+
+/**
+ * @tc.name: HksStorageAliasIndexTest.HksStorageAliasIndexTest003
+ * @tc.desc: files written behind the index and a corrupted index are both detected and rebuilt from a scan
+ * @tc.type: FUNC
+ */
+HWTEST_F(HksStorageAliasIndexTest, HksStorageAliasIndexTest003, TestSize.Level0)
+{
+    StoreFile("key_a");
+    EXPECT_EQ(GetNames().size(), 1u);
+
+    ASSERT_EQ(HksFileWrite(TEST_DIR.c_str(), "key_z", 0, TEST_BLOB, sizeof(TEST_BLOB)), HKS_SUCCESS);
+    std::vector<std::string> expect = { "key_a", "key_z" };
+    EXPECT_EQ(GetNames(), expect);
+
+    uint32_t size = HksFileSize(nullptr, TEST_INDEX.c_str());
+    ASSERT_GT(size, 0u);
+    std::vector<uint8_t> content(size);
+    struct HksBlob blob = { size, content.data() };
+    ASSERT_EQ(HksFileRead(nullptr, TEST_INDEX.c_str(), 0, &blob, &size), HKS_SUCCESS);
+    content[size - 2] ^= 0xff;
+    ASSERT_EQ(HksFileWrite(nullptr, TEST_INDEX.c_str(), 0, content.data(), size), HKS_SUCCESS);
+
+    EXPECT_EQ(GetNames(), expect);
+}
+
+/**
+ * @tc.name: HksStorageAliasIndexTest.HksStorageAliasIndexTest004
+ * @tc.desc: a file added in the same mtime tick as the index is missed until the writer invalidates the index
+ * @tc.type: FUNC
+ */
+HWTEST_F(HksStorageAliasIndexTest, HksStorageAliasIndexTest004, TestSize.Level0)
+{
+    StoreFile("key_a");
+    EXPECT_EQ(GetNames().size(), 1u);
+
+    struct stat dirStat;
+    ASSERT_EQ(stat(TEST_DIR.c_str(), &dirStat), 0);
+    ASSERT_EQ(HksFileWrite(TEST_DIR.c_str(), "key_z", 0, TEST_BLOB, sizeof(TEST_BLOB)), HKS_SUCCESS);
+    struct timespec times[] = { dirStat.st_atim, dirStat.st_mtim };
+    ASSERT_EQ(utimensat(AT_FDCWD, TEST_DIR.c_str(), times, 0), 0);
+    EXPECT_EQ(GetNames().size(), 1u);
+
+    HksAliasIndexInvalidate(TEST_DIR.c_str());
+    EXPECT_NE(HksIsFileExist(nullptr, TEST_INDEX.c_str()), HKS_SUCCESS);
+    std::vector<std::string> expect = { "key_a", "key_z" };
+    EXPECT_EQ(GetNames(), expect);
+
+    HksAliasIndexInvalidate(TEST_DIR.c_str());
+    HksAliasIndexInvalidate(nullptr);
+    EXPECT_EQ(GetNames(), expect);
+}
@@ -0,0 +1,216 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <cstdio>
+#include <dirent.h>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include "hks_config.h"
+#include "hks_file_operator.h"
+#include "hks_type.h"
+
+using namespace testing::ext;
+
+namespace {
+const std::string TEST_ROOT = std::string(HKS_KEY_STORE_PATH) + "/delete_dir_test";
+const std::string TEST_USER = TEST_ROOT + "/user";
+constexpr uint8_t TEST_BLOB[] = { 0x01, 0x02, 0x03, 0x04 };
+constexpr uint32_t BENCH_UID_COUNT = 50;
+constexpr uint32_t BENCH_KEY_COUNT = 1000; /* 50 uids * 1000 keys = 50k key files */
+constexpr uint32_t TRASH_WAIT_MS = 10;
+constexpr uint32_t TRASH_WAIT_ROUNDS = 3000;
+
+void MakeUser(uint32_t uidCount, uint32_t keyCount)
+{
+    ASSERT_EQ(HksMakeDir(TEST_USER.c_str()), HKS_SUCCESS);
+    for (uint32_t u = 0; u < uidCount; ++u) {
+        std::string uidPath = TEST_USER + "/uid" + std::to_string(u);
+        ASSERT_EQ(HksMakeDir(uidPath.c_str()), HKS_SUCCESS);
+        for (uint32_t k = 0; k < keyCount; ++k) {
+            std::string name = "key" + std::to_string(k);
+            ASSERT_EQ(HksFileWrite(uidPath.c_str(), name.c_str(), 0, TEST_BLOB, sizeof(TEST_BLOB)), HKS_SUCCESS);
+        }
+    }
+}
+
+/* the deletion HksDeleteDir did before: a full path string and a path based remove per entry */
+void DeleteByPath(const std::string &path)
+{
+    DIR *dir = opendir(path.c_str());
+    ASSERT_NE(dir, nullptr);
+    struct dirent *dire = readdir(dir);
+    while (dire != nullptr) {
+        std::string name = dire->d_name;
+        if (name != "." && name != "..") {
+            std::string entryPath = path + "/" + name;
+            if (dire->d_type == DT_DIR) {
+                DeleteByPath(entryPath);
+            } else {
+                (void)remove(entryPath.c_str());
+            }
+        }
+        dire = readdir(dir);
+    }
+    closedir(dir);
+    (void)remove(path.c_str());
+}
+
+uint32_t CountTrash(const std::string &path)
+{
+    uint32_t count = 0;
+    DIR *dir = opendir(path.c_str());
+    if (dir == nullptr) {
+        return 0;
+    }
+    for (struct dirent *dire = readdir(dir); dire != nullptr; dire = readdir(dir)) {
+        if (strncmp(dire->d_name, HKS_DIR_TRASH_PREFIX, strlen(HKS_DIR_TRASH_PREFIX)) == 0) {
+            ++count;
+        }
+    }
+    closedir(dir);
+    return count;
+}
+
+bool WaitTrashGone(const std::string &path = TEST_ROOT)
+{
+    for (uint32_t i = 0; i < TRASH_WAIT_ROUNDS; ++i) {
+        if (CountTrash(path) == 0) {
+            return true;
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(TRASH_WAIT_MS));
+    }
+    return false;
+}
+
+double Milliseconds(std::chrono::steady_clock::duration cost)
+{
+    return std::chrono::duration<double, std::milli>(cost).count();
+}
+}  // namespace
+
+class HksStorageDeleteDirTest : public testing::Test {
+public:
+    void SetUp() override
+    {
+        (void)HksDeleteDir(TEST_ROOT.c_str());
+        (void)HksMakeDir(HKS_KEY_STORE_PATH);
+        EXPECT_EQ(HksMakeDir(TEST_ROOT.c_str()), HKS_SUCCESS);
+    }
+
+    void TearDown() override
+    {
+        (void)WaitTrashGone();
+        (void)HksDeleteDir(TEST_ROOT.c_str());
+    }
+};
+
+/**
+ * @tc.name: HksStorageDeleteDirTest.HksStorageDeleteDirTest001
+ * @tc.desc: HksDeleteDir removes a nested user tree, a missing directory fails to open
+ * @tc.type: FUNC
+ */
+HWTEST_F(HksStorageDeleteDirTest, HksStorageDeleteDirTest001, TestSize.Level0)
+{
+    MakeUser(3, 4);
+    std::string deepPath = TEST_USER + "/uid0/a";
+    ASSERT_EQ(HksMakeDir(deepPath.c_str()), HKS_SUCCESS);
+    ASSERT_EQ(HksFileWrite(deepPath.c_str(), "key", 0, TEST_BLOB, sizeof(TEST_BLOB)), HKS_SUCCESS);
+
+    EXPECT_EQ(HksDeleteDir(TEST_USER.c_str()), HKS_SUCCESS);
+    EXPECT_NE(HksIsDirExist(TEST_USER.c_str()), HKS_SUCCESS);
+    EXPECT_EQ(HksDeleteDir(TEST_USER.c_str()), HKS_ERROR_OPEN_FILE_FAIL);
+}
+
+/**
+ * @tc.name: HksStorageDeleteDirTest.HksStorageDeleteDirTest002
+ * @tc.desc: HksDeleteDirAsync moves the tree away at once, the trash and leftovers of earlier runs are removed later
+ * @tc.type: FUNC
+ */
+HWTEST_F(HksStorageDeleteDirTest, HksStorageDeleteDirTest002, TestSize.Level0)
+{
+    std::string leftover = TEST_ROOT + "/" + HKS_DIR_TRASH_PREFIX + "leftover";
+    ASSERT_EQ(HksMakeDir(leftover.c_str()), HKS_SUCCESS);
+    ASSERT_EQ(HksFileWrite(leftover.c_str(), "key", 0, TEST_BLOB, sizeof(TEST_BLOB)), HKS_SUCCESS);
+    MakeUser(3, 4);
+
+    EXPECT_EQ(HksDeleteDirAsync(TEST_USER.c_str()), HKS_SUCCESS);
+    EXPECT_NE(HksIsDirExist(TEST_USER.c_str()), HKS_SUCCESS);
+    MakeUser(1, 1);
+    EXPECT_EQ(HksDeleteDirAsync(TEST_USER.c_str()), HKS_SUCCESS);
+
+    EXPECT_TRUE(WaitTrashGone());
+    EXPECT_EQ(HksDeleteDirAsync(TEST_USER.c_str()), HKS_ERROR_OPEN_FILE_FAIL);
+}
+
+/**
+ * @tc.name: HksStorageDeleteDirTest.HksStorageDeleteDirTest003
+ * @tc.desc: wall time to delete a user with 50k key files: path based, dirfd based, and the caller side of async
+ * @tc.type: PERF
+ */
+HWTEST_F(HksStorageDeleteDirTest, HksStorageDeleteDirTest003, TestSize.Level1)
+{
+    MakeUser(BENCH_UID_COUNT, BENCH_KEY_COUNT);
+    auto start = std::chrono::steady_clock::now();
+    DeleteByPath(TEST_USER);
+    double byPath = Milliseconds(std::chrono::steady_clock::now() - start);
+    ASSERT_NE(HksIsDirExist(TEST_USER.c_str()), HKS_SUCCESS);
+
+    MakeUser(BENCH_UID_COUNT, BENCH_KEY_COUNT);
+    start = std::chrono::steady_clock::now();
+    EXPECT_EQ(HksDeleteDir(TEST_USER.c_str()), HKS_SUCCESS);
+    double byDirFd = Milliseconds(std::chrono::steady_clock::now() - start);
+
+    MakeUser(BENCH_UID_COUNT, BENCH_KEY_COUNT);
+    start = std::chrono::steady_clock::now();
+    EXPECT_EQ(HksDeleteDirAsync(TEST_USER.c_str()), HKS_SUCCESS);
+    double asyncReturn = Milliseconds(std::chrono::steady_clock::now() - start);
+    EXPECT_TRUE(WaitTrashGone());
+
+    std::cout << "delete user with " << BENCH_UID_COUNT * BENCH_KEY_COUNT << " key files: path based " << byPath <<
+        " ms, dirfd based " << byDirFd << " ms, async returns after " << asyncReturn << " ms" << std::endl;
+}
+
+/**
+ * @tc.name: HksStorageDeleteDirTest.HksStorageDeleteDirTest004
+ * @tc.desc: HksSweepDirTrashAsync removes the trash a crash left in a store root and in its subdirectories, and
+ *           nothing else
+ * @tc.type: FUNC
+ */
+HWTEST_F(HksStorageDeleteDirTest, HksStorageDeleteDirTest004, TestSize.Level0)
+{
+    MakeUser(2, 2);
+    const std::string uidPath = TEST_USER + "/uid0";
+    const std::string trashPaths[] = { TEST_ROOT + "/" + HKS_DIR_TRASH_PREFIX + "0",
+        TEST_USER + "/" + HKS_DIR_TRASH_PREFIX + "1", uidPath + "/" + HKS_DIR_TRASH_PREFIX + "2" };
+    for (const std::string &trashPath : trashPaths) {
+        ASSERT_EQ(HksMakeDir(trashPath.c_str()), HKS_SUCCESS);
+        ASSERT_EQ(HksFileWrite(trashPath.c_str(), "key", 0, TEST_BLOB, sizeof(TEST_BLOB)), HKS_SUCCESS);
+    }
+
+    EXPECT_EQ(HksSweepDirTrashAsync(TEST_ROOT.c_str(), true), HKS_SUCCESS);
+    EXPECT_TRUE(WaitTrashGone(TEST_ROOT));
+    EXPECT_TRUE(WaitTrashGone(TEST_USER));
+    EXPECT_EQ(CountTrash(uidPath), 1u);
+    EXPECT_EQ(HksIsFileExist(uidPath.c_str(), "key0"), HKS_SUCCESS);
+
+    EXPECT_EQ(HksSweepDirTrashAsync(uidPath.c_str(), false), HKS_SUCCESS);
+    EXPECT_TRUE(WaitTrashGone(uidPath));
+    EXPECT_EQ(HksIsFileExist(uidPath.c_str(), "key1"), HKS_SUCCESS);
+}
@@ -0,0 +1,146 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "hks_config.h"
+#include "hks_file_operator.h"
+#include "hks_mem.h"
+#include "hks_storage_key_cache.h"
+#include "hks_type.h"
+
+using namespace testing::ext;
+
+namespace {
+const std::string TEST_DIR = std::string(HKS_KEY_STORE_PATH) + "/key_cache_test";
+const std::string TEST_ECE_DIR = std::string(HKS_ECE_ROOT_PATH) + "/100/huks_service/key_cache_test";
+constexpr uint64_t TEST_TOKEN_ID = 0x1234;
+constexpr int32_t TEST_USER_ID = 100;
+constexpr uint32_t TEST_MAX_KEY_SIZE = 4096;
+
+struct HksProcessInfo MakeProcessInfo(uint64_t accessTokenId)
+{
+    struct HksProcessInfo processInfo = { { 0, nullptr }, { 0, nullptr }, TEST_USER_ID, 0, accessTokenId };
+    return processInfo;
+}
+
+int32_t GetKey(const std::string &dir, uint64_t accessTokenId, std::vector<uint8_t> &out)
+{
+    struct HksProcessInfo processInfo = MakeProcessInfo(accessTokenId);
+    struct HksBlob keyOut = { 0, nullptr };
+    uint64_t generation = 0;
+    int32_t ret = HksKeyCacheGetKey(dir.c_str(), "key_a", &processInfo, &keyOut, &generation);
+    out.assign(keyOut.data, keyOut.data + keyOut.size);
+    HKS_FREE_BLOB(keyOut);
+    return ret;
+}
+
+void FillKey(const std::string &dir, std::vector<uint8_t> &key)
+{
+    std::vector<uint8_t> out;
+    EXPECT_EQ(GetKey(dir, TEST_TOKEN_ID, out), HKS_ERROR_NOT_EXIST);
+    uint64_t generation = 0;
+    struct HksProcessInfo processInfo = MakeProcessInfo(TEST_TOKEN_ID);
+    (void)HksKeyCacheGetState(dir.c_str(), "key_a", &generation);
+    struct HksBlob keyBlob = { static_cast<uint32_t>(key.size()), key.data() };
+    HksKeyCacheFillKey(dir.c_str(), "key_a", &processInfo, &keyBlob, generation);
+}
+}  // namespace
+
+class HksStorageKeyCacheTest : public testing::Test {
+public:
+    void SetUp() override
+    {
+        HksKeyCacheClear();
+    }
+
+    void TearDown() override
+    {
+        HksKeyCacheClear();
+    }
+};
+
+/**
+ * @tc.name: HksStorageKeyCacheTest.HksStorageKeyCacheTest001
+ * @tc.desc: a filled state is returned until a writer sets another one, a fill older than that write is dropped
+ * @tc.type: FUNC
+ */
+HWTEST_F(HksStorageKeyCacheTest, HksStorageKeyCacheTest001, TestSize.Level0)
+{
+    uint64_t generation = 0;
+    EXPECT_EQ(HksKeyCacheGetState(TEST_DIR.c_str(), "key_a", &generation), HKS_KEY_CACHE_UNKNOWN);
+    HksKeyCacheFillState(TEST_DIR.c_str(), "key_a", false, generation);
+    EXPECT_EQ(HksKeyCacheGetState(TEST_DIR.c_str(), "key_a", &generation), HKS_KEY_CACHE_NOT_EXIST);
+
+    HksKeyCacheSetState(TEST_DIR.c_str(), "key_a", true);
+    EXPECT_EQ(HksKeyCacheGetState(TEST_DIR.c_str(), "key_a", &generation), HKS_KEY_CACHE_EXIST);
+
+    uint64_t staleGeneration = 0;
+    EXPECT_EQ(HksKeyCacheGetState(TEST_DIR.c_str(), "key_b", &staleGeneration), HKS_KEY_CACHE_UNKNOWN);
+    HksKeyCacheSetState(TEST_DIR.c_str(), "key_a", false);
+    HksKeyCacheFillState(TEST_DIR.c_str(), "key_b", true, staleGeneration);
+    EXPECT_EQ(HksKeyCacheGetState(TEST_DIR.c_str(), "key_b", &generation), HKS_KEY_CACHE_UNKNOWN);
+    EXPECT_EQ(HksKeyCacheGetState(TEST_DIR.c_str(), "key_a", &generation), HKS_KEY_CACHE_NOT_EXIST);
+
+    HksKeyCacheClear();
+    EXPECT_EQ(HksKeyCacheGetState(TEST_DIR.c_str(), "key_a", &generation), HKS_KEY_CACHE_UNKNOWN);
+}
+
+/**
+ * @tc.name: HksStorageKeyCacheTest.HksStorageKeyCacheTest002
+ * @tc.desc: a cached key file is only returned to the same caller, and a write of the key file drops it
+ * @tc.type: FUNC
+ */
+HWTEST_F(HksStorageKeyCacheTest, HksStorageKeyCacheTest002, TestSize.Level0)
+{
+    std::vector<uint8_t> key(TEST_MAX_KEY_SIZE / 2, 0x5a);
+    FillKey(TEST_DIR, key);
+
+    std::vector<uint8_t> out;
+    ASSERT_EQ(GetKey(TEST_DIR, TEST_TOKEN_ID, out), HKS_SUCCESS);
+    EXPECT_EQ(out, key);
+    uint64_t generation = 0;
+    EXPECT_EQ(HksKeyCacheGetState(TEST_DIR.c_str(), "key_a", &generation), HKS_KEY_CACHE_EXIST);
+
+    EXPECT_EQ(GetKey(TEST_DIR, TEST_TOKEN_ID + 1, out), HKS_ERROR_NOT_EXIST);
+
+    HksKeyCacheSetState(TEST_DIR.c_str(), "key_a", true);
+    EXPECT_EQ(GetKey(TEST_DIR, TEST_TOKEN_ID, out), HKS_ERROR_NOT_EXIST);
+}
+
+/**
+ * @tc.name: HksStorageKeyCacheTest.HksStorageKeyCacheTest003
+ * @tc.desc: key files of the ECE store and key files over the size limit are never cached
+ * @tc.type: FUNC
+ */
+HWTEST_F(HksStorageKeyCacheTest, HksStorageKeyCacheTest003, TestSize.Level0)
+{
+    uint64_t generation = 0;
+    EXPECT_EQ(HksKeyCacheGetState(TEST_ECE_DIR.c_str(), "key_a", &generation), HKS_KEY_CACHE_UNKNOWN);
+    HksKeyCacheSetState(TEST_ECE_DIR.c_str(), "key_a", true);
+    EXPECT_EQ(HksKeyCacheGetState(TEST_ECE_DIR.c_str(), "key_a", &generation), HKS_KEY_CACHE_UNKNOWN);
+
+    std::vector<uint8_t> key(TEST_MAX_KEY_SIZE / 2, 0x5a);
+    FillKey(TEST_ECE_DIR, key);
+    std::vector<uint8_t> out;
+    EXPECT_EQ(GetKey(TEST_ECE_DIR, TEST_TOKEN_ID, out), HKS_ERROR_NOT_EXIST);
+
+    key.assign(TEST_MAX_KEY_SIZE + 1, 0x5a);
+    FillKey(TEST_DIR, key);
+    EXPECT_EQ(GetKey(TEST_DIR, TEST_TOKEN_ID, out), HKS_ERROR_NOT_EXIST);
+}
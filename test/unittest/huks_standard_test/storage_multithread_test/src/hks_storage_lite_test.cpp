@@ -0,0 +1,329 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "hks_file_operator.h"
+#include "hks_mem.h"
+#include "hks_param.h"
+#include "hks_storage.h"
+#include "hks_type.h"
+
+using namespace testing::ext;
+
+extern "C" {
+/* the storage image of hks_storage_lite.c, dropped to simulate a service restart */
+extern struct HksBlob g_storageImageBuffer;
+
+/* the storage only needs random salt and a header mac from the core, a keyed checksum stands in for both */
+int32_t HuksAccessGenerateRandom(const struct HksParamSet *paramSet, struct HksBlob *random)
+{
+    (void)paramSet;
+    for (uint32_t i = 0; i < random->size; ++i) {
+        random->data[i] = (uint8_t)rand();
+    }
+    return HKS_SUCCESS;
+}
+
+int32_t HuksAccessCalcHeaderMac(const struct HksParamSet *paramSet, const struct HksBlob *salt,
+    const struct HksBlob *srcData, struct HksBlob *mac)
+{
+    (void)paramSet;
+    uint32_t hash = 2166136261U;
+    for (uint32_t i = 0; i < salt->size; ++i) {
+        hash = (hash ^ salt->data[i]) * 16777619U;
+    }
+    for (uint32_t i = 0; i < srcData->size; ++i) {
+        hash = (hash ^ srcData->data[i]) * 16777619U;
+    }
+    for (uint32_t i = 0; i < HKS_HMAC_DIGEST_SHA512_LEN; ++i) {
+        hash = (hash ^ i) * 16777619U;
+        mac->data[i] = (uint8_t)(hash >> 24);
+    }
+    mac->size = HKS_HMAC_DIGEST_SHA512_LEN;
+    return HKS_SUCCESS;
+}
+}
+
+namespace {
+const uint32_t TEST_KEY_SIZE = 48;
+const uint32_t BENCH_KEY_COUNT = 32;
+const uint32_t BENCH_ROUNDS = 20;
+
+std::vector<uint8_t> MakeKeyRecord(const std::string &alias, uint8_t seed, uint32_t keySize = TEST_KEY_SIZE)
+{
+    struct HksStoreKeyInfo keyInfo;
+    (void)memset(&keyInfo, 0, sizeof(keyInfo));
+    keyInfo.keyInfoLen = sizeof(keyInfo) + alias.size() + keySize;
+    keyInfo.keySize = keySize;
+    keyInfo.keyAlg = HKS_ALG_AES;
+    keyInfo.aliasSize = alias.size();
+
+    std::vector<uint8_t> record(keyInfo.keyInfoLen, seed);
+    (void)memcpy(record.data(), &keyInfo, sizeof(keyInfo));
+    (void)memcpy(record.data() + sizeof(keyInfo), alias.data(), alias.size());
+    return record;
+}
+
+int32_t StoreKey(const std::string &alias, const std::vector<uint8_t> &record)
+{
+    struct HksBlob keyAlias = { (uint32_t)alias.size(), (uint8_t *)alias.data() };
+    struct HksBlob keyBlob = { (uint32_t)record.size(), (uint8_t *)record.data() };
+    return HksStoreKeyBlob(nullptr, &keyAlias, HKS_STORAGE_TYPE_KEY, &keyBlob);
+}
+
+int32_t DeleteKey(const std::string &alias)
+{
+    struct HksBlob keyAlias = { (uint32_t)alias.size(), (uint8_t *)alias.data() };
+    return HksStoreDeleteKeyBlob(nullptr, &keyAlias, HKS_STORAGE_TYPE_KEY);
+}
+
+int32_t GetKey(const std::string &alias, std::vector<uint8_t> &record)
+{
+    struct HksBlob keyAlias = { (uint32_t)alias.size(), (uint8_t *)alias.data() };
+    struct HksBlob keyBlob = { 0, nullptr };
+    int32_t ret = HksStoreGetKeyBlob(nullptr, &keyAlias, HKS_STORAGE_TYPE_KEY, &keyBlob);
+    if (ret == HKS_SUCCESS) {
+        record.assign(keyBlob.data, keyBlob.data + keyBlob.size);
+        HKS_FREE_BLOB(keyBlob);
+    }
+    return ret;
+}
+
+uint32_t GetKeyCount()
+{
+    uint32_t count = 0;
+    EXPECT_EQ(HksGetKeyCountByProcessName(nullptr, &count), HKS_SUCCESS);
+    return count;
+}
+
+void Restart()
+{
+    HKS_FREE_BLOB(g_storageImageBuffer);
+    ASSERT_EQ(HksLoadFileToBuffer(), HKS_SUCCESS);
+}
+
+double OpsPerSecond(uint32_t ops, std::chrono::steady_clock::duration cost)
+{
+    double seconds = std::chrono::duration<double>(cost).count();
+    return (seconds > 0) ? (ops / seconds) : 0;
+}
+}  // namespace
+
+class HksStorageLiteTest : public testing::Test {
+public:
+    void SetUp() override
+    {
+        (void)HksMakeDir(HKS_KEY_STORE_PATH);
+        (void)HksFileRemove(HKS_KEY_STORE_PATH, HKS_KEY_STORE_FILE_NAME);
+        HKS_FREE_BLOB(g_storageImageBuffer);
+        ASSERT_EQ(HksLoadFileToBuffer(), HKS_SUCCESS);
+    }
+
+    void TearDown() override
+    {
+        (void)HksFileRemove(HKS_KEY_STORE_PATH, HKS_KEY_STORE_FILE_NAME);
+        HKS_FREE_BLOB(g_storageImageBuffer);
+    }
+};
+
+/**
+ * @tc.name: HksStorageLiteTest.HksStorageLiteTest001
+ * @tc.desc: stores, overwrites and deletes are visible at once and after reloading the key store file
+ * @tc.type: FUNC
+ */
+HWTEST_F(HksStorageLiteTest, HksStorageLiteTest001, TestSize.Level0)
+{
+    std::vector<uint8_t> keyA = MakeKeyRecord("key_a", 1);
+    std::vector<uint8_t> keyB = MakeKeyRecord("key_b", 2);
+    std::vector<uint8_t> keyA2 = MakeKeyRecord("key_a", 3, TEST_KEY_SIZE * 2);
+    ASSERT_EQ(StoreKey("key_a", keyA), HKS_SUCCESS);
+    ASSERT_EQ(StoreKey("key_b", keyB), HKS_SUCCESS);
+    ASSERT_EQ(StoreKey("key_a", keyA2), HKS_SUCCESS);
+    ASSERT_EQ(StoreKey("key_c", MakeKeyRecord("key_c", 4)), HKS_SUCCESS);
+    ASSERT_EQ(DeleteKey("key_c"), HKS_SUCCESS);
+    EXPECT_EQ(DeleteKey("key_c"), HKS_ERROR_NOT_EXIST);
+
+    for (uint32_t round = 0; round < 2; ++round) {
+        std::vector<uint8_t> record;
+        ASSERT_EQ(GetKey("key_a", record), HKS_SUCCESS);
+        EXPECT_EQ(record, keyA2);
+        ASSERT_EQ(GetKey("key_b", record), HKS_SUCCESS);
+        EXPECT_EQ(record, keyB);
+        EXPECT_EQ(GetKey("key_c", record), HKS_ERROR_NOT_EXIST);
+        EXPECT_EQ(GetKeyCount(), 2u);
+
+        uint32_t totalSize = 0;
+        ASSERT_EQ(HksStoreGetToatalSize(&totalSize), HKS_SUCCESS);
+        EXPECT_EQ(totalSize, sizeof(struct HksStoreHeaderInfo) + keyA2.size() + keyB.size());
+        Restart();
+    }
+}
+
+/**
+ * @tc.name: HksStorageLiteTest.HksStorageLiteTest002
+ * @tc.desc: the key list holds every live key once, whatever was replaced or deleted before
+ * @tc.type: FUNC
+ */
+HWTEST_F(HksStorageLiteTest, HksStorageLiteTest002, TestSize.Level0)
+{
+    for (uint32_t i = 0; i < 4; ++i) {
+        std::string alias = "key_" + std::to_string(i);
+        ASSERT_EQ(StoreKey(alias, MakeKeyRecord(alias, i)), HKS_SUCCESS);
+    }
+    ASSERT_EQ(StoreKey("key_0", MakeKeyRecord("key_0", 9)), HKS_SUCCESS);
+    ASSERT_EQ(DeleteKey("key_2"), HKS_SUCCESS);
+
+    const uint32_t listSize = 8;
+    std::vector<std::vector<uint8_t>> aliases(listSize, std::vector<uint8_t>(HKS_MAX_KEY_ALIAS_LEN));
+    std::vector<std::vector<uint8_t>> paramSets(listSize, std::vector<uint8_t>(HKS_DEFAULT_PARAM_SET_SIZE));
+    struct HksKeyInfo keyInfoList[listSize];
+    for (uint32_t i = 0; i < listSize; ++i) {
+        keyInfoList[i].alias = { HKS_MAX_KEY_ALIAS_LEN, aliases[i].data() };
+        keyInfoList[i].paramSet = (struct HksParamSet *)paramSets[i].data();
+        keyInfoList[i].paramSet->paramSetSize = HKS_DEFAULT_PARAM_SET_SIZE;
+    }
+    uint32_t listCount = listSize;
+    ASSERT_EQ(HksStoreGetKeyInfoList(keyInfoList, &listCount), HKS_SUCCESS);
+
+    std::vector<std::string> names;
+    for (uint32_t i = 0; i < listCount; ++i) {
+        names.emplace_back((const char *)keyInfoList[i].alias.data, keyInfoList[i].alias.size);
+    }
+    std::sort(names.begin(), names.end());
+    std::vector<std::string> expect = { "key_0", "key_1", "key_3" };
+    EXPECT_EQ(names, expect);
+}
+
+#ifdef HKS_SUPPORT_STORAGE_LITE_V2
+/**
+ * @tc.name: HksStorageLiteTest.HksStorageLiteTest003
+ * @tc.desc: a version 1 image loads as a log, and its header is rewritten to version 2
+ * @tc.type: FUNC
+ */
+HWTEST_F(HksStorageLiteTest, HksStorageLiteTest003, TestSize.Level0)
+{
+    std::vector<uint8_t> keyA = MakeKeyRecord("key_a", 1);
+    std::vector<uint8_t> keyB = MakeKeyRecord("key_b", 2);
+    std::vector<uint8_t> image(sizeof(struct HksStoreHeaderInfo));
+    image.insert(image.end(), keyA.begin(), keyA.end());
+    image.insert(image.end(), keyB.begin(), keyB.end());
+
+    struct HksStoreHeaderInfo *head = (struct HksStoreHeaderInfo *)image.data();
+    head->version = 1;
+    head->keyCount = 2;
+    head->totalLen = image.size();
+    head->sealingAlg = 0xFEDCBA98;
+    struct HksBlob salt = { HKS_DERIVE_DEFAULT_SALT_LEN, head->salt };
+    struct HksBlob headData = { sizeof(*head) - HKS_HMAC_DIGEST_SHA512_LEN, image.data() };
+    struct HksBlob mac = { HKS_HMAC_DIGEST_SHA512_LEN, head->hmac };
+    ASSERT_EQ(HuksAccessCalcHeaderMac(nullptr, &salt, &headData, &mac), HKS_SUCCESS);
+    ASSERT_EQ(HksFileWrite(HKS_KEY_STORE_PATH, HKS_KEY_STORE_FILE_NAME, 0, image.data(), image.size()),
+        HKS_SUCCESS);
+
+    Restart();
+    std::vector<uint8_t> record;
+    ASSERT_EQ(GetKey("key_b", record), HKS_SUCCESS);
+    EXPECT_EQ(record, keyB);
+    EXPECT_EQ(GetKeyCount(), 2u);
+
+    struct HksStoreHeaderInfo fileHead;
+    struct HksBlob fileBlob = { sizeof(fileHead), (uint8_t *)&fileHead };
+    uint32_t size = 0;
+    ASSERT_EQ(HksFileRead(HKS_KEY_STORE_PATH, HKS_KEY_STORE_FILE_NAME, 0, &fileBlob, &size), HKS_SUCCESS);
+    EXPECT_EQ(fileHead.version, 2);
+
+    ASSERT_EQ(DeleteKey("key_a"), HKS_SUCCESS);
+    Restart();
+    EXPECT_EQ(GetKey("key_a", record), HKS_ERROR_NOT_EXIST);
+    EXPECT_EQ(GetKeyCount(), 1u);
+}
+
+/**
+ * @tc.name: HksStorageLiteTest.HksStorageLiteTest004
+ * @tc.desc: rewriting the same keys again and again compacts the log instead of running out of space
+ * @tc.type: FUNC
+ */
+HWTEST_F(HksStorageLiteTest, HksStorageLiteTest004, TestSize.Level0)
+{
+    const uint32_t keyCount = 4;
+    const uint32_t rounds = 100;
+    for (uint32_t round = 0; round < rounds; ++round) {
+        for (uint32_t i = 0; i < keyCount; ++i) {
+            std::string alias = "key_" + std::to_string(i);
+            ASSERT_EQ(StoreKey(alias, MakeKeyRecord(alias, round)), HKS_SUCCESS) << round;
+        }
+        ASSERT_EQ(DeleteKey("key_0"), HKS_SUCCESS);
+    }
+
+    uint32_t fileSize = HksFileSize(HKS_KEY_STORE_PATH, HKS_KEY_STORE_FILE_NAME);
+    EXPECT_LE(fileSize, 5120u);
+    Restart();
+    EXPECT_EQ(GetKeyCount(), keyCount - 1);
+    std::vector<uint8_t> record;
+    ASSERT_EQ(GetKey("key_3", record), HKS_SUCCESS);
+    EXPECT_EQ(record, MakeKeyRecord("key_3", rounds - 1));
+}
+#endif
+
+/**
+ * @tc.name: HksStorageLiteTest.HksStorageLiteTest005
+ * @tc.desc: store, get and delete throughput of the lite key store
+ * @tc.type: PERF
+ */
+HWTEST_F(HksStorageLiteTest, HksStorageLiteTest005, TestSize.Level1)
+{
+    std::vector<std::string> aliases;
+    std::vector<std::vector<uint8_t>> records;
+    for (uint32_t i = 0; i < BENCH_KEY_COUNT; ++i) {
+        aliases.emplace_back("bench_key_" + std::to_string(i));
+        records.emplace_back(MakeKeyRecord(aliases.back(), i, TEST_KEY_SIZE));
+    }
+
+    std::chrono::steady_clock::duration storeCost {};
+    std::chrono::steady_clock::duration getCost {};
+    std::chrono::steady_clock::duration deleteCost {};
+    for (uint32_t round = 0; round < BENCH_ROUNDS; ++round) {
+        auto start = std::chrono::steady_clock::now();
+        for (uint32_t i = 0; i < BENCH_KEY_COUNT; ++i) {
+            ASSERT_EQ(StoreKey(aliases[i], records[i]), HKS_SUCCESS);
+        }
+        storeCost += std::chrono::steady_clock::now() - start;
+
+        start = std::chrono::steady_clock::now();
+        for (uint32_t i = 0; i < BENCH_KEY_COUNT; ++i) {
+            std::vector<uint8_t> record;
+            ASSERT_EQ(GetKey(aliases[BENCH_KEY_COUNT - 1 - i], record), HKS_SUCCESS);
+        }
+        getCost += std::chrono::steady_clock::now() - start;
+
+        start = std::chrono::steady_clock::now();
+        for (uint32_t i = 0; i < BENCH_KEY_COUNT; ++i) {
+            ASSERT_EQ(DeleteKey(aliases[i]), HKS_SUCCESS);
+        }
+        deleteCost += std::chrono::steady_clock::now() - start;
+    }
+
+    uint32_t ops = BENCH_KEY_COUNT * BENCH_ROUNDS;
+    std::cout << HKS_KEY_STORE_PATH << ": store " << OpsPerSecond(ops, storeCost) << " ops/s, get " <<
+        OpsPerSecond(ops, getCost) << " ops/s, delete " << OpsPerSecond(ops, deleteCost) << " ops/s" << std::endl;
+}
@@ -0,0 +1,134 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+
+#include <string>
+
+#include "hks_config.h"
+#include "hks_storage_path_cache.h"
+#include "hks_type.h"
+#include "securec.h"
+
+using namespace testing::ext;
+
+namespace {
+const std::string TEST_MAIN_DIR = std::string(HKS_KEY_STORE_PATH) + "/100/20020100/key";
+const std::string TEST_BAK_DIR = std::string(HKS_KEY_STORE_BAK_PATH) + "/100/20020100/key";
+constexpr int32_t TEST_USER_ID = 100;
+uint8_t g_processName[] = "20020100";
+uint8_t g_otherProcessName[] = "20020101";
+
+struct HksStorePathKey MakeKey(struct HksBlob *processName)
+{
+    struct HksStorePathKey key = { DE_PATH, TEST_USER_ID, HKS_STORAGE_TYPE_KEY, true, processName };
+    return key;
+}
+
+class TestFileInfo {
+public:
+    TestFileInfo()
+    {
+        EXPECT_EQ(HksFileInfoInit(&fileInfo), HKS_SUCCESS);
+    }
+
+    ~TestFileInfo()
+    {
+        FileInfoFree(&fileInfo);
+    }
+
+    void SetDirs()
+    {
+        (void)strcpy_s(fileInfo.mainPath.path, fileInfo.mainPath.size, TEST_MAIN_DIR.c_str());
+#ifdef SUPPORT_STORAGE_BACKUP
+        (void)strcpy_s(fileInfo.bakPath.path, fileInfo.bakPath.size, TEST_BAK_DIR.c_str());
+#endif
+    }
+
+    struct HksStoreFileInfo fileInfo {};
+};
+}  // namespace
+
+class HksStoragePathCacheTest : public testing::Test {
+public:
+    void SetUp() override
+    {
+        HksPathCacheClear();
+    }
+
+    void TearDown() override
+    {
+        HksPathCacheClear();
+    }
+};
+
+/**
+ * @tc.name: HksStoragePathCacheTest.HksStoragePathCacheTest001
+ * @tc.desc: a put directory is returned for the same key only, and is gone once the cache is cleared
+ * @tc.type: FUNC
+ */
+HWTEST_F(HksStoragePathCacheTest, HksStoragePathCacheTest001, TestSize.Level0)
+{
+    struct HksBlob processName = { sizeof(g_processName), g_processName };
+    struct HksStorePathKey key = MakeKey(&processName);
+    uint64_t generation = 0;
+    TestFileInfo miss;
+    EXPECT_EQ(HksPathCacheGet(&key, &miss.fileInfo, &generation), HKS_ERROR_NOT_EXIST);
+
+    TestFileInfo built;
+    built.SetDirs();
+    HksPathCachePut(&key, &built.fileInfo, generation);
+
+    TestFileInfo hit;
+    ASSERT_EQ(HksPathCacheGet(&key, &hit.fileInfo, &generation), HKS_SUCCESS);
+    EXPECT_EQ(std::string(hit.fileInfo.mainPath.path), TEST_MAIN_DIR);
+#ifdef SUPPORT_STORAGE_BACKUP
+    EXPECT_EQ(std::string(hit.fileInfo.bakPath.path), TEST_BAK_DIR);
+#endif
+
+    struct HksBlob otherName = { sizeof(g_otherProcessName), g_otherProcessName };
+    struct HksStorePathKey otherKey = MakeKey(&otherName);
+    TestFileInfo other;
+    EXPECT_EQ(HksPathCacheGet(&otherKey, &other.fileInfo, &generation), HKS_ERROR_NOT_EXIST);
+    otherKey = key;
+    otherKey.pathType = CE_PATH;
+    EXPECT_EQ(HksPathCacheGet(&otherKey, &other.fileInfo, &generation), HKS_ERROR_NOT_EXIST);
+
+    HksPathCacheClear();
+    EXPECT_EQ(HksPathCacheGet(&key, &other.fileInfo, &generation), HKS_ERROR_NOT_EXIST);
+}
+
+/**
+ * @tc.name: HksStoragePathCacheTest.HksStoragePathCacheTest002
+ * @tc.desc: a put carrying the generation of a lookup made before a clear is dropped
+ * @tc.type: FUNC
+ */
+HWTEST_F(HksStoragePathCacheTest, HksStoragePathCacheTest002, TestSize.Level0)
+{
+    struct HksBlob processName = { sizeof(g_processName), g_processName };
+    struct HksStorePathKey key = MakeKey(&processName);
+    uint64_t generation = 0;
+    TestFileInfo built;
+    EXPECT_EQ(HksPathCacheGet(&key, &built.fileInfo, &generation), HKS_ERROR_NOT_EXIST);
+
+    HksPathCacheClear();
+    built.SetDirs();
+    HksPathCachePut(&key, &built.fileInfo, generation);
+
+    TestFileInfo stale;
+    EXPECT_EQ(HksPathCacheGet(&key, &stale.fileInfo, &generation), HKS_ERROR_NOT_EXIST);
+    HksPathCachePut(&key, &built.fileInfo, generation);
+    EXPECT_EQ(HksPathCacheGet(&key, &stale.fileInfo, &generation), HKS_SUCCESS);
+}
@@ -0,0 +1,123 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef HKS_BATCH_VERIFY_TEST_H
+#define HKS_BATCH_VERIFY_TEST_H
+
+#include "hks_three_stage_test_common.h"
+namespace Unittest::BatchVerify {
+static const uint32_t BATCH_VERIFY_COUNT = 10;
+static const uint32_t BATCH_VERIFY_SIGNATURE_SIZE = 128;
+static const uint32_t BATCH_VERIFY_PUB_KEY_SIZE = 1024;
+
+/* pair 1 carries a corrupted signature, pair 3 a changed message and pair 8 the signature of pair 0 */
+static const uint32_t BATCH_VERIFY_CORRUPT_SIGNATURE_INDEX = 1;
+static const uint32_t BATCH_VERIFY_CHANGED_MESSAGE_INDEX = 3;
+static const uint32_t BATCH_VERIFY_SWAPPED_SIGNATURE_INDEX = 8;
+static const uint8_t BATCH_VERIFY_EXPECTED_RESULT[HKS_BATCH_VERIFY_RESULT_SIZE(BATCH_VERIFY_COUNT)] = { 0xF5, 0x02 };
+
+static struct HksParam g_genParamsEcc[] = {
+    {
+        .tag = HKS_TAG_ALGORITHM,
+        .uint32Param = HKS_ALG_ECC
+    }, {
+        .tag = HKS_TAG_PURPOSE,
+        .uint32Param = HKS_KEY_PURPOSE_SIGN | HKS_KEY_PURPOSE_VERIFY
+    }, {
+        .tag = HKS_TAG_KEY_SIZE,
+        .uint32Param = HKS_ECC_KEY_SIZE_256
+    }, {
+        .tag = HKS_TAG_DIGEST,
+        .uint32Param = HKS_DIGEST_SHA256
+    }
+};
+static struct HksParam g_signParamsEcc[] = {
+    {
+        .tag = HKS_TAG_ALGORITHM,
+        .uint32Param = HKS_ALG_ECC
+    }, {
+        .tag = HKS_TAG_PURPOSE,
+        .uint32Param = HKS_KEY_PURPOSE_SIGN
+    }, {
+        .tag = HKS_TAG_KEY_SIZE,
+        .uint32Param = HKS_ECC_KEY_SIZE_256
+    }, {
+        .tag = HKS_TAG_DIGEST,
+        .uint32Param = HKS_DIGEST_SHA256
+    }
+};
+static struct HksParam g_verifyParamsEcc[] = {
+    {
+        .tag = HKS_TAG_ALGORITHM,
+        .uint32Param = HKS_ALG_ECC
+    }, {
+        .tag = HKS_TAG_PURPOSE,
+        .uint32Param = HKS_KEY_PURPOSE_VERIFY
+    }, {
+        .tag = HKS_TAG_KEY_SIZE,
+        .uint32Param = HKS_ECC_KEY_SIZE_256
+    }, {
+        .tag = HKS_TAG_DIGEST,
+        .uint32Param = HKS_DIGEST_SHA256
+    }
+};
+
+static struct HksParam g_genParamsEd25519[] = {
+    {
+        .tag = HKS_TAG_ALGORITHM,
+        .uint32Param = HKS_ALG_ED25519
+    }, {
+        .tag = HKS_TAG_PURPOSE,
+        .uint32Param = HKS_KEY_PURPOSE_SIGN | HKS_KEY_PURPOSE_VERIFY
+    }, {
+        .tag = HKS_TAG_KEY_SIZE,
+        .uint32Param = HKS_CURVE25519_KEY_SIZE_256
+    }, {
+        .tag = HKS_TAG_DIGEST,
+        .uint32Param = HKS_DIGEST_SHA256
+    }
+};
+static struct HksParam g_signParamsEd25519[] = {
+    {
+        .tag = HKS_TAG_ALGORITHM,
+        .uint32Param = HKS_ALG_ED25519
+    }, {
+        .tag = HKS_TAG_PURPOSE,
+        .uint32Param = HKS_KEY_PURPOSE_SIGN
+    }, {
+        .tag = HKS_TAG_KEY_SIZE,
+        .uint32Param = HKS_CURVE25519_KEY_SIZE_256
+    }, {
+        .tag = HKS_TAG_DIGEST,
+        .uint32Param = HKS_DIGEST_SHA256
+    }
+};
+static struct HksParam g_verifyParamsEd25519[] = {
+    {
+        .tag = HKS_TAG_ALGORITHM,
+        .uint32Param = HKS_ALG_ED25519
+    }, {
+        .tag = HKS_TAG_PURPOSE,
+        .uint32Param = HKS_KEY_PURPOSE_VERIFY
+    }, {
+        .tag = HKS_TAG_KEY_SIZE,
+        .uint32Param = HKS_CURVE25519_KEY_SIZE_256
+    }, {
+        .tag = HKS_TAG_DIGEST,
+        .uint32Param = HKS_DIGEST_SHA256
+    }
+};
+} // namespace Unittest::BatchVerify
+#endif // HKS_BATCH_VERIFY_TEST_H
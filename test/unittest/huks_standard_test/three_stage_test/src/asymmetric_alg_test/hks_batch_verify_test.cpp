@@ -0,0 +1,207 @@
+/*
+ * Copyright (c) 2026 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *    http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "hks_batch_verify_test.h"
+#include "hks_test_adapt_for_de.h"
+
+#include <gtest/gtest.h>
+#include <string>
+
+using namespace testing::ext;
+namespace Unittest::BatchVerify {
+class HksBatchVerifyTest : public testing::Test {
+public:
+    static void SetUpTestCase(void);
+
+    static void TearDownTestCase(void);
+
+    void SetUp();
+
+    void TearDown();
+};
+
+void HksBatchVerifyTest::SetUpTestCase(void)
+{
+}
+
+void HksBatchVerifyTest::TearDownTestCase(void)
+{
+}
+
+void HksBatchVerifyTest::SetUp()
+{
+    EXPECT_EQ(HksInitialize(), 0);
+}
+
+void HksBatchVerifyTest::TearDown()
+{
+}
+
+struct BatchVerifyParamSets {
+    struct HksParamSet *genParamSet;
+    struct HksParamSet *signParamSet;
+    struct HksParamSet *verifyParamSet;
+};
+
+static int32_t InitBatchVerifyParamSets(struct BatchVerifyParamSets *paramSets, const struct HksParam *genParams,
+    const struct HksParam *signParams, const struct HksParam *verifyParams, uint32_t paramCount)
+{
+    int32_t ret = InitParamSet(&paramSets->genParamSet, genParams, paramCount);
+    if (ret == HKS_SUCCESS) {
+        ret = InitParamSet(&paramSets->signParamSet, signParams, paramCount);
+    }
+    if (ret == HKS_SUCCESS) {
+        ret = InitParamSet(&paramSets->verifyParamSet, verifyParams, paramCount);
+    }
+    return ret;
+}
+
+static void FreeBatchVerifyParamSets(struct BatchVerifyParamSets *paramSets)
+{
+    HksFreeParamSet(&paramSets->genParamSet);
+    HksFreeParamSet(&paramSets->signParamSet);
+    HksFreeParamSet(&paramSets->verifyParamSet);
+}
+
+/*
+ * Signs BATCH_VERIFY_COUNT messages with a generated key, spoils three of the pairs, then verifies the whole batch
+ * with the imported public key and checks that exactly the untouched pairs are set in the result bitmap.
+ */
+static void HksBatchVerifyTestMixedCase(const char *keyAliasString, const char *pubKeyAliasString,
+    const struct BatchVerifyParamSets *paramSets)
+{
+    struct HksBlob keyAlias = { (uint32_t)strlen(keyAliasString), (uint8_t *)keyAliasString };
+    struct HksBlob pubKeyAlias = { (uint32_t)strlen(pubKeyAliasString), (uint8_t *)pubKeyAliasString };
+
+    /* 1. Generate Key */
+    ASSERT_EQ(HksGenerateKeyForDe(&keyAlias, paramSets->genParamSet, nullptr), HKS_SUCCESS) << "GenerateKey failed.";
+
+    /* 2. Sign every message */
+    std::string messageData[BATCH_VERIFY_COUNT];
+    struct HksBlob messages[BATCH_VERIFY_COUNT];
+    uint8_t signData[BATCH_VERIFY_COUNT][BATCH_VERIFY_SIGNATURE_SIZE] = {{0}};
+    struct HksBlob signatures[BATCH_VERIFY_COUNT];
+    for (uint32_t i = 0; i < BATCH_VERIFY_COUNT; ++i) {
+        messageData[i] = "Hks_Batch_Verify_Test_Message_" + std::to_string(i);
+        messages[i] = { (uint32_t)messageData[i].length(), (uint8_t *)messageData[i].c_str() };
+        signatures[i] = { BATCH_VERIFY_SIGNATURE_SIZE, signData[i] };
+        EXPECT_EQ(HksSignForDe(&keyAlias, paramSets->signParamSet, &messages[i], &signatures[i]), HKS_SUCCESS)
+            << "Sign " << i << " failed.";
+    }
+
+    /* 3. Export and import the public key */
+    uint8_t pubKey[BATCH_VERIFY_PUB_KEY_SIZE] = {0};
+    struct HksBlob publicKey = { BATCH_VERIFY_PUB_KEY_SIZE, pubKey };
+    EXPECT_EQ(HksExportPublicKeyForDe(&keyAlias, paramSets->genParamSet, &publicKey), HKS_SUCCESS)
+        << "ExportPublicKey failed.";
+    EXPECT_EQ(HksImportKeyForDe(&pubKeyAlias, paramSets->verifyParamSet, &publicKey), HKS_SUCCESS)
+        << "ImportKey failed.";
+
+    /* 4. Spoil three pairs */
+    struct HksBlob *corrupted = &signatures[BATCH_VERIFY_CORRUPT_SIGNATURE_INDEX];
+    corrupted->data[corrupted->size - 1] ^= 0x01;
+    messageData[BATCH_VERIFY_CHANGED_MESSAGE_INDEX][0] = 'h';
+    signatures[BATCH_VERIFY_SWAPPED_SIGNATURE_INDEX] = signatures[0];
+
+    /* 5. Batch Verify */
+    uint8_t bitmap[HKS_BATCH_VERIFY_RESULT_SIZE(BATCH_VERIFY_COUNT)] = {0};
+    struct HksBlob result = { sizeof(bitmap), bitmap };
+    EXPECT_EQ(HksBatchVerifyForDe(&pubKeyAlias, paramSets->verifyParamSet, messages, signatures,
+        BATCH_VERIFY_COUNT, &result), HKS_SUCCESS) << "BatchVerify failed.";
+    EXPECT_EQ(HksMemCmp(bitmap, BATCH_VERIFY_EXPECTED_RESULT, sizeof(bitmap)), HKS_SUCCESS)
+        << "BatchVerify result " << (uint32_t)bitmap[0] << ", " << (uint32_t)bitmap[1];
+
+    /* 6. The batch result of an untouched pair matches a single verify */
+    EXPECT_EQ(HksVerifyForDe(&pubKeyAlias, paramSets->verifyParamSet, &messages[0], &signatures[0]), HKS_SUCCESS)
+        << "Verify failed.";
+    EXPECT_NE(HksVerifyForDe(&pubKeyAlias, paramSets->verifyParamSet,
+        &messages[BATCH_VERIFY_CHANGED_MESSAGE_INDEX], &signatures[BATCH_VERIFY_CHANGED_MESSAGE_INDEX]), HKS_SUCCESS)
+        << "Verify of a changed message succeeded.";
+
+    /* 7. Delete Key */
+    EXPECT_EQ(HksDeleteKeyForDe(&keyAlias, paramSets->genParamSet), HKS_SUCCESS) << "DeleteKey failed.";
+    EXPECT_EQ(HksDeleteKeyForDe(&pubKeyAlias, paramSets->verifyParamSet), HKS_SUCCESS) << "Delete ImportKey failed.";
+}
+
+/**
+ * @tc.name: HksBatchVerifyTest.HksBatchVerifyTest001
+ * @tc.desc: alg-ECC pur-Verify, a batch of valid and invalid signatures.
+ * @tc.type: FUNC
+ */
+HWTEST_F(HksBatchVerifyTest, HksBatchVerifyTest001, TestSize.Level0)
+{
+    struct BatchVerifyParamSets paramSets = { nullptr, nullptr, nullptr };
+    int32_t ret = InitBatchVerifyParamSets(&paramSets, g_genParamsEcc, g_signParamsEcc, g_verifyParamsEcc,
+        sizeof(g_genParamsEcc) / sizeof(HksParam));
+    EXPECT_EQ(ret, HKS_SUCCESS) << "InitParamSet failed.";
+    if (ret == HKS_SUCCESS) {
+        HksBatchVerifyTestMixedCase("HksBatchVerifyKeyAliasTest001", "HksBatchVerifyPubKeyAliasTest001",
+            &paramSets);
+    }
+    FreeBatchVerifyParamSets(&paramSets);
+}
+
+/**
+ * @tc.name: HksBatchVerifyTest.HksBatchVerifyTest002
+ * @tc.desc: alg-ED25519 pur-Verify, a batch of valid and invalid signatures.
+ * @tc.type: FUNC
+ */
+HWTEST_F(HksBatchVerifyTest, HksBatchVerifyTest002, TestSize.Level0)
+{
+    struct BatchVerifyParamSets paramSets = { nullptr, nullptr, nullptr };
+    int32_t ret = InitBatchVerifyParamSets(&paramSets, g_genParamsEd25519, g_signParamsEd25519,
+        g_verifyParamsEd25519, sizeof(g_genParamsEd25519) / sizeof(HksParam));
+    EXPECT_EQ(ret, HKS_SUCCESS) << "InitParamSet failed.";
+    if (ret == HKS_SUCCESS) {
+        HksBatchVerifyTestMixedCase("HksBatchVerifyKeyAliasTest002", "HksBatchVerifyPubKeyAliasTest002",
+            &paramSets);
+    }
+    FreeBatchVerifyParamSets(&paramSets);
+}
+
+/**
+ * @tc.name: HksBatchVerifyTest.HksBatchVerifyTest003
+ * @tc.desc: a batch without pairs, with more than HKS_MAX_BATCH_VERIFY_COUNT pairs or with a short result is refused.
+ * @tc.type: FUNC
+ */
+HWTEST_F(HksBatchVerifyTest, HksBatchVerifyTest003, TestSize.Level0)
+{
+    struct HksParamSet *verifyParamSet = nullptr;
+    int32_t ret = InitParamSet(&verifyParamSet, g_verifyParamsEcc, sizeof(g_verifyParamsEcc) / sizeof(HksParam));
+    ASSERT_EQ(ret, HKS_SUCCESS) << "InitParamSet failed.";
+
+    const char *keyAliasString = "HksBatchVerifyKeyAliasTest003";
+    struct HksBlob keyAlias = { (uint32_t)strlen(keyAliasString), (uint8_t *)keyAliasString };
+    uint8_t data[] = { 0x00 };
+    struct HksBlob messages[BATCH_VERIFY_COUNT];
+    struct HksBlob signatures[BATCH_VERIFY_COUNT];
+    for (uint32_t i = 0; i < BATCH_VERIFY_COUNT; ++i) {
+        messages[i] = { sizeof(data), data };
+        signatures[i] = { sizeof(data), data };
+    }
+    uint8_t bitmap[HKS_BATCH_VERIFY_RESULT_SIZE(BATCH_VERIFY_COUNT)] = {0};
+    struct HksBlob result = { sizeof(bitmap), bitmap };
+
+    EXPECT_EQ(HksBatchVerifyForDe(&keyAlias, verifyParamSet, messages, signatures, 0, &result),
+        HKS_ERROR_INVALID_ARGUMENT);
+    EXPECT_EQ(HksBatchVerifyForDe(&keyAlias, verifyParamSet, messages, signatures, HKS_MAX_BATCH_VERIFY_COUNT + 1,
+        &result), HKS_ERROR_INVALID_ARGUMENT);
+    result.size = HKS_BATCH_VERIFY_RESULT_SIZE(BATCH_VERIFY_COUNT) - 1;
+    EXPECT_EQ(HksBatchVerifyForDe(&keyAlias, verifyParamSet, messages, signatures, BATCH_VERIFY_COUNT, &result),
+        HKS_ERROR_INVALID_ARGUMENT);
+
+    HksFreeParamSet(&verifyParamSet);
+}
+} // namespace Unittest::BatchVerify
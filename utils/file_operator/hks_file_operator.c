@@ -23,7 +23,11 @@
 
 #include <dirent.h>
 #include <errno.h>
+#include <fcntl.h>
 #include <limits.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdio.h>
 #include <sys/stat.h>
 #include <unistd.h>
 
@@ -221,6 +225,41 @@ static int32_t FileWrite(const char *fileName, uint32_t offset, const uint8_t *b
     return HKS_SUCCESS;
 }
 
+static int32_t FileWriteAt(const char *fileName, uint32_t offset, const uint8_t *buf, uint32_t len)
+{
+    char filePath[PATH_MAX + 1] = {0};
+    if (realpath(fileName, filePath) == NULL) {
+        HKS_LOG_E("get real path fail, errno = 0x%" LOG_PUBLIC "x", errno);
+        return (errno == ENOENT) ? HKS_ERROR_NOT_EXIST : HKS_ERROR_OPEN_FILE_FAIL;
+    }
+
+    /* no O_CREAT and no O_TRUNC: only bytes in [offset, offset + len) change */
+    int fd = open(filePath, O_WRONLY);
+    if (fd < 0) {
+        HKS_LOG_E("open file fail, errno = 0x%" LOG_PUBLIC "x", errno);
+        return (errno == REQUIRED_KEY_NOT_AVAILABLE) ? HKS_ERROR_NO_PERMISSION : HKS_ERROR_OPEN_FILE_FAIL;
+    }
+
+    ssize_t size = pwrite(fd, buf, len, (off_t)offset);
+    if ((size < 0) || ((uint32_t)size != len)) {
+        HKS_LOG_E("write file size fail, errno = 0x%" LOG_PUBLIC "x", errno);
+        close(fd);
+        return HKS_ERROR_WRITE_FILE_FAIL;
+    }
+
+    if (fsync(fd) < 0) {
+        HKS_LOG_E("sync file fail, errno = 0x%" LOG_PUBLIC "x", errno);
+        close(fd);
+        return HKS_ERROR_WRITE_FILE_FAIL;
+    }
+
+    if (close(fd) < 0) {
+        HKS_LOG_E("failed to close file, errno = 0x%" LOG_PUBLIC "x", errno);
+        return HKS_ERROR_CLOSE_FILE_FAIL;
+    }
+    return HKS_SUCCESS;
+}
+
 static int32_t FileRemove(const char *fileName)
 {
     int32_t ret = IsFileExist(fileName);
@@ -372,116 +411,235 @@ int32_t HksRemoveDir(const char *dirPath)
     return HKS_SUCCESS;
 }
 
-static int32_t HksDeletDirPartTwo(const char *path)
+/* deeper entries are still removed, but only when they are empty, as remove() did before */
+#define HKS_DELETE_DIR_MAX_DEPTH 8
+#define HKS_DIR_TRASH_MAX_RETRY 16
+
+static bool IsDotEntry(const char *name)
 {
-    int32_t ret;
-    char deletePath[HKS_MAX_FILE_NAME_LEN] = {0};
-    DIR *dir = opendir(path);
-    HKS_IF_NULL_LOGE_RETURN(dir, HKS_ERROR_OPEN_FILE_FAIL, "open dir failed")
-    struct dirent *dire = readdir(dir);
-    while (dire != NULL) {
-        if (strncpy_s(deletePath, sizeof(deletePath), path, strlen(path)) != EOK) {
-            closedir(dir);
-            return HKS_ERROR_INTERNAL_ERROR;
-        }
+    return (strcmp(name, ".") == 0) || (strcmp(name, "..") == 0);
+}
 
-        if (deletePath[strlen(deletePath) - 1] != '/') {
-            if (strncat_s(deletePath, sizeof(deletePath), "/", strlen("/")) != EOK) {
-                closedir(dir);
-                return HKS_ERROR_INTERNAL_ERROR;
-            }
-        }
+static bool IsSubDir(int dirFd, const struct dirent *dire)
+{
+    if (dire->d_type != DT_UNKNOWN) {
+        return dire->d_type == DT_DIR;
+    }
+    struct stat entryStat;
+    return (fstatat(dirFd, dire->d_name, &entryStat, AT_SYMLINK_NOFOLLOW) == 0) && S_ISDIR(entryStat.st_mode);
+}
 
-        if (strncat_s(deletePath, sizeof(deletePath), dire->d_name, strlen(dire->d_name)) != EOK) {
-            closedir(dir);
-            return HKS_ERROR_INTERNAL_ERROR;
-        }
+/*
+ * Removes the tree name under parentFd. Entries are unlinked relative to the open directory, so no path string is
+ * built per entry and symbolic links below the top level are removed, never followed.
+ */
+static int32_t DeleteDirAt(int parentFd, const char *name, uint32_t depth)
+{
+    int flags = O_RDONLY | O_DIRECTORY | O_CLOEXEC | ((depth == 0) ? 0 : O_NOFOLLOW);
+    int fd = openat(parentFd, name, flags);
+    if (fd < 0) {
+        return HKS_ERROR_OPEN_FILE_FAIL;
+    }
+    DIR *dir = fdopendir(fd);
+    if (dir == NULL) {
+        close(fd);
+        return HKS_ERROR_OPEN_FILE_FAIL;
+    }
 
-        if ((strcmp("..", dire->d_name) != 0) && (strcmp(".", dire->d_name) != 0)) {
-            (void)remove(deletePath);
+    struct dirent *dire = readdir(dir);
+    while (dire != NULL) {
+        if (!IsDotEntry(dire->d_name)) {
+            if (!IsSubDir(fd, dire)) {
+                (void)unlinkat(fd, dire->d_name, 0);
+            } else if (depth + 1 < HKS_DELETE_DIR_MAX_DEPTH) {
+                (void)DeleteDirAt(fd, dire->d_name, depth + 1);
+            } else {
+                (void)unlinkat(fd, dire->d_name, AT_REMOVEDIR);
+            }
         }
         dire = readdir(dir);
     }
     closedir(dir);
-    ret = remove(path);
-    return ret;
+    return (unlinkat(parentFd, name, AT_REMOVEDIR) == 0) ? HKS_SUCCESS : HKS_FAILURE;
 }
 
-static int32_t HksDeletDirPartOne(const char *path)
+int32_t HksDeleteDir(const char *path)
 {
-    int32_t ret;
-    char deletePath[HKS_MAX_FILE_NAME_LEN] = {0};
-    DIR *dir = opendir(path);
-    HKS_IF_NULL_LOGE_RETURN(dir, HKS_ERROR_OPEN_FILE_FAIL, "open dir failed")
+    if (IsValidPath(path) != HKS_SUCCESS) {
+        return HKS_ERROR_INVALID_ARGUMENT;
+    }
+    return DeleteDirAt(AT_FDCWD, path, 0);
+}
+
+struct HksDirTrash {
+    struct HksDirTrash *next;
+    bool isSweep;           // path is not trash, only the trash in it is removed
+    bool withSubDirs;       // for a sweep, the trash in the subdirectories of path too
+    char path[HKS_MAX_FILE_NAME_LEN];
+};
+
+static pthread_mutex_t g_dirTrashLock = PTHREAD_MUTEX_INITIALIZER;
+static struct HksDirTrash *g_dirTrashHead = NULL;
+static struct HksDirTrash *g_dirTrashTail = NULL;
+static bool g_dirTrashWorkerRunning = false;
+static uint32_t g_dirTrashSeq = 0;
+
+/* removes the trash in the dir name of parentFd, and with withSubDirs in its subdirectories too */
+static void SweepDirTrashAt(int parentFd, const char *name, bool withSubDirs)
+{
+    int fd = openat(parentFd, name, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (fd < 0) {
+        return;
+    }
+    DIR *dir = fdopendir(fd);
+    if (dir == NULL) {
+        close(fd);
+        return;
+    }
     struct dirent *dire = readdir(dir);
     while (dire != NULL) {
-        if (strncpy_s(deletePath, sizeof(deletePath), path, strlen(path)) != EOK) {
-            closedir(dir);
-            return HKS_ERROR_INTERNAL_ERROR;
+        if (strncmp(dire->d_name, HKS_DIR_TRASH_PREFIX, strlen(HKS_DIR_TRASH_PREFIX)) == 0) {
+            (void)DeleteDirAt(fd, dire->d_name, 1);
+        } else if (withSubDirs && !IsDotEntry(dire->d_name) && IsSubDir(fd, dire)) {
+            SweepDirTrashAt(fd, dire->d_name, false);
         }
+        dire = readdir(dir);
+    }
+    closedir(dir);
+}
 
-        if (deletePath[strlen(deletePath) - 1] != '/') {
-            if (strncat_s(deletePath, sizeof(deletePath), "/", strlen("/")) != EOK) {
-                closedir(dir);
-                return HKS_ERROR_INTERNAL_ERROR;
-            }
+static void *DirTrashWorker(void *arg)
+{
+    (void)arg;
+    while (true) {
+        (void)pthread_mutex_lock(&g_dirTrashLock);
+        struct HksDirTrash *trash = g_dirTrashHead;
+        if (trash == NULL) {
+            g_dirTrashTail = NULL;
+            g_dirTrashWorkerRunning = false;
+            (void)pthread_mutex_unlock(&g_dirTrashLock);
+            break;
         }
+        g_dirTrashHead = trash->next;
+        (void)pthread_mutex_unlock(&g_dirTrashLock);
 
-        if (strncat_s(deletePath, sizeof(deletePath), dire->d_name, strlen(dire->d_name)) != EOK) {
-            closedir(dir);
-            return HKS_ERROR_INTERNAL_ERROR;
+        if (trash->isSweep) {
+            SweepDirTrashAt(AT_FDCWD, trash->path, trash->withSubDirs);
+            HKS_FREE(trash);
+            continue;
         }
+        HKS_IF_NOT_SUCC_LOGE(DeleteDirAt(AT_FDCWD, trash->path, 0), "delete trash dir failed")
+        /* also removes trash a crash left behind in the same parent */
+        char *slash = strrchr(trash->path, '/');
+        if (slash != NULL) {
+            *slash = '\0';
+            SweepDirTrashAt(AT_FDCWD, (slash == trash->path) ? "/" : trash->path, false);
+        }
+        HKS_FREE(trash);
+    }
+    return NULL;
+}
 
-        if (dire->d_type == DT_DIR && (strcmp("..", dire->d_name) != 0) && (strcmp(".", dire->d_name) != 0)) {
-            HksDeletDirPartTwo(deletePath);
-        } else if (dire->d_type != DT_DIR) {
-            (void)remove(deletePath);
+static int32_t QueueDirTrash(struct HksDirTrash *trash)
+{
+    int32_t ret = HKS_SUCCESS;
+    (void)pthread_mutex_lock(&g_dirTrashLock);
+    if (!g_dirTrashWorkerRunning) {
+        pthread_t worker;
+        if (pthread_create(&worker, NULL, DirTrashWorker, NULL) != 0) {
+            ret = HKS_ERROR_INTERNAL_ERROR;
+        } else {
+            (void)pthread_detach(worker);
+            g_dirTrashWorkerRunning = true;
         }
-        dire = readdir(dir);
     }
-    closedir(dir);
-    ret = remove(path);
+    if (ret == HKS_SUCCESS) {
+        if (g_dirTrashTail == NULL) {
+            g_dirTrashHead = trash;
+        } else {
+            g_dirTrashTail->next = trash;
+        }
+        g_dirTrashTail = trash;
+    }
+    (void)pthread_mutex_unlock(&g_dirTrashLock);
     return ret;
 }
 
-int32_t HksDeleteDir(const char *path)
+/* renames path to a fresh hidden trash name in its parent, the rename stays inside one file system */
+static int32_t MoveDirToTrash(const char *path, struct HksDirTrash *trash)
+{
+    const char *slash = strrchr(path, '/');
+    HKS_IF_NULL_RETURN(slash, HKS_ERROR_INVALID_ARGUMENT)
+    int parentLen = (int)(slash - path);
+
+    for (uint32_t i = 0; i < HKS_DIR_TRASH_MAX_RETRY; ++i) {
+        (void)pthread_mutex_lock(&g_dirTrashLock);
+        uint32_t seq = g_dirTrashSeq++;
+        (void)pthread_mutex_unlock(&g_dirTrashLock);
+        if (snprintf_s(trash->path, sizeof(trash->path), sizeof(trash->path) - 1, "%.*s/%s%u",
+            parentLen, path, HKS_DIR_TRASH_PREFIX, seq) < 0) {
+            return HKS_ERROR_BUFFER_TOO_SMALL;
+        }
+        if (rename(path, trash->path) == 0) {
+            return HKS_SUCCESS;
+        }
+        if (errno == ENOENT) {
+            return HKS_ERROR_NOT_EXIST;
+        }
+        if ((errno != EEXIST) && (errno != ENOTEMPTY)) {
+            return HKS_ERROR_INTERNAL_ERROR;
+        }
+    }
+    return HKS_ERROR_INTERNAL_ERROR;
+}
+
+int32_t HksDeleteDirAsync(const char *path)
 {
     if (IsValidPath(path) != HKS_SUCCESS) {
         return HKS_ERROR_INVALID_ARGUMENT;
     }
-    int32_t ret;
-    char deletePath[HKS_MAX_FILE_NAME_LEN] = { 0 };
+    struct HksDirTrash *trash = (struct HksDirTrash *)HksMalloc(sizeof(struct HksDirTrash));
+    HKS_IF_NULL_RETURN(trash, HKS_ERROR_MALLOC_FAIL)
 
-    DIR *dir = opendir(path);
-    HKS_IF_NULL_LOGE_RETURN(dir, HKS_ERROR_OPEN_FILE_FAIL, "open dir failed")
-    struct dirent *dire = readdir(dir);
-    while (dire != NULL) {
-        if (strncpy_s(deletePath, sizeof(deletePath), path, strlen(path)) != EOK) {
-            closedir(dir);
-            return HKS_ERROR_INTERNAL_ERROR;
-        }
+    int32_t ret = MoveDirToTrash(path, trash);
+    if (ret == HKS_ERROR_NOT_EXIST) {
+        HKS_FREE(trash);
+        return HKS_ERROR_OPEN_FILE_FAIL;
+    }
+    if (ret != HKS_SUCCESS) {
+        HKS_LOG_E("move dir to trash failed, ret = %" LOG_PUBLIC "d, delete in place", ret);
+        HKS_FREE(trash);
+        return HksDeleteDir(path);
+    }
 
-        if (deletePath[strlen(deletePath) - 1] != '/') {
-            if (strncat_s(deletePath, sizeof(deletePath), "/", strlen("/")) != EOK) {
-                closedir(dir);
-                return HKS_ERROR_INTERNAL_ERROR;
-            }
-        }
+    ret = QueueDirTrash(trash);
+    if (ret != HKS_SUCCESS) {
+        HKS_LOG_E("start trash worker failed, delete in place");
+        ret = DeleteDirAt(AT_FDCWD, trash->path, 0);
+        HKS_FREE(trash);
+    }
+    return ret;
+}
 
-        if (strncat_s(deletePath, sizeof(deletePath), dire->d_name, strlen(dire->d_name)) != EOK) {
-            closedir(dir);
-            return HKS_ERROR_INTERNAL_ERROR;
-        }
+int32_t HksSweepDirTrashAsync(const char *path, bool withSubDirs)
+{
+    if (IsValidPath(path) != HKS_SUCCESS) {
+        return HKS_ERROR_INVALID_ARGUMENT;
+    }
+    struct HksDirTrash *trash = (struct HksDirTrash *)HksMalloc(sizeof(struct HksDirTrash));
+    HKS_IF_NULL_RETURN(trash, HKS_ERROR_MALLOC_FAIL)
 
-        if (dire->d_type == DT_DIR && (strcmp("..", dire->d_name) != 0) && (strcmp(".", dire->d_name) != 0)) {
-            HksDeletDirPartOne(deletePath);
-        } else if (dire->d_type != DT_DIR) {
-            (void)remove(deletePath);
-        }
-        dire = readdir(dir);
+    trash->isSweep = true;
+    trash->withSubDirs = withSubDirs;
+    if (strcpy_s(trash->path, sizeof(trash->path), path) != EOK) {
+        HKS_FREE(trash);
+        return HKS_ERROR_BUFFER_TOO_SMALL;
+    }
+    int32_t ret = QueueDirTrash(trash);
+    if (ret != HKS_SUCCESS) {
+        HKS_LOG_E("start trash worker failed, ret = %" LOG_PUBLIC "d", ret);
+        HKS_FREE(trash);
     }
-    closedir(dir);
-    ret = remove(path);
     return ret;
 }
 
@@ -523,6 +681,25 @@ int32_t HksFileWrite(const char *path, const char *fileName, uint32_t offset, co
     return ret;
 }
 
+int32_t HksFileWriteAt(const char *path, const char *fileName, uint32_t offset, const uint8_t *buf, uint32_t len)
+{
+    if ((fileName == NULL) || (buf == NULL) || (len == 0)) {
+        return HKS_ERROR_INVALID_ARGUMENT;
+    }
+
+    char *fullFileName = NULL;
+    int32_t ret = GetFullFileName(path, fileName, &fullFileName);
+    HKS_IF_NOT_SUCC_RETURN(ret, ret)
+    if (IsValidPath(fullFileName) != HKS_SUCCESS) {
+        HKS_FREE(fullFileName);
+        return HKS_ERROR_INVALID_ARGUMENT;
+    }
+
+    ret = FileWriteAt(fullFileName, offset, buf, len);
+    HKS_FREE(fullFileName);
+    return ret;
+}
+
 uint32_t HksFileSize(const char *path, const char *fileName)
 {
     HKS_IF_NULL_RETURN(fileName, 0)
@@ -65,6 +65,7 @@
 
 #define HKS_PROCESS_INFO_LEN    128
 #define HKS_MAX_DIRENT_FILE_LEN 128
+#define HKS_DIR_TRASH_PREFIX    ".hks_trash_"
 struct HksFileDirentInfo {
     char fileName[HKS_MAX_DIRENT_FILE_LEN]; /* point to dirent->d_name */
 };
@@ -77,6 +78,9 @@ int32_t HksFileRead(const char *path, const char *fileName, uint32_t offset, str
 
 int32_t HksFileWrite(const char *path, const char *fileName, uint32_t offset, const uint8_t *buf, uint32_t len);
 
+/* writes buf at offset of an existing file; unlike HksFileWrite the file is neither created nor truncated */
+int32_t HksFileWriteAt(const char *path, const char *fileName, uint32_t offset, const uint8_t *buf, uint32_t len);
+
 int32_t HksFileRemove(const char *path, const char *fileName);
 
 uint32_t HksFileSize(const char *path, const char *fileName);
@@ -97,6 +101,18 @@ int32_t HksRemoveDir(const char *dirPath);
 
 int32_t HksDeleteDir(const char *path);
 
+/*
+ * Moves path out of the way under a HKS_DIR_TRASH_PREFIX name in the same parent and returns, a background thread
+ * removes the tree. Falls back to HksDeleteDir when the rename or the thread fails.
+ */
+int32_t HksDeleteDirAsync(const char *path);
+
+/*
+ * Removes in the background thread of HksDeleteDirAsync the trash a crash or kill left in path before the thread had
+ * removed it, and with withSubDirs the trash in the subdirectories of path too.
+ */
+int32_t HksSweepDirTrashAsync(const char *path, bool withSubDirs);
+
 int32_t HksGetFileName(const char *path, const char *fileName, char *fullFileName, uint32_t fullFileNameLen);
 
 #ifdef __cplusplus
@@ -172,6 +172,26 @@ static int32_t FileWrite(const char *fileName, uint32_t offset, const uint8_t *b
     return HKS_SUCCESS;
 }
 
+static int32_t FileWriteAt(const char *fileName, uint32_t offset, const uint8_t *buf, uint32_t len)
+{
+    int32_t fd = open(fileName, O_WRONLY);
+    if (fd < 0) {
+        HKS_LOG_E("open file failed, errno = 0x%" LOG_PUBLIC "x", errno);
+        return (errno == ENOENT) ? HKS_ERROR_NOT_EXIST : HKS_ERROR_OPEN_FILE_FAIL;
+    }
+
+    int32_t size = pwrite(fd, buf, len, (off_t)offset);
+    if ((size < 0) || ((uint32_t)size != len)) {
+        HKS_LOG_E("write file size failed, errno = 0x%" LOG_PUBLIC "x", errno);
+        close(fd);
+        return HKS_ERROR_WRITE_FILE_FAIL;
+    }
+
+    fsync(fd);
+    close(fd);
+    return HKS_SUCCESS;
+}
+
 static int32_t FileRemove(const char *fileName)
 {
     struct stat fileStat;
@@ -354,6 +374,27 @@ static int32_t FileWrite(const char *fileName, uint32_t offset, const uint8_t *b
     return HKS_SUCCESS;
 }
 
+static int32_t FileWriteAt(const char *fileName, uint32_t offset, const uint8_t *buf, uint32_t len)
+{
+    int fd = UtilsFileOpen(fileName, O_RDWR_FS, 0);
+    if (fd < 0) {
+        HKS_LOG_E("failed to open key file, errno = 0x%" LOG_PUBLIC "x\n", fd);
+        return HKS_ERROR_OPEN_FILE_FAIL;
+    }
+
+    int32_t ret = UtilsFileSeek(fd, (int)offset, SEEK_SET_FS);
+    if (ret >= 0) {
+        ret = UtilsFileWrite(fd, (const char*)buf, len);
+    }
+    (void)UtilsFileClose(fd);
+    if (ret < 0) {
+        HKS_LOG_E("failed to write key file at offset, errno = 0x%" LOG_PUBLIC "x\n", ret);
+        return HKS_ERROR_WRITE_FILE_FAIL;
+    }
+
+    return HKS_SUCCESS;
+}
+
 static uint32_t FileSize(const char *fileName)
 {
     unsigned int fileSize;
@@ -407,6 +448,21 @@ int32_t HksFileWrite(const char *path, const char *fileName, uint32_t offset, co
     return ret;
 }
 
+int32_t HksFileWriteAt(const char *path, const char *fileName, uint32_t offset, const uint8_t *buf, uint32_t len)
+{
+    if ((fileName == NULL) || (buf == NULL) || (len == 0)) {
+        return HKS_ERROR_INVALID_ARGUMENT;
+    }
+
+    char *fullFileName = NULL;
+    int32_t ret = GetFullFileName(path, fileName, &fullFileName);
+    HKS_IF_NOT_SUCC_RETURN(ret, ret)
+
+    ret = FileWriteAt(fullFileName, offset, buf, len);
+    HKS_FREE(fullFileName);
+    return ret;
+}
+
 uint32_t HksFileSize(const char *path, const char *fileName)
 {
     HKS_IF_NULL_RETURN(fileName, 0)